@@ -489,6 +489,16 @@ void Agent::executeScript() {
     avatarDataTimer->setTimerType(Qt::PreciseTimer);
     avatarDataTimer->start();
 
+    // let nodes with rez rights profile the script without restarting the agent
+    auto messagesClient = DependencyManager::get<MessagesClient>();
+    messagesClient->subscribe(MessagesClient::SCRIPT_PROFILER_CHANNEL);
+    connect(messagesClient.data(), &MessagesClient::messageReceived, this,
+            [this](QString channel, QString message, QUuid senderID, bool localOnly) {
+        if (channel == MessagesClient::SCRIPT_PROFILER_CHANNEL && _scriptEngine) {
+            _scriptEngine->handleProfilerMessage(message, senderID);
+        }
+    });
+
     _scriptEngine->run();
 
     Frame::clearFrameHandler(AUDIO_FRAME_TYPE);
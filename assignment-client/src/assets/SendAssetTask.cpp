@@ -72,6 +72,12 @@ void SendAssetTask::run() {
             // first fixup the range based on the now known file size
             byteRange.fixupRange(file.size());
 
+            // a range that runs past the end of the asset is cut short there, clients that don't know the size
+            // yet ask for their first chunk this way and learn it from the reply
+            if (byteRange.fromInclusive >= 0 && byteRange.toExclusive > file.size()) {
+                byteRange.toExclusive = file.size();
+            }
+
             // check if we're being asked to read data that we just don't have
             // because of the file size
             if (file.size() < byteRange.fromInclusive || file.size() < byteRange.toExclusive) {
@@ -88,6 +94,7 @@ void SendAssetTask::run() {
                     file.seek(byteRange.fromInclusive);
                     replyPacketList->writePrimitive(AssetUtils::AssetServerError::NoError);
                     replyPacketList->writePrimitive(size);
+                    replyPacketList->writePrimitive((AssetUtils::DataOffset)file.size());
                     replyPacketList->write(file.read(size));
                 } else {
                     // this range is negative, at least the first part of the read will be back into the end of the file
@@ -97,6 +104,7 @@ void SendAssetTask::run() {
 
                     replyPacketList->writePrimitive(AssetUtils::AssetServerError::NoError);
                     replyPacketList->writePrimitive(size);
+                    replyPacketList->writePrimitive((AssetUtils::DataOffset)file.size());
 
                     // first write everything from the negative range to the end of the file
                     replyPacketList->write(file.read(size));
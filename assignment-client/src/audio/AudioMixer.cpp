@@ -127,7 +127,7 @@ void AudioMixer::queueReplicatedAudioPacket(QSharedPointer<ReceivedMessage> mess
     replicatedNode->setLastHeardMicrostamp(usecTimestampNow());
 
     // construct a "fake" audio received message from the byte array and packet list information
-    auto audioData = message->getMessage().mid(NUM_BYTES_RFC4122_UUID);
+    auto audioData = message->readAll();
 
     PacketType rewrittenType = PacketTypeEnum::getReplicatedPacketMapping().key(message->getType());
 
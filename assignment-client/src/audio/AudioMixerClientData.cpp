@@ -154,7 +154,7 @@ void AudioMixerClientData::optionallyReplicatePacket(ReceivedMessage& message, c
                         packet->write(node.getUUID().toRfc4122());
                     }
 
-                    packet->write(message.getMessage());
+                    packet->write(message.getRawMessage(), message.getSize());
                 }
                 
                 nodeList->sendUnreliablePacket(*packet, *downstreamNode);
@@ -164,7 +164,7 @@ void AvatarMixer::optionallyReplicatePacket(ReceivedMessage& message, const Node
             if (!packet) {
                 // construct an NLPacket to send to the replicant that has the contents of the received packet
                 packet = NLPacket::create(replicatedType, message.getSize());
-                packet->write(message.getMessage());
+                packet->write(message.getRawMessage(), message.getSize());
             }
 
             nodeList->sendUnreliablePacket(*packet, *node);
@@ -77,7 +77,7 @@ void ScriptableAvatar::update(float deltatime) {
     }
 
     // Run animation
-    if (_animation && _animation->isLoaded() && _animation->getFrames().size() > 0 && !_bind.isNull() && _bind->isLoaded()) {
+    if (_animation && _animation->isLoaded() && _animation->getNumFrames() > 0 && !_bind.isNull() && _bind->isLoaded()) {
         if (!_animSkeleton) {
             _animSkeleton = std::make_shared<AnimSkeleton>(_bind->getGeometry());
         }
@@ -96,9 +96,11 @@ void ScriptableAvatar::update(float deltatime) {
                 _jointData.resize(nJoints);
             }
 
-            const int frameCount = _animation->getFrames().size();
-            const FBXAnimationFrame& floorFrame = _animation->getFrames().at((int)glm::floor(currentFrame) % frameCount);
-            const FBXAnimationFrame& ceilFrame = _animation->getFrames().at((int)glm::ceil(currentFrame) % frameCount);
+            const int frameCount = _animation->getNumFrames();
+            FBXAnimationFrame floorFrame;
+            FBXAnimationFrame ceilFrame;
+            _animation->getFrame((int)glm::floor(currentFrame) % frameCount, floorFrame);
+            _animation->getFrame((int)glm::ceil(currentFrame) % frameCount, ceilFrame);
             const float frameFraction = glm::fract(currentFrame);
             std::vector<AnimPose> poses = _animSkeleton->getRelativeDefaultPoses();
 
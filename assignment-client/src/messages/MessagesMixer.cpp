@@ -43,6 +43,11 @@ void MessagesMixer::handleMessages(QSharedPointer<ReceivedMessage> receivedMessa
     bool isText;
     MessagesClient::decodeMessagesPacket(receivedMessage, channel, isText, message, data, senderID);
 
+    if (!MessagesClient::canSendOnChannel(channel, senderNode->getPermissions())) {
+        HIFI_FDEBUG("Dropping message on restricted channel" << channel << "from" << senderNode->getUUID());
+        return;
+    }
+
     auto nodeList = DependencyManager::get<NodeList>();
 
     nodeList->eachMatchingNode(
@@ -13,6 +13,8 @@
 
 #include <mutex>
 
+#include <QtCore/QJsonObject>
+
 #include <AudioConstants.h>
 #include <AudioInjectorManager.h>
 #include <ClientServerUtils.h>
@@ -110,7 +112,10 @@ void EntityScriptServer::handleReloadEntityServerScriptPacket(QSharedPointer<Rec
 
         if (_entityViewer.getTree() && !_shuttingDown) {
             qCDebug(entity_script_server) << "Reloading: " << entityID;
-            _entitiesScriptEngine->unloadEntityScript(entityID);
+            auto engine = _entitiesScriptEngines->find(entityID);
+            if (engine) {
+                engine->unloadEntityScript(entityID);
+            }
             checkAndCallPreload(entityID, true);
         }
     }
@@ -126,7 +131,8 @@ void EntityScriptServer::handleEntityScriptGetStatusPacket(QSharedPointer<Receiv
         replyPacketList->writePrimitive(messageID);
 
         EntityScriptDetails details;
-        if (_entitiesScriptEngine->getEntityScriptDetails(entityID, details)) {
+        auto engine = _entitiesScriptEngines->find(entityID);
+        if (engine && engine->getEntityScriptDetails(entityID, details)) {
             replyPacketList->writePrimitive(true);
             replyPacketList->writePrimitive(details.status);
             replyPacketList->writeString(details.errorInfo);
@@ -168,10 +174,23 @@ void EntityScriptServer::handleSettings() {
 
     qDebug() << QString("Received entity script server settings, Max Entity PPS: %1, Entity PPS Per Entity Script: %2")
                 .arg(_maxEntityPPS).arg(_entityPPSPerScript);
+
+    static const QString SCRIPT_ENGINES_OPTION = "script_engines";
+    static const QString SCRIPT_ENGINE_PARTITION_OPTION = "script_engine_partition";
+    static const QString REBALANCE_SCRIPT_ENGINES_OPTION = "rebalance_script_engines";
+    static const int MAX_SCRIPT_ENGINES = 64;
+
+    _entitiesScriptEngines->setPartition(
+        EntityScriptEnginePool::partitionFromString(entityScriptServerSettings.value(SCRIPT_ENGINE_PARTITION_OPTION).toString()));
+    _rebalanceEntitiesScriptEngines = entityScriptServerSettings.value(REBALANCE_SCRIPT_ENGINES_OPTION).toBool(true);
+    setNumEntitiesScriptEngines(glm::clamp(entityScriptServerSettings.value(SCRIPT_ENGINES_OPTION).toInt(1), 1, MAX_SCRIPT_ENGINES));
 }
 
 void EntityScriptServer::updateEntityPPS() {
-    int numRunningScripts = _entitiesScriptEngine->getNumRunningEntityScripts();
+    int numRunningScripts = 0;
+    for (auto& engine : _entitiesScriptEngines->getEngines()) {
+        numRunningScripts += engine->getNumRunningEntityScripts();
+    }
     int pps;
     if (std::numeric_limits<int>::max() / _entityPPSPerScript < numRunningScripts) {
         qWarning() << QString("Integer multiplication would overflow, clamping to maxint: %1 * %2").arg(numRunningScripts).arg(_entityPPSPerScript);
@@ -233,7 +252,7 @@ void EntityScriptServer::pushLogs() {
 
 void EntityScriptServer::handleEntityScriptCallMethodPacket(QSharedPointer<ReceivedMessage> receivedMessage, SharedNodePointer senderNode) {
 
-    if (_entitiesScriptEngine && _entityViewer.getTree() && !_shuttingDown) {
+    if (_entitiesScriptEngines->getNumEngines() > 0 && _entityViewer.getTree() && !_shuttingDown) {
         auto entityID = QUuid::fromRfc4122(receivedMessage->read(NUM_BYTES_RFC4122_UUID));
 
         auto method = receivedMessage->readString();
@@ -247,7 +266,7 @@ void EntityScriptServer::handleEntityScriptCallMethodPacket(QSharedPointer<Recei
             params << paramString;
         }
 
-        _entitiesScriptEngine->callEntityScriptMethod(entityID, method, params, senderNode->getUUID());
+        _entitiesScriptEngines->callEntityScriptMethod(entityID, method, params, senderNode->getUUID());
     }
 }
 
@@ -262,6 +281,17 @@ void EntityScriptServer::run() {
     auto messagesClient = DependencyManager::set<MessagesClient>();
     messagesClient->startThread();
 
+    // let nodes with rez rights profile the entity scripts without restarting the server
+    messagesClient->subscribe(MessagesClient::SCRIPT_PROFILER_CHANNEL);
+    connect(messagesClient.data(), &MessagesClient::messageReceived, this,
+            [this](QString channel, QString message, QUuid senderID, bool localOnly) {
+        if (channel == MessagesClient::SCRIPT_PROFILER_CHANNEL && !_shuttingDown) {
+            for (auto& engine : _entitiesScriptEngines->getEngines()) {
+                engine->handleProfilerMessage(message, senderID);
+            }
+        }
+    });
+
     DomainHandler& domainHandler = DependencyManager::get<NodeList>()->getDomainHandler();
     connect(&domainHandler, &DomainHandler::settingsReceived, this, &EntityScriptServer::handleSettings);
 
@@ -274,8 +304,8 @@ void EntityScriptServer::run() {
         NodeType::EntityServer, NodeType::MessagesMixer, NodeType::AssetServer
     });
 
-    // Setup Script Engine
-    resetEntitiesScriptEngine();
+    // Setup Script Engines
+    resetEntitiesScriptEngines();
 
     auto entityScriptingInterface = DependencyManager::get<EntityScriptingInterface>();
     entityScriptingInterface->init();
@@ -430,7 +460,7 @@ void EntityScriptServer::selectAudioFormat(const QString& selectedCodecName) {
     }
 }
 
-void EntityScriptServer::resetEntitiesScriptEngine() {
+ScriptEnginePointer EntityScriptServer::createEntitiesScriptEngine(bool updatesEntityTree) {
     auto engineName = QString("about:Entities %1").arg(++_entitiesScriptEngineCount);
     auto newEngine = scriptEngineFactory(ScriptEngine::ENTITY_SERVER_SCRIPT, NO_SCRIPT, engineName);
 
@@ -446,44 +476,86 @@ void EntityScriptServer::resetEntitiesScriptEngine() {
     connect(newEngine.data(), &ScriptEngine::warningMessage, scriptEngines, &ScriptEngines::onWarningMessage);
     connect(newEngine.data(), &ScriptEngine::infoMessage, scriptEngines, &ScriptEngines::onInfoMessage);
 
-    connect(newEngine.data(), &ScriptEngine::update, this, [this] {
-        _entityViewer.queryOctree();
-        _entityViewer.getTree()->update();
-    });
+    // one engine is enough to keep the octree query and the entity tree going
+    if (updatesEntityTree) {
+        connect(newEngine.data(), &ScriptEngine::update, this, [this] {
+            _entityViewer.queryOctree();
+            _entityViewer.getTree()->update();
+        });
+    }
 
+    connect(newEngine.data(), &ScriptEngine::entityScriptDetailsUpdated,
+            this, &EntityScriptServer::updateEntityPPS);
 
     newEngine->runInThread();
-    auto newEngineSP = qSharedPointerCast<EntitiesScriptEngineProvider>(newEngine);
-    DependencyManager::get<EntityScriptingInterface>()->setEntitiesScriptEngine(newEngineSP);
+    return newEngine;
+}
 
-    disconnect(_entitiesScriptEngine.data(), &ScriptEngine::entityScriptDetailsUpdated,
-               this, &EntityScriptServer::updateEntityPPS);
-    _entitiesScriptEngine.swap(newEngine);
-    connect(_entitiesScriptEngine.data(), &ScriptEngine::entityScriptDetailsUpdated,
-            this, &EntityScriptServer::updateEntityPPS);
+void EntityScriptServer::resetEntitiesScriptEngines() {
+    for (auto& oldEngine : _entitiesScriptEngines->getEngines()) {
+        disconnect(oldEngine.data(), &ScriptEngine::entityScriptDetailsUpdated,
+                   this, &EntityScriptServer::updateEntityPPS);
+    }
+
+    std::vector<ScriptEnginePointer> newEngines;
+    for (int i = 0; i < _numEntitiesScriptEngines; i++) {
+        newEngines.push_back(createEntitiesScriptEngine(i == 0));
+    }
+    _entitiesScriptEngines->setEngines(newEngines);
+    _entityScriptLoads.clear();
+
+    // the pool routes calls into entity scripts to whichever engine runs them
+    DependencyManager::get<EntityScriptingInterface>()->setEntitiesScriptEngine(_entitiesScriptEngines);
 }
 
+void EntityScriptServer::stopEntitiesScriptEngines() {
+    auto engines = _entitiesScriptEngines->getEngines();
 
-void EntityScriptServer::clear() {
-    // unload and stop the engine
-    if (_entitiesScriptEngine) {
-        // do this here (instead of in deleter) to avoid marshalling unload signals back to this thread
-        _entitiesScriptEngine->unloadAllEntityScripts();
-        _entitiesScriptEngine->stop();
-        _entitiesScriptEngine->waitTillDoneRunning();
+    // do this here (instead of in deleter) to avoid marshalling unload signals back to this thread
+    for (auto& engine : engines) {
+        engine->unloadAllEntityScripts();
+        engine->stop();
+    }
+    for (auto& engine : engines) {
+        engine->waitTillDoneRunning();
+    }
+}
+
+void EntityScriptServer::setNumEntitiesScriptEngines(int numEngines) {
+    if (numEngines == _numEntitiesScriptEngines) {
+        return;
+    }
+    qCDebug(entity_script_server) << "Running entity scripts on" << numEngines << "script engines";
+    _numEntitiesScriptEngines = numEngines;
+
+    if (_shuttingDown || _entitiesScriptEngines->getNumEngines() == 0) {
+        return;
+    }
+
+    // restart the running scripts on the new engines
+    auto entityIDs = _entitiesScriptEngines->getAssignedEntities();
+    stopEntitiesScriptEngines();
+    resetEntitiesScriptEngines();
+    for (auto& entityID : entityIDs) {
+        checkAndCallPreload(entityID);
     }
+}
+
+void EntityScriptServer::clear() {
+    // unload and stop the engines
+    stopEntitiesScriptEngines();
 
     _entityViewer.clear();
 
-    // reset the engine
+    // reset the engines
     if (!_shuttingDown) {
-        resetEntitiesScriptEngine();
+        resetEntitiesScriptEngines();
     }
 }
 
 void EntityScriptServer::shutdownScriptEngine() {
-    if (_entitiesScriptEngine) {
-        _entitiesScriptEngine->disconnectNonEssentialSignals(); // disconnect all slots/signals from the script engine, except essential
+    for (auto& engine : _entitiesScriptEngines->getEngines()) {
+        engine->disconnectNonEssentialSignals(); // disconnect all slots/signals from the script engine, except essential
     }
     _shuttingDown = true;
 
@@ -495,37 +567,119 @@ void EntityScriptServer::addingEntity(const EntityItemID& entityID) {
 }
 
 void EntityScriptServer::deletingEntity(const EntityItemID& entityID) {
-    if (_entityViewer.getTree() && !_shuttingDown && _entitiesScriptEngine) {
-        _entitiesScriptEngine->unloadEntityScript(entityID, true);
+    if (_entityViewer.getTree() && !_shuttingDown) {
+        auto engine = _entitiesScriptEngines->find(entityID);
+        if (engine) {
+            engine->unloadEntityScript(entityID, true);
+            _entitiesScriptEngines->unassign(entityID);
+        }
+        _entityScriptLoads.remove(entityID);
     }
 }
 
 void EntityScriptServer::entityServerScriptChanging(const EntityItemID& entityID, bool reload) {
     if (_entityViewer.getTree() && !_shuttingDown) {
-        _entitiesScriptEngine->unloadEntityScript(entityID, true);
+        // the new script may belong on another engine
+        auto engine = _entitiesScriptEngines->find(entityID);
+        if (engine) {
+            engine->unloadEntityScript(entityID, true);
+            _entitiesScriptEngines->unassign(entityID);
+        }
         checkAndCallPreload(entityID, reload);
     }
 }
 
 void EntityScriptServer::checkAndCallPreload(const EntityItemID& entityID, bool reload) {
-    if (_entityViewer.getTree() && !_shuttingDown && _entitiesScriptEngine) {
+    if (_entityViewer.getTree() && !_shuttingDown && _entitiesScriptEngines->getNumEngines() > 0) {
 
         EntityItemPointer entity = _entityViewer.getTree()->findEntityByEntityItemID(entityID);
         EntityScriptDetails details;
-        bool notRunning = !_entitiesScriptEngine->getEntityScriptDetails(entityID, details);
+        auto engine = _entitiesScriptEngines->find(entityID);
+        bool notRunning = !engine || !engine->getEntityScriptDetails(entityID, details);
         if (entity && (reload || notRunning || details.scriptText != entity->getServerScripts())) {
             QString scriptUrl = entity->getServerScripts();
             if (!scriptUrl.isEmpty()) {
                 scriptUrl = DependencyManager::get<ResourceManager>()->normalizeURL(scriptUrl);
+                engine = _entitiesScriptEngines->assign(entityID, scriptUrl, entity->getWorldPosition());
                 qCDebug(entity_script_server) << "Loading entity server script" << scriptUrl << "for" << entityID;
-                _entitiesScriptEngine->loadEntityScript(entityID, scriptUrl, reload);
+                engine->loadEntityScript(entityID, scriptUrl, reload);
             }
         }
     }
 }
 
 void EntityScriptServer::sendStatsPacket() {
+    QJsonObject statsObject;
+    updateEntitiesScriptEngineLoads(statsObject);
+    ThreadedAssignment::addPacketStatsAndSendStatsPacket(statsObject);
+}
+
+void EntityScriptServer::updateEntitiesScriptEngineLoads(QJsonObject& statsObject) {
+    auto now = usecTimestampNow();
+    float elapsedSeconds = (_lastLoadUpdate > 0 && now > _lastLoadUpdate) ?
+        (float)(now - _lastLoadUpdate) / (float)USECS_PER_SECOND : 1.0f;
+    _lastLoadUpdate = now;
+
+    // per-entity loads are smoothed so that a single long frame doesn't move a script around
+    const float LOAD_SMOOTHING = 0.25f; // weight of the latest interval
+    for (auto& load : _entityScriptLoads) {
+        load *= (1.0f - LOAD_SMOOTHING);
+    }
+
+    auto engines = _entitiesScriptEngines->getEngines();
+    auto numAssigned = _entitiesScriptEngines->getNumAssigned();
+    QJsonObject enginesObject;
+    for (size_t i = 0; i < engines.size(); i++) {
+        quint64 engineUsecs = 0;
+        auto entityUsecs = engines[i]->takeEntityScriptUsecs();
+        for (auto it = entityUsecs.constBegin(); it != entityUsecs.constEnd(); ++it) {
+            engineUsecs += it.value();
+            _entityScriptLoads[it.key()] += LOAD_SMOOTHING * (float)it.value() / elapsedSeconds;
+        }
+
+        QJsonObject engineObject;
+        engineObject["entity_scripts"] = (i < numAssigned.size()) ? numAssigned[i] : 0;
+        engineObject["script_usecs_per_second"] = (double)engineUsecs / elapsedSeconds;
+        enginesObject[QString::number(i)] = engineObject;
+    }
+    statsObject["script_engines"] = enginesObject;
+
+    // forget the entities that aren't running a script anymore
+    for (auto it = _entityScriptLoads.begin(); it != _entityScriptLoads.end(); ) {
+        if (_entitiesScriptEngines->findIndex(it.key()) < 0) {
+            it = _entityScriptLoads.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    const quint64 REBALANCE_INTERVAL = 10 * USECS_PER_SECOND;
+    if (_rebalanceEntitiesScriptEngines && !_shuttingDown && now - _lastRebalance > REBALANCE_INTERVAL) {
+        rebalanceEntitiesScriptEngines();
+    }
+}
+
+void EntityScriptServer::rebalanceEntitiesScriptEngines() {
+    // moving a script reloads it, only worth it when the engines are a tenth of a core or more apart
+    const float MIN_REBALANCE_IMBALANCE = 0.1f * USECS_PER_SECOND;
+    auto move = _entitiesScriptEngines->chooseRebalanceMove(_entityScriptLoads, MIN_REBALANCE_IMBALANCE);
+    if (move.entities.isEmpty()) {
+        return;
+    }
 
+    qCDebug(entity_script_server) << "Moving" << move.entities.size() << "entity scripts using" << move.load
+        << "usecs per second from engine" << move.from << "to engine" << move.to;
+    for (const auto& entityID : move.entities) {
+        auto oldEngine = _entitiesScriptEngines->find(entityID);
+        if (oldEngine) {
+            oldEngine->unloadEntityScript(entityID, true);
+        }
+    }
+    _entitiesScriptEngines->applyRebalanceMove(move);
+    for (const auto& entityID : move.entities) {
+        checkAndCallPreload(entityID, true);
+    }
+    _lastRebalance = usecTimestampNow();
 }
 
 void EntityScriptServer::handleOctreePacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
@@ -19,6 +19,7 @@
 #include <QtCore/QUuid>
 
 #include <EntityEditPacketSender.h>
+#include <EntityScriptEnginePool.h>
 #include <plugins/CodecPlugin.h>
 #include <ScriptEngine.h>
 #include <ThreadedAssignment.h>
@@ -60,7 +61,10 @@ private:
     void negotiateAudioFormat();
     void selectAudioFormat(const QString& selectedCodecName);
 
-    void resetEntitiesScriptEngine();
+    ScriptEnginePointer createEntitiesScriptEngine(bool updatesEntityTree);
+    void resetEntitiesScriptEngines();
+    void stopEntitiesScriptEngines();
+    void setNumEntitiesScriptEngines(int numEngines);
     void clear();
     void shutdownScriptEngine();
 
@@ -69,12 +73,22 @@ private:
     void entityServerScriptChanging(const EntityItemID& entityID, bool reload);
     void checkAndCallPreload(const EntityItemID& entityID, bool reload = false);
 
+    void updateEntitiesScriptEngineLoads(QJsonObject& statsObject);
+    void rebalanceEntitiesScriptEngines();
+
     void cleanupOldKilledListeners();
 
     bool _shuttingDown { false };
 
     static int _entitiesScriptEngineCount;
-    ScriptEnginePointer _entitiesScriptEngine;
+    QSharedPointer<EntityScriptEnginePool> _entitiesScriptEngines { QSharedPointer<EntityScriptEnginePool>::create() };
+    int _numEntitiesScriptEngines { 1 };
+    bool _rebalanceEntitiesScriptEngines { true };
+
+    // microseconds per second recently spent in each entity's script
+    QHash<EntityItemID, float> _entityScriptLoads;
+    quint64 _lastLoadUpdate { 0 };
+    quint64 _lastRebalance { 0 };
     EntityEditPacketSender _entityEditSender;
     EntityTreeHeadlessViewer _entityViewer;
 
@@ -13,6 +13,7 @@
 
 #include <openssl/x509.h>
 
+#include <QtConcurrent/QtConcurrentRun>
 #include <QtCore/QJsonDocument>
 #include <QtCore/QTimer>
 #include <QtNetwork/QNetworkReply>
@@ -21,11 +22,16 @@
 #include <LimitedNodeList.h>
 #include <NetworkAccessManager.h>
 #include <NetworkingConstants.h>
+#include <NumericalConstants.h>
 #include <udt/PacketHeaders.h>
 #include <SharedUtil.h>
 
 const int CLEAR_INACTIVE_PEERS_INTERVAL_MSECS = 1 * 1000;
 const int PEER_SILENCE_THRESHOLD_MSECS = 5 * 1000;
+const quint64 PEER_SILENCE_THRESHOLD_USECS = PEER_SILENCE_THRESHOLD_MSECS * USECS_PER_MSEC;
+
+// heartbeats that arrive while this many verifications are queued are dropped, the domain-server will send another
+const size_t MAX_PENDING_HEARTBEAT_VERIFICATIONS = 1024;
 
 IceServer::IceServer(int argc, char* argv[]) :
     QCoreApplication(argc, argv),
@@ -73,20 +79,7 @@ void IceServer::processPacket(std::unique_ptr<udt::Packet> packet) {
     if (nlPacket->getPayloadSize() >= NLPacket::localHeaderSize(PacketType::ICEServerHeartbeat)) {
         
         if (nlPacket->getType() == PacketType::ICEServerHeartbeat) {
-            SharedNetworkPeer peer = addOrUpdateHeartbeatingPeer(*nlPacket);
-            if (peer) {
-                // so that we can send packets to the heartbeating peer when we need, we need to activate a socket now
-                peer->activateMatchingOrNewSymmetricSocket(nlPacket->getSenderSockAddr());
-
-                // we have an active and verified heartbeating peer
-                // send them an ACK packet so they know that they are being heard and ready for ICE
-                static auto ackPacket = NLPacket::create(PacketType::ICEServerHeartbeatACK);
-                _serverSocket.writePacket(*ackPacket, nlPacket->getSenderSockAddr());
-            } else {
-                // we couldn't verify this peer - respond back to them so they know they may need to perform keypair re-generation
-                static auto deniedPacket = NLPacket::create(PacketType::ICEServerHeartbeatDenied);
-                _serverSocket.writePacket(*deniedPacket, nlPacket->getSenderSockAddr());
-            }
+            processHeartbeat(*nlPacket);
         } else if (nlPacket->getType() == PacketType::ICEServerQuery) {
             QDataStream heartbeatStream(nlPacket.get());
             
@@ -123,47 +116,33 @@ void IceServer::processPacket(std::unique_ptr<udt::Packet> packet) {
     }
 }
 
-SharedNetworkPeer IceServer::addOrUpdateHeartbeatingPeer(NLPacket& packet) {
-
+void IceServer::processHeartbeat(NLPacket& packet) {
     // pull the UUID, public and private sock addrs for this peer
-    QUuid senderUUID;
-    HifiSockAddr publicSocket, localSocket;
+    Heartbeat heartbeat;
     QByteArray signature;
 
     QDataStream heartbeatStream(&packet);
-    heartbeatStream >> senderUUID >> publicSocket >> localSocket;
+    heartbeatStream >> heartbeat.senderUUID >> heartbeat.publicSocket >> heartbeat.localSocket;
 
     auto signedPlaintext = QByteArray::fromRawData(packet.getPayload(), heartbeatStream.device()->pos());
     heartbeatStream >> signature;
 
-    // make sure this is a verified heartbeat before performing any more processing
-    if (isVerifiedHeartbeat(senderUUID, signedPlaintext, signature)) {
-        // make sure we have this sender in our peer hash
-        SharedNetworkPeer matchingPeer = _activePeers.value(senderUUID);
+    heartbeat.senderSockAddr = packet.getSenderSockAddr();
 
-        if (!matchingPeer) {
-            // if we don't have this sender we need to create them now
-            matchingPeer = QSharedPointer<NetworkPeer>::create(senderUUID, publicSocket, localSocket);
-            _activePeers.insert(senderUUID, matchingPeer);
+    QCryptographicHash sessionHash(QCryptographicHash::Sha256);
+    sessionHash.addData(signedPlaintext);
+    sessionHash.addData(signature);
+    heartbeat.sessionHash = sessionHash.result();
 
-            qDebug() << "Added a new network peer" << *matchingPeer;
-        } else {
-            // we already had the peer so just potentially update their sockets
-            matchingPeer->setPublicSocket(publicSocket);
-            matchingPeer->setLocalSocket(localSocket);
-        }
+    const QUuid& domainID = heartbeat.senderUUID;
 
-        // update our last heard microstamp for this network peer to now
-        matchingPeer->setLastHeardMicrostamp(usecTimestampNow());
-        
-        return matchingPeer;
-    } else {
-        // not verified, return the empty peer object
-        return SharedNetworkPeer();
+    // if this is the same signed heartbeat we last verified for this domain there is no need to check the signature again
+    auto sessionIt = _verifiedSessions.find(domainID);
+    if (sessionIt != _verifiedSessions.end() && sessionIt->second == heartbeat.sessionHash) {
+        heartbeatVerified(heartbeat);
+        return;
     }
-}
 
-bool IceServer::isVerifiedHeartbeat(const QUuid& domainID, const QByteArray& plaintext, const QByteArray& signature) {
     // make sure we're not already waiting for a public key for this domain-server
     if (!_pendingPublicKeyRequests.contains(domainID)) {
         // check if we have a public key for this domain ID - if we do not then fire off the request for it
@@ -171,24 +150,33 @@ bool IceServer::isVerifiedHeartbeat(const QUuid& domainID, const QByteArray& pla
         if (it != _domainPublicKeys.end()) {
 
             // attempt to verify the signature for this heartbeat
-            const auto rsaPublicKey = it->second.get();
+            auto rsaPublicKey = it->second;
 
             if (rsaPublicKey) {
-                auto hashedPlaintext = QCryptographicHash::hash(plaintext, QCryptographicHash::Sha256);
-                int verificationResult = RSA_verify(NID_sha256,
-                                                    reinterpret_cast<const unsigned char*>(hashedPlaintext.constData()),
-                                                    hashedPlaintext.size(),
-                                                    reinterpret_cast<const unsigned char*>(signature.constData()),
-                                                    signature.size(),
-                                                    rsaPublicKey);
-
-                if (verificationResult == 1) {
-                    // this is the only success case - we return true here to indicate that the heartbeat is verified
-                    return true;
-                } else {
-                    qDebug() << "Failed to verify heartbeat for" << domainID << "- re-requesting public key from API.";
+                if (_pendingVerifications.find(domainID) != _pendingVerifications.end()
+                    || _pendingVerifications.size() >= MAX_PENDING_HEARTBEAT_VERIFICATIONS) {
+                    // we're already verifying a heartbeat for this domain or we have too many verifications queued
+                    // drop this heartbeat, the domain-server will send another one
+                    return;
                 }
 
+                _pendingVerifications[domainID] = heartbeat;
+
+                auto plaintext = QByteArray(signedPlaintext.constData(), signedPlaintext.size());
+                QtConcurrent::run(&_verificationThreadPool, [this, domainID, plaintext, signature, rsaPublicKey] {
+                    auto hashedPlaintext = QCryptographicHash::hash(plaintext, QCryptographicHash::Sha256);
+                    int verificationResult = RSA_verify(NID_sha256,
+                                                        reinterpret_cast<const unsigned char*>(hashedPlaintext.constData()),
+                                                        hashedPlaintext.size(),
+                                                        reinterpret_cast<const unsigned char*>(signature.constData()),
+                                                        signature.size(),
+                                                        rsaPublicKey.get());
+
+                    QMetaObject::invokeMethod(this, "heartbeatVerificationFinished", Qt::QueuedConnection,
+                                              Q_ARG(QUuid, domainID), Q_ARG(bool, verificationResult == 1));
+                });
+
+                return;
             } else {
                 // we can't let this user in since we couldn't convert their public key to an RSA key we could use
                 qWarning() << "Public key for" << domainID << "is not a usable RSA* public key.";
@@ -196,12 +184,77 @@ bool IceServer::isVerifiedHeartbeat(const QUuid& domainID, const QByteArray& pla
             }
         }
 
-        // we could not verify this heartbeat (missing public key, could not load public key, bad actor)
-        // ask the metaverse API for the right public key and return false to indicate that this is not verified
+        // we could not verify this heartbeat (missing public key, could not load public key)
+        // ask the metaverse API for the right public key
+        requestDomainPublicKey(domainID);
+    }
+
+    heartbeatDenied(heartbeat.senderSockAddr);
+}
+
+void IceServer::heartbeatVerificationFinished(QUuid domainID, bool verified) {
+    auto it = _pendingVerifications.find(domainID);
+    if (it == _pendingVerifications.end()) {
+        return;
+    }
+
+    auto heartbeat = it->second;
+    _pendingVerifications.erase(it);
+
+    if (verified) {
+        // remember this heartbeat so that repeats of it skip verification
+        _verifiedSessions[domainID] = heartbeat.sessionHash;
+        heartbeatVerified(heartbeat);
+    } else {
+        qDebug() << "Failed to verify heartbeat for" << domainID << "- re-requesting public key from API.";
+
+        _verifiedSessions.erase(domainID);
         requestDomainPublicKey(domainID);
+        heartbeatDenied(heartbeat.senderSockAddr);
     }
+}
 
-    return false;
+void IceServer::heartbeatVerified(const Heartbeat& heartbeat) {
+    SharedNetworkPeer peer = addOrUpdateHeartbeatingPeer(heartbeat);
+
+    // so that we can send packets to the heartbeating peer when we need, we need to activate a socket now
+    peer->activateMatchingOrNewSymmetricSocket(heartbeat.senderSockAddr);
+
+    // we have an active and verified heartbeating peer
+    // send them an ACK packet so they know that they are being heard and ready for ICE
+    static auto ackPacket = NLPacket::create(PacketType::ICEServerHeartbeatACK);
+    _serverSocket.writePacket(*ackPacket, heartbeat.senderSockAddr);
+}
+
+void IceServer::heartbeatDenied(const HifiSockAddr& senderSockAddr) {
+    // we couldn't verify this peer - respond back to them so they know they may need to perform keypair re-generation
+    static auto deniedPacket = NLPacket::create(PacketType::ICEServerHeartbeatDenied);
+    _serverSocket.writePacket(*deniedPacket, senderSockAddr);
+}
+
+SharedNetworkPeer IceServer::addOrUpdateHeartbeatingPeer(const Heartbeat& heartbeat) {
+    // make sure we have this sender in our peer hash
+    SharedNetworkPeer matchingPeer = _activePeers.value(heartbeat.senderUUID);
+
+    // update our last heard microstamp for this network peer to now
+    auto now = usecTimestampNow();
+
+    if (!matchingPeer) {
+        // if we don't have this sender we need to create them now
+        matchingPeer = QSharedPointer<NetworkPeer>::create(heartbeat.senderUUID, heartbeat.publicSocket, heartbeat.localSocket);
+        _activePeers.insert(heartbeat.senderUUID, matchingPeer);
+        _peerExpiryQueue.push({ now + PEER_SILENCE_THRESHOLD_USECS, heartbeat.senderUUID });
+
+        qDebug() << "Added a new network peer" << *matchingPeer;
+    } else {
+        // we already had the peer so just potentially update their sockets
+        matchingPeer->setPublicSocket(heartbeat.publicSocket);
+        matchingPeer->setLocalSocket(heartbeat.localSocket);
+    }
+
+    matchingPeer->setLastHeardMicrostamp(now);
+
+    return matchingPeer;
 }
 
 void IceServer::requestDomainPublicKey(const QUuid& domainID) {
@@ -253,7 +306,10 @@ void IceServer::publicKeyReplyFinished(QNetworkReply* reply) {
                 RSA* rsaPublicKey = d2i_RSA_PUBKEY(NULL, &publicKeyData, apiPublicKey.size());
 
                 if (rsaPublicKey) {
-                    _domainPublicKeys[domainID] = { rsaPublicKey, RSA_free };
+                    _domainPublicKeys[domainID] = RSASharedPtr(rsaPublicKey, RSA_free);
+
+                    // heartbeats verified against a previous key need to be verified again
+                    _verifiedSessions.erase(domainID);
                 } else {
                     qWarning() << "Could not convert in-memory public key for" << domainID << "to usable RSA public key.";
                     qWarning() << "Public key will be re-requested on next heartbeat.";
@@ -290,22 +346,31 @@ void IceServer::sendPeerInformationPacket(const NetworkPeer& peer, const HifiSoc
 }
 
 void IceServer::clearInactivePeers() {
-    NetworkPeerHash::iterator peerItem = _activePeers.begin();
+    auto now = usecTimestampNow();
+
+    // only peers whose expiry has come up need to be looked at
+    while (!_peerExpiryQueue.empty() && _peerExpiryQueue.top().first <= now) {
+        QUuid peerID = _peerExpiryQueue.top().second;
+        _peerExpiryQueue.pop();
 
-    while (peerItem != _activePeers.end()) {
-        SharedNetworkPeer peer = peerItem.value();
+        SharedNetworkPeer peer = _activePeers.value(peerID);
+        if (!peer) {
+            continue;
+        }
 
-        if ((usecTimestampNow() - peer->getLastHeardMicrostamp()) > (PEER_SILENCE_THRESHOLD_MSECS * 1000)) {
+        auto expiry = peer->getLastHeardMicrostamp() + PEER_SILENCE_THRESHOLD_USECS;
+        if (expiry > now) {
+            // we've heard from this peer since it was queued, push it back with its new expiry
+            _peerExpiryQueue.push({ expiry, peerID });
+        } else {
             qDebug() << "Removing peer from memory for inactivity -" << *peer;
 
             // if we had a public key for this domain, remove it now
-            _domainPublicKeys.erase(peer->getUUID());
+            _domainPublicKeys.erase(peerID);
+            _verifiedSessions.erase(peerID);
 
             // remove the peer object
-            peerItem = _activePeers.erase(peerItem);
-        } else {
-            // we didn't kill this peer, push the iterator forwards
-            ++peerItem;
+            _activePeers.remove(peerID);
         }
     }
 }
@@ -12,8 +12,11 @@
 #ifndef hifi_IceServer_h
 #define hifi_IceServer_h
 
+#include <queue>
+
 #include <QtCore/QCoreApplication>
 #include <QtCore/QSharedPointer>
+#include <QtCore/QThreadPool>
 #include <QUdpSocket>
 
 #include <openssl/rsa.h>
@@ -35,14 +38,26 @@ public:
 private slots:
     void clearInactivePeers();
     void publicKeyReplyFinished(QNetworkReply* reply);
+    void heartbeatVerificationFinished(QUuid domainID, bool verified);
 private:
+    struct Heartbeat {
+        QUuid senderUUID;
+        HifiSockAddr publicSocket;
+        HifiSockAddr localSocket;
+        HifiSockAddr senderSockAddr;
+        QByteArray sessionHash; // hash of the signed plaintext and signature, identifies a repeated heartbeat
+    };
+
     bool packetVersionMatch(const udt::Packet& packet);
     void processPacket(std::unique_ptr<udt::Packet> packet);
-    
-    SharedNetworkPeer addOrUpdateHeartbeatingPeer(NLPacket& incomingPacket);
+
+    void processHeartbeat(NLPacket& packet);
+    void heartbeatVerified(const Heartbeat& heartbeat);
+    void heartbeatDenied(const HifiSockAddr& senderSockAddr);
+
+    SharedNetworkPeer addOrUpdateHeartbeatingPeer(const Heartbeat& heartbeat);
     void sendPeerInformationPacket(const NetworkPeer& peer, const HifiSockAddr* destinationSockAddr);
 
-    bool isVerifiedHeartbeat(const QUuid& domainID, const QByteArray& plaintext, const QByteArray& signature);
     void requestDomainPublicKey(const QUuid& domainID);
 
     QUuid _id;
@@ -51,11 +66,24 @@ private:
     using NetworkPeerHash = QHash<QUuid, SharedNetworkPeer>;
     NetworkPeerHash _activePeers;
 
-    using RSAUniquePtr = std::unique_ptr<RSA, std::function<void(RSA*)>>;
-    using DomainPublicKeyHash = std::unordered_map<QUuid, RSAUniquePtr>;
+    // min-heap of the time (in usecs) at which each active peer expires if it is not heard from again
+    // entries are only refreshed when they reach the top, so heartbeats do not touch the heap
+    using PeerExpiry = std::pair<quint64, QUuid>;
+    std::priority_queue<PeerExpiry, std::vector<PeerExpiry>, std::greater<PeerExpiry>> _peerExpiryQueue;
+
+    // public keys are shared with the verification workers, which may still hold one after the domain is removed
+    using RSASharedPtr = std::shared_ptr<RSA>;
+    using DomainPublicKeyHash = std::unordered_map<QUuid, RSASharedPtr>;
     DomainPublicKeyHash _domainPublicKeys;
 
     QSet<QUuid> _pendingPublicKeyRequests;
+
+    // RSA verification of heartbeats happens on this pool, at most one verification is in flight per domain
+    QThreadPool _verificationThreadPool;
+    std::unordered_map<QUuid, Heartbeat> _pendingVerifications;
+
+    // session hash of the last verified heartbeat for each domain - an identical heartbeat skips RSA verification
+    std::unordered_map<QUuid, QByteArray> _verifiedSessions;
 };
 
 #endif // hifi_IceServer_h
@@ -125,6 +125,7 @@
 #include <SceneScriptingInterface.h>
 #include <ScriptEngines.h>
 #include <ScriptCache.h>
+#include <ShapeCache.h>
 #include <ShapeEntityItem.h>
 #include <SoundCache.h>
 #include <ui/TabletScriptingInterface.h>
@@ -932,6 +933,7 @@ bool setupEssentials(int& argc, char** argv, bool runningMarkerExisted) {
     DependencyManager::set<Snapshot>();
     DependencyManager::set<CloseEventSender>();
     DependencyManager::set<ResourceManager>();
+    DependencyManager::get<ResourceManager>()->setCacheDir(PathUtils::getAppLocalDataPath());
     DependencyManager::set<SelectionScriptingInterface>();
     DependencyManager::set<Ledger>();
     DependencyManager::set<Wallet>();
@@ -4915,6 +4917,10 @@ void Application::init() {
         return atan2(maxSize, distance);
     });
 
+    auto shapeCache = std::make_shared<ShapeCache>();
+    shapeCache->initialize();
+    _shapeManager.setShapeCache(shapeCache);
+    _shapeManager.setBuildShapesAsync(true);
     ObjectMotionState::setShapeManager(&_shapeManager);
     _physicsEngine->init();
 
@@ -5670,6 +5676,7 @@ void Application::update(float deltaTime) {
                             PerformanceTimer perfTimer("handleChanges");
 
                             const VectorOfMotionStates& outgoingChanges = _physicsEngine->getChangedMotionStates();
+                            _entitySimulation->setViews(getConicalViews());
                             _entitySimulation->handleChangedMotionStates(outgoingChanges);
                             avatarManager->handleChangedMotionStates(outgoingChanges);
 
@@ -8080,6 +8087,11 @@ void Application::setShowBulletConstraintLimits(bool value) {
     _physicsEngine->setShowBulletConstraintLimits(value);
 }
 
+void Application::setMultithreadedPhysics(bool value) {
+    // leave the other half of the cores to rendering, audio and networking
+    _physicsEngine->setNumWorkerThreads(value ? std::max(1, QThread::idealThreadCount() / 2) : 1);
+}
+
 void Application::startHMDStandBySession() {
     _autoSwitchDisplayModeSupportedHMDPlugin->startStandBySession();
 }
@@ -129,6 +129,7 @@ namespace MenuOption {
     const QString MeshVisible = "Draw Mesh";
     const QString MuteEnvironment = "Mute Environment";
     const QString MuteFaceTracking = "Mute Face Tracking";
+    const QString MultithreadedPhysics = "Multithreaded Physics";
     const QString NamesAboveHeads = "Names Above Heads";
     const QString Networking = "Networking...";
     const QString NoFaceTracking = "None";
@@ -31,6 +31,7 @@
 #include <AvatarData.h>
 #include <PerfStat.h>
 #include <PrioritySortUtil.h>
+#include <Profile.h>
 #include <RegisteredMetaTypes.h>
 #include <Rig.h>
 #include <SettingHandle.h>
@@ -177,6 +178,36 @@ void AvatarManager::updateOtherAvatars(float deltaTime) {
         ++itr;
     }
 
+    // pull the avatars out in priority order and pick the ones that get new joints this frame:
+    // those in view whose level of detail says it is their turn
+    const float OUT_OF_VIEW_THRESHOLD = 0.5f * AvatarData::OUT_OF_VIEW_PENALTY;
+    auto nodeList = DependencyManager::get<NodeList>();
+    std::vector<SortableAvatar> sortedAvatarVector;
+    std::vector<bool> jointUpdates;
+    std::vector<Avatar*> rigUpdates;
+    sortedAvatarVector.reserve(sortedAvatars.size());
+    jointUpdates.reserve(sortedAvatars.size());
+    while (!sortedAvatars.empty()) {
+        const SortableAvatar& sortData = sortedAvatars.top();
+        const auto avatar = std::static_pointer_cast<Avatar>(sortData.getAvatar());
+        bool updateJoints = false;
+        if (sortData.getPriority() > OUT_OF_VIEW_THRESHOLD && !nodeList->isPersonalMutingNode(avatar->getID())) {
+            float distance = std::numeric_limits<float>::max();
+            for (const auto& view : views) {
+                distance = glm::min(distance, glm::distance(view.getPosition(), avatar->getWorldPosition()));
+            }
+            int interval = AnimJobPool::computeUpdateInterval(avatar->getBoundingRadius(), distance);
+            updateJoints = AnimJobPool::isUpdateDue(_animationFrameCount, interval, qHash(avatar->getID()));
+        }
+        if (updateJoints && avatar->hasNewJointData()) {
+            rigUpdates.push_back(avatar.get());
+        }
+        sortedAvatarVector.push_back(sortData);
+        jointUpdates.push_back(updateJoints);
+        sortedAvatars.pop();
+    }
+    ++_animationFrameCount;
+
     // process in sorted order
     uint64_t startTime = usecTimestampNow();
     const uint64_t UPDATE_BUDGET = 2000; // usec
@@ -184,14 +215,23 @@ void AvatarManager::updateOtherAvatars(float deltaTime) {
     int numAvatarsUpdated = 0;
     int numAVatarsNotUpdated = 0;
 
+    {
+        // copying joints into the rigs is independent per avatar, so it runs on the worker pool
+        // and simulate() below picks up the results
+        PROFILE_RANGE_EX(simulation, "updateRigs", 0xffff00ff, (uint64_t)rigUpdates.size());
+        _animJobPool.run(rigUpdates.size(), [&](size_t i) {
+            rigUpdates[i]->updateRigFromJointData();
+        });
+    }
+
+    std::vector<Avatar*> simulatedAvatars;
     render::Transaction transaction;
-    while (!sortedAvatars.empty()) {
-        const SortableAvatar& sortData = sortedAvatars.top();
+    for (size_t i = 0; i < sortedAvatarVector.size(); ++i) {
+        const SortableAvatar& sortData = sortedAvatarVector[i];
         const auto avatar = std::static_pointer_cast<Avatar>(sortData.getAvatar());
 
-        bool ignoring = DependencyManager::get<NodeList>()->isPersonalMutingNode(avatar->getID());
+        bool ignoring = nodeList->isPersonalMutingNode(avatar->getID());
         if (ignoring) {
-            sortedAvatars.pop();
             continue;
         }
 
@@ -213,17 +253,20 @@ void AvatarManager::updateOtherAvatars(float deltaTime) {
         }
         avatar->animateScaleChanges(deltaTime);
 
-        const float OUT_OF_VIEW_THRESHOLD = 0.5f * AvatarData::OUT_OF_VIEW_PENALTY;
         uint64_t now = usecTimestampNow();
         if (now < updateExpiry) {
             // we're within budget
             bool inView = sortData.getPriority() > OUT_OF_VIEW_THRESHOLD;
-            if (inView && avatar->hasNewJointData()) {
+            bool updateJoints = jointUpdates[i];
+            if (updateJoints && avatar->hasNewJointData()) {
                 numAvatarsUpdated++;
             }
-            avatar->simulate(deltaTime, inView);
+            avatar->simulate(deltaTime, inView, updateJoints);
             avatar->updateRenderItem(transaction);
             avatar->setLastRenderUpdateTime(startTime);
+            if (updateJoints) {
+                simulatedAvatars.push_back(avatar.get());
+            }
         } else {
             // we've spent our full time budget --> bail on the rest of the avatar updates
             // --> more avatars may freeze until their priority trickles up
@@ -231,26 +274,32 @@ void AvatarManager::updateOtherAvatars(float deltaTime) {
             // --> some avatar velocity measurements may be a little off
 
             // no time simulate, but we take the time to count how many were tragically missed
-            bool inView = sortData.getPriority() > OUT_OF_VIEW_THRESHOLD;
-            if (!inView) {
-                break;
-            }
-            if (inView && avatar->hasNewJointData()) {
-                numAVatarsNotUpdated++;
-            }
-            sortedAvatars.pop();
-            while (inView && !sortedAvatars.empty()) {
-                const SortableAvatar& newSortData = sortedAvatars.top();
-                const auto newAvatar = std::static_pointer_cast<Avatar>(newSortData.getAvatar());
-                inView = newSortData.getPriority() > OUT_OF_VIEW_THRESHOLD;
-                if (inView && newAvatar->hasNewJointData()) {
+            // and drop the joints copied into their rigs, newer ones may arrive before they next simulate
+            for (size_t j = i; j < sortedAvatarVector.size(); ++j) {
+                const SortableAvatar& missedSortData = sortedAvatarVector[j];
+                bool inView = missedSortData.getPriority() > OUT_OF_VIEW_THRESHOLD;
+                if (!inView) {
+                    break;
+                }
+                const auto missedAvatar = std::static_pointer_cast<Avatar>(missedSortData.getAvatar());
+                if (jointUpdates[j]) {
+                    missedAvatar->discardRigUpdate();
+                }
+                if (missedAvatar->hasNewJointData()) {
                     numAVatarsNotUpdated++;
                 }
-                sortedAvatars.pop();
             }
             break;
         }
-        sortedAvatars.pop();
+    }
+
+    {
+        // Build the cluster matrices here on the worker pool rather than one model at a time in the
+        // post update lambdas, which then find them up to date and just hand them to the render items.
+        PROFILE_RANGE_EX(simulation, "clusterMatrices", 0xffff00ff, (uint64_t)simulatedAvatars.size());
+        _animJobPool.run(simulatedAvatars.size(), [&](size_t i) {
+            simulatedAvatars[i]->getSkeletonModel()->updateClusterMatrices();
+        });
     }
 
     if (_shouldRender) {
@@ -16,6 +16,7 @@
 #include <QtCore/QObject>
 #include <QtCore/QSharedPointer>
 
+#include <AnimJobPool.h>
 #include <AvatarHashMap.h>
 #include <PhysicsEngine.h>
 #include <PIDController.h>
@@ -178,6 +179,8 @@ private:
     int _numAvatarsUpdated { 0 };
     int _numAvatarsNotUpdated { 0 };
     float _avatarSimulationTime { 0.0f };
+    AnimJobPool _animJobPool;
+    uint32_t _animationFrameCount { 0 };
     bool _shouldRender { true };
 };
 
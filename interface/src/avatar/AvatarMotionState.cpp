@@ -46,7 +46,7 @@ PhysicsMotionType AvatarMotionState::computePhysicsMotionType() const {
 const btCollisionShape* AvatarMotionState::computeNewShape() {
     ShapeInfo shapeInfo;
     std::static_pointer_cast<Avatar>(_avatar)->computeShapeInfo(shapeInfo);
-    return getShapeManager()->getShape(shapeInfo);
+    return requestShape(shapeInfo);
 }
 
 // virtual
@@ -177,6 +177,16 @@ void setupPreferences() {
         preferences->addPreference(preference);
     }
 
+    {
+        auto getter = []()->float { return qApp->getEntities()->getEntityScriptLoadDistance(); };
+        auto setter = [](float value) { qApp->getEntities()->setEntityScriptLoadDistance(value); };
+        auto preference = new SpinnerPreference(LOD_TUNING, "Entity script load distance (meters, 0 loads all)", getter, setter);
+        preference->setMin(0);
+        preference->setMax(1000);
+        preference->setStep(10);
+        preferences->addPreference(preference);
+    }
+
     static const QString AVATAR_TUNING { "Avatar Tuning" };
     {
         auto getter = [=]()->QString { return myAvatar->getDominantHand(); };
@@ -527,8 +527,7 @@ void ModelOverlay::animate() {
 
     QVector<JointData> jointsData;
 
-    const QVector<FBXAnimationFrame>&  frames = _animation->getFramesReference(); // NOTE: getFrames() is too heavy
-    int frameCount = frames.size();
+    int frameCount = _animation->getNumFrames();
     if (frameCount <= 0) {
         return;
     }
@@ -564,8 +563,12 @@ void ModelOverlay::animate() {
     auto& originalFbxJoints = _model->getFBXGeometry().joints;
     auto& originalFbxIndices = _model->getFBXGeometry().jointIndices;
 
-    const QVector<glm::quat>& rotations = frames[_lastKnownCurrentFrame].rotations;
-    const QVector<glm::vec3>& translations = frames[_lastKnownCurrentFrame].translations;
+    FBXAnimationFrame frame;
+    if (!_animation->getFrame(_lastKnownCurrentFrame, frame)) {
+        return;
+    }
+    const QVector<glm::quat>& rotations = frame.rotations;
+    const QVector<glm::vec3>& translations = frame.translations;
 
     jointsData.resize(_jointMapping.size());
     for (int j = 0; j < _jointMapping.size(); j++) {
@@ -49,12 +49,7 @@ const AnimPoseVec& AnimClip::evaluate(const AnimVariantMap& animVars, const Anim
         _networkAnim.reset();
     }
 
-    if (_anim.size()) {
-
-        // lazy creation of mirrored animation frames.
-        if (_mirrorFlag && _anim.size() != _mirrorAnim.size()) {
-            buildMirrorAnim();
-        }
+    if (_compressedAnim && _compressedAnim->getNumFrames() > 0) {
 
         int prevIndex = (int)glm::floor(_frame);
         int nextIndex;
@@ -66,15 +61,26 @@ const AnimPoseVec& AnimClip::evaluate(const AnimVariantMap& animVars, const Anim
 
         // It can be quite possible for the user to set _startFrame and _endFrame to
         // values before or past valid ranges.  We clamp the frames here.
-        int frameCount = (int)_anim.size();
+        int frameCount = _compressedAnim->getNumFrames();
         prevIndex = std::min(std::max(0, prevIndex), frameCount - 1);
         nextIndex = std::min(std::max(0, nextIndex), frameCount - 1);
-
-        const AnimPoseVec& prevFrame = _mirrorFlag ? _mirrorAnim[prevIndex] : _anim[prevIndex];
-        const AnimPoseVec& nextFrame = _mirrorFlag ? _mirrorAnim[nextIndex] : _anim[nextIndex];
         float alpha = glm::fract(_frame);
 
-        ::blend(_poses.size(), &prevFrame[0], &nextFrame[0], alpha, &_poses[0]);
+        if (nextIndex == prevIndex) {
+            sampleFrame((float)prevIndex, _poses);
+        } else if (nextIndex == prevIndex + 1) {
+            // the curves interpolate between adjacent frames themselves
+            sampleFrame((float)prevIndex + alpha, _poses);
+        } else {
+            // wrapping around the end of a loop
+            sampleFrame((float)prevIndex, _poses);
+            sampleFrame((float)nextIndex, _nextPoses);
+            ::blend(_poses.size(), &_poses[0], &_nextPoses[0], alpha, &_poses[0]);
+        }
+
+        if (_mirrorFlag) {
+            _skeleton->mirrorRelativePoses(_poses);
+        }
     }
 
     return _poses;
@@ -95,88 +101,70 @@ void AnimClip::setCurrentFrameInternal(float frame) {
 
 void AnimClip::copyFromNetworkAnim() {
     assert(_networkAnim && _networkAnim->isLoaded() && _skeleton);
-    _anim.clear();
+    _mappedJoints.clear();
+    _compressedAnim = _networkAnim->getCompressedAnimation();
+    if (!_compressedAnim) {
+        return;
+    }
 
     // build a mapping from animation joint indices to skeleton joint indices.
     // by matching joints with the same name.
     const FBXGeometry& geom = _networkAnim->getGeometry();
     AnimSkeleton animSkeleton(geom);
-    const auto animJointCount = animSkeleton.getNumJoints();
+    const auto animJointCount = std::min(animSkeleton.getNumJoints(), _compressedAnim->getNumJoints());
     const auto skeletonJointCount = _skeleton->getNumJoints();
-    std::vector<int> jointMap;
-    jointMap.reserve(animJointCount);
-    for (int i = 0; i < animJointCount; i++) {
-        int skeletonJoint = _skeleton->nameToJointIndex(animSkeleton.getJointName(i));
+    _mappedJoints.reserve(animJointCount);
+    for (int animJoint = 0; animJoint < animJointCount; animJoint++) {
+        int skeletonJoint = _skeleton->nameToJointIndex(animSkeleton.getJointName(animJoint));
         if (skeletonJoint == -1) {
-            qCWarning(animation) << "animation contains joint =" << animSkeleton.getJointName(i) << " which is not in the skeleton, url =" << _url;
+            qCWarning(animation) << "animation contains joint =" << animSkeleton.getJointName(animJoint) << " which is not in the skeleton, url =" << _url;
         }
-        jointMap.push_back(skeletonJoint);
-    }
-
-    const int frameCount = geom.animationFrames.size();
-    _anim.resize(frameCount);
-
-    for (int frame = 0; frame < frameCount; frame++) {
-
-        const FBXAnimationFrame& fbxAnimFrame = geom.animationFrames[frame];
 
-        // init all joints in animation to default pose
-        // this will give us a resonable result for bones in the model skeleton but not in the animation.
-        _anim[frame].reserve(skeletonJointCount);
-        for (int skeletonJoint = 0; skeletonJoint < skeletonJointCount; skeletonJoint++) {
-            _anim[frame].push_back(_skeleton->getRelativeDefaultPose(skeletonJoint));
+        // skip joints that are in the animation but not in the skeleton.
+        if (skeletonJoint < 0 || skeletonJoint >= skeletonJointCount) {
+            continue;
         }
 
-        for (int animJoint = 0; animJoint < animJointCount; animJoint++) {
-            int skeletonJoint = jointMap[animJoint];
-
-            const glm::vec3& fbxAnimTrans = fbxAnimFrame.translations[animJoint];
-            const glm::quat& fbxAnimRot = fbxAnimFrame.rotations[animJoint];
-
-            // skip joints that are in the animation but not in the skeleton.
-            if (skeletonJoint >= 0 && skeletonJoint < skeletonJointCount) {
-
-                AnimPose preRot, postRot;
-                preRot = animSkeleton.getPreRotationPose(animJoint);
-                postRot = animSkeleton.getPostRotationPose(animJoint);
-
-                // cancel out scale
-                preRot.scale() = glm::vec3(1.0f);
-                postRot.scale() = glm::vec3(1.0f);
-
-                AnimPose rot(glm::vec3(1.0f), fbxAnimRot, glm::vec3());
-
-                // adjust translation offsets, so large translation animatons on the reference skeleton
-                // will be adjusted when played on a skeleton with short limbs.
-                const glm::vec3& fbxZeroTrans = geom.animationFrames[0].translations[animJoint];
-                const AnimPose& relDefaultPose = _skeleton->getRelativeDefaultPose(skeletonJoint);
-                float boneLengthScale = 1.0f;
-                const float EPSILON = 0.0001f;
-                if (fabsf(glm::length(fbxZeroTrans)) > EPSILON) {
-                    boneLengthScale = glm::length(relDefaultPose.trans()) / glm::length(fbxZeroTrans);
-                }
-
-                AnimPose trans = AnimPose(glm::vec3(1.0f), glm::quat(), relDefaultPose.trans() + boneLengthScale * (fbxAnimTrans - fbxZeroTrans));
-
-                _anim[frame][skeletonJoint] = trans * preRot * rot * postRot;
-            }
+        MappedJoint mappedJoint;
+        mappedJoint.animJoint = animJoint;
+        mappedJoint.skeletonJoint = skeletonJoint;
+        mappedJoint.preRot = animSkeleton.getPreRotationPose(animJoint);
+        mappedJoint.postRot = animSkeleton.getPostRotationPose(animJoint);
+
+        // cancel out scale
+        mappedJoint.preRot.scale() = glm::vec3(1.0f);
+        mappedJoint.postRot.scale() = glm::vec3(1.0f);
+
+        // adjust translation offsets, so large translation animatons on the reference skeleton
+        // will be adjusted when played on a skeleton with short limbs.
+        mappedJoint.zeroTrans = _compressedAnim->sampleTranslation(animJoint, 0.0f);
+        mappedJoint.defaultTrans = _skeleton->getRelativeDefaultPose(skeletonJoint).trans();
+        mappedJoint.boneLengthScale = 1.0f;
+        const float EPSILON = 0.0001f;
+        if (fabsf(glm::length(mappedJoint.zeroTrans)) > EPSILON) {
+            mappedJoint.boneLengthScale = glm::length(mappedJoint.defaultTrans) / glm::length(mappedJoint.zeroTrans);
         }
-    }
 
-    // mirrorAnim will be re-built on demand, if needed.
-    _mirrorAnim.clear();
+        _mappedJoints.push_back(mappedJoint);
+    }
 
     _poses.resize(skeletonJointCount);
+    _nextPoses.resize(skeletonJointCount);
 }
 
-void AnimClip::buildMirrorAnim() {
-    assert(_skeleton);
+void AnimClip::sampleFrame(float frame, AnimPoseVec& posesOut) const {
+    // init all joints to default pose
+    // this will give us a resonable result for bones in the model skeleton but not in the animation.
+    const AnimPoseVec& defaultPoses = _skeleton->getRelativeDefaultPoses();
+    std::copy(defaultPoses.begin(), defaultPoses.begin() + posesOut.size(), posesOut.begin());
+
+    for (auto& mappedJoint : _mappedJoints) {
+        glm::quat fbxAnimRot = _compressedAnim->sampleRotation(mappedJoint.animJoint, frame);
+        glm::vec3 fbxAnimTrans = _compressedAnim->sampleTranslation(mappedJoint.animJoint, frame);
 
-    _mirrorAnim.clear();
-    _mirrorAnim.reserve(_anim.size());
-    for (auto& relPoses : _anim) {
-        _mirrorAnim.push_back(relPoses);
-        _skeleton->mirrorRelativePoses(_mirrorAnim.back());
+        AnimPose rot(glm::vec3(1.0f), fbxAnimRot, glm::vec3());
+        AnimPose trans(glm::vec3(1.0f), glm::quat(), mappedJoint.defaultTrans + mappedJoint.boneLengthScale * (fbxAnimTrans - mappedJoint.zeroTrans));
+        posesOut[mappedJoint.skeletonJoint] = trans * mappedJoint.preRot * rot * mappedJoint.postRot;
     }
 }
 
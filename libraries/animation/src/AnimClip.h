@@ -57,17 +57,29 @@ protected:
     virtual void setCurrentFrameInternal(float frame) override;
 
     void copyFromNetworkAnim();
-    void buildMirrorAnim();
+    void sampleFrame(float frame, AnimPoseVec& posesOut) const;
 
     // for AnimDebugDraw rendering
     virtual const AnimPoseVec& getPosesInternal() const override;
 
+    // an animation joint that is also in the skeleton, with everything needed to turn its curves into a relative pose.
+    struct MappedJoint {
+        int animJoint;
+        int skeletonJoint;
+        AnimPose preRot;
+        AnimPose postRot;
+        glm::vec3 defaultTrans;
+        glm::vec3 zeroTrans;
+        float boneLengthScale;
+    };
+
     AnimationPointer _networkAnim;
     AnimPoseVec _poses;
+    AnimPoseVec _nextPoses;  // scratch space, used when the two frames being blended are not adjacent
 
-    // _anim[frame][joint]
-    std::vector<AnimPoseVec> _anim;
-    std::vector<AnimPoseVec> _mirrorAnim;
+    // frames are sampled from the compressed curves on demand, instead of being expanded into AnimPoses up front.
+    CompressedAnimation::Pointer _compressedAnim;
+    std::vector<MappedJoint> _mappedJoints;
 
     QString _url;
     float _startFrame;
@@ -77,12 +89,12 @@ protected:
     bool _mirrorFlag;
     float _frame;
 
-    QString _startFrameVar;
-    QString _endFrameVar;
-    QString _timeScaleVar;
-    QString _loopFlagVar;
-    QString _mirrorFlagVar;
-    QString _frameVar;
+    AnimVariantKey _startFrameVar;
+    AnimVariantKey _endFrameVar;
+    AnimVariantKey _timeScaleVar;
+    AnimVariantKey _loopFlagVar;
+    AnimVariantKey _mirrorFlagVar;
+    AnimVariantKey _frameVar;
 
     // no copies
     AnimClip(const AnimClip&) = delete;
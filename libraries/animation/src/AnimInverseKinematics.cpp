@@ -22,6 +22,7 @@
 #include "AnimationLogging.h"
 #include "CubicHermiteSpline.h"
 #include "AnimUtil.h"
+#include "IKSolvers.h"
 
 static const int MAX_TARGET_MARKERS = 30;
 static const float JOINT_CHAIN_INTERP_TIME = 0.25f;
@@ -213,7 +214,8 @@ void AnimInverseKinematics::computeTargets(const AnimVariantMap& animVars, std::
     }
 }
 
-void AnimInverseKinematics::solve(const AnimContext& context, const std::vector<IKTarget>& targets, float dt, JointChainInfoVec& jointChainInfoVec) {
+void AnimInverseKinematics::solve(const AnimContext& context, const std::vector<IKTarget>& targets, float dt, SolverMode solverMode,
+                                  JointChainInfoVec& jointChainInfoVec) {
     // compute absolute poses that correspond to relative target poses
     AnimPoseVec absolutePoses;
     absolutePoses.resize(_relativePoses.size());
@@ -227,13 +229,21 @@ void AnimInverseKinematics::solve(const AnimContext& context, const std::vector<
         accumulator.clearAndClean();
     }
 
+    // the analytic solvers converge in a loop or two for independent chains, the extra loops only
+    // settle joints shared by several chains (e.g. the spine under both hands and the head).
+    const int MAX_IK_LOOPS = 16;
+    const int MAX_ANALYTIC_IK_LOOPS = 4;
+    const float MIN_ANALYTIC_IK_IMPROVEMENT = 0.99f;
+    bool analytic = (solverMode == SolverMode::Analytic);
+    int maxLoops = analytic ? MAX_ANALYTIC_IK_LOOPS : MAX_IK_LOOPS;
+
     float maxError = 0.0f;
+    float prevMaxError = FLT_MAX;
     int numLoops = 0;
-    const int MAX_IK_LOOPS = 16;
-    while (numLoops < MAX_IK_LOOPS) {
+    while (numLoops < maxLoops) {
         ++numLoops;
 
-        bool debug = context.getEnableDebugDrawIKChains() && numLoops == MAX_IK_LOOPS;
+        bool debug = context.getEnableDebugDrawIKChains() && numLoops == maxLoops;
 
         // solve all targets
         for (size_t i = 0; i < targets.size(); i++) {
@@ -244,89 +254,40 @@ void AnimInverseKinematics::solve(const AnimContext& context, const std::vector<
                 solveTargetWithSpline(context, targets[i], absolutePoses, debug, jointChainInfoVec[i]);
                 break;
             default:
-                solveTargetWithCCD(context, targets[i], absolutePoses, debug, jointChainInfoVec[i]);
-                break;
-            }
-        }
-
-        // on last iteration, interpolate jointChains, if necessary
-        if (numLoops == MAX_IK_LOOPS) {
-            for (size_t i = 0; i < _prevJointChainInfoVec.size(); i++) {
-                if (_prevJointChainInfoVec[i].timer > 0.0f) {
-                    float alpha = (JOINT_CHAIN_INTERP_TIME - _prevJointChainInfoVec[i].timer) / JOINT_CHAIN_INTERP_TIME;
-                    size_t chainSize = std::min(_prevJointChainInfoVec[i].jointInfoVec.size(), jointChainInfoVec[i].jointInfoVec.size());
-                    for (size_t j = 0; j < chainSize; j++) {
-                        jointChainInfoVec[i].jointInfoVec[j].rot = safeMix(_prevJointChainInfoVec[i].jointInfoVec[j].rot, jointChainInfoVec[i].jointInfoVec[j].rot, alpha);
-                        jointChainInfoVec[i].jointInfoVec[j].trans = lerp(_prevJointChainInfoVec[i].jointInfoVec[j].trans, jointChainInfoVec[i].jointInfoVec[j].trans, alpha);
-                    }
-
-                    // if joint chain was just disabled, ramp the weight toward zero.
-                    if (_prevJointChainInfoVec[i].target.getType() != IKTarget::Type::Unknown &&
-                        jointChainInfoVec[i].target.getType() == IKTarget::Type::Unknown) {
-                        IKTarget newTarget = _prevJointChainInfoVec[i].target;
-                        newTarget.setWeight((1.0f - alpha) * _prevJointChainInfoVec[i].target.getWeight());
-                        jointChainInfoVec[i].target = newTarget;
-                    }
-                }
-            }
-        }
-
-        // copy jointChainInfoVecs into accumulators
-        for (size_t i = 0; i < targets.size(); i++) {
-            const std::vector<JointInfo>& jointInfoVec = jointChainInfoVec[i].jointInfoVec;
-
-            // don't accumulate disabled or rotation only ik targets.
-            IKTarget::Type type = jointChainInfoVec[i].target.getType();
-            if (type != IKTarget::Type::Unknown && type != IKTarget::Type::RotationOnly) {
-                float weight = jointChainInfoVec[i].target.getWeight();
-                if (weight > 0.0f) {
-                    for (size_t j = 0; j < jointInfoVec.size(); j++) {
-                        const JointInfo& info = jointInfoVec[j];
-                        if (info.jointIndex >= 0) {
-                            _rotationAccumulators[info.jointIndex].add(info.rot, weight);
-                            _translationAccumulators[info.jointIndex].add(info.trans, weight);
-                        }
-                    }
+                if (analytic) {
+                    solveTargetAnalytically(context, targets[i], absolutePoses, debug, jointChainInfoVec[i]);
+                } else {
+                    solveTargetWithCCD(context, targets[i], absolutePoses, debug, jointChainInfoVec[i]);
                 }
+                break;
             }
         }
 
-        // harvest accumulated rotations and apply the average
-        for (int i = 0; i < (int)_relativePoses.size(); ++i) {
-            if (i == _hipsIndex) {
-                continue;  // don't apply accumulators to hips
-            }
-            if (_rotationAccumulators[i].size() > 0) {
-                _relativePoses[i].rot() = _rotationAccumulators[i].getAverage();
-                _rotationAccumulators[i].clear();
-            }
-            if (_translationAccumulators[i].size() > 0) {
-                _relativePoses[i].trans() = _translationAccumulators[i].getAverage();
-                _translationAccumulators[i].clear();
-            }
+        // on last iteration, interpolate jointChains, if necessary.
+        if (numLoops == maxLoops) {
+            interpolateJointChains(jointChainInfoVec);
         }
 
-        // update the absolutePoses
-        for (int i = 0; i < (int)_relativePoses.size(); ++i) {
-            auto parentIndex = _skeleton->getParentIndex((int)i);
-            if (parentIndex != -1) {
-                absolutePoses[i] = absolutePoses[parentIndex] * _relativePoses[i];
-            }
-        }
+        applyJointChains(jointChainInfoVec, absolutePoses);
+        maxError = computeMaxError(targets, absolutePoses);
 
-        // compute maxError
-        maxError = 0.0f;
-        for (size_t i = 0; i < targets.size(); i++) {
-            if (targets[i].getType() == IKTarget::Type::RotationAndPosition || targets[i].getType() == IKTarget::Type::HmdHead ||
-                targets[i].getType() == IKTarget::Type::HipsRelativeRotationAndPosition) {
-                float error = glm::length(absolutePoses[targets[i].getIndex()].trans() - targets[i].getTranslation());
-                if (error > maxError) {
-                    maxError = error;
-                }
+        // the analytic mode can stop early, in which case the interpolation is applied once on top of the converged solve.
+        if (analytic && numLoops < maxLoops) {
+            if (maxError < EPSILON || maxError > MIN_ANALYTIC_IK_IMPROVEMENT * prevMaxError) {
+                interpolateJointChains(jointChainInfoVec);
+                applyJointChains(jointChainInfoVec, absolutePoses);
+                maxError = computeMaxError(targets, absolutePoses);
+                break;
             }
+            prevMaxError = maxError;
         }
     }
     _maxErrorOnLastSolve = maxError;
+    _numIterationsOnLastSolve = numLoops;
+    PROFILE_COUNTER(simulation_animation, "ikSolve", {
+        { "iterations", numLoops },
+        { "maxError", maxError }
+    });
 
     // finally set the relative rotation of each tip to agree with absolute target rotation
     for (auto& target: targets) {
@@ -376,6 +337,87 @@ void AnimInverseKinematics::solve(const AnimContext& context, const std::vector<
     }
 }
 
+void AnimInverseKinematics::interpolateJointChains(JointChainInfoVec& jointChainInfoVec) const {
+    // blend from the chains of the previous solve while a chain is transitioning.
+    for (size_t i = 0; i < _prevJointChainInfoVec.size(); i++) {
+        if (_prevJointChainInfoVec[i].timer > 0.0f) {
+            float alpha = (JOINT_CHAIN_INTERP_TIME - _prevJointChainInfoVec[i].timer) / JOINT_CHAIN_INTERP_TIME;
+            size_t chainSize = std::min(_prevJointChainInfoVec[i].jointInfoVec.size(), jointChainInfoVec[i].jointInfoVec.size());
+            for (size_t j = 0; j < chainSize; j++) {
+                jointChainInfoVec[i].jointInfoVec[j].rot = safeMix(_prevJointChainInfoVec[i].jointInfoVec[j].rot, jointChainInfoVec[i].jointInfoVec[j].rot, alpha);
+                jointChainInfoVec[i].jointInfoVec[j].trans = lerp(_prevJointChainInfoVec[i].jointInfoVec[j].trans, jointChainInfoVec[i].jointInfoVec[j].trans, alpha);
+            }
+
+            // if joint chain was just disabled, ramp the weight toward zero.
+            if (_prevJointChainInfoVec[i].target.getType() != IKTarget::Type::Unknown &&
+                jointChainInfoVec[i].target.getType() == IKTarget::Type::Unknown) {
+                IKTarget newTarget = _prevJointChainInfoVec[i].target;
+                newTarget.setWeight((1.0f - alpha) * _prevJointChainInfoVec[i].target.getWeight());
+                jointChainInfoVec[i].target = newTarget;
+            }
+        }
+    }
+}
+
+void AnimInverseKinematics::applyJointChains(const JointChainInfoVec& jointChainInfoVec, AnimPoseVec& absolutePoses) {
+    // copy jointChainInfoVecs into accumulators
+    for (size_t i = 0; i < jointChainInfoVec.size(); i++) {
+        const std::vector<JointInfo>& jointInfoVec = jointChainInfoVec[i].jointInfoVec;
+
+        // don't accumulate disabled or rotation only ik targets.
+        IKTarget::Type type = jointChainInfoVec[i].target.getType();
+        if (type != IKTarget::Type::Unknown && type != IKTarget::Type::RotationOnly) {
+            float weight = jointChainInfoVec[i].target.getWeight();
+            if (weight > 0.0f) {
+                for (size_t j = 0; j < jointInfoVec.size(); j++) {
+                    const JointInfo& info = jointInfoVec[j];
+                    if (info.jointIndex >= 0) {
+                        _rotationAccumulators[info.jointIndex].add(info.rot, weight);
+                        _translationAccumulators[info.jointIndex].add(info.trans, weight);
+                    }
+                }
+            }
+        }
+    }
+
+    // harvest accumulated rotations and apply the average
+    for (int i = 0; i < (int)_relativePoses.size(); ++i) {
+        if (i == _hipsIndex) {
+            continue;  // don't apply accumulators to hips
+        }
+        if (_rotationAccumulators[i].size() > 0) {
+            _relativePoses[i].rot() = _rotationAccumulators[i].getAverage();
+            _rotationAccumulators[i].clear();
+        }
+        if (_translationAccumulators[i].size() > 0) {
+            _relativePoses[i].trans() = _translationAccumulators[i].getAverage();
+            _translationAccumulators[i].clear();
+        }
+    }
+
+    // update the absolutePoses
+    for (int i = 0; i < (int)_relativePoses.size(); ++i) {
+        auto parentIndex = _skeleton->getParentIndex((int)i);
+        if (parentIndex != -1) {
+            absolutePoses[i] = absolutePoses[parentIndex] * _relativePoses[i];
+        }
+    }
+}
+
+float AnimInverseKinematics::computeMaxError(const std::vector<IKTarget>& targets, const AnimPoseVec& absolutePoses) const {
+    float maxError = 0.0f;
+    for (size_t i = 0; i < targets.size(); i++) {
+        if (targets[i].getType() == IKTarget::Type::RotationAndPosition || targets[i].getType() == IKTarget::Type::HmdHead ||
+            targets[i].getType() == IKTarget::Type::HipsRelativeRotationAndPosition) {
+            float error = glm::length(absolutePoses[targets[i].getIndex()].trans() - targets[i].getTranslation());
+            if (error > maxError) {
+                maxError = error;
+            }
+        }
+    }
+    return maxError;
+}
+
 void AnimInverseKinematics::solveTargetWithCCD(const AnimContext& context, const IKTarget& target, const AnimPoseVec& absolutePoses,
                                                bool debug, JointChainInfo& jointChainInfoOut) const {
     size_t chainDepth = 0;
@@ -698,6 +740,121 @@ void AnimInverseKinematics::solveTargetWithCCD(const AnimContext& context, const
     }
 }
 
+void AnimInverseKinematics::solveTargetAnalytically(const AnimContext& context, const IKTarget& target, const AnimPoseVec& absolutePoses,
+                                                    bool debug, JointChainInfo& jointChainInfoOut) const {
+    IKTarget::Type targetType = target.getType();
+    if (targetType != IKTarget::Type::RotationAndPosition && targetType != IKTarget::Type::HipsRelativeRotationAndPosition) {
+        // HmdHead targets are met by shifting the hips and spreading rotation up the spine, which CCD does in a single pass.
+        // RotationOnly targets are enforced after the iterations in both modes.
+        solveTargetWithCCD(context, target, absolutePoses, debug, jointChainInfoOut);
+        return;
+    }
+
+    // collect the joints CCD would pivot: chain[0] is the tip followed by its ancestors up to, but not including, the hips.
+    const size_t MAX_CHAIN_DEPTH = 30;
+    int chain[MAX_CHAIN_DEPTH];
+    glm::vec3 positions[MAX_CHAIN_DEPTH];
+    size_t chainLength = 0;
+    size_t fabrikLength = 0;
+
+    int tipIndex = target.getIndex();
+    chain[chainLength] = tipIndex;
+    positions[chainLength] = absolutePoses[tipIndex].trans();
+    chainLength++;
+
+    int pivotIndex = _skeleton->getParentIndex(tipIndex);
+    while (pivotIndex != -1 && pivotIndex != _hipsIndex && _skeleton->getParentIndex(pivotIndex) != -1 &&
+           chainLength < MAX_CHAIN_DEPTH && chainLength < jointChainInfoOut.jointInfoVec.size()) {
+        if (fabrikLength == 0 && _hipsTargetIndex < 0 && tipIndex != _headIndex) {
+            RotationConstraint* constraint = getConstraint(pivotIndex);
+            if (constraint && constraint->isLowerSpine()) {
+                // without a hips target the lower-spine must not swing toward hand targets,
+                // so FABRIK treats the joint above it as the fixed root of the chain.
+                fabrikLength = chainLength;
+            }
+        }
+        chain[chainLength] = pivotIndex;
+        positions[chainLength] = absolutePoses[pivotIndex].trans();
+        chainLength++;
+        pivotIndex = _skeleton->getParentIndex(pivotIndex);
+    }
+    if (chainLength < 2) {
+        return;
+    }
+    if (fabrikLength == 0) {
+        fabrikLength = chainLength;
+    }
+
+    const float FABRIK_RELATIVE_TOLERANCE = 1.0e-3f;
+    const int MAX_FABRIK_ITERATIONS = 10;
+    float reach = 0.0f;
+    for (size_t i = 1; i < fabrikLength; i++) {
+        reach += glm::length(positions[i] - positions[i - 1]);
+    }
+    float tolerance = FABRIK_RELATIVE_TOLERANCE * reach;
+
+    // limbs are recognized by the hinge constraint on their mid joint (elbows and knees)
+    glm::vec3 targetPosition = target.getTranslation();
+    bool limb = chainLength >= 3 && dynamic_cast<ElbowConstraint*>(getConstraint(chain[1])) != nullptr;
+    float residual = glm::length(targetPosition - positions[0]);
+    if (limb) {
+        glm::vec3 bendHint = target.getPoleVectorEnabled() ? target.getPoleVector() : Vectors::ZERO;
+        residual = solveTwoBoneIK(positions[2], positions[1], positions[0], targetPosition, bendHint);
+    }
+    if (!limb || (residual > tolerance && fabrikLength > 3)) {
+        // the rest of the chain only has to help when the limb alone can't reach
+        solveFABRIK(positions, fabrikLength, targetPosition, tolerance, MAX_FABRIK_ITERATIONS, residual);
+    }
+
+    // convert the new positions back into parent-relative rotations, from the root of the chain toward the tip
+    const float MIN_LINE_LENGTH = 1.0e-4f;
+    int rootParentIndex = _skeleton->getParentIndex(chain[chainLength - 1]);
+    glm::quat parentRotation = absolutePoses[rootParentIndex].rot();
+    glm::vec3 jointPosition = positions[chainLength - 1];
+    for (size_t i = chainLength - 1; i > 0; i--) {
+        int jointIndex = chain[i];
+        int childIndex = chain[i - 1];
+        glm::quat relativeRotation = _relativePoses[jointIndex].rot();
+        glm::quat absoluteRotation = parentRotation * relativeRotation;
+        glm::vec3 childOffset = absolutePoses[jointIndex].scale() * _relativePoses[childIndex].trans();
+
+        glm::vec3 currentLine = absoluteRotation * childOffset;
+        glm::vec3 desiredLine = positions[i - 1] - jointPosition;
+        if (glm::length(currentLine) > MIN_LINE_LENGTH && glm::length(desiredLine) > MIN_LINE_LENGTH) {
+            glm::quat newRelativeRotation = glm::normalize(glm::inverse(parentRotation) *
+                                                           rotationBetween(currentLine, desiredLine) * absoluteRotation);
+            // joints placed by the two-bone solve are exact, the others are damped like the CCD swing
+            float flex = (limb && i <= 2) ? 1.0f : target.getFlexCoefficient(i);
+            relativeRotation = safeLerp(relativeRotation, newRelativeRotation, flex);
+        }
+
+        bool constrained = false;
+        RotationConstraint* constraint = getConstraint(jointIndex);
+        if (constraint) {
+            constrained = constraint->apply(relativeRotation);
+        }
+        absoluteRotation = parentRotation * relativeRotation;
+        jointChainInfoOut.jointInfoVec[i] = { relativeRotation, _relativePoses[jointIndex].trans(), jointIndex, constrained };
+
+        // aim the next joint from where this one actually put it, which differs from the plan when damped or constrained
+        jointPosition += absoluteRotation * childOffset;
+        parentRotation = absoluteRotation;
+    }
+
+    // finally match the tip to the target rotation
+    glm::quat tipRelativeRotation = glm::normalize(glm::inverse(parentRotation) * target.getRotation());
+    bool constrained = false;
+    RotationConstraint* constraint = getConstraint(tipIndex);
+    if (constraint) {
+        constrained = constraint->apply(tipRelativeRotation);
+    }
+    jointChainInfoOut.jointInfoVec[0] = { tipRelativeRotation, _relativePoses[tipIndex].trans(), tipIndex, constrained };
+
+    if (debug) {
+        debugDrawIKChain(jointChainInfoOut, context);
+    }
+}
+
 static CubicHermiteSplineFunctorWithArcLength computeSplineFromTipAndBase(const AnimPose& tipPose, const AnimPose& basePose, float baseGain = 1.0f, float tipGain = 1.0f) {
     float linearDistance = glm::length(basePose.trans() - tipPose.trans());
     glm::vec3 p0 = basePose.trans();
@@ -887,8 +1044,9 @@ const AnimPoseVec& AnimInverseKinematics::overlay(const AnimVariantMap& animVars
     return underPoses;
 #endif
 
-    // allows solutionSource to be overridden by an animVar
+    // allows solutionSource and solverMode to be overridden by an animVar
     auto solutionSource = animVars.lookup(_solutionSourceVar, (int)_solutionSource);
+    auto solverMode = animVars.lookup(_solverModeVar, (int)_solverMode);
 
     const float MAX_OVERLAY_DT = 1.0f / 30.0f; // what to clamp delta-time to in AnimInverseKinematics::overlay
     if (dt > MAX_OVERLAY_DT) {
@@ -1047,7 +1205,7 @@ const AnimPoseVec& AnimInverseKinematics::overlay(const AnimVariantMap& animVars
                 setSecondaryTargets(context);
                 preconditionRelativePosesToAvoidLimbLock(context, targets);
 
-                solve(context, targets, dt, jointChainInfoVec);
+                solve(context, targets, dt, (SolverMode)solverMode, jointChainInfoVec);
             }
         }
 
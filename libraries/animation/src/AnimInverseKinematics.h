@@ -58,6 +58,7 @@ public:
     void clearIKJointLimitHistory();
 
     float getMaxErrorOnLastSolve() { return _maxErrorOnLastSolve; }
+    int getNumIterationsOnLastSolve() { return _numIterationsOnLastSolve; }
 
     enum class SolutionSource {
         RelaxToUnderPoses = 0,
@@ -68,19 +69,36 @@ public:
         NumSolutionSources,
     };
 
+    // CCD iterates a fixed number of loops over every chain.  Analytic solves limbs (chains whose mid joint is a hinge)
+    // with two-bone IK and everything else with FABRIK, then stops as soon as the error stops improving.
+    enum class SolverMode {
+        CCD = 0,
+        Analytic,
+        NumSolverModes,
+    };
+
     void setSecondaryTargetInRigFrame(int jointIndex, const AnimPose& pose);
     void clearSecondaryTarget(int jointIndex);
 
     void setSolutionSource(SolutionSource solutionSource) { _solutionSource = solutionSource; }
     void setSolutionSourceVar(const QString& solutionSourceVar) { _solutionSourceVar = solutionSourceVar; }
 
+    void setSolverMode(SolverMode solverMode) { _solverMode = solverMode; }
+    void setSolverModeVar(const QString& solverModeVar) { _solverModeVar = solverModeVar; }
+
 protected:
     void computeTargets(const AnimVariantMap& animVars, std::vector<IKTarget>& targets, const AnimPoseVec& underPoses);
-    void solve(const AnimContext& context, const std::vector<IKTarget>& targets, float dt, JointChainInfoVec& jointChainInfoVec);
+    void solve(const AnimContext& context, const std::vector<IKTarget>& targets, float dt, SolverMode solverMode,
+               JointChainInfoVec& jointChainInfoVec);
     void solveTargetWithCCD(const AnimContext& context, const IKTarget& target, const AnimPoseVec& absolutePoses,
                             bool debug, JointChainInfo& jointChainInfoOut) const;
     void solveTargetWithSpline(const AnimContext& context, const IKTarget& target, const AnimPoseVec& absolutePoses,
                                bool debug, JointChainInfo& jointChainInfoOut) const;
+    void solveTargetAnalytically(const AnimContext& context, const IKTarget& target, const AnimPoseVec& absolutePoses,
+                                 bool debug, JointChainInfo& jointChainInfoOut) const;
+    void interpolateJointChains(JointChainInfoVec& jointChainInfoVec) const;
+    void applyJointChains(const JointChainInfoVec& jointChainInfoVec, AnimPoseVec& absolutePoses);
+    float computeMaxError(const std::vector<IKTarget>& targets, const AnimPoseVec& absolutePoses) const;
     virtual void setSkeletonInternal(AnimSkeleton::ConstPointer skeleton) override;
     void debugDrawIKChain(const JointChainInfo& jointChainInfo, const AnimContext& context) const;
     void debugDrawRelativePoses(const AnimContext& context) const;
@@ -121,13 +139,13 @@ protected:
         IKTargetVar(const IKTargetVar& orig);
 
         QString jointName;
-        QString positionVar;
-        QString rotationVar;
-        QString typeVar;
-        QString weightVar;
-        QString poleVectorEnabledVar;
-        QString poleReferenceVectorVar;
-        QString poleVectorVar;
+        AnimVariantKey positionVar;
+        AnimVariantKey rotationVar;
+        AnimVariantKey typeVar;
+        AnimVariantKey weightVar;
+        AnimVariantKey poleVectorEnabledVar;
+        AnimVariantKey poleReferenceVectorVar;
+        AnimVariantKey poleVectorVar;
         float weight;
         float flexCoefficients[MAX_FLEX_COEFFICIENTS];
         size_t numFlexCoefficients;
@@ -154,9 +172,12 @@ protected:
     int _rightHandIndex { -1 };
 
     float _maxErrorOnLastSolve { FLT_MAX };
+    int _numIterationsOnLastSolve { 0 };
     bool _previousEnableDebugIKTargets { false };
     SolutionSource _solutionSource { SolutionSource::RelaxToUnderPoses };
-    QString _solutionSourceVar;
+    AnimVariantKey _solutionSourceVar;
+    SolverMode _solverMode { SolverMode::CCD };
+    AnimVariantKey _solverModeVar;
 
     JointChainInfoVec _prevJointChainInfoVec;
 };
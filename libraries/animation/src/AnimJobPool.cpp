@@ -0,0 +1,73 @@
+//
+//  AnimJobPool.cpp
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AnimJobPool.h"
+
+#include <algorithm>
+
+#include <QThread>
+
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+
+#include <glm/glm.hpp>
+
+AnimJobPool::AnimJobPool(int numThreads) {
+    setNumThreads(numThreads);
+}
+
+AnimJobPool::~AnimJobPool() {
+}
+
+void AnimJobPool::setNumThreads(int numThreads) {
+    if (numThreads <= 0) {
+        numThreads = QThread::idealThreadCount();
+    }
+    numThreads = std::max(1, numThreads);
+    if (numThreads != _numThreads || (numThreads > 1 && !_arena)) {
+        _numThreads = numThreads;
+        if (_numThreads > 1) {
+            _arena.reset(new tbb::task_arena(_numThreads));
+        } else {
+            _arena.reset();
+        }
+    }
+}
+
+void AnimJobPool::run(size_t numJobs, const std::function<void(size_t)>& job) {
+    if (!_arena || numJobs < 2) {
+        for (size_t i = 0; i < numJobs; ++i) {
+            job(i);
+        }
+        return;
+    }
+
+    // one job per task: a single avatar is already a few thousand joint transforms
+    _arena->execute([&] {
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, numJobs, 1), [&](const tbb::blocked_range<size_t>& range) {
+            for (size_t i = range.begin(); i != range.end(); ++i) {
+                job(i);
+            }
+        });
+    });
+}
+
+int AnimJobPool::computeUpdateInterval(float radius, float distance) {
+    // full rate while the radius subtends more than about three degrees, e.g. a one meter avatar within twenty meters
+    const float FULL_RATE_APPARENT_SIZE = 0.05f;
+    const float MIN_DISTANCE = 0.001f;
+    float apparentSize = radius / glm::max(distance, MIN_DISTANCE);
+
+    int interval = 1;
+    while (interval < MAX_UPDATE_INTERVAL && apparentSize < FULL_RATE_APPARENT_SIZE) {
+        interval *= 2;
+        apparentSize *= 2.0f;
+    }
+    return interval;
+}
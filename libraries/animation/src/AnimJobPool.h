@@ -0,0 +1,52 @@
+//
+//  AnimJobPool.h
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AnimJobPool
+#define hifi_AnimJobPool
+
+#include <functional>
+#include <memory>
+#include <stdint.h>
+
+namespace tbb {
+    class task_arena;
+}
+
+// AnimJobPool runs independent per-avatar animation jobs, such as copying joints into a rig or building cluster
+// matrices, on worker threads.  A job may only touch the state of its own avatar.  run() returns once every job
+// has finished, which is the point where the caller hands the results on to the render thread.
+class AnimJobPool {
+public:
+    static const int MAX_UPDATE_INTERVAL = 8;
+
+    // numThreads <= 0 uses one thread per core
+    explicit AnimJobPool(int numThreads = 0);
+    ~AnimJobPool();
+
+    void setNumThreads(int numThreads);
+    int getNumThreads() const { return _numThreads; }
+
+    void run(size_t numJobs, const std::function<void(size_t)>& job);
+
+    // Animation level of detail: returns the number of frames between updates for something of the given radius
+    // at the given distance from the nearest view.  1 while it is large on screen, doubling each time its apparent
+    // size halves, up to MAX_UPDATE_INTERVAL.
+    static int computeUpdateInterval(float radius, float distance);
+
+    // true on one frame out of every interval.  seed spreads things with the same interval over different frames.
+    static bool isUpdateDue(uint32_t frameCount, int interval, uint32_t seed) {
+        return interval <= 1 || (frameCount + seed) % (uint32_t)interval == 0;
+    }
+
+private:
+    std::unique_ptr<tbb::task_arena> _arena;
+    int _numThreads { 1 };
+};
+
+#endif
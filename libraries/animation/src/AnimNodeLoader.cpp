@@ -385,6 +385,20 @@ static AnimInverseKinematics::SolutionSource stringToSolutionSourceEnum(const QS
     return AnimInverseKinematics::SolutionSource::NumSolutionSources;
 }
 
+static const char* solverModeStrings[(int)AnimInverseKinematics::SolverMode::NumSolverModes] = {
+    "ccd",
+    "analytic"
+};
+
+static AnimInverseKinematics::SolverMode stringToSolverModeEnum(const QString& str) {
+    for (int i = 0; i < (int)AnimInverseKinematics::SolverMode::NumSolverModes; i++) {
+        if (str == solverModeStrings[i]) {
+            return (AnimInverseKinematics::SolverMode)i;
+        }
+    }
+    return AnimInverseKinematics::SolverMode::NumSolverModes;
+}
+
 static AnimNode::Pointer loadOverlayNode(const QJsonObject& jsonObj, const QString& id, const QUrl& jsonUrl) {
 
     READ_STRING(boneSet, jsonObj, id, jsonUrl, nullptr);
@@ -523,6 +537,23 @@ AnimNode::Pointer loadInverseKinematicsNode(const QJsonObject& jsonObj, const QS
         node->setSolutionSourceVar(solutionSourceVar);
     }
 
+    READ_OPTIONAL_STRING(solverMode, jsonObj);
+
+    if (!solverMode.isEmpty()) {
+        AnimInverseKinematics::SolverMode solverModeType = stringToSolverModeEnum(solverMode);
+        if (solverModeType != AnimInverseKinematics::SolverMode::NumSolverModes) {
+            node->setSolverMode(solverModeType);
+        } else {
+            qCWarning(animation) << "AnimNodeLoader, bad solverModeType in \"solverMode\", id = " << id << ", url = " << jsonUrl.toDisplayString();
+        }
+    }
+
+    READ_OPTIONAL_STRING(solverModeVar, jsonObj);
+
+    if (!solverModeVar.isEmpty()) {
+        node->setSolverModeVar(solverModeVar);
+    }
+
     return node;
 }
 
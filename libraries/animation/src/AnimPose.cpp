@@ -55,6 +55,12 @@ glm::vec3 AnimPose::xformVectorFast(const glm::vec3& rhs) const {
 }
 
 AnimPose AnimPose::operator*(const AnimPose& rhs) const {
+    // a uniform positive scale commutes with rhs._rot, so the parts can be composed directly,
+    // which is much cheaper than building and decomposing a matrix.
+    const float EPSILON = 0.0001f;
+    if (_scale.x > 0.0f && fabsf(_scale.x - _scale.y) <= EPSILON * _scale.x && fabsf(_scale.x - _scale.z) <= EPSILON * _scale.x) {
+        return AnimPose(_scale.x * rhs._scale, _rot * rhs._rot, _trans + _rot * (_scale.x * rhs._trans));
+    }
     glm::mat4 result;
     glm_mat4u_mul(*this, rhs, result);
     return AnimPose(result);
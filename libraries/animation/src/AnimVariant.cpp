@@ -11,13 +11,105 @@
 
 #include "AnimVariant.h" // which has AnimVariant/AnimVariantMap
 
+#include <QHash>
+#include <QReadWriteLock>
 #include <QScriptEngine>
 #include <QScriptValueIterator>
 #include <QThread>
+#include <QVector>
 #include <RegisteredMetaTypes.h>
 
 const AnimVariant AnimVariant::False = AnimVariant();
 
+// names are only ever added, so a slot number stays valid for the life of the process.
+struct AnimVariantKeyRegistry {
+    QReadWriteLock lock;
+    QHash<QString, int> slots;
+    QVector<QString> names;
+};
+
+static AnimVariantKeyRegistry& getKeyRegistry() {
+    static AnimVariantKeyRegistry registry;
+    return registry;
+}
+
+AnimVariantKey AnimVariantKey::find(const QString& name) {
+    if (name.isEmpty()) {
+        return AnimVariantKey();
+    }
+    auto& registry = getKeyRegistry();
+    QReadLocker locker(&registry.lock);
+    return AnimVariantKey(registry.slots.value(name, -1));
+}
+
+int AnimVariantKey::intern(const QString& name) {
+    if (name.isEmpty()) {
+        return -1;
+    }
+    auto& registry = getKeyRegistry();
+    {
+        QReadLocker locker(&registry.lock);
+        auto iter = registry.slots.constFind(name);
+        if (iter != registry.slots.constEnd()) {
+            return iter.value();
+        }
+    }
+    QWriteLocker locker(&registry.lock);
+    auto iter = registry.slots.constFind(name);
+    if (iter != registry.slots.constEnd()) {
+        return iter.value();
+    }
+    int slot = registry.names.size();
+    registry.names.push_back(name);
+    registry.slots.insert(name, slot);
+    return slot;
+}
+
+QString AnimVariantKey::nameOf(int slot) {
+    auto& registry = getKeyRegistry();
+    QReadLocker locker(&registry.lock);
+    return (slot >= 0 && slot < registry.names.size()) ? registry.names[slot] : QString();
+}
+
+int AnimVariantKey::getNumSlots() {
+    auto& registry = getKeyRegistry();
+    QReadLocker locker(&registry.lock);
+    return registry.names.size();
+}
+
+void AnimVariantMap::unset(const QString& key) {
+    int slot = AnimVariantKey::find(key).getSlot();
+    if (find(slot)) {
+        _values[slot] = AnimVariant();
+        _flags[slot] &= ~HAS_VALUE;
+    }
+}
+
+void AnimVariantMap::setTrigger(const QString& key) {
+    int slot = AnimVariantKey::intern(key);
+    if (slot >= 0 && !isTriggered(slot)) {
+        reserveSlot(slot);
+        _flags[slot] |= IS_TRIGGER;
+        _triggerSlots.push_back(slot);
+    }
+}
+
+void AnimVariantMap::clearTriggers() {
+    for (int slot : _triggerSlots) {
+        _flags[slot] &= ~IS_TRIGGER;
+    }
+    _triggerSlots.clear();
+}
+
+void AnimVariantMap::clearMap() {
+    for (size_t slot = 0; slot < _flags.size(); slot++) {
+        if (_flags[slot] & HAS_VALUE) {
+            _values[slot] = AnimVariant();
+            _flags[slot] &= ~HAS_VALUE;
+        }
+    }
+}
+
 QScriptValue AnimVariantMap::animVariantMapToScriptValue(QScriptEngine* engine, const QStringList& names, bool useNames) const {
     if (QThread::currentThread() != engine->thread()) {
         qCWarning(animation) << "Cannot create Javacript object from non-script thread" << QThread::currentThread();
@@ -52,24 +144,31 @@ QScriptValue AnimVariantMap::animVariantMapToScriptValue(QScriptEngine* engine,
     };
     if (useNames) { // copy only the requested names
         for (const QString& name : names) {
-            auto search = _map.find(name);
-            if (search != _map.end()) {
-                setOne(name, search->second);
-            } else if (_triggers.count(name) == 1) {
+            int slot = AnimVariantKey::find(name).getSlot();
+            const AnimVariant* value = find(slot);
+            if (value) {
+                setOne(name, *value);
+            } else if (isTriggered(slot)) {
                 target.setProperty(name, true);
             } // scripts are allowed to request names that do not exist
         }
 
     } else {  // copy all of them
-        for (auto& pair : _map) {
-            setOne(pair.first, pair.second);
+        for (int slot = 0; slot < (int)_values.size(); slot++) {
+            const AnimVariant* value = find(slot);
+            if (value) {
+                setOne(AnimVariantKey::nameOf(slot), *value);
+            }
         }
     }
     return target;
 }
 void AnimVariantMap::copyVariantsFrom(const AnimVariantMap& other) {
-    for (auto& pair : other._map) {
-        _map[pair.first] = pair.second;
+    for (int slot = 0; slot < (int)other._values.size(); slot++) {
+        const AnimVariant* value = other.find(slot);
+        if (value) {
+            setValue(slot, *value);
+        }
     }
 }
 
@@ -17,6 +17,7 @@
 #include <glm/gtx/quaternion.hpp>
 #include <map>
 #include <set>
+#include <vector>
 #include <QScriptValue>
 #include <StreamUtils.h>
 #include <GLMHelpers.h>
@@ -114,119 +115,137 @@ protected:
     } _val;
 };
 
+// AnimVariantKey is an anim variable name interned into a process-wide slot number.  Nodes convert their
+// variable names to keys once, when the graph is loaded, so per-frame lookups index straight into the
+// dense array of an AnimVariantMap instead of comparing strings.  An empty name is an invalid key.
+class AnimVariantKey {
+public:
+    AnimVariantKey() {}
+    AnimVariantKey(const QString& name) : _slot(intern(name)) {}
+
+    int getSlot() const { return _slot; }
+    bool isValid() const { return _slot >= 0; }
+    QString getName() const { return nameOf(_slot); }
+
+    // returns the key for name without interning it, invalid if name has never been interned.
+    static AnimVariantKey find(const QString& name);
+    static int intern(const QString& name);
+    static QString nameOf(int slot);
+    static int getNumSlots();
+
+    bool operator==(const AnimVariantKey& other) const { return _slot == other._slot; }
+    bool operator!=(const AnimVariantKey& other) const { return _slot != other._slot; }
+
+private:
+    explicit AnimVariantKey(int slot) : _slot(slot) {}
+    int _slot { -1 };
+};
+
 class AnimVariantMap {
 public:
 
-    bool lookup(const QString& key, bool defaultValue) const {
+    bool lookup(const AnimVariantKey& key, bool defaultValue) const {
         // check triggers first, then map
-        if (key.isEmpty()) {
-            return defaultValue;
-        } else if (_triggers.find(key) != _triggers.end()) {
+        if (isTriggered(key.getSlot())) {
             return true;
         } else {
-            auto iter = _map.find(key);
-            return iter != _map.end() ? iter->second.getBool() : defaultValue;
+            const AnimVariant* value = find(key.getSlot());
+            return value ? value->getBool() : defaultValue;
         }
     }
 
-    int lookup(const QString& key, int defaultValue) const {
-        if (key.isEmpty()) {
-            return defaultValue;
-        } else {
-            auto iter = _map.find(key);
-            return iter != _map.end() ? iter->second.getInt() : defaultValue;
-        }
+    int lookup(const AnimVariantKey& key, int defaultValue) const {
+        const AnimVariant* value = find(key.getSlot());
+        return value ? value->getInt() : defaultValue;
     }
 
-    float lookup(const QString& key, float defaultValue) const {
-        if (key.isEmpty()) {
-            return defaultValue;
-        } else {
-            auto iter = _map.find(key);
-            return iter != _map.end() ? iter->second.getFloat() : defaultValue;
-        }
+    float lookup(const AnimVariantKey& key, float defaultValue) const {
+        const AnimVariant* value = find(key.getSlot());
+        return value ? value->getFloat() : defaultValue;
     }
 
-    const glm::vec3& lookupRaw(const QString& key, const glm::vec3& defaultValue) const {
-        if (key.isEmpty()) {
-            return defaultValue;
-        } else {
-            auto iter = _map.find(key);
-            return iter != _map.end() ? iter->second.getVec3() : defaultValue;
-        }
+    const glm::vec3& lookupRaw(const AnimVariantKey& key, const glm::vec3& defaultValue) const {
+        const AnimVariant* value = find(key.getSlot());
+        return value ? value->getVec3() : defaultValue;
     }
 
-    glm::vec3 lookupRigToGeometry(const QString& key, const glm::vec3& defaultValue) const {
-        if (key.isEmpty()) {
-            return defaultValue;
-        } else {
-            auto iter = _map.find(key);
-            return iter != _map.end() ? transformPoint(_rigToGeometryMat, iter->second.getVec3()) : defaultValue;
-        }
+    glm::vec3 lookupRigToGeometry(const AnimVariantKey& key, const glm::vec3& defaultValue) const {
+        const AnimVariant* value = find(key.getSlot());
+        return value ? transformPoint(_rigToGeometryMat, value->getVec3()) : defaultValue;
     }
 
-    glm::vec3 lookupRigToGeometryVector(const QString& key, const glm::vec3& defaultValue) const {
-        if (key.isEmpty()) {
-            return defaultValue;
-        } else {
-            auto iter = _map.find(key);
-            return iter != _map.end() ? transformVectorFast(_rigToGeometryMat, iter->second.getVec3()) : defaultValue;
-        }
+    glm::vec3 lookupRigToGeometryVector(const AnimVariantKey& key, const glm::vec3& defaultValue) const {
+        const AnimVariant* value = find(key.getSlot());
+        return value ? transformVectorFast(_rigToGeometryMat, value->getVec3()) : defaultValue;
     }
 
-    const glm::quat& lookupRaw(const QString& key, const glm::quat& defaultValue) const {
-        if (key.isEmpty()) {
-            return defaultValue;
-        } else {
-            auto iter = _map.find(key);
-            return iter != _map.end() ? iter->second.getQuat() : defaultValue;
-        }
+    const glm::quat& lookupRaw(const AnimVariantKey& key, const glm::quat& defaultValue) const {
+        const AnimVariant* value = find(key.getSlot());
+        return value ? value->getQuat() : defaultValue;
     }
 
-    glm::quat lookupRigToGeometry(const QString& key, const glm::quat& defaultValue) const {
-        if (key.isEmpty()) {
-            return defaultValue;
-        } else {
-            auto iter = _map.find(key);
-            return iter != _map.end() ? _rigToGeometryRot * iter->second.getQuat() : defaultValue;
-        }
+    glm::quat lookupRigToGeometry(const AnimVariantKey& key, const glm::quat& defaultValue) const {
+        const AnimVariant* value = find(key.getSlot());
+        return value ? _rigToGeometryRot * value->getQuat() : defaultValue;
     }
 
+    const QString& lookup(const AnimVariantKey& key, const QString& defaultValue) const {
+        const AnimVariant* value = find(key.getSlot());
+        return value ? value->getString() : defaultValue;
+    }
+
+    // string versions, for scripts and other callers that have not interned their names.
+    // These never intern, so looking up a name nobody has set does not grow the slot table.
+    bool lookup(const QString& key, bool defaultValue) const { return lookup(AnimVariantKey::find(key), defaultValue); }
+    int lookup(const QString& key, int defaultValue) const { return lookup(AnimVariantKey::find(key), defaultValue); }
+    float lookup(const QString& key, float defaultValue) const { return lookup(AnimVariantKey::find(key), defaultValue); }
+    const glm::vec3& lookupRaw(const QString& key, const glm::vec3& defaultValue) const {
+        return lookupRaw(AnimVariantKey::find(key), defaultValue);
+    }
+    glm::vec3 lookupRigToGeometry(const QString& key, const glm::vec3& defaultValue) const {
+        return lookupRigToGeometry(AnimVariantKey::find(key), defaultValue);
+    }
+    glm::vec3 lookupRigToGeometryVector(const QString& key, const glm::vec3& defaultValue) const {
+        return lookupRigToGeometryVector(AnimVariantKey::find(key), defaultValue);
+    }
+    const glm::quat& lookupRaw(const QString& key, const glm::quat& defaultValue) const {
+        return lookupRaw(AnimVariantKey::find(key), defaultValue);
+    }
+    glm::quat lookupRigToGeometry(const QString& key, const glm::quat& defaultValue) const {
+        return lookupRigToGeometry(AnimVariantKey::find(key), defaultValue);
+    }
     const QString& lookup(const QString& key, const QString& defaultValue) const {
-        if (key.isEmpty()) {
-            return defaultValue;
-        } else {
-            auto iter = _map.find(key);
-            return iter != _map.end() ? iter->second.getString() : defaultValue;
-        }
+        return lookup(AnimVariantKey::find(key), defaultValue);
     }
 
-    void set(const QString& key, bool value) { _map[key] = AnimVariant(value); }
-    void set(const QString& key, int value) { _map[key] = AnimVariant(value); }
-    void set(const QString& key, float value) { _map[key] = AnimVariant(value); }
-    void set(const QString& key, const glm::vec3& value) { _map[key] = AnimVariant(value); }
-    void set(const QString& key, const glm::quat& value) { _map[key] = AnimVariant(value); }
-    void set(const QString& key, const QString& value) { _map[key] = AnimVariant(value); }
-    void unset(const QString& key) { _map.erase(key); }
+    void set(const AnimVariantKey& key, bool value) { setValue(key.getSlot(), AnimVariant(value)); }
+    void set(const AnimVariantKey& key, int value) { setValue(key.getSlot(), AnimVariant(value)); }
+    void set(const AnimVariantKey& key, float value) { setValue(key.getSlot(), AnimVariant(value)); }
+    void set(const AnimVariantKey& key, const glm::vec3& value) { setValue(key.getSlot(), AnimVariant(value)); }
+    void set(const AnimVariantKey& key, const glm::quat& value) { setValue(key.getSlot(), AnimVariant(value)); }
+    void set(const AnimVariantKey& key, const QString& value) { setValue(key.getSlot(), AnimVariant(value)); }
+    void set(const QString& key, bool value) { set(AnimVariantKey(key), value); }
+    void set(const QString& key, int value) { set(AnimVariantKey(key), value); }
+    void set(const QString& key, float value) { set(AnimVariantKey(key), value); }
+    void set(const QString& key, const glm::vec3& value) { set(AnimVariantKey(key), value); }
+    void set(const QString& key, const glm::quat& value) { set(AnimVariantKey(key), value); }
+    void set(const QString& key, const QString& value) { set(AnimVariantKey(key), value); }
+    void unset(const QString& key);
 
-    void setTrigger(const QString& key) { _triggers.insert(key); }
-    void clearTriggers() { _triggers.clear(); }
+    void setTrigger(const QString& key);
+    void clearTriggers();
 
     void setRigToGeometryTransform(const glm::mat4& rigToGeometry) {
         _rigToGeometryMat = rigToGeometry;
         _rigToGeometryRot = glmExtractRotation(rigToGeometry);
     }
 
-    void clearMap() { _map.clear(); }
-    bool hasKey(const QString& key) const { return _map.find(key) != _map.end(); }
+    void clearMap();
+    bool hasKey(const QString& key) const { return find(AnimVariantKey::find(key).getSlot()) != nullptr; }
 
     const AnimVariant& get(const QString& key) const {
-        auto iter = _map.find(key);
-        if (iter != _map.end()) {
-            return iter->second;
-        } else {
-            return AnimVariant::False;
-        }
+        const AnimVariant* value = find(AnimVariantKey::find(key).getSlot());
+        return value ? *value : AnimVariant::False;
     }
 
     // Answer a Plain Old Javascript Object (for the given engine) all of our values set as properties.
@@ -238,25 +257,30 @@ public:
 #ifdef NDEBUG
     void dump() const {
         qCDebug(animation) << "AnimVariantMap =";
-        for (auto& pair : _map) {
-            switch (pair.second.getType()) {
+        for (int slot = 0; slot < (int)_values.size(); slot++) {
+            const AnimVariant* value = find(slot);
+            if (!value) {
+                continue;
+            }
+            QString name = AnimVariantKey::nameOf(slot);
+            switch (value->getType()) {
             case AnimVariant::Type::Bool:
-                qCDebug(animation) << "    " << pair.first << "=" << pair.second.getBool();
+                qCDebug(animation) << "    " << name << "=" << value->getBool();
                 break;
             case AnimVariant::Type::Int:
-                qCDebug(animation) << "    " << pair.first << "=" << pair.second.getInt();
+                qCDebug(animation) << "    " << name << "=" << value->getInt();
                 break;
             case AnimVariant::Type::Float:
-                qCDebug(animation) << "    " << pair.first << "=" << pair.second.getFloat();
+                qCDebug(animation) << "    " << name << "=" << value->getFloat();
                 break;
             case AnimVariant::Type::Vec3:
-                qCDebug(animation) << "    " << pair.first << "=" << pair.second.getVec3();
+                qCDebug(animation) << "    " << name << "=" << value->getVec3();
                 break;
             case AnimVariant::Type::Quat:
-                qCDebug(animation) << "    " << pair.first << "=" << pair.second.getQuat();
+                qCDebug(animation) << "    " << name << "=" << value->getQuat();
                 break;
             case AnimVariant::Type::String:
-                qCDebug(animation) << "    " << pair.first << "=" << pair.second.getString();
+                qCDebug(animation) << "    " << name << "=" << value->getString();
                 break;
             default:
                 assert(("invalid AnimVariant::Type", false));
@@ -266,8 +290,35 @@ public:
 #endif
 
 protected:
-    std::map<QString, AnimVariant> _map;
-    std::set<QString> _triggers;
+    enum SlotFlags : uint8_t {
+        HAS_VALUE = 0x01,
+        IS_TRIGGER = 0x02
+    };
+
+    const AnimVariant* find(int slot) const {
+        return (slot >= 0 && slot < (int)_flags.size() && (_flags[slot] & HAS_VALUE)) ? &_values[slot] : nullptr;
+    }
+    bool isTriggered(int slot) const {
+        return slot >= 0 && slot < (int)_flags.size() && (_flags[slot] & IS_TRIGGER);
+    }
+    void reserveSlot(int slot) {
+        if (slot >= (int)_flags.size()) {
+            _values.resize(slot + 1);
+            _flags.resize(slot + 1, 0);
+        }
+    }
+    void setValue(int slot, const AnimVariant& value) {
+        if (slot >= 0) {
+            reserveSlot(slot);
+            _values[slot] = value;
+            _flags[slot] |= HAS_VALUE;
+        }
+    }
+
+    // indexed by AnimVariantKey slot
+    std::vector<AnimVariant> _values;
+    std::vector<uint8_t> _flags;
+    std::vector<int> _triggerSlots;
     glm::mat4 _rigToGeometryMat;
     glm::quat _rigToGeometryRot;
 };
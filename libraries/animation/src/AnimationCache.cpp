@@ -11,6 +11,8 @@
 
 #include "AnimationCache.h"
 
+#include <QCryptographicHash>
+#include <QFile>
 #include <QRunnable>
 #include <QThreadPool>
 
@@ -22,6 +24,10 @@
 #include "AnimationLogging.h"
 
 int animationPointerMetaTypeId = qRegisterMetaType<AnimationPointer>();
+int compressedAnimationPointerMetaTypeId = qRegisterMetaType<CompressedAnimation::Pointer>();
+
+const std::string AnimationCache::CLIP_CACHE_DIRNAME { "anim_cache" };
+const std::string AnimationCache::CLIP_CACHE_EXT { "hfca" };
 
 AnimationCache::AnimationCache(QObject* parent) :
     ResourceCache(parent)
@@ -29,6 +35,10 @@ AnimationCache::AnimationCache(QObject* parent) :
     const qint64 ANIMATION_DEFAULT_UNUSED_MAX_SIZE = 50 * BYTES_PER_MEGABYTES;
     setUnusedResourceCacheSize(ANIMATION_DEFAULT_UNUSED_MAX_SIZE);
     setObjectName("AnimationCache");
+
+    const size_t CLIP_CACHE_MAX_SIZE = 200 * BYTES_PER_MEGABYTES;
+    _clipCache->setMaxSize(CLIP_CACHE_MAX_SIZE);
+    _clipCache->initialize();
 }
 
 AnimationPointer AnimationCache::getAnimation(const QUrl& url) {
@@ -76,13 +86,19 @@ void AnimationReader::run() {
         if (urlValid) {
             // Parse the FBX directly from the QNetworkReply
             FBXGeometry::Pointer fbxgeo;
+            CompressedAnimation::Pointer compressedAnimation;
             if (_url.path().toLower().endsWith(".fbx")) {
                 fbxgeo.reset(readFBX(_data, QVariantHash(), _url.path()));
+
+                // only the compressed copy of the frames is kept
+                compressedAnimation = compressFrames(fbxgeo->animationFrames);
+                fbxgeo->animationFrames.clear();
+                fbxgeo->animationFrames.squeeze();
             } else {
                 QString errorStr("usupported format");
                 emit onError(299, errorStr);
             }
-            emit onSuccess(fbxgeo);
+            emit onSuccess(fbxgeo, compressedAnimation);
         } else {
             throw QString("url is invalid");
         }
@@ -93,6 +109,37 @@ void AnimationReader::run() {
     QThread::currentThread()->setPriority(originalPriority);
 }
 
+CompressedAnimation::Pointer AnimationReader::compressFrames(const QVector<FBXAnimationFrame>& frames) {
+    auto animationCache = DependencyManager::get<AnimationCache>();
+    std::shared_ptr<cache::FileCache> clipCache = animationCache ? animationCache->_clipCache : nullptr;
+    cache::FileCache::Key key = QCryptographicHash::hash(_data, QCryptographicHash::Md5).toHex().toStdString();
+
+    if (clipCache) {
+        auto file = clipCache->getFile(key);
+        if (file) {
+            QFile clipFile(file->getFilepath().c_str());
+            if (clipFile.open(QIODevice::ReadOnly)) {
+                auto compressedAnimation = CompressedAnimation::deserialize(clipFile.readAll());
+                if (compressedAnimation) {
+                    return compressedAnimation;
+                }
+            }
+            qCWarning(animation) << "Discarding unreadable cached animation for" << _url.toDisplayString();
+        }
+    }
+
+    auto compressedAnimation = CompressedAnimation::compress(frames);
+    qCDebug(animation) << "Animation compressed" << _url.toDisplayString() << compressedAnimation->getNumFrames() << "frames,"
+        << compressedAnimation->getNumJoints() << "joints," << CompressedAnimation::computeRawMemorySize(frames) << "bytes ->"
+        << compressedAnimation->getMemorySize() << "bytes";
+
+    if (clipCache && compressedAnimation->getNumFrames() > 0) {
+        QByteArray data = compressedAnimation->serialize();
+        clipCache->writeFile(data.constData(), cache::FileCache::Metadata(key, data.size()), true);
+    }
+    return compressedAnimation;
+}
+
 bool Animation::isLoaded() const {
     return _loaded && _geometry;
 }
@@ -118,26 +165,36 @@ QVector<FBXAnimationFrame> Animation::getFrames() const {
             Q_RETURN_ARG(QVector<FBXAnimationFrame>, result));
         return result;
     }
-    return _geometry->animationFrames;
+    return _compressedAnimation ? _compressedAnimation->decompress() : QVector<FBXAnimationFrame>();
 }
 
-const QVector<FBXAnimationFrame>& Animation::getFramesReference() const {
-    return _geometry->animationFrames;
+int Animation::getNumFrames() const {
+    return _compressedAnimation ? _compressedAnimation->getNumFrames() : 0;
+}
+
+bool Animation::getFrame(int frame, FBXAnimationFrame& frameOut) const {
+    if (!_compressedAnimation || frame < 0 || frame >= _compressedAnimation->getNumFrames()) {
+        return false;
+    }
+    _compressedAnimation->getFrame(frame, frameOut);
+    return true;
 }
 
 void Animation::downloadFinished(const QByteArray& data) {
     // parse the animation/fbx file on a background thread.
     AnimationReader* animationReader = new AnimationReader(_url, data);
-    connect(animationReader, SIGNAL(onSuccess(FBXGeometry::Pointer)), SLOT(animationParseSuccess(FBXGeometry::Pointer)));
+    connect(animationReader, SIGNAL(onSuccess(FBXGeometry::Pointer, CompressedAnimation::Pointer)),
+            SLOT(animationParseSuccess(FBXGeometry::Pointer, CompressedAnimation::Pointer)));
     connect(animationReader, SIGNAL(onError(int, QString)), SLOT(animationParseError(int, QString)));
     QThreadPool::globalInstance()->start(animationReader);
 }
 
-void Animation::animationParseSuccess(FBXGeometry::Pointer geometry) {
+void Animation::animationParseSuccess(FBXGeometry::Pointer geometry, CompressedAnimation::Pointer compressedAnimation) {
 
     qCDebug(animation) << "Animation parse success" << _url.toDisplayString();
 
     _geometry = geometry;
+    _compressedAnimation = compressedAnimation;
     finishedLoading(true);
 }
 
@@ -19,6 +19,9 @@
 #include <DependencyManager.h>
 #include <FBXReader.h>
 #include <ResourceCache.h>
+#include <shared/FileCache.h>
+
+#include "CompressedAnimation.h"
 
 class Animation;
 
@@ -97,9 +100,17 @@ protected:
     virtual QSharedPointer<Resource> createResource(const QUrl& url, const QSharedPointer<Resource>& fallback,
         const void* extra) override;
 private:
+    friend class AnimationReader;
+
     explicit AnimationCache(QObject* parent = NULL);
     virtual ~AnimationCache() { }
 
+    static const std::string CLIP_CACHE_DIRNAME;
+    static const std::string CLIP_CACHE_EXT;
+
+    // compressed animations, keyed by the hash of the file they came from
+    std::shared_ptr<cache::FileCache> _clipCache { std::make_shared<cache::FileCache>(CLIP_CACHE_DIRNAME, CLIP_CACHE_EXT) };
+
 };
 
 Q_DECLARE_METATYPE(AnimationPointer)
@@ -121,20 +132,24 @@ public:
     
     Q_INVOKABLE QStringList getJointNames() const;
     
+    // decompresses every frame, prefer getFrame() or getCompressedAnimation() outside of scripts
     Q_INVOKABLE QVector<FBXAnimationFrame> getFrames() const;
 
-    const QVector<FBXAnimationFrame>& getFramesReference() const;
-    
+    int getNumFrames() const;
+    bool getFrame(int frame, FBXAnimationFrame& frameOut) const;
+    CompressedAnimation::Pointer getCompressedAnimation() const { return _compressedAnimation; }
+
 protected:
     virtual void downloadFinished(const QByteArray& data) override;
 
 protected slots:
-    void animationParseSuccess(FBXGeometry::Pointer geometry);
+    void animationParseSuccess(FBXGeometry::Pointer geometry, CompressedAnimation::Pointer compressedAnimation);
     void animationParseError(int error, QString str);
 
 private:
     
     FBXGeometry::Pointer _geometry;
+    CompressedAnimation::Pointer _compressedAnimation;
 };
 
 /// Reads geometry in a worker thread.
@@ -146,10 +161,12 @@ public:
     virtual void run() override;
 
 signals:
-    void onSuccess(FBXGeometry::Pointer geometry);
+    void onSuccess(FBXGeometry::Pointer geometry, CompressedAnimation::Pointer compressedAnimation);
     void onError(int error, QString str);
 
 private:
+    CompressedAnimation::Pointer compressFrames(const QVector<FBXAnimationFrame>& frames);
+
     QUrl _url;
     QByteArray _data;
 };
@@ -0,0 +1,397 @@
+//
+//  CompressedAnimation.cpp
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "CompressedAnimation.h"
+
+#include <algorithm>
+#include <cassert>
+#include <climits>
+#include <cstring>
+
+#include <GLMHelpers.h>
+
+#include "AnimationLogging.h"
+#include "AnimUtil.h"
+
+const float CompressedAnimation::DEFAULT_MAX_ROTATION_ERROR = 0.0005f;
+const float CompressedAnimation::DEFAULT_MAX_TRANSLATION_ERROR = 0.0005f;
+
+static const uint32_t COMPRESSED_ANIMATION_MAGIC = 0x41434648; // "HFCA"
+static const uint32_t COMPRESSED_ANIMATION_VERSION = 1;
+
+static const int MAX_COMPRESSED_FRAMES = 65536; // key frame numbers are stored as uint16_t
+static const int MAX_KEY_INTERVAL = 255; // bounds the cost of key reduction on long, smooth curves
+static const float MIN_TRANSLATION_ERROR = 1.0e-6f;
+
+// the three smallest components of a unit quaternion lie within +/- 1/sqrt(2), each is stored in 15 bits.
+static const float SMALLEST_THREE_RANGE = 0.70710678f;
+static const float SMALLEST_THREE_SCALE = 32767.0f;
+static const float TRANSLATION_SCALE = 65535.0f;
+
+struct CompressedAnimationHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t numFrames;
+    uint32_t numJoints;
+    uint32_t numRotationKeys;
+    uint32_t numTranslationKeys;
+};
+
+// greedy key reduction: grow a segment from its first key for as long as interpolating between its
+// two ends reproduces every frame in between, then start the next segment where it had to stop.
+template <typename SegmentFitsFunc>
+static void reduceKeys(int numFrames, SegmentFitsFunc segmentFits, std::vector<int>& keyFramesOut) {
+    keyFramesOut.clear();
+    keyFramesOut.push_back(0);
+    int start = 0;
+    while (start < numFrames - 1) {
+        int end = start + 1;
+        while (end + 1 < numFrames && end + 1 - start <= MAX_KEY_INTERVAL && segmentFits(start, end + 1)) {
+            ++end;
+        }
+        keyFramesOut.push_back(end);
+        start = end;
+    }
+}
+
+// q and -q are the same rotation, so the chord is measured to whichever is closer.
+static float rotationChord(const glm::quat& a, const glm::quat& b) {
+    glm::vec4 va(a.x, a.y, a.z, a.w);
+    glm::vec4 vb(b.x, b.y, b.z, b.w);
+    return std::min(glm::length(va - vb), glm::length(va + vb));
+}
+
+template <typename T>
+static void appendArray(QByteArray& data, const std::vector<T>& array) {
+    data.append((const char*)array.data(), (int)(array.size() * sizeof(T)));
+}
+
+template <typename T>
+static bool readArray(const QByteArray& data, size_t& offset, size_t count, std::vector<T>& arrayOut) {
+    size_t size = count * sizeof(T);
+    if (offset + size > (size_t)data.size()) {
+        return false;
+    }
+    arrayOut.resize(count);
+    memcpy(arrayOut.data(), data.constData() + offset, size);
+    offset += size;
+    return true;
+}
+
+CompressedAnimation::QuantizedQuat CompressedAnimation::quantize(const glm::quat& rotation) {
+    glm::quat q = glm::normalize(rotation);
+    float components[4] = { q.x, q.y, q.z, q.w };
+    int largest = 0;
+    for (int i = 1; i < 4; i++) {
+        if (fabsf(components[i]) > fabsf(components[largest])) {
+            largest = i;
+        }
+    }
+
+    // q and -q are the same rotation, so flip it to make the dropped component positive.
+    float sign = (components[largest] < 0.0f) ? -1.0f : 1.0f;
+    QuantizedQuat result;
+    int j = 0;
+    for (int i = 0; i < 4; i++) {
+        if (i != largest) {
+            float value = glm::clamp(sign * components[i] / SMALLEST_THREE_RANGE, -1.0f, 1.0f);
+            result.data[j++] = (uint16_t)lrintf((0.5f * value + 0.5f) * SMALLEST_THREE_SCALE);
+        }
+    }
+
+    // the index of the dropped component goes in the spare top bits of the first two values.
+    result.data[0] |= (uint16_t)((largest >> 1) << 15);
+    result.data[1] |= (uint16_t)((largest & 1) << 15);
+    return result;
+}
+
+glm::quat CompressedAnimation::dequantize(const QuantizedQuat& rotation) {
+    int largest = ((rotation.data[0] >> 15) << 1) | (rotation.data[1] >> 15);
+    float components[4];
+    float sumSquares = 0.0f;
+    int j = 0;
+    for (int i = 0; i < 4; i++) {
+        if (i != largest) {
+            float value = 2.0f * (float)(rotation.data[j++] & 0x7fff) / SMALLEST_THREE_SCALE - 1.0f;
+            components[i] = value * SMALLEST_THREE_RANGE;
+            sumSquares += components[i] * components[i];
+        }
+    }
+    components[largest] = sqrtf(std::max(0.0f, 1.0f - sumSquares));
+    return glm::normalize(glm::quat(components[3], components[0], components[1], components[2]));
+}
+
+CompressedAnimation::QuantizedVec3 CompressedAnimation::quantize(const glm::vec3& translation, const Bounds& bounds) {
+    QuantizedVec3 result;
+    for (int i = 0; i < 3; i++) {
+        float value = (bounds.extent[i] > 0.0f) ? (translation[i] - bounds.min[i]) / bounds.extent[i] : 0.0f;
+        result.data[i] = (uint16_t)lrintf(glm::clamp(value, 0.0f, 1.0f) * TRANSLATION_SCALE);
+    }
+    return result;
+}
+
+glm::vec3 CompressedAnimation::dequantize(const QuantizedVec3& translation, const Bounds& bounds) {
+    glm::vec3 value((float)translation.data[0], (float)translation.data[1], (float)translation.data[2]);
+    return bounds.min + bounds.extent * (value / TRANSLATION_SCALE);
+}
+
+uint32_t CompressedAnimation::findKey(const uint16_t* keyFrames, uint32_t numKeys, float frame, float& alphaOut) {
+    alphaOut = 0.0f;
+    if (numKeys <= 1 || frame <= (float)keyFrames[0]) {
+        return 0;
+    }
+    if (frame >= (float)keyFrames[numKeys - 1]) {
+        return numKeys - 1;
+    }
+    const uint16_t* next = std::upper_bound(keyFrames, keyFrames + numKeys, frame, [](float f, uint16_t keyFrame) {
+        return f < (float)keyFrame;
+    });
+    uint32_t key = (uint32_t)(next - keyFrames) - 1;
+    alphaOut = (frame - (float)keyFrames[key]) / (float)(keyFrames[key + 1] - keyFrames[key]);
+    return key;
+}
+
+CompressedAnimation::Pointer CompressedAnimation::compress(const QVector<FBXAnimationFrame>& frames,
+                                                           float maxRotationError, float maxTranslationError) {
+    auto result = std::make_shared<CompressedAnimation>();
+
+    int numFrames = frames.size();
+    if (numFrames > MAX_COMPRESSED_FRAMES) {
+        qCWarning(animation) << "CompressedAnimation, truncating animation from" << numFrames << "to" << MAX_COMPRESSED_FRAMES << "frames";
+        numFrames = MAX_COMPRESSED_FRAMES;
+    }
+    int numJoints = (numFrames > 0) ? INT_MAX : 0;
+    for (int frame = 0; frame < numFrames; frame++) {
+        numJoints = std::min(numJoints, std::min(frames[frame].rotations.size(), frames[frame].translations.size()));
+    }
+    result->_numFrames = numFrames;
+    result->_numJoints = numJoints;
+    result->_rotationCurves.reserve(numJoints);
+    result->_translationCurves.reserve(numJoints);
+    result->_translationBounds.reserve(numJoints);
+
+    // compare rotations by the chord between unit quaternions, 2 * sin(angle / 4), which unlike the dot product
+    // keeps its precision for the tiny angles involved here.
+    const float maxRotationChord = 2.0f * sinf(0.25f * maxRotationError);
+
+    std::vector<glm::quat> rawRotations(numFrames);
+    std::vector<QuantizedQuat> quantizedRotations(numFrames);
+    std::vector<glm::quat> decodedRotations(numFrames);
+    std::vector<QuantizedVec3> quantizedTranslations(numFrames);
+    std::vector<glm::vec3> decodedTranslations(numFrames);
+    std::vector<int> keyFrames;
+
+    for (int joint = 0; joint < numJoints; joint++) {
+
+        // rotations, the error includes quantization since keys are compared after the round trip.
+        for (int frame = 0; frame < numFrames; frame++) {
+            rawRotations[frame] = glm::normalize(frames[frame].rotations[joint]);
+            quantizedRotations[frame] = quantize(rawRotations[frame]);
+            decodedRotations[frame] = dequantize(quantizedRotations[frame]);
+        }
+        auto rotationFits = [&](const glm::quat& rotation, int frame) {
+            return rotationChord(rotation, rawRotations[frame]) <= maxRotationChord;
+        };
+
+        bool constant = true;
+        for (int frame = 0; frame < numFrames && constant; frame++) {
+            constant = rotationFits(decodedRotations[0], frame);
+        }
+        if (constant) {
+            keyFrames.assign(1, 0);
+        } else {
+            reduceKeys(numFrames, [&](int start, int end) {
+                for (int frame = start + 1; frame < end; frame++) {
+                    float alpha = (float)(frame - start) / (float)(end - start);
+                    if (!rotationFits(safeLerp(decodedRotations[start], decodedRotations[end], alpha), frame)) {
+                        return false;
+                    }
+                }
+                return true;
+            }, keyFrames);
+        }
+        result->_rotationCurves.push_back({ (uint32_t)result->_rotationKeys.size(), (uint32_t)keyFrames.size() });
+        for (int frame : keyFrames) {
+            result->_rotationKeyFrames.push_back((uint16_t)frame);
+            result->_rotationKeys.push_back(quantizedRotations[frame]);
+        }
+
+        // translations
+        glm::vec3 minTranslation = frames[0].translations[joint];
+        glm::vec3 maxTranslation = minTranslation;
+        for (int frame = 1; frame < numFrames; frame++) {
+            minTranslation = glm::min(minTranslation, frames[frame].translations[joint]);
+            maxTranslation = glm::max(maxTranslation, frames[frame].translations[joint]);
+        }
+        Bounds bounds { minTranslation, maxTranslation - minTranslation };
+        result->_translationBounds.push_back(bounds);
+
+        for (int frame = 0; frame < numFrames; frame++) {
+            quantizedTranslations[frame] = quantize(frames[frame].translations[joint], bounds);
+            decodedTranslations[frame] = dequantize(quantizedTranslations[frame], bounds);
+        }
+        float scale = std::max(glm::length(frames[0].translations[joint]), glm::length(bounds.extent));
+        float translationTolerance = std::max(maxTranslationError * scale, MIN_TRANSLATION_ERROR);
+        auto translationFits = [&](const glm::vec3& translation, int frame) {
+            return glm::length(translation - frames[frame].translations[joint]) <= translationTolerance;
+        };
+
+        constant = true;
+        for (int frame = 0; frame < numFrames && constant; frame++) {
+            constant = translationFits(decodedTranslations[0], frame);
+        }
+        if (constant) {
+            keyFrames.assign(1, 0);
+        } else {
+            reduceKeys(numFrames, [&](int start, int end) {
+                for (int frame = start + 1; frame < end; frame++) {
+                    float alpha = (float)(frame - start) / (float)(end - start);
+                    if (!translationFits(lerp(decodedTranslations[start], decodedTranslations[end], alpha), frame)) {
+                        return false;
+                    }
+                }
+                return true;
+            }, keyFrames);
+        }
+        result->_translationCurves.push_back({ (uint32_t)result->_translationKeys.size(), (uint32_t)keyFrames.size() });
+        for (int frame : keyFrames) {
+            result->_translationKeyFrames.push_back((uint16_t)frame);
+            result->_translationKeys.push_back(quantizedTranslations[frame]);
+        }
+    }
+
+    result->_rotationKeyFrames.shrink_to_fit();
+    result->_rotationKeys.shrink_to_fit();
+    result->_translationKeyFrames.shrink_to_fit();
+    result->_translationKeys.shrink_to_fit();
+    return result;
+}
+
+QByteArray CompressedAnimation::serialize() const {
+    CompressedAnimationHeader header;
+    header.magic = COMPRESSED_ANIMATION_MAGIC;
+    header.version = COMPRESSED_ANIMATION_VERSION;
+    header.numFrames = (uint32_t)_numFrames;
+    header.numJoints = (uint32_t)_numJoints;
+    header.numRotationKeys = (uint32_t)_rotationKeys.size();
+    header.numTranslationKeys = (uint32_t)_translationKeys.size();
+
+    QByteArray data;
+    data.reserve((int)(sizeof(header) + getMemorySize()));
+    data.append((const char*)&header, (int)sizeof(header));
+    appendArray(data, _rotationCurves);
+    appendArray(data, _translationCurves);
+    appendArray(data, _translationBounds);
+    appendArray(data, _rotationKeyFrames);
+    appendArray(data, _rotationKeys);
+    appendArray(data, _translationKeyFrames);
+    appendArray(data, _translationKeys);
+    return data;
+}
+
+CompressedAnimation::Pointer CompressedAnimation::deserialize(const QByteArray& data) {
+    CompressedAnimationHeader header;
+    if ((size_t)data.size() < sizeof(header)) {
+        return nullptr;
+    }
+    memcpy(&header, data.constData(), sizeof(header));
+    if (header.magic != COMPRESSED_ANIMATION_MAGIC || header.version != COMPRESSED_ANIMATION_VERSION ||
+        header.numFrames > (uint32_t)MAX_COMPRESSED_FRAMES || (header.numFrames == 0 && header.numJoints > 0)) {
+        return nullptr;
+    }
+
+    auto result = std::make_shared<CompressedAnimation>();
+    result->_numFrames = (int)header.numFrames;
+    result->_numJoints = (int)header.numJoints;
+
+    size_t offset = sizeof(header);
+    if (!readArray(data, offset, header.numJoints, result->_rotationCurves) ||
+        !readArray(data, offset, header.numJoints, result->_translationCurves) ||
+        !readArray(data, offset, header.numJoints, result->_translationBounds) ||
+        !readArray(data, offset, header.numRotationKeys, result->_rotationKeyFrames) ||
+        !readArray(data, offset, header.numRotationKeys, result->_rotationKeys) ||
+        !readArray(data, offset, header.numTranslationKeys, result->_translationKeyFrames) ||
+        !readArray(data, offset, header.numTranslationKeys, result->_translationKeys) ||
+        offset != (size_t)data.size()) {
+        return nullptr;
+    }
+
+    // every curve needs at least one key, and all of its keys must be in range.
+    for (uint32_t joint = 0; joint < header.numJoints; joint++) {
+        const Curve& rotationCurve = result->_rotationCurves[joint];
+        const Curve& translationCurve = result->_translationCurves[joint];
+        if (rotationCurve.numKeys == 0 || (uint64_t)rotationCurve.firstKey + rotationCurve.numKeys > header.numRotationKeys ||
+            translationCurve.numKeys == 0 || (uint64_t)translationCurve.firstKey + translationCurve.numKeys > header.numTranslationKeys) {
+            return nullptr;
+        }
+    }
+    return result;
+}
+
+glm::quat CompressedAnimation::sampleRotation(int joint, float frame) const {
+    assert(joint >= 0 && joint < _numJoints);
+    const Curve& curve = _rotationCurves[joint];
+    float alpha;
+    uint32_t key = curve.firstKey + findKey(&_rotationKeyFrames[curve.firstKey], curve.numKeys, frame, alpha);
+    glm::quat rotation = dequantize(_rotationKeys[key]);
+    if (alpha > 0.0f) {
+        rotation = safeLerp(rotation, dequantize(_rotationKeys[key + 1]), alpha);
+    }
+    return rotation;
+}
+
+glm::vec3 CompressedAnimation::sampleTranslation(int joint, float frame) const {
+    assert(joint >= 0 && joint < _numJoints);
+    const Curve& curve = _translationCurves[joint];
+    const Bounds& bounds = _translationBounds[joint];
+    float alpha;
+    uint32_t key = curve.firstKey + findKey(&_translationKeyFrames[curve.firstKey], curve.numKeys, frame, alpha);
+    glm::vec3 translation = dequantize(_translationKeys[key], bounds);
+    if (alpha > 0.0f) {
+        translation = lerp(translation, dequantize(_translationKeys[key + 1], bounds), alpha);
+    }
+    return translation;
+}
+
+void CompressedAnimation::getFrame(int frame, FBXAnimationFrame& frameOut) const {
+    frameOut.rotations.resize(_numJoints);
+    frameOut.translations.resize(_numJoints);
+    for (int joint = 0; joint < _numJoints; joint++) {
+        frameOut.rotations[joint] = sampleRotation(joint, (float)frame);
+        frameOut.translations[joint] = sampleTranslation(joint, (float)frame);
+    }
+}
+
+QVector<FBXAnimationFrame> CompressedAnimation::decompress() const {
+    QVector<FBXAnimationFrame> frames(_numFrames);
+    for (int frame = 0; frame < _numFrames; frame++) {
+        getFrame(frame, frames[frame]);
+    }
+    return frames;
+}
+
+size_t CompressedAnimation::getMemorySize() const {
+    return sizeof(CompressedAnimation) +
+        _rotationCurves.capacity() * sizeof(Curve) +
+        _translationCurves.capacity() * sizeof(Curve) +
+        _translationBounds.capacity() * sizeof(Bounds) +
+        _rotationKeyFrames.capacity() * sizeof(uint16_t) +
+        _rotationKeys.capacity() * sizeof(QuantizedQuat) +
+        _translationKeyFrames.capacity() * sizeof(uint16_t) +
+        _translationKeys.capacity() * sizeof(QuantizedVec3);
+}
+
+size_t CompressedAnimation::computeRawMemorySize(const QVector<FBXAnimationFrame>& frames) {
+    size_t size = sizeof(QVector<FBXAnimationFrame>);
+    for (const auto& frame : frames) {
+        size += sizeof(FBXAnimationFrame) + frame.rotations.capacity() * sizeof(glm::quat) +
+            frame.translations.capacity() * sizeof(glm::vec3);
+    }
+    return size;
+}
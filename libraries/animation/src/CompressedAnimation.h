@@ -0,0 +1,99 @@
+//
+//  CompressedAnimation.h
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_CompressedAnimation_h
+#define hifi_CompressedAnimation_h
+
+#include <memory>
+#include <vector>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QMetaType>
+#include <QtCore/QVector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <FBX.h>
+
+// Compact, read-only copy of the frames of an FBX animation.
+// Every joint gets a rotation curve and a translation curve that only keep the frames linear interpolation
+// can't reproduce within the error bounds.  Rotation keys are 48-bit "smallest three" quaternions, translation
+// keys are 16-bit fixed point within the bounding box of their curve.  Curves are sampled in place, so the
+// full-precision frames can be thrown away as soon as the animation is loaded.
+class CompressedAnimation {
+public:
+    using Pointer = std::shared_ptr<const CompressedAnimation>;
+
+    static const float DEFAULT_MAX_ROTATION_ERROR;     // radians
+    static const float DEFAULT_MAX_TRANSLATION_ERROR;  // fraction of the bone length or of the curve extent, whichever is larger
+
+    static Pointer compress(const QVector<FBXAnimationFrame>& frames,
+                            float maxRotationError = DEFAULT_MAX_ROTATION_ERROR,
+                            float maxTranslationError = DEFAULT_MAX_TRANSLATION_ERROR);
+
+    // binary form used by the on-disk animation cache.  deserialize() returns nullptr for malformed or out of date data.
+    QByteArray serialize() const;
+    static Pointer deserialize(const QByteArray& data);
+
+    int getNumFrames() const { return _numFrames; }
+    int getNumJoints() const { return _numJoints; }
+    int getNumKeys() const { return (int)(_rotationKeys.size() + _translationKeys.size()); }
+
+    // frame is clamped to the animation, fractional frames interpolate between keys.
+    glm::quat sampleRotation(int joint, float frame) const;
+    glm::vec3 sampleTranslation(int joint, float frame) const;
+
+    void getFrame(int frame, FBXAnimationFrame& frameOut) const;
+    QVector<FBXAnimationFrame> decompress() const;
+
+    // bytes used by this object, and by the same frames held as FBXAnimationFrames.
+    size_t getMemorySize() const;
+    static size_t computeRawMemorySize(const QVector<FBXAnimationFrame>& frames);
+
+private:
+    struct Curve {
+        uint32_t firstKey;
+        uint32_t numKeys;
+    };
+    struct QuantizedQuat {
+        uint16_t data[3];
+    };
+    struct QuantizedVec3 {
+        uint16_t data[3];
+    };
+    struct Bounds {
+        glm::vec3 min;
+        glm::vec3 extent;
+    };
+
+    static QuantizedQuat quantize(const glm::quat& rotation);
+    static glm::quat dequantize(const QuantizedQuat& rotation);
+    static QuantizedVec3 quantize(const glm::vec3& translation, const Bounds& bounds);
+    static glm::vec3 dequantize(const QuantizedVec3& translation, const Bounds& bounds);
+
+    // index of the last key at or before frame, and the interpolation factor toward the key after it.
+    static uint32_t findKey(const uint16_t* keyFrames, uint32_t numKeys, float frame, float& alphaOut);
+
+    int _numFrames { 0 };
+    int _numJoints { 0 };
+
+    std::vector<Curve> _rotationCurves;
+    std::vector<Curve> _translationCurves;
+    std::vector<Bounds> _translationBounds;
+
+    std::vector<uint16_t> _rotationKeyFrames;
+    std::vector<QuantizedQuat> _rotationKeys;
+    std::vector<uint16_t> _translationKeyFrames;
+    std::vector<QuantizedVec3> _translationKeys;
+};
+
+Q_DECLARE_METATYPE(CompressedAnimation::Pointer)
+
+#endif // hifi_CompressedAnimation_h
@@ -0,0 +1,108 @@
+//
+//  IKSolvers.cpp
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "IKSolvers.h"
+
+#include <GLMHelpers.h>
+
+static const float MIN_IK_LENGTH = 1.0e-4f;
+static const size_t MAX_FABRIK_CHAIN_LENGTH = 32;
+
+// returns the unit vector along v, or fallback when v is too short to have a meaningful direction.
+static glm::vec3 directionOr(const glm::vec3& v, const glm::vec3& fallback) {
+    float length = glm::length(v);
+    return (length > MIN_IK_LENGTH) ? v / length : fallback;
+}
+
+float solveTwoBoneIK(const glm::vec3& basePos, glm::vec3& midPos, glm::vec3& tipPos,
+                     const glm::vec3& target, const glm::vec3& bendHint) {
+    float upperLength = glm::length(midPos - basePos);
+    float lowerLength = glm::length(tipPos - midPos);
+    glm::vec3 baseToTarget = target - basePos;
+    float targetDistance = glm::length(baseToTarget);
+    if (upperLength < MIN_IK_LENGTH || lowerLength < MIN_IK_LENGTH || targetDistance < MIN_IK_LENGTH) {
+        return glm::length(target - tipPos);
+    }
+    glm::vec3 targetDir = baseToTarget / targetDistance;
+
+    // a target out of reach straightens the limb, one too close folds it as far as the bone lengths allow
+    float distance = glm::clamp(targetDistance, fabsf(upperLength - lowerLength), upperLength + lowerLength);
+
+    // the mid joint bends along the component of the hint (or of its current offset) perpendicular to the base-target line
+    glm::vec3 bendDir = bendHint - glm::dot(bendHint, targetDir) * targetDir;
+    if (glm::length(bendDir) < MIN_IK_LENGTH) {
+        glm::vec3 currentBend = midPos - basePos;
+        bendDir = currentBend - glm::dot(currentBend, targetDir) * targetDir;
+        if (glm::length(bendDir) < MIN_IK_LENGTH) {
+            // the limb is straight and already points at the target, any perpendicular will do
+            bendDir = glm::cross(targetDir, (fabsf(targetDir.x) < 0.9f) ? Vectors::UNIT_X : Vectors::UNIT_Y);
+        }
+    }
+    bendDir = glm::normalize(bendDir);
+
+    // angle at the base between the base-target line and the upper bone
+    float cosAngle = (upperLength * upperLength + distance * distance - lowerLength * lowerLength) / (2.0f * upperLength * distance);
+    cosAngle = glm::clamp(cosAngle, -1.0f, 1.0f);
+    float sinAngle = sqrtf(1.0f - cosAngle * cosAngle);
+
+    midPos = basePos + upperLength * (cosAngle * targetDir + sinAngle * bendDir);
+    tipPos = basePos + distance * targetDir;
+    return targetDistance - distance;
+}
+
+int solveFABRIK(glm::vec3* positions, size_t numPositions, const glm::vec3& target,
+                float tolerance, int maxIterations, float& residualOut) {
+    residualOut = (numPositions > 0) ? glm::length(target - positions[0]) : 0.0f;
+    if (numPositions < 2 || numPositions > MAX_FABRIK_CHAIN_LENGTH) {
+        return 0;
+    }
+
+    // lengths[i] is the length of the bone between positions[i] and positions[i + 1]
+    float lengths[MAX_FABRIK_CHAIN_LENGTH];
+    float totalLength = 0.0f;
+    const size_t last = numPositions - 1;
+    for (size_t i = 0; i < last; i++) {
+        lengths[i] = glm::length(positions[i + 1] - positions[i]);
+        totalLength += lengths[i];
+    }
+    const glm::vec3 rootPos = positions[last];
+
+    if (glm::length(target - rootPos) >= totalLength) {
+        // out of reach, stretch the chain straight toward the target
+        glm::vec3 direction = directionOr(target - rootPos, Vectors::UNIT_Y);
+        for (size_t i = last; i > 0; i--) {
+            positions[i - 1] = positions[i] + lengths[i - 1] * direction;
+        }
+        residualOut = glm::length(target - positions[0]);
+        return 1;
+    }
+
+    int numIterations = 0;
+    while (residualOut > tolerance && numIterations < maxIterations) {
+        ++numIterations;
+
+        // forward pass: pin the end-effector on the target and drag the rest of the chain after it
+        glm::vec3 direction = Vectors::UNIT_Y;
+        positions[0] = target;
+        for (size_t i = 0; i < last; i++) {
+            direction = directionOr(positions[i + 1] - positions[i], direction);
+            positions[i + 1] = positions[i] + lengths[i] * direction;
+        }
+
+        // backward pass: put the root back and push the chain out toward the target again
+        positions[last] = rootPos;
+        for (size_t i = last; i > 0; i--) {
+            direction = directionOr(positions[i - 1] - positions[i], direction);
+            positions[i - 1] = positions[i] + lengths[i - 1] * direction;
+        }
+
+        residualOut = glm::length(target - positions[0]);
+    }
+    return numIterations;
+}
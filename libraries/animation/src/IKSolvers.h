@@ -0,0 +1,31 @@
+//
+//  IKSolvers.h
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_IKSolvers_h
+#define hifi_IKSolvers_h
+
+#include <glm/glm.hpp>
+
+// Position-space IK kernels used by the analytic solver mode of AnimInverseKinematics.
+// They move joint positions only; the caller converts the new positions back into joint rotations.
+
+// Two-bone IK by the law of cosines.  basePos stays fixed, midPos and tipPos are moved so that tipPos gets as close
+// to target as the bone lengths allow.  The mid joint bends toward bendHint, or keeps its current bend plane when
+// bendHint is zero or parallel to the base-target line.  Returns the remaining distance between tip and target.
+float solveTwoBoneIK(const glm::vec3& basePos, glm::vec3& midPos, glm::vec3& tipPos,
+                     const glm::vec3& target, const glm::vec3& bendHint);
+
+// FABRIK (Forward And Backward Reaching IK).  positions[0] is the end-effector and positions[numPositions - 1] is the
+// fixed root, bone lengths are taken from the initial positions.  Iterates until the end-effector is within tolerance
+// of target or maxIterations is reached and returns the number of iterations used.  residualOut is set to the
+// remaining distance between end-effector and target.
+int solveFABRIK(glm::vec3* positions, size_t numPositions, const glm::vec3& target,
+                float tolerance, int maxIterations, float& residualOut);
+
+#endif // hifi_IKSolvers_h
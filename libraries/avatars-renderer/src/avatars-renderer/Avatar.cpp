@@ -416,7 +416,7 @@ void Avatar::relayJointDataToChildren() {
     _reconstructSoftEntitiesJointMap = false;
 }
 
-void Avatar::simulate(float deltaTime, bool inView) {
+void Avatar::simulate(float deltaTime, bool inView, bool updateJoints) {
     PROFILE_RANGE(simulation, "simulate");
 
     _simulationRate.increment();
@@ -429,10 +429,12 @@ void Avatar::simulate(float deltaTime, bool inView) {
         PROFILE_RANGE(simulation, "updateJoints");
         if (inView) {
             Head* head = getHead();
-            if (_hasNewJointData) {
-                _skeletonModel->getRig().copyJointsFromJointData(_jointData);
-                glm::mat4 rootTransform = glm::scale(_skeletonModel->getScale()) * glm::translate(_skeletonModel->getOffset());
-                _skeletonModel->getRig().computeExternalPoses(rootTransform);
+            // when the level of detail skips the joints the new data waits for a later frame
+            if (_hasNewJointData && updateJoints) {
+                if (!_rigUpdatedFromJointData) {
+                    updateRigFromJointData();
+                }
+                _rigUpdatedFromJointData = false;
                 _jointDataSimulationRate.increment();
 
                 _skeletonModel->simulate(deltaTime, true);
@@ -485,6 +487,16 @@ void Avatar::simulate(float deltaTime, bool inView) {
     }
 }
 
+void Avatar::updateRigFromJointData() {
+    {
+        QReadLocker readLock(&_jointDataLock);
+        _skeletonModel->getRig().copyJointsFromJointData(_jointData);
+    }
+    glm::mat4 rootTransform = glm::scale(_skeletonModel->getScale()) * glm::translate(_skeletonModel->getOffset());
+    _skeletonModel->getRig().computeExternalPoses(rootTransform);
+    _rigUpdatedFromJointData = true;
+}
+
 float Avatar::getSimulationRate(const QString& rateName) const {
     if (rateName == "") {
         return _simulationRate.rate();
@@ -78,7 +78,13 @@ public:
 
     void init();
     void updateAvatarEntities();
-    void simulate(float deltaTime, bool inView);
+    // updateJoints false keeps the rig as it is for this frame, for animation level of detail
+    void simulate(float deltaTime, bool inView, bool updateJoints = true);
+    // Copies new joint data into the rig and computes its poses.  This only touches the avatar's own rig, so
+    // AvatarManager runs it for many avatars in parallel ahead of simulate(), which then skips that step.
+    void updateRigFromJointData();
+    // Forgets an updateRigFromJointData() that simulate() didn't get to, so the next one copies the latest joints
+    void discardRigUpdate() { _rigUpdatedFromJointData = false; }
     virtual void simulateAttachments(float deltaTime);
 
     virtual void render(RenderArgs* renderArgs);
@@ -510,6 +516,7 @@ protected:
     int _rightPointerGeometryID { 0 };
     int _nameRectGeometryID { 0 };
     bool _initialized { false };
+    bool _rigUpdatedFromJointData { false };
     bool _isLookAtTarget { false };
     bool _isAnimatingScale { false };
     bool _mustFadeIn { false };
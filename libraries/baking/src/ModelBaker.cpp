@@ -11,10 +11,14 @@
 
 #include "ModelBaker.h"
 
+#include <QtCore/QHash>
+#include <QtCore/QTimer>
+
 #include <PathUtils.h>
 
 #include <FBXReader.h>
 #include <FBXWriter.h>
+#include <MeshOptimizer.h>
 
 #ifdef _WIN32
 #pragma warning( push )
@@ -66,8 +70,15 @@ void ModelBaker::abort() {
 
     // tell our underlying TextureBaker instances to abort
     // the ModelBaker will wait until all are aborted before emitting its own abort signal
-    for (auto& textureBaker : _bakingTextures) {
-        textureBaker->abort();
+    abortTextureBakes();
+}
+
+void ModelBaker::abortTextureBakes() {
+    for (auto& bakingTexture : _bakingTextures) {
+        // other models still need the bakes they share with this one
+        if (!_textureBakeCache || !_textureBakeCache->isShared(bakingTexture.data())) {
+            bakingTexture->abort();
+        }
     }
 }
 
@@ -81,30 +92,46 @@ bool ModelBaker::compressMesh(FBXMesh& mesh, bool hasDeformers, FBXNode& dracoMe
     Q_ASSERT(mesh.colors.size() == 0 || mesh.colors.size() == mesh.vertices.size());
     Q_ASSERT(mesh.texCoords.size() == 0 || mesh.texCoords.size() == mesh.vertices.size());
 
+    // Merge the corners the extraction split and take both kinds of polygons of a part as one list of triangles
+    FBXMesh optimizedMesh = mesh;
+    mesh_optimizer::weldVertices(optimizedMesh, hasDeformers);
+
     int64_t numTriangles{ 0 };
-    for (auto& part : mesh.parts) {
+    QVector<QVector<int>> partTriangles;
+    for (auto& part : optimizedMesh.parts) {
         if ((part.quadTrianglesIndices.size() % 3) != 0 || (part.triangleIndices.size() % 3) != 0) {
             handleWarning("Found a mesh part with invalid index data, skipping");
+            partTriangles.append(QVector<int>());
             continue;
         }
-        numTriangles += part.quadTrianglesIndices.size() / 3;
-        numTriangles += part.triangleIndices.size() / 3;
+        partTriangles.append(part.quadTrianglesIndices + part.triangleIndices);
+        numTriangles += partTriangles.last().size() / 3;
     }
 
     if (numTriangles == 0) {
         return false;
     }
 
+    // The simplified levels are ordered for the vertex cache here, their indices go out as they are.  Draco's
+    // edgebreaker reorders the faces of the full level, so the reader orders those once it has decoded them.
+    auto lods = mesh_optimizer::generateLODs(partTriangles, optimizedMesh.vertices);
+    for (auto& lod : lods) {
+        for (auto& triangles : lod.parts) {
+            triangles = mesh_optimizer::optimizeVertexCache(triangles);
+        }
+    }
+
     draco::TriangleSoupMeshBuilder meshBuilder;
 
     meshBuilder.Start(numTriangles);
 
-    bool hasNormals{ mesh.normals.size() > 0 };
-    bool hasColors{ mesh.colors.size() > 0 };
-    bool hasTexCoords{ mesh.texCoords.size() > 0 };
-    bool hasTexCoords1{ mesh.texCoords1.size() > 0 };
-    bool hasPerFaceMaterials = (materialIDCallback) ? (mesh.parts.size() > 1 || materialIDCallback(0) != 0 ) : true;
+    bool hasNormals{ optimizedMesh.normals.size() > 0 };
+    bool hasColors{ optimizedMesh.colors.size() > 0 };
+    bool hasTexCoords{ optimizedMesh.texCoords.size() > 0 };
+    bool hasTexCoords1{ optimizedMesh.texCoords1.size() > 0 };
+    bool hasPerFaceMaterials = (materialIDCallback) ? (optimizedMesh.parts.size() > 1 || materialIDCallback(0) != 0 ) : true;
     bool needsOriginalIndices{ hasDeformers };
+    bool hasLODs{ !lods.isEmpty() };
 
     int normalsAttributeID { -1 };
     int colorsAttributeID { -1 };
@@ -112,6 +139,7 @@ bool ModelBaker::compressMesh(FBXMesh& mesh, bool hasDeformers, FBXNode& dracoMe
     int texCoords1AttributeID { -1 };
     int faceMaterialAttributeID { -1 };
     int originalIndexAttributeID { -1 };
+    int lodVertexAttributeID { -1 };
 
     const int positionAttributeID = meshBuilder.AddAttribute(draco::GeometryAttribute::POSITION,
                                                              3, draco::DT_FLOAT32);
@@ -120,6 +148,11 @@ bool ModelBaker::compressMesh(FBXMesh& mesh, bool hasDeformers, FBXNode& dracoMe
             (draco::GeometryAttribute::Type)DRACO_ATTRIBUTE_ORIGINAL_INDEX,
             1, draco::DT_INT32);
     }
+    if (hasLODs) {
+        lodVertexAttributeID = meshBuilder.AddAttribute(
+            (draco::GeometryAttribute::Type)DRACO_ATTRIBUTE_LOD_VERTEX,
+            1, draco::DT_INT32);
+    }
 
     if (hasNormals) {
         normalsAttributeID = meshBuilder.AddAttribute(draco::GeometryAttribute::NORMAL,
@@ -144,14 +177,15 @@ bool ModelBaker::compressMesh(FBXMesh& mesh, bool hasDeformers, FBXNode& dracoMe
             1, draco::DT_UINT16);
     }
 
-    auto partIndex = 0;
     draco::FaceIndex face;
     uint16_t materialID;
-    
-    for (auto& part : mesh.parts) {
+    QVector<uint16_t> partMaterialIDs;
+
+    for (int partIndex = 0; partIndex < partTriangles.size(); partIndex++) {
         materialID = (materialIDCallback) ? materialIDCallback(partIndex) : partIndex;
-        
-        auto addFace = [&](QVector<int>& indices, int index, draco::FaceIndex face) {
+        partMaterialIDs.append(materialID);
+
+        auto addFace = [&](const QVector<int>& indices, int index, draco::FaceIndex face) {
             int32_t idx0 = indices[index];
             int32_t idx1 = indices[index + 1];
             int32_t idx2 = indices[index + 2];
@@ -161,46 +195,44 @@ bool ModelBaker::compressMesh(FBXMesh& mesh, bool hasDeformers, FBXNode& dracoMe
             }
 
             meshBuilder.SetAttributeValuesForFace(positionAttributeID, face,
-                                                  &mesh.vertices[idx0], &mesh.vertices[idx1],
-                                                  &mesh.vertices[idx2]);
+                                                  &optimizedMesh.vertices[idx0], &optimizedMesh.vertices[idx1],
+                                                  &optimizedMesh.vertices[idx2]);
 
             if (needsOriginalIndices) {
                 meshBuilder.SetAttributeValuesForFace(originalIndexAttributeID, face,
-                                                      &mesh.originalIndices[idx0],
-                                                      &mesh.originalIndices[idx1],
-                                                      &mesh.originalIndices[idx2]);
+                                                      &optimizedMesh.originalIndices[idx0],
+                                                      &optimizedMesh.originalIndices[idx1],
+                                                      &optimizedMesh.originalIndices[idx2]);
+            }
+            if (hasLODs) {
+                meshBuilder.SetAttributeValuesForFace(lodVertexAttributeID, face, &idx0, &idx1, &idx2);
             }
             if (hasNormals) {
                 meshBuilder.SetAttributeValuesForFace(normalsAttributeID, face,
-                                                      &mesh.normals[idx0], &mesh.normals[idx1],
-                                                      &mesh.normals[idx2]);
+                                                      &optimizedMesh.normals[idx0], &optimizedMesh.normals[idx1],
+                                                      &optimizedMesh.normals[idx2]);
             }
             if (hasColors) {
                 meshBuilder.SetAttributeValuesForFace(colorsAttributeID, face,
-                                                      &mesh.colors[idx0], &mesh.colors[idx1],
-                                                      &mesh.colors[idx2]);
+                                                      &optimizedMesh.colors[idx0], &optimizedMesh.colors[idx1],
+                                                      &optimizedMesh.colors[idx2]);
             }
             if (hasTexCoords) {
                 meshBuilder.SetAttributeValuesForFace(texCoordsAttributeID, face,
-                                                      &mesh.texCoords[idx0], &mesh.texCoords[idx1],
-                                                      &mesh.texCoords[idx2]);
+                                                      &optimizedMesh.texCoords[idx0], &optimizedMesh.texCoords[idx1],
+                                                      &optimizedMesh.texCoords[idx2]);
             }
             if (hasTexCoords1) {
                 meshBuilder.SetAttributeValuesForFace(texCoords1AttributeID, face,
-                                                      &mesh.texCoords1[idx0], &mesh.texCoords1[idx1],
-                                                      &mesh.texCoords1[idx2]);
+                                                      &optimizedMesh.texCoords1[idx0], &optimizedMesh.texCoords1[idx1],
+                                                      &optimizedMesh.texCoords1[idx2]);
             }
         };
 
-        for (int i = 0; (i + 2) < part.quadTrianglesIndices.size(); i += 3) {
-            addFace(part.quadTrianglesIndices, i, face++);
-        }
-
-        for (int i = 0; (i + 2) < part.triangleIndices.size(); i += 3) {
-            addFace(part.triangleIndices, i, face++);
+        const auto& triangles = partTriangles[partIndex];
+        for (int i = 0; (i + 2) < triangles.size(); i += 3) {
+            addFace(triangles, i, face++);
         }
-
-        partIndex++;
     }
 
     auto dracoMesh = meshBuilder.Finalize();
@@ -224,6 +256,10 @@ bool ModelBaker::compressMesh(FBXMesh& mesh, bool hasDeformers, FBXNode& dracoMe
         dracoMesh->attribute(originalIndexAttributeID)->set_unique_id(DRACO_ATTRIBUTE_ORIGINAL_INDEX);
     }
 
+    if (hasLODs) {
+        dracoMesh->attribute(lodVertexAttributeID)->set_unique_id(DRACO_ATTRIBUTE_LOD_VERTEX);
+    }
+
     draco::Encoder encoder;
 
     encoder.SetAttributeQuantization(draco::GeometryAttribute::POSITION, 14);
@@ -238,7 +274,25 @@ bool ModelBaker::compressMesh(FBXMesh& mesh, bool hasDeformers, FBXNode& dracoMe
     dracoNode.name = "DracoMesh";
     auto value = QVariant::fromValue(QByteArray(buffer.data(), (int)buffer.size()));
     dracoNode.properties.append(value);
-    
+
+    // The levels index the welded vertices, the reader finds their points through the LOD vertex attribute
+    for (const auto& lod : lods) {
+        FBXNode lodNode;
+        lodNode.name = DRACO_MESH_LOD_NODE_NAME;
+        lodNode.properties.append((double)lod.error);
+
+        for (int partIndex = 0; partIndex < lod.parts.size(); partIndex++) {
+            if (lod.parts[partIndex].isEmpty()) {
+                continue;
+            }
+            FBXNode partNode;
+            partNode.name = DRACO_MESH_LOD_PART_NODE_NAME;
+            partNode.properties = { (int)partMaterialIDs[partIndex], QVariant::fromValue(lod.parts[partIndex]) };
+            lodNode.children.append(partNode);
+        }
+        dracoNode.children.append(lodNode);
+    }
+
     dracoMeshNode = dracoNode;
     // Mesh compression successful return true
     return true;
@@ -280,7 +334,16 @@ QString ModelBaker::compressTexture(QString modelTextureFileName, image::Texture
             // construct the new baked texture file name and file path
             // ensuring that the baked texture will have a unique name
             // even if there was another texture with the same name at a different path
-            baseTextureFileName = createBaseTextureFileName(modelTextureFileInfo);
+            // if another model is baking this texture use its name, so its files can be copied as they are
+            QString sharedTextureFileName;
+            if (_textureBakeCache) {
+                sharedTextureFileName = _textureBakeCache->getBaseFilename(urlToTexture, textureType);
+            }
+            if (!sharedTextureFileName.isEmpty() && !isTextureFileNameUsed(sharedTextureFileName)) {
+                baseTextureFileName = sharedTextureFileName;
+            } else {
+                baseTextureFileName = createBaseTextureFileName(modelTextureFileInfo);
+            }
             _remappedTexturePaths[urlToTexture] = baseTextureFileName;
         }
 
@@ -312,7 +375,15 @@ void ModelBaker::bakeTexture(const QUrl& textureURL, image::TextureUsage::Type t
         new TextureBaker(textureURL, textureType, outputDir, "../", bakedFilename, textureContent),
         &TextureBaker::deleteLater
     };
-    
+
+    if (_textureBakeCache) {
+        auto sharedTexture = _textureBakeCache->findOrInsert(textureURL, textureType, bakingTexture);
+        if (sharedTexture != bakingTexture) {
+            waitForSharedTexture(sharedTexture);
+            return;
+        }
+    }
+
     // make sure we hear when the baking texture is done or aborted
     connect(bakingTexture.data(), &Baker::finished, this, &ModelBaker::handleBakedTexture);
     connect(bakingTexture.data(), &TextureBaker::aborted, this, &ModelBaker::handleAbortedTexture);
@@ -325,14 +396,61 @@ void ModelBaker::bakeTexture(const QUrl& textureURL, image::TextureUsage::Type t
     QMetaObject::invokeMethod(bakingTexture.data(), "bake");
 }
 
+void ModelBaker::waitForSharedTexture(const QSharedPointer<TextureBaker>& sharedTexture) {
+    qCDebug(model_baking) << "Sharing the bake of" << sharedTexture->getTextureURL() << "with another model";
+
+    connect(sharedTexture.data(), &Baker::finished, this, &ModelBaker::handleBakedTexture);
+    connect(sharedTexture.data(), &TextureBaker::aborted, this, &ModelBaker::handleAbortedTexture);
+
+    _bakingTextures.insert(sharedTexture->getTextureURL(), sharedTexture);
+
+    // it may have been done before we connected, in which case handle it from the event loop like a signal
+    if (sharedTexture->isFinished() || sharedTexture->wasAborted()) {
+        QTimer::singleShot(0, this, [this, sharedTexture] {
+            if (sharedTexture->wasAborted()) {
+                textureBakeAborted(sharedTexture.data());
+            } else {
+                textureBakeFinished(sharedTexture.data());
+            }
+        });
+    }
+}
+
+bool ModelBaker::copySharedTextureFiles(TextureBaker* bakedTexture) {
+    QDir bakedOutputDir { _bakedOutputDir };
+    if (QFileInfo(bakedTexture->getMetaTextureFileName()).absoluteDir() == bakedOutputDir) {
+        // we baked it ourselves
+        return true;
+    }
+
+    for (const auto& filePath : bakedTexture->getOutputFiles()) {
+        auto copyFilePath = bakedOutputDir.absoluteFilePath(QFileInfo(filePath).fileName());
+        QFile::remove(copyFilePath);
+        if (!QFile::copy(filePath, copyFilePath)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 void ModelBaker::handleBakedTexture() {
-    TextureBaker* bakedTexture = qobject_cast<TextureBaker*>(sender());
-    qDebug() << "Handling baked texture" << bakedTexture->getTextureURL();
+    textureBakeFinished(qobject_cast<TextureBaker*>(sender()));
+}
 
+void ModelBaker::textureBakeFinished(TextureBaker* bakedTexture) {
     // make sure we haven't already run into errors, and that this is a valid texture
-    if (bakedTexture) {
+    // a shared texture can get here twice if it finished while we were connecting to it
+    if (bakedTexture && _bakingTextures.contains(bakedTexture->getTextureURL())) {
+        qDebug() << "Handling baked texture" << bakedTexture->getTextureURL();
+
         if (!shouldStop()) {
             if (!bakedTexture->hasErrors()) {
+                if (!copySharedTextureFiles(bakedTexture)) {
+                    handleError("Could not copy baked texture " + bakedTexture->getTextureURL().toString()
+                                + " for " + _modelURL.toString());
+                    return;
+                }
+
                 if (!_originalOutputDir.isEmpty()) {
                     // we've been asked to make copies of the originals, so we need to make copies of this if it is a linked texture
 
@@ -384,9 +502,7 @@ void ModelBaker::handleBakedTexture() {
                 _bakingTextures.remove(bakedTexture->getTextureURL());
 
                 // abort any other ongoing texture bakes since we know we'll end up failing
-                for (auto& bakingTexture : _bakingTextures) {
-                    bakingTexture->abort();
-                }
+                abortTextureBakes();
 
                 checkIfTexturesFinished();
             }
@@ -402,22 +518,24 @@ void ModelBaker::handleBakedTexture() {
 }
 
 void ModelBaker::handleAbortedTexture() {
+    textureBakeAborted(qobject_cast<TextureBaker*>(sender()));
+}
+
+void ModelBaker::textureBakeAborted(TextureBaker* bakedTexture) {
     // grab the texture bake that was aborted and remove it from our hash since we don't need to track it anymore
-    TextureBaker* bakedTexture = qobject_cast<TextureBaker*>(sender());
+    if (!bakedTexture || !_bakingTextures.contains(bakedTexture->getTextureURL())) {
+        return;
+    }
 
     qDebug() << "Texture aborted: " << bakedTexture->getTextureURL();
 
-    if (bakedTexture) {
-        _bakingTextures.remove(bakedTexture->getTextureURL());
-    }
+    _bakingTextures.remove(bakedTexture->getTextureURL());
 
     // since a texture we were baking aborted, our status is also aborted
     _shouldAbort.store(true);
 
     // abort any other ongoing texture bakes since we know we'll end up failing
-    for (auto& bakingTexture : _bakingTextures) {
-        bakingTexture->abort();
-    }
+    abortTextureBakes();
 
     checkIfTexturesFinished();
 }
@@ -496,20 +614,34 @@ QString ModelBaker::createBaseTextureFileName(const QFileInfo& textureFileInfo)
     // in case another texture referenced by this model has the same base name
     auto& nameMatches = _textureNameMatchCount[textureFileInfo.baseName()];
 
-    QString baseTextureFileName{ textureFileInfo.completeBaseName() };
+    QString baseTextureFileName;
+    do {
+        baseTextureFileName = textureFileInfo.completeBaseName();
 
-    if (nameMatches > 0) {
-        // there are already nameMatches texture with this name
-        // append - and that number to our baked texture file name so that it is unique
-        baseTextureFileName += "-" + QString::number(nameMatches);
-    }
+        if (nameMatches > 0) {
+            // there are already nameMatches texture with this name
+            // append - and that number to our baked texture file name so that it is unique
+            baseTextureFileName += "-" + QString::number(nameMatches);
+        }
+
+        // increment the number of name matches
+        ++nameMatches;
 
-    // increment the number of name matches
-    ++nameMatches;
+        // names taken from shared texture bakes aren't counted
+    } while (isTextureFileNameUsed(baseTextureFileName));
 
     return baseTextureFileName;
 }
 
+bool ModelBaker::isTextureFileNameUsed(const QString& baseTextureFileName) const {
+    for (const auto& remappedTexturePath : _remappedTexturePaths) {
+        if (remappedTexturePath == baseTextureFileName) {
+            return true;
+        }
+    }
+    return false;
+}
+
 void ModelBaker::setWasAborted(bool wasAborted) {
     if (wasAborted != _wasAborted.load()) {
         Baker::setWasAborted(wasAborted);
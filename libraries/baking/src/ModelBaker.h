@@ -18,6 +18,7 @@
 #include <QtNetwork/QNetworkReply>
 
 #include "Baker.h"
+#include "TextureBakeCache.h"
 #include "TextureBaker.h"
 
 #include "ModelBakingLoggingCategory.h"
@@ -31,6 +32,9 @@ using GetMaterialIDCallback = std::function <int(int)>;
 
 static const QString BAKED_FBX_EXTENSION = ".baked.fbx";
 
+// Bump when a change to the model or texture bakers changes what they output, so previous bakes aren't reused
+static const int MODEL_BAKE_VERSION = 3;
+
 class ModelBaker : public Baker {
     Q_OBJECT
 
@@ -46,6 +50,12 @@ public:
     QUrl getModelURL() const { return _modelURL; }
     QString getBakedModelFilePath() const { return _bakedModelFilePath; }
 
+    // Every texture the model references, embedded ones have URLs under the model's
+    QList<QUrl> getTextureURLs() const { return _remappedTexturePaths.keys(); }
+
+    // Shares the texture bakes with the other models using the same cache, set before baking
+    void setTextureBakeCache(const std::shared_ptr<TextureBakeCache>& textureBakeCache) { _textureBakeCache = textureBakeCache; }
+
 public slots:
     virtual void abort() override;
 
@@ -70,15 +80,22 @@ private slots:
 
 private:
     QString createBaseTextureFileName(const QFileInfo & textureFileInfo);
+    bool isTextureFileNameUsed(const QString& baseTextureFileName) const;
     QUrl getTextureURL(const QFileInfo& textureFileInfo, QString relativeFileName, bool isEmbedded = false);
     void bakeTexture(const QUrl & textureURL, image::TextureUsage::Type textureType, const QDir & outputDir, 
                      const QString & bakedFilename, const QByteArray & textureContent);
     QString texturePathRelativeToModel(QUrl modelURL, QUrl textureURL);
+    void waitForSharedTexture(const QSharedPointer<TextureBaker>& sharedTexture);
+    bool copySharedTextureFiles(TextureBaker* bakedTexture);
+    void textureBakeFinished(TextureBaker* bakedTexture);
+    void textureBakeAborted(TextureBaker* bakedTexture);
+    void abortTextureBakes();
     
     TextureBakerThreadGetter _textureThreadGetter;
     QMultiHash<QUrl, QSharedPointer<TextureBaker>> _bakingTextures;
     QHash<QString, int> _textureNameMatchCount;
     QHash<QUrl, QString> _remappedTexturePaths;
+    std::shared_ptr<TextureBakeCache> _textureBakeCache;
     bool _pendingErrorEmission{ false };
 };
 
@@ -0,0 +1,79 @@
+//
+//  TextureBakeCache.cpp
+//  libraries/baking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "TextureBakeCache.h"
+
+#include <QtCore/QJsonObject>
+
+QSharedPointer<TextureBaker> TextureBakeCache::findOrInsert(const QUrl& textureURL, image::TextureUsage::Type textureType,
+                                                            const QSharedPointer<TextureBaker>& bakingTexture) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto& entry = _entries[{ textureURL, (int)textureType }];
+    if (entry && !entry->baker->wasAborted()) {
+        // a model that had to give the texture another name bakes its own copy, without sharing this one
+        if (entry->baker->getBaseFilename() != bakingTexture->getBaseFilename()) {
+            return bakingTexture;
+        }
+        ++entry->users;
+        return entry->baker;
+    }
+
+    entry = std::make_shared<Entry>();
+    entry->baker = bakingTexture;
+    entry->textureType = textureType;
+    entry->timer.start();
+
+    // runs on the texture's thread, the entry outlives the baker's connections
+    std::weak_ptr<Entry> weakEntry = entry;
+    QObject::connect(bakingTexture.data(), &Baker::finished, [weakEntry] {
+        if (auto entry = weakEntry.lock()) {
+            entry->bakeMsecs.store(entry->timer.elapsed());
+        }
+    });
+
+    return bakingTexture;
+}
+
+QString TextureBakeCache::getBaseFilename(const QUrl& textureURL, image::TextureUsage::Type textureType) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto entry = _entries.value({ textureURL, (int)textureType });
+    if (!entry || entry->baker->wasAborted()) {
+        return QString();
+    }
+    return entry->baker->getBaseFilename();
+}
+
+bool TextureBakeCache::isShared(const TextureBaker* bakingTexture) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto entry = _entries.value({ bakingTexture->getTextureURL(), (int)bakingTexture->getTextureType() });
+    return entry && entry->baker.data() == bakingTexture && entry->users > 1;
+}
+
+QJsonArray TextureBakeCache::getReport() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    QJsonArray report;
+    for (auto it = _entries.begin(); it != _entries.end(); ++it) {
+        const auto& entry = it.value();
+        QJsonObject texture;
+        texture["url"] = it.key().first.toString();
+        texture["usage"] = (int)entry->textureType;
+        texture["models"] = entry->users;
+        texture["bakeMsecs"] = (double)entry->bakeMsecs.load();
+        if (entry->baker->isFinished()) {
+            texture["errors"] = QJsonArray::fromStringList(entry->baker->getErrors());
+        }
+        report.append(texture);
+    }
+    return report;
+}
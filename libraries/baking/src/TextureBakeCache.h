@@ -0,0 +1,60 @@
+//
+//  TextureBakeCache.h
+//  libraries/baking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_TextureBakeCache_h
+#define hifi_TextureBakeCache_h
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
+#include <QtCore/QJsonArray>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QUrl>
+
+#include "TextureBaker.h"
+
+// Texture bakes shared by the ModelBakers of one larger bake, so a texture referenced by several models is only
+// baked once.  The first model to ask for a texture starts the bake into its own folder, the others wait on the
+// same TextureBaker and copy its files when it's done.  The model bakers live on different threads.
+class TextureBakeCache {
+public:
+    // The bake already started for this texture and usage, or bakingTexture if there's none yet, in which case the
+    // caller has to start it.  Aborted bakes are replaced.  A bake under another base file name isn't shared, the
+    // caller gets bakingTexture back to start on its own and the cached one isn't replaced.
+    QSharedPointer<TextureBaker> findOrInsert(const QUrl& textureURL, image::TextureUsage::Type textureType,
+                                              const QSharedPointer<TextureBaker>& bakingTexture);
+
+    // The base file name the bake of this texture writes to, empty if there's no bake of it
+    QString getBaseFilename(const QUrl& textureURL, image::TextureUsage::Type textureType) const;
+
+    // Whether more than one model waits on this bake, in which case a model giving up shouldn't abort it
+    bool isShared(const TextureBaker* bakingTexture) const;
+
+    // One object per texture: url, usage, models, bakeMsecs (-1 when unfinished), errors
+    QJsonArray getReport() const;
+
+private:
+    struct Entry {
+        QSharedPointer<TextureBaker> baker;
+        image::TextureUsage::Type textureType;
+        int users { 1 };
+        QElapsedTimer timer;
+        std::atomic<qint64> bakeMsecs { -1 };
+    };
+    using Key = QPair<QUrl, int>;
+
+    mutable std::mutex _mutex;
+    QHash<Key, std::shared_ptr<Entry>> _entries;
+};
+
+#endif // hifi_TextureBakeCache_h
@@ -36,6 +36,8 @@ public:
     const QByteArray& getOriginalTexture() const { return _originalTexture; }
 
     QUrl getTextureURL() const { return _textureURL; }
+    image::TextureUsage::Type getTextureType() const { return _textureType; }
+    QString getBaseFilename() const { return _baseFilename; }
 
     QString getMetaTextureFileName() const { return _metaTextureFileName; }
 
@@ -207,6 +207,7 @@ void EntityTreeRenderer::clear() {
     }
     _entitiesInScene.clear();
     _renderablesToUpdate.clear();
+    _deferredEntityScripts.clear();
 
     // reset the zone to the default (while we load the next scene)
     _layeredZones.clear();
@@ -220,12 +221,81 @@ void EntityTreeRenderer::reloadEntityScripts() {
     for (const auto& entry : _entitiesInScene) {
         const auto& renderer = entry.second;
         const auto& entity = renderer->getEntity();
-        if (!entity->getScript().isEmpty()) {
+        if (entity->getScript().isEmpty()) {
+            continue;
+        }
+        auto deferred = _deferredEntityScripts.find(entity->getEntityItemID());
+        if (deferred != _deferredEntityScripts.end()) {
+            // still out of range, it will be loaded fresh when the avatar gets close
+            deferred->second = true;
+        } else {
             _entitiesScriptEngine->loadEntityScript(entity->getEntityItemID(), entity->getScript(), true);
         }
     }
 }
 
+void EntityTreeRenderer::setEntityScriptLoadDistance(float distance) {
+    _entityScriptLoadDistance.set(std::max(distance, 0.0f));
+    // check the deferred scripts against the new distance on the next update
+    _lastDeferredScriptCheck = 0;
+}
+
+bool EntityTreeRenderer::isBeyondEntityScriptLoadDistance(const EntityItemPointer& entity) const {
+    float loadDistance = getEntityScriptLoadDistance();
+    if (loadDistance <= 0.0f) {
+        return false;
+    }
+    bool success;
+    AABox entityBox = entity->getAABox(success);
+    if (!success) {
+        return false;
+    }
+    glm::vec3 avatarPosition = _viewState->getAvatarPosition();
+    glm::vec3 delta = glm::max(glm::max(entityBox.getMinimumPoint() - avatarPosition, glm::vec3(0.0f)),
+                               avatarPosition - entityBox.getMaximumPoint());
+    return glm::length(delta) > loadDistance;
+}
+
+void EntityTreeRenderer::loadDeferredEntityScripts() {
+    if (_deferredEntityScripts.empty()) {
+        return;
+    }
+    auto now = usecTimestampNow();
+    glm::vec3 avatarPosition = _viewState->getAvatarPosition();
+    bool movedEnough = glm::distance(avatarPosition, _lastDeferredScriptCheckPosition) > DEFERRED_SCRIPT_CHECK_DISTANCE;
+    bool enoughTimeElapsed = (now - _lastDeferredScriptCheck) > DEFERRED_SCRIPT_CHECK_INTERVAL;
+    if (!movedEnough && !enoughTimeElapsed) {
+        return;
+    }
+    _lastDeferredScriptCheckPosition = avatarPosition;
+    _lastDeferredScriptCheck = now;
+
+    std::vector<std::pair<EntityItemID, bool>> scriptsToLoad;
+    float loadDistance = getEntityScriptLoadDistance();
+    if (loadDistance <= 0.0f) {
+        scriptsToLoad.assign(_deferredEntityScripts.begin(), _deferredEntityScripts.end());
+    } else {
+        // only the entities around the avatar need to be looked at, however many are waiting
+        QVector<EntityItemPointer> nearbyEntities;
+        auto tree = getTree();
+        AABox searchBox(avatarPosition - glm::vec3(loadDistance), glm::vec3(2.0f * loadDistance));
+        tree->withReadLock([&] {
+            tree->findEntities(searchBox, nearbyEntities);
+        });
+        foreach (const EntityItemPointer& entity, nearbyEntities) {
+            auto deferred = _deferredEntityScripts.find(entity->getEntityItemID());
+            if (deferred != _deferredEntityScripts.end() && !isBeyondEntityScriptLoadDistance(entity)) {
+                scriptsToLoad.push_back(*deferred);
+            }
+        }
+    }
+
+    for (const auto& script : scriptsToLoad) {
+        _deferredEntityScripts.erase(script.first);
+        checkAndCallPreload(script.first, script.second);
+    }
+}
+
 void EntityTreeRenderer::init() {
     OctreeProcessor::init();
     EntityTreePointer entityTree = std::static_pointer_cast<EntityTree>(_tree);
@@ -427,6 +497,8 @@ void EntityTreeRenderer::update(bool simulate) {
             // Handle enter/leave entity logic
             checkEnterLeaveEntities();
 
+            loadDeferredEntityScripts();
+
             // Even if we're not moving the mouse, if we started clicking on an entity and we have
             // not yet released the hold then this is still considered a holdingClickOnEntity event
             // and we want to simulate this message here as well as in mouse move
@@ -850,6 +922,7 @@ void EntityTreeRenderer::mouseMoveEvent(QMouseEvent* event) {
 }
 
 void EntityTreeRenderer::deletingEntity(const EntityItemID& entityID) {
+    _deferredEntityScripts.erase(entityID);
     // If it's in a pending queue, remove it
     _renderablesToUpdate.erase(entityID);
     _entitiesToAdd.erase(entityID);
@@ -912,6 +985,13 @@ void EntityTreeRenderer::checkAndCallPreload(const EntityItemID& entityID, bool
             _entitiesScriptEngine->unloadEntityScript(entityID);
             }
             entity->scriptHasUnloaded();
+            _deferredEntityScripts.erase(entityID);
+        }
+        if (shouldLoad && isBeyondEntityScriptLoadDistance(entity)) {
+            // loadDeferredEntityScripts() comes back to it once the avatar is close enough
+            bool& deferredReload = _deferredEntityScripts[entityID];
+            deferredReload = deferredReload || reload;
+            return;
         }
         if (shouldLoad) {
             scriptUrl = DependencyManager::get<ResourceManager>()->normalizeURL(scriptUrl);
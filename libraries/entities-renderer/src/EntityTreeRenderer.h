@@ -21,6 +21,7 @@
 #include <EntityTree.h>
 #include <PointerEvent.h>
 #include <ScriptCache.h>
+#include <SettingHandle.h>
 #include <TextureCache.h>
 #include <OctreeProcessor.h>
 #include <render/Forward.h>
@@ -93,6 +94,11 @@ public:
     /// reloads the entity scripts, calling unload and preload
     void reloadEntityScripts();
 
+    /// entity scripts of entities farther than this from the avatar (in meters) wait until the avatar comes closer,
+    /// zero loads every entity script as soon as its entity arrives
+    float getEntityScriptLoadDistance() const { return _entityScriptLoadDistance.get(); }
+    void setEntityScriptLoadDistance(float distance);
+
     // event handles which may generate entity related events
     void mouseReleaseEvent(QMouseEvent* event);
     void mousePressEvent(QMouseEvent* event);
@@ -159,6 +165,8 @@ private:
     bool applyLayeredZones();
 
     void checkAndCallPreload(const EntityItemID& entityID, bool reload = false, bool unloadFirst = false);
+    bool isBeyondEntityScriptLoadDistance(const EntityItemPointer& entity) const;
+    void loadDeferredEntityScripts();
 
     EntityItemID _currentHoverOverEntityID;
     EntityItemID _currentClickingOnEntityID;
@@ -247,6 +255,14 @@ private:
     const uint64_t ZONE_CHECK_INTERVAL = USECS_PER_MSEC * 100; // ~10hz
     const float ZONE_CHECK_DISTANCE = 0.001f;
 
+    // entity scripts waiting for the avatar to come within the load distance, and whether they were asked to reload
+    Setting::Handle<float> _entityScriptLoadDistance { "entityScriptLoadDistance", 0.0f };
+    std::unordered_map<EntityItemID, bool> _deferredEntityScripts;
+    glm::vec3 _lastDeferredScriptCheckPosition { 0.0f };
+    uint64_t _lastDeferredScriptCheck { 0 };
+    const uint64_t DEFERRED_SCRIPT_CHECK_INTERVAL = USECS_PER_SECOND;
+    const float DEFERRED_SCRIPT_CHECK_DISTANCE = 1.0f;
+
     ReadWriteLockable _changedEntitiesGuard;
     std::unordered_set<EntityItemID> _changedEntities;
 
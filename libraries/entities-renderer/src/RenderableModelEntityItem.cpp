@@ -1097,8 +1097,7 @@ void ModelEntityRenderer::animate(const TypedEntityPointer& entity) {
 
     QVector<EntityJointData> jointsData;
 
-    const QVector<FBXAnimationFrame>&  frames = _animation->getFramesReference(); // NOTE: getFrames() is too heavy
-    int frameCount = frames.size();
+    int frameCount = _animation->getNumFrames();
     if (frameCount <= 0) {
         return;
     }
@@ -1129,8 +1128,12 @@ void ModelEntityRenderer::animate(const TypedEntityPointer& entity) {
 
     bool allowTranslation = entity->getAnimationAllowTranslation();
 
-    const QVector<glm::quat>& rotations = frames[_lastKnownCurrentFrame].rotations;
-    const QVector<glm::vec3>& translations = frames[_lastKnownCurrentFrame].translations;
+    FBXAnimationFrame frame;
+    if (!_animation->getFrame(_lastKnownCurrentFrame, frame)) {
+        return;
+    }
+    const QVector<glm::quat>& rotations = frame.rotations;
+    const QVector<glm::vec3>& translations = frame.translations;
                 
     jointsData.resize(_jointMapping.size());
     for (int j = 0; j < _jointMapping.size(); j++) {
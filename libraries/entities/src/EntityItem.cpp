@@ -2513,6 +2513,11 @@ void EntityItem::requiresRecalcBoxes() {
         _recalcMinAACube = true;
         _recalcMaxAACube = true;
     });
+    // the element keeps a packed copy of our AABox for spatial queries
+    EntityTreeElementPointer element = _element;
+    if (element) {
+        element->markPackedBoundsDirty();
+    }
 }
 
 QString EntityItem::getHref() const {
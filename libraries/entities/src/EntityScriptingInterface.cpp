@@ -19,6 +19,7 @@
 
 #include <shared/QtHelpers.h>
 #include <VariantMapToScriptValue.h>
+#include <NumericalConstants.h>
 #include <SharedUtil.h>
 #include <SpatialParentFinder.h>
 #include <AvatarHashMap.h>
@@ -536,6 +537,211 @@ QUuid EntityScriptingInterface::editEntity(QUuid id, const EntityItemProperties&
     return id;
 }
 
+// a property that can go through the property buffers, values are in script semantics (world frame)
+struct BufferProperty {
+    const char* name;
+    int numValues;
+    void (*read)(const EntityItem& entity, float* values);
+    void (*write)(const float* values, EntityItemProperties& properties); // nullptr for read only properties
+};
+
+static void readVec3(const glm::vec3& v, float* values) {
+    values[0] = v.x;
+    values[1] = v.y;
+    values[2] = v.z;
+}
+
+static void readQuat(const glm::quat& q, float* values) {
+    values[0] = q.x;
+    values[1] = q.y;
+    values[2] = q.z;
+    values[3] = q.w;
+}
+
+static glm::vec3 writeVec3(const float* values) {
+    return glm::vec3(values[0], values[1], values[2]);
+}
+
+// a quaternion too short to normalize leaves the property unchanged, like a NaN
+static bool writeQuat(const float* values, glm::quat& q) {
+    glm::quat value(values[3], values[0], values[1], values[2]);
+    float lengthSquared = glm::dot(value, value);
+    if (lengthSquared < EPSILON) {
+        return false;
+    }
+    q = value / sqrtf(lengthSquared);
+    return true;
+}
+
+static const BufferProperty BUFFER_PROPERTIES[] = {
+    { "position", 3,
+        [](const EntityItem& e, float* v) { readVec3(e.getWorldPosition(), v); },
+        [](const float* v, EntityItemProperties& p) { p.setPosition(writeVec3(v)); } },
+    { "rotation", 4,
+        [](const EntityItem& e, float* v) { readQuat(e.getWorldOrientation(), v); },
+        [](const float* v, EntityItemProperties& p) { glm::quat q; if (writeQuat(v, q)) { p.setRotation(q); } } },
+    { "dimensions", 3,
+        [](const EntityItem& e, float* v) { readVec3(e.getScaledDimensions(), v); },
+        [](const float* v, EntityItemProperties& p) { p.setDimensions(writeVec3(v)); } },
+    { "velocity", 3,
+        [](const EntityItem& e, float* v) { readVec3(e.getWorldVelocity(), v); },
+        [](const float* v, EntityItemProperties& p) { p.setVelocity(writeVec3(v)); } },
+    { "angularVelocity", 3,
+        [](const EntityItem& e, float* v) { readVec3(e.getWorldAngularVelocity(), v); },
+        [](const float* v, EntityItemProperties& p) { p.setAngularVelocity(writeVec3(v)); } },
+    { "localPosition", 3,
+        [](const EntityItem& e, float* v) { readVec3(e.getLocalPosition(), v); },
+        [](const float* v, EntityItemProperties& p) { p.setLocalPosition(writeVec3(v)); } },
+    { "localRotation", 4,
+        [](const EntityItem& e, float* v) { readQuat(e.getLocalOrientation(), v); },
+        [](const float* v, EntityItemProperties& p) { glm::quat q; if (writeQuat(v, q)) { p.setLocalRotation(q); } } },
+    { "localVelocity", 3,
+        [](const EntityItem& e, float* v) { readVec3(e.getLocalVelocity(), v); },
+        [](const float* v, EntityItemProperties& p) { p.setLocalVelocity(writeVec3(v)); } },
+    { "localAngularVelocity", 3,
+        [](const EntityItem& e, float* v) { readVec3(e.getLocalAngularVelocity(), v); },
+        [](const float* v, EntityItemProperties& p) { p.setLocalAngularVelocity(writeVec3(v)); } },
+    { "gravity", 3,
+        [](const EntityItem& e, float* v) { readVec3(e.getGravity(), v); },
+        [](const float* v, EntityItemProperties& p) { p.setGravity(writeVec3(v)); } },
+    { "acceleration", 3,
+        [](const EntityItem& e, float* v) { readVec3(e.getAcceleration(), v); },
+        [](const float* v, EntityItemProperties& p) { p.setAcceleration(writeVec3(v)); } },
+    { "damping", 1,
+        [](const EntityItem& e, float* v) { v[0] = e.getDamping(); },
+        [](const float* v, EntityItemProperties& p) { p.setDamping(v[0]); } },
+    { "angularDamping", 1,
+        [](const EntityItem& e, float* v) { v[0] = e.getAngularDamping(); },
+        [](const float* v, EntityItemProperties& p) { p.setAngularDamping(v[0]); } },
+    { "restitution", 1,
+        [](const EntityItem& e, float* v) { v[0] = e.getRestitution(); },
+        [](const float* v, EntityItemProperties& p) { p.setRestitution(v[0]); } },
+    { "friction", 1,
+        [](const EntityItem& e, float* v) { v[0] = e.getFriction(); },
+        [](const float* v, EntityItemProperties& p) { p.setFriction(v[0]); } },
+    { "density", 1,
+        [](const EntityItem& e, float* v) { v[0] = e.getDensity(); },
+        [](const float* v, EntityItemProperties& p) { p.setDensity(v[0]); } },
+    { "lifetime", 1,
+        [](const EntityItem& e, float* v) { v[0] = e.getLifetime(); },
+        [](const float* v, EntityItemProperties& p) { p.setLifetime(v[0]); } },
+    { "age", 1,
+        [](const EntityItem& e, float* v) { v[0] = e.getAge(); },
+        nullptr },
+    { "visible", 1,
+        [](const EntityItem& e, float* v) { v[0] = e.getVisible() ? 1.0f : 0.0f; },
+        [](const float* v, EntityItemProperties& p) { p.setVisible(v[0] != 0.0f); } },
+    { "collisionless", 1,
+        [](const EntityItem& e, float* v) { v[0] = e.getCollisionless() ? 1.0f : 0.0f; },
+        [](const float* v, EntityItemProperties& p) { p.setCollisionless(v[0] != 0.0f); } },
+    { "dynamic", 1,
+        [](const EntityItem& e, float* v) { v[0] = e.getDynamic() ? 1.0f : 0.0f; },
+        [](const float* v, EntityItemProperties& p) { p.setDynamic(v[0] != 0.0f); } }
+};
+
+// looks up the properties of a buffer, returns the number of values per entity or -1 if a property isn't supported.
+static int getBufferLayout(const QStringList& names, std::vector<const BufferProperty*>& layout) {
+    int stride = 0;
+    layout.clear();
+    layout.reserve(names.size());
+    for (auto& name : names) {
+        auto property = std::find_if(std::begin(BUFFER_PROPERTIES), std::end(BUFFER_PROPERTIES), [&](const BufferProperty& p) {
+            return name == p.name;
+        });
+        if (property == std::end(BUFFER_PROPERTIES)) {
+            qCWarning(entities) << "Entities property buffer, unsupported property" << name;
+            return -1;
+        }
+        layout.push_back(property);
+        stride += property->numValues;
+    }
+    return stride;
+}
+
+int EntityScriptingInterface::getEntityPropertiesBufferStride(const QStringList& properties) const {
+    std::vector<const BufferProperty*> layout;
+    return getBufferLayout(properties, layout);
+}
+
+QByteArray EntityScriptingInterface::getEntityPropertiesBuffer(const QVector<QUuid>& entityIDs, const QStringList& properties) {
+    PROFILE_RANGE(script_entities, __FUNCTION__);
+
+    std::vector<const BufferProperty*> layout;
+    int stride = getBufferLayout(properties, layout);
+    if (stride < 0) {
+        return QByteArray();
+    }
+
+    const int numValues = entityIDs.size() * stride;
+    QByteArray buffer(numValues * (int)sizeof(float), Qt::Uninitialized);
+    float* values = reinterpret_cast<float*>(buffer.data());
+    std::fill(values, values + numValues, std::numeric_limits<float>::quiet_NaN());
+
+    if (_entityTree) {
+        _entityTree->withReadLock([&] {
+            for (int i = 0; i < entityIDs.size(); i++) {
+                EntityItemPointer entity = _entityTree->findEntityByEntityItemID(EntityItemID(entityIDs[i]));
+                if (!entity) {
+                    continue;
+                }
+                float* entityValues = values + i * stride;
+                for (auto property : layout) {
+                    property->read(*entity, entityValues);
+                    entityValues += property->numValues;
+                }
+            }
+        });
+    }
+    return buffer;
+}
+
+int EntityScriptingInterface::editEntitiesFromBuffer(const QVector<QUuid>& entityIDs, const QStringList& properties,
+                                                      const QByteArray& buffer) {
+    PROFILE_RANGE(script_entities, __FUNCTION__);
+
+    std::vector<const BufferProperty*> layout;
+    int stride = getBufferLayout(properties, layout);
+    if (stride < 0) {
+        return 0;
+    }
+    for (auto property : layout) {
+        if (!property->write) {
+            qCWarning(entities) << "Entities.editEntitiesFromBuffer, property" << property->name << "is read only";
+            return 0;
+        }
+    }
+    if (buffer.size() < entityIDs.size() * stride * (int)sizeof(float)) {
+        qCWarning(entities) << "Entities.editEntitiesFromBuffer, buffer of" << buffer.size() << "bytes is too small for"
+            << entityIDs.size() << "entities";
+        return 0;
+    }
+
+    // the buffer may come from a typed array with any alignment
+    std::vector<float> entityValues(stride);
+    int numEdited = 0;
+    for (int i = 0; i < entityIDs.size(); i++) {
+        memcpy(entityValues.data(), buffer.constData() + i * stride * sizeof(float), stride * sizeof(float));
+
+        EntityItemProperties entityProperties;
+        const float* propertyValues = entityValues.data();
+        for (auto property : layout) {
+            bool hasNaN = std::any_of(propertyValues, propertyValues + property->numValues, [](float v) { return glm::isnan(v); });
+            if (!hasNaN) {
+                property->write(propertyValues, entityProperties);
+            }
+            propertyValues += property->numValues;
+        }
+
+        if (entityProperties.getChangedProperties().isEmpty()) {
+            continue;
+        }
+        if (!editEntity(entityIDs[i], entityProperties).isNull()) {
+            ++numEdited;
+        }
+    }
+    return numEdited;
+}
+
 void EntityScriptingInterface::deleteEntity(QUuid id) {
     PROFILE_RANGE(script_entities, __FUNCTION__);
 
@@ -748,49 +954,53 @@ QVector<QUuid> EntityScriptingInterface::findEntitiesInFrustum(QVariantMap frust
 }
 
 QVector<QUuid> EntityScriptingInterface::findEntitiesByType(const QString entityType, const glm::vec3& center, float radius) const {
+    PROFILE_RANGE(script_entities, __FUNCTION__);
+
     EntityTypes::EntityType type = EntityTypes::getEntityTypeFromName(entityType);
 
     QVector<QUuid> result;
     if (_entityTree) {
         QVector<EntityItemPointer> entities;
         _entityTree->withReadLock([&] {
-            _entityTree->findEntities(center, radius, entities);
+            _entityTree->findEntitiesByType(type, center, radius, entities);
         });
 
         foreach(EntityItemPointer entity, entities) {
-            if (entity->getType() == type) {
-                result << entity->getEntityItemID().toString();
-            }
+            result << entity->getEntityItemID();
         }
     }
     return result;
 }
 
 QVector<QUuid> EntityScriptingInterface::findEntitiesByName(const QString entityName, const glm::vec3& center, float radius, bool caseSensitiveSearch) const {
-    
+    PROFILE_RANGE(script_entities, __FUNCTION__);
+
     QVector<QUuid> result;
     if (_entityTree) {
         QVector<EntityItemPointer> entities;
         _entityTree->withReadLock([&] {
-            _entityTree->findEntities(center, radius, entities);
+            _entityTree->findEntitiesByName(entityName, center, radius, caseSensitiveSearch, entities);
         });
 
-        if (caseSensitiveSearch) {
-            foreach(EntityItemPointer entity, entities) {
-                if (entity->getName() == entityName) {
-                    result << entity->getEntityItemID();
-                }
-            }
+        foreach(EntityItemPointer entity, entities) {
+            result << entity->getEntityItemID();
+        }
+    }
+    return result;
+}
 
-        } else {
-            QString entityNameLowerCase = entityName.toLower();
+QVector<QUuid> EntityScriptingInterface::findNearestEntities(const glm::vec3& center, int count, float radius) const {
+    PROFILE_RANGE(script_entities, __FUNCTION__);
 
-            foreach(EntityItemPointer entity, entities) {
-                QString entityItemLowerCase = entity->getName().toLower();
-                if (entityItemLowerCase == entityNameLowerCase) {
-                    result << entity->getEntityItemID();
-                }
-            }
+    QVector<QUuid> result;
+    if (_entityTree) {
+        QVector<EntityItemPointer> entities;
+        _entityTree->withReadLock([&] {
+            _entityTree->findNearestEntities(center, count, radius, entities);
+        });
+
+        foreach(EntityItemPointer entity, entities) {
+            result << entity->getEntityItemID();
         }
     }
     return result;
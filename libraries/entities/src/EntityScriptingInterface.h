@@ -268,6 +268,60 @@ public slots:
      */
     Q_INVOKABLE QUuid editEntity(QUuid entityID, const EntityItemProperties& properties);
 
+    /**jsdoc
+     * Get the number of values per entity in the buffers used by {@link Entities.getEntityPropertiesBuffer} and
+     * {@link Entities.editEntitiesFromBuffer} for a list of properties. Vec3 properties take 3 values, Quat properties 4 and
+     * every other property 1.
+     * <p>Supported properties: <code>position</code>, <code>rotation</code>, <code>dimensions</code>, <code>velocity</code>,
+     * <code>angularVelocity</code>, <code>localPosition</code>, <code>localRotation</code>, <code>localVelocity</code>,
+     * <code>localAngularVelocity</code>, <code>gravity</code>, <code>acceleration</code>, <code>damping</code>,
+     * <code>angularDamping</code>, <code>restitution</code>, <code>friction</code>, <code>density</code>,
+     * <code>lifetime</code>, <code>age</code> (read only), <code>visible</code>, <code>collisionless</code> and
+     * <code>dynamic</code>. Booleans are stored as <code>0</code> or <code>1</code>.</p>
+     * @function Entities.getEntityPropertiesBufferStride
+     * @param {string[]} properties - The names of the properties.
+     * @returns {number} The number of values per entity, or <code>-1</code> if a property isn't supported.
+     */
+    Q_INVOKABLE int getEntityPropertiesBufferStride(const QStringList& properties) const;
+
+    /**jsdoc
+     * Get some properties of many entities at once, packed into an ArrayBuffer of 32-bit floats. This is much faster than
+     * calling {@link Entities.getEntityProperties} for each entity.
+     * @function Entities.getEntityPropertiesBuffer
+     * @param {Uuid[]} entityIDs - The IDs of the entities to get the properties of.
+     * @param {string[]} properties - The names of the properties to get, see
+     *     {@link Entities.getEntityPropertiesBufferStride} for the supported properties.
+     * @returns {ArrayBuffer} The values of the properties, entity by entity and in the order of <code>properties</code>.
+     *     The values of entities that can't be found are <code>NaN</code>. The buffer is empty if a property isn't
+     *     supported.
+     * @example <caption>Report the positions of the entities around you.</caption>
+     * var entityIDs = Entities.findEntities(MyAvatar.position, 10);
+     * var positions = new Float32Array(Entities.getEntityPropertiesBuffer(entityIDs, ["position"]));
+     * for (var i = 0; i < entityIDs.length; i++) {
+     *     print(entityIDs[i] + ": " + positions[3 * i] + ", " + positions[3 * i + 1] + ", " + positions[3 * i + 2]);
+     * }
+     */
+    Q_INVOKABLE QByteArray getEntityPropertiesBuffer(const QVector<QUuid>& entityIDs, const QStringList& properties);
+
+    /**jsdoc
+     * Edit some properties of many entities at once, from an ArrayBuffer of 32-bit floats laid out as by
+     * {@link Entities.getEntityPropertiesBuffer}. A property whose values include a <code>NaN</code>, or a rotation with a
+     * length of zero, is left unchanged for that entity.
+     * @function Entities.editEntitiesFromBuffer
+     * @param {Uuid[]} entityIDs - The IDs of the entities to edit.
+     * @param {string[]} properties - The names of the properties to edit.
+     * @param {ArrayBuffer} buffer - The new values of the properties.
+     * @returns {number} The number of entities that were edited.
+     * @example <caption>Raise the entities around you by 1m.</caption>
+     * var entityIDs = Entities.findEntities(MyAvatar.position, 10);
+     * var positions = new Float32Array(Entities.getEntityPropertiesBuffer(entityIDs, ["position"]));
+     * for (var i = 0; i < entityIDs.length; i++) {
+     *     positions[3 * i + 1] += 1;
+     * }
+     * Entities.editEntitiesFromBuffer(entityIDs, ["position"], positions.buffer);
+     */
+    Q_INVOKABLE int editEntitiesFromBuffer(const QVector<QUuid>& entityIDs, const QStringList& properties, const QByteArray& buffer);
+
     /**jsdoc
      * Delete an entity.
      * @function Entities.deleteEntity
@@ -409,6 +463,22 @@ public slots:
     Q_INVOKABLE QVector<QUuid> findEntitiesByName(const QString entityName, const glm::vec3& center, float radius, 
         bool caseSensitiveSearch = false ) const;
 
+    /**jsdoc
+     * Find the entities nearest to a point, nearest first. Distances are measured to the entities' axis-aligned boxes, so an
+     * entity whose box contains the point is at distance <code>0</code>.
+     * @function Entities.findNearestEntities
+     * @param {Vec3} center - The point about which to search.
+     * @param {number} count - The maximum number of entities to find.
+     * @param {number} radius - The radius within which to search.
+     * @returns {Uuid[]} An array of up to <code>count</code> entity IDs sorted by increasing distance from <code>center</code>.
+     *     The array is empty if no entities could be found.
+     * @example <caption>Report the three entities nearest to your avatar within 10m.</caption>
+     * var entityIDs = Entities.findNearestEntities(MyAvatar.position, 3, 10);
+     * print("Nearest entities: " + JSON.stringify(entityIDs));
+     */
+    /// this function will not find any entities in script engine contexts which don't have access to entities
+    Q_INVOKABLE QVector<QUuid> findNearestEntities(const glm::vec3& center, int count, float radius) const;
+
     /**jsdoc
      * Find the first entity intersected by a {@link PickRay}. <code>Light</code> and <code>Zone</code> entities are not 
      * intersected unless they've been configured as pickable using {@link Entities.setLightsArePickable|setLightsArePickable}
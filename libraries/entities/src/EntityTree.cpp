@@ -10,6 +10,10 @@
 //
 
 #include "EntityTree.h"
+
+#include <algorithm>
+#include <queue>
+
 #include <QtCore/QDateTime>
 #include <QtCore/QQueue>
 #include <openssl/err.h>
@@ -24,6 +28,7 @@
 #include <QtScript/QScriptEngine>
 
 #include <Extents.h>
+#include <GLMHelpers.h>
 #include <PerfStat.h>
 #include <Profile.h>
 
@@ -99,6 +104,7 @@ void EntityTree::eraseAllOctreeElements(bool createNewRoot) {
     }
     QHash<EntityItemID, EntityItemPointer> localMap;
     localMap.swap(_entityMap);
+    _entityTypeMap.clear();
     this->withWriteLock([&] {
         foreach(EntityItemPointer entity, localMap) {
             EntityTreeElementPointer element = entity->getElement();
@@ -804,6 +810,7 @@ public:
     glm::vec3 position;
     float targetRadius;
     QVector<EntityItemPointer> entities;
+    EntityItemFilter filter;
 };
 
 
@@ -815,7 +822,7 @@ bool EntityTree::findInSphereOperation(const OctreeElementPointer& element, void
     // If this element contains the point, then search it...
     if (sphereIntersection) {
         EntityTreeElementPointer entityTreeElement = std::static_pointer_cast<EntityTreeElement>(element);
-        entityTreeElement->getEntities(args->position, args->targetRadius, args->entities);
+        entityTreeElement->getEntities(args->position, args->targetRadius, args->entities, args->filter);
         return true; // keep searching in case children have closer entities
     }
 
@@ -824,8 +831,9 @@ bool EntityTree::findInSphereOperation(const OctreeElementPointer& element, void
 }
 
 // NOTE: assumes caller has handled locking
-void EntityTree::findEntities(const glm::vec3& center, float radius, QVector<EntityItemPointer>& foundEntities) {
-    FindAllNearPointArgs args = { center, radius, QVector<EntityItemPointer>() };
+void EntityTree::findEntities(const glm::vec3& center, float radius, QVector<EntityItemPointer>& foundEntities,
+                              const EntityItemFilter& filter) {
+    FindAllNearPointArgs args = { center, radius, QVector<EntityItemPointer>(), filter };
     // NOTE: This should use recursion, since this is a spatial operation
     recurseTreeWithOperation(findInSphereOperation, &args);
 
@@ -833,6 +841,128 @@ void EntityTree::findEntities(const glm::vec3& center, float radius, QVector<Ent
     foundEntities.swap(args.entities);
 }
 
+// types with at most this many entities are searched through the type index instead of the octree
+static const int MAX_TYPE_INDEX_SEARCH_SIZE = 256;
+
+// NOTE: assumes caller has handled locking
+void EntityTree::findEntitiesByType(EntityTypes::EntityType type, const glm::vec3& center, float radius,
+                                    QVector<EntityItemPointer>& foundEntities) {
+    QVector<EntityItemPointer> typeEntities;
+    bool useIndex = false;
+    {
+        QReadLocker locker(&_entityMapLock);
+        auto typeItr = _entityTypeMap.constFind(type);
+        if (typeItr == _entityTypeMap.constEnd()) {
+            foundEntities.clear();
+            return;
+        }
+        if (typeItr->size() <= MAX_TYPE_INDEX_SEARCH_SIZE) {
+            useIndex = true;
+            typeEntities.reserve(typeItr->size());
+            foreach (const EntityItemPointer& entity, *typeItr) {
+                typeEntities.push_back(entity);
+            }
+        }
+    }
+
+    if (useIndex) {
+        QVector<EntityItemPointer> result;
+        foreach (const EntityItemPointer& entity, typeEntities) {
+            bool success;
+            AABox entityBox = entity->getAABox(success);
+            if ((!success || entityBox.touchesSphere(center, radius)) &&
+                EntityTreeElement::entityTouchesSphere(entity, center, radius)) {
+                result.push_back(entity);
+            }
+        }
+        foundEntities.swap(result);
+    } else {
+        findEntities(center, radius, foundEntities, [type](EntityItemPointer& entity) {
+            return entity->getType() == type;
+        });
+    }
+}
+
+// NOTE: assumes caller has handled locking
+void EntityTree::findEntitiesByName(const QString& name, const glm::vec3& center, float radius, bool caseSensitive,
+                                    QVector<EntityItemPointer>& foundEntities) {
+    // names are edited through too many paths to index, but testing them during the search
+    // skips the exact shape test for every entity with a different name
+    Qt::CaseSensitivity sensitivity = caseSensitive ? Qt::CaseSensitive : Qt::CaseInsensitive;
+    findEntities(center, radius, foundEntities, [&](EntityItemPointer& entity) {
+        return entity->getName().compare(name, sensitivity) == 0;
+    });
+}
+
+static float distanceToBox(const glm::vec3& point, const glm::vec3& minCorner, const glm::vec3& maxCorner) {
+    return glm::length(glm::max(glm::max(minCorner - point, Vectors::ZERO), point - maxCorner));
+}
+
+// NOTE: assumes caller has handled locking
+void EntityTree::findNearestEntities(const glm::vec3& center, int count, float maxRadius,
+                                     QVector<EntityItemPointer>& foundEntities) {
+    foundEntities.clear();
+    EntityTreeElementPointer root = getRoot();
+    if (!root || count <= 0) {
+        return;
+    }
+
+    // elements are visited in order of their distance from center and the best entities so far are kept in a max heap,
+    // so once count entities have been found the search radius shrinks to the farthest of them
+    using ElementDistance = std::pair<float, EntityTreeElementPointer>;
+    using EntityDistance = std::pair<float, EntityItemPointer>;
+    auto fartherElement = [](const ElementDistance& a, const ElementDistance& b) { return a.first > b.first; };
+    auto closerEntity = [](const EntityDistance& a, const EntityDistance& b) { return a.first < b.first; };
+
+    std::priority_queue<ElementDistance, std::vector<ElementDistance>, decltype(fartherElement)> elements(fartherElement);
+    std::vector<EntityDistance> nearest;
+    std::vector<EntityDistance> candidates;
+    float searchRadius = maxRadius;
+
+    const AACube& rootCube = root->getAACube();
+    elements.push({ distanceToBox(center, rootCube.getMinimumPoint(), rootCube.getMaximumPoint()), root });
+    while (!elements.empty()) {
+        ElementDistance next = elements.top();
+        elements.pop();
+        if (next.first > searchRadius) {
+            break;
+        }
+
+        candidates.clear();
+        next.second->getEntityDistances(center, searchRadius, candidates);
+        for (const auto& candidate : candidates) {
+            if ((int)nearest.size() < count) {
+                nearest.push_back(candidate);
+                std::push_heap(nearest.begin(), nearest.end(), closerEntity);
+            } else if (candidate.first < nearest.front().first) {
+                std::pop_heap(nearest.begin(), nearest.end(), closerEntity);
+                nearest.back() = candidate;
+                std::push_heap(nearest.begin(), nearest.end(), closerEntity);
+            }
+            if ((int)nearest.size() == count) {
+                searchRadius = std::min(searchRadius, nearest.front().first);
+            }
+        }
+
+        for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
+            EntityTreeElementPointer child = next.second->getChildAtIndex(i);
+            if (child) {
+                const AACube& childCube = child->getAACube();
+                float distance = distanceToBox(center, childCube.getMinimumPoint(), childCube.getMaximumPoint());
+                if (distance <= searchRadius) {
+                    elements.push({ distance, child });
+                }
+            }
+        }
+    }
+
+    std::sort_heap(nearest.begin(), nearest.end(), closerEntity);
+    foundEntities.reserve((int)nearest.size());
+    for (const auto& entityDistance : nearest) {
+        foundEntities.push_back(entityDistance.second);
+    }
+}
+
 class FindEntitiesInCubeArgs {
 public:
     FindEntitiesInCubeArgs(const AACube& cube)
@@ -2006,11 +2136,21 @@ void EntityTree::addEntityMapEntry(EntityItemPointer entity) {
         return;
     }
     _entityMap.insert(id, entity);
+    _entityTypeMap[entity->getType()].insert(id, entity);
 }
 
 void EntityTree::clearEntityMapEntry(const EntityItemID& id) {
     QWriteLocker locker(&_entityMapLock);
-    _entityMap.remove(id);
+    EntityItemPointer entity = _entityMap.take(id);
+    if (entity) {
+        auto typeItr = _entityTypeMap.find(entity->getType());
+        if (typeItr != _entityTypeMap.end()) {
+            typeItr->remove(id);
+            if (typeItr->isEmpty()) {
+                _entityTypeMap.erase(typeItr);
+            }
+        }
+    }
 }
 
 void EntityTree::debugDumpMap() {
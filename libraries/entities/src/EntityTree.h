@@ -134,8 +134,28 @@ public:
     /// \param center the center of the sphere in world-frame (meters)
     /// \param radius the radius of the sphere in world-frame (meters)
     /// \param foundEntities[out] vector of EntityItemPointer
+    /// \param filter optional test applied before the exact shape test, entities it rejects are skipped
     /// \remark Side effect: any initial contents in foundEntities will be lost
-    void findEntities(const glm::vec3& center, float radius, QVector<EntityItemPointer>& foundEntities);
+    void findEntities(const glm::vec3& center, float radius, QVector<EntityItemPointer>& foundEntities,
+                      const EntityItemFilter& filter = EntityItemFilter());
+
+    /// finds all entities of a type that touch a sphere, using the type index when the type is rare enough
+    /// \remark Side effect: any initial contents in foundEntities will be lost
+    void findEntitiesByType(EntityTypes::EntityType type, const glm::vec3& center, float radius,
+                            QVector<EntityItemPointer>& foundEntities);
+
+    /// finds all entities with a name that touch a sphere
+    /// \remark Side effect: any initial contents in foundEntities will be lost
+    void findEntitiesByName(const QString& name, const glm::vec3& center, float radius, bool caseSensitive,
+                            QVector<EntityItemPointer>& foundEntities);
+
+    /// finds the entities whose world frame AABoxes are nearest to a point, best first over the octree
+    /// \param center the query point in world-frame (meters)
+    /// \param count the largest number of entities to find
+    /// \param maxRadius entities farther than this from center are ignored (meters)
+    /// \param foundEntities[out] vector of EntityItemPointer sorted by increasing distance
+    /// \remark Side effect: any initial contents in foundEntities will be lost
+    void findNearestEntities(const glm::vec3& center, int count, float maxRadius, QVector<EntityItemPointer>& foundEntities);
 
     /// finds all entities that touch a cube
     /// \param cube the query cube in world-frame (meters)
@@ -342,6 +362,7 @@ protected:
 
     mutable QReadWriteLock _entityMapLock;
     QHash<EntityItemID, EntityItemPointer> _entityMap;
+    QHash<EntityTypes::EntityType, QHash<EntityItemID, EntityItemPointer>> _entityTypeMap; // also under _entityMapLock
 
     mutable QReadWriteLock _entityCertificateIDMapLock;
     QHash<QString, EntityItemID> _entityCertificateIDMap;
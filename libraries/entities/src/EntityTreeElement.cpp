@@ -11,9 +11,13 @@
 
 #include "EntityTreeElement.h"
 
+#include <cmath>
+#include <limits>
+
 #include <glm/gtx/transform.hpp>
 
 #include <GeometryUtil.h>
+#include <GLMHelpers.h>
 #include <OctreeUtils.h>
 #include <Extents.h>
 
@@ -301,121 +305,262 @@ EntityItemPointer EntityTreeElement::getClosestEntity(glm::vec3 position) const
     return closestEntity;
 }
 
+static const int PACKED_BOUNDS_LANES = 4;
+enum PackedBoundsComponent { MIN_X = 0, MIN_Y, MIN_Z, MAX_X, MAX_Y, MAX_Z, NUM_PACKED_BOUNDS_COMPONENTS };
+
+void EntityTreeElement::updatePackedBounds() const {
+    if (!_packedBoundsDirty) {
+        return;
+    }
+    // clear the flag before reading the entities, so a change that races with the rebuild marks it dirty again
+    _packedBoundsDirty = false;
+
+    withReadLock([&] {
+        _packedEntities = _entityItems;
+    });
+    int numEntities = _packedEntities.size();
+    _numPackedBounds = ((numEntities + PACKED_BOUNDS_LANES - 1) / PACKED_BOUNDS_LANES) * PACKED_BOUNDS_LANES;
+    _packedBounds.resize(NUM_PACKED_BOUNDS_COMPONENTS * _numPackedBounds);
+
+    const float INF = std::numeric_limits<float>::infinity();
+    float* bounds = _packedBounds.data();
+    for (int i = 0; i < _numPackedBounds; i++) {
+        glm::vec3 minCorner(INF);
+        glm::vec3 maxCorner(-INF);
+        if (i < numEntities) {
+            bool success;
+            AABox entityBox = _packedEntities[i]->getAABox(success);
+            if (success) {
+                minCorner = entityBox.getMinimumPoint();
+                maxCorner = entityBox.getMaximumPoint();
+            } else {
+                minCorner = glm::vec3(-INF);
+                maxCorner = glm::vec3(INF);
+            }
+        }
+        bounds[MIN_X * _numPackedBounds + i] = minCorner.x;
+        bounds[MIN_Y * _numPackedBounds + i] = minCorner.y;
+        bounds[MIN_Z * _numPackedBounds + i] = minCorner.z;
+        bounds[MAX_X * _numPackedBounds + i] = maxCorner.x;
+        bounds[MAX_Y * _numPackedBounds + i] = maxCorner.y;
+        bounds[MAX_Z * _numPackedBounds + i] = maxCorner.z;
+    }
+}
+
+void EntityTreeElement::clearPackedBounds() {
+    // drop the references to removed entities now rather than at the next query, which may never come
+    std::lock_guard<std::mutex> lock(_packedBoundsMutex);
+    _packedBoundsDirty = true;
+    _packedEntities.clear();
+    _numPackedBounds = 0;
+}
+
+template <typename F>
+void EntityTreeElement::forEachPackedEntityTouchingBox(const glm::vec3& minCorner, const glm::vec3& maxCorner, F f) const {
+    const float* bounds = _packedBounds.data();
+    const int stride = _numPackedBounds;
+    // padding only passes an unbounded query, so it is masked off by count rather than tested
+    const int numEntities = _packedEntities.size();
+    for (int i = 0; i < stride; i += PACKED_BOUNDS_LANES) {
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+        __m128 touches = _mm_and_ps(
+            _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(bounds + MIN_X * stride + i), _mm_set1_ps(maxCorner.x)),
+                       _mm_cmpge_ps(_mm_loadu_ps(bounds + MAX_X * stride + i), _mm_set1_ps(minCorner.x))),
+            _mm_and_ps(
+                _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(bounds + MIN_Y * stride + i), _mm_set1_ps(maxCorner.y)),
+                           _mm_cmpge_ps(_mm_loadu_ps(bounds + MAX_Y * stride + i), _mm_set1_ps(minCorner.y))),
+                _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(bounds + MIN_Z * stride + i), _mm_set1_ps(maxCorner.z)),
+                           _mm_cmpge_ps(_mm_loadu_ps(bounds + MAX_Z * stride + i), _mm_set1_ps(minCorner.z)))));
+        int mask = _mm_movemask_ps(touches);
+        for (int lane = 0; mask; lane++, mask >>= 1) {
+            if ((mask & 1) && i + lane < numEntities) {
+                f(i + lane);
+            }
+        }
+#else
+        for (int j = i; j < i + PACKED_BOUNDS_LANES && j < numEntities; j++) {
+            if (bounds[MIN_X * stride + j] <= maxCorner.x && bounds[MAX_X * stride + j] >= minCorner.x &&
+                bounds[MIN_Y * stride + j] <= maxCorner.y && bounds[MAX_Y * stride + j] >= minCorner.y &&
+                bounds[MIN_Z * stride + j] <= maxCorner.z && bounds[MAX_Z * stride + j] >= minCorner.z) {
+                f(j);
+            }
+        }
+#endif
+    }
+}
+
 // TODO: change this to use better bounding shape for entity than sphere
-void EntityTreeElement::getEntities(const glm::vec3& searchPosition, float searchRadius, QVector<EntityItemPointer>& foundEntities) const {
-    forEachEntity([&](EntityItemPointer entity) {
+bool EntityTreeElement::entityTouchesSphere(const EntityItemPointer& entity, const glm::vec3& searchPosition, float searchRadius) {
+    glm::vec3 dimensions = entity->getScaledDimensions();
+    glm::vec3 penetration;
+
+    // FIXME - consider allowing the entity to determine penetration so that
+    //         entities could presumably dull actuall hull testing if they wanted to
+    // FIXME - handle entity->getShapeType() == SHAPE_TYPE_SPHERE case better in particular
+    //         can we handle the ellipsoid case better? We only currently handle perfect spheres
+    //         with centered registration points
+    if (entity->getShapeType() == SHAPE_TYPE_SPHERE &&
+        (dimensions.x == dimensions.y && dimensions.y == dimensions.z)) {
+
+        // NOTE: entity->getRadius() doesn't return the true radius, it returns the radius of the
+        //       maximum bounding sphere, which is actually larger than our actual radius
+        float entityTrueRadius = dimensions.x / 2.0f;
 
         bool success;
-        AABox entityBox = entity->getAABox(success);
+        glm::vec3 entityCenter = entity->getCenterPosition(success);
+        return findSphereSpherePenetration(searchPosition, searchRadius, entityCenter, entityTrueRadius, penetration) &&
+            success;
+    }
 
-        // if the sphere doesn't intersect with our world frame AABox, we don't need to consider the more complex case
-        glm::vec3 penetration;
-        if (!success || entityBox.findSpherePenetration(searchPosition, searchRadius, penetration)) {
-
-            glm::vec3 dimensions = entity->getScaledDimensions();
-
-            // FIXME - consider allowing the entity to determine penetration so that
-            //         entities could presumably dull actuall hull testing if they wanted to
-            // FIXME - handle entity->getShapeType() == SHAPE_TYPE_SPHERE case better in particular
-            //         can we handle the ellipsoid case better? We only currently handle perfect spheres
-            //         with centered registration points
-            if (entity->getShapeType() == SHAPE_TYPE_SPHERE &&
-                (dimensions.x == dimensions.y && dimensions.y == dimensions.z)) {
-
-                // NOTE: entity->getRadius() doesn't return the true radius, it returns the radius of the
-                //       maximum bounding sphere, which is actually larger than our actual radius
-                float entityTrueRadius = dimensions.x / 2.0f;
-
-                bool success;
-                if (findSphereSpherePenetration(searchPosition, searchRadius,
-                        entity->getCenterPosition(success), entityTrueRadius, penetration)) {
-                    if (success) {
-                        foundEntities.push_back(entity);
-                    }
-                }
-            } else {
-                // determine the worldToEntityMatrix that doesn't include scale because
-                // we're going to use the registration aware aa box in the entity frame
-                glm::mat4 rotation = glm::mat4_cast(entity->getWorldOrientation());
-                glm::mat4 translation = glm::translate(entity->getWorldPosition());
-                glm::mat4 entityToWorldMatrix = translation * rotation;
-                glm::mat4 worldToEntityMatrix = glm::inverse(entityToWorldMatrix);
+    // determine the worldToEntityMatrix that doesn't include scale because
+    // we're going to use the registration aware aa box in the entity frame
+    glm::mat4 rotation = glm::mat4_cast(entity->getWorldOrientation());
+    glm::mat4 translation = glm::translate(entity->getWorldPosition());
+    glm::mat4 entityToWorldMatrix = translation * rotation;
+    glm::mat4 worldToEntityMatrix = glm::inverse(entityToWorldMatrix);
 
-                glm::vec3 registrationPoint = entity->getRegistrationPoint();
-                glm::vec3 corner = -(dimensions * registrationPoint);
+    glm::vec3 registrationPoint = entity->getRegistrationPoint();
+    glm::vec3 corner = -(dimensions * registrationPoint);
 
-                AABox entityFrameBox(corner, dimensions);
+    AABox entityFrameBox(corner, dimensions);
 
-                glm::vec3 entityFrameSearchPosition = glm::vec3(worldToEntityMatrix * glm::vec4(searchPosition, 1.0f));
-                if (entityFrameBox.findSpherePenetration(entityFrameSearchPosition, searchRadius, penetration)) {
-                    foundEntities.push_back(entity);
-                }
+    glm::vec3 entityFrameSearchPosition = glm::vec3(worldToEntityMatrix * glm::vec4(searchPosition, 1.0f));
+    return entityFrameBox.findSpherePenetration(entityFrameSearchPosition, searchRadius, penetration);
+}
+
+void EntityTreeElement::getEntities(const glm::vec3& searchPosition, float searchRadius, QVector<EntityItemPointer>& foundEntities,
+                                    const EntityItemFilter& filter) const {
+    std::lock_guard<std::mutex> lock(_packedBoundsMutex);
+    updatePackedBounds();
+
+    // if the sphere doesn't touch the world frame AABox of an entity, we don't need to consider the more complex case.
+    // the squared distance from the center of the sphere to each box is computed four boxes at a time.
+    const float* bounds = _packedBounds.data();
+    const int stride = _numPackedBounds;
+    const float radiusSquared = searchRadius * searchRadius;
+    const int numEntities = _packedEntities.size();
+    auto testEntity = [&](int index) {
+        if (index >= numEntities) {
+            // padding only passes an unbounded query
+            return;
+        }
+        EntityItemPointer entity = _packedEntities[index];
+        if ((!filter || filter(entity)) && entityTouchesSphere(entity, searchPosition, searchRadius)) {
+            foundEntities.push_back(entity);
+        }
+    };
+    for (int i = 0; i < stride; i += PACKED_BOUNDS_LANES) {
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+        const __m128 zero = _mm_setzero_ps();
+        __m128 px = _mm_set1_ps(searchPosition.x);
+        __m128 py = _mm_set1_ps(searchPosition.y);
+        __m128 pz = _mm_set1_ps(searchPosition.z);
+        __m128 dx = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(bounds + MIN_X * stride + i), px), zero),
+                               _mm_sub_ps(px, _mm_loadu_ps(bounds + MAX_X * stride + i)));
+        __m128 dy = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(bounds + MIN_Y * stride + i), py), zero),
+                               _mm_sub_ps(py, _mm_loadu_ps(bounds + MAX_Y * stride + i)));
+        __m128 dz = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(bounds + MIN_Z * stride + i), pz), zero),
+                               _mm_sub_ps(pz, _mm_loadu_ps(bounds + MAX_Z * stride + i)));
+        __m128 distanceSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+        int mask = _mm_movemask_ps(_mm_cmple_ps(distanceSquared, _mm_set1_ps(radiusSquared)));
+        for (int lane = 0; mask; lane++, mask >>= 1) {
+            if (mask & 1) {
+                testEntity(i + lane);
             }
         }
-    });
+#else
+        for (int j = i; j < i + PACKED_BOUNDS_LANES; j++) {
+            glm::vec3 minCorner(bounds[MIN_X * stride + j], bounds[MIN_Y * stride + j], bounds[MIN_Z * stride + j]);
+            glm::vec3 maxCorner(bounds[MAX_X * stride + j], bounds[MAX_Y * stride + j], bounds[MAX_Z * stride + j]);
+            glm::vec3 delta = glm::max(glm::max(minCorner - searchPosition, Vectors::ZERO), searchPosition - maxCorner);
+            if (glm::dot(delta, delta) <= radiusSquared) {
+                testEntity(j);
+            }
+        }
+#endif
+    }
 }
 
-void EntityTreeElement::getEntities(const AACube& cube, QVector<EntityItemPointer>& foundEntities) {
-    forEachEntity([&](EntityItemPointer entity) {
-        bool success;
-        AABox entityBox = entity->getAABox(success);
-        // FIXME - handle entity->getShapeType() == SHAPE_TYPE_SPHERE case better
-        // FIXME - consider allowing the entity to determine penetration so that
-        //         entities could presumably dull actuall hull testing if they wanted to
-        // FIXME - is there an easy way to translate the search cube into something in the
-        //         entity frame that can be easily tested against?
-        //         simple algorithm is probably:
-        //             if target box is fully inside search box == yes
-        //             if search box is fully inside target box == yes
-        //             for each face of search box:
-        //                 translate the triangles of the face into the box frame
-        //                 test the triangles of the face against the box?
-        //                 if translated search face triangle intersect target box
-        //                     add to result
-        //
-
-        // If the entities AABox touches the search cube then consider it to be found
-        if (!success || entityBox.touches(cube)) {
-            foundEntities.push_back(entity);
+void EntityTreeElement::getEntityDistances(const glm::vec3& position, float maxDistance,
+                                           std::vector<std::pair<float, EntityItemPointer>>& foundEntities) const {
+    std::lock_guard<std::mutex> lock(_packedBoundsMutex);
+    updatePackedBounds();
+
+    const float* bounds = _packedBounds.data();
+    const int stride = _numPackedBounds;
+    const int numEntities = _packedEntities.size();
+    for (int i = 0; i < numEntities; i++) {
+        glm::vec3 minCorner(bounds[MIN_X * stride + i], bounds[MIN_Y * stride + i], bounds[MIN_Z * stride + i]);
+        glm::vec3 maxCorner(bounds[MAX_X * stride + i], bounds[MAX_Y * stride + i], bounds[MAX_Z * stride + i]);
+        if (std::isinf(minCorner.x) && std::isinf(maxCorner.x)) {
+            // bounds weren't known when the packed bounds were built
+            continue;
+        }
+        glm::vec3 delta = glm::max(glm::max(minCorner - position, Vectors::ZERO), position - maxCorner);
+        float distance = glm::length(delta);
+        if (distance <= maxDistance) {
+            foundEntities.push_back({ distance, _packedEntities[i] });
         }
+    }
+}
+
+void EntityTreeElement::getEntities(const AACube& cube, QVector<EntityItemPointer>& foundEntities) {
+    // FIXME - handle entity->getShapeType() == SHAPE_TYPE_SPHERE case better
+    // FIXME - consider allowing the entity to determine penetration so that
+    //         entities could presumably dull actuall hull testing if they wanted to
+    // FIXME - is there an easy way to translate the search cube into something in the
+    //         entity frame that can be easily tested against?
+    //         simple algorithm is probably:
+    //             if target box is fully inside search box == yes
+    //             if search box is fully inside target box == yes
+    //             for each face of search box:
+    //                 translate the triangles of the face into the box frame
+    //                 test the triangles of the face against the box?
+    //                 if translated search face triangle intersect target box
+    //                     add to result
+    //
+
+    // If the entities AABox touches the search cube then consider it to be found
+    std::lock_guard<std::mutex> lock(_packedBoundsMutex);
+    updatePackedBounds();
+    forEachPackedEntityTouchingBox(cube.getMinimumPoint(), cube.getMaximumPoint(), [&](int index) {
+        foundEntities.push_back(_packedEntities[index]);
     });
 }
 
 void EntityTreeElement::getEntities(const AABox& box, QVector<EntityItemPointer>& foundEntities) {
-    forEachEntity([&](EntityItemPointer entity) {
-        bool success;
-        AABox entityBox = entity->getAABox(success);
-        // FIXME - handle entity->getShapeType() == SHAPE_TYPE_SPHERE case better
-        // FIXME - consider allowing the entity to determine penetration so that
-        //         entities could presumably dull actuall hull testing if they wanted to
-        // FIXME - is there an easy way to translate the search cube into something in the
-        //         entity frame that can be easily tested against?
-        //         simple algorithm is probably:
-        //             if target box is fully inside search box == yes
-        //             if search box is fully inside target box == yes
-        //             for each face of search box:
-        //                 translate the triangles of the face into the box frame
-        //                 test the triangles of the face against the box?
-        //                 if translated search face triangle intersect target box
-        //                     add to result
-        //
-
-        // If the entities AABox touches the search cube then consider it to be found
-        if (!success || entityBox.touches(box)) {
-            foundEntities.push_back(entity);
-        }
+    // FIXME - See FIXMEs for the cube version above.
+
+    // If the entities AABox touches the search box then consider it to be found
+    std::lock_guard<std::mutex> lock(_packedBoundsMutex);
+    updatePackedBounds();
+    forEachPackedEntityTouchingBox(box.getMinimumPoint(), box.getMaximumPoint(), [&](int index) {
+        foundEntities.push_back(_packedEntities[index]);
     });
 }
 
 void EntityTreeElement::getEntities(const ViewFrustum& frustum, QVector<EntityItemPointer>& foundEntities) {
-    forEachEntity([&](EntityItemPointer entity) {
-        bool success;
-        AABox entityBox = entity->getAABox(success);
-        // FIXME - See FIXMEs for similar methods above.
-        if (!success || frustum.boxIntersectsFrustum(entityBox) || frustum.boxIntersectsKeyhole(entityBox)) {
-            foundEntities.push_back(entity);
+    std::lock_guard<std::mutex> lock(_packedBoundsMutex);
+    updatePackedBounds();
+
+    // FIXME - See FIXMEs for similar methods above.
+    // the frustum test itself stays scalar, but it reads the packed bounds instead of asking every entity for its AABox
+    const float* bounds = _packedBounds.data();
+    const int stride = _numPackedBounds;
+    const int numEntities = _packedEntities.size();
+    for (int i = 0; i < numEntities; i++) {
+        glm::vec3 minCorner(bounds[MIN_X * stride + i], bounds[MIN_Y * stride + i], bounds[MIN_Z * stride + i]);
+        glm::vec3 maxCorner(bounds[MAX_X * stride + i], bounds[MAX_Y * stride + i], bounds[MAX_Z * stride + i]);
+        bool known = !(std::isinf(minCorner.x) && std::isinf(maxCorner.x));
+        if (!known) {
+            foundEntities.push_back(_packedEntities[i]);
+            continue;
         }
-    });
+        AABox entityBox(minCorner, maxCorner - minCorner);
+        if (frustum.boxIntersectsFrustum(entityBox) || frustum.boxIntersectsKeyhole(entityBox)) {
+            foundEntities.push_back(_packedEntities[i]);
+        }
+    }
 }
 
 void EntityTreeElement::getEntities(EntityItemFilter& filter,  QVector<EntityItemPointer>& foundEntities) {
@@ -451,6 +596,7 @@ void EntityTreeElement::cleanupEntities() {
         }
         _entityItems.clear();
     });
+    clearPackedBounds();
     bumpChangedContent();
 }
 
@@ -466,6 +612,7 @@ bool EntityTreeElement::removeEntityItem(EntityItemPointer entity, bool deletion
         // NOTE: only EntityTreeElement should ever be changing the value of entity->_element
         assert(entity->_element.get() == this);
         entity->_element = NULL;
+        clearPackedBounds();
         bumpChangedContent();
         return true;
     }
@@ -484,6 +631,7 @@ void EntityTreeElement::addEntityItem(EntityItemPointer entity) {
     withWriteLock([&] {
         _entityItems.push_back(entity);
     });
+    markPackedBoundsDirty();
     bumpChangedContent();
     entity->_element = getThisPointer();
 }
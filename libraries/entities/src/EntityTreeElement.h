@@ -12,7 +12,10 @@
 #ifndef hifi_EntityTreeElement_h
 #define hifi_EntityTreeElement_h
 
+#include <atomic>
 #include <memory>
+#include <mutex>
+#include <vector>
 
 #include <OctreeElement.h>
 #include <QList>
@@ -172,7 +175,22 @@ public:
     /// \param position the center of the query sphere
     /// \param radius the radius of the query sphere
     /// \param entities[out] vector of const EntityItemPointer
-    void getEntities(const glm::vec3& position, float radius, QVector<EntityItemPointer>& foundEntities) const;
+    /// \param filter optional test applied before the exact shape test, entities it rejects are skipped
+    void getEntities(const glm::vec3& position, float radius, QVector<EntityItemPointer>& foundEntities,
+                     const EntityItemFilter& filter = EntityItemFilter()) const;
+
+    /// finds the entities whose world frame AABox is within maxDistance of a point
+    /// \param position the query point
+    /// \param maxDistance the largest distance of interest
+    /// \param foundEntities[out] (distance, entity) pairs appended in no particular order, entities without bounds are skipped
+    void getEntityDistances(const glm::vec3& position, float maxDistance,
+                            std::vector<std::pair<float, EntityItemPointer>>& foundEntities) const;
+
+    /// exact test of the sphere query, also used by queries that don't go through the octree
+    static bool entityTouchesSphere(const EntityItemPointer& entity, const glm::vec3& position, float radius);
+
+    /// called when an entity in this element changes its bounds, the packed bounds are rebuilt by the next query
+    void markPackedBoundsDirty() { _packedBoundsDirty = true; }
 
     /// finds all entities that touch a box
     /// \param box the query box
@@ -234,8 +252,27 @@ public:
 
 protected:
     virtual void init(unsigned char * octalCode) override;
+
+    // rebuilds the packed bounds if needed, requires _packedBoundsMutex
+    void updatePackedBounds() const;
+    void clearPackedBounds();
+
+    // calls f(index) for every packed entity whose AABox touches the box from minCorner to maxCorner,
+    // requires _packedBoundsMutex
+    template <typename F>
+    void forEachPackedEntityTouchingBox(const glm::vec3& minCorner, const glm::vec3& maxCorner, F f) const;
+
     EntityTreePointer _myTree;
     EntityItems _entityItems;
+
+    // World frame AABoxes of _entityItems as six runs of _numPackedBounds floats (min x, y, z, max x, y, z) so the
+    // spatial queries can test four entities at a time.  The count is padded to a multiple of four with empty boxes,
+    // entities whose AABox isn't known get an infinite box so they always pass, as they did before.
+    mutable std::mutex _packedBoundsMutex;
+    mutable std::atomic<bool> _packedBoundsDirty { true };
+    mutable std::vector<float> _packedBounds;
+    mutable EntityItems _packedEntities;
+    mutable int _numPackedBounds { 0 };
 };
 
 #endif // hifi_EntityTreeElement_h
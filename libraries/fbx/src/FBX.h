@@ -37,6 +37,13 @@ static const int DRACO_BEGIN_CUSTOM_HIFI_ATTRIBUTES = 1000;
 static const int DRACO_ATTRIBUTE_MATERIAL_ID = DRACO_BEGIN_CUSTOM_HIFI_ATTRIBUTES;
 static const int DRACO_ATTRIBUTE_TEX_COORD_1 = DRACO_BEGIN_CUSTOM_HIFI_ATTRIBUTES + 1;
 static const int DRACO_ATTRIBUTE_ORIGINAL_INDEX = DRACO_BEGIN_CUSTOM_HIFI_ATTRIBUTES + 2;
+static const int DRACO_ATTRIBUTE_LOD_VERTEX = DRACO_BEGIN_CUSTOM_HIFI_ATTRIBUTES + 3;
+
+// Simplified levels of a baked mesh, children of its DracoMesh node.  A level holds its error then a part node per
+// material, with the material ID and triangle indices.  The indices are values of the LOD vertex attribute, or the
+// draco points themselves in bakes without that attribute.
+static const QByteArray DRACO_MESH_LOD_NODE_NAME = "LOD";
+static const QByteArray DRACO_MESH_LOD_PART_NODE_NAME = "Part";
 
 static const int32_t FBX_PROPERTY_UNCOMPRESSED_FLAG = 0;
 static const int32_t FBX_PROPERTY_COMPRESSED_FLAG = 1;
@@ -215,6 +222,15 @@ public:
     bool needTangentSpace() const;
 };
 
+/// A simplified version of a mesh made by the baker, drawn with the vertices of the full one.
+class FBXMeshLOD {
+public:
+    float error { 0.0f }; // how far the surface moved, in mesh units
+    QVector<QVector<int>> partTriangleIndices; // in the order of the mesh parts
+
+    std::vector<graphics::Mesh::Part> _drawParts; // ranges of FBXMesh::_lodIndexBuffer
+};
+
 /// A single mesh (with optional blendshapes) extracted from an FBX document.
 class FBXMesh {
 public:
@@ -238,9 +254,12 @@ public:
 
     QVector<FBXBlendshape> blendshapes;
 
+    QVector<FBXMeshLOD> lods; // from the most detailed down
+
     unsigned int meshIndex; // the order the meshes appeared in the object file
 
     graphics::MeshPointer _mesh;
+    gpu::BufferPointer _lodIndexBuffer;
     bool wasCompressed { false };
 
     void createMeshTangents(bool generateFromTexCoords);
@@ -1997,15 +1997,12 @@ FBXGeometry* FBXReader::extractFBXGeometry(const QVariantHash& mapping, const QS
     return geometryPtr;
 }
 
-FBXGeometry* readFBX(const QByteArray& model, const QVariantHash& mapping, const QString& url, bool loadLightmaps, float lightmapLevel) {
-    QBuffer buffer(const_cast<QByteArray*>(&model));
-    buffer.open(QIODevice::ReadOnly);
-    return readFBX(&buffer, mapping, url, loadLightmaps, lightmapLevel);
-}
+// Top level and object nodes extractFBXGeometry never looks at
+static const QSet<QByteArray> UNUSED_FBX_NODES {
+    "Documents", "References", "Definitions", "Takes", "Pose", "AnimationStack", "AnimationLayer", "AnimationCurveNode"
+};
 
-FBXGeometry* readFBX(QIODevice* device, const QVariantHash& mapping, const QString& url, bool loadLightmaps, float lightmapLevel) {
-    FBXReader reader;
-    reader._rootNode = FBXReader::parseFBX(device);
+static FBXGeometry* readFBX(FBXReader& reader, const QVariantHash& mapping, const QString& url, bool loadLightmaps, float lightmapLevel) {
     reader._loadLightmaps = loadLightmaps;
     reader._lightmapLevel = lightmapLevel;
 
@@ -2013,3 +2010,15 @@ FBXGeometry* readFBX(QIODevice* device, const QVariantHash& mapping, const QStri
 
     return reader.extractFBXGeometry(mapping, url);
 }
+
+FBXGeometry* readFBX(const QByteArray& model, const QVariantHash& mapping, const QString& url, bool loadLightmaps, float lightmapLevel) {
+    FBXReader reader;
+    reader._rootNode = FBXReader::parseFBX(model, UNUSED_FBX_NODES);
+    return readFBX(reader, mapping, url, loadLightmaps, lightmapLevel);
+}
+
+FBXGeometry* readFBX(QIODevice* device, const QVariantHash& mapping, const QString& url, bool loadLightmaps, float lightmapLevel) {
+    FBXReader reader;
+    reader._rootNode = FBXReader::parseFBX(device, UNUSED_FBX_NODES);
+    return readFBX(reader, mapping, url, loadLightmaps, lightmapLevel);
+}
@@ -120,7 +120,11 @@ public:
     FBXGeometry* _fbxGeometry;
 
     FBXNode _rootNode;
-    static FBXNode parseFBX(QIODevice* device);
+    // In binary files, nodes named in skippedNodes are jumped over and left out of the tree, and array properties stay
+    // encoded until they're first converted to QVectors, which throws if they're corrupt; the tree holds on to the
+    // file's data (mapped when it's a QFile).
+    static FBXNode parseFBX(QIODevice* device, const QSet<QByteArray>& skippedNodes = QSet<QByteArray>());
+    static FBXNode parseFBX(const QByteArray& data, const QSet<QByteArray>& skippedNodes = QSet<QByteArray>());
 
     FBXGeometry* extractFBXGeometry(const QVariantHash& mapping, const QString& url);
 
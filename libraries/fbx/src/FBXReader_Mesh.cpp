@@ -34,7 +34,9 @@
 #include "ModelFormatLogging.h"
 
 #include "FBXReader.h"
+#include "MeshOptimizer.h"
 
+#include <algorithm>
 #include <memory>
 
 #include <glm/detail/type_half.hpp>
@@ -372,12 +374,19 @@ ExtractedMesh FBXReader::extractMesh(const FBXNode& object, unsigned int& meshIn
             auto colorAttribute = dracoMesh->GetNamedAttribute(draco::GeometryAttribute::COLOR);
             auto materialIDAttribute = dracoMesh->GetAttributeByUniqueId(DRACO_ATTRIBUTE_MATERIAL_ID);
             auto originalIndexAttribute = dracoMesh->GetAttributeByUniqueId(DRACO_ATTRIBUTE_ORIGINAL_INDEX);
+            auto lodVertexAttribute = dracoMesh->GetAttributeByUniqueId(DRACO_ATTRIBUTE_LOD_VERTEX);
 
             // setup extracted mesh data structures given number of points
             auto numVertices = dracoMesh->num_points();
 
             QHash<QPair<int, int>, int> materialTextureParts;
 
+            // the point each simplified level vertex of a material became
+            auto lodVertexKey = [](uint16_t materialID, int32_t lodVertex) {
+                return ((qint64)materialID << 32) | (quint32)lodVertex;
+            };
+            QHash<qint64, int> lodVertexPoints;
+
             data.extracted.mesh.vertices.resize(numVertices);
 
             if (normalAttribute) {
@@ -482,6 +491,72 @@ ExtractedMesh FBXReader::extractMesh(const FBXNode& object, unsigned int& meshIn
                 part.triangleIndices.append(firstCorner.value());
                 part.triangleIndices.append(dracoFace[1].value());
                 part.triangleIndices.append(dracoFace[2].value());
+
+                if (lodVertexAttribute) {
+                    for (int j = 0; j < 3; j++) {
+                        int32_t lodVertex;
+                        lodVertexAttribute->ConvertValue<int32_t, 1>(lodVertexAttribute->mapped_index(dracoFace[j]), &lodVertex);
+                        lodVertexPoints.insert(lodVertexKey(materialID, lodVertex), dracoFace[j].value());
+                    }
+                }
+            }
+
+            // draco's edgebreaker decodes the faces in its own order, put each part's back in one that suits the
+            // vertex cache and then overdraw, as the baker can't
+            for (auto& part : data.extracted.mesh.parts) {
+                part.triangleIndices = mesh_optimizer::optimizeOverdraw(mesh_optimizer::optimizeVertexCache(part.triangleIndices),
+                                                                        data.extracted.mesh.vertices);
+            }
+
+            // simplified levels the baker made, drawn with the same points.  A level with any part that doesn't
+            // fit the mesh is left out whole, drawing what's left of it would leave holes.
+            foreach (const FBXNode& lodNode, child.children) {
+                if (lodNode.name != DRACO_MESH_LOD_NODE_NAME || lodNode.properties.isEmpty()) {
+                    continue;
+                }
+                FBXMeshLOD lod;
+                lod.error = lodNode.properties.at(0).toFloat();
+                lod.partTriangleIndices.resize(data.extracted.mesh.parts.size());
+
+                bool isValid = true;
+                bool hasParts = false;
+                foreach (const FBXNode& partNode, lodNode.children) {
+                    if (partNode.name != DRACO_MESH_LOD_PART_NODE_NAME) {
+                        continue;
+                    }
+                    if (partNode.properties.size() < 2) {
+                        isValid = false;
+                        break;
+                    }
+                    uint16_t materialID = (uint16_t)partNode.properties.at(0).toInt();
+                    int partIndex = materialTextureParts.value(QPair<int, int>(materialID, 0)) - 1;
+                    QVector<int> indices = partNode.properties.at(1).value<QVector<int>>();
+                    if (partIndex < 0 || indices.isEmpty() || (indices.size() % 3) != 0) {
+                        isValid = false;
+                        break;
+                    }
+                    for (int& index : indices) {
+                        if (lodVertexAttribute) {
+                            index = lodVertexPoints.value(lodVertexKey(materialID, index), -1);
+                        }
+                        if (index < 0 || index >= (int)numVertices) {
+                            isValid = false;
+                            break;
+                        }
+                    }
+                    if (!isValid) {
+                        break;
+                    }
+                    lod.partTriangleIndices[partIndex] += indices;
+                    hasParts = true;
+                }
+
+                if (isValid && hasParts) {
+                    data.extracted.mesh.lods.append(lod);
+                } else {
+                    qCWarning(modelformat) << "Skipping a simplified level of mesh" << data.extracted.mesh.meshIndex
+                        << "that doesn't match its parts";
+                }
             }
         }
     }
@@ -825,6 +900,36 @@ void FBXReader::buildModelMesh(FBXMesh& extractedMesh, const QString& url) {
         return;
     }
 
+    // the simplified levels get their own index buffer, so the mesh's stays the full surface for picking and collisions
+    unsigned int totalLODIndices = 0;
+    for (const auto& lod : extractedMesh.lods) {
+        for (const auto& indices : lod.partTriangleIndices) {
+            totalLODIndices += indices.size();
+        }
+    }
+    extractedMesh._lodIndexBuffer.reset();
+    if (totalLODIndices) {
+        auto lodIndexBuffer = std::make_shared<gpu::Buffer>();
+        lodIndexBuffer->resize(totalLODIndices * sizeof(int));
+        offset = 0;
+        indexNum = 0;
+        for (auto& lod : extractedMesh.lods) {
+            lod._drawParts.clear();
+            for (int i = 0; i < (int)parts.size(); i++) {
+                // a part the simplification left out of this level
+                QVector<int> indices = lod.partTriangleIndices.value(i);
+                graphics::Mesh::Part lodPart(indexNum, indices.size(), 0, graphics::Mesh::TRIANGLES);
+                if (indices.size()) {
+                    lodIndexBuffer->setSubData(offset, indices.size() * sizeof(int), (gpu::Byte*) indices.constData());
+                    offset += indices.size() * sizeof(int);
+                    indexNum += indices.size();
+                }
+                lod._drawParts.push_back(lodPart);
+            }
+        }
+        extractedMesh._lodIndexBuffer = lodIndexBuffer;
+    }
+
     // graphics::Box box =
     mesh->evalPartBound(0);
 
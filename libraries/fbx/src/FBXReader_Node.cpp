@@ -11,9 +11,13 @@
 
 #include "FBXReader.h"
 
+#include <algorithm>
 #include <iostream>
+#include <memory>
+#include <mutex>
+
 #include <QtCore/QBuffer>
-#include <QtCore/QDataStream>
+#include <QtCore/QFile>
 #include <QtCore/QIODevice>
 #include <QtCore/QStringList>
 #include <QtCore/QTextStream>
@@ -21,208 +25,335 @@
 #include <QtCore/QtEndian>
 #include <QtCore/QFileInfo>
 
+#include <zlib.h>
+
 #include <shared/NsightHelpers.h>
 #include "ModelFormatLogging.h"
 
-template<class T>
-int streamSize() {
-    return sizeof(T);
+// The bytes of a binary FBX file, kept alive by the array properties of the tree parsed from it so they can be
+// decoded when they're read.  Either shares a QByteArray or maps the file.  The data starts where the FBX does,
+// which is where the node end offsets count from.
+class FBXData {
+public:
+    FBXData(const QByteArray& bytes, int start = 0) :
+        _bytes(bytes),
+        _data(bytes.constData() + start),
+        _size((size_t)(bytes.size() - start))
+    {}
+
+    FBXData(std::unique_ptr<QFile> file, const uchar* mapped, size_t size) :
+        _file(std::move(file)),
+        _data(reinterpret_cast<const char*>(mapped)),
+        _size(size)
+    {}
+
+    static std::shared_ptr<const FBXData> fromDevice(QIODevice* device);
+
+    const char* data() const { return _data; }
+    size_t size() const { return _size; }
+
+private:
+    QByteArray _bytes;
+    std::unique_ptr<QFile> _file; // unmapped when closed
+    const char* _data;
+    size_t _size;
+};
+using FBXDataPointer = std::shared_ptr<const FBXData>;
+
+// Takes the rest of the device from its current position, and leaves the device at its end as reading it would
+FBXDataPointer FBXData::fromDevice(QIODevice* device) {
+    if (auto buffer = qobject_cast<QBuffer*>(device)) {
+        auto data = std::make_shared<FBXData>(buffer->data(), (int)buffer->pos());
+        buffer->seek(buffer->size());
+        return data;
+    }
+    if (auto file = qobject_cast<QFile*>(device)) {
+        // Map our own handle, the caller's file may be closed before the tree is done with
+        auto mappedFile = std::unique_ptr<QFile>(new QFile(file->fileName()));
+        qint64 start = file->pos();
+        qint64 size = mappedFile->size() - start;
+        if (size > 0 && mappedFile->open(QIODevice::ReadOnly)) {
+            const uchar* mapped = mappedFile->map(start, size);
+            if (mapped) {
+                file->seek(start + size);
+                return std::make_shared<FBXData>(std::move(mappedFile), mapped, (size_t)size);
+            }
+        }
+    }
+    return std::make_shared<FBXData>(device->readAll());
 }
 
-template<bool>
-int streamSize() {
-    return 1;
+template <typename T>
+static T fromLittleEndian(const char* source) {
+    T value;
+    memcpy(&value, source, sizeof(T));
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+    char* bytes = reinterpret_cast<char*>(&value);
+    std::reverse(bytes, bytes + sizeof(T));
+#endif
+    return value;
 }
 
-template<class T>
-QVariant readBinaryArray(QDataStream& in, int& position) {
-    quint32 arrayLength;
-    quint32 encoding;
-    quint32 compressedLength;
+// The values of an array property once they've been decoded, shared by the copies of the property
+template <typename T>
+class FBXDecodedArray {
+public:
+    std::mutex mutex;
+    bool isDecoded { false };
+    QVector<T> values;
+};
+
+// An array property of a binary FBX file, left compressed in the file's data until it's first converted to a
+// QVector<T>, which decompresses it straight into the vector.  Later conversions share that vector.  Arrays nobody
+// reads are never decoded, and a corrupt array throws when it's read.
+template <typename T>
+class FBXArrayProperty {
+public:
+    FBXDataPointer data;
+    size_t offset { 0 };
+    quint32 length { 0 };
+    quint32 encoding { FBX_PROPERTY_UNCOMPRESSED_FLAG };
+    quint32 compressedLength { 0 };
+    std::shared_ptr<FBXDecodedArray<T>> decoded { std::make_shared<FBXDecodedArray<T>>() };
+
+    QVector<T> decode() const;
 
-    in >> arrayLength;
-    in >> encoding;
-    in >> compressedLength;
-    position += sizeof(quint32) * 3;
+private:
+    QVector<T> decompress() const;
+};
+
+Q_DECLARE_METATYPE(FBXArrayProperty<float>)
+Q_DECLARE_METATYPE(FBXArrayProperty<double>)
+Q_DECLARE_METATYPE(FBXArrayProperty<qint64>)
+Q_DECLARE_METATYPE(FBXArrayProperty<qint32>)
+Q_DECLARE_METATYPE(FBXArrayProperty<bool>)
+
+template <typename T>
+QVector<T> FBXArrayProperty<T>::decode() const {
+    std::lock_guard<std::mutex> lock(decoded->mutex);
+    if (!decoded->isDecoded) {
+        decoded->values = decompress();
+        decoded->isDecoded = true;
+    }
+    return decoded->values;
+}
+
+template <typename T>
+QVector<T> FBXArrayProperty<T>::decompress() const {
+    static_assert(sizeof(bool) == 1, "FBX bool arrays hold one byte per value");
 
     QVector<T> values;
-    if ((int)QSysInfo::ByteOrder == (int)in.byteOrder()) {
-        values.resize(arrayLength);
-        QByteArray arrayData;
-        if (encoding == FBX_PROPERTY_COMPRESSED_FLAG) {
-            // preface encoded data with uncompressed length
-            QByteArray compressed(sizeof(quint32) + compressedLength, 0);
-            *((quint32*)compressed.data()) = qToBigEndian<quint32>(arrayLength * sizeof(T));
-            in.readRawData(compressed.data() + sizeof(quint32), compressedLength);
-            position += compressedLength;
-            arrayData = qUncompress(compressed);
-            if (arrayData.isEmpty() ||
-                (unsigned int)arrayData.size() != (sizeof(T) * arrayLength)) { // answers empty byte array if corrupt
-                throw QString("corrupt fbx file");
-            }
-        } else {
-            arrayData.resize(sizeof(T) * arrayLength);
-            position += sizeof(T) * arrayLength;
-            in.readRawData(arrayData.data(), arrayData.size());
+    values.resize(length);
+    size_t byteLength = sizeof(T) * length;
+    const char* source = data->data() + offset;
+
+    if (encoding == FBX_PROPERTY_COMPRESSED_FLAG) {
+        z_stream stream;
+        memset(&stream, 0, sizeof(stream));
+        stream.next_in = (Bytef*)source;
+        stream.avail_in = compressedLength;
+        stream.next_out = reinterpret_cast<Bytef*>(values.data());
+        stream.avail_out = (uInt)byteLength;
+        bool inflated = inflateInit(&stream) == Z_OK && inflate(&stream, Z_FINISH) == Z_STREAM_END && stream.avail_out == 0;
+        inflateEnd(&stream);
+        if (!inflated) {
+            throw QString("corrupt fbx file");
         }
+    } else if (byteLength > 0) {
+        memcpy(values.data(), source, byteLength);
+    }
 
-        if (arrayData.size() > 0) {
-            memcpy(&values[0], arrayData.constData(), arrayData.size());
-        }
-    } else {
-        values.reserve(arrayLength);
-        if (encoding == FBX_PROPERTY_COMPRESSED_FLAG) {
-            // preface encoded data with uncompressed length
-            QByteArray compressed(sizeof(quint32) + compressedLength, 0);
-            *((quint32*)compressed.data()) = qToBigEndian<quint32>(arrayLength * sizeof(T));
-            in.readRawData(compressed.data() + sizeof(quint32), compressedLength);
-            position += compressedLength;
-            QByteArray uncompressed = qUncompress(compressed);
-            if (uncompressed.isEmpty()) { // answers empty byte array if corrupt
-                throw QString("corrupt fbx file");
-            }
-            QDataStream uncompressedIn(uncompressed);
-            uncompressedIn.setByteOrder(QDataStream::LittleEndian);
-            uncompressedIn.setVersion(QDataStream::Qt_4_5); // for single/double precision switch
-            for (quint32 i = 0; i < arrayLength; i++) {
-                T value;
-                uncompressedIn >> value;
-                values.append(value);
-            }
-        } else {
-            for (quint32 i = 0; i < arrayLength; i++) {
-                T value;
-                in >> value;
-                position += streamSize<T>();
-                values.append(value);
-            }
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+    for (T& value : values) {
+        value = fromLittleEndian<T>(reinterpret_cast<const char*>(&value));
+    }
+#endif
+    return values;
+}
+
+template <typename T>
+static bool registerArrayProperty() {
+    qRegisterMetaType<FBXArrayProperty<T>>();
+    return QMetaType::registerConverter<FBXArrayProperty<T>, QVector<T>>(&FBXArrayProperty<T>::decode);
+}
+
+static const bool arrayPropertiesRegistered = registerArrayProperty<float>() && registerArrayProperty<double>() &&
+    registerArrayProperty<qint64>() && registerArrayProperty<qint32>() && registerArrayProperty<bool>();
+
+// Walks the nodes of a binary FBX file in place.  Strings are copied out, arrays are only located.
+class BinaryFBXParser {
+public:
+    BinaryFBXParser(const FBXDataPointer& data, bool has64BitPositions, const QSet<QByteArray>& skippedNodes) :
+        _data(data),
+        _has64BitPositions(has64BitPositions),
+        _skippedNodes(skippedNodes)
+    {}
+
+    void seek(size_t position) { _position = position; }
+    bool atEnd() const { return _position >= _data->size(); }
+
+    template <typename T>
+    T read() {
+        T value = fromLittleEndian<T>(require(sizeof(T)));
+        _position += sizeof(T);
+        return value;
+    }
+
+    // Returns false on the null record that ends a list of nodes.  Skipped nodes come back with only their name.
+    bool parseNode(FBXNode& node);
+
+private:
+    const char* require(size_t length) const {
+        if (_position > _data->size() || length > _data->size() - _position) {
+            throw QString("truncated fbx file");
         }
+        return _data->data() + _position;
     }
-    return QVariant::fromValue(values);
+
+    QVariant parseProperty();
+
+    template <typename T>
+    QVariant parseArrayProperty();
+
+    FBXDataPointer _data;
+    size_t _position { 0 };
+    bool _has64BitPositions;
+    const QSet<QByteArray>& _skippedNodes;
+};
+
+template <typename T>
+QVariant BinaryFBXParser::parseArrayProperty() {
+    FBXArrayProperty<T> array;
+    array.data = _data;
+    array.length = read<quint32>();
+    array.encoding = read<quint32>();
+    array.compressedLength = read<quint32>();
+    array.offset = _position;
+
+    size_t length = (array.encoding == FBX_PROPERTY_COMPRESSED_FLAG) ? array.compressedLength : (size_t)array.length * sizeof(T);
+    require(length);
+    _position += length;
+    return QVariant::fromValue(array);
 }
 
-QVariant parseBinaryFBXProperty(QDataStream& in, int& position) {
-    char ch;
-    in.device()->getChar(&ch);
-    position++;
+QVariant BinaryFBXParser::parseProperty() {
+    char ch = read<char>();
     switch (ch) {
-        case 'Y': {
-            qint16 value;
-            in >> value;
-            position += sizeof(qint16);
-            return QVariant::fromValue(value);
-        }
-        case 'C': {
-            bool value;
-            in >> value;
-            position++;
-            return QVariant::fromValue(value);
-        }
-        case 'I': {
-            qint32 value;
-            in >> value;
-            position += sizeof(qint32);
-            return QVariant::fromValue(value);
-        }
-        case 'F': {
-            float value;
-            in >> value;
-            position += sizeof(float);
-            return QVariant::fromValue(value);
-        }
-        case 'D': {
-            double value;
-            in >> value;
-            position += sizeof(double);
-            return QVariant::fromValue(value);
-        }
-        case 'L': {
-            qint64 value;
-            in >> value;
-            position += sizeof(qint64);
-            return QVariant::fromValue(value);
-        }
-        case 'f': {
-            return readBinaryArray<float>(in, position);
-        }
-        case 'd': {
-            return readBinaryArray<double>(in, position);
-        }
-        case 'l': {
-            return readBinaryArray<qint64>(in, position);
-        }
-        case 'i': {
-            return readBinaryArray<qint32>(in, position);
-        }
-        case 'b': {
-            return readBinaryArray<bool>(in, position);
-        }
+        case 'Y':
+            return QVariant::fromValue(read<qint16>());
+        case 'C':
+            return QVariant::fromValue(read<char>() != 0);
+        case 'I':
+            return QVariant::fromValue(read<qint32>());
+        case 'F':
+            return QVariant::fromValue(read<float>());
+        case 'D':
+            return QVariant::fromValue(read<double>());
+        case 'L':
+            return QVariant::fromValue(read<qint64>());
+        case 'f':
+            return parseArrayProperty<float>();
+        case 'd':
+            return parseArrayProperty<double>();
+        case 'l':
+            return parseArrayProperty<qint64>();
+        case 'i':
+            return parseArrayProperty<qint32>();
+        case 'b':
+            return parseArrayProperty<bool>();
         case 'S':
         case 'R': {
-            quint32 length;
-            in >> length;
-            position += sizeof(quint32) + length;
-            return QVariant::fromValue(in.device()->read(length));
+            quint32 length = read<quint32>();
+            QByteArray value(require(length), length);
+            _position += length;
+            return QVariant::fromValue(value);
         }
         default:
             throw QString("Unknown property type: ") + ch;
     }
 }
 
-FBXNode parseBinaryFBXNode(QDataStream& in, int& position, bool has64BitPositions = false) {
+bool BinaryFBXParser::parseNode(FBXNode& node) {
     qint64 endOffset;
     quint64 propertyCount;
-    quint64 propertyListLength;
-    quint8 nameLength;
 
     // FBX 2016 and beyond uses 64bit positions in the node headers, pre-2016 used 32bit values
-    // our code generally doesn't care about the size that much, so we will use 64bit values
-    // from here on out, but if the file is an older format we read the stream into temp 32bit 
-    // values and then assign to our actual 64bit values.
-    if (has64BitPositions) {
-        in >> endOffset;
-        in >> propertyCount;
-        in >> propertyListLength;
-        position += sizeof(quint64) * 3;
+    if (_has64BitPositions) {
+        endOffset = read<qint64>();
+        propertyCount = read<quint64>();
+        read<quint64>(); // property list length
     } else {
-        qint32 tempEndOffset;
-        quint32 tempPropertyCount;
-        quint32 tempPropertyListLength;
-        in >> tempEndOffset;
-        in >> tempPropertyCount;
-        in >> tempPropertyListLength;
-        position += sizeof(quint32) * 3;
-        endOffset = tempEndOffset;
-        propertyCount = tempPropertyCount;
-        propertyListLength = tempPropertyListLength;
-    }
-    in >> nameLength;
-    position += sizeof(quint8);
+        endOffset = read<qint32>();
+        propertyCount = read<quint32>();
+        read<quint32>(); // property list length
+    }
+    quint8 nameLength = read<quint8>();
 
-    FBXNode node;
     const int MIN_VALID_OFFSET = 40;
     if (endOffset < MIN_VALID_OFFSET || nameLength == 0) {
-        // use a null name to indicate a null node
-        return node;
+        return false;
     }
-    node.name = in.device()->read(nameLength);
-    position += nameLength;
+    node.name = QByteArray(require(nameLength), nameLength);
+    _position += nameLength;
 
-    for (quint32 i = 0; i < propertyCount; i++) {
-        node.properties.append(parseBinaryFBXProperty(in, position));
+    // skipped nodes seek to their end, one that isn't past their header would have us parse the same bytes forever
+    if ((size_t)endOffset < _position || (size_t)endOffset > _data->size()) {
+        throw QString("corrupt fbx file");
     }
 
-    while (endOffset > position) {
-        FBXNode child = parseBinaryFBXNode(in, position, has64BitPositions);
-        if (child.name.isNull()) {
-            return node;
+    if (_skippedNodes.contains(node.name)) {
+        seek((size_t)endOffset);
+        return true;
+    }
 
-        } else {
+    node.properties.reserve((int)propertyCount);
+    for (quint64 i = 0; i < propertyCount; i++) {
+        node.properties.append(parseProperty());
+    }
+
+    while ((size_t)endOffset > _position) {
+        FBXNode child;
+        if (!parseNode(child)) {
+            return true;
+        }
+        if (!_skippedNodes.contains(child.name)) {
             node.children.append(child);
         }
     }
 
-    return node;
+    return true;
+}
+
+static FBXNode parseBinaryFBX(const FBXDataPointer& data, const QSet<QByteArray>& skippedNodes) {
+    // see http://code.blender.org/index.php/2013/08/fbx-binary-file-format-specification/ for an explanation
+    // of the FBX binary format
+
+    // The first 27 bytes contain the header.
+    //   Bytes 0 - 20: Kaydara FBX Binary  \x00(file - magic, with 2 spaces at the end, then a NULL terminator).
+    //   Bytes 21 - 22: [0x1A, 0x00](unknown but all observed files show these bytes).
+    //   Bytes 23 - 26 : unsigned int, the version number. 7300 for version 7.3 for example.
+    if (data->size() < FBX_HEADER_BYTES_BEFORE_VERSION + sizeof(quint32)) {
+        throw QString("truncated fbx file");
+    }
+    quint32 fileVersion = fromLittleEndian<quint32>(data->data() + FBX_HEADER_BYTES_BEFORE_VERSION);
+    qCDebug(modelformat) << "fileVersion:" << fileVersion;
+    bool has64BitPositions = (fileVersion >= FBX_VERSION_2016);
+
+    BinaryFBXParser parser(data, has64BitPositions, skippedNodes);
+    parser.seek(FBX_HEADER_BYTES_BEFORE_VERSION + sizeof(fileVersion));
+
+    // parse the top-level node
+    FBXNode top;
+    while (!parser.atEnd()) {
+        FBXNode next;
+        if (!parser.parseNode(next)) {
+            break;
+        }
+        if (!skippedNodes.contains(next.name)) {
+            top.children.append(next);
+        }
+    }
+    return top;
 }
 
 class Tokenizer {
@@ -348,7 +479,7 @@ FBXNode parseTextFBXNode(Tokenizer& tokenizer) {
     return node;
 }
 
-FBXNode FBXReader::parseFBX(QIODevice* device) {
+FBXNode FBXReader::parseFBX(QIODevice* device, const QSet<QByteArray>& skippedNodes) {
     PROFILE_RANGE_EX(resource_parse, __FUNCTION__, 0xff0000ff, device);
     // verify the prolog
     if (device->peek(FBX_BINARY_PROLOG.size()) != FBX_BINARY_PROLOG) {
@@ -366,38 +497,20 @@ FBXNode FBXReader::parseFBX(QIODevice* device) {
         }
         return top;
     }
-    QDataStream in(device);
-    in.setByteOrder(QDataStream::LittleEndian);
-    in.setVersion(QDataStream::Qt_4_5); // for single/double precision switch
-
-    // see http://code.blender.org/index.php/2013/08/fbx-binary-file-format-specification/ for an explanation
-    // of the FBX binary format
 
-    // The first 27 bytes contain the header.
-    //   Bytes 0 - 20: Kaydara FBX Binary  \x00(file - magic, with 2 spaces at the end, then a NULL terminator).
-    //   Bytes 21 - 22: [0x1A, 0x00](unknown but all observed files show these bytes).
-    //   Bytes 23 - 26 : unsigned int, the version number. 7300 for version 7.3 for example.
-    in.skipRawData(FBX_HEADER_BYTES_BEFORE_VERSION);
-    int position = FBX_HEADER_BYTES_BEFORE_VERSION;
-    quint32 fileVersion;
-    in >> fileVersion;
-    position += sizeof(fileVersion);
-    qCDebug(modelformat) << "fileVersion:" << fileVersion;
-    bool has64BitPositions = (fileVersion >= FBX_VERSION_2016);
-
-    // parse the top-level node
-    FBXNode top;
-    while (device->bytesAvailable()) {
-        FBXNode next = parseBinaryFBXNode(in, position, has64BitPositions);
-        if (next.name.isNull()) {
-            return top;
+    return parseBinaryFBX(FBXData::fromDevice(device), skippedNodes);
+}
 
-        } else {
-            top.children.append(next);
-        }
+FBXNode FBXReader::parseFBX(const QByteArray& data, const QSet<QByteArray>& skippedNodes) {
+    if (!data.startsWith(FBX_BINARY_PROLOG)) {
+        QBuffer buffer;
+        buffer.setData(data);
+        buffer.open(QIODevice::ReadOnly);
+        return parseFBX(&buffer, skippedNodes);
     }
 
-    return top;
+    PROFILE_RANGE_EX(resource_parse, __FUNCTION__, 0xff0000ff, data.size());
+    return parseBinaryFBX(std::make_shared<FBXData>(data), skippedNodes);
 }
 
 
@@ -473,10 +586,11 @@ QVector<int> FBXReader::getIntVector(const FBXNode& node) {
     if (node.properties.isEmpty()) {
         return QVector<int>();
     }
-    QVector<int> vector = node.properties.at(0).value<QVector<int> >();
-    if (!vector.isEmpty()) {
-        return vector;
+    if (node.properties.at(0).canConvert<QVector<int> >()) {
+        // a binary array, which may well be empty
+        return node.properties.at(0).value<QVector<int> >();
     }
+    QVector<int> vector;
     for (int i = 0; i < node.properties.size(); i++) {
         vector.append(node.properties.at(i).toInt());
     }
@@ -492,10 +606,11 @@ QVector<float> FBXReader::getFloatVector(const FBXNode& node) {
     if (node.properties.isEmpty()) {
         return QVector<float>();
     }
-    QVector<float> vector = node.properties.at(0).value<QVector<float> >();
-    if (!vector.isEmpty()) {
-        return vector;
+    if (node.properties.at(0).canConvert<QVector<float> >()) {
+        // a binary array, which may well be empty
+        return node.properties.at(0).value<QVector<float> >();
     }
+    QVector<float> vector;
     for (int i = 0; i < node.properties.size(); i++) {
         vector.append(node.properties.at(i).toFloat());
     }
@@ -511,10 +626,11 @@ QVector<double> FBXReader::getDoubleVector(const FBXNode& node) {
     if (node.properties.isEmpty()) {
         return QVector<double>();
     }
-    QVector<double> vector = node.properties.at(0).value<QVector<double> >();
-    if (!vector.isEmpty()) {
-        return vector;
+    if (node.properties.at(0).canConvert<QVector<double> >()) {
+        // a binary array, which may well be empty
+        return node.properties.at(0).value<QVector<double> >();
     }
+    QVector<double> vector;
     for (int i = 0; i < node.properties.size(); i++) {
         vector.append(node.properties.at(i).toDouble());
     }
@@ -0,0 +1,624 @@
+//
+//  MeshOptimizer.cpp
+//  libraries/fbx/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QHash>
+
+#include "FBX.h"
+
+namespace mesh_optimizer {
+
+template <typename T>
+static void appendKey(QByteArray& key, const QVector<T>& values, int index) {
+    if (index < values.size()) {
+        key.append(reinterpret_cast<const char*>(&values[index]), sizeof(T));
+    }
+}
+
+template <typename T>
+static void compactValues(QVector<T>& values, const std::vector<int>& kept) {
+    if (values.isEmpty()) {
+        return;
+    }
+    QVector<T> compacted;
+    compacted.reserve((int)kept.size());
+    for (int index : kept) {
+        compacted.append(values.at(index));
+    }
+    values = compacted;
+}
+
+static void remapIndices(QVector<int>& indices, const std::vector<int>& remap) {
+    for (int& index : indices) {
+        index = remap[index];
+    }
+}
+
+void weldVertices(FBXMesh& mesh, bool keepOriginalIndices) {
+    int vertexCount = mesh.vertices.size();
+    QHash<QByteArray, int> uniqueVertices;
+    uniqueVertices.reserve(vertexCount);
+    std::vector<int> remap(vertexCount);
+    std::vector<int> kept;
+
+    QByteArray key;
+    for (int i = 0; i < vertexCount; i++) {
+        key.clear();
+        appendKey(key, mesh.vertices, i);
+        appendKey(key, mesh.normals, i);
+        appendKey(key, mesh.colors, i);
+        appendKey(key, mesh.texCoords, i);
+        appendKey(key, mesh.texCoords1, i);
+        if (keepOriginalIndices) {
+            appendKey(key, mesh.originalIndices, i);
+        }
+
+        auto it = uniqueVertices.find(key);
+        if (it == uniqueVertices.end()) {
+            it = uniqueVertices.insert(key, (int)kept.size());
+            kept.push_back(i);
+        }
+        remap[i] = it.value();
+    }
+
+    if ((int)kept.size() == vertexCount) {
+        return;
+    }
+
+    compactValues(mesh.vertices, kept);
+    compactValues(mesh.normals, kept);
+    compactValues(mesh.tangents, kept);
+    compactValues(mesh.colors, kept);
+    compactValues(mesh.texCoords, kept);
+    compactValues(mesh.texCoords1, kept);
+    compactValues(mesh.originalIndices, kept);
+
+    for (auto& part : mesh.parts) {
+        remapIndices(part.quadIndices, remap);
+        remapIndices(part.quadTrianglesIndices, remap);
+        remapIndices(part.triangleIndices, remap);
+    }
+}
+
+static int evalVertexCount(const QVector<int>& indices) {
+    return indices.isEmpty() ? 0 : *std::max_element(indices.begin(), indices.end()) + 1;
+}
+
+float evalACMR(const QVector<int>& indices, int cacheSize) {
+    int triangleCount = indices.size() / 3;
+    if (triangleCount == 0) {
+        return 0.0f;
+    }
+
+    // A vertex is still in the FIFO cache if fewer than cacheSize others went in after it
+    std::vector<int> cacheTime(evalVertexCount(indices), 0);
+    int time = cacheSize + 1;
+    int misses = 0;
+    for (int i = 0; i < triangleCount * 3; i++) {
+        int vertex = indices[i];
+        if (time - cacheTime[vertex] > cacheSize) {
+            cacheTime[vertex] = time++;
+            misses++;
+        }
+    }
+    return (float)misses / (float)triangleCount;
+}
+
+QVector<int> optimizeVertexCache(const QVector<int>& indices, int cacheSize) {
+    int triangleCount = indices.size() / 3;
+    if (triangleCount < 2) {
+        return indices;
+    }
+    int vertexCount = evalVertexCount(indices);
+
+    // The triangles around each vertex
+    std::vector<int> offsets(vertexCount + 1, 0);
+    for (int i = 0; i < triangleCount * 3; i++) {
+        offsets[indices[i] + 1]++;
+    }
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    std::vector<int> vertexTriangles(triangleCount * 3);
+    std::vector<int> fill(offsets.begin(), offsets.end() - 1);
+    for (int i = 0; i < triangleCount * 3; i++) {
+        vertexTriangles[fill[indices[i]]++] = i / 3;
+    }
+
+    std::vector<int> liveTriangles(vertexCount);
+    for (int i = 0; i < vertexCount; i++) {
+        liveTriangles[i] = offsets[i + 1] - offsets[i];
+    }
+    std::vector<int> cacheTime(vertexCount, 0);
+    std::vector<bool> isEmitted(triangleCount, false);
+    std::vector<int> deadEnd;
+    std::vector<int> candidates;
+
+    QVector<int> result;
+    result.reserve(triangleCount * 3);
+    int time = cacheSize + 1;
+    int cursor = 0;
+    int fanningVertex = indices[0];
+
+    while (fanningVertex >= 0) {
+        // Emit the whole fan around the vertex
+        candidates.clear();
+        for (int i = offsets[fanningVertex]; i < offsets[fanningVertex + 1]; i++) {
+            int triangle = vertexTriangles[i];
+            if (isEmitted[triangle]) {
+                continue;
+            }
+            isEmitted[triangle] = true;
+            for (int j = 0; j < 3; j++) {
+                int vertex = indices[triangle * 3 + j];
+                result.append(vertex);
+                deadEnd.push_back(vertex);
+                candidates.push_back(vertex);
+                liveTriangles[vertex]--;
+                if (time - cacheTime[vertex] > cacheSize) {
+                    cacheTime[vertex] = time++;
+                }
+            }
+        }
+
+        // Fan next around the oldest vertex that would still be in the cache once its own fan is out
+        int nextVertex = -1;
+        int bestPriority = -1;
+        for (int vertex : candidates) {
+            if (liveTriangles[vertex] == 0) {
+                continue;
+            }
+            int priority = 0;
+            if (time - cacheTime[vertex] + 2 * liveTriangles[vertex] <= cacheSize) {
+                priority = time - cacheTime[vertex];
+            }
+            if (priority > bestPriority) {
+                bestPriority = priority;
+                nextVertex = vertex;
+            }
+        }
+
+        // Out of neighbours, go back through the recently used vertices, then through the rest in order
+        while (nextVertex < 0 && !deadEnd.empty()) {
+            int vertex = deadEnd.back();
+            deadEnd.pop_back();
+            if (liveTriangles[vertex] > 0) {
+                nextVertex = vertex;
+            }
+        }
+        if (nextVertex < 0) {
+            while (cursor < vertexCount && liveTriangles[cursor] == 0) {
+                cursor++;
+            }
+            if (cursor < vertexCount) {
+                nextVertex = cursor;
+            }
+        }
+        fanningVertex = nextVertex;
+    }
+
+    return result;
+}
+
+QVector<int> optimizeOverdraw(const QVector<int>& indices, const QVector<glm::vec3>& positions, int cacheSize, float threshold) {
+    int triangleCount = indices.size() / 3;
+    if (triangleCount < 2) {
+        return indices;
+    }
+
+    // Runs start where all three vertices of a triangle miss the cache, moving them around costs next to nothing
+    std::vector<int> runStarts;
+    std::vector<int> cacheTime(evalVertexCount(indices), 0);
+    int time = cacheSize + 1;
+    for (int i = 0; i < triangleCount; i++) {
+        int misses = 0;
+        for (int j = 0; j < 3; j++) {
+            int vertex = indices[i * 3 + j];
+            if (time - cacheTime[vertex] > cacheSize) {
+                cacheTime[vertex] = time++;
+                misses++;
+            }
+        }
+        if (i == 0 || misses == 3) {
+            runStarts.push_back(i);
+        }
+    }
+    if (runStarts.size() < 2) {
+        return indices;
+    }
+    runStarts.push_back(triangleCount);
+
+    // Area weighted centroids and normals
+    struct Run {
+        int start;
+        int end;
+        glm::vec3 centroid;
+        glm::vec3 normal;
+        float sortKey;
+    };
+    std::vector<Run> runs;
+    runs.reserve(runStarts.size() - 1);
+    glm::vec3 meshCentroid { 0.0f };
+    float meshArea = 0.0f;
+    for (size_t i = 0; i + 1 < runStarts.size(); i++) {
+        Run run { runStarts[i], runStarts[i + 1], glm::vec3(0.0f), glm::vec3(0.0f), 0.0f };
+        float runArea = 0.0f;
+        for (int j = run.start; j < run.end; j++) {
+            const glm::vec3& p0 = positions[indices[j * 3]];
+            const glm::vec3& p1 = positions[indices[j * 3 + 1]];
+            const glm::vec3& p2 = positions[indices[j * 3 + 2]];
+            glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+            float area = glm::length(normal);
+            run.normal += normal;
+            run.centroid += area * (p0 + p1 + p2) / 3.0f;
+            runArea += area;
+        }
+        if (runArea > 0.0f) {
+            meshCentroid += run.centroid;
+            meshArea += runArea;
+            run.centroid /= runArea;
+        }
+        runs.push_back(run);
+    }
+    if (meshArea > 0.0f) {
+        meshCentroid /= meshArea;
+    }
+    for (auto& run : runs) {
+        float normalLength = glm::length(run.normal);
+        run.sortKey = (normalLength > 0.0f) ? glm::dot(run.centroid - meshCentroid, run.normal / normalLength) : 0.0f;
+    }
+    std::stable_sort(runs.begin(), runs.end(), [](const Run& a, const Run& b) {
+        return a.sortKey > b.sortKey;
+    });
+
+    QVector<int> result;
+    result.reserve(indices.size());
+    for (const auto& run : runs) {
+        result.append(indices.mid(run.start * 3, (run.end - run.start) * 3));
+    }
+
+    if (evalACMR(result, cacheSize) > threshold * evalACMR(indices, cacheSize)) {
+        return indices;
+    }
+    return result;
+}
+
+// Sum of the squared distances to a set of planes, weighted by the area of the triangles they come from
+struct Quadric {
+    double a2 { 0.0 }, ab { 0.0 }, ac { 0.0 }, ad { 0.0 };
+    double b2 { 0.0 }, bc { 0.0 }, bd { 0.0 };
+    double c2 { 0.0 }, cd { 0.0 };
+    double d2 { 0.0 };
+    double weight { 0.0 };
+
+    void addPlane(const glm::dvec3& n, double d, double w) {
+        a2 += w * n.x * n.x; ab += w * n.x * n.y; ac += w * n.x * n.z; ad += w * n.x * d;
+        b2 += w * n.y * n.y; bc += w * n.y * n.z; bd += w * n.y * d;
+        c2 += w * n.z * n.z; cd += w * n.z * d;
+        d2 += w * d * d;
+        weight += w;
+    }
+
+    Quadric& operator+=(const Quadric& other) {
+        a2 += other.a2; ab += other.ab; ac += other.ac; ad += other.ad;
+        b2 += other.b2; bc += other.bc; bd += other.bd;
+        c2 += other.c2; cd += other.cd;
+        d2 += other.d2;
+        weight += other.weight;
+        return *this;
+    }
+
+    // Mean squared distance of the point to the planes
+    double eval(const glm::vec3& p) const {
+        double x = p.x, y = p.y, z = p.z;
+        double sum = a2 * x * x + 2.0 * ab * x * y + 2.0 * ac * x * z + 2.0 * ad * x +
+            b2 * y * y + 2.0 * bc * y * z + 2.0 * bd * y +
+            c2 * z * z + 2.0 * cd * z + d2;
+        return (weight > 0.0) ? std::max(sum / weight, 0.0) : 0.0;
+    }
+};
+
+class Simplifier {
+public:
+    Simplifier(const QVector<QVector<int>>& parts, const QVector<glm::vec3>& positions);
+
+    int getTriangleCount() const { return _liveTriangleCount; }
+    float getError() const { return (float)std::sqrt(_maxCost); }
+
+    // Collapses edges until there are no more than targetTriangleCount triangles left, or nothing left to collapse
+    void simplify(int targetTriangleCount);
+
+    QVector<QVector<int>> getParts() const;
+
+private:
+    struct Collapse {
+        double cost;
+        int from;
+        int to;
+        uint32_t version;
+        bool operator<(const Collapse& other) const { return cost > other.cost; }
+    };
+
+    void queueCollapse(int vertex);
+    bool isCollapseValid(int from, int to) const;
+    void collapse(int from, int to);
+
+    const QVector<glm::vec3>& _positions;
+    int _partCount;
+    std::vector<int> _corners;
+    std::vector<int> _triangleParts;
+    std::vector<bool> _isTriangleLive;
+    int _liveTriangleCount { 0 };
+
+    std::vector<std::vector<int>> _vertexTriangles;
+    std::vector<Quadric> _quadrics;
+    std::vector<bool> _isLocked;
+    std::vector<bool> _isRemoved;
+    std::vector<uint32_t> _versions;
+    std::priority_queue<Collapse> _queue;
+    double _maxCost { 0.0 };
+};
+
+static uint64_t makeEdgeKey(int a, int b) {
+    return ((uint64_t)std::min(a, b) << 32) | (uint32_t)std::max(a, b);
+}
+
+Simplifier::Simplifier(const QVector<QVector<int>>& parts, const QVector<glm::vec3>& positions) :
+    _positions(positions),
+    _partCount(parts.size())
+{
+    int vertexCount = positions.size();
+    for (int i = 0; i < parts.size(); i++) {
+        const auto& indices = parts[i];
+        for (int j = 0; j + 2 < indices.size(); j += 3) {
+            _corners.push_back(indices[j]);
+            _corners.push_back(indices[j + 1]);
+            _corners.push_back(indices[j + 2]);
+            _triangleParts.push_back(i);
+        }
+    }
+    int triangleCount = (int)_triangleParts.size();
+    _liveTriangleCount = triangleCount;
+    _isTriangleLive.assign(triangleCount, true);
+
+    _vertexTriangles.resize(vertexCount);
+    _quadrics.resize(vertexCount);
+    _isLocked.assign(vertexCount, false);
+    _isRemoved.assign(vertexCount, false);
+    _versions.assign(vertexCount, 0);
+
+    // Vertices split along attribute seams share a position, they're kept where they are
+    QHash<QByteArray, int> positionGroups;
+    std::vector<int> vertexGroups(vertexCount);
+    std::vector<int> groupSizes;
+    for (int i = 0; i < vertexCount; i++) {
+        QByteArray key(reinterpret_cast<const char*>(&positions[i]), sizeof(glm::vec3));
+        auto it = positionGroups.find(key);
+        if (it == positionGroups.end()) {
+            it = positionGroups.insert(key, (int)groupSizes.size());
+            groupSizes.push_back(0);
+        }
+        vertexGroups[i] = it.value();
+        groupSizes[it.value()]++;
+    }
+
+    // So are vertices of more than one part, and those on an edge that doesn't have exactly two triangles
+    std::vector<int> vertexParts(vertexCount, -1);
+    std::vector<bool> isGroupLocked(groupSizes.size(), false);
+    std::unordered_map<uint64_t, int> edgeTriangleCounts;
+    for (int i = 0; i < triangleCount; i++) {
+        for (int j = 0; j < 3; j++) {
+            int vertex = _corners[i * 3 + j];
+            _vertexTriangles[vertex].push_back(i);
+            if (vertexParts[vertex] == -1) {
+                vertexParts[vertex] = _triangleParts[i];
+            } else if (vertexParts[vertex] != _triangleParts[i]) {
+                _isLocked[vertex] = true;
+            }
+
+            int group = vertexGroups[vertex];
+            int nextGroup = vertexGroups[_corners[i * 3 + (j + 1) % 3]];
+            if (group != nextGroup) {
+                edgeTriangleCounts[makeEdgeKey(group, nextGroup)]++;
+            }
+        }
+
+        const glm::vec3& p0 = positions[_corners[i * 3]];
+        const glm::vec3& p1 = positions[_corners[i * 3 + 1]];
+        const glm::vec3& p2 = positions[_corners[i * 3 + 2]];
+        glm::dvec3 normal = glm::cross(glm::dvec3(p1 - p0), glm::dvec3(p2 - p0));
+        double doubleArea = glm::length(normal);
+        if (doubleArea > 0.0) {
+            normal /= doubleArea;
+            double distance = -glm::dot(normal, glm::dvec3(p0));
+            for (int j = 0; j < 3; j++) {
+                _quadrics[_corners[i * 3 + j]].addPlane(normal, distance, 0.5 * doubleArea);
+            }
+        }
+    }
+    for (const auto& edge : edgeTriangleCounts) {
+        if (edge.second != 2) {
+            isGroupLocked[(int)(edge.first >> 32)] = true;
+            isGroupLocked[(int)(edge.first & 0xffffffff)] = true;
+        }
+    }
+    for (int i = 0; i < vertexCount; i++) {
+        if (groupSizes[vertexGroups[i]] > 1 || isGroupLocked[vertexGroups[i]]) {
+            _isLocked[i] = true;
+        }
+    }
+
+    for (int i = 0; i < vertexCount; i++) {
+        queueCollapse(i);
+    }
+}
+
+bool Simplifier::isCollapseValid(int from, int to) const {
+    // None of the remaining triangles may flip or turn too far
+    const float MIN_NORMAL_DOT = 0.25f;
+    const glm::vec3& target = _positions[to];
+    for (int triangle : _vertexTriangles[from]) {
+        if (!_isTriangleLive[triangle]) {
+            continue;
+        }
+        const int* corners = &_corners[triangle * 3];
+        if (corners[0] == to || corners[1] == to || corners[2] == to) {
+            continue;
+        }
+        glm::vec3 p[3] = { _positions[corners[0]], _positions[corners[1]], _positions[corners[2]] };
+        glm::vec3 oldNormal = glm::cross(p[1] - p[0], p[2] - p[0]);
+        for (int j = 0; j < 3; j++) {
+            if (corners[j] == from) {
+                p[j] = target;
+            }
+        }
+        glm::vec3 newNormal = glm::cross(p[1] - p[0], p[2] - p[0]);
+        float oldLength = glm::length(oldNormal);
+        float newLength = glm::length(newNormal);
+        if (newLength == 0.0f || (oldLength > 0.0f && glm::dot(oldNormal, newNormal) < MIN_NORMAL_DOT * oldLength * newLength)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void Simplifier::queueCollapse(int vertex) {
+    if (_isLocked[vertex] || _isRemoved[vertex]) {
+        return;
+    }
+
+    // Onto the neighbour that moves the surface the least
+    Collapse best { std::numeric_limits<double>::max(), vertex, -1, _versions[vertex] };
+    for (int triangle : _vertexTriangles[vertex]) {
+        if (!_isTriangleLive[triangle]) {
+            continue;
+        }
+        for (int j = 0; j < 3; j++) {
+            int neighbour = _corners[triangle * 3 + j];
+            if (neighbour == vertex) {
+                continue;
+            }
+            Quadric quadric = _quadrics[vertex];
+            quadric += _quadrics[neighbour];
+            double cost = quadric.eval(_positions[neighbour]);
+            if (cost < best.cost && isCollapseValid(vertex, neighbour)) {
+                best.cost = cost;
+                best.to = neighbour;
+            }
+        }
+    }
+    if (best.to >= 0) {
+        _queue.push(best);
+    }
+}
+
+void Simplifier::collapse(int from, int to) {
+    for (int triangle : _vertexTriangles[from]) {
+        if (!_isTriangleLive[triangle]) {
+            continue;
+        }
+        int* corners = &_corners[triangle * 3];
+        if (corners[0] == to || corners[1] == to || corners[2] == to) {
+            _isTriangleLive[triangle] = false;
+            _liveTriangleCount--;
+            continue;
+        }
+        for (int j = 0; j < 3; j++) {
+            if (corners[j] == from) {
+                corners[j] = to;
+            }
+        }
+        _vertexTriangles[to].push_back(triangle);
+    }
+    _vertexTriangles[from].clear();
+    _quadrics[to] += _quadrics[from];
+    _isRemoved[from] = true;
+
+    // Everything around the target has to find its best collapse again
+    std::vector<int> neighbours { to };
+    for (int triangle : _vertexTriangles[to]) {
+        if (_isTriangleLive[triangle]) {
+            neighbours.insert(neighbours.end(), &_corners[triangle * 3], &_corners[triangle * 3] + 3);
+        }
+    }
+    std::sort(neighbours.begin(), neighbours.end());
+    neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+    for (int vertex : neighbours) {
+        _versions[vertex]++;
+        queueCollapse(vertex);
+    }
+}
+
+void Simplifier::simplify(int targetTriangleCount) {
+    while (_liveTriangleCount > targetTriangleCount && !_queue.empty()) {
+        Collapse next = _queue.top();
+        _queue.pop();
+        if (_isRemoved[next.from] || _isRemoved[next.to] || next.version != _versions[next.from]) {
+            continue;
+        }
+        _maxCost = std::max(_maxCost, next.cost);
+        collapse(next.from, next.to);
+    }
+}
+
+QVector<QVector<int>> Simplifier::getParts() const {
+    QVector<QVector<int>> parts(_partCount);
+    for (int i = 0; i < (int)_triangleParts.size(); i++) {
+        if (_isTriangleLive[i]) {
+            auto& indices = parts[_triangleParts[i]];
+            indices.append(_corners[i * 3]);
+            indices.append(_corners[i * 3 + 1]);
+            indices.append(_corners[i * 3 + 2]);
+        }
+    }
+    return parts;
+}
+
+QVector<LOD> generateLODs(const QVector<QVector<int>>& parts, const QVector<glm::vec3>& positions) {
+    // A level that doesn't save at least this much isn't worth its indices
+    const float MAX_USEFUL_TRIANGLE_RATIO = 0.8f;
+
+    QVector<LOD> lods;
+    Simplifier simplifier(parts, positions);
+    int triangleCount = simplifier.getTriangleCount();
+    if (triangleCount < MIN_LOD_TRIANGLES) {
+        return lods;
+    }
+
+    for (int level = 0; level < MAX_LOD_LEVELS; level++) {
+        int targetTriangleCount = (int)(triangleCount * LOD_TRIANGLE_RATIO);
+        simplifier.simplify(targetTriangleCount);
+        int levelTriangleCount = simplifier.getTriangleCount();
+        if (levelTriangleCount > triangleCount * MAX_USEFUL_TRIANGLE_RATIO || levelTriangleCount == 0) {
+            break;
+        }
+
+        LOD lod;
+        lod.error = simplifier.getError();
+        lod.parts = simplifier.getParts();
+        lods.append(lod);
+
+        triangleCount = levelTriangleCount;
+        if (triangleCount < MIN_LOD_TRIANGLES) {
+            break;
+        }
+    }
+    return lods;
+}
+
+}
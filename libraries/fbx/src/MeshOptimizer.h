@@ -0,0 +1,61 @@
+//
+//  MeshOptimizer.h
+//  libraries/fbx/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_MeshOptimizer_h
+#define hifi_MeshOptimizer_h
+
+#include <QtCore/QVector>
+
+#include <glm/glm.hpp>
+
+class FBXMesh;
+
+// Triangle lists are index triples into the vertices of one mesh.
+namespace mesh_optimizer {
+
+    // Entries in the post transform cache of the gpus we aim at, most hold 16 to 32
+    static const int DEFAULT_CACHE_SIZE = 16;
+
+    // Merges the vertices whose attributes are all the same and points the part indices at them, the FBX extraction
+    // gives every polygon corner its own.  Original indices only tell vertices apart when they're kept for the deformers.
+    // Goes before the clusters and blendshapes are resolved, which index the vertices too.
+    void weldVertices(FBXMesh& mesh, bool keepOriginalIndices);
+
+    // Average number of vertices transformed per triangle with a FIFO cache of cacheSize, from 0.5 to 3
+    float evalACMR(const QVector<int>& indices, int cacheSize = DEFAULT_CACHE_SIZE);
+
+    // Reorders the triangles so the following ones reuse the vertices still in the cache (Tipsify, Sander et al. 2007)
+    QVector<int> optimizeVertexCache(const QVector<int>& indices, int cacheSize = DEFAULT_CACHE_SIZE);
+
+    // Reorders the runs of a cache optimized list between cache flushes so those facing away from the middle of the
+    // mesh come first, they hide the others from most directions.  Keeps the order it's given if that would cost more
+    // than threshold times its ACMR.
+    QVector<int> optimizeOverdraw(const QVector<int>& indices, const QVector<glm::vec3>& positions,
+                                  int cacheSize = DEFAULT_CACHE_SIZE, float threshold = 1.05f);
+
+    // A simplified version of all the parts of a mesh, using a subset of its vertices
+    struct LOD {
+        float error { 0.0f }; // in mesh units, the largest RMS distance of a removed vertex to the triangles it merged
+        QVector<QVector<int>> parts;
+    };
+
+    static const int MAX_LOD_LEVELS = 3;
+    static const float LOD_TRIANGLE_RATIO = 0.5f;
+    static const int MIN_LOD_TRIANGLES = 64;
+
+    // Collapses edges by quadric error (Garland and Heckbert 1997) onto existing vertices, so the levels draw with the
+    // vertex buffer of the full mesh.  Each level has at most LOD_TRIANGLE_RATIO of the triangles of the one before.
+    // Vertices on open borders, attribute seams and between parts don't move, so levels that can't lose enough
+    // triangles that way are left out, as are meshes with fewer than MIN_LOD_TRIANGLES.
+    QVector<LOD> generateLODs(const QVector<QVector<int>>& parts, const QVector<glm::vec3>& positions);
+
+}
+
+#endif // hifi_MeshOptimizer_h
@@ -321,21 +321,36 @@ void GLVariableAllocationSupport::addMemoryManagedTexture(const TexturePointer&
     }
 }
 
+// Textures the renderer has drawn before but not lately are the first to give up memory and the last to get it back
+static const float OFF_SCREEN_PRIORITY_SCALE = 1000.0f;
+
+static bool isOffScreen(const Texture& texture) {
+    return texture.hasUsage() && texture.getUsageScreenSize() == 0.0f;
+}
+
 void GLVariableAllocationSupport::addToWorkQueue(const TexturePointer& texturePointer) {
     GLTexture* gltexture = Backend::getGPUObject<GLTexture>(*texturePointer);
     GLVariableAllocationSupport* vargltexture = dynamic_cast<GLVariableAllocationSupport*>(gltexture);
     switch (_memoryPressureState) {
         case MemoryPressureState::Oversubscribed:
             if (vargltexture->canDemote()) {
-                // Demote largest first
-                _demoteQueue.push({ texturePointer, (float)gltexture->size() });
+                // Demote off screen, then largest first
+                float priority = (float)gltexture->size();
+                if (isOffScreen(*texturePointer)) {
+                    priority *= OFF_SCREEN_PRIORITY_SCALE;
+                }
+                _demoteQueue.push({ texturePointer, priority });
             }
             break;
 
         case MemoryPressureState::Undersubscribed:
             if (vargltexture->canPromote()) {
-                // Promote smallest first
-                _promoteQueue.push({ texturePointer, 1.0f / (float)gltexture->size() });
+                // Promote smallest first, off screen last
+                float priority = 1.0f / (float)gltexture->size();
+                if (isOffScreen(*texturePointer)) {
+                    priority /= OFF_SCREEN_PRIORITY_SCALE;
+                }
+                _promoteQueue.push({ texturePointer, priority });
             }
             break;
 
@@ -22,6 +22,7 @@
 
 #include <ktx/KTX.h>
 #include <NumericalConstants.h>
+#include <SharedUtil.h>
 
 #include "GPULogging.h"
 #include "Context.h"
@@ -922,6 +923,32 @@ Texture::ExternalUpdates Texture::getUpdates() const {
     return result;
 }
 
+static const uint64_t TEXTURE_USAGE_PERIOD_USECS = USECS_PER_SECOND;
+
+void Texture::noteUsage(float screenSize) {
+    uint64_t now = usecTimestampNow();
+    uint64_t periodStart = _usagePeriodStart.load(std::memory_order_relaxed);
+    if (now - periodStart > TEXTURE_USAGE_PERIOD_USECS) {
+        // Keep the last period's size around so the reported size doesn't collapse at every period boundary
+        bool lastPeriodWasUsed = now - periodStart <= 2 * TEXTURE_USAGE_PERIOD_USECS;
+        float previous = lastPeriodWasUsed ? _usageScreenSize.load(std::memory_order_relaxed) : 0.0f;
+        _previousUsageScreenSize.store(previous, std::memory_order_relaxed);
+        _usageScreenSize.store(screenSize, std::memory_order_relaxed);
+        _usagePeriodStart.store(now, std::memory_order_relaxed);
+    } else if (screenSize > _usageScreenSize.load(std::memory_order_relaxed)) {
+        _usageScreenSize.store(screenSize, std::memory_order_relaxed);
+    }
+    _lastUsage.store(now, std::memory_order_relaxed);
+}
+
+float Texture::getUsageScreenSize() const {
+    uint64_t lastUsage = _lastUsage.load(std::memory_order_relaxed);
+    if (lastUsage == 0 || usecTimestampNow() - lastUsage > 2 * TEXTURE_USAGE_PERIOD_USECS) {
+        return 0.0f;
+    }
+    return std::max(_usageScreenSize.load(std::memory_order_relaxed), _previousUsageScreenSize.load(std::memory_order_relaxed));
+}
+
 void Texture::setStorage(std::unique_ptr<Storage>& newStorage) {
     _storage.swap(newStorage);
 }
@@ -12,6 +12,7 @@
 #define hifi_gpu_Texture_h
 
 #include <algorithm> //min max and more
+#include <atomic>
 #include <bitset>
 
 #include <QMetaType>
@@ -552,6 +553,13 @@ public:
     void setFallbackTexture(const TexturePointer& fallback) { _fallback = fallback; }
     TexturePointer getFallbackTexture() const { return _fallback.lock(); }
 
+    // Streaming feedback from the renderer.  noteUsage records the size, in pixels on screen, the texture is drawn at,
+    // and getUsageScreenSize returns the largest size seen over the last second or so, 0 once it's off screen.
+    // Textures the renderer doesn't report on (hasUsage() is false) have no way of telling either.
+    void noteUsage(float screenSize);
+    float getUsageScreenSize() const;
+    bool hasUsage() const { return _lastUsage.load(std::memory_order_relaxed) != 0; }
+
     void setExternalTexture(uint32 externalId, void* externalFence);
     void setExternalRecycler(const ExternalRecycler& recycler);
     ExternalRecycler getExternalRecycler() const;
@@ -581,6 +589,12 @@ protected:
 
 
     std::weak_ptr<Texture> _fallback;
+
+    // Written by the render thread and read by everyone else, only ever a hint so relaxed ordering is enough
+    std::atomic<uint64_t> _lastUsage { 0 };
+    std::atomic<uint64_t> _usagePeriodStart { 0 };
+    std::atomic<float> _usageScreenSize { 0.0f };
+    std::atomic<float> _previousUsageScreenSize { 0.0f };
     // Not strictly necessary, but incredibly useful for debugging
     std::string _source;
     std::string _sourceHash;
@@ -11,9 +11,15 @@
 
 #include "Image.h"
 
+#include <condition_variable>
+#include <mutex>
+
 #include <glm/gtc/packing.hpp>
 
 #include <QtCore/QtGlobal>
+#include <QtCore/QRunnable>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
 #include <QUrl>
 #include <QImage>
 #include <QBuffer>
@@ -24,6 +30,7 @@
 #include <StatTracker.h>
 #include <GLMHelpers.h>
 
+#include "ImageKernels.h"
 #include "ImageLogging.h"
 
 using namespace gpu;
@@ -43,6 +50,7 @@ static std::atomic<bool> compressColorTextures { false };
 static std::atomic<bool> compressNormalTextures { false };
 static std::atomic<bool> compressGrayscaleTextures { false };
 static std::atomic<bool> compressCubeTextures { false };
+static std::atomic<int> textureProcessingThreadCount { 0 };
 
 uint rectifyDimension(const uint& dimension) {
     if (dimension == 0) {
@@ -219,23 +227,93 @@ void setCubeTexturesCompressionEnabled(bool enabled) {
     compressCubeTextures.store(enabled);
 }
 
-static float denormalize(float value, const float minValue) {
-    return value < minValue ? 0.0f : value;
+void setTextureProcessingThreadCount(int count) {
+    textureProcessingThreadCount.store(std::max(count, 0));
+}
+
+int getTextureProcessingThreadCount() {
+    int count = textureProcessingThreadCount.load();
+    return (count > 0) ? count : std::max(QThread::idealThreadCount(), 1);
 }
 
-uint32 packR11G11B10F(const glm::vec3& color) {
-    // Denormalize else unpacking gives high and incorrect values
-    // See https://www.khronos.org/opengl/wiki/Small_Float_Formats for this min value
-    static const auto minValue = 6.10e-5f;
-    static const auto maxValue = 6.50e4f;
-    glm::vec3 ucolor;
-    ucolor.r = denormalize(color.r, minValue);
-    ucolor.g = denormalize(color.g, minValue);
-    ucolor.b = denormalize(color.b, minValue);
-    ucolor.r = std::min(ucolor.r, maxValue);
-    ucolor.g = std::min(ucolor.g, maxValue);
-    ucolor.b = std::min(ucolor.b, maxValue);
-    return glm::packF2x11_1x10(ucolor);
+// Kept apart from the global pool, which the texture loads themselves run on
+static QThreadPool* getTextureProcessingThreadPool() {
+    static QThreadPool pool;
+    return &pool;
+}
+
+// Work shared by the threads of one parallelFor.  Helpers that only get to run once it's all done find nothing
+// left to grab, so they hold on to it rather than to the caller's stack.
+struct ParallelWork {
+    std::function<void(int)> task;
+    const std::atomic<bool>* abortProcessing;
+    int count;
+    int batchSize;
+    std::atomic<int> next { 0 };
+    std::atomic<int> remaining { 0 };
+    std::mutex mutex;
+    std::condition_variable finished;
+
+    void run() {
+        int begin;
+        while ((begin = next.fetch_add(batchSize)) < count) {
+            int end = std::min(begin + batchSize, count);
+            for (int i = begin; i < end; ++i) {
+                if (!abortProcessing->load(std::memory_order_relaxed)) {
+                    task(i);
+                }
+            }
+            if (remaining.fetch_sub(end - begin) == end - begin) {
+                std::lock_guard<std::mutex> lock(mutex);
+                finished.notify_all();
+            }
+        }
+    }
+};
+
+class ParallelWorkRunnable : public QRunnable {
+public:
+    ParallelWorkRunnable(const std::shared_ptr<ParallelWork>& work) : _work(work) {}
+    void run() override { _work->run(); }
+
+private:
+    std::shared_ptr<ParallelWork> _work;
+};
+
+// Runs task(0) to task(count - 1) on the texture processing pool and returns once they are all done.  The calling
+// thread grabs tasks too, so a parallelFor nested in another one (the blocks of a face while the faces of a cube are
+// compressed in parallel) always makes progress even when every pool thread is busy.  Tasks not started yet are
+// skipped once abortProcessing is set.
+static void parallelFor(int count, const std::atomic<bool>& abortProcessing, std::function<void(int)> task) {
+    int numHelpers = std::min(getTextureProcessingThreadCount(), count) - 1;
+    if (numHelpers <= 0) {
+        for (int i = 0; i < count && !abortProcessing.load(); ++i) {
+            task(i);
+        }
+        return;
+    }
+
+    auto pool = getTextureProcessingThreadPool();
+    if (pool->maxThreadCount() != getTextureProcessingThreadCount() - 1) {
+        pool->setMaxThreadCount(getTextureProcessingThreadCount() - 1);
+    }
+
+    auto work = std::make_shared<ParallelWork>();
+    work->task = std::move(task);
+    work->abortProcessing = &abortProcessing;
+    work->count = count;
+    // nvtt hands out single blocks, grabbing a few at a time keeps the threads off each other's cache lines
+    const int BATCHES_PER_THREAD = 8;
+    work->batchSize = std::max(count / ((numHelpers + 1) * BATCHES_PER_THREAD), 1);
+    work->remaining = count;
+
+    for (int i = 0; i < numHelpers; ++i) {
+        pool->start(new ParallelWorkRunnable(work));
+    }
+    work->run();
+
+    std::unique_lock<std::mutex> lock(work->mutex);
+    work->finished.wait(lock, [&] { return work->remaining.load() == 0; });
 }
 
 QImage processRawImageData(QByteArray&& content, const std::string& filename) {
@@ -269,6 +347,17 @@ QImage processRawImageData(QByteArray&& content, const std::string& filename) {
     return QImage();
 }
 
+static ColorSpace getColorSpaceForType(TextureUsage::Type textureType) {
+    switch (textureType) {
+        case TextureUsage::NORMAL_TEXTURE:
+            return ColorSpace::NORMAL_MAP;
+        case TextureUsage::BUMP_TEXTURE:
+            return ColorSpace::LINEAR;
+        default:
+            return ColorSpace::GAMMA;
+    }
+}
+
 gpu::TexturePointer processImage(QByteArray&& content, const std::string& filename,
                                  int maxNumPixels, TextureUsage::Type textureType,
                                  const std::atomic<bool>& abortProcessing) {
@@ -292,7 +381,7 @@ gpu::TexturePointer processImage(QByteArray&& content, const std::string& filena
         int originalHeight = imageHeight;
         imageWidth = (int)(scaleFactor * (float)imageWidth + 0.5f);
         imageHeight = (int)(scaleFactor * (float)imageHeight + 0.5f);
-        image = image.scaled(QSize(imageWidth, imageHeight), Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        image = resizeImage(image, imageWidth, imageHeight, getColorSpaceForType(textureType));
         qCDebug(imagelogging).nospace() << "Downscaled " << filename.c_str() << " (" <<
             QSize(originalWidth, originalHeight) << " to " <<
             QSize(imageWidth, imageHeight) << ")";
@@ -304,7 +393,7 @@ gpu::TexturePointer processImage(QByteArray&& content, const std::string& filena
     return texture;
 }
 
-QImage processSourceImage(QImage&& srcImage, bool cubemap) {
+QImage processSourceImage(QImage&& srcImage, bool cubemap, ColorSpace colorSpace) {
     PROFILE_RANGE(resource_parse, "processSourceImage");
 
     // Take a local copy to force move construction
@@ -336,7 +425,7 @@ QImage processSourceImage(QImage&& srcImage, bool cubemap) {
     if (targetSize != srcImageSize) {
         PROFILE_RANGE(resource_parse, "processSourceImage Rectify");
         qCDebug(imagelogging) << "Resizing texture from " << srcImageSize.x << "x" << srcImageSize.y << " to " << targetSize.x << "x" << targetSize.y;
-        return localCopy.scaled(fromGlm(targetSize), Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        return resizeImage(localCopy, targetSize.x, targetSize.y, colorSpace);
     }
 
     return localCopy;
@@ -344,7 +433,8 @@ QImage processSourceImage(QImage&& srcImage, bool cubemap) {
 
 #if defined(NVTT_API)
 struct OutputHandler : public nvtt::OutputHandler {
-    OutputHandler(gpu::Texture* texture, int face) : _texture(texture), _face(face) {}
+    OutputHandler(gpu::Texture* texture, int face, std::mutex* textureMutex = nullptr) :
+        _texture(texture), _face(face), _textureMutex(textureMutex) {}
 
     virtual void beginImage(int size, int width, int height, int depth, int face, int miplevel) override {
         _size = size;
@@ -362,13 +452,20 @@ struct OutputHandler : public nvtt::OutputHandler {
     }
 
     virtual void endImage() override {
+        storage::StoragePointer storage = std::make_shared<storage::MemoryStorage>(_size, static_cast<const gpu::Byte*>(_data));
+        free(_data);
+        _data = nullptr;
+
+        // the texture's storage isn't thread safe, mips and faces compressed in parallel take turns
+        std::unique_lock<std::mutex> lock;
+        if (_textureMutex) {
+            lock = std::unique_lock<std::mutex>(*_textureMutex);
+        }
         if (_face >= 0) {
-            _texture->assignStoredMipFace(_miplevel, _face, _size, static_cast<const gpu::Byte*>(_data));
+            _texture->assignStoredMipFace(_miplevel, _face, storage);
         } else {
-            _texture->assignStoredMip(_miplevel, _size, static_cast<const gpu::Byte*>(_data));
+            _texture->assignStoredMip(_miplevel, storage);
         }
-        free(_data);
-        _data = nullptr;
     }
 
     gpu::Byte* _data{ nullptr };
@@ -377,15 +474,13 @@ struct OutputHandler : public nvtt::OutputHandler {
     int _miplevel = 0;
     int _size = 0;
     int _face = -1;
+    std::mutex* _textureMutex{ nullptr };
 };
 
 struct PackedFloatOutputHandler : public OutputHandler {
-    PackedFloatOutputHandler(gpu::Texture* texture, int face, gpu::Element format) : OutputHandler(texture, face) {
-        if (format == gpu::Element::COLOR_RGB9E5) {
-            _packFunc = glm::packF3x9_E1x5;
-        } else if (format == gpu::Element::COLOR_R11G11B10) {
-            _packFunc = packR11G11B10F;
-        } else {
+    PackedFloatOutputHandler(gpu::Texture* texture, int face, gpu::Element format, std::mutex* textureMutex = nullptr) :
+        OutputHandler(texture, face, textureMutex), _format(format) {
+        if (format != gpu::Element::COLOR_RGB9E5 && format != gpu::Element::COLOR_R11G11B10) {
             qCWarning(imagelogging) << "Unknown handler format";
             Q_UNREACHABLE();
         }
@@ -394,33 +489,25 @@ struct PackedFloatOutputHandler : public OutputHandler {
     virtual void beginImage(int size, int width, int height, int depth, int face, int miplevel) override {
         // Divide by 3 because we will compress from 3*floats to 1 uint32
         OutputHandler::beginImage(size / 3, width, height, depth, face, miplevel);
+        _floats.clear();
+        _floats.reserve(size / sizeof(float));
     }
     virtual bool writeData(const void* data, int size) override {
-        // Expecting to write multiple of floats
-        if (_packFunc) {
-            assert((size % sizeof(float)) == 0);
-            auto floatCount = size / sizeof(float);
-            const float* floatBegin = (const float*)data;
-            const float* floatEnd = floatBegin + floatCount;
-
-            while (floatBegin < floatEnd) {
-                _pixel[_coordIndex] = *floatBegin;
-                floatBegin++;
-                _coordIndex++;
-                if (_coordIndex == 3) {
-                    uint32 packedRGB = _packFunc(_pixel);
-                    _coordIndex = 0;
-                    OutputHandler::writeData(&packedRGB, sizeof(packedRGB));
-                }
-            }
-            return true;
-        }
-        return false;
+        // Expecting to write multiple of floats, they're packed all at once at the end
+        assert((size % sizeof(float)) == 0);
+        const float* floatBegin = (const float*)data;
+        _floats.insert(_floats.end(), floatBegin, floatBegin + size / sizeof(float));
+        return true;
+    }
+    virtual void endImage() override {
+        packHDRPixels(_floats.data(), reinterpret_cast<uint32*>(_data), _floats.size() / 3, _format);
+        _current = _data + _size;
+        _floats = std::vector<float>();
+        OutputHandler::endImage();
     }
 
-    std::function<uint32(const glm::vec3&)> _packFunc;
-    glm::vec3 _pixel;
-    int _coordIndex{ 0 };
+    gpu::Element _format;
+    std::vector<float> _floats;
 };
 
 struct MyErrorHandler : public nvtt::ErrorHandler {
@@ -429,24 +516,21 @@ struct MyErrorHandler : public nvtt::ErrorHandler {
     }
 };
 
-class SequentialTaskDispatcher : public nvtt::TaskDispatcher {
+class ParallelTaskDispatcher : public nvtt::TaskDispatcher {
 public:
-    SequentialTaskDispatcher(const std::atomic<bool>& abortProcessing) : _abortProcessing(abortProcessing) {};
+    ParallelTaskDispatcher(const std::atomic<bool>& abortProcessing) : _abortProcessing(abortProcessing) {};
 
     const std::atomic<bool>& _abortProcessing;
 
     virtual void dispatch(nvtt::Task* task, void* context, int count) override {
-        for (int i = 0; i < count; i++) {
-            if (!_abortProcessing.load()) {
-                task(context, i);
-            } else {
-                break;
-            }
-        }
+        parallelFor(count, _abortProcessing, [task, context](int i) {
+            task(context, i);
+        });
     }
 };
 
-void generateHDRMips(gpu::Texture* texture, QImage&& image, const std::atomic<bool>& abortProcessing, int face) {
+void generateHDRMips(gpu::Texture* texture, QImage&& image, const std::atomic<bool>& abortProcessing, int face,
+                     std::mutex* textureMutex) {
     // Take a local copy to force move construction
     // https://github.com/isocpp/CppCoreGuidelines/blob/master/CppCoreGuidelines.md#f18-for-consume-parameters-pass-by-x-and-stdmove-the-parameter
     QImage localCopy = std::move(image);
@@ -455,9 +539,7 @@ void generateHDRMips(gpu::Texture* texture, QImage&& image, const std::atomic<bo
 
     const int width = localCopy.width(), height = localCopy.height();
     std::vector<glm::vec4> data;
-    std::vector<glm::vec4>::iterator dataIt;
     auto mipFormat = texture->getStoredMipFormat();
-    std::function<glm::vec3(uint32)> unpackFunc;
 
     nvtt::InputFormat inputFormat = nvtt::InputFormat_RGBA_32F;
     nvtt::WrapMode wrapMode = nvtt::WrapMode_Mirror;
@@ -483,67 +565,60 @@ void generateHDRMips(gpu::Texture* texture, QImage&& image, const std::atomic<bo
         return;
     }
 
-    if (HDR_FORMAT == gpu::Element::COLOR_RGB9E5) {
-        unpackFunc = glm::unpackF3x9_E1x5;
-    } else if (HDR_FORMAT == gpu::Element::COLOR_R11G11B10) {
-        unpackFunc = glm::unpackF2x11_1x10;
-    } else {
-        qCWarning(imagelogging) << "Unknown HDR encoding format in QImage";
-        Q_UNREACHABLE();
-        return;
-    }
-
     data.resize(width * height);
-    dataIt = data.begin();
     for (auto lineNb = 0; lineNb < height; lineNb++) {
-        const uint32* srcPixelIt = reinterpret_cast<const uint32*>(localCopy.constScanLine(lineNb));
-        const uint32* srcPixelEnd = srcPixelIt + width;
-
-        while (srcPixelIt < srcPixelEnd) {
-            *dataIt = glm::vec4(unpackFunc(*srcPixelIt), 1.0f);
-            ++srcPixelIt;
-            ++dataIt;
-        }
+        unpackHDRPixels(reinterpret_cast<const uint32*>(localCopy.constScanLine(lineNb)), &data[lineNb * width], width, HDR_FORMAT);
     }
-    assert(dataIt == data.end());
 
     // We're done with the localCopy, free up the memory to avoid bloating the heap
     localCopy = QImage(); // QImage doesn't have a clear function, so override it with an empty one.
 
-    nvtt::OutputOptions outputOptions;
-    outputOptions.setOutputHeader(false);
-    std::unique_ptr<nvtt::OutputHandler> outputHandler;
-    MyErrorHandler errorHandler;
-    outputOptions.setErrorHandler(&errorHandler);
-    nvtt::Context context;
-    int mipLevel = 0;
-
-    if (mipFormat == gpu::Element::COLOR_RGB9E5 || mipFormat == gpu::Element::COLOR_R11G11B10) {
-        // Don't use NVTT (at least version 2.1) as it outputs wrong RGB9E5 and R11G11B10F values from floats
-        outputHandler.reset(new PackedFloatOutputHandler(texture, face, mipFormat));
-    } else {
-        outputHandler.reset(new OutputHandler(texture, face));
-    }
-
-    outputOptions.setOutputHandler(outputHandler.get());
-
     nvtt::Surface surface;
     surface.setImage(inputFormat, width, height, 1, &(*data.begin()));
     surface.setAlphaMode(alphaMode);
     surface.setWrapMode(wrapMode);
 
-    SequentialTaskDispatcher dispatcher(abortProcessing);
-    nvtt::Compressor compressor;
-    context.setTaskDispatcher(&dispatcher);
+    // We're done with the data, the surface holds its own copy
+    data = std::vector<glm::vec4>();
 
-    context.compress(surface, face, mipLevel++, compressionOptions, outputOptions);
+    // The box filter is cheap next to the compression, build the whole chain up front so the levels can be compressed in parallel
+    std::vector<nvtt::Surface> mips;
+    mips.push_back(surface);
     while (surface.canMakeNextMipmap() && !abortProcessing.load()) {
         surface.buildNextMipmap(nvtt::MipmapFilter_Box);
-        context.compress(surface, face, mipLevel++, compressionOptions, outputOptions);
+        mips.push_back(surface);
     }
+    surface = nvtt::Surface();
+
+    std::mutex localTextureMutex;
+    if (!textureMutex) {
+        textureMutex = &localTextureMutex;
+    }
+
+    ParallelTaskDispatcher dispatcher(abortProcessing);
+    parallelFor((int)mips.size(), abortProcessing, [&](int mipLevel) {
+        nvtt::OutputOptions outputOptions;
+        outputOptions.setOutputHeader(false);
+        std::unique_ptr<nvtt::OutputHandler> outputHandler;
+        MyErrorHandler errorHandler;
+        outputOptions.setErrorHandler(&errorHandler);
+
+        if (mipFormat == gpu::Element::COLOR_RGB9E5 || mipFormat == gpu::Element::COLOR_R11G11B10) {
+            // Don't use NVTT (at least version 2.1) as it outputs wrong RGB9E5 and R11G11B10F values from floats
+            outputHandler.reset(new PackedFloatOutputHandler(texture, face, mipFormat, textureMutex));
+        } else {
+            outputHandler.reset(new OutputHandler(texture, face, textureMutex));
+        }
+        outputOptions.setOutputHandler(outputHandler.get());
+
+        nvtt::Context context;
+        context.setTaskDispatcher(&dispatcher);
+        context.compress(mips[mipLevel], face, mipLevel, compressionOptions, outputOptions);
+    });
 }
 
-void generateLDRMips(gpu::Texture* texture, QImage&& image, const std::atomic<bool>& abortProcessing, int face) {
+void generateLDRMips(gpu::Texture* texture, QImage&& image, const std::atomic<bool>& abortProcessing, int face,
+                     std::mutex* textureMutex) {
     // Take a local copy to force move construction
     // https://github.com/isocpp/CppCoreGuidelines/blob/master/CppCoreGuidelines.md#f18-for-consume-parameters-pass-by-x-and-stdmove-the-parameter
     QImage localCopy = std::move(image);
@@ -552,34 +627,11 @@ void generateLDRMips(gpu::Texture* texture, QImage&& image, const std::atomic<bo
         localCopy = localCopy.convertToFormat(QImage::Format_ARGB32);
     }
 
-    const int width = localCopy.width(), height = localCopy.height();
-    const void* data = static_cast<const void*>(localCopy.constBits());
-
-    nvtt::TextureType textureType = nvtt::TextureType_2D;
     nvtt::InputFormat inputFormat = nvtt::InputFormat_BGRA_8UB;
     nvtt::WrapMode wrapMode = nvtt::WrapMode_Mirror;
-    nvtt::RoundMode roundMode = nvtt::RoundMode_None;
     nvtt::AlphaMode alphaMode = nvtt::AlphaMode_None;
 
-    float inputGamma = 2.2f;
-    float outputGamma = 2.2f;
-
-    nvtt::InputOptions inputOptions;
-    inputOptions.setTextureLayout(textureType, width, height);
-
-    inputOptions.setMipmapData(data, width, height);
-    // setMipmapData copies the memory, so free up the memory afterward to avoid bloating the heap
-    data = nullptr;
-    localCopy = QImage(); // QImage doesn't have a clear function, so override it with an empty one.
-
-    inputOptions.setFormat(inputFormat);
-    inputOptions.setGamma(inputGamma, outputGamma);
-    inputOptions.setAlphaMode(alphaMode);
-    inputOptions.setWrapMode(wrapMode);
-    inputOptions.setRoundMode(roundMode);
-
-    inputOptions.setMipmapGeneration(true);
-    inputOptions.setMipmapFilter(nvtt::MipmapFilter_Box);
+    ColorSpace colorSpace = ColorSpace::GAMMA;
 
     nvtt::CompressionOptions compressionOptions;
     compressionOptions.setQuality(nvtt::Quality_Production);
@@ -597,6 +649,7 @@ void generateLDRMips(gpu::Texture* texture, QImage&& image, const std::atomic<bo
     } else if (mipFormat == gpu::Element::COLOR_COMPRESSED_BCX_RED) {
         compressionOptions.setFormat(nvtt::Format_BC4);
     } else if (mipFormat == gpu::Element::COLOR_COMPRESSED_BCX_XY) {
+        colorSpace = ColorSpace::NORMAL_MAP;
         compressionOptions.setFormat(nvtt::Format_BC5);
     } else if (mipFormat == gpu::Element::COLOR_COMPRESSED_BCX_SRGBA_HIGH) {
         alphaMode = nvtt::AlphaMode_Transparency;
@@ -610,8 +663,7 @@ void generateLDRMips(gpu::Texture* texture, QImage&& image, const std::atomic<bo
             0x0000FF00,
             0x00FF0000,
             0xFF000000);
-        inputGamma = 1.0f;
-        outputGamma = 1.0f;
+        colorSpace = ColorSpace::LINEAR;
     } else if (mipFormat == gpu::Element::COLOR_BGRA_32) {
         compressionOptions.setFormat(nvtt::Format_RGBA);
         compressionOptions.setPixelType(nvtt::PixelType_UnsignedNorm);
@@ -621,8 +673,7 @@ void generateLDRMips(gpu::Texture* texture, QImage&& image, const std::atomic<bo
             0x0000FF00,
             0x000000FF,
             0xFF000000);
-        inputGamma = 1.0f;
-        outputGamma = 1.0f;
+        colorSpace = ColorSpace::LINEAR;
     } else if (mipFormat == gpu::Element::COLOR_SRGBA_32) {
         compressionOptions.setFormat(nvtt::Format_RGBA);
         compressionOptions.setPixelType(nvtt::PixelType_UnsignedNorm);
@@ -647,7 +698,7 @@ void generateLDRMips(gpu::Texture* texture, QImage&& image, const std::atomic<bo
         compressionOptions.setPitchAlignment(4);
         compressionOptions.setPixelFormat(8, 0, 0, 0);
     } else if (mipFormat == gpu::Element::VEC2NU8_XY) {
-        inputOptions.setNormalMap(true);
+        colorSpace = ColorSpace::NORMAL_MAP;
         compressionOptions.setFormat(nvtt::Format_RGBA);
         compressionOptions.setPixelType(nvtt::PixelType_UnsignedNorm);
         compressionOptions.setPitchAlignment(4);
@@ -658,31 +709,59 @@ void generateLDRMips(gpu::Texture* texture, QImage&& image, const std::atomic<bo
         return;
     }
 
-    nvtt::OutputOptions outputOptions;
-    outputOptions.setOutputHeader(false);
-    OutputHandler outputHandler(texture, face);
-    outputOptions.setOutputHandler(&outputHandler);
-    MyErrorHandler errorHandler;
-    outputOptions.setErrorHandler(&errorHandler);
-
-    SequentialTaskDispatcher dispatcher(abortProcessing);
-    nvtt::Compressor compressor;
-    compressor.setTaskDispatcher(&dispatcher);
-    compressor.process(inputOptions, compressionOptions, outputOptions);
+    // Build the mips up front, filtered in linear space (or renormalized for normal maps) like nvtt would, so the
+    // levels can be compressed in parallel
+    std::vector<QImage> mips;
+    {
+        PROFILE_RANGE(resource_parse, "generateLDRMipChain");
+        FloatImage mip = decodeImage(localCopy, colorSpace);
+        mips.push_back(std::move(localCopy));
+        while ((mip.width > 1 || mip.height > 1) && !abortProcessing.load()) {
+            mip = downsampleImage(mip, colorSpace);
+            mips.push_back(encodeImage(mip, colorSpace));
+        }
+    }
+
+    std::mutex localTextureMutex;
+    if (!textureMutex) {
+        textureMutex = &localTextureMutex;
+    }
+
+    ParallelTaskDispatcher dispatcher(abortProcessing);
+    parallelFor((int)mips.size(), abortProcessing, [&](int mipLevel) {
+        const QImage& mip = mips[mipLevel];
+        nvtt::Surface surface;
+        surface.setImage(inputFormat, mip.width(), mip.height(), 1, mip.constBits());
+        surface.setAlphaMode(alphaMode);
+        surface.setWrapMode(wrapMode);
+        surface.setNormalMap(colorSpace == ColorSpace::NORMAL_MAP);
+
+        nvtt::OutputOptions outputOptions;
+        outputOptions.setOutputHeader(false);
+        OutputHandler outputHandler(texture, face, textureMutex);
+        outputOptions.setOutputHandler(&outputHandler);
+        MyErrorHandler errorHandler;
+        outputOptions.setErrorHandler(&errorHandler);
+
+        nvtt::Context context;
+        context.setTaskDispatcher(&dispatcher);
+        context.compress(surface, face, mipLevel, compressionOptions, outputOptions);
+    });
 }
 
 #endif
 
 
 
-void generateMips(gpu::Texture* texture, QImage&& image, const std::atomic<bool>& abortProcessing = false, int face = -1) {
+void generateMips(gpu::Texture* texture, QImage&& image, const std::atomic<bool>& abortProcessing = false, int face = -1,
+                  std::mutex* textureMutex = nullptr) {
 #if CPU_MIPMAPS
     PROFILE_RANGE(resource_parse, "generateMips");
 
     if (image.format() == QIMAGE_HDR_FORMAT) {
-        generateHDRMips(texture, std::move(image), abortProcessing, face);
+        generateHDRMips(texture, std::move(image), abortProcessing, face, textureMutex);
     } else  {
-        generateLDRMips(texture, std::move(image), abortProcessing, face);
+        generateLDRMips(texture, std::move(image), abortProcessing, face, textureMutex);
     }
 #else
     texture->setAutoGenerateMips(true);
@@ -719,7 +798,7 @@ void processTextureAlpha(const QImage& srcImage, bool& validAlpha, bool& alphaAs
 gpu::TexturePointer TextureUsage::process2DTextureColorFromImage(QImage&& srcImage, const std::string& srcImageName,
                                                                  bool isStrict, const std::atomic<bool>& abortProcessing) {
     PROFILE_RANGE(resource_parse, "process2DTextureColorFromImage");
-    QImage image = processSourceImage(std::move(srcImage), false);
+    QImage image = processSourceImage(std::move(srcImage), false, ColorSpace::GAMMA);
 
     bool validAlpha = image.hasAlphaChannel();
     bool alphaAsMask = false;
@@ -863,7 +942,7 @@ QImage processBumpMap(QImage&& image) {
 gpu::TexturePointer TextureUsage::process2DTextureNormalMapFromImage(QImage&& srcImage, const std::string& srcImageName,
                                                                      bool isBumpMap, const std::atomic<bool>& abortProcessing) {
     PROFILE_RANGE(resource_parse, "process2DTextureNormalMapFromImage");
-    QImage image = processSourceImage(std::move(srcImage), false);
+    QImage image = processSourceImage(std::move(srcImage), false, isBumpMap ? ColorSpace::LINEAR : ColorSpace::NORMAL_MAP);
 
     if (isBumpMap) {
         image = processBumpMap(std::move(image));
@@ -901,7 +980,7 @@ gpu::TexturePointer TextureUsage::process2DTextureGrayscaleFromImage(QImage&& sr
                                                                      bool isInvertedPixels,
                                                                      const std::atomic<bool>& abortProcessing) {
     PROFILE_RANGE(resource_parse, "process2DTextureGrayscaleFromImage");
-    QImage image = processSourceImage(std::move(srcImage), false);
+    QImage image = processSourceImage(std::move(srcImage), false, ColorSpace::GAMMA);
 
     if (image.format() != QImage::Format_ARGB32) {
         image = image.convertToFormat(QImage::Format_ARGB32);
@@ -1210,55 +1289,28 @@ QImage convertToHDRFormat(QImage&& srcImage, gpu::Element format) {
     // https://github.com/isocpp/CppCoreGuidelines/blob/master/CppCoreGuidelines.md#f18-for-consume-parameters-pass-by-x-and-stdmove-the-parameter
     QImage localCopy = std::move(srcImage);
 
-    QImage hdrImage(localCopy.width(), localCopy.height(), (QImage::Format)QIMAGE_HDR_FORMAT);
-    std::function<uint32(const glm::vec3&)> packFunc;
-#ifdef DEBUG_COLOR_PACKING
-    std::function<glm::vec3(uint32)> unpackFunc;
-#endif
-
-    switch (format.getSemantic()) {
-        case gpu::R11G11B10:
-            packFunc = packR11G11B10F;
-#ifdef DEBUG_COLOR_PACKING
-            unpackFunc = glm::unpackF2x11_1x10;
-#endif
-            break;
-        case gpu::RGB9E5:
-            packFunc = glm::packF3x9_E1x5;
-#ifdef DEBUG_COLOR_PACKING
-            unpackFunc = glm::unpackF3x9_E1x5;
-#endif
-            break;
-        default:
-            qCWarning(imagelogging) << "Unsupported HDR format";
-            Q_UNREACHABLE();
-            return localCopy;
+    if (format.getSemantic() != gpu::R11G11B10 && format.getSemantic() != gpu::RGB9E5) {
+        qCWarning(imagelogging) << "Unsupported HDR format";
+        Q_UNREACHABLE();
+        return localCopy;
     }
 
+    QImage hdrImage(localCopy.width(), localCopy.height(), (QImage::Format)QIMAGE_HDR_FORMAT);
     localCopy = localCopy.convertToFormat(QImage::Format_ARGB32);
     for (auto y = 0; y < localCopy.height(); y++) {
-        const QRgb* srcLineIt = reinterpret_cast<const QRgb*>( localCopy.constScanLine(y) );
-        const QRgb* srcLineEnd = srcLineIt + localCopy.width();
-        uint32* hdrLineIt = reinterpret_cast<uint32*>( hdrImage.scanLine(y) );
-        glm::vec3 color;
-
-        while (srcLineIt < srcLineEnd) {
-            color.r = qRed(*srcLineIt);
-            color.g = qGreen(*srcLineIt);
-            color.b = qBlue(*srcLineIt);
-            // Normalize and apply gamma
-            color /= 255.0f;
-            color.r = powf(color.r, 2.2f);
-            color.g = powf(color.g, 2.2f);
-            color.b = powf(color.b, 2.2f);
-            *hdrLineIt = packFunc(color);
+        const QRgb* srcLine = reinterpret_cast<const QRgb*>(localCopy.constScanLine(y));
+        uint32* hdrLine = reinterpret_cast<uint32*>(hdrImage.scanLine(y));
+        // Normalize and apply gamma
+        convertARGB32ToHDR(srcLine, hdrLine, localCopy.width(), format);
 #ifdef DEBUG_COLOR_PACKING
-            glm::vec3 ucolor = unpackFunc(*hdrLineIt);
-            assert(glm::distance(color, ucolor) <= 5e-2);
-#endif
-            ++srcLineIt;
-            ++hdrLineIt;
+        std::vector<glm::vec4> unpacked(localCopy.width());
+        unpackHDRPixels(hdrLine, unpacked.data(), unpacked.size(), format);
+        for (int x = 0; x < localCopy.width(); x++) {
+            glm::vec3 color = glm::vec3(qRed(srcLine[x]), qGreen(srcLine[x]), qBlue(srcLine[x])) / 255.0f;
+            color = glm::pow(color, glm::vec3(2.2f));
+            assert(glm::distance(color, glm::vec3(unpacked[x])) <= 5e-2);
         }
+#endif
     }
     return hdrImage;
 }
@@ -1280,7 +1332,7 @@ gpu::TexturePointer TextureUsage::processCubeTextureColorFromImage(QImage&& srcI
 
     gpu::TexturePointer theTexture = nullptr;
 
-    QImage image = processSourceImage(std::move(localCopy), true);
+    QImage image = processSourceImage(std::move(localCopy), true, ColorSpace::GAMMA);
 
     if (image.format() != QIMAGE_HDR_FORMAT) {
         image = convertToHDRFormat(std::move(image), HDR_FORMAT);
@@ -1355,9 +1407,11 @@ gpu::TexturePointer TextureUsage::processCubeTextureColorFromImage(QImage&& srcI
             theTexture->overrideIrradiance(irradiance);
         }
 
-        for (uint8 face = 0; face < faces.size(); ++face) {
-            generateMips(theTexture.get(), std::move(faces[face]), abortProcessing, face);
-        }
+        PROFILE_RANGE(resource_parse, "generateCubeMips");
+        std::mutex textureMutex;
+        parallelFor((int)faces.size(), abortProcessing, [&](int face) {
+            generateMips(theTexture.get(), std::move(faces[face]), abortProcessing, face, &textureMutex);
+        });
     }
 
     return theTexture;
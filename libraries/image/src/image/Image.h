@@ -92,6 +92,11 @@ void setNormalTexturesCompressionEnabled(bool enabled);
 void setGrayscaleTexturesCompressionEnabled(bool enabled);
 void setCubeTexturesCompressionEnabled(bool enabled);
 
+// Number of threads, the calling one included, a single texture's compression and mip generation may use.
+// 0 (the default) uses one per core, 1 processes everything on the calling thread like before.
+void setTextureProcessingThreadCount(int count);
+int getTextureProcessingThreadCount();
+
 gpu::TexturePointer processImage(QByteArray&& content, const std::string& url,
                                  int maxNumPixels, TextureUsage::Type textureType,
                                  const std::atomic<bool>& abortProcessing = false);
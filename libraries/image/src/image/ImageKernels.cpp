@@ -0,0 +1,515 @@
+//
+//  ImageKernels.cpp
+//  image/src/image
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ImageKernels.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#include <glm/gtc/packing.hpp>
+
+#include <NumericalConstants.h>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#include <emmintrin.h>  // SSE2
+#define IMAGE_KERNELS_SSE2 1
+#endif
+
+namespace image {
+
+static const float GAMMA = 2.2f;
+static const int LINEAR_TO_GAMMA_TABLE_SIZE = 4096;
+
+// R11G11B10 can't hold denormals, and glm's packing gives wrong values for them
+static const float MIN_R11G11B10_VALUE = 6.10e-5f;
+static const float MAX_R11G11B10_VALUE = 6.50e4f;
+
+// Kaiser windowed sinc, same shape as nvtt's KaiserFilter
+static const float KAISER_WIDTH = 3.0f;
+static const float KAISER_ALPHA = 4.0f;
+
+static const float* getGammaToLinearTable() {
+    static const std::array<float, 256> table = [] {
+        std::array<float, 256> values;
+        for (int i = 0; i < 256; ++i) {
+            values[i] = powf((float)i / 255.0f, GAMMA);
+        }
+        return values;
+    }();
+    return table.data();
+}
+
+// Indexed by sqrt(linear), which spreads the entries out where the curve is steepest
+static const uint8_t* getLinearToGammaTable() {
+    static const std::array<uint8_t, LINEAR_TO_GAMMA_TABLE_SIZE> table = [] {
+        std::array<uint8_t, LINEAR_TO_GAMMA_TABLE_SIZE> values;
+        for (int i = 0; i < LINEAR_TO_GAMMA_TABLE_SIZE; ++i) {
+            float root = (float)i / (float)(LINEAR_TO_GAMMA_TABLE_SIZE - 1);
+            values[i] = (uint8_t)(powf(root * root, 1.0f / GAMMA) * 255.0f + 0.5f);
+        }
+        return values;
+    }();
+    return table.data();
+}
+
+static uint32_t packR11G11B10F(const glm::vec3& color) {
+    glm::vec3 clamped;
+    for (int i = 0; i < 3; ++i) {
+        clamped[i] = (color[i] < MIN_R11G11B10_VALUE) ? 0.0f : std::min(color[i], MAX_R11G11B10_VALUE);
+    }
+    return glm::packF2x11_1x10(clamped);
+}
+
+#ifdef IMAGE_KERNELS_SSE2
+
+// Rebiases the exponents (127 => 15) and truncates the mantissas like glm::packF2x11_1x10
+static inline __m128i packR11G11B10F(__m128 red, __m128 green, __m128 blue) {
+    const __m128 minValue = _mm_set1_ps(MIN_R11G11B10_VALUE);
+    const __m128 maxValue = _mm_set1_ps(MAX_R11G11B10_VALUE);
+    const __m128i zero = _mm_setzero_si128();
+
+    __m128i r = _mm_castps_si128(_mm_and_ps(_mm_min_ps(red, maxValue), _mm_cmpge_ps(red, minValue)));
+    __m128i g = _mm_castps_si128(_mm_and_ps(_mm_min_ps(green, maxValue), _mm_cmpge_ps(green, minValue)));
+    __m128i b = _mm_castps_si128(_mm_and_ps(_mm_min_ps(blue, maxValue), _mm_cmpge_ps(blue, minValue)));
+
+    __m128i r11 = _mm_and_si128(_mm_sub_epi32(_mm_srli_epi32(r, 17), _mm_set1_epi32(0x1C00)), _mm_set1_epi32(0x7FF));
+    __m128i g11 = _mm_and_si128(_mm_sub_epi32(_mm_srli_epi32(g, 17), _mm_set1_epi32(0x1C00)), _mm_set1_epi32(0x7FF));
+    __m128i b10 = _mm_and_si128(_mm_sub_epi32(_mm_srli_epi32(b, 18), _mm_set1_epi32(0x0E00)), _mm_set1_epi32(0x3FF));
+    r11 = _mm_andnot_si128(_mm_cmpeq_epi32(r, zero), r11);
+    g11 = _mm_andnot_si128(_mm_cmpeq_epi32(g, zero), g11);
+    b10 = _mm_andnot_si128(_mm_cmpeq_epi32(b, zero), b10);
+
+    return _mm_or_si128(r11, _mm_or_si128(_mm_slli_epi32(g11, 11), _mm_slli_epi32(b10, 22)));
+}
+
+// A small float with mantissaBits bits of mantissa and a 5 bit exponent, as in the low bits of packed
+static inline __m128 unpackSmallFloat(__m128i packed, int mantissaBits) {
+    const __m128i exponentMask = _mm_set1_epi32(0x1F << mantissaBits);
+    const __m128i mantissaMask = _mm_set1_epi32((1 << mantissaBits) - 1);
+    __m128i exponent = _mm_and_si128(packed, exponentMask);
+
+    // (exponent + 112) << (23 - mantissaBits) rebiases 15 => 127, all ones stays all ones for inf and nan
+    __m128i normal = _mm_slli_epi32(_mm_add_epi32(packed, _mm_set1_epi32(112 << mantissaBits)), 23 - mantissaBits);
+    normal = _mm_or_si128(normal, _mm_and_si128(_mm_cmpeq_epi32(exponent, exponentMask), _mm_set1_epi32(0x7F800000)));
+
+    // mantissa * 2^-(14 + mantissaBits)
+    __m128 denormal = _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(packed, mantissaMask)),
+                                 _mm_set1_ps(1.0f / (float)(1 << (14 + mantissaBits))));
+
+    __m128 isDenormal = _mm_castsi128_ps(_mm_cmpeq_epi32(exponent, _mm_setzero_si128()));
+    return _mm_or_ps(_mm_and_ps(isDenormal, denormal), _mm_andnot_ps(isDenormal, _mm_castsi128_ps(normal)));
+}
+
+#endif
+
+void unpackHDRPixels(const uint32_t* src, glm::vec4* dst, size_t count, const gpu::Element& format) {
+    if (format.getSemantic() == gpu::RGB9E5) {
+        for (size_t i = 0; i < count; ++i) {
+            dst[i] = glm::vec4(glm::unpackF3x9_E1x5(src[i]), 1.0f);
+        }
+        return;
+    }
+    assert(format.getSemantic() == gpu::R11G11B10);
+
+    size_t i = 0;
+#ifdef IMAGE_KERNELS_SSE2
+    const __m128i elevenBits = _mm_set1_epi32(0x7FF);
+    const __m128i tenBits = _mm_set1_epi32(0x3FF);
+    for (; i + 4 <= count; i += 4) {
+        __m128i packed = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128 red = unpackSmallFloat(_mm_and_si128(packed, elevenBits), 6);
+        __m128 green = unpackSmallFloat(_mm_and_si128(_mm_srli_epi32(packed, 11), elevenBits), 6);
+        __m128 blue = unpackSmallFloat(_mm_and_si128(_mm_srli_epi32(packed, 22), tenBits), 5);
+        __m128 alpha = _mm_set1_ps(1.0f);
+        _MM_TRANSPOSE4_PS(red, green, blue, alpha);
+        _mm_storeu_ps(&dst[i + 0].x, red);
+        _mm_storeu_ps(&dst[i + 1].x, green);
+        _mm_storeu_ps(&dst[i + 2].x, blue);
+        _mm_storeu_ps(&dst[i + 3].x, alpha);
+    }
+#endif
+    for (; i < count; ++i) {
+        dst[i] = glm::vec4(glm::unpackF2x11_1x10(src[i]), 1.0f);
+    }
+}
+
+void packHDRPixels(const float* rgb, uint32_t* dst, size_t count, const gpu::Element& format) {
+    if (format.getSemantic() == gpu::RGB9E5) {
+        for (size_t i = 0; i < count; ++i) {
+            dst[i] = glm::packF3x9_E1x5(glm::vec3(rgb[3 * i], rgb[3 * i + 1], rgb[3 * i + 2]));
+        }
+        return;
+    }
+    assert(format.getSemantic() == gpu::R11G11B10);
+
+    size_t i = 0;
+#ifdef IMAGE_KERNELS_SSE2
+    for (; i + 4 <= count; i += 4) {
+        // r0 g0 b0 r1 | g1 b1 r2 g2 | b2 r3 g3 b3 => r0 r1 r2 r3 | g0 g1 g2 g3 | b0 b1 b2 b3
+        __m128 a = _mm_loadu_ps(rgb + 3 * i);
+        __m128 b = _mm_loadu_ps(rgb + 3 * i + 4);
+        __m128 c = _mm_loadu_ps(rgb + 3 * i + 8);
+        __m128 red = _mm_shuffle_ps(a, _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 3, 0));
+        __m128 green = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)),
+                                      _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 blue = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)), c, _MM_SHUFFLE(3, 0, 2, 0));
+        _mm_storeu_si128((__m128i*)(dst + i), packR11G11B10F(red, green, blue));
+    }
+#endif
+    for (; i < count; ++i) {
+        dst[i] = packR11G11B10F(glm::vec3(rgb[3 * i], rgb[3 * i + 1], rgb[3 * i + 2]));
+    }
+}
+
+void convertARGB32ToHDR(const QRgb* src, uint32_t* dst, size_t count, const gpu::Element& format) {
+    const float* toLinear = getGammaToLinearTable();
+    if (format.getSemantic() == gpu::RGB9E5) {
+        for (size_t i = 0; i < count; ++i) {
+            dst[i] = glm::packF3x9_E1x5(glm::vec3(toLinear[qRed(src[i])], toLinear[qGreen(src[i])], toLinear[qBlue(src[i])]));
+        }
+        return;
+    }
+    assert(format.getSemantic() == gpu::R11G11B10);
+
+    size_t i = 0;
+#ifdef IMAGE_KERNELS_SSE2
+    for (; i + 4 <= count; i += 4) {
+        const QRgb* pixels = src + i;
+        __m128 red = _mm_setr_ps(toLinear[qRed(pixels[0])], toLinear[qRed(pixels[1])],
+                                 toLinear[qRed(pixels[2])], toLinear[qRed(pixels[3])]);
+        __m128 green = _mm_setr_ps(toLinear[qGreen(pixels[0])], toLinear[qGreen(pixels[1])],
+                                   toLinear[qGreen(pixels[2])], toLinear[qGreen(pixels[3])]);
+        __m128 blue = _mm_setr_ps(toLinear[qBlue(pixels[0])], toLinear[qBlue(pixels[1])],
+                                  toLinear[qBlue(pixels[2])], toLinear[qBlue(pixels[3])]);
+        _mm_storeu_si128((__m128i*)(dst + i), packR11G11B10F(red, green, blue));
+    }
+#endif
+    for (; i < count; ++i) {
+        dst[i] = packR11G11B10F(glm::vec3(toLinear[qRed(src[i])], toLinear[qGreen(src[i])], toLinear[qBlue(src[i])]));
+    }
+}
+
+static void decodeRow(const QRgb* src, glm::vec4* dst, int width, ColorSpace colorSpace) {
+    if (colorSpace == ColorSpace::GAMMA) {
+        const float* toLinear = getGammaToLinearTable();
+        for (int x = 0; x < width; ++x) {
+            QRgb pixel = src[x];
+            float alpha = (float)qAlpha(pixel) / 255.0f;
+            dst[x] = glm::vec4(toLinear[qRed(pixel)] * alpha, toLinear[qGreen(pixel)] * alpha, toLinear[qBlue(pixel)] * alpha, alpha);
+        }
+        return;
+    }
+
+    // LINEAR maps [0, 255] to [0, 1], NORMAL_MAP maps the color channels to [-1, 1]
+    const glm::vec4 scale = (colorSpace == ColorSpace::NORMAL_MAP) ? glm::vec4(2.0f / 255.0f, 2.0f / 255.0f, 2.0f / 255.0f, 1.0f / 255.0f) : glm::vec4(1.0f / 255.0f);
+    const glm::vec4 offset = (colorSpace == ColorSpace::NORMAL_MAP) ? glm::vec4(-1.0f, -1.0f, -1.0f, 0.0f) : glm::vec4(0.0f);
+    int x = 0;
+#ifdef IMAGE_KERNELS_SSE2
+    const __m128 scaleVector = _mm_loadu_ps(&scale.x);
+    const __m128 offsetVector = _mm_loadu_ps(&offset.x);
+    const __m128i zero = _mm_setzero_si128();
+    for (; x + 4 <= width; x += 4) {
+        __m128i bytes = _mm_loadu_si128((const __m128i*)(src + x));
+        __m128i low = _mm_unpacklo_epi8(bytes, zero);
+        __m128i high = _mm_unpackhi_epi8(bytes, zero);
+        __m128i channels[4] = {
+            _mm_unpacklo_epi16(low, zero), _mm_unpackhi_epi16(low, zero),
+            _mm_unpacklo_epi16(high, zero), _mm_unpackhi_epi16(high, zero)
+        };
+        for (int i = 0; i < 4; ++i) {
+            // bgra in memory => rgba
+            __m128 pixel = _mm_cvtepi32_ps(channels[i]);
+            pixel = _mm_shuffle_ps(pixel, pixel, _MM_SHUFFLE(3, 0, 1, 2));
+            _mm_storeu_ps(&dst[x + i].x, _mm_add_ps(_mm_mul_ps(pixel, scaleVector), offsetVector));
+        }
+    }
+#endif
+    for (; x < width; ++x) {
+        QRgb pixel = src[x];
+        dst[x] = glm::vec4(qRed(pixel), qGreen(pixel), qBlue(pixel), qAlpha(pixel)) * scale + offset;
+    }
+}
+
+static void encodeRow(const glm::vec4* src, QRgb* dst, int width, ColorSpace colorSpace) {
+    if (colorSpace == ColorSpace::GAMMA) {
+        const uint8_t* toGamma = getLinearToGammaTable();
+        for (int x = 0; x < width; ++x) {
+            float alpha = glm::clamp(src[x].a, 0.0f, 1.0f);
+            glm::vec3 color = (alpha > 0.0f) ? glm::vec3(src[x]) / alpha : glm::vec3(0.0f);
+            glm::ivec3 index = glm::ivec3(glm::sqrt(glm::clamp(color, 0.0f, 1.0f)) * (float)(LINEAR_TO_GAMMA_TABLE_SIZE - 1) + 0.5f);
+            dst[x] = qRgba(toGamma[index.r], toGamma[index.g], toGamma[index.b], (int)(alpha * 255.0f + 0.5f));
+        }
+        return;
+    }
+
+    const glm::vec4 scale = (colorSpace == ColorSpace::NORMAL_MAP) ? glm::vec4(127.5f, 127.5f, 127.5f, 255.0f) : glm::vec4(255.0f);
+    const glm::vec4 offset = (colorSpace == ColorSpace::NORMAL_MAP) ? glm::vec4(127.5f, 127.5f, 127.5f, 0.0f) : glm::vec4(0.0f);
+#ifdef IMAGE_KERNELS_SSE2
+    const __m128 scaleVector = _mm_loadu_ps(&scale.x);
+    const __m128 offsetVector = _mm_add_ps(_mm_loadu_ps(&offset.x), _mm_set1_ps(0.5f));
+    const __m128 minValue = _mm_setzero_ps();
+    const __m128 maxValue = _mm_set1_ps(255.0f);
+    for (int x = 0; x < width; ++x) {
+        __m128 pixel = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&src[x].x), scaleVector), offsetVector);
+        pixel = _mm_min_ps(_mm_max_ps(pixel, minValue), maxValue);
+        // rgba => bgra in memory
+        pixel = _mm_shuffle_ps(pixel, pixel, _MM_SHUFFLE(3, 0, 1, 2));
+        __m128i channels = _mm_cvttps_epi32(pixel);
+        channels = _mm_packs_epi32(channels, channels);
+        channels = _mm_packus_epi16(channels, channels);
+        dst[x] = (QRgb)_mm_cvtsi128_si32(channels);
+    }
+#else
+    for (int x = 0; x < width; ++x) {
+        glm::ivec4 channels = glm::ivec4(glm::clamp(src[x] * scale + offset + 0.5f, 0.0f, 255.0f));
+        dst[x] = qRgba(channels.r, channels.g, channels.b, channels.a);
+    }
+#endif
+}
+
+static void renormalize(glm::vec4* pixels, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        glm::vec3 normal(pixels[i]);
+        float length = glm::length(normal);
+        if (length > 0.0f) {
+            normal /= length;
+            pixels[i] = glm::vec4(normal, pixels[i].a);
+        }
+    }
+}
+
+// dst += src * weight over count pixels
+static void accumulateRow(glm::vec4* dst, const glm::vec4* src, float weight, int count) {
+#ifdef IMAGE_KERNELS_SSE2
+    const __m128 weightVector = _mm_set1_ps(weight);
+    for (int i = 0; i < count; ++i) {
+        _mm_storeu_ps(&dst[i].x, _mm_add_ps(_mm_loadu_ps(&dst[i].x), _mm_mul_ps(_mm_loadu_ps(&src[i].x), weightVector)));
+    }
+#else
+    for (int i = 0; i < count; ++i) {
+        dst[i] += src[i] * weight;
+    }
+#endif
+}
+
+// The source pixels each destination pixel is made of, and their weights
+struct Contributors {
+    std::vector<int> first;
+    std::vector<int> count;
+    std::vector<float> weights; // maxCount per destination pixel
+    int maxCount { 0 };
+};
+
+enum class Filter {
+    BOX,
+    KAISER
+};
+
+static float bessel0(float x) {
+    float sum = 1.0f;
+    float term = 1.0f;
+    for (int k = 1; term > sum * 1e-8f; ++k) {
+        float factor = x / (2.0f * (float)k);
+        term *= factor * factor;
+        sum += term;
+    }
+    return sum;
+}
+
+static float kaiser(float x) {
+    if (fabsf(x) >= KAISER_WIDTH) {
+        return 0.0f;
+    }
+    float sinc = (x == 0.0f) ? 1.0f : sinf(PI * x) / (PI * x);
+    float t = x / KAISER_WIDTH;
+    return sinc * bessel0(KAISER_ALPHA * sqrtf(1.0f - t * t)) / bessel0(KAISER_ALPHA);
+}
+
+static Contributors computeContributors(int srcSize, int dstSize, Filter filter) {
+    Contributors contributors;
+    contributors.first.resize(dstSize);
+    contributors.count.resize(dstSize);
+
+    const float scale = (float)srcSize / (float)dstSize;
+    // when minifying the filter stretches to cover every source pixel
+    const float filterScale = std::max(scale, 1.0f);
+    const float radius = (filter == Filter::BOX) ? 0.5f * scale : KAISER_WIDTH * filterScale;
+    contributors.maxCount = std::min((int)ceilf(2.0f * radius) + 2, srcSize);
+    contributors.weights.resize(dstSize * contributors.maxCount, 0.0f);
+
+    for (int i = 0; i < dstSize; ++i) {
+        const float center = ((float)i + 0.5f) * scale;
+        int first = std::max((int)floorf(center - radius), 0);
+        int last = std::min((int)ceilf(center + radius), srcSize - 1);
+        last = std::min(last, first + contributors.maxCount - 1);
+
+        float* weights = &contributors.weights[i * contributors.maxCount];
+        float total = 0.0f;
+        for (int j = first; j <= last; ++j) {
+            float weight;
+            if (filter == Filter::BOX) {
+                // how much of source pixel j the destination pixel covers
+                weight = std::max(std::min((float)j + 1.0f, center + radius) - std::max((float)j, center - radius), 0.0f);
+            } else {
+                weight = kaiser(((float)j + 0.5f - center) / filterScale);
+            }
+            weights[j - first] = weight;
+            total += weight;
+        }
+        // taps falling outside of the image are dropped, what's left is renormalized
+        if (total != 0.0f) {
+            for (int j = first; j <= last; ++j) {
+                weights[j - first] /= total;
+            }
+        }
+        contributors.first[i] = first;
+        contributors.count[i] = last - first + 1;
+    }
+    return contributors;
+}
+
+static void resampleRow(const glm::vec4* src, glm::vec4* dst, const Contributors& contributors) {
+    for (size_t x = 0; x < contributors.first.size(); ++x) {
+        const glm::vec4* pixels = src + contributors.first[x];
+        const float* weights = &contributors.weights[x * contributors.maxCount];
+        const int count = contributors.count[x];
+#ifdef IMAGE_KERNELS_SSE2
+        __m128 sum = _mm_setzero_ps();
+        for (int k = 0; k < count; ++k) {
+            sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(&pixels[k].x), _mm_set1_ps(weights[k])));
+        }
+        _mm_storeu_ps(&dst[x].x, sum);
+#else
+        glm::vec4 sum(0.0f);
+        for (int k = 0; k < count; ++k) {
+            sum += pixels[k] * weights[k];
+        }
+        dst[x] = sum;
+#endif
+    }
+}
+
+FloatImage decodeImage(const QImage& image, ColorSpace colorSpace) {
+    QImage source = (image.format() == QImage::Format_ARGB32 || image.format() == QImage::Format_RGB32) ?
+        image : image.convertToFormat(QImage::Format_ARGB32);
+
+    FloatImage result;
+    result.width = source.width();
+    result.height = source.height();
+    result.pixels.resize((size_t)result.width * result.height);
+    for (int y = 0; y < result.height; ++y) {
+        decodeRow(reinterpret_cast<const QRgb*>(source.constScanLine(y)), &result.pixels[(size_t)y * result.width],
+                  result.width, colorSpace);
+    }
+    return result;
+}
+
+QImage encodeImage(const FloatImage& image, ColorSpace colorSpace, QImage::Format format) {
+    QImage result(image.width, image.height, format);
+    for (int y = 0; y < image.height; ++y) {
+        encodeRow(&image.pixels[(size_t)y * image.width], reinterpret_cast<QRgb*>(result.scanLine(y)), image.width, colorSpace);
+    }
+    return result;
+}
+
+FloatImage downsampleImage(const FloatImage& image, ColorSpace colorSpace) {
+    FloatImage result;
+    result.width = std::max(image.width / 2, 1);
+    result.height = std::max(image.height / 2, 1);
+    result.pixels.resize((size_t)result.width * result.height);
+
+    bool evenWidth = (image.width % 2 == 0) || (image.width == 1);
+    bool evenHeight = (image.height % 2 == 0) || (image.height == 1);
+    if (evenWidth && evenHeight) {
+        // the common case, every destination pixel averages a 2x2 block (or a 2x1 one at the end of the chain)
+        const int stepX = (image.width > 1) ? 1 : 0;
+        const int stepY = (image.height > 1) ? 1 : 0;
+        for (int y = 0; y < result.height; ++y) {
+            const glm::vec4* row0 = &image.pixels[(size_t)(2 * y) * image.width];
+            const glm::vec4* row1 = row0 + stepY * image.width;
+            glm::vec4* dst = &result.pixels[(size_t)y * result.width];
+            for (int x = 0; x < result.width; ++x) {
+                const int x0 = (image.width > 1) ? 2 * x : 0;
+                const int x1 = x0 + stepX;
+#ifdef IMAGE_KERNELS_SSE2
+                __m128 sum = _mm_add_ps(_mm_add_ps(_mm_loadu_ps(&row0[x0].x), _mm_loadu_ps(&row0[x1].x)),
+                                        _mm_add_ps(_mm_loadu_ps(&row1[x0].x), _mm_loadu_ps(&row1[x1].x)));
+                _mm_storeu_ps(&dst[x].x, _mm_mul_ps(sum, _mm_set1_ps(0.25f)));
+#else
+                dst[x] = (row0[x0] + row0[x1] + row1[x0] + row1[x1]) * 0.25f;
+#endif
+            }
+        }
+    } else {
+        // odd sizes, each destination pixel covers one and a half source pixels or more
+        Contributors horizontal = computeContributors(image.width, result.width, Filter::BOX);
+        Contributors vertical = computeContributors(image.height, result.height, Filter::BOX);
+        std::vector<glm::vec4> rows((size_t)result.width * image.height);
+        for (int y = 0; y < image.height; ++y) {
+            resampleRow(&image.pixels[(size_t)y * image.width], &rows[(size_t)y * result.width], horizontal);
+        }
+        for (int y = 0; y < result.height; ++y) {
+            glm::vec4* dst = &result.pixels[(size_t)y * result.width];
+            const float* weights = &vertical.weights[y * vertical.maxCount];
+            for (int k = 0; k < vertical.count[y]; ++k) {
+                accumulateRow(dst, &rows[(size_t)(vertical.first[y] + k) * result.width], weights[k], result.width);
+            }
+        }
+    }
+
+    if (colorSpace == ColorSpace::NORMAL_MAP) {
+        renormalize(result.pixels.data(), result.pixels.size());
+    }
+    return result;
+}
+
+QImage resizeImage(const QImage& image, int width, int height, ColorSpace colorSpace) {
+    const QImage::Format format = image.hasAlphaChannel() ? QImage::Format_ARGB32 : QImage::Format_RGB32;
+    const QImage source = (image.format() == format) ? image : image.convertToFormat(format);
+    QImage result(width, height, format);
+    if (source.isNull() || result.isNull()) {
+        return result;
+    }
+
+    const Contributors horizontal = computeContributors(source.width(), width, Filter::KAISER);
+    const Contributors vertical = computeContributors(source.height(), height, Filter::KAISER);
+
+    // Source rows are decoded and resampled horizontally once, then kept in a ring for as long as destination rows
+    // need them.  A destination row never needs more than maxCount consecutive rows, so they can't collide.
+    const int ringSize = vertical.maxCount;
+    std::vector<glm::vec4> decoded(source.width());
+    std::vector<glm::vec4> ring((size_t)ringSize * width);
+    std::vector<int> ringRows(ringSize, -1);
+    std::vector<glm::vec4> accumulated(width);
+
+    for (int y = 0; y < height; ++y) {
+        std::fill(accumulated.begin(), accumulated.end(), glm::vec4(0.0f));
+        const float* weights = &vertical.weights[y * vertical.maxCount];
+        for (int k = 0; k < vertical.count[y]; ++k) {
+            const int row = vertical.first[y] + k;
+            const int slot = row % ringSize;
+            glm::vec4* resampled = &ring[(size_t)slot * width];
+            if (ringRows[slot] != row) {
+                decodeRow(reinterpret_cast<const QRgb*>(source.constScanLine(row)), decoded.data(), source.width(), colorSpace);
+                resampleRow(decoded.data(), resampled, horizontal);
+                ringRows[slot] = row;
+            }
+            accumulateRow(accumulated.data(), resampled, weights[k], width);
+        }
+        if (colorSpace == ColorSpace::NORMAL_MAP) {
+            renormalize(accumulated.data(), accumulated.size());
+        }
+        encodeRow(accumulated.data(), reinterpret_cast<QRgb*>(result.scanLine(y)), width, colorSpace);
+    }
+    return result;
+}
+
+} // namespace image
@@ -0,0 +1,61 @@
+//
+//  ImageKernels.h
+//  image/src/image
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_image_ImageKernels_h
+#define hifi_image_ImageKernels_h
+
+#include <stdint.h>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <QtGui/QImage>
+
+#include <gpu/Format.h>
+
+namespace image {
+
+// How the channels of an 8 bit image are encoded, which decides how they're filtered
+enum class ColorSpace {
+    LINEAR,     // data, filtered as is
+    GAMMA,      // colors with a 2.2 gamma, filtered in linear space and weighted by alpha
+    NORMAL_MAP  // a normal in rgb, renormalized after filtering
+};
+
+// Four floats per pixel in rgba order.  GAMMA images are held linear and premultiplied by alpha,
+// NORMAL_MAP images hold the normal in [-1, 1] and alpha as is.
+struct FloatImage {
+    int width { 0 };
+    int height { 0 };
+    std::vector<glm::vec4> pixels;
+};
+
+FloatImage decodeImage(const QImage& image, ColorSpace colorSpace);
+QImage encodeImage(const FloatImage& image, ColorSpace colorSpace, QImage::Format format = QImage::Format_ARGB32);
+
+// Next mip level: half the size, rounded down, box filtered.  Odd sizes are area averaged.
+FloatImage downsampleImage(const FloatImage& image, ColorSpace colorSpace);
+
+// Kaiser filtered resize, replaces QImage::scaled(..., Qt::SmoothTransformation).  Works through the image a few
+// rows at a time so even the largest source never has to be held in floats.  The result is ARGB32 when the source
+// has an alpha channel and RGB32 otherwise.
+QImage resizeImage(const QImage& image, int width, int height, ColorSpace colorSpace);
+
+// Packed HDR formats (COLOR_R11G11B10, COLOR_RGB9E5) to and from floats.  Unpacking sets alpha to 1,
+// packing takes three floats per pixel and flushes values too small for the format to 0.
+void unpackHDRPixels(const uint32_t* src, glm::vec4* dst, size_t count, const gpu::Element& format);
+void packHDRPixels(const float* rgb, uint32_t* dst, size_t count, const gpu::Element& format);
+
+// 8 bit colors with a 2.2 gamma to linear packed HDR, alpha is dropped
+void convertARGB32ToHDR(const QRgb* src, uint32_t* dst, size_t count, const gpu::Element& format);
+
+} // namespace image
+
+#endif // hifi_image_ImageKernels_h
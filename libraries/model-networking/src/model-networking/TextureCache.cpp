@@ -455,14 +455,9 @@ void NetworkTexture::makeRequest() {
 
         startMipRangeRequest(NULL_MIP_LEVEL, NULL_MIP_LEVEL);
     } else if (_ktxResourceState == PENDING_MIP_REQUEST) {
-        if (_lowestKnownPopulatedMip > 0) {
+        if (_ktxMipLevelRangeRequested.first != NULL_MIP_LEVEL) {
             _ktxResourceState = REQUESTING_MIP;
-
-            // Add a fragment to the base url so we can identify the section of the ktx being requested when debugging
-            // The actual requested url is _activeUrl and will not contain the fragment
-            uint16_t nextMip = _lowestKnownPopulatedMip - 1;
-            _url.setFragment(QString::number(nextMip));
-            startMipRangeRequest(nextMip, nextMip);
+            startMipRangeRequest(_ktxMipLevelRangeRequested.first, _ktxMipLevelRangeRequested.second);
         }
     } else {
         qWarning(networking) << "NetworkTexture::makeRequest() called while not in a valid state: " << _ktxResourceState;
@@ -572,16 +567,31 @@ void NetworkTexture::startRequestForNextMipLevel() {
         return;
     }
 
+    // The streamer decides which textures get their next mips and when
     _lowestKnownPopulatedMip = texture->minAvailableMipLevel();
     if (_lowestRequestedMipLevel < _lowestKnownPopulatedMip) {
-        _ktxResourceState = PENDING_MIP_REQUEST;
+        DependencyManager::get<TextureCache>()->getTextureStreamer().addTexture(self.staticCast<NetworkTexture>());
+    }
+}
 
-        init(false);
-        float priority = -(float)_originalKtxDescriptor->header.numberOfMipmapLevels + (float)_lowestKnownPopulatedMip;
-        setLoadPriority(this, priority);
-        _url.setFragment(QString::number(_lowestKnownPopulatedMip - 1));
-        TextureCache::attemptRequest(self);
+void NetworkTexture::requestMipRange(uint16_t low, uint16_t high, size_t bytes, float priority) {
+    auto self = _self.lock();
+    if (!self || _ktxResourceState != WAITING_FOR_MIP_REQUEST) {
+        return;
     }
+
+    _ktxResourceState = PENDING_MIP_REQUEST;
+    _ktxMipLevelRangeRequested = { low, high };
+    _ktxMipBytesInFlight = bytes;
+
+    init(false);
+    // Mips load after everything else, in the order the streamer picked them
+    setLoadPriority(this, -1.0f / (1.0f + priority));
+
+    // Add a fragment to the base url so we can identify the section of the ktx being requested when debugging
+    // The actual requested url is _activeUrl and will not contain the fragment
+    _url.setFragment(low == high ? QString::number(low) : QString("%1-%2").arg(low).arg(high));
+    TextureCache::attemptRequest(self);
 }
 
 // Load mips in the range [low, high] (inclusive)
@@ -611,12 +621,7 @@ void NetworkTexture::startMipRangeRequest(uint16_t low, uint16_t high) {
 
         connect(_ktxMipRequest, &ResourceRequest::finished, this, &NetworkTexture::ktxInitialDataRequestFinished);
     } else {
-        ByteRange range;
-        range.fromInclusive = ktx::KTX_HEADER_SIZE + _originalKtxDescriptor->header.bytesOfKeyValueData
-                              + _originalKtxDescriptor->images[low]._imageOffset + ktx::IMAGE_SIZE_WIDTH;
-        range.toExclusive = ktx::KTX_HEADER_SIZE + _originalKtxDescriptor->header.bytesOfKeyValueData
-                              + _originalKtxDescriptor->images[high + 1]._imageOffset;
-        _ktxMipRequest->setByteRange(range);
+        _ktxMipRequest->setByteRange(TextureStreamer::evalMipRangeBytes(*_originalKtxDescriptor, low, high));
 
         connect(_ktxMipRequest, &ResourceRequest::finished, this, &NetworkTexture::ktxMipRequestFinished);
     }
@@ -709,17 +714,19 @@ void NetworkTexture::ktxMipRequestFinished() {
 
         if (_ktxResourceState == REQUESTING_MIP) {
             Q_ASSERT(_ktxMipLevelRangeInFlight.first != NULL_MIP_LEVEL);
-            Q_ASSERT(_ktxMipLevelRangeInFlight.second - _ktxMipLevelRangeInFlight.first == 0);
+            Q_ASSERT(_ktxMipLevelRangeInFlight.second >= _ktxMipLevelRangeInFlight.first);
 
             _ktxResourceState = WAITING_FOR_MIP_REQUEST;
+            _ktxMipLevelRangeRequested = { NULL_MIP_LEVEL, NULL_MIP_LEVEL };
 
             auto self = _self;
             auto url = _url;
             auto data = _ktxMipRequest->getData();
-            auto mipLevel = _ktxMipLevelRangeInFlight.first;
+            auto mipRange = _ktxMipLevelRangeInFlight;
+            auto descriptor = _originalKtxDescriptor;
             auto texture = _textureSource->getGPUTexture();
             DependencyManager::get<StatTracker>()->incrementStat("PendingProcessing");
-            QtConcurrent::run(QThreadPool::globalInstance(), [self, data, mipLevel, url, texture] {
+            QtConcurrent::run(QThreadPool::globalInstance(), [self, data, mipRange, descriptor, url, texture] {
                 PROFILE_RANGE_EX(resource_parse_image, "NetworkTexture - Processing Mip Data", 0xffff0000, 0, { { "url", url.toString() } });
                 DependencyManager::get<StatTracker>()->decrementStat("PendingProcessing");
                 CounterStat counter("Processing");
@@ -739,11 +746,15 @@ void NetworkTexture::ktxMipRequestFinished() {
 
                 Q_ASSERT_X(texture, "Async - NetworkTexture::ktxMipRequestFinished", "NetworkTexture should have been assigned a GPU texture by now.");
 
-                texture->assignStoredMip(mipLevel, data.size(), reinterpret_cast<const uint8_t*>(data.data()));
+                auto levels = TextureStreamer::splitMipRange(*descriptor, mipRange.first, mipRange.second, data.size());
+                for (const auto& level : levels) {
+                    texture->assignStoredMip(level.first, descriptor->images[level.first]._imageSize,
+                                             reinterpret_cast<const uint8_t*>(data.data()) + level.second);
+                }
 
-                // If mip level assigned above is still unavailable, then we assume future requests will also fail.
+                // If the mip levels assigned above are still unavailable, then we assume future requests will also fail.
                 auto minMipLevel = texture->minAvailableMipLevel();
-                if (minMipLevel > mipLevel) {
+                if (minMipLevel > mipRange.second) {
                     return;
                 }
 
@@ -766,6 +777,12 @@ void NetworkTexture::ktxMipRequestFinished() {
         }
     }
 
+    if (_ktxResourceState != PENDING_MIP_REQUEST) {
+        // A retry keeps its place in the budget
+        _ktxMipBytesInFlight = 0;
+        DependencyManager::get<TextureCache>()->getTextureStreamer().scheduleUpdate();
+    }
+
     _ktxMipRequest->disconnect(this);
     _ktxMipRequest->deleteLater();
     _ktxMipRequest = nullptr;
@@ -1036,6 +1053,8 @@ void NetworkTexture::refresh() {
     }
 
     _ktxResourceState = PENDING_INITIAL_LOAD;
+    _ktxMipLevelRangeRequested = { NULL_MIP_LEVEL, NULL_MIP_LEVEL };
+    _ktxMipBytesInFlight = 0;
     Resource::refresh();
 }
 
@@ -28,6 +28,7 @@
 
 #include <gpu/Context.h>
 #include "KTXCache.h"
+#include "TextureStreamer.h"
 
 namespace gpu {
 class Batch;
@@ -88,12 +89,15 @@ protected:
 
     Q_INVOKABLE void startRequestForNextMipLevel();
 
+    // Called by the TextureStreamer when it's this texture's turn, bytes is the size of the range
+    void requestMipRange(uint16_t low, uint16_t high, size_t bytes, float priority);
     void startMipRangeRequest(uint16_t low, uint16_t high);
     void handleFinishedInitialLoad();
 
 private:
     friend class KTXReader;
     friend class ImageReader;
+    friend class TextureStreamer;
 
     image::TextureUsage::Type _type;
 
@@ -109,7 +113,7 @@ private:
     enum KTXResourceState {
         PENDING_INITIAL_LOAD = 0,
         LOADING_INITIAL_DATA,    // Loading KTX Header + Low Resolution Mips
-        WAITING_FOR_MIP_REQUEST, // Waiting for the gpu layer to report that it needs higher resolution mips
+        WAITING_FOR_MIP_REQUEST, // Waiting for the TextureStreamer to pick us for higher resolution mips
         PENDING_MIP_REQUEST,     // We have added ourselves to the ResourceCache queue
         REQUESTING_MIP,          // We have a mip in flight
         FAILED_TO_LOAD
@@ -120,6 +124,10 @@ private:
     // The current mips that are currently being requested w/ _ktxMipRequest
     std::pair<uint16_t, uint16_t> _ktxMipLevelRangeInFlight{ NULL_MIP_LEVEL, NULL_MIP_LEVEL };
 
+    // The mips the TextureStreamer picked for the next request, and their size until they're loaded
+    std::pair<uint16_t, uint16_t> _ktxMipLevelRangeRequested{ NULL_MIP_LEVEL, NULL_MIP_LEVEL };
+    size_t _ktxMipBytesInFlight { 0 };
+
     ResourceRequest* _ktxHeaderRequest { nullptr };
     ResourceRequest* _ktxMipRequest { nullptr };
     QByteArray _ktxHeaderData;
@@ -244,6 +252,8 @@ public:
     static const int DEFAULT_SPECTATOR_CAM_WIDTH { 2048 };
     static const int DEFAULT_SPECTATOR_CAM_HEIGHT { 1024 };
 
+    TextureStreamer& getTextureStreamer() { return _textureStreamer; }
+
     void setGPUContext(const gpu::ContextPointer& context) { _gpuContext = context; }
     gpu::ContextPointer getGPUContext() const { return _gpuContext; }
 
@@ -284,6 +294,8 @@ private:
 
     std::shared_ptr<cache::FileCache> _ktxCache { std::make_shared<KTXCache>(KTX_DIRNAME, KTX_EXT) };
 
+    TextureStreamer _textureStreamer;
+
     // Map from image hashes to texture weak pointers
     std::unordered_map<std::string, std::weak_ptr<gpu::Texture>> _texturesByHashes;
     std::mutex _texturesByHashesMutex;
@@ -0,0 +1,246 @@
+//
+//  TextureStreamer.cpp
+//  libraries/model-networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "TextureStreamer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <gpu/Texture.h>
+#include <ktx/KTX.h>
+#include <NumericalConstants.h>
+#include <Profile.h>
+
+#include "TextureCache.h"
+
+const size_t TextureStreamer::DEFAULT_MAX_BYTES_IN_FLIGHT = MB_TO_BYTES(16);
+const size_t TextureStreamer::MAX_BATCH_BYTES = MB_TO_BYTES(1);
+const int TextureStreamer::UPDATE_INTERVAL_MSECS = 100;
+
+// Same as the gpu backend's default
+static const size_t DEFAULT_MEMORY_BUDGET = MB_TO_BYTES(1024);
+
+static size_t evalMipRequestSize(const ktx::KTXDescriptor& descriptor, uint16_t level) {
+    return descriptor.images[level]._imageSize + ktx::IMAGE_SIZE_WIDTH;
+}
+
+TextureStreamer::TextureStreamer(QObject* parent) :
+    QObject(parent),
+    _updateTimer(this)
+{
+    _updateTimer.setInterval(UPDATE_INTERVAL_MSECS);
+    connect(&_updateTimer, &QTimer::timeout, this, &TextureStreamer::update);
+}
+
+void TextureStreamer::addTexture(const QSharedPointer<NetworkTexture>& texture) {
+    _textures.insert(texture.data(), texture);
+    if (!_updateTimer.isActive()) {
+        _updateTimer.start();
+    }
+    scheduleUpdate();
+}
+
+void TextureStreamer::scheduleUpdate() {
+    if (!_updateScheduled) {
+        _updateScheduled = true;
+        QMetaObject::invokeMethod(this, "update", Qt::QueuedConnection);
+    }
+}
+
+size_t TextureStreamer::getMemoryBudget() const {
+    if (_memoryBudget != 0) {
+        return _memoryBudget;
+    }
+    size_t allowed = gpu::Texture::getAllowedGPUMemoryUsage();
+    return allowed != 0 ? allowed : DEFAULT_MEMORY_BUDGET;
+}
+
+std::vector<TextureStreamer::MipRequest> TextureStreamer::rankRequests(const std::vector<TextureState>& textures,
+        size_t bytesInFlight, size_t residentBytes, size_t maxBytesInFlight, size_t memoryBudget) {
+    struct Candidate {
+        size_t texture;
+        bool isOnScreen;
+        float priority;
+        uint16_t desiredMip;
+        uint16_t nextMip;
+        size_t nextMipSize;
+    };
+    std::vector<Candidate> candidates;
+
+    for (size_t i = 0; i < textures.size(); ++i) {
+        const auto& state = textures[i];
+        if (!state.descriptor || state.populatedMip <= state.lowestRequestedMip) {
+            continue;
+        }
+
+        Candidate candidate;
+        candidate.texture = i;
+        candidate.isOnScreen = false;
+        candidate.priority = 0.0f;
+        candidate.desiredMip = state.lowestRequestedMip;
+        candidate.nextMip = state.populatedMip - 1;
+        candidate.nextMipSize = evalMipRequestSize(*state.descriptor, candidate.nextMip);
+
+        // Without usage there is nothing to go by, stream it all the way down after everything on screen
+        if (state.hasUsage) {
+            if (state.screenSize == 0.0f) {
+                // Off screen, it keeps what it has
+                continue;
+            }
+
+            // The mip whose resolution matches the size on screen, and how magnified the current one is
+            float resolution = (float)std::max(state.width, state.height);
+            int desiredMip = (state.screenSize >= resolution) ? 0 : (int)floorf(log2f(resolution / state.screenSize));
+            desiredMip = std::min(desiredMip, (int)state.descriptor->images.size() - 1);
+            desiredMip = std::max(desiredMip, (int)state.lowestRequestedMip);
+
+            uint32_t populatedResolution = std::max(state.width, state.height) >> state.populatedMip;
+            candidate.priority = state.screenSize / std::max((float)populatedResolution, 1.0f);
+
+            // Once it has the resolution it's drawn at the rest goes with the unreported textures, still ranked by size
+            if (state.populatedMip > desiredMip) {
+                candidate.isOnScreen = true;
+                candidate.desiredMip = (uint16_t)desiredMip;
+            }
+        }
+        candidates.push_back(candidate);
+    }
+
+    // Most magnified first, then the rest by size on screen and smallest download first
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+        if (a.isOnScreen != b.isOnScreen) {
+            return a.isOnScreen;
+        }
+        if (a.priority != b.priority) {
+            return a.priority > b.priority;
+        }
+        return a.nextMipSize < b.nextMipSize;
+    });
+
+    std::vector<MipRequest> requests;
+    for (const auto& candidate : candidates) {
+        if (!candidate.isOnScreen && residentBytes >= memoryBudget) {
+            break;
+        }
+        // A level bigger than the cap still goes, on its own
+        if (bytesInFlight > 0 && bytesInFlight + candidate.nextMipSize > maxBytesInFlight) {
+            break;
+        }
+
+        // Levels are stored from the largest down, so consecutive levels make one contiguous byte range
+        const auto& descriptor = *textures[candidate.texture].descriptor;
+        uint16_t high = candidate.nextMip;
+        uint16_t low = high;
+        size_t requestSize = candidate.nextMipSize;
+        while (low > candidate.desiredMip) {
+            size_t levelSize = evalMipRequestSize(descriptor, low - 1);
+            if (requestSize + levelSize > MAX_BATCH_BYTES || bytesInFlight + requestSize + levelSize > maxBytesInFlight) {
+                break;
+            }
+            requestSize += levelSize;
+            --low;
+        }
+
+        // Only the magnified textures jump ahead in the resource queue
+        requests.push_back({ candidate.texture, low, high, requestSize, candidate.isOnScreen ? candidate.priority : 0.0f });
+        bytesInFlight += requestSize;
+        residentBytes += requestSize;
+    }
+    return requests;
+}
+
+ByteRange TextureStreamer::evalMipRangeBytes(const ktx::KTXDescriptor& descriptor, uint16_t low, uint16_t high) {
+    // Image offsets point at each level's size field, the range skips the first one
+    auto imagesStart = ktx::KTX_HEADER_SIZE + descriptor.header.bytesOfKeyValueData;
+    ByteRange range;
+    range.fromInclusive = imagesStart + descriptor.images[low]._imageOffset + ktx::IMAGE_SIZE_WIDTH;
+    range.toExclusive = imagesStart + descriptor.images[high + 1]._imageOffset;
+    return range;
+}
+
+std::vector<std::pair<uint16_t, size_t>> TextureStreamer::splitMipRange(const ktx::KTXDescriptor& descriptor,
+                                                                        uint16_t low, uint16_t high, size_t dataSize) {
+    // The data starts at the low level's image, each following level comes after its image size.
+    // Levels have to be assigned from the smallest up.
+    std::vector<std::pair<uint16_t, size_t>> levels;
+    auto rangeStart = descriptor.images[low]._imageOffset;
+    for (int level = high; level >= low; --level) {
+        const auto& image = descriptor.images[level];
+        auto offset = image._imageOffset - rangeStart;
+        if (offset + image._imageSize > dataSize) {
+            break;
+        }
+        levels.emplace_back((uint16_t)level, offset);
+    }
+    return levels;
+}
+
+void TextureStreamer::update() {
+    PROFILE_RANGE(resource, __FUNCTION__);
+    _updateScheduled = false;
+
+    std::vector<QSharedPointer<NetworkTexture>> waiting;
+    std::vector<TextureState> states;
+    size_t bytesInFlight = 0;
+    size_t residentBytes = 0;
+    bool isStreaming = false;
+
+    for (auto it = _textures.begin(); it != _textures.end();) {
+        auto texture = it.value().lock();
+        if (!texture) {
+            it = _textures.erase(it);
+            continue;
+        }
+        ++it;
+
+        bytesInFlight += texture->_ktxMipBytesInFlight;
+        auto gpuTexture = texture->getGPUTexture();
+        const auto& descriptor = texture->_originalKtxDescriptor;
+        if (!gpuTexture || !descriptor) {
+            continue;
+        }
+
+        uint16_t populatedMip = gpuTexture->minAvailableMipLevel();
+        residentBytes += gpuTexture->evalTotalSize(populatedMip);
+        if (populatedMip <= texture->_lowestRequestedMipLevel) {
+            continue;
+        }
+        isStreaming = true;
+        if (texture->_ktxResourceState != NetworkTexture::WAITING_FOR_MIP_REQUEST) {
+            continue;
+        }
+
+        TextureState state;
+        state.descriptor = descriptor.get();
+        state.width = gpuTexture->getWidth();
+        state.height = gpuTexture->getHeight();
+        state.populatedMip = populatedMip;
+        state.lowestRequestedMip = texture->_lowestRequestedMipLevel;
+        state.hasUsage = gpuTexture->hasUsage();
+        state.screenSize = state.hasUsage ? gpuTexture->getUsageScreenSize() : 0.0f;
+        states.push_back(state);
+        waiting.push_back(texture);
+    }
+
+    auto requests = rankRequests(states, bytesInFlight, residentBytes, _maxBytesInFlight, getMemoryBudget());
+    for (const auto& request : requests) {
+        waiting[request.texture]->requestMipRange(request.low, request.high, request.bytes, request.priority);
+        bytesInFlight += request.bytes;
+        residentBytes += request.bytes;
+    }
+
+    _bytesInFlight = bytesInFlight;
+    _residentBytes = residentBytes;
+
+    if (!isStreaming) {
+        _updateTimer.stop();
+    }
+}
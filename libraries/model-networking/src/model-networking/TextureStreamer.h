@@ -0,0 +1,109 @@
+//
+//  TextureStreamer.h
+//  libraries/model-networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_TextureStreamer_h
+#define hifi_TextureStreamer_h
+
+#include <vector>
+
+#include <QtCore/QHash>
+#include <QtCore/QObject>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QTimer>
+
+#include <ByteRange.h>
+
+namespace ktx {
+    struct KTXDescriptor;
+}
+
+class NetworkTexture;
+
+// Decides which KTX textures get their next mips, and when.
+//
+// NetworkTextures hand themselves over once their header and high mips are in.  Every update the streamer ranks them
+// by how large they're drawn on screen (as reported by the renderer, see gpu::Texture::noteUsage) against the
+// resolution they already have, and starts the mip requests of the most magnified ones while the bytes in flight stay
+// under a cap.  Small levels are fetched several at a time with one ranged request.  Once a texture has the resolution
+// it's drawn at, it keeps streaming down to its lowest requested level like the textures the renderer doesn't report
+// on, after everything still magnified and only while the mips of all the streamed textures are under the memory
+// budget.  Textures that have been drawn but are now off screen get no more mips; the gpu backend gives up the memory
+// of off screen textures first.  Lives on the TextureCache's thread.
+class TextureStreamer : public QObject {
+    Q_OBJECT
+
+public:
+    static const size_t DEFAULT_MAX_BYTES_IN_FLIGHT;
+    static const size_t MAX_BATCH_BYTES;
+    static const int UPDATE_INTERVAL_MSECS;
+
+    // What the ranking needs to know about a texture waiting for its next mips
+    struct TextureState {
+        const ktx::KTXDescriptor* descriptor { nullptr };
+        uint32_t width { 0 };
+        uint32_t height { 0 };
+        uint16_t populatedMip { 0 };
+        uint16_t lowestRequestedMip { 0 };
+        bool hasUsage { false };
+        float screenSize { 0.0f };
+    };
+
+    struct MipRequest {
+        size_t texture; // index into the TextureStates
+        uint16_t low;
+        uint16_t high;
+        size_t bytes;
+        float priority;
+    };
+
+    // The requests to start, in order, given what is already in flight and resident
+    static std::vector<MipRequest> rankRequests(const std::vector<TextureState>& textures, size_t bytesInFlight,
+                                                size_t residentBytes, size_t maxBytesInFlight, size_t memoryBudget);
+
+    // The byte range of the KTX file holding the levels [low, high], and where each level starts in the data of that
+    // range.  Levels are listed smallest first, up to the first one the data doesn't cover in full.
+    static ByteRange evalMipRangeBytes(const ktx::KTXDescriptor& descriptor, uint16_t low, uint16_t high);
+    static std::vector<std::pair<uint16_t, size_t>> splitMipRange(const ktx::KTXDescriptor& descriptor,
+                                                                 uint16_t low, uint16_t high, size_t dataSize);
+
+    TextureStreamer(QObject* parent = nullptr);
+
+    // The texture wants more mips than it has, it stays known to the streamer for as long as it lives
+    void addTexture(const QSharedPointer<NetworkTexture>& texture);
+
+    // Coalesces into one update on the next pass through the event loop
+    void scheduleUpdate();
+
+    void setMaxBytesInFlight(size_t bytes) { _maxBytesInFlight = bytes; }
+    size_t getMaxBytesInFlight() const { return _maxBytesInFlight; }
+
+    // 0 follows gpu::Texture::getAllowedGPUMemoryUsage()
+    void setMemoryBudget(size_t bytes) { _memoryBudget = bytes; }
+    size_t getMemoryBudget() const;
+
+    // As of the last update
+    size_t getBytesInFlight() const { return _bytesInFlight; }
+    size_t getResidentBytes() const { return _residentBytes; }
+
+public slots:
+    void update();
+
+private:
+    QHash<NetworkTexture*, QWeakPointer<NetworkTexture>> _textures;
+    QTimer _updateTimer;
+    bool _updateScheduled { false };
+
+    size_t _maxBytesInFlight { DEFAULT_MAX_BYTES_IN_FLIGHT };
+    size_t _memoryBudget { 0 };
+    size_t _bytesInFlight { 0 };
+    size_t _residentBytes { 0 };
+};
+
+#endif // hifi_TextureStreamer_h
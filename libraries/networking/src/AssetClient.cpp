@@ -14,6 +14,7 @@
 #include <cstdint>
 
 #include <QtCore/QBuffer>
+#include <QtCore/QDir>
 #include <QtCore/QStandardPaths>
 #include <QtCore/QThread>
 #include <QtScript/QScriptEngine>
@@ -25,6 +26,7 @@
 #include "AssetRequest.h"
 #include "AssetUpload.h"
 #include "AssetUtils.h"
+#include "ContentDiskCache.h"
 #include "MappingRequest.h"
 #include "NetworkAccessManager.h"
 #include "NetworkLogging.h"
@@ -67,7 +69,7 @@ void AssetClient::initCaching() {
 #endif
             _cacheDir = !cachePath.isEmpty() ? cachePath : "interfaceCache";
         }
-        QNetworkDiskCache* cache = new QNetworkDiskCache();
+        QNetworkDiskCache* cache = new ContentDiskCache();
         cache->setMaximumCacheSize(MAXIMUM_CACHE_SIZE);
         cache->setCacheDirectory(_cacheDir);
         networkAccessManager.setCache(cache);
@@ -368,6 +370,22 @@ SetBakingEnabledRequest* AssetClient::createSetBakingEnabledRequest(const AssetU
     return bakingEnabledRequest;
 }
 
+QString AssetClient::getPartialDownloadPath(const AssetUtils::AssetHash& hash) const {
+    // next to the disk cache rather than in it, so the cache's eviction never deletes a download being resumed
+    static const QString PARTIAL_DOWNLOADS_SUFFIX = "-partial";
+
+    if (_cacheDir.isEmpty()) {
+        return QString();
+    }
+
+    QDir partialDownloadsDir { QDir::cleanPath(QDir(_cacheDir).absolutePath()) + PARTIAL_DOWNLOADS_SUFFIX };
+    if (!partialDownloadsDir.mkpath(".")) {
+        return QString();
+    }
+
+    return partialDownloadsDir.filePath(hash);
+}
+
 AssetRequest* AssetClient::createRequest(const AssetUtils::AssetHash& hash, const ByteRange& byteRange) {
     auto request = new AssetRequest(hash, byteRange);
 
@@ -428,7 +446,7 @@ MessageID AssetClient::getAsset(const QString& hash, AssetUtils::DataOffset star
         }
     }
 
-    callback(false, AssetUtils::AssetServerError::NoError, QByteArray());
+    callback(false, AssetUtils::AssetServerError::NoError, QByteArray(), 0);
     return INVALID_MESSAGE_ID;
 }
 
@@ -507,8 +525,10 @@ void AssetClient::handleAssetGetReply(QSharedPointer<ReceivedMessage> message, S
     message->readHeadPrimitive(&error);
 
     AssetUtils::DataOffset length = 0;
+    AssetUtils::DataOffset assetSize = 0;
     if (!error) {
         message->readHeadPrimitive(&length);
+        message->readHeadPrimitive(&assetSize);
     } else {
         qCWarning(asset_client) << "Failure getting asset: " << error;
     }
@@ -534,6 +554,7 @@ void AssetClient::handleAssetGetReply(QSharedPointer<ReceivedMessage> message, S
 
     // Store message in case we need to disconnect from it later.
     callbacks.message = message;
+    callbacks.assetSize = assetSize;
 
 
     auto weakNode = senderNode.toWeakRef();
@@ -548,9 +569,9 @@ void AssetClient::handleAssetGetReply(QSharedPointer<ReceivedMessage> message, S
         disconnect(message.data(), nullptr, this, nullptr);
 
         if (length != message->getBytesLeftToRead()) {
-            callbacks.completeCallback(false, error, QByteArray());
+            callbacks.completeCallback(false, error, QByteArray(), 0);
         } else {
-            callbacks.completeCallback(true, error, message->readAll());
+            callbacks.completeCallback(true, error, message->readAll(), assetSize);
         }
 
 
@@ -619,9 +640,9 @@ void AssetClient::handleCompleteCallback(const QWeakPointer<Node>& node, Message
     }
 
     if (message->failed() || length != message->getBytesLeftToRead()) {
-        callbacks.completeCallback(false, AssetUtils::AssetServerError::NoError, QByteArray());
+        callbacks.completeCallback(false, AssetUtils::AssetServerError::NoError, QByteArray(), 0);
     } else {
-        callbacks.completeCallback(true, AssetUtils::AssetServerError::NoError, message->readAll());
+        callbacks.completeCallback(true, AssetUtils::AssetServerError::NoError, message->readAll(), callbacks.assetSize);
     }
 
     // We should never get to this point without the associated senderNode and messageID
@@ -968,7 +989,7 @@ void AssetClient::forceFailureOfPendingRequests(SharedNodePointer node) {
                     disconnect(message.data(), nullptr, this, nullptr);
                 }
 
-                value.second.completeCallback(false, AssetUtils::AssetServerError::NoError, QByteArray());
+                value.second.completeCallback(false, AssetUtils::AssetServerError::NoError, QByteArray(), 0);
             }
             messageMapIt->second.clear();
         }
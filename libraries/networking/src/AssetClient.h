@@ -43,7 +43,9 @@ struct AssetInfo {
 };
 
 using MappingOperationCallback = std::function<void(bool responseReceived, AssetUtils::AssetServerError serverError, QSharedPointer<ReceivedMessage> message)>;
-using ReceivedAssetCallback = std::function<void(bool responseReceived, AssetUtils::AssetServerError serverError, const QByteArray& data)>;
+// assetSize is the size of the whole asset, which may be larger than the data of a ranged request
+using ReceivedAssetCallback = std::function<void(bool responseReceived, AssetUtils::AssetServerError serverError,
+                                                 const QByteArray& data, AssetUtils::DataOffset assetSize)>;
 using GetInfoCallback = std::function<void(bool responseReceived, AssetUtils::AssetServerError serverError, AssetInfo info)>;
 using UploadResultCallback = std::function<void(bool responseReceived, AssetUtils::AssetServerError serverError, const QString& hash)>;
 using ProgressCallback = std::function<void(qint64 totalReceived, qint64 total)>;
@@ -63,6 +65,9 @@ public:
     Q_INVOKABLE AssetUpload* createUpload(const QString& filename);
     Q_INVOKABLE AssetUpload* createUpload(const QByteArray& data);
 
+    // path where the partial download of the given asset is kept, empty if there is no cache directory
+    QString getPartialDownloadPath(const AssetUtils::AssetHash& hash) const;
+
 public slots:
     void initCaching();
 
@@ -109,6 +114,7 @@ private:
         QSharedPointer<ReceivedMessage> message;
         ReceivedAssetCallback completeCallback;
         ProgressCallback progressCallback;
+        AssetUtils::DataOffset assetSize { 0 };
     };
 
     static MessageID _currentID;
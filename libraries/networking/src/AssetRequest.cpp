@@ -25,6 +25,8 @@
 
 static int requestID = 0;
 
+std::atomic<int> AssetRequest::_maxParallelChunkRequests { DEFAULT_MAX_PARALLEL_CHUNK_REQUESTS };
+
 AssetRequest::AssetRequest(const QString& hash, const ByteRange& byteRange) :
     _requestID(++requestID),
     _hash(hash),
@@ -38,6 +40,11 @@ AssetRequest::~AssetRequest() {
     if (_assetRequestID) {
         assetClient->cancelGetAssetRequest(_assetRequestID);
     }
+    for (auto& chunk : _chunks) {
+        if (chunk.requestID) {
+            assetClient->cancelGetAssetRequest(chunk.requestID);
+        }
+    }
 }
 
 void AssetRequest::start() {
@@ -75,12 +82,52 @@ void AssetRequest::start() {
 
     _state = WaitingForData;
 
+    requestAsset();
+}
+
+AssetRequest::Error AssetRequest::errorForReply(bool responseReceived, AssetUtils::AssetServerError serverError) const {
+    if (!responseReceived) {
+        return NetworkError;
+    }
+
+    switch (serverError) {
+        case AssetUtils::AssetServerError::NoError:
+            return NoError;
+        case AssetUtils::AssetServerError::AssetNotFound:
+            return NotFound;
+        case AssetUtils::AssetServerError::InvalidByteRange:
+            return InvalidByteRange;
+        default:
+            return UnknownError;
+    }
+}
+
+void AssetRequest::finish(Error error) {
+    _error = error;
+
+    if (_error != NoError) {
+        qCWarning(asset_client) << "Got error retrieving asset" << _hash << "- error code" << _error;
+    }
+
+    // whatever is left of the partial download stays on disk for the next request to resume
+    closePartialDownload();
+
+    _state = Finished;
+    emit finished(this);
+}
+
+void AssetRequest::requestAsset() {
     auto assetClient = DependencyManager::get<AssetClient>();
     auto that = QPointer<AssetRequest>(this); // Used to track the request's lifetime
     auto hash = _hash;
 
-    _assetRequestID = assetClient->getAsset(_hash, _byteRange.fromInclusive, _byteRange.toExclusive,
-        [this, that, hash](bool responseReceived, AssetUtils::AssetServerError serverError, const QByteArray& data) {
+    // without a range we don't know the size of the asset yet, ask for its first chunk and learn the size from the reply
+    auto start = _byteRange.isSet() ? _byteRange.fromInclusive : 0;
+    auto end = _byteRange.isSet() ? _byteRange.toExclusive : ASSET_DOWNLOAD_CHUNK_SIZE;
+
+    _assetRequestID = assetClient->getAsset(_hash, start, end,
+        [this, that, hash](bool responseReceived, AssetUtils::AssetServerError serverError, const QByteArray& data,
+                           AssetUtils::DataOffset assetSize) {
 
         if (!that) {
             qCWarning(asset_client) << "Got reply for dead asset request " << hash << "- error code" << _error;
@@ -89,27 +136,21 @@ void AssetRequest::start() {
         }
         _assetRequestID = INVALID_MESSAGE_ID;
 
-        if (!responseReceived) {
-            _error = NetworkError;
-        } else if (serverError != AssetUtils::AssetServerError::NoError) {
-            switch (serverError) {
-                case AssetUtils::AssetServerError::AssetNotFound:
-                    _error = NotFound;
-                    break;
-                case AssetUtils::AssetServerError::InvalidByteRange:
-                    _error = InvalidByteRange;
-                    break;
-                default:
-                    _error = UnknownError;
-                    break;
-            }
-        } else {
+        auto error = errorForReply(responseReceived, serverError);
+
+        if (error == NoError && !_byteRange.isSet() && assetSize > data.size()) {
+            // the rest of the asset comes in chunks
+            requestChunks(assetSize, data);
+            return;
+        }
+
+        if (error == NoError) {
             if (!_byteRange.isSet() && AssetUtils::hashData(data).toHex() != _hash) {
                 // the hash of the received data does not match what we expect, so we return an error
-                _error = HashVerificationFailed;
+                error = HashVerificationFailed;
             }
 
-            if (_error == NoError) {
+            if (error == NoError) {
                 _data = data;
                 _totalReceived += data.size();
                 emit progress(_totalReceived, data.size());
@@ -119,13 +160,8 @@ void AssetRequest::start() {
                 }
             }
         }
-        
-        if (_error != NoError) {
-            qCWarning(asset_client) << "Got error retrieving asset" << _hash << "- error code" << _error;
-        }
-        
-        _state = Finished;
-        emit finished(this);
+
+        finish(error);
     }, [this, that](qint64 totalReceived, qint64 total) {
         if (!that) {
             // If the request is dead, return
@@ -135,6 +171,207 @@ void AssetRequest::start() {
     });
 }
 
+void AssetRequest::requestChunks(AssetUtils::DataOffset size, const QByteArray& firstChunk) {
+    for (AssetUtils::DataOffset start = 0; start < size; start += ASSET_DOWNLOAD_CHUNK_SIZE) {
+        Chunk chunk;
+        chunk.start = start;
+        chunk.end = std::min(start + ASSET_DOWNLOAD_CHUNK_SIZE, size);
+        _chunks.push_back(chunk);
+    }
+
+    _data = QByteArray((int)size, Qt::Uninitialized);
+
+    if (openPartialDownload(size)) {
+        // pick up the chunks we already have from an earlier attempt at this download
+        QByteArray receivedFlags = _partialChunksFile->readAll();
+        for (size_t i = 0; i < _chunks.size() && i < (size_t)receivedFlags.size(); ++i) {
+            auto& chunk = _chunks[i];
+            if (receivedFlags[(int)i] && _partialFile->seek(chunk.start)) {
+                auto length = chunk.end - chunk.start;
+                if (_partialFile->read(_data.data() + chunk.start, length) == length) {
+                    chunk.received = true;
+                    _totalReceived += length;
+                    ++_numResumedChunks;
+                }
+            }
+        }
+
+        if (_numResumedChunks > 0) {
+            qCDebug(asset_client) << "Resuming download of" << _hash << "with" << _numResumedChunks << "of"
+                << _chunks.size() << "chunks already received";
+        }
+    }
+
+    // the first chunk came with the size, it completes the download when everything else was resumed
+    if (!_chunks[0].received && firstChunk.size() == _chunks[0].end - _chunks[0].start) {
+        handleChunk(0, firstChunk);
+        return;
+    }
+
+    hashReceivedChunks();
+
+    // everything may already be there, in which case there is nothing left to request
+    if (!finishChunks()) {
+        requestNextChunks();
+    }
+}
+
+void AssetRequest::requestNextChunks() {
+    auto assetClient = DependencyManager::get<AssetClient>();
+    auto that = QPointer<AssetRequest>(this); // Used to track the request's lifetime
+
+    while (_nextChunk < _chunks.size() && _numPendingRequests < _maxParallelChunkRequests) {
+        auto chunkIndex = _nextChunk++;
+        auto& chunk = _chunks[chunkIndex];
+
+        if (chunk.received) {
+            continue;
+        }
+
+        ++_numPendingRequests;
+
+        auto requestID = assetClient->getAsset(_hash, chunk.start, chunk.end,
+            [this, that, chunkIndex](bool responseReceived, AssetUtils::AssetServerError serverError, const QByteArray& data,
+                                     AssetUtils::DataOffset) {
+
+            if (!that || _state == Finished) {
+                return;
+            }
+
+            --_numPendingRequests;
+            _chunks[chunkIndex].requestID = INVALID_MESSAGE_ID;
+
+            // a chunk of the wrong length is a bad reply, its data is only trusted once the hash of the whole asset matches
+            auto error = errorForReply(responseReceived, serverError);
+            if (error == NoError && data.size() != _chunks[chunkIndex].end - _chunks[chunkIndex].start) {
+                qCWarning(asset_client) << "Got" << data.size() << "bytes for chunk" << chunkIndex << "of" << _hash;
+                error = NetworkError;
+            }
+
+            if (error != NoError) {
+                // whatever we have on disk so far stays there, so a later request can resume from it
+                _data = QByteArray();
+                finish(error);
+                return;
+            }
+
+            handleChunk(chunkIndex, data);
+        }, [](qint64 totalReceived, qint64 total) {
+            // progress is reported per chunk as chunks complete
+        });
+
+        // the request may have completed (and failed) synchronously
+        if (_state != Finished && requestID != INVALID_MESSAGE_ID && !_chunks[chunkIndex].received) {
+            _chunks[chunkIndex].requestID = requestID;
+        }
+
+        if (_state == Finished) {
+            return;
+        }
+    }
+}
+
+void AssetRequest::handleChunk(size_t chunkIndex, const QByteArray& data) {
+    auto& chunk = _chunks[chunkIndex];
+
+    memcpy(_data.data() + chunk.start, data.constData(), data.size());
+    chunk.received = true;
+    _totalReceived += data.size();
+
+    // persist the chunk before marking it as received, so a resumed download never trusts a chunk that isn't on disk
+    if (_partialFile && _partialFile->seek(chunk.start) && _partialFile->write(data) == data.size()
+        && _partialFile->flush() && _partialChunksFile->seek(chunkIndex)) {
+        _partialChunksFile->putChar(1);
+        _partialChunksFile->flush();
+    }
+
+    emit progress(_totalReceived, _data.size());
+
+    hashReceivedChunks();
+
+    if (!finishChunks()) {
+        requestNextChunks();
+    }
+}
+
+bool AssetRequest::finishChunks() {
+    if (_numHashedChunks < _chunks.size()) {
+        return false;
+    }
+
+    auto error = NoError;
+    if (_hasher.result().toHex() != _hash) {
+        // the data on disk can't be trusted either, start from scratch next time
+        error = HashVerificationFailed;
+        _data = QByteArray();
+    } else {
+        AssetUtils::saveToCache(getUrl(), _data);
+    }
+
+    removePartialDownload();
+    finish(error);
+    return true;
+}
+
+void AssetRequest::hashReceivedChunks() {
+    // feed the hash with every chunk we have in order, chunks that arrive early wait for the ones before them
+    while (_numHashedChunks < _chunks.size() && _chunks[_numHashedChunks].received) {
+        const auto& chunk = _chunks[_numHashedChunks];
+        _hasher.addData(_data.constData() + chunk.start, (int)(chunk.end - chunk.start));
+        ++_numHashedChunks;
+    }
+}
+
+bool AssetRequest::openPartialDownload(AssetUtils::DataOffset size) {
+    auto assetClient = DependencyManager::get<AssetClient>();
+    QString partialPath = assetClient->getPartialDownloadPath(_hash);
+    if (partialPath.isEmpty()) {
+        return false;
+    }
+
+    // another request for the same asset may be writing to the partial download already, only one of them gets to
+    _partialLock.reset(new QLockFile(partialPath + ".lock"));
+    _partialLock->setStaleLockTime(0); // downloads take as long as they take, only a dead owner makes the lock stale
+    if (!_partialLock->tryLock(0)) {
+        qCDebug(asset_client) << "Partial download of" << _hash << "is in use by another request - it will not be resumable";
+        _partialLock.reset();
+        return false;
+    }
+
+    _partialFile.reset(new QFile(partialPath));
+    _partialChunksFile.reset(new QFile(partialPath + ".chunks"));
+
+    if (!_partialFile->open(QIODevice::ReadWrite) || !_partialChunksFile->open(QIODevice::ReadWrite)) {
+        qCWarning(asset_client) << "Could not open partial download file for" << _hash << "- it will not be resumable";
+        closePartialDownload();
+        return false;
+    }
+
+    if (_partialFile->size() != size || _partialChunksFile->size() != (qint64)_chunks.size()) {
+        // this is a new download (or a partial download we can't make sense of), start it from scratch
+        _partialFile->resize(size);
+        _partialChunksFile->resize(0);
+        _partialChunksFile->write(QByteArray((int)_chunks.size(), 0));
+        _partialChunksFile->flush();
+    }
+
+    _partialChunksFile->seek(0);
+    return true;
+}
+
+void AssetRequest::removePartialDownload() {
+    if (_partialFile) {
+        _partialFile->remove();
+        _partialChunksFile->remove();
+        closePartialDownload();
+    }
+}
+
+void AssetRequest::closePartialDownload() {
+    _partialFile.reset();
+    _partialChunksFile.reset();
+    _partialLock.reset(); // unlocks and removes the lock file
+}
 
 const QString AssetRequest::getErrorString() const {
     QString result;
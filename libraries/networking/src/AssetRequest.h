@@ -13,18 +13,36 @@
 #define hifi_AssetRequest_h
 
 #include <QByteArray>
+#include <QCryptographicHash>
+#include <QFile>
+#include <QLockFile>
 #include <QObject>
 #include <QString>
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
 #include "AssetClient.h"
 #include "AssetUtils.h"
 
 #include "ByteRange.h"
 
+class AssetRequestTests;
+
 const QString ATP_SCHEME { "atp:" };
 
+// Every download starts by asking for the first chunk, whose reply also carries the size of the asset.
+// Assets larger than a chunk continue as several ranged AssetGet requests in flight at once.
+// Chunks are written to a partial file next to the cache directory as they arrive, so an interrupted
+// download resumes with the chunks it is still missing. The assembled asset is only kept once its hash matches.
+const AssetUtils::DataOffset ASSET_DOWNLOAD_CHUNK_SIZE = 1024 * 1024; // 1MB
+const int DEFAULT_MAX_PARALLEL_CHUNK_REQUESTS = 4;
+
 class AssetRequest : public QObject {
    Q_OBJECT
+    friend class ::AssetRequestTests;
 public:
     enum State {
         NotStarted = 0,
@@ -38,7 +56,6 @@ public:
         InvalidByteRange,
         InvalidHash,
         HashVerificationFailed,
-        SizeVerificationFailed,
         NetworkError,
         UnknownError
     };
@@ -57,11 +74,40 @@ public:
 
     bool loadedFromCache() const { return _loadedFromCache; }
 
+    // number of chunks resumed from a previous partial download
+    int getNumResumedChunks() const { return _numResumedChunks; }
+
+    static void setMaxParallelChunkRequests(int maxRequests) { _maxParallelChunkRequests = std::max(maxRequests, 1); }
+    static int getMaxParallelChunkRequests() { return _maxParallelChunkRequests; }
+
 signals:
     void finished(AssetRequest* thisRequest);
     void progress(qint64 totalReceived, qint64 total);
 
 private:
+    struct Chunk {
+        AssetUtils::DataOffset start;
+        AssetUtils::DataOffset end;
+        MessageID requestID { INVALID_MESSAGE_ID };
+        bool received { false };
+    };
+
+    void requestAsset();
+    // downloads the rest of an asset larger than a chunk, given the first chunk of it
+    void requestChunks(AssetUtils::DataOffset size, const QByteArray& firstChunk);
+    void requestNextChunks();
+    void handleChunk(size_t chunkIndex, const QByteArray& data);
+    void hashReceivedChunks();
+    // verifies and caches the asset once every chunk is in, returns whether the request finished
+    bool finishChunks();
+
+    bool openPartialDownload(AssetUtils::DataOffset size);
+    void removePartialDownload();
+    void closePartialDownload();
+
+    Error errorForReply(bool responseReceived, AssetUtils::AssetServerError serverError) const;
+    void finish(Error error);
+
     int _requestID;
     State _state = NotStarted;
     Error _error = NoError;
@@ -72,6 +118,20 @@ private:
     MessageID _assetRequestID { INVALID_MESSAGE_ID };
     const ByteRange _byteRange;
     bool _loadedFromCache { false };
+
+    std::vector<Chunk> _chunks;
+    size_t _nextChunk { 0 };
+    size_t _numHashedChunks { 0 };
+    int _numResumedChunks { 0 };
+    QCryptographicHash _hasher { QCryptographicHash::Sha256 };
+
+    // data of the chunks received so far, and one byte per chunk flagging the chunks that are complete
+    std::unique_ptr<QFile> _partialFile;
+    std::unique_ptr<QFile> _partialChunksFile;
+    // held while the partial files are open, concurrent requests for the same asset share their paths
+    std::unique_ptr<QLockFile> _partialLock;
+
+    static std::atomic<int> _maxParallelChunkRequests;
 };
 
 #endif
@@ -62,13 +62,40 @@ QByteArray hashData(const QByteArray& data) {
     return QCryptographicHash::hash(data, QCryptographicHash::Sha256);
 }
 
+// ATP content is addressed by its SHA-256, so it lives in the shared content cache where
+// identical bytes fetched over any other scheme are also stored
+static ContentCachePointer getContentCacheFor(const QUrl& url, AssetHash& hash) {
+    hash = extractAssetHash(url.toString());
+    if (hash.isEmpty() || !DependencyManager::isSet<ResourceManager>()) {
+        return ContentCachePointer();
+    }
+    return DependencyManager::get<ResourceManager>()->getContentCache();
+}
+
 QByteArray loadFromCache(const QUrl& url) {
+    AssetHash hash;
+    auto contentCache = getContentCacheFor(url, hash);
+    if (contentCache) {
+        auto data = contentCache->read(hash);
+        if (!data.isEmpty()) {
+            qCDebug(asset_client) << url.toDisplayString() << "loaded from content cache.";
+            return data;
+        }
+        qCDebug(asset_client) << url.toDisplayString() << "not in content cache";
+    }
+
     if (auto cache = NetworkAccessManager::getInstance().cache()) {
 
         // caller is responsible for the deletion of the ioDevice, hence the unique_ptr
         if (auto ioDevice = std::unique_ptr<QIODevice>(cache->data(url))) {
             qCDebug(asset_client) << url.toDisplayString() << "loaded from disk cache.";
-            return ioDevice->readAll();
+            auto data = ioDevice->readAll();
+
+            // assets cached before the content cache existed are moved into it on first use
+            if (contentCache && contentCache->write(hash, data)) {
+                cache->remove(url);
+            }
+            return data;
         } else {
             qCDebug(asset_client) << url.toDisplayString() << "not in disk cache";
         }
@@ -79,6 +106,16 @@ QByteArray loadFromCache(const QUrl& url) {
 }
 
 bool saveToCache(const QUrl& url, const QByteArray& file) {
+    AssetHash hash;
+    if (auto contentCache = getContentCacheFor(url, hash)) {
+        if (contentCache->write(hash, file)) {
+            qCDebug(asset_client) << url.toDisplayString() << "saved to content cache";
+            return true;
+        }
+        qCWarning(asset_client) << "Could not save" << url.toDisplayString() << "to content cache.";
+        return false;
+    }
+
     if (auto cache = NetworkAccessManager::getInstance().cache()) {
         if (!cache->metaData(url).isValid()) {
             QNetworkCacheMetaData metaData;
@@ -0,0 +1,120 @@
+//
+//  ContentCache.cpp
+//  libraries/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ContentCache.h"
+
+#include <QtCore/QBuffer>
+#include <QtCore/QFile>
+
+#include "AssetUtils.h"
+
+const std::string ContentCache::DIRNAME { "content_cache" };
+const std::string ContentCache::EXT { "bin" };
+
+ContentCache::ContentCache(const std::string& dirname, QObject* parent) :
+    FileCache(dirname, EXT, parent) { }
+
+QString ContentCache::hashContent(const QByteArray& data) {
+    return AssetUtils::hashData(data).toHex();
+}
+
+namespace {
+
+// Reads straight out of the mapped file; holding the cache entry keeps it from being evicted
+// while the mapping is in use.
+class MappedContent : public QBuffer {
+public:
+    MappedContent(const cache::FilePointer& file, std::unique_ptr<QFile> mappedFile, const uchar* data, qint64 size) :
+        _file(file),
+        _mappedFile(std::move(mappedFile)),
+        _content(QByteArray::fromRawData(reinterpret_cast<const char*>(data), (int)size)) {
+        setBuffer(&_content);
+        QBuffer::open(QIODevice::ReadOnly);
+    }
+
+    ~MappedContent() {
+        close();
+    }
+
+private:
+    cache::FilePointer _file;
+    std::unique_ptr<QFile> _mappedFile; // unmaps when destroyed
+    QByteArray _content;
+};
+
+}
+
+std::unique_ptr<QIODevice> ContentCache::open(const QString& hash) {
+    auto file = getFile(hash.toLower().toStdString());
+    if (!file) {
+        ++_misses;
+        return std::unique_ptr<QIODevice>();
+    }
+
+    auto size = (qint64)file->getLength();
+    std::unique_ptr<QFile> contentFile { new QFile(QString::fromStdString(file->getFilepath())) };
+    uchar* mapped = contentFile->open(QIODevice::ReadOnly) ? contentFile->map(0, size) : nullptr;
+    if (!mapped) {
+        qCWarning(file_cache) << "Failed to map content" << hash;
+        ++_misses;
+        return std::unique_ptr<QIODevice>();
+    }
+
+    ++_hits;
+    _bytesRead += size;
+    return std::unique_ptr<QIODevice>(new MappedContent(file, std::move(contentFile), mapped, size));
+}
+
+QByteArray ContentCache::read(const QString& hash) {
+    auto content = open(hash);
+    return content ? content->readAll() : QByteArray();
+}
+
+bool ContentCache::write(const QString& hash, const QByteArray& data) {
+    if (data.isEmpty()) {
+        return false;
+    }
+
+    auto key = hash.toLower().toStdString();
+    if (getFile(key)) {
+        _bytesDeduplicated += data.size();
+        return true;
+    }
+
+    if (!writeFile(data.constData(), Metadata(key, data.size()))) {
+        return false;
+    }
+
+    _bytesWritten += data.size();
+    return true;
+}
+
+QString ContentCache::write(const QByteArray& data) {
+    auto hash = hashContent(data);
+    return write(hash, data) ? hash : QString();
+}
+
+bool ContentCache::contains(const QString& hash) {
+    return (bool)getFile(hash.toLower().toStdString());
+}
+
+QVariantMap ContentCache::getStats() const {
+    QVariantMap stats;
+    stats["hits"] = getHits();
+    stats["misses"] = getMisses();
+    stats["bytesRead"] = getBytesRead();
+    stats["bytesWritten"] = getBytesWritten();
+    stats["bytesDeduplicated"] = getBytesDeduplicated();
+    stats["numFiles"] = (quint64)getNumTotalFiles();
+    stats["numUnusedFiles"] = (quint64)getNumCachedFiles();
+    stats["size"] = (quint64)getSizeTotalFiles();
+    stats["unusedSize"] = (quint64)getSizeCachedFiles();
+    return stats;
+}
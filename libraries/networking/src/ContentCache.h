@@ -0,0 +1,80 @@
+//
+//  ContentCache.h
+//  libraries/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ContentCache_h
+#define hifi_ContentCache_h
+
+#include <atomic>
+#include <memory>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QIODevice>
+#include <QtCore/QString>
+#include <QtCore/QVariantMap>
+
+#include <shared/FileCache.h>
+
+class ContentCacheTests;
+
+// On-disk cache of resource content keyed by the hex SHA-256 of the bytes themselves.  ATP hashes are
+// the SHA-256 of the asset, so ATP assets are stored and looked up by their hash directly; HTTP responses
+// land here through ContentDiskCache, so identical bytes reached through any URL or scheme are stored once.
+class ContentCache : public cache::FileCache {
+    Q_OBJECT
+    Q_PROPERTY(quint64 hits READ getHits NOTIFY dirty)
+    Q_PROPERTY(quint64 misses READ getMisses NOTIFY dirty)
+    Q_PROPERTY(quint64 bytesRead READ getBytesRead NOTIFY dirty)
+    Q_PROPERTY(quint64 bytesWritten READ getBytesWritten NOTIFY dirty)
+    Q_PROPERTY(quint64 bytesDeduplicated READ getBytesDeduplicated NOTIFY dirty)
+
+    friend class ::ContentCacheTests;
+
+public:
+    static const std::string DIRNAME;
+    static const std::string EXT;
+
+    ContentCache(const std::string& dirname = DIRNAME, QObject* parent = nullptr);
+
+    static QString hashContent(const QByteArray& data);
+
+    // Returns a read-only device over the memory-mapped content stored under hash, or nullptr on a miss.
+    // The content can't be evicted while the device is alive.
+    std::unique_ptr<QIODevice> open(const QString& hash);
+
+    // Returns the content stored under hash, or an empty array on a miss
+    QByteArray read(const QString& hash);
+
+    // Stores data under hash unless it is already present; returns false if it could not be written
+    bool write(const QString& hash, const QByteArray& data);
+
+    // Hashes data and stores it; returns the hash, or an empty string if it could not be written
+    QString write(const QByteArray& data);
+
+    bool contains(const QString& hash);
+
+    quint64 getHits() const { return _hits; }
+    quint64 getMisses() const { return _misses; }
+    quint64 getBytesRead() const { return _bytesRead; }
+    quint64 getBytesWritten() const { return _bytesWritten; }
+    quint64 getBytesDeduplicated() const { return _bytesDeduplicated; }
+
+    QVariantMap getStats() const;
+
+private:
+    std::atomic<quint64> _hits { 0 };
+    std::atomic<quint64> _misses { 0 };
+    std::atomic<quint64> _bytesRead { 0 };
+    std::atomic<quint64> _bytesWritten { 0 };
+    std::atomic<quint64> _bytesDeduplicated { 0 };
+};
+
+using ContentCachePointer = std::shared_ptr<ContentCache>;
+
+#endif // hifi_ContentCache_h
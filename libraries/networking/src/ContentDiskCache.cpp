@@ -0,0 +1,152 @@
+//
+//  ContentDiskCache.cpp
+//  libraries/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ContentDiskCache.h"
+
+#include <QtCore/QBuffer>
+
+#include <DependencyManager.h>
+
+#include "ResourceManager.h"
+
+const QNetworkRequest::Attribute ContentDiskCache::CONTENT_HASH_ATTRIBUTE =
+    (QNetworkRequest::Attribute)(QNetworkRequest::User + 1);
+
+ContentDiskCache::ContentDiskCache(QObject* parent) : QNetworkDiskCache(parent) { }
+
+ContentCachePointer ContentDiskCache::getContentCache() const {
+    if (!DependencyManager::isSet<ResourceManager>()) {
+        return ContentCachePointer();
+    }
+    return DependencyManager::get<ResourceManager>()->getContentCache();
+}
+
+QString ContentDiskCache::getContentHash(const QUrl& url) {
+    return QNetworkDiskCache::metaData(url).attributes().value(CONTENT_HASH_ATTRIBUTE).toString();
+}
+
+QIODevice* ContentDiskCache::data(const QUrl& url) {
+    auto contentCache = getContentCache();
+    auto hash = getContentHash(url);
+
+    if (hash.isEmpty()) {
+        auto device = QNetworkDiskCache::data(url);
+        if (!device || !contentCache) {
+            return device;
+        }
+
+        // entries written before the content cache existed hold their body inline, move it over
+        auto content = device->readAll();
+        delete device;
+        hash = contentCache->write(content);
+        if (!hash.isEmpty()) {
+            insertIndexEntry(QNetworkDiskCache::metaData(url), hash);
+        }
+
+        auto buffer = new QBuffer();
+        buffer->setData(content);
+        buffer->open(QIODevice::ReadOnly);
+        return buffer;
+    }
+
+    if (contentCache) {
+        if (auto content = contentCache->open(hash)) {
+            return content.release();
+        }
+    }
+
+    // the content was evicted, drop the entry so the resource is fetched again
+    QNetworkDiskCache::remove(url);
+    return nullptr;
+}
+
+QIODevice* ContentDiskCache::prepare(const QNetworkCacheMetaData& metaData) {
+    if (!getContentCache()) {
+        return QNetworkDiskCache::prepare(metaData);
+    }
+
+    if (!metaData.isValid() || !metaData.url().isValid() || !metaData.saveToDisk()) {
+        return nullptr;
+    }
+
+    auto buffer = new QBuffer();
+    buffer->open(QIODevice::ReadWrite);
+    _pendingInserts.insert(buffer, metaData);
+    return buffer;
+}
+
+void ContentDiskCache::insert(QIODevice* device) {
+    auto it = _pendingInserts.find(device);
+    if (it == _pendingInserts.end()) {
+        QNetworkDiskCache::insert(device);
+        return;
+    }
+
+    auto metaData = it.value();
+    _pendingInserts.erase(it);
+    auto content = static_cast<QBuffer*>(device)->data();
+    delete device;
+
+    auto contentCache = getContentCache();
+    auto hash = contentCache ? contentCache->write(content) : QString();
+    if (!hash.isEmpty()) {
+        insertIndexEntry(metaData, hash);
+    } else {
+        // empty bodies aren't content-addressed
+        insertInline(metaData, content);
+    }
+}
+
+bool ContentDiskCache::remove(const QUrl& url) {
+    for (auto it = _pendingInserts.begin(); it != _pendingInserts.end();) {
+        if (it.value().url() == url) {
+            delete it.key();
+            it = _pendingInserts.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    // the content itself may be shared with other entries, it is left to the content cache's eviction
+    return QNetworkDiskCache::remove(url);
+}
+
+void ContentDiskCache::updateMetaData(const QNetworkCacheMetaData& metaData) {
+    auto hash = getContentHash(metaData.url());
+    if (hash.isEmpty()) {
+        QNetworkDiskCache::updateMetaData(metaData);
+        return;
+    }
+    insertIndexEntry(metaData, hash);
+}
+
+void ContentDiskCache::clear() {
+    qDeleteAll(_pendingInserts.keys());
+    _pendingInserts.clear();
+    QNetworkDiskCache::clear();
+    if (auto contentCache = getContentCache()) {
+        contentCache->wipe();
+    }
+}
+
+void ContentDiskCache::insertIndexEntry(const QNetworkCacheMetaData& metaData, const QString& hash) {
+    auto attributes = metaData.attributes();
+    attributes[CONTENT_HASH_ATTRIBUTE] = hash;
+    QNetworkCacheMetaData indexMetaData(metaData);
+    indexMetaData.setAttributes(attributes);
+    insertInline(indexMetaData, QByteArray());
+}
+
+void ContentDiskCache::insertInline(const QNetworkCacheMetaData& metaData, const QByteArray& content) {
+    if (auto device = QNetworkDiskCache::prepare(metaData)) {
+        device->write(content);
+        QNetworkDiskCache::insert(device);
+    }
+}
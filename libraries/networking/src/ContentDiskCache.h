@@ -0,0 +1,51 @@
+//
+//  ContentDiskCache.h
+//  libraries/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ContentDiskCache_h
+#define hifi_ContentDiskCache_h
+
+#include <QtCore/QHash>
+#include <QtNetwork/QNetworkDiskCache>
+
+#include "ContentCache.h"
+
+// QNetworkDiskCache that keeps only the URL -> metadata index itself and stores response bodies in the
+// ResourceManager's ContentCache, keyed by their hash.  Responses with identical bytes, including ATP
+// assets, share one copy on disk, and cached bodies are served from a memory-mapped file.
+// Without a content cache (e.g. in the assignment clients) it behaves exactly like QNetworkDiskCache.
+class ContentDiskCache : public QNetworkDiskCache {
+    Q_OBJECT
+
+public:
+    static const QNetworkRequest::Attribute CONTENT_HASH_ATTRIBUTE;
+
+    ContentDiskCache(QObject* parent = nullptr);
+
+    QIODevice* data(const QUrl& url) override;
+    QIODevice* prepare(const QNetworkCacheMetaData& metaData) override;
+    void insert(QIODevice* device) override;
+    bool remove(const QUrl& url) override;
+    void updateMetaData(const QNetworkCacheMetaData& metaData) override;
+
+public slots:
+    void clear() override;
+
+protected:
+    virtual ContentCachePointer getContentCache() const;
+
+private:
+    QString getContentHash(const QUrl& url);
+    void insertIndexEntry(const QNetworkCacheMetaData& metaData, const QString& hash);
+    void insertInline(const QNetworkCacheMetaData& metaData, const QByteArray& content);
+
+    QHash<QIODevice*, QNetworkCacheMetaData> _pendingInserts;
+};
+
+#endif // hifi_ContentDiskCache_h
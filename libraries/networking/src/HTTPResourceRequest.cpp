@@ -142,7 +142,6 @@ void HTTPResourceRequest::onRequestFinished() {
             }
 
             recordBytesDownloadedInStats(STAT_HTTP_RESOURCE_TOTAL_BYTES, _data.size());
-
             break;
 
         case QNetworkReply::TimeoutError:
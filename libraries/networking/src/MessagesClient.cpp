@@ -32,6 +32,19 @@ MessagesClient::MessagesClient() {
     connect(nodeList.data(), &LimitedNodeList::nodeActivated, this, &MessagesClient::handleNodeActivated);
 }
 
+const QString MessagesClient::SCRIPT_PROFILER_CHANNEL = "com.highfidelity.scriptProfiler";
+
+bool MessagesClient::canSendOnChannel(const QString& channel, const NodePermissions& permissions) {
+    if (channel == SCRIPT_PROFILER_CHANNEL) {
+        // the same nodes that may watch the entity script server's log may profile scripts
+        return permissions.can(NodePermissions::Permission::canRezPermanentEntities) ||
+            permissions.can(NodePermissions::Permission::canRezTemporaryEntities) ||
+            permissions.can(NodePermissions::Permission::canRezPermanentCertifiedEntities) ||
+            permissions.can(NodePermissions::Permission::canRezTemporaryCertifiedEntities);
+    }
+    return true;
+}
+
 void MessagesClient::decodeMessagesPacket(QSharedPointer<ReceivedMessage> receivedMessage, QString& channel, 
                                                 bool& isText, QString& message, QByteArray& data, QUuid& senderID) {
     quint16 channelLength;
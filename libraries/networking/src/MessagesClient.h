@@ -167,6 +167,13 @@ public:
     static std::unique_ptr<NLPacketList> encodeMessagesPacket(QString channel, QString message, QUuid senderID);
     static std::unique_ptr<NLPacketList> encodeMessagesDataPacket(QString channel, QByteArray data, QUuid senderID);
 
+    // Commands for the script profilers of the assignment clients, restricted to nodes with rez rights
+    static const QString SCRIPT_PROFILER_CHANNEL;
+
+    // The messages mixer drops what is sent on a restricted channel by a node without the rights for it, so the nodes
+    // listening on one can trust what they receive without knowing the sender
+    static bool canSendOnChannel(const QString& channel, const NodePermissions& permissions);
+
 signals:
     /**jsdoc
      * Triggered when the a text message is received.
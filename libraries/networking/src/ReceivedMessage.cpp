@@ -12,6 +12,8 @@
 
 #include "ReceivedMessage.h"
 
+#include <algorithm>
+
 #include "QSharedPointer"
 
 int receivedMessageMetaTypeId = qRegisterMetaType<ReceivedMessage*>("ReceivedMessage*");
@@ -20,32 +22,44 @@ int sharedPtrReceivedMessageMetaTypeId = qRegisterMetaType<QSharedPointer<Receiv
 static const int HEAD_DATA_SIZE = 512;
 
 ReceivedMessage::ReceivedMessage(const NLPacketList& packetList)
-    : _data(packetList.getMessage()),
-      _headData(_data.mid(0, HEAD_DATA_SIZE)),
-      _numPackets(packetList.getNumPackets()),
+    : _numPackets(packetList.getNumPackets()),
       _sourceID(packetList.getSourceID()),
       _packetType(packetList.getType()),
       _packetVersion(packetList.getVersion()),
       _senderSockAddr(packetList.getSenderSockAddr())
 {
+    appendSegment(packetList.getMessage(), nullptr);
+    _headData = _segments.front().data.mid(0, HEAD_DATA_SIZE);
 }
 
 ReceivedMessage::ReceivedMessage(NLPacket& packet)
-    : _data(packet.readAll()),
-      _headData(_data.mid(0, HEAD_DATA_SIZE)),
-      _numPackets(1),
+    : _numPackets(1),
       _sourceID(packet.getSourceID()),
       _packetType(packet.getType()),
       _packetVersion(packet.getVersion()),
       _senderSockAddr(packet.getSenderSockAddr()),
       _isComplete(packet.getPacketPosition() == NLPacket::ONLY)
 {
+    appendSegment(packet.readAll(), nullptr);
+    _headData = _segments.front().data.mid(0, HEAD_DATA_SIZE);
+}
+
+ReceivedMessage::ReceivedMessage(std::unique_ptr<NLPacket> packet)
+    : _numPackets(1),
+      _sourceID(packet->getSourceID()),
+      _packetType(packet->getType()),
+      _packetVersion(packet->getVersion()),
+      _senderSockAddr(packet->getSenderSockAddr()),
+      _isComplete(packet->getPacketPosition() == NLPacket::ONLY)
+{
+    auto data = packet->readWithoutCopy(packet->bytesLeftToRead());
+    _headData = QByteArray(data.constData(), std::min(data.size(), HEAD_DATA_SIZE));
+    appendSegment(data, std::move(packet));
 }
 
 ReceivedMessage::ReceivedMessage(QByteArray byteArray, PacketType packetType, PacketVersion packetVersion,
                 const HifiSockAddr& senderSockAddr, NLPacket::LocalID sourceID) :
-    _data(byteArray),
-    _headData(_data.mid(0, HEAD_DATA_SIZE)),
+    _headData(byteArray.mid(0, HEAD_DATA_SIZE)),
     _numPackets(1),
     _sourceID(sourceID),
     _packetType(packetType),
@@ -53,6 +67,7 @@ ReceivedMessage::ReceivedMessage(QByteArray byteArray, PacketType packetType, Pa
     _senderSockAddr(senderSockAddr),
     _isComplete(true)
 {
+    appendSegment(byteArray, nullptr);
 }
 
 void ReceivedMessage::setFailed() {
@@ -61,17 +76,39 @@ void ReceivedMessage::setFailed() {
     emit completed();
 }
 
+void ReceivedMessage::appendSegment(QByteArray data, std::unique_ptr<NLPacket> packet) {
+    std::lock_guard<std::mutex> lock(_segmentsMutex);
+    qint64 offset = _size;
+    qint64 size = data.size();
+    _segments.push_back({ std::move(data), std::move(packet), offset });
+    _size += size;
+}
+
 void ReceivedMessage::appendPacket(NLPacket& packet) {
     Q_ASSERT_X(!_isComplete, "ReceivedMessage::appendPacket", 
                "We should not be appending to a complete message");
 
+    appendSegment(QByteArray(packet.getPayload(), packet.getPayloadSize()), nullptr);
+    packetAppended(packet);
+}
+
+void ReceivedMessage::appendPacket(std::unique_ptr<NLPacket> packet) {
+    Q_ASSERT_X(!_isComplete, "ReceivedMessage::appendPacket",
+               "We should not be appending to a complete message");
+
+    // the payload stays in the packet's buffer, which the segment keeps alive
+    auto payload = QByteArray::fromRawData(packet->getPayload(), packet->getPayloadSize());
+    auto& appendedPacket = *packet;
+    appendSegment(payload, std::move(packet));
+    packetAppended(appendedPacket);
+}
+
+void ReceivedMessage::packetAppended(const NLPacket& packet) {
     // Limit progress signal to every X packets
     const int EMIT_PROGRESS_EVERY_X_PACKETS = 50;
 
     ++_numPackets;
 
-    _data.append(packet.getPayload(), packet.getPayloadSize());
-
     if (_numPackets % EMIT_PROGRESS_EVERY_X_PACKETS == 0) {
         emit progress(getSize());
     }
@@ -82,13 +119,67 @@ void ReceivedMessage::appendPacket(NLPacket& packet) {
     }
 }
 
+size_t ReceivedMessage::segmentIndexAt(qint64 position) const {
+    auto it = std::upper_bound(_segments.begin(), _segments.end(), position, [](qint64 position, const Segment& segment) {
+        return position < segment.offset;
+    });
+    return it == _segments.begin() ? 0 : std::distance(_segments.begin(), it) - 1;
+}
+
+void ReceivedMessage::copyRange(char* data, qint64 position, qint64 size) const {
+    for (size_t i = segmentIndexAt(position); size > 0 && i < _segments.size(); ++i) {
+        const auto& segment = _segments[i];
+        qint64 segmentPosition = position - segment.offset;
+        qint64 toCopy = std::min(size, (qint64)segment.data.size() - segmentPosition);
+        memcpy(data, segment.data.constData() + segmentPosition, toCopy);
+        data += toCopy;
+        position += toCopy;
+        size -= toCopy;
+    }
+}
+
+QByteArray ReceivedMessage::contiguousData() const {
+    if (_segments.size() == 1) {
+        return _segments.front().data;
+    }
+
+    // assembled once, next to the segments, so views already handed out stay valid
+    if (_contiguousData.size() != _size) {
+        _contiguousData = QByteArray((int)_size, Qt::Uninitialized);
+        copyRange(_contiguousData.data(), 0, _size);
+    }
+    return _contiguousData;
+}
+
+QByteArray ReceivedMessage::getMessage() const {
+    std::lock_guard<std::mutex> lock(_segmentsMutex);
+    if (_segments.size() == 1 && _segments.front().packet) {
+        // a packet backed segment is raw data, hand out a deep copy that can outlive this message
+        const auto& data = _segments.front().data;
+        return QByteArray(data.constData(), data.size());
+    }
+    return contiguousData();
+}
+
+const char* ReceivedMessage::getRawMessage() const {
+    std::lock_guard<std::mutex> lock(_segmentsMutex);
+    return _segments.empty() ? nullptr : contiguousData().constData();
+}
+
+size_t ReceivedMessage::getNumSegments() const {
+    std::lock_guard<std::mutex> lock(_segmentsMutex);
+    return _segments.size();
+}
+
 qint64 ReceivedMessage::peek(char* data, qint64 size) {
-    memcpy(data, _data.constData() + _position, size);
+    std::lock_guard<std::mutex> lock(_segmentsMutex);
+    copyRange(data, _position, size);
     return size;
 }
 
 qint64 ReceivedMessage::read(char* data, qint64 size) {
-    memcpy(data, _data.constData() + _position, size);
+    std::lock_guard<std::mutex> lock(_segmentsMutex);
+    copyRange(data, _position, size);
     _position += size;
     return size;
 }
@@ -100,12 +191,25 @@ qint64 ReceivedMessage::readHead(char* data, qint64 size) {
 }
 
 QByteArray ReceivedMessage::peek(qint64 size) {
-    return _data.mid(_position, size);
+    std::lock_guard<std::mutex> lock(_segmentsMutex);
+    size = std::max(std::min(size, getBytesLeftToRead()), (qint64)0);
+
+    if (size > 0) {
+        const auto& segment = _segments[segmentIndexAt(_position)];
+        // share the buffer rather than copy it when a whole owned segment is requested
+        if (!segment.packet && segment.offset == _position && segment.data.size() == size) {
+            return segment.data;
+        }
+    }
+
+    QByteArray data((int)size, Qt::Uninitialized);
+    copyRange(data.data(), _position, size);
+    return data;
 }
 
 QByteArray ReceivedMessage::read(qint64 size) {
-    auto data = _data.mid(_position, size);
-    _position += size;
+    auto data = peek(size);
+    _position += data.size();
     return data;
 }
 
@@ -123,17 +227,54 @@ QString ReceivedMessage::readString() {
     uint32_t size;
     readPrimitive(&size);
     //Q_ASSERT(size <= _size - _position);
-    auto string = QString::fromUtf8(_data.constData() + _position, size);
-    _position += size;
+    auto string = QString::fromUtf8(readWithoutCopy(size));
     return string;
 }
 
 QByteArray ReceivedMessage::readWithoutCopy(qint64 size) {
-    QByteArray data { QByteArray::fromRawData(_data.constData() + _position, size) };
+    std::lock_guard<std::mutex> lock(_segmentsMutex);
+    QByteArray data;
+
+    if (size > 0) {
+        const auto& segment = _segments[segmentIndexAt(_position)];
+        qint64 segmentPosition = _position - segment.offset;
+        if (segmentPosition + size <= segment.data.size()) {
+            data = QByteArray::fromRawData(segment.data.constData() + segmentPosition, (int)size);
+        } else {
+            data = QByteArray((int)size, Qt::Uninitialized);
+            copyRange(data.data(), _position, size);
+        }
+    }
+
     _position += size;
     return data;
 }
 
+ReceivedMessage::SegmentViews ReceivedMessage::peekSegments(qint64 size) const {
+    std::lock_guard<std::mutex> lock(_segmentsMutex);
+    SegmentViews views;
+
+    qint64 position = _position;
+    for (size_t i = segmentIndexAt(position); size > 0 && i < _segments.size(); ++i) {
+        const auto& segment = _segments[i];
+        qint64 segmentPosition = position - segment.offset;
+        qint64 viewSize = std::min(size, (qint64)segment.data.size() - segmentPosition);
+        views.push_back({ segment.data.constData() + segmentPosition, viewSize });
+        position += viewSize;
+        size -= viewSize;
+    }
+
+    return views;
+}
+
+ReceivedMessage::SegmentViews ReceivedMessage::readSegments(qint64 size) {
+    auto views = peekSegments(size);
+    for (const auto& view : views) {
+        _position += view.size;
+    }
+    return views;
+}
+
 void ReceivedMessage::onComplete() {
     _isComplete = true;
     emit completed();
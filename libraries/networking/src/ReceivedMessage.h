@@ -16,26 +16,49 @@
 #include <QObject>
 
 #include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 #include "NLPacketList.h"
 
+// ReceivedMessage keeps the payloads of the packets that make up a message as a chain of
+// segments rather than appending them into one growing buffer. Packets handed over by
+// unique_ptr are kept alive and referenced in place, so a large reliable message is only
+// made contiguous if a consumer asks for it (getMessage/getRawMessage). The segments are
+// never released before the message, so views stay valid whatever is called afterwards.
 class ReceivedMessage : public QObject {
     Q_OBJECT
 public:
+    // A read-only view into one segment of the message. Like readWithoutCopy, a view is only
+    // valid for the lifetime of the ReceivedMessage it was taken from.
+    struct SegmentView {
+        const char* data;
+        qint64 size;
+    };
+    using SegmentViews = std::vector<SegmentView>;
+
     ReceivedMessage(const NLPacketList& packetList);
     ReceivedMessage(NLPacket& packet);
+    ReceivedMessage(std::unique_ptr<NLPacket> packet);
     ReceivedMessage(QByteArray byteArray, PacketType packetType, PacketVersion packetVersion,
                     const HifiSockAddr& senderSockAddr, NLPacket::LocalID sourceID = NLPacket::NULL_LOCAL_ID);
 
-    QByteArray getMessage() const { return _data; }
-    const char* getRawMessage() const { return _data.constData(); }
+    // Returns the whole message as one contiguous buffer that can outlive the message. This copies
+    // a message that references its packet; prefer getRawMessage or readWithoutCopy on hot paths.
+    QByteArray getMessage() const;
+    // Contiguous view of the whole message, valid for the lifetime of a complete message
+    const char* getRawMessage() const;
 
     PacketType getType() const { return _packetType; }
     PacketVersion getVersion() const { return _packetVersion; }
 
     void setFailed();
 
+    // Copies the payload of the packet into the message
     void appendPacket(NLPacket& packet);
+    // Takes ownership of the packet and references its payload in place
+    void appendPacket(std::unique_ptr<NLPacket> packet);
 
     bool failed() const { return _failed; }
     bool isComplete() const { return _isComplete; }
@@ -48,9 +71,12 @@ public:
     // Get the number of packets that were used to send this message
     qint64 getNumPackets() const { return _numPackets; }
 
-    qint64 getSize() const { return _data.size(); }
+    qint64 getSize() const { return _size; }
+
+    qint64 getBytesLeftToRead() const { return _size - _position; }
 
-    qint64 getBytesLeftToRead() const { return _data.size() -  _position; }
+    // Number of segments backing the message
+    size_t getNumSegments() const;
 
     void seek(qint64 position) { _position = position; }
 
@@ -72,8 +98,14 @@ public:
     // This will return a QByteArray referencing the underlying data _without_ refcounting that data.
     // Be careful when using this method, only use it when the lifetime of the returned QByteArray will not
     // exceed that of the ReceivedMessage.
+    // If the requested range spans more than one segment the returned QByteArray is a copy.
     QByteArray readWithoutCopy(qint64 size);
 
+    // Scatter-gather equivalents of peek/read: return views of the segments covering the next
+    // size bytes without copying them. Same lifetime caveats as readWithoutCopy.
+    SegmentViews peekSegments(qint64 size) const;
+    SegmentViews readSegments(qint64 size);
+
     template<typename T> qint64 peekPrimitive(T* data);
     template<typename T> qint64 readPrimitive(T* data);
 
@@ -87,9 +119,29 @@ private slots:
     void onComplete();
 
 private:
-    QByteArray _data;
+    struct Segment {
+        QByteArray data;
+        std::unique_ptr<NLPacket> packet; // set when data references the payload of a packet we own
+        qint64 offset;
+    };
+
+    void appendSegment(QByteArray data, std::unique_ptr<NLPacket> packet);
+    void packetAppended(const NLPacket& packet);
+
+    // returns the index of the segment containing position, must be called with _segmentsMutex held
+    size_t segmentIndexAt(qint64 position) const;
+    // copies size bytes starting at position into data, must be called with _segmentsMutex held
+    void copyRange(char* data, qint64 position, qint64 size) const;
+    // returns the whole message in one buffer, must be called with _segmentsMutex held
+    QByteArray contiguousData() const;
+
+    mutable std::mutex _segmentsMutex;
+    std::vector<Segment> _segments;
+    mutable QByteArray _contiguousData;
     QByteArray _headData;
 
+    std::atomic<qint64> _size { 0 };
+
     std::atomic<qint64> _position { 0 };
     std::atomic<qint64> _numPackets { 0 };
 
@@ -16,6 +16,7 @@
 #include <QNetworkDiskCache>
 #include <QStandardPaths>
 #include <QThread>
+#include <QDir>
 #include <QFileInfo>
 
 #include <SharedUtil.h>
@@ -25,6 +26,7 @@
 #include "HTTPResourceRequest.h"
 #include "NetworkAccessManager.h"
 #include "NetworkLogging.h"
+#include "ResourceCache.h"
 
 ResourceManager::ResourceManager(bool atpSupportEnabled) : _atpSupportEnabled(atpSupportEnabled) {
     _thread.setObjectName("Resource Manager Thread");
@@ -38,6 +40,24 @@ ResourceManager::ResourceManager(bool atpSupportEnabled) : _atpSupportEnabled(at
     _thread.start();
 }
 
+void ResourceManager::setCacheDir(const QString& cacheDir) {
+    ContentCachePointer contentCache;
+    if (!cacheDir.isEmpty()) {
+        auto dirname = QDir(cacheDir).absoluteFilePath(QString::fromStdString(ContentCache::DIRNAME));
+        contentCache = std::make_shared<ContentCache>(dirname.toStdString());
+        contentCache->initialize();
+        contentCache->setMaxSize(MAXIMUM_CACHE_SIZE);
+    }
+
+    QMutexLocker locker(&_contentCacheLock);
+    _contentCache = contentCache;
+}
+
+ContentCachePointer ResourceManager::getContentCache() const {
+    QMutexLocker locker(&_contentCacheLock);
+    return _contentCache;
+}
+
 void ResourceManager::setUrlPrefixOverride(const QString& prefix, const QString& replacement) {
     QMutexLocker locker(&_prefixMapLock);
     if (replacement.isEmpty()) {
@@ -20,6 +20,7 @@
 
 #include <DependencyManager.h>
 
+#include "ContentCache.h"
 #include "ResourceRequest.h"
 
 class ResourceManager: public QObject, public Dependency {
@@ -42,9 +43,14 @@ public:
     // to return to the calling thread so that events can still be processed.
     bool resourceExists(const QUrl& url);
 
-    // adjust where we persist the cache
+    // adjust where we persist the cache, content already cached in the old location is left there.
+    // The content cache isn't safe to share between processes, so it is off until the owning
+    // application opts in; an empty path turns it off again.
     void setCacheDir(const QString& cacheDir);
 
+    // content-hash keyed disk cache shared by ATP assets and cached HTTP responses, null when disabled
+    ContentCachePointer getContentCache() const;
+
 private:
     QThread _thread;
 
@@ -54,6 +60,9 @@ private:
     PrefixMap _prefixMap;
     QMutex _prefixMapLock;
 
+    mutable QMutex _contentCacheLock;
+    ContentCachePointer _contentCache;
+
 };
 
 #endif
@@ -13,3 +13,8 @@
 void ResourceScriptingInterface::overrideUrlPrefix(const QString& prefix, const QString& replacement) {
     DependencyManager::get<ResourceManager>()->setUrlPrefixOverride(prefix, replacement);
 }
+
+QVariantMap ResourceScriptingInterface::getContentCacheStats() {
+    auto contentCache = DependencyManager::get<ResourceManager>()->getContentCache();
+    return contentCache ? contentCache->getStats() : QVariantMap();
+}
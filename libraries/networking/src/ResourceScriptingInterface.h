@@ -14,6 +14,7 @@
 #define hifi_networking_ResourceScriptingInterface_h
 
 #include <QtCore/QObject>
+#include <QtCore/QVariantMap>
 
 #include <DependencyManager.h>
 
@@ -25,6 +26,9 @@ public:
     Q_INVOKABLE void restoreUrlPrefix(const QString& prefix) {
         overrideUrlPrefix(prefix, "");
     }
+
+    // hits, misses and byte counters of the content-hash keyed disk cache
+    Q_INVOKABLE QVariantMap getContentCacheStats();
 };
 
 
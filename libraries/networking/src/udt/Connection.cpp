@@ -444,7 +444,12 @@ bool Connection::processReceivedSequenceNumber(SequenceNumber sequenceNumber, in
         return false;
     }
     
-    _isReceivingData = true;
+    if (!_isReceivingData) {
+        _isReceivingData = true;
+
+        // let the socket know it needs to sync us again on SYN interval
+        _parentSocket->connectionStartedReceiving(_destination);
+    }
     
     // mark our last receive time as now (to push the potential expiry farther)
     _lastReceiveTime = p_high_resolution_clock::now();
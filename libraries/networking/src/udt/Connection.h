@@ -62,7 +62,9 @@ public:
     void sendReliablePacket(std::unique_ptr<Packet> packet);
     void sendReliablePacketList(std::unique_ptr<PacketList> packet);
 
-    void sync(); // rate control method, fired by Socket for all connections on SYN interval
+    void sync(); // rate control method, fired by Socket for receiving connections on SYN interval
+
+    bool isReceivingData() const { return _isReceivingData; }
 
     // return indicates if this packet should be processed
     bool processReceivedSequenceNumber(SequenceNumber sequenceNumber, int packetSize, int payloadSize);
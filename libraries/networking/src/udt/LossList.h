@@ -12,7 +12,7 @@
 #ifndef hifi_LossList_h
 #define hifi_LossList_h
 
-#include <list>
+#include <deque>
 
 #include "SequenceNumber.h"
 
@@ -30,7 +30,7 @@ public:
     void append(SequenceNumber seq);
     void append(SequenceNumber start, SequenceNumber end);
     
-    // inserts anywhere - MUCH slower
+    // inserts anywhere - slower
     void insert(SequenceNumber start, SequenceNumber end);
     
     bool remove(SequenceNumber seq);
@@ -44,7 +44,13 @@ public:
     void write(ControlPacket& packet, int maxPairs = -1);
     
 private:
-    std::list<std::pair<SequenceNumber, SequenceNumber>> _lossList;
+    using LossRange = std::pair<SequenceNumber, SequenceNumber>;
+    using LossRanges = std::deque<LossRange>;
+
+    // returns the first range that ends at or after seq, ranges are kept sorted so this is a binary search
+    LossRanges::iterator firstRangeEndingAtOrAfter(SequenceNumber seq);
+
+    LossRanges _lossList;
     int _length { 0 };
 };
     
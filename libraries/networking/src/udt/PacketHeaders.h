@@ -253,7 +253,8 @@ enum class AssetServerPacketVersion: PacketVersion {
     VegasCongestionControl = 19,
     RangeRequestSupport,
     RedirectedMappings,
-    BakingTextureMeta
+    BakingTextureMeta,
+    AssetSizeInGetReply
 };
 
 enum class AvatarMixerPacketVersion : PacketVersion {
@@ -278,11 +278,13 @@ void Socket::clearConnections() {
         // clear all of the current connections in the socket
         qCDebug(networking) << "Clearing all remaining connections in Socket.";
         _connectionsHash.clear();
+        _receivingConnections.clear();
     }
 }
 
 void Socket::cleanupConnection(HifiSockAddr sockAddr) {
     auto numErased = _connectionsHash.erase(sockAddr);
+    _receivingConnections.erase(sockAddr);
 
     if (numErased > 0) {
 #ifdef UDT_CONNECTION_DEBUG
@@ -429,20 +431,16 @@ void Socket::connectToSendSignal(const HifiSockAddr& destinationAddr, QObject* r
 
 void Socket::rateControlSync() {
 
-    // enumerate our list of connections and ask each of them to send off periodic ACK packet for rate control
+    // enumerate our list of receiving connections and ask each of them to send off periodic ACK packet for rate control
+    // connections that are not receiving data have nothing to do on SYN, so they are not in this list and cost nothing
 
     // the way we do this is a little funny looking - we need to avoid the case where we call sync and
     // (because of our Qt direct connection to the Connection's signal that it has been deactivated)
     // an iterator on _connectionsHash would be invalidated by our own call to cleanupConnection
 
-    // collect the sockets for all connections in a vector
+    // collect the sockets for all receiving connections in a vector
 
-    std::vector<HifiSockAddr> sockAddrVector;
-    sockAddrVector.reserve(_connectionsHash.size());
-
-    for (auto& connection : _connectionsHash) {
-        sockAddrVector.emplace_back(connection.first);
-    }
+    std::vector<HifiSockAddr> sockAddrVector(_receivingConnections.begin(), _receivingConnections.end());
 
     // enumerate that vector of HifiSockAddr objects
     for (auto& sockAddr : sockAddrVector) {
@@ -454,6 +452,15 @@ void Socket::rateControlSync() {
             // we're good to go
             auto& connection = _connectionsHash[sockAddr];
             connection->sync();
+
+            // look the connection up again since sync may have caused it to be cleaned up
+            it = _connectionsHash.find(sockAddr);
+            if (it == _connectionsHash.end() || !it->second->isReceivingData()) {
+                // the receive side of this connection expired (or was reset), park it until it receives data again
+                _receivingConnections.erase(sockAddr);
+            }
+        } else {
+            _receivingConnections.erase(sockAddr);
         }
     }
 
@@ -16,6 +16,7 @@
 
 #include <functional>
 #include <unordered_map>
+#include <unordered_set>
 #include <mutex>
 
 #include <QtCore/QObject>
@@ -88,6 +89,9 @@ public:
     
     StatsVector sampleStatsForAllConnections();
 
+    // called by a Connection when data starts arriving on it, so that it is synced until its receive side expires
+    void connectionStartedReceiving(const HifiSockAddr& sockAddr) { _receivingConnections.insert(sockAddr); }
+
 #if (PR_BUILD || DEV_BUILD)
     void sendFakedHandshakeRequest(const HifiSockAddr& sockAddr);
 #endif
@@ -133,6 +137,10 @@ private:
     std::unordered_map<HifiSockAddr, BasePacketHandler> _unfilteredHandlers;
     std::unordered_map<HifiSockAddr, SequenceNumber> _unreliableSequenceNumbers;
     std::unordered_map<HifiSockAddr, std::unique_ptr<Connection>> _connectionsHash;
+
+    // connections whose receive side is active - idle connections are parked outside of this set
+    // and cost nothing on SYN interval until they receive data again
+    std::unordered_set<HifiSockAddr> _receivingConnections;
     
     int _synInterval { 10 }; // 10ms
     QTimer* _synTimer { nullptr };
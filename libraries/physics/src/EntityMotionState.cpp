@@ -316,7 +316,7 @@ const btCollisionShape* EntityMotionState::computeNewShape() {
     ShapeInfo shapeInfo;
     assert(entityTreeIsLocked());
     _entity->computeShapeInfo(shapeInfo);
-    return getShapeManager()->getShape(shapeInfo);
+    return requestShape(shapeInfo);
 }
 
 void EntityMotionState::setShape(const btCollisionShape* shape) {
@@ -464,6 +464,18 @@ bool EntityMotionState::shouldSendUpdate(uint32_t simulationStep) {
     return remoteSimulationOutOfSync(simulationStep);
 }
 
+float EntityMotionState::getOutgoingVisualError() const {
+    // a rough measure (in meters) of how far our copy of the entity has drifted from what the entity-server
+    // is expected to have: the position error, plus what the velocity error adds over a short lookahead,
+    // plus the arc swept at the bounding radius by the rotation error
+    const float VELOCITY_LOOKAHEAD = 0.1f; // seconds
+    float positionError = glm::distance(_entity->getLocalPosition(), _serverPosition);
+    float velocityError = glm::distance(_entity->getLocalVelocity(), _serverVelocity);
+    float rotationError = 1.0f - fabsf(glm::dot(_entity->getLocalOrientation(), _serverRotation));
+    float radius = 0.5f * glm::length(_entity->getScaledDimensions());
+    return positionError + VELOCITY_LOOKAHEAD * velocityError + radius * rotationError;
+}
+
 void EntityMotionState::updateSendVelocities() {
     if (!_body->isActive()) {
         // make sure all derivatives are zero
@@ -806,6 +818,8 @@ bool EntityMotionState::isLocallyOwnedOrShouldBe() const {
 void EntityMotionState::initForBid() {
     assert(_ownershipState != EntityMotionState::OwnershipState::Unownable);
     _ownershipState = EntityMotionState::OwnershipState::PendingBid;
+    // the first bid goes out as soon as the outgoing budget of PhysicalEntitySimulation allows
+    _nextBidExpiry = 0;
 }
 
 void EntityMotionState::initForOwned() {
@@ -51,6 +51,7 @@ public:
     virtual void setWorldTransform(const btTransform& worldTrans) override;
 
     bool shouldSendUpdate(uint32_t simulationStep);
+    float getOutgoingVisualError() const;
     void sendBid(OctreeEditPacketSender* packetSender, uint32_t step);
     void sendUpdate(OctreeEditPacketSender* packetSender, uint32_t step);
 
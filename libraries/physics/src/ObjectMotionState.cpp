@@ -63,6 +63,12 @@ ShapeManager* ObjectMotionState::getShapeManager() {
     return shapeManager;
 }
 
+const btCollisionShape* ObjectMotionState::requestShape(const ShapeInfo& info) {
+    const btCollisionShape* shape = getShapeManager()->getShape(info);
+    _isNewShapeBuilding = !shape && getShapeManager()->isBuildingShape(info);
+    return shape;
+}
+
 ObjectMotionState::ObjectMotionState(const btCollisionShape* shape) :
     _shape(shape),
     _lastKinematicStep(worldSimulationStep)
@@ -291,6 +297,10 @@ bool ObjectMotionState::handleHardAndEasyChanges(uint32_t& flags, PhysicsEngine*
             return false;
         }
         const btCollisionShape* newShape = computeNewShape();
+        if (!newShape && _isNewShapeBuilding) {
+            // the new shape is still building on a worker so try again later
+            return false;
+        }
         if (!newShape) {
             qCDebug(physics) << "Warning: failed to generate new shape!";
             // failed to generate new shape! --> keep old shape and remove shape-change flag
@@ -171,6 +171,8 @@ public:
 protected:
     virtual bool isReadyToComputeShape() const = 0;
     virtual const btCollisionShape* computeNewShape() = 0;
+    // the shape for info from the ShapeManager, for computeNewShape()
+    const btCollisionShape* requestShape(const ShapeInfo& info);
     virtual void setMotionType(PhysicsMotionType motionType);
     void updateCCDConfiguration();
 
@@ -181,6 +183,7 @@ protected:
     PhysicsMotionType _motionType { MOTION_TYPE_STATIC }; // type of motion: KINEMATIC, DYNAMIC, or STATIC
 
     const btCollisionShape* _shape;
+    bool _isNewShapeBuilding { false }; // requestShape() came back empty because the shape is building on a worker
     btRigidBody* _body { nullptr };
     float _density { 1.0f };
 
@@ -12,6 +12,8 @@
 
 #include "PhysicalEntitySimulation.h"
 
+#include <algorithm>
+
 #include <Profile.h>
 
 #include "PhysicsHelpers.h"
@@ -234,16 +236,17 @@ void PhysicalEntitySimulation::getObjectsToAddToPhysics(VectorOfMotionStates& re
         } else if (entity->isReadyToComputeShape()) {
             ShapeInfo shapeInfo;
             entity->computeShapeInfo(shapeInfo);
-            int numPoints = shapeInfo.getLargestSubshapePointCount();
-            if (shapeInfo.getType() == SHAPE_TYPE_COMPOUND) {
-                if (numPoints > MAX_HULL_POINTS) {
-                    qWarning() << "convex hull with" << numPoints
-                        << "points for entity" << entity->getName()
-                        << "at" << entity->getWorldPosition() << " will be reduced";
-                }
-            }
             btCollisionShape* shape = const_cast<btCollisionShape*>(ObjectMotionState::getShapeManager()->getShape(shapeInfo));
             if (shape) {
+                // the shape may have been built asynchronously, in which case we only get here once it is ready
+                int numPoints = shapeInfo.getLargestSubshapePointCount();
+                if (shapeInfo.getType() == SHAPE_TYPE_COMPOUND) {
+                    if (numPoints > MAX_HULL_POINTS) {
+                        qWarning() << "convex hull with" << numPoints
+                            << "points for entity" << entity->getName()
+                            << "at" << entity->getWorldPosition() << " will be reduced";
+                    }
+                }
                 EntityMotionState* motionState = new EntityMotionState(shape, entity);
                 entity->setPhysicsInfo(static_cast<void*>(motionState));
                 _physicalObjects.insert(motionState);
@@ -322,8 +325,19 @@ void PhysicalEntitySimulation::handleChangedMotionStates(const VectorOfMotionSta
             clearOwnershipData();
         }
         // send updates before bids, because this simplifies the logic thasuccessful bids will immediately send an update when added to the 'owned' list
+        _numOutgoingEditsThisFrame = 0;
         sendOwnedUpdates(numSubsteps);
         sendOwnershipBids(numSubsteps);
+        if (_numOutgoingEditsThisFrame > 0) {
+            // release everything at once so this frame's edits share as few packets as possible
+            _entityPacketSender->releaseQueuedMessages();
+        }
+        PROFILE_COUNTER(simulation_physics, "OutgoingEdits", {
+            { "bidsSent", (qulonglong)_outgoingEditStats.bidsSent },
+            { "bidsDeferred", (qulonglong)_outgoingEditStats.bidsDeferred },
+            { "updatesSent", (qulonglong)_outgoingEditStats.updatesSent },
+            { "updatesDeferred", (qulonglong)_outgoingEditStats.updatesDeferred }
+        });
     }
 }
 
@@ -335,10 +349,10 @@ void PhysicalEntitySimulation::addOwnershipBid(EntityMotionState* motionState) {
         entity->setSimulationOwner(SimulationOwner(sessionID, SCRIPT_GRAB_SIMULATION_PRIORITY));
         _owned.push_back(motionState);
     } else {
+        // the bid itself is sent by sendOwnershipBids() when the outgoing budget allows
         motionState->initForBid();
-        motionState->sendBid(_entityPacketSender, _physicsEngine->getNumSubsteps());
         _bids.push_back(motionState);
-        _nextBidExpiry = glm::min(_nextBidExpiry, motionState->getNextBidExpiry());
+        _nextBidExpiry = 0;
     }
 }
 
@@ -347,11 +361,27 @@ void PhysicalEntitySimulation::addOwnership(EntityMotionState* motionState) {
     _owned.push_back(motionState);
 }
 
+float PhysicalEntitySimulation::computeOutgoingPriority(EntityMotionState* motionState, uint64_t now) const {
+    const EntityItemPointer& entity = motionState->getEntity();
+    float age = (float)(now - glm::min(now, entity->getLastBroadcast())) / (float)USECS_PER_SECOND;
+
+    float distance = 0.0f;
+    if (!_views.empty()) {
+        glm::vec3 position = entity->getWorldPosition();
+        distance = std::numeric_limits<float>::max();
+        for (const auto& view : _views) {
+            distance = glm::min(distance, glm::distance(position, view.getPosition()));
+        }
+    }
+    return computeOutgoingPriority(motionState->getOutgoingVisualError(), age, distance);
+}
+
 void PhysicalEntitySimulation::sendOwnershipBids(uint32_t numSubsteps) {
     uint64_t now = usecTimestampNow();
     if (now > _nextBidExpiry) {
         PROFILE_RANGE_EX(simulation_physics, "Bid", 0x00000000, (uint64_t)_bids.size());
         _nextBidExpiry = std::numeric_limits<uint64_t>::max();
+        _outgoingCandidates.clear();
         uint32_t i = 0;
         while (i < _bids.size()) {
             bool removeBid = false;
@@ -360,8 +390,11 @@ void PhysicalEntitySimulation::sendOwnershipBids(uint32_t numSubsteps) {
                 // in the EntityMotionState::_serverFoo variables (please see comments in EntityMotionState.h)
                 // therefore we need to immediately send an update so that the values stored are what we're
                 // "telling" the server rather than what we've been "hearing" from the server.
+                // This update is never deferred but it does count against the budget.
                 _bids[i]->slaveBidPriority();
                 _bids[i]->sendUpdate(_entityPacketSender, numSubsteps);
+                ++_numOutgoingEditsThisFrame;
+                ++_outgoingEditStats.updatesSent;
 
                 addOwnership(_bids[i]);
                 removeBid = true;
@@ -373,17 +406,36 @@ void PhysicalEntitySimulation::sendOwnershipBids(uint32_t numSubsteps) {
                 _bids.remove(i);
             } else {
                 if (now > _bids[i]->getNextBidExpiry()) {
-                    _bids[i]->sendBid(_entityPacketSender, numSubsteps);
+                    _outgoingCandidates.push_back({ computeOutgoingPriority(_bids[i], now), _bids[i] });
+                } else {
                     _nextBidExpiry = glm::min(_nextBidExpiry, _bids[i]->getNextBidExpiry());
                 }
                 ++i;
             }
         }
+
+        uint32_t budget = computeOutgoingBudget(_maxOutgoingEditsPerFrame, _numOutgoingEditsThisFrame);
+        sortOutgoingCandidates(_outgoingCandidates, budget);
+        for (size_t j = 0; j < _outgoingCandidates.size(); ++j) {
+            EntityMotionState* motionState = _outgoingCandidates[j].second;
+            if (j < budget) {
+                motionState->sendBid(_entityPacketSender, numSubsteps);
+                _nextBidExpiry = glm::min(_nextBidExpiry, motionState->getNextBidExpiry());
+                ++_numOutgoingEditsThisFrame;
+                ++_outgoingEditStats.bidsSent;
+            } else {
+                // try again next frame
+                _nextBidExpiry = 0;
+                ++_outgoingEditStats.bidsDeferred;
+            }
+        }
     }
 }
 
 void PhysicalEntitySimulation::sendOwnedUpdates(uint32_t numSubsteps) {
     PROFILE_RANGE_EX(simulation_physics, "Update", 0x00000000, (uint64_t)_owned.size());
+    uint64_t now = usecTimestampNow();
+    _outgoingCandidates.clear();
     uint32_t i = 0;
     while (i < _owned.size()) {
         if (!_owned[i]->isLocallyOwned()) {
@@ -395,11 +447,26 @@ void PhysicalEntitySimulation::sendOwnedUpdates(uint32_t numSubsteps) {
             _owned.remove(i);
         } else {
             if (_owned[i]->shouldSendUpdate(numSubsteps)) {
-                _owned[i]->sendUpdate(_entityPacketSender, numSubsteps);
+                _outgoingCandidates.push_back({ computeOutgoingPriority(_owned[i], now), _owned[i] });
             }
             ++i;
         }
     }
+
+    uint32_t budget = computeOutgoingBudget(_maxOutgoingEditsPerFrame, _numOutgoingEditsThisFrame);
+    sortOutgoingCandidates(_outgoingCandidates, budget);
+    for (size_t j = 0; j < _outgoingCandidates.size(); ++j) {
+        EntityMotionState* motionState = _outgoingCandidates[j].second;
+        // the server revokes ownership of things we stop talking about, so those go out regardless of budget
+        if (j < budget || now > motionState->getEntity()->getSimulationOwnershipExpiry()) {
+            motionState->sendUpdate(_entityPacketSender, numSubsteps);
+            ++_numOutgoingEditsThisFrame;
+            ++_outgoingEditStats.updatesSent;
+        } else {
+            // shouldSendUpdate() will notice the same error again next frame
+            ++_outgoingEditStats.updatesDeferred;
+        }
+    }
 }
 
 void PhysicalEntitySimulation::handleCollisionEvents(const CollisionEvents& collisionEvents) {
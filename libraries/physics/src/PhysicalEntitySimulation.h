@@ -14,11 +14,15 @@
 
 #include <stdint.h>
 
+#include <algorithm>
+#include <vector>
+
 #include <btBulletDynamicsCommon.h>
 #include <BulletCollision/CollisionDispatch/btGhostObject.h>
 
 #include <EntityItem.h>
 #include <EntitySimulation.h>
+#include <shared/ConicalViewFrustum.h>
 
 #include "PhysicsEngine.h"
 #include "EntityMotionState.h"
@@ -38,6 +42,16 @@ public:
     }
 };
 
+const uint32_t DEFAULT_MAX_OUTGOING_EDITS_PER_FRAME = 64;
+
+// running totals of the ownership bids and updates that made it into the outgoing budget
+struct OutgoingEditStats {
+    uint64_t bidsSent { 0 };
+    uint64_t bidsDeferred { 0 };
+    uint64_t updatesSent { 0 };
+    uint64_t updatesDeferred { 0 };
+};
+
 class PhysicalEntitySimulation : public EntitySimulation {
     Q_OBJECT
 public:
@@ -86,7 +100,38 @@ public:
     void sendOwnershipBids(uint32_t numSubsteps);
     void sendOwnedUpdates(uint32_t numSubsteps);
 
+    // Bids and updates share a budget of edits per physics frame.  When there are more candidates than the
+    // budget allows they are sent in order of visual error weighted by proximity to the views, and the rest
+    // wait for the next frame.  Everything sent in one frame is released together so edits share packets.
+    void setViews(const ConicalViewFrustums& views) { _views = views; }
+    void setMaxOutgoingEditsPerFrame(uint32_t maxEdits) { _maxOutgoingEditsPerFrame = maxEdits; }
+    uint32_t getMaxOutgoingEditsPerFrame() const { return _maxOutgoingEditsPerFrame; }
+    const OutgoingEditStats& getOutgoingEditStats() const { return _outgoingEditStats; }
+
+    // the scheduling rules behind the budget, kept inline so they can be exercised without an entity tree
+    static float computeOutgoingPriority(float visualError, float secondsSinceBroadcast, float distanceToView) {
+        // visual error (plus a little for every second since the last send, so nothing starves)
+        // divided by the distance to the nearest view
+        const float AGE_WEIGHT = 0.01f; // meters of error per second
+        return (visualError + AGE_WEIGHT * secondsSinceBroadcast) / (1.0f + distanceToView);
+    }
+    static uint32_t computeOutgoingBudget(uint32_t maxEdits, uint32_t numSentThisFrame) {
+        return maxEdits - glm::min(maxEdits, numSentThisFrame);
+    }
+    // moves the 'budget' highest priority candidates to the front, in descending order
+    template <typename T>
+    static void sortOutgoingCandidates(std::vector<std::pair<float, T>>& candidates, uint32_t budget) {
+        if (candidates.size() > budget) {
+            std::partial_sort(candidates.begin(), candidates.begin() + budget, candidates.end(),
+                [](const std::pair<float, T>& a, const std::pair<float, T>& b) {
+                    return a.first > b.first;
+                });
+        }
+    }
+
 private:
+    float computeOutgoingPriority(EntityMotionState* motionState, uint64_t now) const;
+
     SetOfEntities _entitiesToAddToPhysics;
     SetOfEntities _entitiesToRemoveFromPhysics;
 
@@ -104,6 +149,12 @@ private:
     VectorOfEntityMotionStates _bids;
     uint64_t _nextBidExpiry;
     uint32_t _lastStepSendPackets { 0 };
+
+    ConicalViewFrustums _views;
+    std::vector<std::pair<float, EntityMotionState*>> _outgoingCandidates;
+    OutgoingEditStats _outgoingEditStats;
+    uint32_t _maxOutgoingEditsPerFrame { DEFAULT_MAX_OUTGOING_EDITS_PER_FRAME };
+    uint32_t _numOutgoingEditsThisFrame { 0 };
 };
 
 
@@ -11,6 +11,7 @@
 
 #include "PhysicsEngine.h"
 
+#include <algorithm>
 #include <functional>
 
 #include <QFile>
@@ -68,6 +69,14 @@ void PhysicsEngine::init() {
         // in order for its broadphase collision queries to work correctly. Look at how we use
         // _activeStaticBodies to track and update the Aabb's of moved static objects.
         _dynamicsWorld->setForceUpdateAllAabbs(false);
+        _dynamicsWorld->setNumWorkerThreads(_numWorkerThreads);
+    }
+}
+
+void PhysicsEngine::setNumWorkerThreads(int numThreads) {
+    _numWorkerThreads = std::max(1, numThreads);
+    if (_dynamicsWorld) {
+        _dynamicsWorld->setNumWorkerThreads(_numWorkerThreads);
     }
 }
 
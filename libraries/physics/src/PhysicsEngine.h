@@ -92,6 +92,10 @@ public:
 
     void dumpNextStats() { _dumpNextStats = true; }
 
+    // number of threads used to step the simulation, 1 means everything runs on the calling thread
+    void setNumWorkerThreads(int numThreads);
+    int getNumWorkerThreads() const { return _numWorkerThreads; }
+
     EntityDynamicPointer getDynamicByID(const QUuid& dynamicID) const;
     bool addDynamic(EntityDynamicPointer dynamic);
     void removeDynamic(const QUuid dynamicID);
@@ -139,6 +143,7 @@ private:
 
     bool _dumpNextStats { false };
     bool _saveNextStats { false };
+    int _numWorkerThreads { 1 };
     bool _hasOutgoingChanges { false };
 
 };
@@ -0,0 +1,64 @@
+//
+//  ShapeCache.cpp
+//  libraries/physics/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ShapeCache.h"
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QFile>
+
+#include "PhysicsLogging.h"
+#include "ShapeFactory.h"
+
+const std::string ShapeCache::DIRNAME { "shape_cache" };
+const std::string ShapeCache::EXT { "shape" };
+
+ShapeCache::ShapeCache(const std::string& dirname) :
+    FileCache(dirname, EXT) { }
+
+cache::FileCache::Key ShapeCache::getKey(const ShapeInfo& info) {
+    // The ShapeInfo hash only covers the url and dimensions of model shapes, and the content behind a url
+    // can change between sessions, so the points and indices the shape is built from are digested as well.
+    QCryptographicHash digest(QCryptographicHash::Sha1);
+    for (const auto& points : info.getPointCollection()) {
+        digest.addData(reinterpret_cast<const char*>(points.constData()), points.size() * sizeof(glm::vec3));
+    }
+    const auto& indices = info.getTriangleIndices();
+    digest.addData(reinterpret_cast<const char*>(indices.constData()), indices.size() * sizeof(int32_t));
+
+    return QString("%1_%2_%3").arg(info.getType())
+        .arg(info.getHash().getHash64(), 16, 16, QChar('0'))
+        .arg(QString(digest.result().toHex())).toStdString();
+}
+
+const btCollisionShape* ShapeCache::loadShape(const ShapeInfo& info) {
+    auto file = getFile(getKey(info));
+    if (!file) {
+        return nullptr;
+    }
+
+    QFile shapeFile(QString::fromStdString(file->getFilepath()));
+    if (!shapeFile.open(QIODevice::ReadOnly)) {
+        return nullptr;
+    }
+
+    const btCollisionShape* shape = ShapeFactory::deserializeShape(info, shapeFile.readAll());
+    if (!shape) {
+        qCDebug(physics) << "ShapeCache: ignoring unusable entry" << file->getKey().c_str();
+    }
+    return shape;
+}
+
+void ShapeCache::saveShape(const ShapeInfo& info, const btCollisionShape* shape) {
+    QByteArray data;
+    if (ShapeFactory::serializeShape(shape, data)) {
+        const bool OVERWRITE = true;
+        writeFile(data.constData(), Metadata(getKey(info), data.size()), OVERWRITE);
+    }
+}
@@ -0,0 +1,42 @@
+//
+//  ShapeCache.h
+//  libraries/physics/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ShapeCache_h
+#define hifi_ShapeCache_h
+
+#include <btBulletDynamicsCommon.h>
+
+#include <ShapeInfo.h>
+#include <shared/FileCache.h>
+
+// The ShapeCache persists the expensive parts of built collision shapes (convex hulls and
+// static mesh BVHs) on disk, keyed by the ShapeInfo hash, so they survive across sessions.
+// It is safe to use from the ShapeManager's build workers.
+
+class ShapeCache : public cache::FileCache {
+    Q_OBJECT
+
+public:
+    static const std::string DIRNAME;
+    static const std::string EXT;
+
+    ShapeCache(const std::string& dirname = DIRNAME);
+
+    /// \return a new shape restored from disk, or nullptr if there is no usable entry
+    const btCollisionShape* loadShape(const ShapeInfo& info);
+
+    /// store shape under the info's hash, if it is a kind of shape worth caching
+    void saveShape(const ShapeInfo& info, const btCollisionShape* shape);
+
+private:
+    static Key getKey(const ShapeInfo& info);
+};
+
+#endif // hifi_ShapeCache_h
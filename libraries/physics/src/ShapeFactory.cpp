@@ -13,6 +13,9 @@
 
 #include <glm/gtx/norm.hpp>
 
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDataStream>
+
 #include <SharedUtil.h> // for MILLIMETERS_PER_METER
 
 #include "BulletUtil.h"
@@ -27,7 +30,21 @@ public:
         assert(_dataArray);
     }
 
+    // use a BVH that was deserialized in place into bvhBuffer rather than building one
+    StaticMeshShape(btTriangleIndexVertexArray* dataArray, btOptimizedBvh* bvh, void* bvhBuffer)
+    :   btBvhTriangleMeshShape(dataArray, true, false), _dataArray(dataArray), _bvhBuffer(bvhBuffer) {
+        assert(_dataArray && bvh && _bvhBuffer);
+        setOptimizedBvh(bvh);
+    }
+
     ~StaticMeshShape() {
+        if (_bvhBuffer) {
+            // the BVH lives inside _bvhBuffer and is not owned by the base class
+            m_bvh->~btOptimizedBvh();
+            m_bvh = nullptr;
+            btAlignedFree(_bvhBuffer);
+            _bvhBuffer = nullptr;
+        }
         assert(_dataArray);
         IndexedMeshArray& meshes = _dataArray->getIndexedMeshArray();
         for (int32_t i = 0; i < meshes.size(); ++i) {
@@ -47,6 +64,7 @@ public:
 private:
     // the StaticMeshShape owns its vertex/index data
     btTriangleIndexVertexArray* _dataArray;
+    void* _bvhBuffer { nullptr };
 };
 
 // the dataArray must be created before we create the StaticMeshShape
@@ -470,3 +488,182 @@ void ShapeFactory::deleteShape(const btCollisionShape* shape) {
     }
     delete nonConstShape;
 }
+
+// serialized shape format: header followed by one node per shape, compounds recurse into their children
+static const quint32 SERIALIZED_SHAPE_MAGIC = 0x48465348; // "HFSH"
+// bump whenever the serialized format or the way shapes are built changes
+static const quint32 SERIALIZED_SHAPE_VERSION = 2;
+static const int BVH_BUFFER_ALIGNMENT = 16;
+
+enum SerializedShapeNode : quint8 {
+    SERIALIZED_HULL = 1,
+    SERIALIZED_COMPOUND,
+    SERIALIZED_STATIC_MESH
+};
+
+static void writeVector(QDataStream& stream, const btVector3& vector) {
+    stream << (float)vector.getX() << (float)vector.getY() << (float)vector.getZ();
+}
+
+static btVector3 readVector(QDataStream& stream) {
+    float x, y, z;
+    stream >> x >> y >> z;
+    return btVector3(x, y, z);
+}
+
+static bool serializeNode(QDataStream& stream, const btCollisionShape* shape) {
+    switch (shape->getShapeType()) {
+        case CONVEX_HULL_SHAPE_PROXYTYPE: {
+            auto hull = static_cast<const btConvexHullShape*>(shape);
+            int32_t numPoints = hull->getNumPoints();
+            stream << (quint8)SERIALIZED_HULL << (float)hull->getMargin() << numPoints;
+            const btVector3* points = hull->getUnscaledPoints();
+            for (int32_t i = 0; i < numPoints; ++i) {
+                writeVector(stream, points[i]);
+            }
+            return true;
+        }
+        case COMPOUND_SHAPE_PROXYTYPE: {
+            auto compound = static_cast<const btCompoundShape*>(shape);
+            int32_t numChildren = compound->getNumChildShapes();
+            stream << (quint8)SERIALIZED_COMPOUND << numChildren;
+            for (int32_t i = 0; i < numChildren; ++i) {
+                const btTransform& transform = compound->getChildTransform(i);
+                btQuaternion rotation = transform.getRotation();
+                writeVector(stream, transform.getOrigin());
+                stream << (float)rotation.getX() << (float)rotation.getY() << (float)rotation.getZ() << (float)rotation.getW();
+                if (!serializeNode(stream, compound->getChildShape(i))) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        case TRIANGLE_MESH_SHAPE_PROXYTYPE: {
+            // the mesh itself is cheap to rebuild from the ShapeInfo, it's the BVH we want to keep
+            auto meshShape = const_cast<btBvhTriangleMeshShape*>(static_cast<const btBvhTriangleMeshShape*>(shape));
+            btOptimizedBvh* bvh = meshShape->getOptimizedBvh();
+            if (!bvh) {
+                return false;
+            }
+            quint32 bufferSize = bvh->calculateSerializeBufferSize();
+            void* buffer = btAlignedAlloc(bufferSize, BVH_BUFFER_ALIGNMENT);
+            bool success = bvh->serializeInPlace(buffer, bufferSize, false);
+            if (success) {
+                // Bullet trusts the counts inside the buffer, so the buffer carries a digest to check it against
+                QByteArray digest = QCryptographicHash::hash(QByteArray::fromRawData(static_cast<const char*>(buffer), bufferSize),
+                                                             QCryptographicHash::Sha1);
+                stream << (quint8)SERIALIZED_STATIC_MESH << bufferSize << digest;
+                stream.writeRawData(static_cast<const char*>(buffer), bufferSize);
+            }
+            btAlignedFree(buffer);
+            return success;
+        }
+        default:
+            return false;
+    }
+}
+
+static btCollisionShape* deserializeNode(QDataStream& stream, const ShapeInfo& info) {
+    quint8 node;
+    stream >> node;
+    switch (node) {
+        case SERIALIZED_HULL: {
+            float margin;
+            int32_t numPoints;
+            stream >> margin >> numPoints;
+            if (stream.status() != QDataStream::Ok || numPoints <= 0) {
+                return nullptr;
+            }
+            btConvexHullShape* hull = new btConvexHullShape();
+            hull->setMargin(margin);
+            for (int32_t i = 0; i < numPoints && stream.status() == QDataStream::Ok; ++i) {
+                hull->addPoint(readVector(stream), false);
+            }
+            hull->recalcLocalAabb();
+            return hull;
+        }
+        case SERIALIZED_COMPOUND: {
+            int32_t numChildren;
+            stream >> numChildren;
+            if (stream.status() != QDataStream::Ok || numChildren <= 0) {
+                return nullptr;
+            }
+            auto compound = new btCompoundShape();
+            for (int32_t i = 0; i < numChildren; ++i) {
+                btVector3 origin = readVector(stream);
+                float x, y, z, w;
+                stream >> x >> y >> z >> w;
+                btCollisionShape* child = deserializeNode(stream, info);
+                if (!child) {
+                    ShapeFactory::deleteShape(compound);
+                    return nullptr;
+                }
+                compound->addChildShape(btTransform(btQuaternion(x, y, z, w), origin), child);
+            }
+            return compound;
+        }
+        case SERIALIZED_STATIC_MESH: {
+            quint32 bufferSize;
+            QByteArray digest;
+            stream >> bufferSize >> digest;
+            if (stream.status() != QDataStream::Ok || bufferSize < sizeof(btOptimizedBvh) ||
+                    bufferSize > (quint64)stream.device()->bytesAvailable() || info.getType() != SHAPE_TYPE_STATIC_MESH) {
+                return nullptr;
+            }
+            void* buffer = btAlignedAlloc(bufferSize, BVH_BUFFER_ALIGNMENT);
+            if (stream.readRawData(static_cast<char*>(buffer), bufferSize) != (int)bufferSize ||
+                    QCryptographicHash::hash(QByteArray::fromRawData(static_cast<const char*>(buffer), bufferSize),
+                                             QCryptographicHash::Sha1) != digest ||
+                    static_cast<btOptimizedBvh*>(buffer)->calculateSerializeBufferSize() != bufferSize) {
+                // corrupt, or not what serializeNode() wrote
+                btAlignedFree(buffer);
+                return nullptr;
+            }
+            auto bvh = static_cast<btOptimizedBvh*>(btOptimizedBvh::deSerializeInPlace(buffer, bufferSize, false));
+            if (!bvh) {
+                btAlignedFree(buffer);
+                return nullptr;
+            }
+            btTriangleIndexVertexArray* dataArray = createStaticMeshArray(info);
+            if (!dataArray) {
+                bvh->~btOptimizedBvh();
+                btAlignedFree(buffer);
+                return nullptr;
+            }
+            return new StaticMeshShape(dataArray, bvh, buffer);
+        }
+        default:
+            return nullptr;
+    }
+}
+
+bool ShapeFactory::serializeShape(const btCollisionShape* shape, QByteArray& data) {
+    assert(shape);
+    data.clear();
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+    stream << SERIALIZED_SHAPE_MAGIC << SERIALIZED_SHAPE_VERSION;
+    if (!serializeNode(stream, shape)) {
+        data.clear();
+        return false;
+    }
+    return true;
+}
+
+const btCollisionShape* ShapeFactory::deserializeShape(const ShapeInfo& info, const QByteArray& data) {
+    QDataStream stream(data);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+    quint32 magic, version;
+    stream >> magic >> version;
+    if (magic != SERIALIZED_SHAPE_MAGIC || version != SERIALIZED_SHAPE_VERSION) {
+        return nullptr;
+    }
+
+    btCollisionShape* shape = deserializeNode(stream, info);
+    if (shape && stream.status() != QDataStream::Ok) {
+        // truncated data
+        deleteShape(shape);
+        shape = nullptr;
+    }
+    return shape;
+}
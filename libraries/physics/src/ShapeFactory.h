@@ -15,6 +15,8 @@
 #include <btBulletDynamicsCommon.h>
 #include <glm/glm.hpp>
 
+#include <QtCore/QByteArray>
+
 #include <ShapeInfo.h>
 
 // The ShapeFactory assembles and correctly disassembles btCollisionShapes.
@@ -22,6 +24,11 @@
 namespace ShapeFactory {
     const btCollisionShape* createShapeFromInfo(const ShapeInfo& info);
     void deleteShape(const btCollisionShape* shape);
+
+    // Hulls, compounds of hulls and static mesh BVHs can be written out and restored so that
+    // their construction can be skipped.  Other shapes are cheap to build and are not serialized.
+    bool serializeShape(const btCollisionShape* shape, QByteArray& data);
+    const btCollisionShape* deserializeShape(const ShapeInfo& info, const QByteArray& data);
 };
 
 #endif // hifi_ShapeFactory_h
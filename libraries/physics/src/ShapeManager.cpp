@@ -11,16 +11,82 @@
 
 #include "ShapeManager.h"
 
+#include <algorithm>
+#include <functional>
+
 #include <glm/gtx/norm.hpp>
 
 #include <QDebug>
+#include <QtCore/QRunnable>
+#include <QtCore/QThread>
+
+#include <SharedUtil.h>
 
+#include "ShapeCache.h"
 #include "ShapeFactory.h"
 
+// the body asks again every frame, a build that failed is given another go now and then in case it was the input
+// that wasn't ready rather than the shape that can't be built
+static const quint64 FAILED_BUILD_RETRY_DELAY = 5 * USECS_PER_SECOND;
+
+static bool isExpensiveToBuild(const ShapeInfo& info) {
+    switch (info.getType()) {
+        case SHAPE_TYPE_COMPOUND:
+        case SHAPE_TYPE_SIMPLE_HULL:
+        case SHAPE_TYPE_SIMPLE_COMPOUND:
+        case SHAPE_TYPE_STATIC_MESH:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static const btCollisionShape* buildShape(const ShapeInfo& info, const std::shared_ptr<ShapeCache>& shapeCache) {
+    if (shapeCache && isExpensiveToBuild(info)) {
+        if (const btCollisionShape* shape = shapeCache->loadShape(info)) {
+            return shape;
+        }
+        const btCollisionShape* shape = ShapeFactory::createShapeFromInfo(info);
+        if (shape) {
+            shapeCache->saveShape(info, shape);
+        }
+        return shape;
+    }
+    return ShapeFactory::createShapeFromInfo(info);
+}
+
+class ShapeBuilder : public QRunnable {
+public:
+    using Callback = std::function<void(const btCollisionShape*)>;
+
+    ShapeBuilder(const ShapeInfo& info, std::shared_ptr<ShapeCache> shapeCache, Callback callback) :
+        _info(info), _shapeCache(shapeCache), _callback(callback) {}
+
+    void run() override {
+        _callback(buildShape(_info, _shapeCache));
+    }
+
+private:
+    ShapeInfo _info;
+    std::shared_ptr<ShapeCache> _shapeCache;
+    Callback _callback;
+};
+
 ShapeManager::ShapeManager() {
+    // leave some cores for the main, render and physics threads
+    const int RESERVED_THREADS = 2;
+    _buildPool.setMaxThreadCount(std::max(1, QThread::idealThreadCount() - RESERVED_THREADS));
 }
 
 ShapeManager::~ShapeManager() {
+    _buildPool.waitForDone();
+    for (auto& builtShape : _builtShapes) {
+        if (builtShape.second) {
+            ShapeFactory::deleteShape(builtShape.second);
+        }
+    }
+    _builtShapes.clear();
+
     int numShapes = _shapeMap.size();
     for (int i = 0; i < numShapes; ++i) {
         ShapeReference* shapeRef = _shapeMap.getAtIndex(i);
@@ -33,23 +99,82 @@ const btCollisionShape* ShapeManager::getShape(const ShapeInfo& info) {
     if (info.getType() == SHAPE_TYPE_NONE) {
         return nullptr;
     }
+    receiveBuiltShapes();
+
     HashKey key = info.getHash();
     ShapeReference* shapeRef = _shapeMap.find(key);
     if (shapeRef) {
         shapeRef->refCount++;
         return shapeRef->shape;
     }
-    const btCollisionShape* shape = ShapeFactory::createShapeFromInfo(info);
+
+    if (_buildShapesAsync && isExpensiveToBuild(info)) {
+        uint64_t hash = key.getHash64();
+        if (_pendingBuilds.find(hash) == _pendingBuilds.end()) {
+            auto failed = _failedBuilds.find(hash);
+            if (failed == _failedBuilds.end() || usecTimestampNow() - failed->second > FAILED_BUILD_RETRY_DELAY) {
+                _failedBuilds.erase(hash);
+                submitBuild(info);
+            }
+        }
+        return nullptr;
+    }
+
+    const btCollisionShape* shape = buildShape(info, _shapeCache);
     if (shape) {
-        ShapeReference newRef;
-        newRef.refCount = 1;
-        newRef.shape = shape;
-        newRef.key = key;
-        _shapeMap.insert(key, newRef);
+        addShape(key, shape, 1);
     }
     return shape;
 }
 
+bool ShapeManager::isBuildingShape(const ShapeInfo& info) const {
+    return _pendingBuilds.find(info.getHash().getHash64()) != _pendingBuilds.end();
+}
+
+// private helper method
+void ShapeManager::addShape(const HashKey& key, const btCollisionShape* shape, int refCount) {
+    ShapeReference newRef;
+    newRef.refCount = refCount;
+    newRef.shape = shape;
+    newRef.key = key;
+    _shapeMap.insert(key, newRef);
+}
+
+// private helper method
+void ShapeManager::submitBuild(const ShapeInfo& info) {
+    HashKey key = info.getHash();
+    _pendingBuilds.insert(key.getHash64());
+    _buildPool.start(new ShapeBuilder(info, _shapeCache, [this, key](const btCollisionShape* shape) {
+        std::lock_guard<std::mutex> lock(_builtShapesMutex);
+        _builtShapes.push_back({ key, shape });
+    }));
+}
+
+// private helper method
+void ShapeManager::receiveBuiltShapes() {
+    std::vector<BuiltShape> builtShapes;
+    {
+        std::lock_guard<std::mutex> lock(_builtShapesMutex);
+        if (_builtShapes.empty()) {
+            return;
+        }
+        builtShapes.swap(_builtShapes);
+    }
+
+    for (auto& builtShape : builtShapes) {
+        const HashKey& key = builtShape.first;
+        _pendingBuilds.erase(key.getHash64());
+        if (!builtShape.second) {
+            _failedBuilds[key.getHash64()] = usecTimestampNow();
+        } else {
+            // nobody holds a reference until the body that asked for it comes back, so if it never does
+            // the shape is collected like any other unreferenced shape
+            addShape(key, builtShape.second, 0);
+            _pendingGarbage.push_back(key);
+        }
+    }
+}
+
 // private helper method
 bool ShapeManager::releaseShapeByKey(const HashKey& key) {
     ShapeReference* shapeRef = _shapeMap.find(key);
@@ -12,9 +12,17 @@
 #ifndef hifi_ShapeManager_h
 #define hifi_ShapeManager_h
 
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
 #include <btBulletDynamicsCommon.h>
 #include <LinearMath/btHashMap.h>
 
+#include <QtCore/QThreadPool>
+
 #include <ShapeInfo.h>
 
 #include "HashKey.h"
@@ -40,6 +48,15 @@
 // doesn't delete it right away.  Instead it puts the shape's key on a list delete
 // later.  When that list grows big enough the ShapeManager will remove any matching
 // entries that still have zero ref-count.
+//
+// Hulls, compounds and static meshes can be expensive to build.  When async builds are enabled
+// those are built on a worker pool instead: getShape() returns nullptr while the build is in
+// flight and the body must ask again later, at which point the finished shape is handed out.
+// When a ShapeCache is set the built hulls and BVHs are also persisted on disk and restored
+// from there instead of being rebuilt.  A build that fails isn't retried for a while, asking for
+// it again in the meantime returns nullptr right away.
+
+class ShapeCache;
 
 class ShapeManager {
 public:
@@ -47,9 +64,16 @@ public:
     ShapeManager();
     ~ShapeManager();
 
-    /// \return pointer to shape
+    /// \return pointer to shape, or nullptr if it could not be built or its async build is pending
     const btCollisionShape* getShape(const ShapeInfo& info);
 
+    void setBuildShapesAsync(bool async) { _buildShapesAsync = async; }
+    void setShapeCache(std::shared_ptr<ShapeCache> shapeCache) { _shapeCache = shapeCache; }
+
+    /// \return true if some shapes are still being built on the worker pool
+    bool hasPendingBuilds() const { return !_pendingBuilds.empty(); }
+    bool isBuildingShape(const ShapeInfo& info) const;
+
     /// \return true if shape was found and released
     bool releaseShape(const btCollisionShape* shape);
 
@@ -64,6 +88,9 @@ public:
 
 private:
     bool releaseShapeByKey(const HashKey& key);
+    void addShape(const HashKey& key, const btCollisionShape* shape, int refCount);
+    void submitBuild(const ShapeInfo& info);
+    void receiveBuiltShapes();
 
     class ShapeReference {
     public:
@@ -76,6 +103,16 @@ private:
     // btHashMap is required because it supports memory alignment of the btCollisionShapes
     btHashMap<HashKey, ShapeReference> _shapeMap;
     btAlignedObjectArray<HashKey> _pendingGarbage;
+
+    using BuiltShape = std::pair<HashKey, const btCollisionShape*>;
+
+    bool _buildShapesAsync { false };
+    std::shared_ptr<ShapeCache> _shapeCache;
+    QThreadPool _buildPool;
+    std::unordered_set<uint64_t> _pendingBuilds;
+    std::unordered_map<uint64_t, quint64> _failedBuilds; // hash => when it failed
+    std::mutex _builtShapesMutex;
+    std::vector<BuiltShape> _builtShapes;
 };
 
 #endif // hifi_ShapeManager_h
@@ -17,10 +17,80 @@
 
 #include "ThreadSafeDynamicsWorld.h"
 
+#include <algorithm>
+
 #include <LinearMath/btQuickprof.h>
 
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+
 #include "Profile.h"
 
+// Solves one group of islands in three phases so that only the iterations, which are free of Bullet's
+// profiler (btQuickprof is not thread safe), run on the worker threads.  Setup and finish stay serial.
+class IslandSolver : public btSequentialImpulseConstraintSolver {
+public:
+    BT_DECLARE_ALIGNED_ALLOCATOR();
+
+    void clear() {
+        bodies.clear();
+        manifolds.clear();
+        constraints.clear();
+        cost = 0;
+    }
+
+    void setup(const btContactSolverInfo& solverInfo, btIDebugDraw* debugDrawer) {
+        solveGroupCacheFriendlySetup(getBodies(), (int)bodies.size(), getManifolds(), (int)manifolds.size(),
+            getConstraints(), (int)constraints.size(), solverInfo, debugDrawer);
+    }
+
+    // same as btSequentialImpulseConstraintSolver::solveGroupCacheFriendlyIterations() minus BT_PROFILE
+    void iterate(const btContactSolverInfo& solverInfo, btIDebugDraw* debugDrawer) {
+        solveGroupCacheFriendlySplitImpulseIterations(getBodies(), (int)bodies.size(), getManifolds(), (int)manifolds.size(),
+            getConstraints(), (int)constraints.size(), solverInfo, debugDrawer);
+        int maxIterations = std::max(m_maxOverrideNumSolverIterations, solverInfo.m_numIterations);
+        for (int iteration = 0; iteration < maxIterations; ++iteration) {
+            solveSingleIteration(iteration, getBodies(), (int)bodies.size(), getManifolds(), (int)manifolds.size(),
+                getConstraints(), (int)constraints.size(), solverInfo, debugDrawer);
+        }
+    }
+
+    void finish(const btContactSolverInfo& solverInfo) {
+        solveGroupCacheFriendlyFinish(getBodies(), (int)bodies.size(), solverInfo);
+    }
+
+    btCollisionObject** getBodies() { return bodies.empty() ? nullptr : bodies.data(); }
+    btPersistentManifold** getManifolds() { return manifolds.empty() ? nullptr : manifolds.data(); }
+    btTypedConstraint** getConstraints() { return constraints.empty() ? nullptr : constraints.data(); }
+
+    std::vector<btCollisionObject*> bodies;
+    std::vector<btPersistentManifold*> manifolds;
+    std::vector<btTypedConstraint*> constraints;
+    int cost { 0 };
+};
+
+class IslandWorkers {
+public:
+    IslandWorkers(int numThreads) : arena(numThreads) {
+        for (int i = 0; i < numThreads; ++i) {
+            groups.emplace_back(new IslandSolver());
+        }
+        // islands touching kinematic objects all go into this extra group, see collectIslandGroups()
+        kinematicGroup.reset(new IslandSolver());
+    }
+
+    tbb::task_arena arena;
+    std::vector<std::unique_ptr<IslandSolver>> groups;
+    std::unique_ptr<IslandSolver> kinematicGroup;
+};
+
+// same ordering as btDiscreteDynamicsWorld uses so the constraints of an island are contiguous
+static int getConstraintIslandId(const btTypedConstraint* constraint) {
+    const btCollisionObject& objectA = constraint->getRigidBodyA();
+    const btCollisionObject& objectB = constraint->getRigidBodyB();
+    return objectA.getIslandTag() >= 0 ? objectA.getIslandTag() : objectB.getIslandTag();
+}
+
 ThreadSafeDynamicsWorld::ThreadSafeDynamicsWorld(
         btDispatcher* dispatcher,
         btBroadphaseInterface* pairCache,
@@ -29,6 +99,21 @@ ThreadSafeDynamicsWorld::ThreadSafeDynamicsWorld(
     :   btDiscreteDynamicsWorld(dispatcher, pairCache, constraintSolver, collisionConfiguration) {
 }
 
+ThreadSafeDynamicsWorld::~ThreadSafeDynamicsWorld() {
+}
+
+void ThreadSafeDynamicsWorld::setNumWorkerThreads(int numThreads) {
+    numThreads = std::max(1, numThreads);
+    if (numThreads != _numWorkerThreads) {
+        _numWorkerThreads = numThreads;
+        if (_numWorkerThreads > 1) {
+            _workers.reset(new IslandWorkers(_numWorkerThreads));
+        } else {
+            _workers.reset();
+        }
+    }
+}
+
 int ThreadSafeDynamicsWorld::stepSimulationWithSubstepCallback(btScalar timeStep, int maxSubSteps,
                                                                btScalar fixedTimeStep, SubStepCallback onSubStep) {
     DETAILED_PROFILE_RANGE(simulation_physics, "stepWithCB");
@@ -185,3 +270,142 @@ void ThreadSafeDynamicsWorld::saveKinematicState(btScalar timeStep) {
 }
 
 
+
+void ThreadSafeDynamicsWorld::predictUnconstraintMotion(btScalar timeStep) {
+    if (!_workers) {
+        btDiscreteDynamicsWorld::predictUnconstraintMotion(timeStep);
+        return;
+    }
+
+    DETAILED_PROFILE_RANGE(simulation_physics, "predictMotion");
+    BT_PROFILE("predictUnconstraintMotion");
+    const int BODIES_PER_TASK = 256;
+    _workers->arena.execute([&] {
+        tbb::parallel_for(tbb::blocked_range<int>(0, m_nonStaticRigidBodies.size(), BODIES_PER_TASK),
+                [&](const tbb::blocked_range<int>& range) {
+            for (int i = range.begin(); i < range.end(); ++i) {
+                btRigidBody* body = m_nonStaticRigidBodies[i];
+                if (!body->isStaticOrKinematicObject()) {
+                    // don't integrate/update velocities here, it happens in the constraint solver
+                    body->applyDamping(timeStep);
+                    body->predictIntegratedTransform(timeStep, body->getInterpolationWorldTransform());
+                }
+            }
+        });
+    });
+}
+
+void ThreadSafeDynamicsWorld::collectIslandGroups() {
+    // Hands each awake island to the least loaded group.  Kinematic objects are not island members so one
+    // may touch islands of several groups, and the solver setup of a group stamps its companion id on it
+    // until that group finishes, so all islands that touch a kinematic object share a group of their own.
+    class IslandCollector : public btSimulationIslandManager::IslandCallback {
+    public:
+        IslandCollector(IslandWorkers& workers, btTypedConstraint** sortedConstraints, int numConstraints) :
+            _workers(workers), _sortedConstraints(sortedConstraints), _numConstraints(numConstraints) {}
+
+        virtual void processIsland(btCollisionObject** bodies, int numBodies,
+                btPersistentManifold** manifolds, int numManifolds, int islandId) override {
+            auto islandIdLess = [](const btTypedConstraint* constraint, int id) {
+                return getConstraintIslandId(constraint) < id;
+            };
+            auto idIslandLess = [](int id, const btTypedConstraint* constraint) {
+                return id < getConstraintIslandId(constraint);
+            };
+            btTypedConstraint** constraintsEnd = _sortedConstraints + _numConstraints;
+            btTypedConstraint** firstConstraint = std::lower_bound(_sortedConstraints, constraintsEnd, islandId, islandIdLess);
+            btTypedConstraint** lastConstraint = std::upper_bound(firstConstraint, constraintsEnd, islandId, idIslandLess);
+
+            bool touchesKinematic = false;
+            for (int i = 0; i < numManifolds && !touchesKinematic; ++i) {
+                touchesKinematic = manifolds[i]->getBody0()->isKinematicObject() ||
+                    manifolds[i]->getBody1()->isKinematicObject();
+            }
+            for (auto constraint = firstConstraint; constraint != lastConstraint && !touchesKinematic; ++constraint) {
+                touchesKinematic = (*constraint)->getRigidBodyA().isKinematicObject() ||
+                    (*constraint)->getRigidBodyB().isKinematicObject();
+            }
+
+            IslandSolver* group = _workers.kinematicGroup.get();
+            if (!touchesKinematic) {
+                group = std::min_element(_workers.groups.begin(), _workers.groups.end(),
+                    [](const std::unique_ptr<IslandSolver>& a, const std::unique_ptr<IslandSolver>& b) {
+                        return a->cost < b->cost;
+                    })->get();
+            }
+            group->bodies.insert(group->bodies.end(), bodies, bodies + numBodies);
+            group->manifolds.insert(group->manifolds.end(), manifolds, manifolds + numManifolds);
+            group->constraints.insert(group->constraints.end(), firstConstraint, lastConstraint);
+            group->cost += numBodies + numManifolds + (int)(lastConstraint - firstConstraint);
+        }
+
+    private:
+        IslandWorkers& _workers;
+        btTypedConstraint** _sortedConstraints;
+        int _numConstraints;
+    };
+
+    for (auto& group : _workers->groups) {
+        group->clear();
+    }
+    _workers->kinematicGroup->clear();
+
+    int numConstraints = getNumConstraints();
+    m_sortedConstraints.resize(numConstraints);
+    for (int i = 0; i < numConstraints; ++i) {
+        m_sortedConstraints[i] = m_constraints[i];
+    }
+    btTypedConstraint** sortedConstraints = numConstraints ? &m_sortedConstraints[0] : nullptr;
+    std::stable_sort(sortedConstraints, sortedConstraints + numConstraints,
+        [](const btTypedConstraint* a, const btTypedConstraint* b) {
+            return getConstraintIslandId(a) < getConstraintIslandId(b);
+        });
+
+    IslandCollector collector(*_workers, sortedConstraints, numConstraints);
+    m_islandManager->buildAndProcessIslands(getCollisionWorld()->getDispatcher(), getCollisionWorld(), &collector);
+}
+
+void ThreadSafeDynamicsWorld::solveConstraints(btContactSolverInfo& solverInfo) {
+    if (!_workers || !m_islandManager->getSplitIslands()) {
+        btDiscreteDynamicsWorld::solveConstraints(solverInfo);
+        return;
+    }
+
+    DETAILED_PROFILE_RANGE(simulation_physics, "solveIslands");
+    BT_PROFILE("solveConstraintsOnIslands");
+    collectIslandGroups();
+
+    std::vector<IslandSolver*> groups;
+    groups.reserve(_workers->groups.size() + 1);
+    for (auto& group : _workers->groups) {
+        groups.push_back(group.get());
+    }
+    groups.push_back(_workers->kinematicGroup.get());
+    groups.erase(std::remove_if(groups.begin(), groups.end(), [](IslandSolver* group) {
+        return group->bodies.empty();
+    }), groups.end());
+
+    btIDebugDraw* debugDrawer = getDebugDrawer();
+    {
+        BT_PROFILE("setupIslands");
+        for (auto group : groups) {
+            group->setup(solverInfo, debugDrawer);
+        }
+    }
+    {
+        BT_PROFILE("iterateIslands");
+        _workers->arena.execute([&] {
+            tbb::parallel_for(tbb::blocked_range<size_t>(0, groups.size(), 1), [&](const tbb::blocked_range<size_t>& range) {
+                for (size_t i = range.begin(); i < range.end(); ++i) {
+                    groups[i]->iterate(solverInfo, debugDrawer);
+                }
+            });
+        });
+    }
+    {
+        BT_PROFILE("finishIslands");
+        for (auto group : groups) {
+            group->finish(solverInfo);
+        }
+    }
+}
@@ -24,9 +24,13 @@
 #include "ObjectMotionState.h"
 
 #include <functional>
+#include <memory>
+#include <vector>
 
 using SubStepCallback = std::function<void()>;
 
+class IslandWorkers;
+
 ATTRIBUTE_ALIGNED16(class) ThreadSafeDynamicsWorld : public btDiscreteDynamicsWorld {
 public:
     BT_DECLARE_ALIGNED_ALLOCATOR();
@@ -36,6 +40,14 @@ public:
             btBroadphaseInterface* pairCache,
             btConstraintSolver* constraintSolver,
             btCollisionConfiguration* collisionConfiguration);
+    ~ThreadSafeDynamicsWorld();
+
+    // With more than one worker thread the awake simulation islands are split into one group per thread
+    // and the solver iterations of the groups run in parallel, as does the unconstrained motion prediction.
+    // Islands never share dynamic bodies so the results do not depend on how they are grouped, and
+    // everything else (including synchronizeMotionStates) stays on the calling thread.
+    void setNumWorkerThreads(int numThreads);
+    int getNumWorkerThreads() const { return _numWorkerThreads; }
 
     int stepSimulationWithSubstepCallback(btScalar timeStep, int maxSubSteps = 1,
                                           btScalar fixedTimeStep = btScalar(1.)/btScalar(60.),
@@ -53,10 +65,19 @@ public:
 
     void addChangedMotionState(ObjectMotionState* motionState) { _changedMotionStates.push_back(motionState); }
 
+protected:
+    virtual void predictUnconstraintMotion(btScalar timeStep) override;
+    virtual void solveConstraints(btContactSolverInfo& solverInfo) override;
+
 private:
     // call this instead of non-virtual btDiscreteDynamicsWorld::synchronizeSingleMotionState()
     void synchronizeMotionState(btRigidBody* body);
 
+    void collectIslandGroups();
+
+    int _numWorkerThreads { 1 };
+    std::unique_ptr<IslandWorkers> _workers;
+
     VectorOfMotionStates _changedMotionStates;
     VectorOfMotionStates _deactivatedStates;
     SetOfMotionStates _activeStates;
@@ -103,7 +103,7 @@ void CauterizedModel::createCollisionRenderItemSet() {
 }
 
 void CauterizedModel::updateClusterMatrices() {
-    PerformanceTimer perfTimer("CauterizedModel::updateClusterMatrices");
+    DETAILED_PERFORMANCE_TIMER("CauterizedModel::updateClusterMatrices");
 
     if (!_needsUpdateClusterMatrices || !isLoaded()) {
         return;
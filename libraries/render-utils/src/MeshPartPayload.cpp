@@ -49,6 +49,9 @@ template <> void payloadRender(const MeshPartPayload::Pointer& payload, RenderAr
 
 const graphics::MaterialPointer MeshPartPayload::DEFAULT_MATERIAL = std::make_shared<graphics::Material>();
 
+// How far on screen a simplified level may be from the full mesh
+static const float MAX_LOD_ERROR_PIXELS = 1.0f;
+
 MeshPartPayload::MeshPartPayload(const std::shared_ptr<const graphics::Mesh>& mesh, int partIndex, graphics::MaterialPointer material) {
     updateMeshPart(mesh, partIndex);
     addMaterial(graphics::MaterialLayer(material, 0));
@@ -56,6 +59,7 @@ MeshPartPayload::MeshPartPayload(const std::shared_ptr<const graphics::Mesh>& me
 
 void MeshPartPayload::updateMeshPart(const std::shared_ptr<const graphics::Mesh>& drawMesh, int partIndex) {
     _drawMesh = drawMesh;
+    _partIndex = partIndex;
     if (_drawMesh) {
         auto vertexFormat = _drawMesh->getVertexFormat();
         _hasColorAttrib = vertexFormat->hasAttribute(gpu::Stream::COLOR);
@@ -173,7 +177,9 @@ void MeshPartPayload::render(RenderArgs* args) {
     bindMesh(batch);
 
     // apply material properties
-    RenderPipelines::bindMaterial(!_drawMaterials.empty() ? _drawMaterials.top().material : DEFAULT_MATERIAL, batch, args->_enableTexturing);
+    const auto& material = !_drawMaterials.empty() ? _drawMaterials.top().material : DEFAULT_MATERIAL;
+    RenderPipelines::bindMaterial(material, batch, args->_enableTexturing);
+    RenderPipelines::updateMaterialUsage(material, args, _worldBound);
     args->_details._materialSwitches++;
 
     // Draw!
@@ -271,6 +277,15 @@ void ModelMeshPartPayload::initCache(const ModelPointer& model) {
 
         _isBlendShaped = !mesh.blendshapes.isEmpty();
         _hasTangents = !mesh.tangents.isEmpty();
+
+        if (mesh._lodIndexBuffer && mesh._mesh == _drawMesh) {
+            _lodIndexBuffer = mesh._lodIndexBuffer;
+            for (const auto& lod : mesh.lods) {
+                if (_partIndex < (int)lod._drawParts.size()) {
+                    _lods.push_back({ lod.error, lod._drawParts[_partIndex] });
+                }
+            }
+        }
     }
 
     auto networkMaterial = model->getGeometry()->getShapeMaterial(_shapeID);
@@ -279,6 +294,13 @@ void ModelMeshPartPayload::initCache(const ModelPointer& model) {
     }
 }
 
+void ModelMeshPartPayload::updateMeshPart(const std::shared_ptr<const graphics::Mesh>& drawMesh, int partIndex) {
+    MeshPartPayload::updateMeshPart(drawMesh, partIndex);
+    _lods.clear();
+    _lodIndexBuffer.reset();
+    _lodIndex = -1;
+}
+
 void ModelMeshPartPayload::notifyLocationChanged() {
 
 }
@@ -456,6 +478,26 @@ void ModelMeshPartPayload::bindTransform(gpu::Batch& batch, RenderArgs::RenderMo
     batch.setModelTransform(_transform);
 }
 
+int ModelMeshPartPayload::evalLOD(RenderArgs* args) const {
+    if (_lods.empty()) {
+        return -1;
+    }
+
+    // Pixels per mesh unit, from the size of the part on screen against its size in the mesh
+    float screenSize = RenderPipelines::evalScreenSize(args, _worldBound);
+    float meshSize = glm::length(_localBound.getDimensions());
+    if (screenSize == 0.0f || meshSize == 0.0f) {
+        return -1;
+    }
+    float pixelsPerUnit = screenSize / meshSize;
+
+    int lodIndex = -1;
+    for (int i = 0; i < (int)_lods.size() && _lods[i].error * pixelsPerUnit <= MAX_LOD_ERROR_PIXELS; i++) {
+        lodIndex = i;
+    }
+    return lodIndex;
+}
+
 void ModelMeshPartPayload::render(RenderArgs* args) {
     PerformanceTimer perfTimer("ModelMeshPartPayload::render");
 
@@ -470,18 +512,28 @@ void ModelMeshPartPayload::render(RenderArgs* args) {
     //Bind the index buffer and vertex buffer and Blend shapes if needed
     bindMesh(batch);
 
+    if (args->_renderMode != RenderArgs::SHADOW_RENDER_MODE) {
+        _lodIndex = evalLOD(args);
+    }
+    const graphics::Mesh::Part& drawPart = (_lodIndex >= 0) ? _lods[_lodIndex].drawPart : _drawPart;
+    if (_lodIndex >= 0) {
+        batch.setIndexBuffer(gpu::UINT32, _lodIndexBuffer, 0);
+    }
+
     // apply material properties
-    RenderPipelines::bindMaterial(!_drawMaterials.empty() ? _drawMaterials.top().material : DEFAULT_MATERIAL, batch, args->_enableTexturing);
+    const auto& material = !_drawMaterials.empty() ? _drawMaterials.top().material : DEFAULT_MATERIAL;
+    RenderPipelines::bindMaterial(material, batch, args->_enableTexturing);
+    RenderPipelines::updateMaterialUsage(material, args, _worldBound);
     args->_details._materialSwitches++;
 
     // Draw!
-    {
+    if (drawPart._numIndices > 0) {
         PerformanceTimer perfTimer("batch.drawIndexed()");
-        drawCall(batch);
+        batch.drawIndexed(gpu::TRIANGLES, drawPart._numIndices, drawPart._startIndex);
     }
 
     const int INDICES_PER_TRIANGLE = 3;
-    args->_details._trianglesRendered += _drawPart._numIndices / INDICES_PER_TRIANGLE;
+    args->_details._trianglesRendered += drawPart._numIndices / INDICES_PER_TRIANGLE;
 }
 
 void ModelMeshPartPayload::computeAdjustedLocalBound(const std::vector<glm::mat4>& clusterMatrices) {
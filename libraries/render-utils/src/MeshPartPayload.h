@@ -97,6 +97,9 @@ public:
 
     void updateKey(bool isVisible, bool isLayered, bool canCastShadow, uint8_t tagBits, bool isGroupCulled = false) override;
 
+    // Drops the simplified levels, they only index the mesh of the model
+    void updateMeshPart(const std::shared_ptr<const graphics::Mesh>& drawMesh, int partIndex) override;
+
     // matrix palette skinning
     void updateClusterBuffer(const std::vector<glm::mat4>& clusterMatrices);
 
@@ -137,7 +140,19 @@ public:
 private:
     void initCache(const ModelPointer& model);
 
+    // The most simplified level of the part that's off by less than MAX_LOD_ERROR_PIXELS, -1 for the full part
+    int evalLOD(RenderArgs* args) const;
+
     gpu::BufferPointer _blendedVertexBuffer;
+
+    // Simplified levels made by the baker, from the most detailed down, drawn from their own index buffer
+    struct LOD {
+        float error; // in mesh units
+        graphics::Mesh::Part drawPart;
+    };
+    std::vector<LOD> _lods;
+    gpu::BufferPointer _lodIndexBuffer;
+    int _lodIndex { -1 }; // as of the last draw from the camera, the shadows follow it
     render::ShapeKey _shapeKey { render::ShapeKey::Builder::invalid() };
     int _layer { render::Item::LAYER_3D };
 };
@@ -17,6 +17,7 @@
 #include <QUrl>
 #include <QMutex>
 
+#include <atomic>
 #include <unordered_map>
 #include <unordered_set>
 #include <functional>
@@ -497,6 +498,7 @@ class ModelBlender : public QObject, public Dependency {
 public:
 
     /// Adds the specified model to the list requiring vertex blends.
+    /// Thread safe, as cluster matrices may be updated on worker threads.
     void noteRequiresBlend(ModelPointer model);
 
 public slots:
@@ -511,7 +513,7 @@ private:
     virtual ~ModelBlender();
 
     std::set<ModelWeakPointer, std::owner_less<ModelWeakPointer>> _modelsRequiringBlends;
-    int _pendingBlenders;
+    std::atomic<int> _pendingBlenders;
     Mutex _mutex;
 };
 
@@ -618,6 +618,43 @@ void initZPassPipelines(ShapePlumber& shapePlumber, gpu::StatePointer state) {
         skinModelShadowFadeDualQuatProgram, state);
 }
 
+float RenderPipelines::evalScreenSize(const RenderArgs* args, const AABox& bound) {
+    if (!args->hasViewFrustum() || bound.isNull()) {
+        return 0.0f;
+    }
+
+    // The same measure the LOD culling goes by
+    const ViewFrustum& frustum = args->getViewFrustum();
+    float radius = 0.5f * glm::length(bound.getDimensions());
+    float distance = std::max(glm::distance(bound.calcCenter(), frustum.getPosition()), radius);
+    float tanHalfFieldOfView = tanf(glm::radians(frustum.getFieldOfView()) * 0.5f);
+    if (distance == 0.0f || tanHalfFieldOfView <= 0.0f) {
+        return 0.0f;
+    }
+    return (radius / (distance * tanHalfFieldOfView)) * (float)args->_viewport.w;
+}
+
+void RenderPipelines::updateMaterialUsage(const graphics::MaterialPointer& material, const RenderArgs* args, const AABox& bound) {
+    // Shadows and untextured draws don't tell us anything about the resolution the textures are seen at
+    if (!material || !args->_enableTexturing || args->_renderMode == RenderArgs::SHADOW_RENDER_MODE) {
+        return;
+    }
+
+    float screenSize = evalScreenSize(args, bound);
+    if (screenSize == 0.0f) {
+        return;
+    }
+
+    for (const auto& textureMap : material->getTextureMaps()) {
+        if (textureMap.second && textureMap.second->getTextureSource()) {
+            auto texture = textureMap.second->getTextureSource()->getGPUTexture();
+            if (texture) {
+                texture->noteUsage(screenSize);
+            }
+        }
+    }
+}
+
 // FIXME find a better way to setup the default textures
 void RenderPipelines::bindMaterial(const graphics::MaterialPointer& material, gpu::Batch& batch, bool enableTextures) {
     if (!material) {
@@ -12,10 +12,18 @@
 #define hifi_RenderPipelines_h
 
 #include <graphics/Material.h>
+#include <render/Args.h>
 
 class RenderPipelines {
 public:
     static void bindMaterial(const graphics::MaterialPointer& material, gpu::Batch& batch, bool enableTextures);
+
+    // Reports how large the material's textures are drawn on screen when drawing an item with the given bound,
+    // which is what the texture streaming and memory management go by
+    static void updateMaterialUsage(const graphics::MaterialPointer& material, const RenderArgs* args, const AABox& bound);
+
+    // The size in pixels of the bounding sphere of an item with the given bound, 0 when there's no view to go by
+    static float evalScreenSize(const RenderArgs* args, const AABox& bound);
 };
 
 
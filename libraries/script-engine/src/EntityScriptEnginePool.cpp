@@ -0,0 +1,231 @@
+//
+//  EntityScriptEnginePool.cpp
+//  libraries/script-engine/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityScriptEnginePool.h"
+
+#include <algorithm>
+
+#include <QtCore/QFutureInterface>
+
+using Lock = std::lock_guard<std::mutex>;
+
+static const float REGION_SIZE = 64.0f; // meters
+
+EntityScriptEnginePool::Partition EntityScriptEnginePool::partitionFromString(const QString& partition) {
+    if (partition == "script") {
+        return Partition::Script;
+    } else if (partition == "region") {
+        return Partition::Region;
+    }
+    return Partition::Entity;
+}
+
+void EntityScriptEnginePool::setEngines(std::vector<ScriptEnginePointer> engines) {
+    Lock lock(_mutex);
+    _engines = std::move(engines);
+    _numAssigned.assign(_engines.size(), 0);
+    _assignments.clear();
+    _scriptURLs.clear();
+    _movedScripts.clear();
+}
+
+std::vector<ScriptEnginePointer> EntityScriptEnginePool::getEngines() const {
+    Lock lock(_mutex);
+    return _engines;
+}
+
+int EntityScriptEnginePool::getNumEngines() const {
+    Lock lock(_mutex);
+    return (int)_engines.size();
+}
+
+int EntityScriptEnginePool::chooseEngine(const QString& scriptURL, const glm::vec3& position) const {
+    const int numEngines = (int)_engines.size();
+    switch (_partition) {
+        case Partition::Script:
+            return _movedScripts.value(scriptURL, (int)(qHash(scriptURL) % (uint)numEngines));
+        case Partition::Region: {
+            glm::ivec3 region = glm::ivec3(glm::floor(position / REGION_SIZE));
+            uint hash = qHash(region.x) ^ (qHash(region.y) * 31) ^ (qHash(region.z) * 961);
+            return (int)(hash % (uint)numEngines);
+        }
+        case Partition::Entity:
+        default:
+            return (int)(std::min_element(_numAssigned.begin(), _numAssigned.end()) - _numAssigned.begin());
+    }
+}
+
+ScriptEnginePointer EntityScriptEnginePool::assign(const EntityItemID& entityID, const QString& scriptURL, const glm::vec3& position) {
+    Lock lock(_mutex);
+    if (_engines.empty()) {
+        return ScriptEnginePointer();
+    }
+    _scriptURLs.insert(entityID, scriptURL);
+    auto it = _assignments.constFind(entityID);
+    if (it != _assignments.constEnd()) {
+        return _engines[it.value()];
+    }
+    int index = chooseEngine(scriptURL, position);
+    _assignments.insert(entityID, index);
+    ++_numAssigned[index];
+    return _engines[index];
+}
+
+void EntityScriptEnginePool::reassign(const EntityItemID& entityID, int engineIndex) {
+    Lock lock(_mutex);
+    if (engineIndex < 0 || engineIndex >= (int)_engines.size()) {
+        return;
+    }
+    auto it = _assignments.find(entityID);
+    if (it != _assignments.end()) {
+        --_numAssigned[it.value()];
+        it.value() = engineIndex;
+    } else {
+        _assignments.insert(entityID, engineIndex);
+    }
+    ++_numAssigned[engineIndex];
+}
+
+void EntityScriptEnginePool::unassign(const EntityItemID& entityID) {
+    Lock lock(_mutex);
+    auto it = _assignments.find(entityID);
+    if (it != _assignments.end()) {
+        --_numAssigned[it.value()];
+        _assignments.erase(it);
+    }
+    _scriptURLs.remove(entityID);
+}
+
+EntityScriptEnginePool::Move EntityScriptEnginePool::chooseRebalanceMove(const QHash<EntityItemID, float>& entityLoads,
+                                                                         float minImbalance) const {
+    Lock lock(_mutex);
+    std::vector<ScriptLoad> loads;
+    loads.reserve(entityLoads.size());
+    for (auto it = entityLoads.constBegin(); it != entityLoads.constEnd(); ++it) {
+        auto assignment = _assignments.constFind(it.key());
+        if (assignment != _assignments.constEnd()) {
+            QString group = (_partition == Partition::Script) ? _scriptURLs.value(it.key()) : it.key().toString();
+            loads.push_back({ it.key(), assignment.value(), group, it.value() });
+        }
+    }
+    Move move = chooseRebalanceMove(loads, (int)_engines.size(), minImbalance);
+    if (_partition == Partition::Script && !move.entities.isEmpty()) {
+        move.scriptURL = _scriptURLs.value(move.entities.front());
+    }
+    return move;
+}
+
+EntityScriptEnginePool::Move EntityScriptEnginePool::chooseRebalanceMove(const std::vector<ScriptLoad>& loads, int numEngines,
+                                                                         float minImbalance) {
+    Move move;
+    if (numEngines < 2) {
+        return move;
+    }
+
+    std::vector<float> engineLoads(numEngines, 0.0f);
+    for (const auto& load : loads) {
+        if (load.engine >= 0 && load.engine < numEngines) {
+            engineLoads[load.engine] += load.load;
+        }
+    }
+    int busiest = (int)(std::max_element(engineLoads.begin(), engineLoads.end()) - engineLoads.begin());
+    int idlest = (int)(std::min_element(engineLoads.begin(), engineLoads.end()) - engineLoads.begin());
+    float imbalance = engineLoads[busiest] - engineLoads[idlest];
+    if (imbalance < minImbalance) {
+        return move;
+    }
+
+    QHash<QString, float> groupLoads;
+    for (const auto& load : loads) {
+        if (load.engine == busiest) {
+            groupLoads[load.group] += load.load;
+        }
+    }
+    QString hottestGroup;
+    float hottestLoad = 0.0f;
+    for (auto it = groupLoads.constBegin(); it != groupLoads.constEnd(); ++it) {
+        if (it.value() > hottestLoad && it.value() < imbalance / 2.0f) {
+            hottestGroup = it.key();
+            hottestLoad = it.value();
+        }
+    }
+    if (hottestLoad <= 0.0f) {
+        return move;
+    }
+
+    for (const auto& load : loads) {
+        if (load.engine == busiest && load.group == hottestGroup) {
+            move.entities.push_back(load.entityID);
+        }
+    }
+    move.from = busiest;
+    move.to = idlest;
+    move.load = hottestLoad;
+    return move;
+}
+
+void EntityScriptEnginePool::applyRebalanceMove(const Move& move) {
+    for (const auto& entityID : move.entities) {
+        reassign(entityID, move.to);
+    }
+    if (!move.scriptURL.isEmpty()) {
+        Lock lock(_mutex);
+        if (move.to >= 0 && move.to < (int)_engines.size()) {
+            _movedScripts.insert(move.scriptURL, move.to);
+        }
+    }
+}
+
+ScriptEnginePointer EntityScriptEnginePool::find(const EntityItemID& entityID) const {
+    Lock lock(_mutex);
+    auto it = _assignments.constFind(entityID);
+    return (it != _assignments.constEnd()) ? _engines[it.value()] : ScriptEnginePointer();
+}
+
+int EntityScriptEnginePool::findIndex(const EntityItemID& entityID) const {
+    Lock lock(_mutex);
+    return _assignments.value(entityID, -1);
+}
+
+QList<EntityItemID> EntityScriptEnginePool::getAssignedEntities() const {
+    Lock lock(_mutex);
+    return _assignments.keys();
+}
+
+std::vector<int> EntityScriptEnginePool::getNumAssigned() const {
+    Lock lock(_mutex);
+    return _numAssigned;
+}
+
+void EntityScriptEnginePool::callEntityScriptMethod(const EntityItemID& entityID, const QString& methodName,
+                                                    const QStringList& params, const QUuid& remoteCallerID) {
+    // ScriptEngine queues the call onto its own thread when it comes from another one
+    auto engine = find(entityID);
+    if (engine) {
+        engine->callEntityScriptMethod(entityID, methodName, params, remoteCallerID);
+    }
+}
+
+QFuture<QVariant> EntityScriptEnginePool::getLocalEntityScriptDetails(const EntityItemID& entityID) {
+    auto engine = find(entityID);
+    if (!engine) {
+        // let any engine report that the entity has no script
+        Lock lock(_mutex);
+        if (_engines.empty()) {
+            QFutureInterface<QVariant> noDetails;
+            noDetails.reportStarted();
+            noDetails.reportResult(QVariant());
+            noDetails.reportFinished();
+            return noDetails.future();
+        }
+        engine = _engines.front();
+    }
+    return engine->getLocalEntityScriptDetails(entityID);
+}
@@ -0,0 +1,98 @@
+//
+//  EntityScriptEnginePool.h
+//  libraries/script-engine/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityScriptEnginePool_h
+#define hifi_EntityScriptEnginePool_h
+
+#include <mutex>
+#include <vector>
+
+#include <QtCore/QHash>
+
+#include <glm/glm.hpp>
+
+#include <EntitiesScriptEngineProvider.h>
+#include <ScriptEngine.h>
+
+// The script engines of the entity script server.  Each engine runs on its own thread and every scripted entity is
+// assigned to exactly one of them; calls into an entity's script are routed to the engine that owns it.
+class EntityScriptEnginePool : public EntitiesScriptEngineProvider {
+public:
+    // how new entities are spread over the engines
+    enum class Partition {
+        Entity,  // the engine with the fewest scripts
+        Script,  // the same script URL always lands on the same engine, so its instances can share state
+        Region   // entities in the same region of space land on the same engine
+    };
+    static Partition partitionFromString(const QString& partition);
+
+    void setPartition(Partition partition) { _partition = partition; }
+    Partition getPartition() const { return _partition; }
+
+    // replaces the engines and forgets every assignment
+    void setEngines(std::vector<ScriptEnginePointer> engines);
+    std::vector<ScriptEnginePointer> getEngines() const;
+    int getNumEngines() const;
+
+    // the engine owning entityID, assigning one when it has none
+    ScriptEnginePointer assign(const EntityItemID& entityID, const QString& scriptURL, const glm::vec3& position);
+    // moves entityID to engine engineIndex, the caller is responsible for reloading its script there
+    void reassign(const EntityItemID& entityID, int engineIndex);
+    void unassign(const EntityItemID& entityID);
+
+    // Scripts to move from the busiest engine to the idlest one to even out their loads: the hottest group of scripts
+    // on the busiest engine whose load is less than half the difference, so the busiest can't become the idlest and
+    // send them back.  With Partition::Script a group is every entity running the same script, so its instances keep
+    // sharing an engine, otherwise a group is a single entity.  No entities when the engines are less than minImbalance
+    // apart or nothing fits.
+    struct Move {
+        QList<EntityItemID> entities;
+        QString scriptURL;
+        int from { -1 };
+        int to { -1 };
+        float load { 0.0f };
+    };
+    Move chooseRebalanceMove(const QHash<EntityItemID, float>& entityLoads, float minImbalance) const;
+    // reassigns the entities of the move, and with Partition::Script sends the later instances of its script along
+    void applyRebalanceMove(const Move& move);
+
+    // nullptr when entityID isn't assigned
+    ScriptEnginePointer find(const EntityItemID& entityID) const;
+    int findIndex(const EntityItemID& entityID) const;
+    QList<EntityItemID> getAssignedEntities() const;
+    std::vector<int> getNumAssigned() const;
+
+    // EntitiesScriptEngineProvider, safe to call from any engine thread
+    virtual void callEntityScriptMethod(const EntityItemID& entityID, const QString& methodName,
+                                        const QStringList& params = QStringList(), const QUuid& remoteCallerID = QUuid()) override;
+    virtual QFuture<QVariant> getLocalEntityScriptDetails(const EntityItemID& entityID) override;
+
+private:
+    struct ScriptLoad {
+        EntityItemID entityID;
+        int engine;
+        QString group;
+        float load;
+    };
+    static Move chooseRebalanceMove(const std::vector<ScriptLoad>& loads, int numEngines, float minImbalance);
+
+    int chooseEngine(const QString& scriptURL, const glm::vec3& position) const;
+
+    Partition _partition { Partition::Entity };
+
+    mutable std::mutex _mutex;
+    std::vector<ScriptEnginePointer> _engines;
+    std::vector<int> _numAssigned;
+    QHash<EntityItemID, int> _assignments;
+    QHash<EntityItemID, QString> _scriptURLs;
+    QHash<QString, int> _movedScripts;  // with Partition::Script, scripts rebalanced away from the engine they hash to
+};
+
+#endif // hifi_EntityScriptEnginePool_h
@@ -12,11 +12,17 @@
 #include "ScriptEngine.h"
 
 #include <chrono>
+#include <limits>
 #include <thread>
 
 #include <QtCore/QCoreApplication>
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
 #include <QtCore/QEventLoop>
+#include <QtCore/QFile>
 #include <QtCore/QFileInfo>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
 #include <QtCore/QTimer>
 #include <QtCore/QThread>
 #include <QtCore/QRegularExpression>
@@ -44,6 +50,7 @@
 #include <AvatarData.h>
 #include <DebugDraw.h>
 #include <EntityScriptingInterface.h>
+#include <LogHandler.h>
 #include <MessagesClient.h>
 #include <NetworkAccessManager.h>
 #include <PathUtils.h>
@@ -173,6 +180,7 @@ ScriptEngine::ScriptEngine(Context context, const QString& scriptContents, const
     _context(context),
     _scriptContents(scriptContents),
     _timerFunctionMap(),
+    _timerWheelTimer(new QTimer(this)),
     _fileNameString(fileNameString),
     _arrayBufferClass(new ArrayBufferClass(this)),
     _assetScriptingInterface(new AssetScriptingInterface(this)),
@@ -205,6 +213,13 @@ ScriptEngine::ScriptEngine(Context context, const QString& scriptContents, const
         }
     }, Qt::DirectConnection);
 
+    _timerClock.start();
+    _timerWheelTimer->setSingleShot(true);
+    _timerWheelTimer->setTimerType(Qt::PreciseTimer);
+    connect(_timerWheelTimer, &QTimer::timeout, this, &ScriptEngine::timerFired);
+    // make sure the timers stop when the script does
+    connect(this, &ScriptEngine::scriptEnding, _timerWheelTimer, &QTimer::stop);
+
     setProcessEventsInterval(MSECS_PER_SECOND);
     if (isEntityServerScript()) {
         qCDebug(scriptengine) << "isEntityServerScript() -- limiting maxRetries to 1";
@@ -238,6 +253,10 @@ QString ScriptEngine::getContext() const {
 }
 
 ScriptEngine::~ScriptEngine() {
+    // timer handles have no parent, the run loop normally stops them all before getting here
+    qDeleteAll(_timerFunctionMap.keys());
+    delete _profiler;
+
     auto scriptEngines = DependencyManager::get<ScriptEngines>();
     if (scriptEngines) {
         scriptEngines->removeScriptEngine(qSharedPointerCast<ScriptEngine>(sharedFromThis()));
@@ -995,17 +1014,21 @@ QScriptValue ScriptEngine::evaluate(const QString& sourceCode, const QString& fi
         return result;
     }
 
-    // Check syntax
-    auto syntaxError = lintScript(sourceCode, fileName);
-    if (syntaxError.isError()) {
-        if (!isEvaluating()) {
-            syntaxError.setProperty("detail", "evaluate");
+    // Check syntax, unless this source already passed in some engine
+    QByteArray sourceHash = ScriptProgramCache::hashSource(sourceCode);
+    if (!ScriptProgramCache::hasPassedSyntaxCheck(sourceHash)) {
+        auto syntaxError = lintScript(sourceCode, fileName);
+        if (syntaxError.isError()) {
+            if (!isEvaluating()) {
+                syntaxError.setProperty("detail", "evaluate");
+            }
+            raiseException(syntaxError);
+            maybeEmitUncaughtException("lint");
+            return syntaxError;
         }
-        raiseException(syntaxError);
-        maybeEmitUncaughtException("lint");
-        return syntaxError;
+        ScriptProgramCache::setPassedSyntaxCheck(sourceHash);
     }
-    QScriptProgram program { sourceCode, fileName, lineNumber };
+    QScriptProgram program = _programCache.getProgram(sourceCode, fileName, lineNumber, sourceHash);
     if (program.isNull()) {
         // can this happen?
         auto err = makeError("could not create QScriptProgram for " + fileName);
@@ -1042,8 +1065,11 @@ void ScriptEngine::run() {
 
     {
         PROFILE_RANGE(script, _fileNameString);
+        quint64 startUsecs = usecTimestampNow();
         evaluate(_scriptContents, _fileNameString);
         maybeEmitUncaughtException(__FUNCTION__);
+        qCDebug(scriptengine) << "evaluated" << getFilename() << "in"
+            << (float)(usecTimestampNow() - startUsecs) / (float)USECS_PER_MSEC << "ms";
     }
 #ifdef _WIN32
     // VS13 does not sleep_until unless it uses the system_clock, see:
@@ -1207,26 +1233,23 @@ void ScriptEngine::run() {
 // NOTE: This is private because it must be called on the same thread that created the timers, which is why
 // we want to only call it in our own run "shutdown" processing.
 void ScriptEngine::stopAllTimers() {
-    QMutableHashIterator<QTimer*, CallbackData> i(_timerFunctionMap);
     int j {0};
-    while (i.hasNext()) {
-        i.next();
-        QTimer* timer = i.key();
+    foreach (QObject* timer, _timerFunctionMap.keys()) {
         qCDebug(scriptengine) << getFilename() << "stopAllTimers[" << j++ << "]";
         stopTimer(timer);
     }
 }
 
 void ScriptEngine::stopAllTimersForEntityScript(const EntityItemID& entityID) {
-     // We could maintain a separate map of entityID => QTimer, but someone will have to prove to me that it's worth the complexity. -HRS
-    QVector<QTimer*> toDelete;
-    QMutableHashIterator<QTimer*, CallbackData> i(_timerFunctionMap);
+     // We could maintain a separate map of entityID => timer, but someone will have to prove to me that it's worth the complexity. -HRS
+    QVector<QObject*> toDelete;
+    QHashIterator<QObject*, TimerData> i(_timerFunctionMap);
     while (i.hasNext()) {
         i.next();
-        if (i.value().definingEntityIdentifier != entityID) {
+        if (i.value().callback.definingEntityIdentifier != entityID) {
             continue;
         }
-        QTimer* timer = i.key();
+        QObject* timer = i.key();
         toDelete << timer; // don't delete while we're iterating. save it.
     }
     for (auto timer:toDelete) { // now reap 'em
@@ -1290,50 +1313,87 @@ void ScriptEngine::timerFired() {
             return; // bail early
         }
     }
+    _scheduledTimerWakeup = -1;
+
+    // a callback can spin a nested event loop (e.g. a synchronous include) and get back in here,
+    // so the batch is taken out of the member that only saves reallocating it
+    std::vector<TimerWheel::Expired> expiredTimers;
+    expiredTimers.swap(_expiredTimers);
+    _timerWheel.advance(_timerClock.elapsed(), expiredTimers);
+    if (!expiredTimers.empty()) {
+        ++_numTimerWakeups;
+    }
 
-    QTimer* callingTimer = reinterpret_cast<QTimer*>(sender());
-    CallbackData timerData = _timerFunctionMap.value(callingTimer);
+    for (const auto& expired : expiredTimers) {
+        QObject* timer = _timerHandles.value(expired.id);
+        auto timerData = _timerFunctionMap.find(timer);
+        if (!timer || timerData == _timerFunctionMap.end()) {
+            continue; // cleared by an earlier callback of this batch
+        }
+        CallbackData callbackData = timerData->callback;
 
-    if (!callingTimer->isActive()) {
-        // this timer is done, we can kill it
-        _timerFunctionMap.remove(callingTimer);
-        delete callingTimer;
+        if (timerData->isSingleShot) {
+            // this timer is done, we can kill it
+            _timerHandles.remove(expired.id);
+            _timerFunctionMap.erase(timerData);
+            delete timer;
+        }
+
+        int64_t latency = std::max((int64_t)_timerClock.elapsed() - expired.dueTime, (int64_t)0);
+        _totalTimerLatency += latency;
+        _maxTimerLatency = std::max(_maxTimerLatency, latency);
+        ++_numTimerCallbacks;
+
+        // call the associated JS function, if it exists
+        if (callbackData.function.isValid()) {
+            PROFILE_RANGE(script, __FUNCTION__);
+            auto preTimer = p_high_resolution_clock::now();
+            callWithEnvironment(callbackData.definingEntityIdentifier, callbackData.definingSandboxURL, callbackData.function, callbackData.function, QScriptValueList());
+            auto postTimer = p_high_resolution_clock::now();
+            auto elapsed = (postTimer - preTimer);
+            _totalTimerExecution += std::chrono::duration_cast<std::chrono::microseconds>(elapsed);
+        } else {
+            qCWarning(scriptengine) << "timerFired -- invalid function" << callbackData.function.toVariant().toString();
+        }
     }
 
-    // call the associated JS function, if it exists
-    if (timerData.function.isValid()) {
-        PROFILE_RANGE(script, __FUNCTION__);
-        auto preTimer = p_high_resolution_clock::now();
-        callWithEnvironment(timerData.definingEntityIdentifier, timerData.definingSandboxURL, timerData.function, timerData.function, QScriptValueList());
-        auto postTimer = p_high_resolution_clock::now();
-        auto elapsed = (postTimer - preTimer);
-        _totalTimerExecution += std::chrono::duration_cast<std::chrono::microseconds>(elapsed);
-    } else {
-        qCWarning(scriptengine) << "timerFired -- invalid function" << timerData.function.toVariant().toString();
+    expiredTimers.clear();
+    _expiredTimers.swap(expiredTimers);
+    scheduleTimerWheel();
+}
+
+void ScriptEngine::scheduleTimerWheel() {
+    int64_t wakeup = _timerWheel.getNextWakeup();
+    if (wakeup < 0) {
+        _timerWheelTimer->stop();
+        _scheduledTimerWakeup = -1;
+        return;
     }
+    if (_timerWheelTimer->isActive() && _scheduledTimerWakeup >= 0 && _scheduledTimerWakeup <= wakeup) {
+        return; // already woken up in time, waking up early for a timer that has been cleared is harmless
+    }
+    _scheduledTimerWakeup = wakeup;
+    int64_t delay = std::max(wakeup - (int64_t)_timerClock.elapsed(), (int64_t)0);
+    _timerWheelTimer->start((int)std::min(delay, (int64_t)std::numeric_limits<int>::max()));
 }
 
 QObject* ScriptEngine::setupTimerWithInterval(const QScriptValue& function, int intervalMS, bool isSingleShot) {
-    // create the timer, add it to the map, and start it
-    QTimer* newTimer = new QTimer(this);
-    newTimer->setSingleShot(isSingleShot);
-
-    // The default timer type is not very accurate below about 200ms http://doc.qt.io/qt-5/qt.html#TimerType-enum
+    // Longer timers get the same 5% slack as Qt::CoarseTimer, which lets the timer wheel fire them in batches.
+    // Below about 200ms they stay precise http://doc.qt.io/qt-5/qt.html#TimerType-enum
     static const int MIN_TIMEOUT_FOR_COARSE_TIMER = 200;
-    if (intervalMS < MIN_TIMEOUT_FOR_COARSE_TIMER) {
-        newTimer->setTimerType(Qt::PreciseTimer);
-    }
-
-    connect(newTimer, &QTimer::timeout, this, &ScriptEngine::timerFired);
-
-    // make sure the timer stops when the script does
-    connect(this, &ScriptEngine::scriptEnding, newTimer, &QTimer::stop);
+    static const int COARSE_TIMER_TOLERANCE_DIVISOR = 20;
+    intervalMS = std::max(intervalMS, 0);
+    int tolerance = (intervalMS < MIN_TIMEOUT_FOR_COARSE_TIMER) ? 0 : intervalMS / COARSE_TIMER_TOLERANCE_DIVISOR;
 
+    // create the timer handle, add it to the map, and start it
+    QObject* newTimer = new QObject();
+    TimerWheel::TimerID id = _timerWheel.start(_timerClock.elapsed(), intervalMS, tolerance, isSingleShot);
 
-    CallbackData timerData = { function, currentEntityIdentifier, currentSandboxURL };
-    _timerFunctionMap.insert(newTimer, timerData);
+    CallbackData callbackData = { function, currentEntityIdentifier, currentSandboxURL };
+    _timerFunctionMap.insert(newTimer, { callbackData, id, isSingleShot });
+    _timerHandles.insert(id, newTimer);
 
-    newTimer->start(intervalMS);
+    scheduleTimerWheel();
     return newTimer;
 }
 
@@ -1355,16 +1415,164 @@ QObject* ScriptEngine::setTimeout(const QScriptValue& function, int timeoutMS) {
     return setupTimerWithInterval(function, timeoutMS, true);
 }
 
-void ScriptEngine::stopTimer(QTimer *timer) {
-    if (_timerFunctionMap.contains(timer)) {
-        timer->stop();
-        _timerFunctionMap.remove(timer);
+void ScriptEngine::stopTimer(QObject* timer) {
+    auto timerData = _timerFunctionMap.find(timer);
+    if (timerData != _timerFunctionMap.end()) {
+        _timerWheel.stop(timerData->id);
+        _timerHandles.remove(timerData->id);
+        _timerFunctionMap.erase(timerData);
         delete timer;
+        if (_timerWheel.getNumTimers() == 0) {
+            _timerWheelTimer->stop();
+            _scheduledTimerWakeup = -1;
+        }
     } else {
         qCDebug(scriptengine) << "stopTimer -- not in _timerFunctionMap" << timer;
     }
 }
 
+QVariantMap ScriptEngine::getTimerStats() const {
+    QVariantMap stats;
+    stats["timers"] = _timerWheel.getNumTimers();
+    stats["intervals"] = _timerWheel.getNumTimers() - _timerWheel.getNumSingleShotTimers();
+    stats["timeouts"] = _timerWheel.getNumSingleShotTimers();
+    stats["callbacks"] = _numTimerCallbacks;
+    stats["wakeups"] = _numTimerWakeups;
+    stats["callbacksPerWakeup"] = (_numTimerWakeups > 0) ? (float)_numTimerCallbacks / (float)_numTimerWakeups : 0.0f;
+    stats["averageLatency"] = (_numTimerCallbacks > 0) ? (float)_totalTimerLatency / (float)_numTimerCallbacks : 0.0f;
+    stats["maxLatency"] = (qint64)_maxTimerLatency;
+    stats["averageCallbackTime"] = (_numTimerCallbacks > 0) ?
+        (float)_totalTimerExecution.count() / (float)(_numTimerCallbacks * USECS_PER_MSEC) : 0.0f;
+    return stats;
+}
+
+bool ScriptEngine::startProfiling(int sampleIntervalMS) {
+    if (_debuggable || (agent() && agent() != _profiler)) {
+        scriptWarningMessage("Script.startProfiling() can't be used while the script is being debugged");
+        return false;
+    }
+    if (!_profiler) {
+        _profiler = new ScriptProfiler(this, sampleIntervalMS);
+    } else {
+        _profiler->setSampleInterval(sampleIntervalMS);
+    }
+    setAgent(_profiler);
+    _profiler->start();
+    return true;
+}
+
+void ScriptEngine::stopProfiling() {
+    if (_profiler && _profiler->isRunning()) {
+        _profiler->stop();
+        setAgent(nullptr);
+    }
+}
+
+void ScriptEngine::resetProfile() {
+    if (_profiler) {
+        _profiler->reset();
+    }
+}
+
+QVariantMap ScriptEngine::getProfile() const {
+    return _profiler ? _profiler->getStats() : QVariantMap();
+}
+
+QString ScriptEngine::getProfileJSON(const QString& format) const {
+    if (!_profiler) {
+        return QString();
+    }
+    QJsonObject profile = (format == "flamegraph") ? _profiler->toFlameGraph() : _profiler->toChromeTrace();
+    return QJsonDocument(profile).toJson(QJsonDocument::Compact);
+}
+
+static const QString PROFILES_FOLDER = "script-profiles";
+static const int MAX_PROFILES = 20;
+static const qint64 MAX_PROFILES_SIZE = (qint64)MB_TO_BYTES(100);
+static const quint64 MIN_PROFILER_COMMAND_INTERVAL_USECS = USECS_PER_SECOND;
+
+// Deletes the oldest profiles beyond the number and total size kept
+static void pruneProfiles(const QDir& profilesDir) {
+    int numProfiles = 0;
+    qint64 profilesSize = 0;
+    for (const auto& profile : profilesDir.entryInfoList({ "*.json" }, QDir::Files, QDir::Time)) {
+        ++numProfiles;
+        profilesSize += profile.size();
+        if (numProfiles > MAX_PROFILES || profilesSize > MAX_PROFILES_SIZE) {
+            QFile::remove(profile.absoluteFilePath());
+        }
+    }
+}
+
+void ScriptEngine::handleProfilerMessage(const QString& message, const QUuid& senderID) {
+    QJsonObject command = QJsonDocument::fromJson(message.toUtf8()).object();
+    QString context = command["context"].toString();
+    if (!context.isEmpty() && context != getContext()) {
+        return;
+    }
+    handleProfilerCommand(command["command"].toString(), command["interval"].toInt(), command["format"].toString("chrome"),
+                          senderID);
+}
+
+void ScriptEngine::handleProfilerCommand(const QString& command, int sampleIntervalMS, const QString& format,
+                                         const QUuid& senderID) {
+    if (QThread::currentThread() != thread()) {
+        executeOnScriptThread([=] {
+            handleProfilerCommand(command, sampleIntervalMS, format, senderID);
+        });
+        return;
+    }
+
+    quint64 now = usecTimestampNow();
+    for (auto it = _lastProfilerCommandUsecs.begin(); it != _lastProfilerCommandUsecs.end();) {
+        if (now - it.value() >= MIN_PROFILER_COMMAND_INTERVAL_USECS) {
+            it = _lastProfilerCommandUsecs.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    if (_lastProfilerCommandUsecs.contains(senderID)) {
+        HIFI_FCDEBUG(scriptengine(), "Ignoring profiler command" << command << "from" << senderID << "sent too soon");
+        return;
+    }
+    _lastProfilerCommandUsecs[senderID] = now;
+
+    if (command == "start") {
+        resetProfile();
+        if (startProfiling(sampleIntervalMS > 0 ? sampleIntervalMS : ScriptProfiler::DEFAULT_SAMPLE_INTERVAL_MSECS)) {
+            qCDebug(scriptengine) << "Started profiling" << getFilename();
+        }
+    } else if (command == "stop" || command == "dump") {
+        if (command == "stop") {
+            stopProfiling();
+        }
+        if (!_profiler || _profiler->getNumSamples() == 0) {
+            qCDebug(scriptengine) << "No profile to save for" << getFilename();
+            return;
+        }
+
+        QDir profilesDir(PathUtils::getAppLocalDataPath());
+        profilesDir.mkpath(PROFILES_FOLDER);
+        profilesDir.cd(PROFILES_FOLDER);
+        QString baseName = QFileInfo(QUrl(getFilename()).path()).completeBaseName();
+        QString fileName = profilesDir.absoluteFilePath(QString("%1-%2-%3.json")
+            .arg(baseName.isEmpty() ? getContext() : baseName)
+            .arg(QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss"))
+            .arg((quintptr)this, 0, 16));
+        QFile file(fileName);
+        if (file.open(QIODevice::WriteOnly)) {
+            file.write(getProfileJSON(format).toUtf8());
+            file.close();
+            qCDebug(scriptengine) << "Saved profile of" << getFilename() << "to" << fileName;
+            pruneProfiles(profilesDir);
+        } else {
+            qCWarning(scriptengine) << "Could not save profile of" << getFilename() << "to" << fileName;
+        }
+    } else {
+        qCWarning(scriptengine) << "Unknown profiler command" << command;
+    }
+}
+
 QUrl ScriptEngine::resolvePath(const QString& include) const {
     QUrl url(include);
     // first lets check to see if it's already a full URL -- or a Windows path like "c:/"
@@ -1660,7 +1868,8 @@ QScriptValue ScriptEngine::instantiateModule(const QScriptValue& module, const Q
         closure.setProperty("require", module.property("require"));
         closure.setProperty("__filename", modulePath, READONLY_HIDDEN_PROP_FLAGS);
         closure.setProperty("__dirname", QString(modulePath).replace(QRegExp("/[^/]*$"), ""), READONLY_HIDDEN_PROP_FLAGS);
-        result = evaluateInClosure(closure, { sourceCode, modulePath });
+        result = evaluateInClosure(closure,
+            _programCache.getProgram(sourceCode, modulePath, 1, ScriptProgramCache::hashSource(sourceCode)));
     }
     maybeEmitUncaughtException(__FUNCTION__);
     return result;
@@ -1978,6 +2187,14 @@ QVariant ScriptEngine::cloneEntityScriptDetails(const EntityItemID& entityID) {
             map["status"] = EntityScriptStatus_::valueToKey(scriptDetails.status).toLower();
             map["errorInfo"] = scriptDetails.errorInfo;
             map["entityID"] = entityID.toString();
+            {
+                QVariantMap startup;
+                startup["fetchUsecs"] = scriptDetails.fetchUsecs;
+                startup["compileUsecs"] = scriptDetails.compileUsecs;
+                startup["constructUsecs"] = scriptDetails.constructUsecs;
+                startup["preloadUsecs"] = scriptDetails.preloadUsecs;
+                map["startup"] = startup;
+            }
 #ifdef DEBUG_ENTITY_STATES
             {
                 auto debug = QVariantMap();
@@ -2138,6 +2355,7 @@ void ScriptEngine::loadEntityScript(const EntityItemID& entityID, const QString&
     newDetails.scriptText = entityScript;
     newDetails.status = EntityScriptStatus::LOADING;
     newDetails.definingSandboxURL = currentSandboxURL;
+    newDetails.loadStartUsecs = usecTimestampNow();
     setEntityScriptDetails(entityID, newDetails);
 
     auto scriptCache = DependencyManager::get<ScriptCache>();
@@ -2235,6 +2453,11 @@ void ScriptEngine::entityScriptContentAvailable(const EntityItemID& entityID, co
 
     EntityScriptDetails newDetails;
     newDetails.scriptText = scriptOrURL;
+    newDetails.loadStartUsecs = oldDetails.loadStartUsecs;
+    quint64 stepStartUsecs = usecTimestampNow();
+    if (oldDetails.loadStartUsecs > 0) {
+        newDetails.fetchUsecs = stepStartUsecs - oldDetails.loadStartUsecs;
+    }
 
     // If an error happens below, we want to update newDetails with the new status info
     // and also abort any pending Entity loads that are waiting on the exact same script URL.
@@ -2257,85 +2480,96 @@ void ScriptEngine::entityScriptContentAvailable(const EntityItemID& entityID, co
         return;
     }
 
-    // SYNTAX ERRORS
-    auto syntaxError = lintScript(contents, fileName);
-    if (syntaxError.isError()) {
-        auto message = syntaxError.property("formatted").toString();
-        if (message.isEmpty()) {
-            message = syntaxError.toString();
+    // the syntax check and the sandbox preflight only depend on the contents, so they are skipped for contents that
+    // already passed them, typically a script shared by many entities or already loaded by another engine
+    QByteArray contentsHash = ScriptProgramCache::hashSource(contents);
+    if (!ScriptProgramCache::hasPassedPreflight(contentsHash)) {
+        // SYNTAX ERRORS
+        if (!ScriptProgramCache::hasPassedSyntaxCheck(contentsHash)) {
+            auto syntaxError = lintScript(contents, fileName);
+            if (syntaxError.isError()) {
+                auto message = syntaxError.property("formatted").toString();
+                if (message.isEmpty()) {
+                    message = syntaxError.toString();
+                }
+                setError(QString("Bad syntax (%1)").arg(message), EntityScriptStatus::ERROR_RUNNING_SCRIPT);
+                syntaxError.setProperty("detail", entityID.toString());
+                emit unhandledException(syntaxError);
+                return;
+            }
+            ScriptProgramCache::setPassedSyntaxCheck(contentsHash);
+        }
+        QScriptProgram program { contents, fileName };
+        if (program.isNull()) {
+            setError("Bad program (isNull)", EntityScriptStatus::ERROR_RUNNING_SCRIPT);
+            emit unhandledException(makeError("program.isNull"));
+            return; // done processing script
         }
-        setError(QString("Bad syntax (%1)").arg(message), EntityScriptStatus::ERROR_RUNNING_SCRIPT);
-        syntaxError.setProperty("detail", entityID.toString());
-        emit unhandledException(syntaxError);
-        return;
-    }
-    QScriptProgram program { contents, fileName };
-    if (program.isNull()) {
-        setError("Bad program (isNull)", EntityScriptStatus::ERROR_RUNNING_SCRIPT);
-        emit unhandledException(makeError("program.isNull"));
-        return; // done processing script
-    }
 
-    if (isURL) {
-        setParentURL(scriptOrURL);
-    }
+        // SANITY/PERFORMANCE CHECK USING SANDBOX
+        const int SANDBOX_TIMEOUT = 0.25 * MSECS_PER_SECOND;
+        BaseScriptEngine sandbox;
+        sandbox.setProcessEventsInterval(SANDBOX_TIMEOUT);
+        QScriptValue testConstructor, exception;
+        {
+            QTimer timeout;
+            timeout.setSingleShot(true);
+            timeout.start(SANDBOX_TIMEOUT);
+            connect(&timeout, &QTimer::timeout, [=, &sandbox]{
+                    qCDebug(scriptengine) << "ScriptEngine::entityScriptContentAvailable timeout(" << scriptOrURL << ")";
+
+                    // Guard against infinite loops and non-performant code
+                    sandbox.raiseException(
+                        sandbox.makeError(QString("Timed out (entity constructors are limited to %1ms)").arg(SANDBOX_TIMEOUT))
+                    );
+            });
 
-    // SANITY/PERFORMANCE CHECK USING SANDBOX
-    const int SANDBOX_TIMEOUT = 0.25 * MSECS_PER_SECOND;
-    BaseScriptEngine sandbox;
-    sandbox.setProcessEventsInterval(SANDBOX_TIMEOUT);
-    QScriptValue testConstructor, exception;
-    {
-        QTimer timeout;
-        timeout.setSingleShot(true);
-        timeout.start(SANDBOX_TIMEOUT);
-        connect(&timeout, &QTimer::timeout, [=, &sandbox]{
-                qCDebug(scriptengine) << "ScriptEngine::entityScriptContentAvailable timeout(" << scriptOrURL << ")";
-
-                // Guard against infinite loops and non-performant code
-                sandbox.raiseException(
-                    sandbox.makeError(QString("Timed out (entity constructors are limited to %1ms)").arg(SANDBOX_TIMEOUT))
-                );
-        });
+            testConstructor = sandbox.evaluate(program);
 
-        testConstructor = sandbox.evaluate(program);
+            if (sandbox.hasUncaughtException()) {
+                exception = sandbox.cloneUncaughtException(QString("(preflight %1)").arg(entityID.toString()));
+                sandbox.clearExceptions();
+            } else if (testConstructor.isError()) {
+                exception = testConstructor;
+            }
+        }
 
-        if (sandbox.hasUncaughtException()) {
-            exception = sandbox.cloneUncaughtException(QString("(preflight %1)").arg(entityID.toString()));
-            sandbox.clearExceptions();
-        } else if (testConstructor.isError()) {
-            exception = testConstructor;
+        if (exception.isError()) {
+            // create a local copy using makeError to decouple from the sandbox engine
+            exception = makeError(exception);
+            setError(formatException(exception, _enableExtendedJSExceptions.get()), EntityScriptStatus::ERROR_RUNNING_SCRIPT);
+            emit unhandledException(exception);
+            return;
         }
-    }
 
-    if (exception.isError()) {
-        // create a local copy using makeError to decouple from the sandbox engine
-        exception = makeError(exception);
-        setError(formatException(exception, _enableExtendedJSExceptions.get()), EntityScriptStatus::ERROR_RUNNING_SCRIPT);
-        emit unhandledException(exception);
-        return;
-    }
+        // CONSTRUCTOR VIABILITY
+        if (!testConstructor.isFunction()) {
+            QString testConstructorType = QString(testConstructor.toVariant().typeName());
+            if (testConstructorType == "") {
+                testConstructorType = "empty";
+            }
+            QString testConstructorValue = testConstructor.toString();
+            if (testConstructorValue.size() > MAX_DEBUG_VALUE_LENGTH) {
+                testConstructorValue = testConstructorValue.mid(0, MAX_DEBUG_VALUE_LENGTH) + "...";
+            }
+            auto message = QString("failed to load entity script -- expected a function, got %1, %2")
+                .arg(testConstructorType).arg(testConstructorValue);
 
-    // CONSTRUCTOR VIABILITY
-    if (!testConstructor.isFunction()) {
-        QString testConstructorType = QString(testConstructor.toVariant().typeName());
-        if (testConstructorType == "") {
-            testConstructorType = "empty";
-        }
-        QString testConstructorValue = testConstructor.toString();
-        if (testConstructorValue.size() > MAX_DEBUG_VALUE_LENGTH) {
-            testConstructorValue = testConstructorValue.mid(0, MAX_DEBUG_VALUE_LENGTH) + "...";
+            auto err = makeError(message);
+            err.setProperty("fileName", scriptOrURL);
+            err.setProperty("detail", "(constructor " + entityID.toString() + ")");
+
+            setError("Could not find constructor (" + testConstructorType + ")", EntityScriptStatus::ERROR_RUNNING_SCRIPT);
+            emit unhandledException(err);
+            return; // done processing script
         }
-        auto message = QString("failed to load entity script -- expected a function, got %1, %2")
-            .arg(testConstructorType).arg(testConstructorValue);
 
-        auto err = makeError(message);
-        err.setProperty("fileName", scriptOrURL);
-        err.setProperty("detail", "(constructor " + entityID.toString() + ")");
+        ScriptProgramCache::setPassedPreflight(contentsHash);
+    }
+    newDetails.compileUsecs = usecTimestampNow() - stepStartUsecs;
 
-        setError("Could not find constructor (" + testConstructorType + ")", EntityScriptStatus::ERROR_RUNNING_SCRIPT);
-        emit unhandledException(err);
-        return; // done processing script
+    if (isURL) {
+        setParentURL(scriptOrURL);
     }
 
     // (this feeds into refreshFileScript)
@@ -2358,7 +2592,9 @@ void ScriptEngine::entityScriptContentAvailable(const EntityItemID& entityID, co
         }
     };
 
+    stepStartUsecs = usecTimestampNow();
     doWithEnvironment(entityID, sandboxURL, initialization);
+    newDetails.constructUsecs = usecTimestampNow() - stepStartUsecs;
 
     if (entityScriptObject.isError()) {
         auto exception = entityScriptObject;
@@ -2379,7 +2615,12 @@ void ScriptEngine::entityScriptContentAvailable(const EntityItemID& entityID, co
     }
 
     // if we got this far, then call the preload method
+    stepStartUsecs = usecTimestampNow();
     callEntityScriptMethod(entityID, "preload");
+    auto details = _entityScripts.find(entityID);
+    if (details != _entityScripts.end()) {
+        details->preloadUsecs = usecTimestampNow() - stepStartUsecs;
+    }
 
     _occupiedScriptURLs.remove(entityScript);
     processDeferredEntityLoads(entityScript, entityID);
@@ -2504,6 +2745,10 @@ void ScriptEngine::doWithEnvironment(const EntityItemID& entityID, const QUrl& s
     currentEntityIdentifier = entityID;
     currentSandboxURL = sandboxURL;
 
+    // nested calls are charged to the outermost entity
+    bool timed = _context == ENTITY_SERVER_SCRIPT && !entityID.isNull() && oldIdentifier.isNull();
+    auto startTime = timed ? p_high_resolution_clock::now() : p_high_resolution_clock::time_point();
+
 #if DEBUG_CURRENT_ENTITY
     QScriptValue oldData = this->globalObject().property("debugEntityID");
     this->globalObject().setProperty("debugEntityID", entityID.toScriptValue(this)); // Make the entityID available to javascript as a global.
@@ -2515,6 +2760,19 @@ void ScriptEngine::doWithEnvironment(const EntityItemID& entityID, const QUrl& s
     maybeEmitUncaughtException(!entityID.isNull() ? entityID.toString() : __FUNCTION__);
     currentEntityIdentifier = oldIdentifier;
     currentSandboxURL = oldSandboxURL;
+
+    if (timed) {
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(p_high_resolution_clock::now() - startTime);
+        std::lock_guard<std::mutex> lock(_entityScriptUsecsMutex);
+        _entityScriptUsecs[entityID] += elapsed.count();
+    }
+}
+
+QHash<EntityItemID, quint64> ScriptEngine::takeEntityScriptUsecs() {
+    QHash<EntityItemID, quint64> result;
+    std::lock_guard<std::mutex> lock(_entityScriptUsecsMutex);
+    std::swap(result, _entityScriptUsecs);
+    return result;
 }
 
 void ScriptEngine::callWithEnvironment(const EntityItemID& entityID, const QUrl& sandboxURL, QScriptValue function, QScriptValue thisObject, QScriptValueList args) {
@@ -14,6 +14,7 @@
 
 #include <vector>
 
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QObject>
 #include <QtCore/QUrl>
 #include <QtCore/QSet>
@@ -30,6 +31,7 @@
 #include <EntityItemID.h>
 #include <EntitiesScriptEngineProvider.h>
 #include <EntityScriptUtils.h>
+#include <TimerWheel.h>
 
 #include "PointerEvent.h"
 #include "ArrayBufferClass.h"
@@ -39,6 +41,8 @@
 #include "Quat.h"
 #include "Mat4.h"
 #include "ScriptCache.h"
+#include "ScriptProfiler.h"
+#include "ScriptProgramCache.h"
 #include "ScriptUUID.h"
 #include "Vec3.h"
 #include "ConsoleScriptingInterface.h"
@@ -85,6 +89,13 @@ public:
     QScriptValue scriptObject { QScriptValue() };
     int64_t lastModified { 0 };
     QUrl definingSandboxURL { QUrl("about:EntityScript") };
+
+    // startup timings, filled in by ScriptEngine::entityScriptContentAvailable()
+    quint64 loadStartUsecs { 0 };
+    quint64 fetchUsecs { 0 };      // getting the contents from the ScriptCache or the network
+    quint64 compileUsecs { 0 };    // syntax check and preflight, zero when another entity already did them
+    quint64 constructUsecs { 0 };  // evaluating the script and constructing the entity script object
+    quint64 preloadUsecs { 0 };    // calling preload()
 };
 
 /**jsdoc
@@ -385,7 +396,7 @@ public:
      *     Script.clearInterval(timer);
      * }, 10000);
      */
-    Q_INVOKABLE void clearInterval(QObject* timer) { stopTimer(reinterpret_cast<QTimer*>(timer)); }
+    Q_INVOKABLE void clearInterval(QObject* timer) { stopTimer(timer); }
 
     /**jsdoc
      * Clear a timeout timer set by {@link Script.setTimeout|setTimeout}.
@@ -400,7 +411,88 @@ public:
      * // Uncomment the following line to stop the timer from firing.
      * //Script.clearTimeout(timer);
      */
-    Q_INVOKABLE void clearTimeout(QObject* timer) { stopTimer(reinterpret_cast<QTimer*>(timer)); }
+    Q_INVOKABLE void clearTimeout(QObject* timer) { stopTimer(timer); }
+
+    /**jsdoc
+     * Get statistics on the interval and timeout timers of this script.
+     * @function Script.getTimerStats
+     * @returns {object} An object with the number of running <code>timers</code>, <code>intervals</code> and
+     *     <code>timeouts</code>, the number of timer <code>callbacks</code> made and of <code>wakeups</code> they were
+     *     batched into, <code>callbacksPerWakeup</code>, the <code>averageLatency</code> and <code>maxLatency</code> between
+     *     a timer becoming due and its callback being called, and the <code>averageCallbackTime</code>, all times in ms.
+     * @example <caption>Report timer statistics every 10 seconds.</caption>
+     * Script.setInterval(function () {
+     *     print(JSON.stringify(Script.getTimerStats()));
+     * }, 10000);
+     */
+    Q_INVOKABLE QVariantMap getTimerStats() const;
+
+    /**jsdoc
+     * Start sampling which functions of this script its time is spent in. Profiling slows the script down, and can't be
+     * used while the script debugger is attached.
+     * @function Script.startProfiling
+     * @param {number} [sampleInterval=5] - The interval between samples, in ms.
+     * @returns {boolean} <code>true</code> if the profiler is running, otherwise <code>false</code>.
+     */
+    Q_INVOKABLE bool startProfiling(int sampleIntervalMS = ScriptProfiler::DEFAULT_SAMPLE_INTERVAL_MSECS);
+
+    /**jsdoc
+     * Stop sampling. The profile collected so far is kept until {@link Script.resetProfile|resetProfile} is called.
+     * @function Script.stopProfiling
+     */
+    Q_INVOKABLE void stopProfiling();
+
+    /**jsdoc
+     * @function Script.isProfiling
+     * @returns {boolean} <code>true</code> if the profiler is running, otherwise <code>false</code>.
+     */
+    Q_INVOKABLE bool isProfiling() const { return _profiler && _profiler->isRunning(); }
+
+    /**jsdoc
+     * Clear the profile collected so far.
+     * @function Script.resetProfile
+     */
+    Q_INVOKABLE void resetProfile();
+
+    /**jsdoc
+     * Get the profile collected so far.
+     * @function Script.getProfile
+     * @returns {object} An object with the <code>sampleInterval</code> in ms, the number of <code>samples</code> taken,
+     *     and a list of <code>functions</code>, each with its <code>name</code>, <code>file</code>, <code>line</code>,
+     *     the number of <code>calls</code> made to it and its <code>selfTime</code> and <code>totalTime</code> in ms,
+     *     most expensive first.
+     * @example <caption>Print the five most expensive functions after a minute.</caption>
+     * Script.startProfiling();
+     * Script.setTimeout(function () {
+     *     Script.stopProfiling();
+     *     Script.getProfile().functions.slice(0, 5).forEach(function (f) {
+     *         print(f.name + " " + f.file + ":" + f.line + " self " + f.selfTime + "ms total " + f.totalTime + "ms");
+     *     });
+     * }, 60000);
+     */
+    Q_INVOKABLE QVariantMap getProfile() const;
+
+    /**jsdoc
+     * Get the profile collected so far as JSON.
+     * @function Script.getProfileJSON
+     * @param {string} [format="chrome"] - <code>"chrome"</code> for a timeline in Chrome trace event format that can be
+     *     loaded in <code>chrome://tracing</code>, or <code>"flamegraph"</code> for a tree of <code>name</code>,
+     *     <code>value</code> and <code>children</code> as used by d3-flame-graph.
+     * @returns {string}
+     */
+    Q_INVOKABLE QString getProfileJSON(const QString& format = "chrome") const;
+
+    // Starts, stops or dumps the profiler of a running engine from any thread.  Dumps go to the script-profiles
+    // folder in the application's local data, in the given format, which only keeps the latest few.  Used by the
+    // assignment clients to profile their scripts without restarting.  Commands from a sender that come faster than
+    // one a second are ignored.
+    void handleProfilerCommand(const QString& command, int sampleIntervalMS, const QString& format,
+                               const QUuid& senderID = QUuid());
+
+    // Handles a message from MessagesClient::SCRIPT_PROFILER_CHANNEL, as JSON like {"command":"start","interval":5},
+    // {"command":"stop","format":"flamegraph"} or {"command":"dump"}.  An optional "context" of "agent" or "entity_server"
+    // limits a command to that kind of engine.  The messages mixer only forwards these from nodes with rez rights.
+    void handleProfilerMessage(const QString& message, const QUuid& senderID);
 
     /**jsdoc
      * @function Script.print
@@ -542,6 +634,10 @@ public:
     int getNumRunningEntityScripts() const;
     bool getEntityScriptDetails(const EntityItemID& entityID, EntityScriptDetails &details) const;
 
+    // microseconds spent running each entity's script code since the last call, only tracked for entity server scripts.
+    // Safe to call from any thread.
+    QHash<EntityItemID, quint64> takeEntityScriptUsecs();
+
 public slots:
 
     /**jsdoc
@@ -713,6 +809,7 @@ protected:
 
     QString logException(const QScriptValue& exception);
     void timerFired();
+    void scheduleTimerWheel();
     void stopAllTimers();
     void stopAllTimersForEntityScript(const EntityItemID& entityID);
     void refreshFileScript(const EntityItemID& entityID);
@@ -722,7 +819,7 @@ protected:
     void processDeferredEntityLoads(const QString& entityScript, const EntityItemID& leaderID);
 
     QObject* setupTimerWithInterval(const QScriptValue& function, int intervalMS, bool isSingleShot);
-    void stopTimer(QTimer* timer);
+    void stopTimer(QObject* timer);
 
     QHash<EntityItemID, RegisteredEventHandlers> _registeredHandlers;
     void forwardHandlerCall(const EntityItemID& entityID, const QString& eventName, QScriptValueList eventHanderArgs);
@@ -751,9 +848,31 @@ protected:
     std::atomic<bool> _isRunning { false };
     std::atomic<bool> _isStopping { false };
     bool _isInitialized { false };
-    QHash<QTimer*, CallbackData> _timerFunctionMap;
+
+    // Script timers all run off one timer wheel, woken by a single QTimer when the next of them comes due.
+    // The objects handed to scripts are plain QObjects that only identify the timer.
+    struct TimerData {
+        CallbackData callback;
+        TimerWheel::TimerID id;
+        bool isSingleShot;
+    };
+    QHash<QObject*, TimerData> _timerFunctionMap;
+    QHash<TimerWheel::TimerID, QObject*> _timerHandles;
+    TimerWheel _timerWheel;
+    QTimer* _timerWheelTimer { nullptr };
+    QElapsedTimer _timerClock;
+    int64_t _scheduledTimerWakeup { -1 };
+    std::vector<TimerWheel::Expired> _expiredTimers;
+    ScriptProfiler* _profiler { nullptr };
+    QHash<QUuid, quint64> _lastProfilerCommandUsecs;
+
+    quint64 _numTimerCallbacks { 0 };
+    quint64 _numTimerWakeups { 0 };
+    quint64 _totalTimerLatency { 0 };
+    int64_t _maxTimerLatency { 0 };
     QSet<QUrl> _includedURLs;
     QHash<EntityItemID, EntityScriptDetails> _entityScripts;
+    ScriptProgramCache _programCache;
     QHash<QString, EntityItemID> _occupiedScriptURLs;
     QList<DeferredLoadEntity> _deferredEntityLoads;
 
@@ -783,6 +902,9 @@ protected:
 
     std::chrono::microseconds _totalTimerExecution { 0 };
 
+    std::mutex _entityScriptUsecsMutex;
+    QHash<EntityItemID, quint64> _entityScriptUsecs;
+
     static const QString _SETTINGS_ENABLE_EXTENDED_MODULE_COMPAT;
     static const QString _SETTINGS_ENABLE_EXTENDED_EXCEPTIONS;
 
@@ -0,0 +1,380 @@
+//
+//  ScriptProfiler.cpp
+//  libraries/script-engine/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ScriptProfiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <numeric>
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QJsonArray>
+#include <QtCore/QStringList>
+#include <QtScript/QScriptContext>
+#include <QtScript/QScriptContextInfo>
+#include <QtScript/QScriptEngine>
+
+#include <DependencyManager.h>
+#include <Profile.h>
+#include <SharedUtil.h>
+#include <Trace.h>
+
+const int ScriptProfiler::DEFAULT_SAMPLE_INTERVAL_MSECS = 5;
+
+static const size_t MAX_TIMELINE_SAMPLES = 200000; // over 15 minutes of samples at the default interval
+static const int MAX_CACHED_CALLEES = 1 << 16;     // closures created on every call would otherwise grow this forever
+
+ScriptProfiler::ScriptProfiler(QScriptEngine* engine, int sampleIntervalMsecs) :
+    QScriptEngineAgent(engine),
+    _sampleIntervalUsecs(std::max(sampleIntervalMsecs, 1) * USECS_PER_MSEC)
+{
+}
+
+ScriptProfiler::~ScriptProfiler() {
+    stop();
+}
+
+void ScriptProfiler::start() {
+    if (isRunning()) {
+        return;
+    }
+    // when started from a script, the functions already on the stack return while the profiler is watching
+    int depth = 0;
+    for (QScriptContext* context = engine()->currentContext(); context && context->parentContext(); context = context->parentContext()) {
+        ++depth;
+    }
+    _depth = depth;
+    _pendingUsecs = 0;
+    _stopSampling = false;
+    _samplingThread = std::thread([this] { samplingLoop(); });
+}
+
+void ScriptProfiler::stop() {
+    if (!isRunning()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(_samplingMutex);
+        _stopSampling = true;
+    }
+    _samplingCondition.notify_all();
+    _samplingThread.join();
+}
+
+void ScriptProfiler::setSampleInterval(int sampleIntervalMsecs) {
+    _sampleIntervalUsecs = std::max(sampleIntervalMsecs, 1) * USECS_PER_MSEC;
+    _samplingCondition.notify_all();
+}
+
+void ScriptProfiler::reset() {
+    _functions.clear();
+    _functionIndices.clear();
+    _calleeFunctions.clear();
+    _stacks.clear();
+    _stackIndices.clear();
+    _stackUsecs.clear();
+    _timeline.clear();
+    _numSamples = 0;
+    _pendingUsecs = 0;
+}
+
+void ScriptProfiler::samplingLoop() {
+    std::unique_lock<std::mutex> lock(_samplingMutex);
+    auto lastWakeup = std::chrono::steady_clock::now();
+    auto nextSample = lastWakeup;
+    while (!_stopSampling) {
+        nextSample += std::chrono::microseconds(_sampleIntervalUsecs.load());
+        auto now = std::chrono::steady_clock::now();
+        if (nextSample < now) {
+            nextSample = now;
+        }
+        _samplingCondition.wait_until(lock, nextSample, [this] { return _stopSampling; });
+
+        // the time actually slept, wakeups run late on a busy machine.  An engine that isn't running script code isn't
+        // charged for anything, one that is owes the whole time even if it hasn't reached a statement to pay it yet.
+        now = std::chrono::steady_clock::now();
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(now - lastWakeup).count();
+        lastWakeup = now;
+        if (!_stopSampling && _depth.load(std::memory_order_relaxed) > 0) {
+            _pendingUsecs.fetch_add((quint64)elapsed, std::memory_order_relaxed);
+        }
+    }
+}
+
+void ScriptProfiler::functionEntry(qint64 scriptId) {
+    _depth.store(_depth.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    int index = findFunction(engine()->currentContext());
+    if (index >= 0) {
+        ++_functions[index].calls;
+    }
+}
+
+void ScriptProfiler::functionExit(qint64 scriptId, const QScriptValue& returnValue) {
+    int depth = _depth.load(std::memory_order_relaxed);
+    if (depth > 0) {
+        _depth.store(depth - 1, std::memory_order_relaxed);
+    }
+}
+
+void ScriptProfiler::positionChange(qint64 scriptId, int lineNumber, int columnNumber) {
+    if (_pendingUsecs.load(std::memory_order_relaxed) > 0) {
+        quint64 usecs = _pendingUsecs.exchange(0);
+        if (usecs > 0) {
+            takeSample(usecs);
+        }
+    }
+}
+
+QString ScriptProfiler::describeFunction(const Function& function) {
+    if (function.fileName.isEmpty()) {
+        return function.name;
+    }
+    if (function.lineNumber < 0) {
+        return QString("%1 (%2)").arg(function.name, function.fileName);
+    }
+    return QString("%1 (%2:%3)").arg(function.name, function.fileName).arg(function.lineNumber);
+}
+
+int ScriptProfiler::findFunction(QScriptContext* context) {
+    if (!context) {
+        return -1;
+    }
+    QScriptValue callee = context->callee();
+    qint64 calleeID = callee.isFunction() ? callee.objectId() : -1;
+    if (calleeID != -1) {
+        auto cached = _calleeFunctions.find(calleeID);
+        if (cached != _calleeFunctions.end()) {
+            return cached.value();
+        }
+    }
+
+    QScriptContextInfo info(context);
+    QString name = info.functionName();
+    QString fileName = info.fileName();
+    int lineNumber = info.functionStartLineNumber();
+    if (info.functionType() == QScriptContextInfo::NativeFunction) {
+        name = "[native] " + (name.isEmpty() ? QString("(anonymous)") : name);
+        fileName.clear();
+        lineNumber = -1;
+    } else if (!callee.isFunction()) {
+        name = "(program)";
+        lineNumber = -1;
+    } else if (name.isEmpty()) {
+        name = "(anonymous)";
+    }
+
+    QString key = name + '\n' + fileName + '\n' + QString::number(lineNumber);
+    int index = _functionIndices.value(key, -1);
+    if (index == -1) {
+        index = (int)_functions.size();
+        Function function;
+        function.name = name;
+        function.fileName = fileName;
+        function.lineNumber = lineNumber;
+        _functions.push_back(function);
+        _functionIndices.insert(key, index);
+    }
+
+    if (calleeID != -1) {
+        if (_calleeFunctions.size() >= MAX_CACHED_CALLEES) {
+            _calleeFunctions.clear();
+        }
+        _calleeFunctions.insert(calleeID, index);
+    }
+    return index;
+}
+
+int ScriptProfiler::findStack(const QVector<int>& frames) {
+    auto existing = _stackIndices.find(frames);
+    if (existing != _stackIndices.end()) {
+        return existing.value();
+    }
+    int index = (int)_stacks.size();
+    _stacks.push_back(frames);
+    _stackUsecs.push_back(0);
+    _stackIndices.insert(frames, index);
+    return index;
+}
+
+void ScriptProfiler::takeSample(quint64 usecs) {
+    QVector<int> frames;
+    for (QScriptContext* context = engine()->currentContext(); context; context = context->parentContext()) {
+        frames.push_back(findFunction(context));
+    }
+    if (!frames.isEmpty()) {
+        addSample(frames, usecs, usecTimestampNow());
+    }
+}
+
+void ScriptProfiler::addSample(QVector<int> frames, quint64 usecs, quint64 timestamp) {
+    _functions[frames.front()].selfUsecs += usecs;
+    for (int index : frames) {
+        // recursive functions are only charged once per sample
+        Function& function = _functions[index];
+        if (function.lastSample != _numSamples) {
+            function.lastSample = _numSamples;
+            function.totalUsecs += usecs;
+        }
+    }
+    ++_numSamples;
+
+    std::reverse(frames.begin(), frames.end());
+    int stack = findStack(frames);
+    _stackUsecs[stack] += usecs;
+    if (_timeline.size() < MAX_TIMELINE_SAMPLES) {
+        _timeline.push_back({ timestamp, stack, usecs });
+    }
+
+    if (DependencyManager::isSet<tracing::Tracer>() && tracing::enabled()) {
+        QStringList names;
+        for (int index : frames) {
+            names << describeFunction(_functions[index]);
+        }
+        tracing::traceEvent(trace_script(), _functions[frames.back()].name, tracing::Sample, "", { { "stack", names } });
+    }
+}
+
+QVariantMap ScriptProfiler::getStats() const {
+    std::vector<int> order(_functions.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [this](int a, int b) {
+        const Function& functionA = _functions[a];
+        const Function& functionB = _functions[b];
+        if (functionA.selfUsecs != functionB.selfUsecs) {
+            return functionA.selfUsecs > functionB.selfUsecs;
+        }
+        if (functionA.totalUsecs != functionB.totalUsecs) {
+            return functionA.totalUsecs > functionB.totalUsecs;
+        }
+        return functionA.calls > functionB.calls;
+    });
+
+    QVariantList functions;
+    for (int index : order) {
+        const Function& function = _functions[index];
+        QVariantMap functionStats;
+        functionStats["name"] = function.name;
+        functionStats["file"] = function.fileName;
+        functionStats["line"] = function.lineNumber;
+        functionStats["calls"] = function.calls;
+        functionStats["selfTime"] = (float)function.selfUsecs / (float)USECS_PER_MSEC;
+        functionStats["totalTime"] = (float)function.totalUsecs / (float)USECS_PER_MSEC;
+        functions.push_back(functionStats);
+    }
+
+    QVariantMap stats;
+    stats["sampleInterval"] = getSampleInterval();
+    stats["samples"] = _numSamples;
+    stats["functions"] = functions;
+    return stats;
+}
+
+QJsonObject ScriptProfiler::toChromeTrace() const {
+    QJsonArray events;
+    const qint64 processID = QCoreApplication::applicationPid();
+    const quint64 interval = _sampleIntervalUsecs.load();
+
+    // consecutive samples sharing the bottom of their stacks extend the same slices
+    QVector<int> openFrames;
+    QVector<quint64> openedAt;
+    auto closeFrames = [&](int framesToKeep, quint64 timestamp) {
+        while (openFrames.size() > framesToKeep) {
+            const Function& function = _functions[openFrames.back()];
+            QJsonObject event;
+            event["name"] = function.name;
+            event["cat"] = "script";
+            event["ph"] = "X";
+            event["ts"] = (double)openedAt.back();
+            event["dur"] = (double)(timestamp - openedAt.back());
+            event["pid"] = processID;
+            event["tid"] = 0;
+            event["args"] = QJsonObject { { "file", function.fileName }, { "line", function.lineNumber } };
+            events.push_back(event);
+            openFrames.pop_back();
+            openedAt.pop_back();
+        }
+    };
+
+    quint64 lastTimestamp = 0;
+    for (const Sample& sample : _timeline) {
+        // a sample covers the script time before it
+        quint64 begin = sample.timestamp - std::min(sample.usecs, sample.timestamp);
+        if (!openFrames.isEmpty() && begin > lastTimestamp + interval) {
+            // the engine was idle in between
+            closeFrames(0, lastTimestamp);
+        }
+        quint64 start = openFrames.isEmpty() ? begin : lastTimestamp;
+
+        const QVector<int>& frames = _stacks[sample.stack];
+        int commonFrames = 0;
+        while (commonFrames < openFrames.size() && commonFrames < frames.size() && openFrames[commonFrames] == frames[commonFrames]) {
+            ++commonFrames;
+        }
+        closeFrames(commonFrames, start);
+        for (int i = commonFrames; i < frames.size(); ++i) {
+            openFrames.push_back(frames[i]);
+            openedAt.push_back(start);
+        }
+        lastTimestamp = sample.timestamp;
+    }
+    closeFrames(0, lastTimestamp);
+
+    QJsonObject trace;
+    trace["traceEvents"] = events;
+    trace["displayTimeUnit"] = "ms";
+    return trace;
+}
+
+QJsonObject ScriptProfiler::toFlameGraph() const {
+    struct Node {
+        int function;
+        quint64 value;
+        std::vector<int> children;
+    };
+    std::vector<Node> nodes;
+    nodes.push_back({ -1, 0, {} });
+
+    for (size_t stack = 0; stack < _stacks.size(); ++stack) {
+        quint64 value = _stackUsecs[stack];
+        int node = 0;
+        nodes[node].value += value;
+        for (int function : _stacks[stack]) {
+            int child = -1;
+            for (int candidate : nodes[node].children) {
+                if (nodes[candidate].function == function) {
+                    child = candidate;
+                    break;
+                }
+            }
+            if (child == -1) {
+                child = (int)nodes.size();
+                nodes.push_back({ function, 0, {} });
+                nodes[node].children.push_back(child);
+            }
+            node = child;
+            nodes[node].value += value;
+        }
+    }
+
+    std::function<QJsonObject(int)> toJson = [&](int index) {
+        const Node& node = nodes[index];
+        QJsonArray children;
+        for (int child : node.children) {
+            children.push_back(toJson(child));
+        }
+        QJsonObject json;
+        json["name"] = (node.function == -1) ? QString("root") : describeFunction(_functions[node.function]);
+        json["value"] = (double)node.value;
+        json["children"] = children;
+        return json;
+    };
+    return toJson(0);
+}
@@ -0,0 +1,115 @@
+//
+//  ScriptProfiler.h
+//  libraries/script-engine/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ScriptProfiler_h
+#define hifi_ScriptProfiler_h
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <QtCore/QHash>
+#include <QtCore/QJsonObject>
+#include <QtCore/QString>
+#include <QtCore/QVariantMap>
+#include <QtCore/QVector>
+#include <QtScript/QScriptEngineAgent>
+
+#include <NumericalConstants.h>
+
+class QScriptContext;
+class ScriptProfilerTests;
+
+// Sampling profiler for the script functions of one engine.
+//
+// A sampling thread wakes up every interval and adds the time since its last wakeup to the time owed to the engine
+// while it is running script code.  The engine pays it as a sample at its next statement, since QScriptContext can't
+// be walked from anywhere else.  Each sample charges the owed time to the function on top of the stack (self time)
+// and once to every function on the stack (total time), so a native call that runs for many intervals is charged for
+// all of them, to the script function that made it.  Calls are counted exactly.  Must be created, used and destroyed
+// on the engine's thread.
+class ScriptProfiler : public QScriptEngineAgent {
+    friend class ::ScriptProfilerTests;
+public:
+    static const int DEFAULT_SAMPLE_INTERVAL_MSECS;
+
+    ScriptProfiler(QScriptEngine* engine, int sampleIntervalMsecs = DEFAULT_SAMPLE_INTERVAL_MSECS);
+    ~ScriptProfiler();
+
+    // starts and stops the sampling thread, the engine's agent is managed by the caller.  Data is kept until reset().
+    void start();
+    void stop();
+    bool isRunning() const { return _samplingThread.joinable(); }
+
+    void setSampleInterval(int sampleIntervalMsecs);
+    int getSampleInterval() const { return (int)(_sampleIntervalUsecs / USECS_PER_MSEC); }
+    void reset();
+
+    int getNumSamples() const { return _numSamples; }
+
+    // per-function calls, self and total time (ms), most expensive first
+    QVariantMap getStats() const;
+
+    // the samples as a timeline in Chrome trace event format, loadable in chrome://tracing like Tracer's output
+    QJsonObject toChromeTrace() const;
+
+    // the samples aggregated into a tree of { name, value, children } nodes as used by d3-flame-graph, values in usecs
+    QJsonObject toFlameGraph() const;
+
+    void functionEntry(qint64 scriptId) override;
+    void functionExit(qint64 scriptId, const QScriptValue& returnValue) override;
+    void positionChange(qint64 scriptId, int lineNumber, int columnNumber) override;
+
+private:
+    struct Function {
+        QString name;
+        QString fileName;
+        int lineNumber;
+        quint64 calls { 0 };
+        quint64 selfUsecs { 0 };
+        quint64 totalUsecs { 0 };
+        int lastSample { -1 };
+    };
+    struct Sample {
+        quint64 timestamp;
+        int stack;
+        quint64 usecs; // of script time up to timestamp
+    };
+
+    static QString describeFunction(const Function& function);
+
+    int findFunction(QScriptContext* context);
+    int findStack(const QVector<int>& frames);
+    void takeSample(quint64 usecs);
+    void addSample(QVector<int> frames, quint64 usecs, quint64 timestamp); // frames from the top of the stack
+    void samplingLoop();
+
+    std::vector<Function> _functions;
+    QHash<QString, int> _functionIndices;
+    QHash<qint64, int> _calleeFunctions;    // function object id => index in _functions, saves building a QScriptContextInfo per call
+    std::vector<QVector<int>> _stacks;      // distinct stacks seen by the samples, root first
+    QHash<QVector<int>, int> _stackIndices;
+    std::vector<quint64> _stackUsecs;
+    std::vector<Sample> _timeline;
+    int _numSamples { 0 };
+
+    std::atomic<quint64> _sampleIntervalUsecs;
+    std::atomic<int> _depth { 0 };
+    std::atomic<quint64> _pendingUsecs { 0 };  // script time the sampling thread has seen and no sample has charged yet
+
+    std::mutex _samplingMutex;
+    std::condition_variable _samplingCondition;
+    bool _stopSampling { false };
+    std::thread _samplingThread;
+};
+
+#endif // hifi_ScriptProfiler_h
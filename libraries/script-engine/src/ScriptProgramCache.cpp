@@ -0,0 +1,78 @@
+//
+//  ScriptProgramCache.cpp
+//  libraries/script-engine/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ScriptProgramCache.h"
+
+#include <mutex>
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QSet>
+
+// bound on the memory held by the shared checks, when one fills up it starts over
+static const int MAX_SHARED_SOURCE_HASHES = 8192;
+
+static std::mutex sharedHashesMutex;
+static QSet<QByteArray> syntaxCheckedHashes;
+static QSet<QByteArray> preflightedHashes;
+
+static bool containsHash(const QSet<QByteArray>& hashes, const QByteArray& sourceHash) {
+    std::lock_guard<std::mutex> lock(sharedHashesMutex);
+    return hashes.contains(sourceHash);
+}
+
+static void insertHash(QSet<QByteArray>& hashes, const QByteArray& sourceHash) {
+    std::lock_guard<std::mutex> lock(sharedHashesMutex);
+    if (hashes.size() >= MAX_SHARED_SOURCE_HASHES) {
+        hashes.clear();
+    }
+    hashes.insert(sourceHash);
+}
+
+QByteArray ScriptProgramCache::hashSource(const QString& sourceCode) {
+    // a cryptographic hash, since a collision would let a script skip the preflight that guards against slow constructors
+    return QCryptographicHash::hash(sourceCode.toUtf8(), QCryptographicHash::Sha256);
+}
+
+bool ScriptProgramCache::hasPassedSyntaxCheck(const QByteArray& sourceHash) {
+    return containsHash(syntaxCheckedHashes, sourceHash);
+}
+
+void ScriptProgramCache::setPassedSyntaxCheck(const QByteArray& sourceHash) {
+    insertHash(syntaxCheckedHashes, sourceHash);
+}
+
+bool ScriptProgramCache::hasPassedPreflight(const QByteArray& sourceHash) {
+    return containsHash(preflightedHashes, sourceHash);
+}
+
+void ScriptProgramCache::setPassedPreflight(const QByteArray& sourceHash) {
+    insertHash(preflightedHashes, sourceHash);
+}
+
+QScriptProgram ScriptProgramCache::getProgram(const QString& sourceCode, const QString& fileName, int lineNumber,
+                                              const QByteArray& sourceHash) {
+    // the file name and line are part of the program, they show up in exceptions and stack traces
+    QByteArray key = sourceHash + fileName.toUtf8() + ':' + QByteArray::number(lineNumber);
+    auto itr = _programs.constFind(key);
+    if (itr != _programs.constEnd()) {
+        ++_numHits;
+        return itr.value();
+    }
+
+    ++_numMisses;
+    if (_programs.size() >= MAX_PROGRAMS) {
+        _programs.clear();
+    }
+    QScriptProgram program { sourceCode, fileName, lineNumber };
+    if (!program.isNull()) {
+        _programs.insert(key, program);
+    }
+    return program;
+}
@@ -0,0 +1,51 @@
+//
+//  ScriptProgramCache.h
+//  libraries/script-engine/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ScriptProgramCache_h
+#define hifi_ScriptProgramCache_h
+
+#include <QtCore/QByteArray>
+#include <QtCore/QHash>
+#include <QtCore/QString>
+#include <QtScript/QScriptProgram>
+
+// Compiled programs of one script engine, keyed by the hash of their source.
+//
+// A QScriptProgram keeps the compiled form for the engine that last evaluated it and recompiles when it is handed to
+// another one, so programs are only reused within an engine; that covers the common case of one entity script
+// engine running the same script for many entities.  What is shared between engines is whether a source passed the
+// syntax check and the entity script preflight, since those only depend on the source text.
+class ScriptProgramCache {
+public:
+    // bound on the memory held by an engine's programs, when it fills up it starts over
+    static const int MAX_PROGRAMS = 512;
+
+    static QByteArray hashSource(const QString& sourceCode);
+
+    static bool hasPassedSyntaxCheck(const QByteArray& sourceHash);
+    static void setPassedSyntaxCheck(const QByteArray& sourceHash);
+
+    static bool hasPassedPreflight(const QByteArray& sourceHash);
+    static void setPassedPreflight(const QByteArray& sourceHash);
+
+    // returns the program for this source, file name and line, compiling it the first time it is asked for.
+    QScriptProgram getProgram(const QString& sourceCode, const QString& fileName, int lineNumber, const QByteArray& sourceHash);
+    void clear() { _programs.clear(); }
+
+    int getNumHits() const { return _numHits; }
+    int getNumMisses() const { return _numMisses; }
+
+private:
+    QHash<QByteArray, QScriptProgram> _programs;
+    int _numHits { 0 };
+    int _numMisses { 0 };
+};
+
+#endif // hifi_ScriptProgramCache_h
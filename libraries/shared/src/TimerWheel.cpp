@@ -0,0 +1,255 @@
+//
+//  TimerWheel.cpp
+//  libraries/shared/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "TimerWheel.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include <QtCore/QtAlgorithms>
+
+const TimerWheel::TimerID TimerWheel::INVALID_TIMER_ID;
+
+TimerWheel::TimerWheel(int64_t now) : _currentTick(now) {
+    for (auto& level : _slots) {
+        std::fill(std::begin(level), std::end(level), (int32_t)INVALID_INDEX);
+    }
+}
+
+int64_t TimerWheel::coalesce(int64_t dueTime, int64_t tolerance) {
+    if (tolerance <= 0) {
+        return dueTime;
+    }
+    // the largest power of two within the tolerance always has a multiple in [dueTime, dueTime + tolerance]
+    int64_t granularity = (int64_t)1 << (63 - qCountLeadingZeroBits((quint64)tolerance));
+    return (dueTime + tolerance) & ~(granularity - 1);
+}
+
+TimerWheel::TimerID TimerWheel::start(int64_t now, int64_t interval, int64_t tolerance, bool singleShot) {
+    int32_t index;
+    if (!_freeEntries.empty()) {
+        index = _freeEntries.back();
+        _freeEntries.pop_back();
+    } else {
+        index = (int32_t)_entries.size();
+        _entries.emplace_back();
+    }
+
+    Entry& entry = _entries[index];
+    entry.interval = std::max(interval, singleShot ? (int64_t)0 : (int64_t)1);
+    entry.tolerance = std::max(tolerance, (int64_t)0);
+    entry.dueTime = std::max(now, _currentTick) + entry.interval;
+    entry.sequence = _nextSequence++;
+    entry.singleShot = singleShot;
+    entry.active = true;
+    schedule(index);
+
+    ++_numTimers;
+    if (singleShot) {
+        ++_numSingleShotTimers;
+    }
+    return makeID(index, entry.generation);
+}
+
+bool TimerWheel::stop(TimerID id) {
+    int32_t index = findIndex(id);
+    if (index == INVALID_INDEX) {
+        return false;
+    }
+    unlink(index);
+    release(index);
+    return true;
+}
+
+bool TimerWheel::isActive(TimerID id) const {
+    return findIndex(id) != INVALID_INDEX;
+}
+
+void TimerWheel::clear() {
+    for (int32_t index = 0; index < (int32_t)_entries.size(); ++index) {
+        if (_entries[index].active) {
+            unlink(index);
+            release(index);
+        }
+    }
+}
+
+int32_t TimerWheel::findIndex(TimerID id) const {
+    uint32_t slot = (uint32_t)(id & 0xffffffff);
+    if (slot == 0 || slot > _entries.size()) {
+        return INVALID_INDEX;
+    }
+    int32_t index = (int32_t)slot - 1;
+    const Entry& entry = _entries[index];
+    if (!entry.active || entry.generation != (uint32_t)(id >> 32)) {
+        return INVALID_INDEX;
+    }
+    return index;
+}
+
+void TimerWheel::schedule(int32_t index) {
+    Entry& entry = _entries[index];
+    // the current tick has already been processed, nothing can be put back into it
+    entry.expiry = std::max(coalesce(entry.dueTime, entry.tolerance), _currentTick + 1);
+    link(index);
+}
+
+void TimerWheel::link(int32_t index) {
+    Entry& entry = _entries[index];
+    int64_t delta = std::max(entry.expiry - _currentTick, (int64_t)0);
+    int level = 0;
+    while (level < NUM_LEVELS - 1 && delta >= ((int64_t)1 << (SLOT_BITS * (level + 1)))) {
+        ++level;
+    }
+    int slot = (int)(((uint64_t)entry.expiry >> (SLOT_BITS * level)) & SLOT_MASK);
+
+    entry.level = (uint8_t)level;
+    entry.slot = (uint8_t)slot;
+    entry.previous = INVALID_INDEX;
+    entry.next = _slots[level][slot];
+    if (entry.next != INVALID_INDEX) {
+        _entries[entry.next].previous = index;
+    }
+    _slots[level][slot] = index;
+    _occupiedSlots[level] |= (uint64_t)1 << slot;
+}
+
+void TimerWheel::unlink(int32_t index) {
+    Entry& entry = _entries[index];
+    if (entry.previous != INVALID_INDEX) {
+        _entries[entry.previous].next = entry.next;
+    } else {
+        _slots[entry.level][entry.slot] = entry.next;
+        if (entry.next == INVALID_INDEX) {
+            _occupiedSlots[entry.level] &= ~((uint64_t)1 << entry.slot);
+        }
+    }
+    if (entry.next != INVALID_INDEX) {
+        _entries[entry.next].previous = entry.previous;
+    }
+    entry.previous = INVALID_INDEX;
+    entry.next = INVALID_INDEX;
+}
+
+void TimerWheel::release(int32_t index) {
+    Entry& entry = _entries[index];
+    if (entry.singleShot) {
+        --_numSingleShotTimers;
+    }
+    --_numTimers;
+    entry.active = false;
+    ++entry.generation;
+    _freeEntries.push_back(index);
+}
+
+void TimerWheel::cascade(int level) {
+    int slot = (int)(((uint64_t)_currentTick >> (SLOT_BITS * level)) & SLOT_MASK);
+    int32_t index = _slots[level][slot];
+    _slots[level][slot] = INVALID_INDEX;
+    _occupiedSlots[level] &= ~((uint64_t)1 << slot);
+
+    // everything in this slot is now less than one slot of this level away and moves to a lower level
+    while (index != INVALID_INDEX) {
+        int32_t next = _entries[index].next;
+        link(index);
+        index = next;
+    }
+}
+
+void TimerWheel::expireCurrentSlot(int64_t now, std::vector<Expired>& expiredOut) {
+    int slot = (int)((uint64_t)_currentTick & SLOT_MASK);
+    int32_t index = _slots[0][slot];
+    if (index == INVALID_INDEX) {
+        return;
+    }
+    _slots[0][slot] = INVALID_INDEX;
+    _occupiedSlots[0] &= ~((uint64_t)1 << slot);
+
+    _expiring.clear();
+    while (index != INVALID_INDEX) {
+        _expiring.push_back(index);
+        index = _entries[index].next;
+    }
+    if (_expiring.size() > 1) {
+        std::sort(_expiring.begin(), _expiring.end(), [this](int32_t a, int32_t b) {
+            const Entry& entryA = _entries[a];
+            const Entry& entryB = _entries[b];
+            return (entryA.dueTime != entryB.dueTime) ? (entryA.dueTime < entryB.dueTime) : (entryA.sequence < entryB.sequence);
+        });
+    }
+
+    for (int32_t expiring : _expiring) {
+        Entry& entry = _entries[expiring];
+        entry.previous = INVALID_INDEX;
+        entry.next = INVALID_INDEX;
+        expiredOut.push_back({ makeID(expiring, entry.generation), entry.dueTime });
+        if (entry.singleShot) {
+            release(expiring);
+        } else {
+            // like QTimer, a repeating timer that fell behind skips the firings it missed rather than bursting
+            entry.dueTime += entry.interval;
+            if (entry.dueTime <= now) {
+                entry.dueTime = now + entry.interval;
+            }
+            schedule(expiring);
+        }
+    }
+}
+
+void TimerWheel::advance(int64_t now, std::vector<Expired>& expiredOut) {
+    while (_currentTick < now) {
+        int64_t wakeup = getNextWakeup();
+        if (wakeup < 0) {
+            _currentTick = now;
+            break;
+        }
+        if (wakeup > _currentTick + 1) {
+            // nothing expires or cascades in between, jump straight to the tick before the next event
+            _currentTick = std::min(now, wakeup - 1);
+            continue;
+        }
+
+        ++_currentTick;
+        for (int level = 1; level < NUM_LEVELS; ++level) {
+            if (((uint64_t)_currentTick & (((uint64_t)1 << (SLOT_BITS * level)) - 1)) != 0) {
+                break;
+            }
+            cascade(level);
+        }
+        expireCurrentSlot(now, expiredOut);
+    }
+}
+
+int64_t TimerWheel::getNextWakeup() const {
+    if (_numTimers == 0) {
+        return -1;
+    }
+    int64_t wakeup = -1;
+    for (int level = 0; level < NUM_LEVELS; ++level) {
+        uint64_t occupied = _occupiedSlots[level];
+        if (occupied == 0) {
+            continue;
+        }
+        int shift = SLOT_BITS * level;
+        uint64_t block = (uint64_t)_currentTick >> shift;
+
+        // slots come around starting with the one after the current one, the current slot itself comes around last
+        int first = (int)((block + 1) & SLOT_MASK);
+        uint64_t rotated = (first == 0) ? occupied : ((occupied >> first) | (occupied << (NUM_SLOTS - first)));
+        uint64_t offset = qCountTrailingZeroBits(rotated);
+
+        // level 0 slots expire on their tick, higher level slots cascade at the start of their block
+        int64_t levelWakeup = (int64_t)((block + 1 + offset) << shift);
+        if (wakeup < 0 || levelWakeup < wakeup) {
+            wakeup = levelWakeup;
+        }
+    }
+    return wakeup;
+}
@@ -0,0 +1,99 @@
+//
+//  TimerWheel.h
+//  libraries/shared/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_TimerWheel_h
+#define hifi_TimerWheel_h
+
+#include <stdint.h>
+#include <vector>
+
+// Hierarchical timing wheel holding any number of one-shot and repeating timers behind a single wakeup.
+// Time is measured in ticks of whatever unit the caller uses (ScriptEngine uses milliseconds).  Starting and
+// stopping a timer is O(1), and advance() hands back every timer that came due as one batch.
+//
+// A timer started with a non-zero tolerance may fire up to tolerance ticks late; its expiry is rounded to a
+// coarse boundary within that window so that timers with similar deadlines land in the same slot and fire together.
+//
+// Not thread safe, the owner is expected to use it from a single thread.
+class TimerWheel {
+public:
+    using TimerID = uint64_t;
+    static const TimerID INVALID_TIMER_ID = 0;
+
+    struct Expired {
+        TimerID id;
+        int64_t dueTime; // when the timer was due before any coalescing, for measuring latency
+    };
+
+    explicit TimerWheel(int64_t now = 0);
+
+    // interval is clamped to at least one tick for repeating timers, tolerance is in ticks
+    TimerID start(int64_t now, int64_t interval, int64_t tolerance, bool singleShot);
+    bool stop(TimerID id);
+    bool isActive(TimerID id) const;
+    void clear();
+
+    // moves the wheel up to now and appends the timers that came due, in order of expiry.
+    // Single-shot timers are stopped, repeating timers are rescheduled and fire at most once per call.
+    void advance(int64_t now, std::vector<Expired>& expiredOut);
+
+    // earliest tick at which advance() may have work to do, or -1 when no timer is running.
+    // This can be earlier than the next expiry when a far away timer needs to move down the wheel.
+    int64_t getNextWakeup() const;
+
+    int getNumTimers() const { return _numTimers; }
+    int getNumSingleShotTimers() const { return _numSingleShotTimers; }
+    int64_t getCurrentTick() const { return _currentTick; }
+
+private:
+    static const int SLOT_BITS = 6;
+    static const int NUM_SLOTS = 1 << SLOT_BITS;
+    static const uint64_t SLOT_MASK = NUM_SLOTS - 1;
+    static const int NUM_LEVELS = 6; // 64^6 ticks, a couple of years at millisecond resolution
+    static const int32_t INVALID_INDEX = -1;
+
+    struct Entry {
+        int64_t dueTime { 0 };
+        int64_t expiry { 0 };
+        int64_t interval { 0 };
+        int64_t tolerance { 0 };
+        uint64_t sequence { 0 }; // start order, keeps timers due on the same tick firing first come first served
+        int32_t previous { INVALID_INDEX };
+        int32_t next { INVALID_INDEX };
+        uint32_t generation { 0 };
+        uint8_t level { 0 };
+        uint8_t slot { 0 };
+        bool singleShot { false };
+        bool active { false };
+    };
+
+    static int64_t coalesce(int64_t dueTime, int64_t tolerance);
+    static TimerID makeID(int32_t index, uint32_t generation) { return ((TimerID)generation << 32) | (TimerID)(index + 1); }
+
+    int32_t findIndex(TimerID id) const;
+    void schedule(int32_t index);
+    void link(int32_t index);
+    void unlink(int32_t index);
+    void release(int32_t index);
+    void cascade(int level);
+    void expireCurrentSlot(int64_t now, std::vector<Expired>& expiredOut);
+
+    std::vector<Entry> _entries;
+    std::vector<int32_t> _freeEntries;
+    std::vector<int32_t> _expiring;
+    int32_t _slots[NUM_LEVELS][NUM_SLOTS];
+    uint64_t _occupiedSlots[NUM_LEVELS] { 0, 0, 0, 0, 0, 0 };
+    int64_t _currentTick { 0 };
+    uint64_t _nextSequence { 0 };
+    int _numTimers { 0 };
+    int _numSingleShotTimers { 0 };
+};
+
+#endif // hifi_TimerWheel_h
@@ -9,12 +9,17 @@
 
 #include "AnimInverseKinematicsTests.h"
 
+#include <algorithm>
+#include <iostream>
+
 #include <glm/gtx/transform.hpp>
 
 #include <AnimInverseKinematics.h>
 #include <AnimBlendLinear.h>
 #include <AnimationLogging.h>
+#include <IKSolvers.h>
 #include <NumericalConstants.h>
+#include <SharedUtil.h>
 
 #include "../QTestExtensions.h"
 
@@ -305,3 +310,248 @@ void AnimInverseKinematicsTests::testBar() {
     QCOMPARE_WITH_ABS_ERROR(expectedTransC, poseC.trans(), EPSILON);
 }
 
+
+void AnimInverseKinematicsTests::testTwoBoneIK() {
+    const float acceptableError = 0.001f;
+
+    // straight limb along x, reachable target above the mid joint:
+    //
+    //         t
+    //
+    // A------>B------>C
+    //
+    glm::vec3 base = origin;
+    glm::vec3 mid = xAxis;
+    glm::vec3 tip = 2.0f * xAxis;
+    glm::vec3 target(1.0f, 1.0f, 0.0f);
+    glm::vec3 bendHint = yAxis;
+    float residual = solveTwoBoneIK(base, mid, tip, target, bendHint);
+
+    QVERIFY(fabsf(residual) < acceptableError);
+    QCOMPARE_WITH_ABS_ERROR(tip, target, acceptableError);
+    QVERIFY(fabsf(glm::length(mid - base) - 1.0f) < acceptableError);
+    QVERIFY(fabsf(glm::length(tip - mid) - 1.0f) < acceptableError);
+
+    // the mid joint bends toward the hint
+    glm::vec3 targetDir = glm::normalize(target - base);
+    glm::vec3 hintDir = bendHint - glm::dot(bendHint, targetDir) * targetDir;
+    QVERIFY(glm::dot(mid - base, hintDir) > 0.0f);
+
+    // out of reach targets straighten the limb toward the target
+    base = origin;
+    mid = glm::vec3(1.0f, 1.0f, 0.0f);
+    tip = glm::vec3(2.0f, 0.0f, 0.0f);
+    target = 5.0f * yAxis;
+    residual = solveTwoBoneIK(base, mid, tip, target, glm::vec3(0.0f));
+    QVERIFY(fabsf(residual - (5.0f - 2.0f * sqrtf(2.0f))) < acceptableError);
+    QCOMPARE_WITH_ABS_ERROR(mid, sqrtf(2.0f) * yAxis, acceptableError);
+    QCOMPARE_WITH_ABS_ERROR(tip, 2.0f * sqrtf(2.0f) * yAxis, acceptableError);
+}
+
+void AnimInverseKinematicsTests::testFABRIK() {
+    const float tolerance = 0.001f;
+    const int maxIterations = 20;
+
+    // D------>C------>B------>A, where A is the fixed root
+    const size_t NUM_POSITIONS = 4;
+    glm::vec3 positions[NUM_POSITIONS] = { 3.0f * xAxis, 2.0f * xAxis, xAxis, origin };
+
+    // reachable target
+    glm::vec3 target(1.0f, 2.0f, 0.0f);
+    float residual = FLT_MAX;
+    int numIterations = solveFABRIK(positions, NUM_POSITIONS, target, tolerance, maxIterations, residual);
+    QVERIFY(numIterations > 0);
+    QVERIFY(numIterations <= maxIterations);
+    QVERIFY(residual <= tolerance);
+    QCOMPARE_WITH_ABS_ERROR(positions[0], target, tolerance);
+    QCOMPARE_WITH_ABS_ERROR(positions[NUM_POSITIONS - 1], origin, EPSILON);
+    for (size_t i = 1; i < NUM_POSITIONS; i++) {
+        QVERIFY(fabsf(glm::length(positions[i] - positions[i - 1]) - 1.0f) < tolerance);
+    }
+
+    // unreachable target stretches the chain toward it in a single iteration
+    target = 10.0f * yAxis;
+    numIterations = solveFABRIK(positions, NUM_POSITIONS, target, tolerance, maxIterations, residual);
+    QCOMPARE(numIterations, 1);
+    QVERIFY(fabsf(residual - 7.0f) < tolerance);
+    for (size_t i = 0; i < NUM_POSITIONS; i++) {
+        QCOMPARE_WITH_ABS_ERROR(positions[i], (float)(NUM_POSITIONS - 1 - i) * yAxis, tolerance);
+    }
+}
+
+void AnimInverseKinematicsTests::testAnalyticSingleChain() {
+
+    AnimContext context(false, false, false, glm::mat4(), glm::mat4());
+
+    FBXGeometry geometry;
+    makeTestFBXJoints(geometry);
+
+    AnimSkeleton::Pointer skeletonPtr = std::make_shared<AnimSkeleton>(geometry);
+    AnimInverseKinematics ikDoll("doll");
+    ikDoll.setSkeleton(skeletonPtr);
+    ikDoll.setSolverMode(AnimInverseKinematics::SolverMode::Analytic);
+
+    // same starting pose as the hard CCD test:
+    //
+    // D<------C
+    //         |
+    //         |
+    // A------>B               t
+    //
+    AnimPose pose;
+    pose.scale() = glm::vec3(1.0f);
+    pose.rot() = identity;
+    pose.trans() = origin;
+
+    AnimPoseVec poses;
+    poses.push_back(pose);
+    pose.trans() = xAxis;
+    pose.rot() = quaterTurnAroundZ;
+    poses.push_back(pose);
+    poses.push_back(pose);
+    poses.push_back(pose);
+    ikDoll.loadPoses(poses);
+
+    AnimVariantMap varMap;
+    varMap.set("rotationD", identity);
+    varMap.set("targetTypeD", (int)IKTarget::Type::RotationAndPosition);
+    varMap.set("poleVectorEnabledD", false);
+    std::vector<float> flexCoefficients = {1.0f, 1.0f, 1.0f, 1.0f};
+    ikDoll.setTargetVars(QString("D"), QString("positionD"), QString("rotationD"), QString("targetTypeD"),
+                         QString("weightD"), 1.0f, flexCoefficients, QString("poleVectorEnabledD"),
+                         QString("poleReferenceVectorD"), QString("poleVectorD"));
+    AnimNode::Triggers triggers;
+
+    // run past the chain interpolation time so the last frame is a clean solve
+    float dt = 1.0f;
+    const int NUM_FRAMES = 10;
+    const float acceptableDistance = 0.01f;
+    const float acceptableAngle = 0.01f;
+
+    for (glm::vec3 targetPosition : { glm::vec3(3.0f, 0.0f, 0.0f), glm::vec3(2.0f, 1.0f, 0.0f), glm::vec3(1.5f, 0.5f, 0.5f) }) {
+        varMap.set("positionD", targetPosition);
+        AnimPoseVec solution = poses;
+        for (int i = 0; i < NUM_FRAMES; i++) {
+            solution = ikDoll.overlay(varMap, context, dt, triggers, poses);
+        }
+
+        AnimPoseVec absolutePoses = solution;
+        ikDoll.computeAbsolutePoses(absolutePoses);
+
+        // the root never moves and the tip meets both position and rotation targets
+        QCOMPARE_WITH_ABS_ERROR(absolutePoses[0].trans(), origin, acceptableDistance);
+        QCOMPARE_WITH_ABS_ERROR(absolutePoses[1].trans(), xAxis, acceptableDistance);
+        QCOMPARE_WITH_ABS_ERROR(absolutePoses[3].trans(), targetPosition, acceptableDistance);
+        QCOMPARE_QUATS(absolutePoses[3].rot(), identity, acceptableAngle);
+
+        QVERIFY(ikDoll.getMaxErrorOnLastSolve() < acceptableDistance);
+        QVERIFY(ikDoll.getNumIterationsOnLastSolve() >= 1);
+        QVERIFY(ikDoll.getNumIterationsOnLastSolve() <= 4);
+    }
+}
+
+#ifdef MANUAL_TEST
+static float randomFloat(float min, float max) {
+    return min + (max - min) * ((float)rand() / (float)RAND_MAX);
+}
+
+// hips and spine with two arms and two legs, enough for hand and foot targets
+static void makeLimbsFBXJoints(FBXGeometry& geometry) {
+    FBXJoint joint;
+    joint.isFree = false;
+    joint.distanceToParent = 1.0f;
+    joint.preTransform = glm::mat4();
+    joint.postTransform = glm::mat4();
+    joint.preRotation = identity;
+    joint.rotation = identity;
+    joint.postRotation = identity;
+    joint.rotationMin = glm::vec3(-PI);
+    joint.rotationMax = glm::vec3(PI);
+    joint.isSkeletonJoint = true;
+
+    auto addJoint = [&](const QString& name, int parentIndex, const glm::vec3& translation) {
+        joint.name = name;
+        joint.parentIndex = parentIndex;
+        joint.translation = translation;
+        geometry.joints.push_back(joint);
+        return (int)geometry.joints.size() - 1;
+    };
+
+    int hips = addJoint("Hips", -1, glm::vec3(0.0f, 1.0f, 0.0f));
+    int spine = addJoint("Spine", hips, glm::vec3(0.0f, 0.2f, 0.0f));
+    int spine2 = addJoint("Spine2", spine, glm::vec3(0.0f, 0.3f, 0.0f));
+    for (float side : { -1.0f, 1.0f }) {
+        QString prefix = side < 0.0f ? "Left" : "Right";
+        int parent = addJoint(prefix + "UpLeg", hips, glm::vec3(side * 0.1f, -0.05f, 0.0f));
+        parent = addJoint(prefix + "Leg", parent, glm::vec3(0.0f, -0.45f, 0.0f));
+        addJoint(prefix + "Foot", parent, glm::vec3(0.0f, -0.45f, 0.0f));
+        parent = addJoint(prefix + "Shoulder", spine2, glm::vec3(side * 0.05f, 0.15f, 0.0f));
+        parent = addJoint(prefix + "Arm", parent, glm::vec3(side * 0.1f, 0.0f, 0.0f));
+        parent = addJoint(prefix + "ForeArm", parent, glm::vec3(side * 0.3f, 0.0f, 0.0f));
+        addJoint(prefix + "Hand", parent, glm::vec3(side * 0.25f, 0.0f, 0.0f));
+    }
+}
+
+void AnimInverseKinematicsTests::benchmark() {
+    AnimContext context(false, false, false, glm::mat4(), glm::mat4());
+
+    FBXGeometry geometry;
+    makeLimbsFBXJoints(geometry);
+    AnimSkeleton::Pointer skeletonPtr = std::make_shared<AnimSkeleton>(geometry);
+    const AnimPoseVec& defaultPoses = skeletonPtr->getRelativeDefaultPoses();
+
+    // hands and feet reach for targets scattered around their rest positions
+    const char* TARGET_JOINTS[] = { "LeftHand", "RightHand", "LeftFoot", "RightFoot" };
+    const int NUM_FRAMES = 1000;
+    const float MAX_TARGET_OFFSET = 0.2f;
+    std::vector<glm::vec3> targetOffsets;
+    for (int i = 0; i < NUM_FRAMES; ++i) {
+        targetOffsets.push_back(glm::vec3(randomFloat(-MAX_TARGET_OFFSET, MAX_TARGET_OFFSET),
+                                          randomFloat(-MAX_TARGET_OFFSET, MAX_TARGET_OFFSET),
+                                          randomFloat(-MAX_TARGET_OFFSET, MAX_TARGET_OFFSET)));
+    }
+
+    for (auto solverMode : { AnimInverseKinematics::SolverMode::CCD, AnimInverseKinematics::SolverMode::Analytic }) {
+        AnimInverseKinematics ikDoll("doll");
+        ikDoll.setSkeleton(skeletonPtr);
+        ikDoll.setSolverMode(solverMode);
+        ikDoll.loadPoses(defaultPoses);
+
+        AnimVariantMap varMap;
+        std::vector<float> flexCoefficients = { 1.0f, 1.0f, 1.0f, 0.5f, 0.25f, 0.1f };
+        for (auto name : TARGET_JOINTS) {
+            QString jointName(name);
+            ikDoll.setTargetVars(jointName, jointName + "Position", jointName + "Rotation", jointName + "Type",
+                                 jointName + "Weight", 1.0f, flexCoefficients, jointName + "PoleVectorEnabled",
+                                 jointName + "PoleReferenceVector", jointName + "PoleVector");
+            varMap.set(jointName + "Type", (int)IKTarget::Type::RotationAndPosition);
+            varMap.set(jointName + "PoleVectorEnabled", false);
+            varMap.set(jointName + "Rotation", skeletonPtr->getAbsoluteDefaultPose(skeletonPtr->nameToJointIndex(jointName)).rot());
+        }
+        AnimNode::Triggers triggers;
+
+        int totalIterations = 0;
+        float totalError = 0.0f;
+        float worstError = 0.0f;
+        uint64_t start = usecTimestampNow();
+        for (int frame = 0; frame < NUM_FRAMES; ++frame) {
+            for (auto name : TARGET_JOINTS) {
+                QString jointName(name);
+                glm::vec3 restPosition = skeletonPtr->getAbsoluteDefaultPose(skeletonPtr->nameToJointIndex(jointName)).trans();
+                varMap.set(jointName + "Position", restPosition + targetOffsets[frame]);
+            }
+            ikDoll.overlay(varMap, context, 1.0f / 60.0f, triggers, defaultPoses);
+            totalIterations += ikDoll.getNumIterationsOnLastSolve();
+            totalError += ikDoll.getMaxErrorOnLastSolve();
+            worstError = std::max(worstError, ikDoll.getMaxErrorOnLastSolve());
+        }
+        float usecPerFrame = (float)(usecTimestampNow() - start) / (float)NUM_FRAMES;
+
+        std::cout << (solverMode == AnimInverseKinematics::SolverMode::CCD ? "CCD:      " : "Analytic: ")
+            << usecPerFrame << " usec/frame, "
+            << (float)totalIterations / (float)NUM_FRAMES << " iterations/frame, "
+            << "mean error " << totalError / (float)NUM_FRAMES << ", "
+            << "max error " << worstError << std::endl;
+    }
+}
+#endif // MANUAL_TEST
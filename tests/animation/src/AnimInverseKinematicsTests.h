@@ -13,6 +13,8 @@
 #include <QtTest/QtTest>
 #include <glm/glm.hpp>
 
+//#define MANUAL_TEST
+
 inline float getErrorDifference(float a, float b) {
     return fabs(a - b);
 }
@@ -22,6 +24,12 @@ class AnimInverseKinematicsTests : public QObject {
 private slots:
     void testSingleChain();
     void testBar();
+    void testTwoBoneIK();
+    void testFABRIK();
+    void testAnalyticSingleChain();
+#ifdef MANUAL_TEST
+    void benchmark();
+#endif // MANUAL_TEST
 };
 
 #endif // hifi_AnimInverseKinematicsTests_h
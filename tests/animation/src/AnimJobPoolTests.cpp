@@ -0,0 +1,191 @@
+//
+//  AnimJobPoolTests.cpp
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AnimJobPoolTests.h"
+
+#include <iostream>
+#include <memory>
+
+#include <AnimJobPool.h>
+#include <FBX.h>
+#include <GLMHelpers.h>
+#include <JointData.h>
+#include <NumericalConstants.h>
+#include <Rig.h>
+#include <SharedUtil.h>
+
+#include "../QTestExtensions.h"
+
+QTEST_MAIN(AnimJobPoolTests)
+
+void AnimJobPoolTests::testRunEveryJobOnce() {
+    const size_t NUM_JOBS = 1000;
+    for (int numThreads : { 1, 2, 4 }) {
+        AnimJobPool pool(numThreads);
+        QCOMPARE(pool.getNumThreads(), numThreads);
+
+        std::vector<int> counts(NUM_JOBS, 0);
+        pool.run(NUM_JOBS, [&](size_t i) {
+            counts[i]++;
+        });
+        for (size_t i = 0; i < NUM_JOBS; ++i) {
+            QCOMPARE(counts[i], 1);
+        }
+    }
+
+    AnimJobPool pool(0);
+    QVERIFY(pool.getNumThreads() >= 1);
+}
+
+void AnimJobPoolTests::testUpdateInterval() {
+    const float RADIUS = 1.0f;
+    QCOMPARE(AnimJobPool::computeUpdateInterval(RADIUS, 0.0f), 1);
+    QCOMPARE(AnimJobPool::computeUpdateInterval(RADIUS, 10.0f), 1);
+    QCOMPARE(AnimJobPool::computeUpdateInterval(RADIUS, 10000.0f), (int)AnimJobPool::MAX_UPDATE_INTERVAL);
+
+    // bigger things stay at full rate further away
+    QVERIFY(AnimJobPool::computeUpdateInterval(2.0f * RADIUS, 50.0f) < AnimJobPool::computeUpdateInterval(RADIUS, 50.0f));
+
+    int previousInterval = 1;
+    for (float distance = 1.0f; distance < 1000.0f; distance *= 1.5f) {
+        int interval = AnimJobPool::computeUpdateInterval(RADIUS, distance);
+        QVERIFY(interval >= previousInterval);
+        QVERIFY(interval <= AnimJobPool::MAX_UPDATE_INTERVAL);
+        previousInterval = interval;
+
+        // due exactly once in every run of interval frames, whatever the seed
+        for (uint32_t seed : { 0u, 3u, 12345u }) {
+            int numDue = 0;
+            for (uint32_t frame = 0; frame < (uint32_t)interval; ++frame) {
+                if (AnimJobPool::isUpdateDue(frame + 17, interval, seed)) {
+                    ++numDue;
+                }
+            }
+            QCOMPARE(numDue, 1);
+        }
+    }
+}
+
+#ifdef MANUAL_TEST
+static float randomFloat(float min, float max) {
+    return min + (max - min) * ((float)rand() / (float)RAND_MAX);
+}
+
+static glm::quat randomRotation() {
+    glm::vec3 axis = glm::normalize(glm::vec3(randomFloat(-1.0f, 1.0f), randomFloat(-1.0f, 1.0f), randomFloat(0.1f, 1.0f)));
+    return glm::angleAxis(randomFloat(-PI, PI), axis);
+}
+
+// a chain per limb from the hips, about as many joints as a full avatar with fingers
+static void makeBenchmarkFBXJoints(FBXGeometry& geometry) {
+    const int NUM_LIMBS = 8;
+    const int NUM_LIMB_JOINTS = 8;
+    FBXJoint joint;
+    joint.isFree = false;
+    joint.distanceToParent = 1.0f;
+    joint.preTransform = glm::mat4();
+    joint.postTransform = glm::mat4();
+    joint.rotationMin = glm::vec3(-PI);
+    joint.rotationMax = glm::vec3(PI);
+    joint.isSkeletonJoint = true;
+
+    joint.name = "Hips";
+    joint.parentIndex = -1;
+    joint.translation = glm::vec3(0.0f, 1.0f, 0.0f);
+    geometry.joints.push_back(joint);
+    for (int limb = 0; limb < NUM_LIMBS; ++limb) {
+        int parent = 0;
+        for (int i = 0; i < NUM_LIMB_JOINTS; ++i) {
+            joint.name = QString("Limb%1Joint%2").arg(limb).arg(i);
+            joint.parentIndex = parent;
+            joint.translation = glm::vec3(randomFloat(-0.1f, 0.1f), randomFloat(0.05f, 0.2f), randomFloat(-0.1f, 0.1f));
+            joint.preRotation = randomRotation();
+            geometry.joints.push_back(joint);
+            parent = (int)geometry.joints.size() - 1;
+        }
+    }
+}
+
+// A rig driven by a recorded clip of network joint data, plus the cluster matrices Model::updateClusterMatrices()
+// would build from it, which is the work AvatarManager hands to the pool for each other avatar.
+class ClipRig {
+public:
+    ClipRig(const FBXGeometry& geometry, int numFrames) {
+        _rig.initJointStates(geometry, glm::mat4());
+        int numJoints = (int)geometry.joints.size();
+        for (int i = 0; i < numJoints; ++i) {
+            _inverseBindMatrices.push_back(glm::inverse(_rig.getJointTransform(i)));
+        }
+        _clusterMatrices.resize(numJoints);
+
+        for (int frame = 0; frame < numFrames; ++frame) {
+            QVector<JointData> jointData(numJoints);
+            for (auto& data : jointData) {
+                data.rotation = randomRotation();
+                data.rotationIsDefaultPose = false;
+            }
+            _clip.push_back(jointData);
+        }
+    }
+
+    void update(int frame) {
+        _rig.copyJointsFromJointData(_clip[frame % _clip.size()]);
+        _rig.computeExternalPoses(glm::mat4());
+        for (size_t i = 0; i < _clusterMatrices.size(); ++i) {
+            glm_mat4u_mul(_rig.getJointTransform((int)i), _inverseBindMatrices[i], _clusterMatrices[i]);
+        }
+    }
+
+private:
+    Rig _rig;
+    std::vector<QVector<JointData>> _clip;
+    std::vector<glm::mat4> _inverseBindMatrices;
+    std::vector<glm::mat4> _clusterMatrices;
+};
+
+void AnimJobPoolTests::benchmark() {
+    FBXGeometry geometry;
+    makeBenchmarkFBXJoints(geometry);
+
+    const int NUM_AVATARS = 100;
+    const int NUM_CLIP_FRAMES = 60;
+    const int NUM_FRAMES = 300;
+    const float MAX_DISTANCE = 100.0f;
+    std::vector<std::unique_ptr<ClipRig>> avatars;
+    std::vector<float> distances;
+    for (int i = 0; i < NUM_AVATARS; ++i) {
+        avatars.emplace_back(new ClipRig(geometry, NUM_CLIP_FRAMES));
+        distances.push_back(MAX_DISTANCE * (float)(i + 1) / (float)NUM_AVATARS);
+    }
+
+    std::cout << NUM_AVATARS << " avatars, " << geometry.joints.size() << " joints each" << std::endl;
+    for (bool useLOD : { false, true }) {
+        for (int numThreads : { 1, 2, 4, 8 }) {
+            AnimJobPool pool(numThreads);
+            std::vector<ClipRig*> due;
+            uint64_t start = usecTimestampNow();
+            for (int frame = 0; frame < NUM_FRAMES; ++frame) {
+                due.clear();
+                for (int i = 0; i < NUM_AVATARS; ++i) {
+                    int interval = useLOD ? AnimJobPool::computeUpdateInterval(1.0f, distances[i]) : 1;
+                    if (AnimJobPool::isUpdateDue(frame, interval, i)) {
+                        due.push_back(avatars[i].get());
+                    }
+                }
+                pool.run(due.size(), [&](size_t i) {
+                    due[i]->update(frame);
+                });
+            }
+            float msecPerFrame = (float)(usecTimestampNow() - start) / (float)(USECS_PER_MSEC * NUM_FRAMES);
+            std::cout << (useLOD ? "with LOD, " : "no LOD, ") << numThreads << " threads: "
+                << msecPerFrame << " ms/frame" << std::endl;
+        }
+    }
+}
+#endif // MANUAL_TEST
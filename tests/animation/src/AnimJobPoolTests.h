@@ -0,0 +1,27 @@
+//
+//  AnimJobPoolTests.h
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AnimJobPoolTests_h
+#define hifi_AnimJobPoolTests_h
+
+#include <QtTest/QtTest>
+
+//#define MANUAL_TEST
+
+class AnimJobPoolTests : public QObject {
+    Q_OBJECT
+private slots:
+    void testRunEveryJobOnce();
+    void testUpdateInterval();
+#ifdef MANUAL_TEST
+    void benchmark();
+#endif // MANUAL_TEST
+};
+
+#endif // hifi_AnimJobPoolTests_h
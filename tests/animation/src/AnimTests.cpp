@@ -257,6 +257,57 @@ void AnimTests::testVariant() {
     QVERIFY(q.z == 4.0f);
 }
 
+void AnimTests::testVariantMap() {
+    AnimVariantKey emptyKey("");
+    AnimVariantKey floatKey("testVariantMapFloat");
+    AnimVariantKey sameFloatKey(QString("testVariantMapFloat"));
+    AnimVariantKey triggerKey("testVariantMapTrigger");
+
+    QVERIFY(!emptyKey.isValid());
+    QVERIFY(floatKey.isValid());
+    QVERIFY(floatKey == sameFloatKey);
+    QVERIFY(floatKey != triggerKey);
+    QCOMPARE(floatKey.getName(), QString("testVariantMapFloat"));
+    QVERIFY(AnimVariantKey::find("testVariantMapFloat") == floatKey);
+    QVERIFY(!AnimVariantKey::find("testVariantMapNeverInterned").isValid());
+
+    AnimVariantMap vars;
+    QCOMPARE(vars.lookup(floatKey, 2.0f), 2.0f);
+    QCOMPARE(vars.lookup(emptyKey, 2.0f), 2.0f);
+
+    // string and key interfaces share the same storage
+    vars.set("testVariantMapFloat", 3.0f);
+    QCOMPARE(vars.lookup(floatKey, 2.0f), 3.0f);
+    vars.set(floatKey, 4.0f);
+    QCOMPARE(vars.lookup("testVariantMapFloat", 2.0f), 4.0f);
+    QVERIFY(vars.hasKey("testVariantMapFloat"));
+
+    // looking up an unknown name must not intern it
+    int numSlots = AnimVariantKey::getNumSlots();
+    QCOMPARE(vars.lookup("testVariantMapNeverInterned", 5), 5);
+    QCOMPARE(AnimVariantKey::getNumSlots(), numSlots);
+
+    vars.setTrigger("testVariantMapTrigger");
+    QVERIFY(vars.lookup(triggerKey, false));
+    QVERIFY(!vars.hasKey("testVariantMapTrigger"));
+    vars.clearTriggers();
+    QVERIFY(!vars.lookup(triggerKey, false));
+
+    AnimVariantMap copy;
+    copy.set(triggerKey, true);
+    copy.copyVariantsFrom(vars);
+    QCOMPARE(copy.lookup(floatKey, 2.0f), 4.0f);
+    QVERIFY(copy.lookup(triggerKey, false));
+
+    vars.unset("testVariantMapFloat");
+    QVERIFY(!vars.hasKey("testVariantMapFloat"));
+    QCOMPARE(vars.lookup(floatKey, 2.0f), 2.0f);
+
+    copy.clearMap();
+    QVERIFY(!copy.hasKey("testVariantMapFloat"));
+    QVERIFY(!copy.lookup(triggerKey, false));
+}
+
 void AnimTests::testAccumulateTime() {
 
     float startFrame = 0.0f;
@@ -441,6 +492,19 @@ void AnimTests::testAnimPose() {
             }
         }
     }
+
+    // with a uniform lhs scale, poses are composed by parts, which has to match multiplying their matrices
+    AnimPose rhs(glm::vec3(1.0f, 2.0f, 0.5f), ROT_X_90 * ROT_Z_30, glm::vec3(1.0f, -2.0f, 3.0f));
+    std::vector<glm::vec3> lhsScaleVec = { glm::vec3(1.0f), glm::vec3(2.5f), glm::vec3(0.5f) };
+    for (auto& scale : lhsScaleVec) {
+        for (auto& rot : rotVec) {
+            for (auto& trans : transVec) {
+                AnimPose lhs(scale, rot, trans);
+                glm::mat4 expected = (glm::mat4)lhs * (glm::mat4)rhs;
+                QCOMPARE_WITH_ABS_ERROR((glm::mat4)(lhs * rhs), expected, EPSILON);
+            }
+        }
+    }
 }
 
 void AnimTests::testExpressionTokenizer() {
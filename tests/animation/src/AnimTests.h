@@ -25,6 +25,7 @@ private slots:
     void testClipEvaulateWithVars();
     void testLoader();
     void testVariant();
+    void testVariantMap();
     void testAccumulateTime();
     void testAnimPose();
     void testExpressionTokenizer();
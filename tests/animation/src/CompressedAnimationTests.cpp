@@ -0,0 +1,150 @@
+//
+//  CompressedAnimationTests.cpp
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "CompressedAnimationTests.h"
+
+#include <CompressedAnimation.h>
+#include <GLMHelpers.h>
+#include <NumericalConstants.h>
+
+#include "../QTestExtensions.h"
+
+QTEST_MAIN(CompressedAnimationTests)
+
+const float EPSILON = 0.0001f;
+const int NUM_JOINTS = 20;
+const int NUM_FRAMES = 300;
+
+static float randomFloat(float min, float max) {
+    return min + (max - min) * ((float)rand() / (float)RAND_MAX);
+}
+
+static float rotationChord(const glm::quat& a, const glm::quat& b) {
+    glm::vec4 va(a.x, a.y, a.z, a.w);
+    glm::vec4 vb(b.x, b.y, b.z, b.w);
+    return std::min(glm::length(va - vb), glm::length(va + vb));
+}
+
+// every joint swings around its own axis and bobs along its own direction, like a looping mocap clip.
+static QVector<FBXAnimationFrame> makeSmoothFrames() {
+    std::vector<glm::vec3> axes;
+    std::vector<glm::vec3> offsets;
+    std::vector<float> phases;
+    for (int joint = 0; joint < NUM_JOINTS; joint++) {
+        axes.push_back(glm::normalize(glm::vec3(randomFloat(-1.0f, 1.0f), randomFloat(-1.0f, 1.0f), randomFloat(0.1f, 1.0f))));
+        offsets.push_back(glm::vec3(randomFloat(-10.0f, 10.0f), randomFloat(5.0f, 20.0f), randomFloat(-10.0f, 10.0f)));
+        phases.push_back(randomFloat(0.0f, TWO_PI));
+    }
+
+    QVector<FBXAnimationFrame> frames(NUM_FRAMES);
+    for (int frame = 0; frame < NUM_FRAMES; frame++) {
+        float t = TWO_PI * (float)frame / (float)NUM_FRAMES;
+        frames[frame].rotations.resize(NUM_JOINTS);
+        frames[frame].translations.resize(NUM_JOINTS);
+        for (int joint = 0; joint < NUM_JOINTS; joint++) {
+            frames[frame].rotations[joint] = glm::angleAxis(0.5f * sinf(t + phases[joint]), axes[joint]);
+            frames[frame].translations[joint] = offsets[joint] * (1.0f + 0.1f * sinf(2.0f * t + phases[joint]));
+        }
+    }
+    return frames;
+}
+
+void CompressedAnimationTests::testConstantCurves() {
+    QVector<FBXAnimationFrame> frames(NUM_FRAMES);
+    for (int frame = 0; frame < NUM_FRAMES; frame++) {
+        frames[frame].rotations.resize(NUM_JOINTS);
+        frames[frame].translations.resize(NUM_JOINTS);
+        for (int joint = 0; joint < NUM_JOINTS; joint++) {
+            frames[frame].rotations[joint] = glm::angleAxis((float)joint * 0.1f, Vectors::UNIT_Y);
+            frames[frame].translations[joint] = glm::vec3(0.0f, (float)joint, 0.0f);
+        }
+    }
+
+    auto compressed = CompressedAnimation::compress(frames);
+    QCOMPARE(compressed->getNumFrames(), NUM_FRAMES);
+    QCOMPARE(compressed->getNumJoints(), NUM_JOINTS);
+
+    // a single key per curve
+    QCOMPARE(compressed->getNumKeys(), 2 * NUM_JOINTS);
+
+    for (int joint = 0; joint < NUM_JOINTS; joint++) {
+        QVERIFY(rotationChord(compressed->sampleRotation(joint, 123.4f), frames[0].rotations[joint]) < EPSILON);
+        QCOMPARE_WITH_ABS_ERROR(compressed->sampleTranslation(joint, 123.4f), frames[0].translations[joint], EPSILON);
+    }
+}
+
+void CompressedAnimationTests::testLinearCurves() {
+    QVector<FBXAnimationFrame> frames(NUM_FRAMES);
+    for (int frame = 0; frame < NUM_FRAMES; frame++) {
+        frames[frame].rotations.resize(1);
+        frames[frame].translations.resize(1);
+        frames[frame].rotations[0] = glm::angleAxis(0.2f * (float)frame / (float)NUM_FRAMES, Vectors::UNIT_X);
+        frames[frame].translations[0] = glm::vec3((float)frame, 2.0f * (float)frame, 0.0f);
+    }
+
+    auto compressed = CompressedAnimation::compress(frames);
+
+    // a straight line only needs its two end points, a slow turn only a handful of keys
+    int numRotationKeys = compressed->getNumKeys() - 2;
+    QVERIFY(numRotationKeys >= 2);
+    QVERIFY(numRotationKeys < NUM_FRAMES / 10);
+
+    // fractional frames interpolate
+    glm::vec3 expected(10.5f, 21.0f, 0.0f);
+    QCOMPARE_WITH_ABS_ERROR(compressed->sampleTranslation(0, 10.5f), expected, 0.05f);
+
+    // frames outside of the animation clamp
+    QCOMPARE_WITH_ABS_ERROR(compressed->sampleTranslation(0, -5.0f), frames[0].translations[0], 0.05f);
+    QCOMPARE_WITH_ABS_ERROR(compressed->sampleTranslation(0, (float)(NUM_FRAMES + 5)), frames[NUM_FRAMES - 1].translations[0], 0.05f);
+}
+
+void CompressedAnimationTests::testErrorBounds() {
+    QVector<FBXAnimationFrame> frames = makeSmoothFrames();
+    auto compressed = CompressedAnimation::compress(frames);
+
+    // rotations are within the requested angle, translations within the requested fraction of their size
+    const float MAX_ROTATION_CHORD = 2.0f * sinf(0.25f * CompressedAnimation::DEFAULT_MAX_ROTATION_ERROR) + EPSILON;
+    QVector<FBXAnimationFrame> decompressed = compressed->decompress();
+    QCOMPARE(decompressed.size(), NUM_FRAMES);
+    for (int frame = 0; frame < NUM_FRAMES; frame++) {
+        for (int joint = 0; joint < NUM_JOINTS; joint++) {
+            QVERIFY(rotationChord(decompressed[frame].rotations[joint], frames[frame].rotations[joint]) < MAX_ROTATION_CHORD);
+
+            float scale = 1.1f * glm::length(frames[0].translations[joint]);
+            float error = glm::length(decompressed[frame].translations[joint] - frames[frame].translations[joint]);
+            QVERIFY(error < CompressedAnimation::DEFAULT_MAX_TRANSLATION_ERROR * scale + EPSILON);
+        }
+    }
+
+    // smooth curves drop most of their keys
+    QVERIFY(compressed->getNumKeys() < NUM_FRAMES * NUM_JOINTS);
+    QVERIFY(compressed->getMemorySize() * 4 < CompressedAnimation::computeRawMemorySize(frames));
+}
+
+void CompressedAnimationTests::testSerialize() {
+    QVector<FBXAnimationFrame> frames = makeSmoothFrames();
+    auto compressed = CompressedAnimation::compress(frames);
+
+    QByteArray data = compressed->serialize();
+    auto copy = CompressedAnimation::deserialize(data);
+    QVERIFY(copy);
+    QCOMPARE(copy->getNumFrames(), compressed->getNumFrames());
+    QCOMPARE(copy->getNumJoints(), compressed->getNumJoints());
+    QCOMPARE(copy->getNumKeys(), compressed->getNumKeys());
+    for (int joint = 0; joint < NUM_JOINTS; joint++) {
+        float frame = randomFloat(0.0f, (float)NUM_FRAMES);
+        QVERIFY(rotationChord(copy->sampleRotation(joint, frame), compressed->sampleRotation(joint, frame)) < EPSILON);
+        QCOMPARE_WITH_ABS_ERROR(copy->sampleTranslation(joint, frame), compressed->sampleTranslation(joint, frame), EPSILON);
+    }
+
+    // truncated and garbage data are rejected
+    QVERIFY(!CompressedAnimation::deserialize(data.left(data.size() - 1)));
+    QVERIFY(!CompressedAnimation::deserialize(QByteArray(64, 'x')));
+    QVERIFY(!CompressedAnimation::deserialize(QByteArray()));
+}
@@ -0,0 +1,24 @@
+//
+//  CompressedAnimationTests.h
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_CompressedAnimationTests_h
+#define hifi_CompressedAnimationTests_h
+
+#include <QtTest/QtTest>
+
+class CompressedAnimationTests : public QObject {
+    Q_OBJECT
+private slots:
+    void testConstantCurves();
+    void testLinearCurves();
+    void testErrorBounds();
+    void testSerialize();
+};
+
+#endif // hifi_CompressedAnimationTests_h
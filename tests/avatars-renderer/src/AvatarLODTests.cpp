@@ -0,0 +1,179 @@
+//
+//  AvatarLODTests.cpp
+//  tests/avatars-renderer/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AvatarLODTests.h"
+
+#include <memory>
+
+#include <AnimJobPool.h>
+#include <DependencyManager.h>
+#include <FBX.h>
+#include <GeometryCache.h>
+#include <JointData.h>
+#include <NumericalConstants.h>
+#include <Rig.h>
+
+#include <avatars-renderer/OtherAvatar.h>
+
+#include "../GLMTestUtils.h"
+#include "../QTestExtensions.h"
+
+QTEST_MAIN(AvatarLODTests)
+
+const float EPSILON = 0.0001f;
+const float DELTA_TIME = 1.0f / 60.0f;
+const int NUM_JOINTS = 6;
+
+// An other-avatar as AvatarManager updates it, with joint data handed in the way the avatar mixer packets do
+class LODTestAvatar : public OtherAvatar {
+public:
+    LODTestAvatar() : OtherAvatar(QThread::currentThread()) {}
+
+    void receiveJointData(const QVector<JointData>& jointData) {
+        setRawJointData(jointData);
+        _hasNewJointData = true;
+    }
+
+    glm::mat4 getRigJointTransform(int index) { return getSkeletonModel()->getRig().getJointTransform(index); }
+};
+
+static void makeChainFBXJoints(FBXGeometry& geometry) {
+    FBXJoint joint;
+    joint.isFree = false;
+    joint.distanceToParent = 1.0f;
+    joint.preTransform = glm::mat4();
+    joint.postTransform = glm::mat4();
+    joint.preRotation = glm::quat();
+    joint.rotation = glm::quat();
+    joint.postRotation = glm::quat();
+    joint.rotationMin = glm::vec3(-PI);
+    joint.rotationMax = glm::vec3(PI);
+    joint.isSkeletonJoint = true;
+    for (int i = 0; i < NUM_JOINTS; ++i) {
+        joint.name = QString("Joint%1").arg(i);
+        joint.parentIndex = i - 1;
+        joint.translation = i == 0 ? glm::vec3(0.0f, 1.0f, 0.0f) : glm::vec3(0.0f, 0.2f, 0.0f);
+        geometry.joints.push_back(joint);
+    }
+}
+
+static QVector<JointData> makeJointData(float angle) {
+    QVector<JointData> jointData(NUM_JOINTS);
+    for (int i = 0; i < NUM_JOINTS; ++i) {
+        jointData[i].rotation = glm::angleAxis(angle * (float)(i + 1), glm::normalize(glm::vec3(1.0f, 0.5f, 0.25f)));
+        jointData[i].rotationIsDefaultPose = false;
+    }
+    return jointData;
+}
+
+static std::shared_ptr<LODTestAvatar> makeAvatar(const FBXGeometry& geometry) {
+    auto avatar = std::make_shared<LODTestAvatar>();
+    avatar->getSkeletonModel()->getRig().initJointStates(geometry, glm::mat4());
+    return avatar;
+}
+
+// the joints the avatar's rig should end up with for the given joint data
+static std::vector<glm::mat4> expectedTransforms(const FBXGeometry& geometry, const QVector<JointData>& jointData) {
+    Rig rig;
+    rig.initJointStates(geometry, glm::mat4());
+    rig.copyJointsFromJointData(jointData);
+    rig.computeExternalPoses(glm::mat4());
+    std::vector<glm::mat4> transforms;
+    for (int i = 0; i < NUM_JOINTS; ++i) {
+        transforms.push_back(rig.getJointTransform(i));
+    }
+    return transforms;
+}
+
+static void verifyRig(LODTestAvatar& avatar, const std::vector<glm::mat4>& expected) {
+    for (int i = 0; i < NUM_JOINTS; ++i) {
+        QCOMPARE_WITH_ABS_ERROR(avatar.getRigJointTransform(i), expected[i], EPSILON);
+    }
+}
+
+void AvatarLODTests::initTestCase() {
+    DependencyManager::set<GeometryCache>();
+}
+
+void AvatarLODTests::cleanupTestCase() {
+    DependencyManager::destroy<GeometryCache>();
+}
+
+void AvatarLODTests::skippedJointsWait() {
+    FBXGeometry geometry;
+    makeChainFBXJoints(geometry);
+    auto avatar = makeAvatar(geometry);
+    std::vector<glm::mat4> restTransforms;
+    for (int i = 0; i < NUM_JOINTS; ++i) {
+        restTransforms.push_back(avatar->getRigJointTransform(i));
+    }
+
+    auto jointData = makeJointData(0.3f);
+    avatar->receiveJointData(jointData);
+
+    // in view, but not its turn: the rig stays put and the joint data waits
+    avatar->simulate(DELTA_TIME, true, false);
+    QVERIFY(avatar->hasNewJointData());
+    verifyRig(*avatar, restTransforms);
+
+    // out of view never takes the joints either
+    avatar->simulate(DELTA_TIME, false, true);
+    QVERIFY(avatar->hasNewJointData());
+    verifyRig(*avatar, restTransforms);
+
+    avatar->simulate(DELTA_TIME, true, true);
+    QVERIFY(!avatar->hasNewJointData());
+    verifyRig(*avatar, expectedTransforms(geometry, jointData));
+}
+
+void AvatarLODTests::discardedRigUpdate() {
+    FBXGeometry geometry;
+    makeChainFBXJoints(geometry);
+    auto avatar = makeAvatar(geometry);
+
+    // the rig is updated ahead of simulate(), which the time budget then doesn't reach
+    avatar->receiveJointData(makeJointData(0.3f));
+    avatar->updateRigFromJointData();
+    avatar->discardRigUpdate();
+
+    // newer joints arrive before the next simulate
+    auto newJointData = makeJointData(-0.6f);
+    avatar->receiveJointData(newJointData);
+    avatar->simulate(DELTA_TIME, true, true);
+    verifyRig(*avatar, expectedTransforms(geometry, newJointData));
+}
+
+void AvatarLODTests::parallelRigUpdates() {
+    FBXGeometry geometry;
+    makeChainFBXJoints(geometry);
+
+    const int NUM_AVATARS = 16;
+    std::vector<std::shared_ptr<LODTestAvatar>> avatars;
+    std::vector<QVector<JointData>> jointData;
+    for (int i = 0; i < NUM_AVATARS; ++i) {
+        avatars.push_back(makeAvatar(geometry));
+        jointData.push_back(makeJointData(0.1f * (float)(i + 1)));
+        avatars[i]->receiveJointData(jointData[i]);
+    }
+
+    // as AvatarManager does: the rigs on the pool, then the serial simulate picks them up
+    AnimJobPool pool(4);
+    pool.run(avatars.size(), [&](size_t i) {
+        avatars[i]->updateRigFromJointData();
+    });
+    for (auto& avatar : avatars) {
+        avatar->simulate(DELTA_TIME, true, true);
+    }
+
+    for (int i = 0; i < NUM_AVATARS; ++i) {
+        QVERIFY(!avatars[i]->hasNewJointData());
+        verifyRig(*avatars[i], expectedTransforms(geometry, jointData[i]));
+    }
+}
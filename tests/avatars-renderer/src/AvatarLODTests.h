@@ -0,0 +1,26 @@
+//
+//  AvatarLODTests.h
+//  tests/avatars-renderer/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AvatarLODTests_h
+#define hifi_AvatarLODTests_h
+
+#include <QtTest/QtTest>
+
+class AvatarLODTests : public QObject {
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void skippedJointsWait();
+    void discardedRigUpdate();
+    void parallelRigUpdates();
+    void cleanupTestCase();
+};
+
+#endif // hifi_AvatarLODTests_h
@@ -0,0 +1,196 @@
+//
+//  MeshOptimizerTests.cpp
+//  tests/baking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "MeshOptimizerTests.h"
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <numeric>
+#include <random>
+#include <set>
+
+#include <MeshOptimizer.h>
+
+QTEST_GUILESS_MAIN(MeshOptimizerTests)
+
+using namespace mesh_optimizer;
+
+static const int GRID_SIZE = 32;
+
+static int gridVertex(int x, int y) {
+    return y * (GRID_SIZE + 1) + x;
+}
+
+// A GRID_SIZE square of quads, two triangles each, row by row
+static void makeGrid(QVector<glm::vec3>& positions, QVector<int>& indices, std::function<float(float, float)> height) {
+    positions.clear();
+    indices.clear();
+    for (int y = 0; y <= GRID_SIZE; y++) {
+        for (int x = 0; x <= GRID_SIZE; x++) {
+            float u = (float)x / GRID_SIZE;
+            float v = (float)y / GRID_SIZE;
+            positions.append(glm::vec3(u, v, height(u, v)));
+        }
+    }
+    for (int y = 0; y < GRID_SIZE; y++) {
+        for (int x = 0; x < GRID_SIZE; x++) {
+            indices << gridVertex(x, y) << gridVertex(x + 1, y) << gridVertex(x + 1, y + 1);
+            indices << gridVertex(x, y) << gridVertex(x + 1, y + 1) << gridVertex(x, y + 1);
+        }
+    }
+}
+
+static std::multiset<std::array<int, 3>> getTriangleSet(const QVector<int>& indices) {
+    std::multiset<std::array<int, 3>> triangles;
+    for (int i = 0; i + 2 < indices.size(); i += 3) {
+        triangles.insert({ { indices[i], indices[i + 1], indices[i + 2] } });
+    }
+    return triangles;
+}
+
+static int countTriangles(const LOD& lod) {
+    int count = 0;
+    for (const auto& indices : lod.parts) {
+        count += indices.size() / 3;
+    }
+    return count;
+}
+
+void MeshOptimizerTests::vertexCache() {
+    QVector<glm::vec3> positions;
+    QVector<int> indices;
+    makeGrid(positions, indices, [](float, float) { return 0.0f; });
+
+    // Scatter the triangles
+    QVector<int> shuffled;
+    std::vector<int> order(indices.size() / 3);
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), std::mt19937(1));
+    for (int triangle : order) {
+        shuffled << indices[triangle * 3] << indices[triangle * 3 + 1] << indices[triangle * 3 + 2];
+    }
+
+    QVector<int> optimized = optimizeVertexCache(shuffled);
+    QCOMPARE(optimized.size(), shuffled.size());
+    QVERIFY(getTriangleSet(optimized) == getTriangleSet(shuffled));
+
+    // A regular grid can't do better than 0.5, rows of a grid wider than the cache don't do better than 1
+    float shuffledACMR = evalACMR(shuffled);
+    float optimizedACMR = evalACMR(optimized);
+    QVERIFY(optimizedACMR >= 0.5f);
+    QVERIFY(optimizedACMR < 0.8f);
+    QVERIFY(optimizedACMR < 0.5f * shuffledACMR);
+}
+
+void MeshOptimizerTests::overdraw() {
+    QVector<glm::vec3> positions;
+    QVector<int> indices;
+    makeGrid(positions, indices, [](float u, float v) { return sinf(6.0f * u) * cosf(6.0f * v) * 0.2f; });
+
+    QVector<int> cacheOptimized = optimizeVertexCache(indices);
+    QVector<int> optimized = optimizeOverdraw(cacheOptimized, positions);
+    QVERIFY(getTriangleSet(optimized) == getTriangleSet(indices));
+    QVERIFY(evalACMR(optimized) <= 1.05f * evalACMR(cacheOptimized) + 1.0e-6f);
+
+    // Nothing to do for a single triangle
+    QVector<int> triangle { 0, 1, 2 };
+    QCOMPARE(optimizeOverdraw(triangle, positions), triangle);
+}
+
+void MeshOptimizerTests::flatLODs() {
+    QVector<glm::vec3> positions;
+    QVector<int> indices;
+    makeGrid(positions, indices, [](float, float) { return 0.0f; });
+
+    auto lods = generateLODs({ indices }, positions);
+    QVERIFY(!lods.isEmpty());
+    int triangleCount = indices.size() / 3;
+    for (const auto& lod : lods) {
+        // Collapsing within a plane doesn't move the surface
+        QCOMPARE(lod.parts.size(), 1);
+        QVERIFY(lod.error < 1.0e-4f);
+        int lodTriangleCount = countTriangles(lod);
+        QVERIFY(lodTriangleCount <= triangleCount * LOD_TRIANGLE_RATIO);
+        triangleCount = lodTriangleCount;
+    }
+
+    // Nothing flipped over
+    for (const auto& lod : lods) {
+        const auto& lodIndices = lod.parts[0];
+        for (int i = 0; i < lodIndices.size(); i += 3) {
+            glm::vec3 normal = glm::cross(positions[lodIndices[i + 1]] - positions[lodIndices[i]],
+                                          positions[lodIndices[i + 2]] - positions[lodIndices[i]]);
+            QVERIFY(normal.z > 0.0f);
+        }
+    }
+}
+
+void MeshOptimizerTests::curvedLODs() {
+    QVector<glm::vec3> positions;
+    QVector<int> indices;
+    makeGrid(positions, indices, [](float u, float v) { return (u - 0.5f) * (u - 0.5f) + (v - 0.5f) * (v - 0.5f); });
+
+    auto lods = generateLODs({ indices }, positions);
+    QCOMPARE(lods.size(), MAX_LOD_LEVELS);
+    float error = 0.0f;
+    for (const auto& lod : lods) {
+        QVERIFY(lod.error > 0.0f);
+        QVERIFY(lod.error >= error);
+        // Far less than the size of the bump
+        QVERIFY(lod.error < 0.05f);
+        error = lod.error;
+        for (int index : lod.parts[0]) {
+            QVERIFY(index >= 0 && index < positions.size());
+        }
+    }
+
+    // Too small to bother
+    QVERIFY(generateLODs({ indices.mid(0, 3 * (MIN_LOD_TRIANGLES - 1)) }, positions).isEmpty());
+}
+
+void MeshOptimizerTests::lockedBorders() {
+    QVector<glm::vec3> positions;
+    QVector<int> indices;
+    makeGrid(positions, indices, [](float u, float v) { return 0.1f * sinf(5.0f * u + 3.0f * v); });
+
+    // Left and right halves as separate parts
+    QVector<QVector<int>> parts(2);
+    for (int i = 0; i < indices.size(); i += 3) {
+        bool isLeft = positions[indices[i]].x + positions[indices[i + 1]].x + positions[indices[i + 2]].x < 1.5f;
+        parts[isLeft ? 0 : 1] << indices[i] << indices[i + 1] << indices[i + 2];
+    }
+    std::vector<std::set<int>> partVertices(2);
+    for (int i = 0; i < 2; i++) {
+        partVertices[i].insert(parts[i].begin(), parts[i].end());
+    }
+
+    auto lods = generateLODs(parts, positions);
+    QVERIFY(!lods.isEmpty());
+    for (const auto& lod : lods) {
+        QCOMPARE(lod.parts.size(), 2);
+        std::set<int> usedVertices;
+        for (int i = 0; i < 2; i++) {
+            for (int index : lod.parts[i]) {
+                // Only the vertices of the part, so they keep their material
+                QVERIFY(partVertices[i].count(index) == 1);
+                usedVertices.insert(index);
+            }
+        }
+
+        // The outline of the grid stays as it was
+        for (int j = 0; j <= GRID_SIZE; j++) {
+            QVERIFY(usedVertices.count(gridVertex(j, 0)) == 1);
+            QVERIFY(usedVertices.count(gridVertex(j, GRID_SIZE)) == 1);
+            QVERIFY(usedVertices.count(gridVertex(0, j)) == 1);
+            QVERIFY(usedVertices.count(gridVertex(GRID_SIZE, j)) == 1);
+        }
+    }
+}
@@ -0,0 +1,26 @@
+//
+//  MeshOptimizerTests.h
+//  tests/baking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_MeshOptimizerTests_h
+#define hifi_MeshOptimizerTests_h
+
+#include <QtTest/QtTest>
+
+class MeshOptimizerTests : public QObject {
+    Q_OBJECT
+private slots:
+    void vertexCache();
+    void overdraw();
+    void flatLODs();
+    void curvedLODs();
+    void lockedBorders();
+};
+
+#endif // hifi_MeshOptimizerTests_h
@@ -0,0 +1,162 @@
+//
+//  ModelBakerTests.cpp
+//  tests/baking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ModelBakerTests.h"
+
+#include <QtCore/QThread>
+
+#include <FBX.h>
+#include <FBXReader.h>
+#include <MeshOptimizer.h>
+#include <ModelBaker.h>
+
+QTEST_GUILESS_MAIN(ModelBakerTests)
+
+using namespace mesh_optimizer;
+
+static const int GRID_SIZE = 32;
+// a little more than the draco position quantization over the size of the grid
+static const float POSITION_EPSILON = 1.0e-3f;
+
+static int gridVertex(int x, int y) {
+    return y * (GRID_SIZE + 1) + x;
+}
+
+// A curved square in two parts, its left and right halves, so the baker makes simplified levels with both materials
+static FBXMesh makeMesh() {
+    FBXMesh mesh;
+    for (int y = 0; y <= GRID_SIZE; y++) {
+        for (int x = 0; x <= GRID_SIZE; x++) {
+            float u = (float)x / GRID_SIZE;
+            float v = (float)y / GRID_SIZE;
+            mesh.vertices.append(glm::vec3(u, v, (u - 0.5f) * (u - 0.5f) + (v - 0.5f) * (v - 0.5f)));
+        }
+    }
+    mesh.parts.resize(2);
+    for (int y = 0; y < GRID_SIZE; y++) {
+        for (int x = 0; x < GRID_SIZE; x++) {
+            auto& triangles = mesh.parts[x < GRID_SIZE / 2 ? 0 : 1].triangleIndices;
+            triangles << gridVertex(x, y) << gridVertex(x + 1, y) << gridVertex(x + 1, y + 1);
+            triangles << gridVertex(x, y) << gridVertex(x + 1, y + 1) << gridVertex(x, y + 1);
+        }
+    }
+    return mesh;
+}
+
+class TestModelBaker : public ModelBaker {
+public:
+    TestModelBaker() : ModelBaker(QUrl("file:///test.fbx"), [] { return QThread::currentThread(); }, QString()) {}
+    void bake() override {}
+};
+
+static FBXNode bakeMesh(FBXMesh mesh) {
+    TestModelBaker baker;
+    FBXNode dracoMeshNode;
+    bool compressed = baker.compressMesh(mesh, false, dracoMeshNode, [](int partIndex) { return partIndex; });
+    Q_ASSERT(compressed);
+    Q_UNUSED(compressed);
+    return dracoMeshNode;
+}
+
+static ExtractedMesh readMesh(const FBXNode& dracoMeshNode) {
+    FBXNode geometryNode;
+    geometryNode.name = "Geometry";
+    geometryNode.children.append(dracoMeshNode);
+    unsigned int meshIndex = 0;
+    return FBXReader::extractMesh(geometryNode, meshIndex);
+}
+
+static int findPart(const ExtractedMesh& extracted, int materialID) {
+    for (int i = 0; i < extracted.partMaterialTextures.size(); i++) {
+        if (extracted.partMaterialTextures[i].first == materialID) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void ModelBakerTests::lodRoundTrip() {
+    FBXMesh mesh = makeMesh();
+
+    // the levels as the baker makes them
+    FBXMesh weldedMesh = mesh;
+    weldVertices(weldedMesh, false);
+    QVector<QVector<int>> parts;
+    for (const auto& part : weldedMesh.parts) {
+        parts.append(part.triangleIndices);
+    }
+    auto lods = generateLODs(parts, weldedMesh.vertices);
+    QVERIFY(!lods.isEmpty());
+    for (auto& lod : lods) {
+        for (auto& triangles : lod.parts) {
+            triangles = optimizeVertexCache(triangles);
+        }
+    }
+
+    ExtractedMesh extracted = readMesh(bakeMesh(mesh));
+    const auto& vertices = extracted.mesh.vertices;
+    QCOMPARE(extracted.mesh.parts.size(), 2);
+    QCOMPARE(extracted.mesh.lods.size(), lods.size());
+
+    // the full level comes back whole, in an order that suits the vertex cache
+    for (int materialID = 0; materialID < 2; materialID++) {
+        int partIndex = findPart(extracted, materialID);
+        QVERIFY(partIndex >= 0);
+        const auto& triangles = extracted.mesh.parts[partIndex].triangleIndices;
+        QCOMPARE(triangles.size(), parts[materialID].size());
+        QVERIFY(evalACMR(triangles) <= 1.05f * evalACMR(optimizeVertexCache(triangles)) + 1.0e-6f);
+    }
+
+    // every simplified triangle lands on the same positions, corner for corner
+    for (int level = 0; level < lods.size(); level++) {
+        const auto& lod = extracted.mesh.lods[level];
+        QVERIFY(fabsf(lod.error - lods[level].error) < 1.0e-6f);
+        for (int materialID = 0; materialID < 2; materialID++) {
+            const auto& expected = lods[level].parts[materialID];
+            const auto& actual = lod.partTriangleIndices[findPart(extracted, materialID)];
+            QCOMPARE(actual.size(), expected.size());
+            for (int i = 0; i < actual.size(); i++) {
+                QVERIFY(actual[i] >= 0 && actual[i] < vertices.size());
+                QVERIFY(glm::distance(vertices[actual[i]], weldedMesh.vertices[expected[i]]) < POSITION_EPSILON);
+            }
+        }
+    }
+}
+
+void ModelBakerTests::invalidLODPart() {
+    FBXNode dracoMeshNode = bakeMesh(makeMesh());
+    int numLODs = readMesh(dracoMeshNode).mesh.lods.size();
+    QVERIFY(numLODs > 0);
+
+    // a part with a material the mesh doesn't have takes its whole level out, the others still load
+    FBXNode unknownMaterial = dracoMeshNode;
+    unknownMaterial.children[0].children[1].properties[0] = 99;
+    ExtractedMesh extracted = readMesh(unknownMaterial);
+    QCOMPARE(extracted.mesh.lods.size(), numLODs - 1);
+    for (const auto& lod : extracted.mesh.lods) {
+        for (const auto& indices : lod.partTriangleIndices) {
+            QVERIFY(!indices.isEmpty());
+        }
+    }
+
+    // so does a vertex the draco mesh doesn't have
+    FBXNode unknownVertex = dracoMeshNode;
+    QVector<int> indices = unknownVertex.children[0].children[0].properties[1].value<QVector<int>>();
+    indices[0] = 100000;
+    unknownVertex.children[0].children[0].properties[1] = QVariant::fromValue(indices);
+    QCOMPARE(readMesh(unknownVertex).mesh.lods.size(), numLODs - 1);
+
+    // and a part left with a partial triangle
+    FBXNode partialTriangle = dracoMeshNode;
+    indices = partialTriangle.children[0].children[0].properties[1].value<QVector<int>>();
+    indices.removeLast();
+    partialTriangle.children[0].children[0].properties[1] = QVariant::fromValue(indices);
+    QCOMPARE(readMesh(partialTriangle).mesh.lods.size(), numLODs - 1);
+}
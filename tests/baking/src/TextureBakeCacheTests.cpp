@@ -0,0 +1,113 @@
+//
+//  TextureBakeCacheTests.cpp
+//  tests/baking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "TextureBakeCacheTests.h"
+
+#include <QtCore/QJsonObject>
+
+#include <TextureBakeCache.h>
+
+QTEST_GUILESS_MAIN(TextureBakeCacheTests)
+
+static const QUrl TEXTURE_URL { "file:///textures/wood.png" };
+
+// The bakes are never started, the cache only looks at what they were made with and how they ended
+static QSharedPointer<TextureBaker> makeBaker(const QString& baseFilename,
+                                              image::TextureUsage::Type textureType = image::TextureUsage::ALBEDO_TEXTURE) {
+    return QSharedPointer<TextureBaker>::create(TEXTURE_URL, textureType, QDir("/baked"), "../", baseFilename);
+}
+
+static QSharedPointer<TextureBaker> findOrInsert(TextureBakeCache& cache, const QSharedPointer<TextureBaker>& baker) {
+    return cache.findOrInsert(baker->getTextureURL(), baker->getTextureType(), baker);
+}
+
+// The report of the only texture in the cache, empty if there are more
+static QJsonObject getOnlyReport(const TextureBakeCache& cache) {
+    QJsonArray report = cache.getReport();
+    return report.size() == 1 ? report.at(0).toObject() : QJsonObject();
+}
+
+void TextureBakeCacheTests::sharedBake() {
+    TextureBakeCache cache;
+    auto first = makeBaker("wood");
+    QCOMPARE(findOrInsert(cache, first), first);
+    QVERIFY(!cache.isShared(first.data()));
+    QCOMPARE(cache.getBaseFilename(TEXTURE_URL, image::TextureUsage::ALBEDO_TEXTURE), QString("wood"));
+
+    // the next model under the same name waits on the first bake
+    auto second = makeBaker("wood");
+    QCOMPARE(findOrInsert(cache, second), first);
+    QVERIFY(cache.isShared(first.data()));
+    QVERIFY(!cache.isShared(second.data()));
+    QCOMPARE(getOnlyReport(cache)["models"].toInt(), 2);
+}
+
+void TextureBakeCacheTests::nameCollision() {
+    TextureBakeCache cache;
+    auto first = makeBaker("wood");
+    findOrInsert(cache, first);
+
+    // a model that already had another texture called wood bakes this one itself, the first bake isn't shared
+    auto renamed = makeBaker("wood-1");
+    QCOMPARE(findOrInsert(cache, renamed), renamed);
+    QVERIFY(!cache.isShared(first.data()));
+    QVERIFY(!cache.isShared(renamed.data()));
+    QCOMPARE(getOnlyReport(cache)["models"].toInt(), 1);
+
+    // and the cache keeps offering the first name
+    QCOMPARE(cache.getBaseFilename(TEXTURE_URL, image::TextureUsage::ALBEDO_TEXTURE), QString("wood"));
+    QCOMPARE(findOrInsert(cache, makeBaker("wood")), first);
+    QVERIFY(cache.isShared(first.data()));
+}
+
+void TextureBakeCacheTests::usages() {
+    TextureBakeCache cache;
+    auto albedo = makeBaker("wood");
+    auto normal = makeBaker("wood", image::TextureUsage::NORMAL_TEXTURE);
+    QCOMPARE(findOrInsert(cache, albedo), albedo);
+    QCOMPARE(findOrInsert(cache, normal), normal);
+    QVERIFY(!cache.isShared(albedo.data()));
+    QVERIFY(!cache.isShared(normal.data()));
+    QCOMPARE(cache.getReport().size(), 2);
+}
+
+void TextureBakeCacheTests::abortedBake() {
+    TextureBakeCache cache;
+    auto first = makeBaker("wood");
+    findOrInsert(cache, first);
+    findOrInsert(cache, makeBaker("wood"));
+    first->setWasAborted(true);
+    QVERIFY(cache.getBaseFilename(TEXTURE_URL, image::TextureUsage::ALBEDO_TEXTURE).isEmpty());
+
+    // the next model starts over, with nobody to share it yet
+    auto retry = makeBaker("wood");
+    QCOMPARE(findOrInsert(cache, retry), retry);
+    QVERIFY(!cache.isShared(first.data()));
+    QVERIFY(!cache.isShared(retry.data()));
+    QCOMPARE(getOnlyReport(cache)["models"].toInt(), 1);
+}
+
+void TextureBakeCacheTests::report() {
+    TextureBakeCache cache;
+    auto baker = makeBaker("wood");
+    findOrInsert(cache, baker);
+
+    QJsonObject texture = getOnlyReport(cache);
+    QVERIFY(!texture.isEmpty());
+    QCOMPARE(texture["url"].toString(), TEXTURE_URL.toString());
+    QCOMPARE(texture["usage"].toInt(), (int)image::TextureUsage::ALBEDO_TEXTURE);
+    QCOMPARE(texture["bakeMsecs"].toDouble(), -1.0);
+    QVERIFY(!texture.contains("errors"));
+
+    baker->setIsFinished(true);
+    texture = getOnlyReport(cache);
+    QVERIFY(texture["bakeMsecs"].toDouble() >= 0.0);
+    QCOMPARE(texture["errors"].toArray().size(), 0);
+}
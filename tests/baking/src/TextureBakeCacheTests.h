@@ -0,0 +1,26 @@
+//
+//  TextureBakeCacheTests.h
+//  tests/baking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_TextureBakeCacheTests_h
+#define hifi_TextureBakeCacheTests_h
+
+#include <QtTest/QtTest>
+
+class TextureBakeCacheTests : public QObject {
+    Q_OBJECT
+private slots:
+    void sharedBake();
+    void nameCollision();
+    void usages();
+    void abortedBake();
+    void report();
+};
+
+#endif // hifi_TextureBakeCacheTests_h
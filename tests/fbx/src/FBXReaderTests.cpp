@@ -0,0 +1,253 @@
+//
+//  FBXReaderTests.cpp
+//  tests/fbx/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "FBXReaderTests.h"
+
+#include <memory>
+
+#include <QtCore/QBuffer>
+#include <QtCore/QtEndian>
+#include <QtCore/QTemporaryFile>
+
+#include <FBX.h>
+#include <FBXReader.h>
+
+#include <LegacyFBXReader.h>
+
+QTEST_GUILESS_MAIN(FBXReaderTests)
+
+static QString getModelPath(const QString& path) {
+    return QString(FBX_TEST_MODELS_DIR) + "/" + path;
+}
+
+template <typename T>
+static bool isArrayOf(const QVariant& value) {
+    return value.userType() == qMetaTypeId<QVector<T>>();
+}
+
+// The legacy reader decoded arrays into QVectors as it read them, the parser leaves them to be decoded on conversion
+static void compareProperty(const QVariant& actual, const QVariant& expected) {
+    if (isArrayOf<float>(expected)) {
+        QCOMPARE(actual.value<QVector<float>>(), expected.value<QVector<float>>());
+    } else if (isArrayOf<double>(expected)) {
+        QCOMPARE(actual.value<QVector<double>>(), expected.value<QVector<double>>());
+    } else if (isArrayOf<qint64>(expected)) {
+        QCOMPARE(actual.value<QVector<qint64>>(), expected.value<QVector<qint64>>());
+    } else if (isArrayOf<qint32>(expected)) {
+        QCOMPARE(actual.value<QVector<qint32>>(), expected.value<QVector<qint32>>());
+    } else if (isArrayOf<bool>(expected)) {
+        QCOMPARE(actual.value<QVector<bool>>(), expected.value<QVector<bool>>());
+    } else {
+        QCOMPARE(actual, expected);
+    }
+}
+
+static void compareNodes(const FBXNode& actual, const FBXNode& expected) {
+    QCOMPARE(actual.name, expected.name);
+    QCOMPARE(actual.properties.size(), expected.properties.size());
+    for (int i = 0; i < expected.properties.size(); i++) {
+        compareProperty(actual.properties.at(i), expected.properties.at(i));
+        if (QTest::currentTestFailed()) {
+            qDebug() << "in property" << i << "of" << expected.name;
+            return;
+        }
+    }
+    QCOMPARE(actual.children.size(), expected.children.size());
+    for (int i = 0; i < expected.children.size(); i++) {
+        compareNodes(actual.children.at(i), expected.children.at(i));
+        if (QTest::currentTestFailed()) {
+            return;
+        }
+    }
+}
+
+// A binary FBX file of a single Indices node holding the values as an int array
+static QByteArray makeIndicesFBX(const QVector<qint32>& values, bool compressed, bool corrupt = false) {
+    QByteArray arrayData;
+    {
+        QDataStream out(&arrayData, QIODevice::WriteOnly);
+        out.setByteOrder(QDataStream::LittleEndian);
+        for (qint32 value : values) {
+            out << value;
+        }
+    }
+    if (compressed) {
+        // qCompress puts the uncompressed length in front of the zlib stream
+        arrayData = qCompress(arrayData).mid(sizeof(quint32));
+        if (corrupt) {
+            arrayData.truncate(arrayData.size() / 2);
+        }
+    }
+
+    const QByteArray NAME = "Indices";
+    const int HEADER_BYTES = FBX_HEADER_BYTES_BEFORE_VERSION + sizeof(quint32);
+    const int NODE_HEADER_BYTES = 3 * sizeof(quint32) + sizeof(quint8);
+    quint32 propertyListLength = sizeof(qint8) + 3 * sizeof(quint32) + arrayData.size();
+    quint32 endOffset = HEADER_BYTES + NODE_HEADER_BYTES + NAME.size() + propertyListLength;
+
+    QByteArray fbx;
+    QDataStream out(&fbx, QIODevice::WriteOnly);
+    out.setByteOrder(QDataStream::LittleEndian);
+    out.writeRawData(FBX_BINARY_PROLOG.constData(), FBX_BINARY_PROLOG.size());
+    out.writeRawData("\0\x1a\0", 3);
+    out << (quint32)7400;
+
+    out << endOffset << (quint32)1 << propertyListLength << (quint8)NAME.size();
+    out.writeRawData(NAME.constData(), NAME.size());
+    out << (qint8)'i' << (quint32)values.size();
+    out << (quint32)(compressed ? FBX_PROPERTY_COMPRESSED_FLAG : FBX_PROPERTY_UNCOMPRESSED_FLAG) << (quint32)arrayData.size();
+    out.writeRawData(arrayData.constData(), arrayData.size());
+
+    // the null record that ends the top level
+    const int NULL_RECORD_BYTES = 13;
+    out.writeRawData(QByteArray(NULL_RECORD_BYTES, 0).constData(), NULL_RECORD_BYTES);
+    return fbx;
+}
+
+static QVector<qint32> makeIndices() {
+    QVector<qint32> values;
+    for (int i = 0; i < 1000; i++) {
+        values.append((i * 7) % 1013);
+    }
+    return values;
+}
+
+void FBXReaderTests::parseMatchesLegacy_data() {
+    QTest::addColumn<QString>("path");
+
+    QTest::newRow("mesh") << "shapes/assets/create/cube.fbx";
+    QTest::newRow("animation") << "clap/animations/Clap_left.fbx";
+    QTest::newRow("textured") << "shortbow/bow/models/bow-deadly.fbx";
+    // 2016 files, with 64 bit offsets and draco meshes
+    QTest::newRow("baked") << "shortbow/bow/models/bow-deadly.baked.fbx";
+    QTest::newRow("baked button") << "shortbow/models/shortbow-button.baked.fbx";
+}
+
+void FBXReaderTests::parseMatchesLegacy() {
+    QFETCH(QString, path);
+    QString filename = getModelPath(path);
+
+    QFile file(filename);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    FBXNode expected = legacy::parseFBX(&file);
+    QVERIFY(!expected.children.isEmpty());
+
+    QVERIFY(file.seek(0));
+    compareNodes(FBXReader::parseFBX(&file), expected);
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+
+    // and the geometry readFBX makes, with the nodes it doesn't look at skipped, is what it made from the legacy tree
+    FBXReader legacyReader;
+    legacyReader._rootNode = expected;
+    std::unique_ptr<FBXGeometry> expectedGeometry(legacyReader.extractFBXGeometry(QVariantHash(), filename));
+
+    QVERIFY(file.seek(0));
+    std::unique_ptr<FBXGeometry> geometry(readFBX(&file, QVariantHash(), filename));
+
+    QCOMPARE(geometry->joints.size(), expectedGeometry->joints.size());
+    QCOMPARE(geometry->animationFrames.size(), expectedGeometry->animationFrames.size());
+    QCOMPARE(geometry->meshes.size(), expectedGeometry->meshes.size());
+    for (int i = 0; i < expectedGeometry->meshes.size(); i++) {
+        const FBXMesh& mesh = geometry->meshes.at(i);
+        const FBXMesh& expectedMesh = expectedGeometry->meshes.at(i);
+        QCOMPARE(mesh.vertices, expectedMesh.vertices);
+        QCOMPARE(mesh.texCoords, expectedMesh.texCoords);
+        QCOMPARE(mesh.parts.size(), expectedMesh.parts.size());
+        for (int j = 0; j < expectedMesh.parts.size(); j++) {
+            QCOMPARE(mesh.parts.at(j).triangleIndices, expectedMesh.parts.at(j).triangleIndices);
+            QCOMPARE(mesh.parts.at(j).quadIndices, expectedMesh.parts.at(j).quadIndices);
+        }
+    }
+}
+
+void FBXReaderTests::startOffset() {
+    QFile file(getModelPath("shapes/assets/create/cube.fbx"));
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QByteArray data = file.readAll();
+    QBuffer legacyBuffer(&data);
+    QVERIFY(legacyBuffer.open(QIODevice::ReadOnly));
+    FBXNode expected = legacy::parseFBX(&legacyBuffer);
+
+    // a model that doesn't start at the beginning of the device still counts its offsets from its own start
+    const QByteArray PREFIX = "not part of the model";
+    QByteArray prefixed = PREFIX + data;
+
+    QBuffer buffer(&prefixed);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    QVERIFY(buffer.seek(PREFIX.size()));
+    compareNodes(FBXReader::parseFBX(&buffer), expected);
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+    QVERIFY(buffer.atEnd());
+
+    // the same from a mapped file
+    QTemporaryFile prefixedFile;
+    QVERIFY(prefixedFile.open());
+    QCOMPARE(prefixedFile.write(prefixed), (qint64)prefixed.size());
+    QVERIFY(prefixedFile.flush());
+    QVERIFY(prefixedFile.seek(PREFIX.size()));
+    compareNodes(FBXReader::parseFBX(&prefixedFile), expected);
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+    QVERIFY(prefixedFile.atEnd());
+}
+
+void FBXReaderTests::decodedArrays() {
+    QVector<qint32> values = makeIndices();
+    for (bool compressed : { false, true }) {
+        FBXNode root = FBXReader::parseFBX(makeIndicesFBX(values, compressed));
+        QCOMPARE(root.children.size(), 1);
+        FBXNode node = root.children.at(0);
+        QCOMPARE(node.name, QByteArray("Indices"));
+        QCOMPARE(FBXReader::getIntVector(node), values);
+
+        // later reads, through copies of the node too, share what the first one decoded
+        FBXNode copy = node;
+        QCOMPARE(FBXReader::getIntVector(copy).constData(), FBXReader::getIntVector(node).constData());
+    }
+}
+
+void FBXReaderTests::emptyArray() {
+    FBXNode root = FBXReader::parseFBX(makeIndicesFBX(QVector<qint32>(), false));
+    QCOMPARE(root.children.size(), 1);
+    QVERIFY(FBXReader::getIntVector(root.children.at(0)).isEmpty());
+}
+
+void FBXReaderTests::corruptArray() {
+    // arrays are only located while parsing, the corruption turns up when it's read
+    FBXNode root = FBXReader::parseFBX(makeIndicesFBX(makeIndices(), true, true));
+    QCOMPARE(root.children.size(), 1);
+    QVERIFY_EXCEPTION_THROWN(FBXReader::getIntVector(root.children.at(0)), QString);
+
+    // and again, nothing was kept from the failed read
+    QVERIFY_EXCEPTION_THROWN(FBXReader::getIntVector(root.children.at(0)), QString);
+}
+
+void FBXReaderTests::invalidEndOffset() {
+    QByteArray fbx = makeIndicesFBX(makeIndices(), false);
+    const QSet<QByteArray> SKIPPED_NODES { "Indices" };
+    FBXNode root = FBXReader::parseFBX(fbx, SKIPPED_NODES);
+    QVERIFY(root.children.isEmpty());
+
+    // the node's end, read from the file, inside its header, at the last byte of its name, and past the end of the file
+    // (ends before the lowest valid offset are taken for the null record that ends the file)
+    const int NODE_START = FBX_HEADER_BYTES_BEFORE_VERSION + sizeof(quint32);
+    const int NAME_END = NODE_START + 3 * sizeof(quint32) + sizeof(quint8) + (int)strlen("Indices");
+    for (quint32 endOffset : { 40u, (quint32)NAME_END - 1, (quint32)fbx.size() + 1 }) {
+        QByteArray corrupt = fbx;
+        qToLittleEndian(endOffset, (uchar*)corrupt.data() + NODE_START);
+        QVERIFY_EXCEPTION_THROWN(FBXReader::parseFBX(corrupt, SKIPPED_NODES), QString);
+        QVERIFY_EXCEPTION_THROWN(FBXReader::parseFBX(corrupt), QString);
+    }
+}
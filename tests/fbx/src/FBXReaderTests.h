@@ -0,0 +1,28 @@
+//
+//  FBXReaderTests.h
+//  tests/fbx/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_FBXReaderTests_h
+#define hifi_FBXReaderTests_h
+
+#include <QtTest/QtTest>
+
+class FBXReaderTests : public QObject {
+    Q_OBJECT
+private slots:
+    void parseMatchesLegacy_data();
+    void parseMatchesLegacy();
+    void startOffset();
+    void decodedArrays();
+    void emptyArray();
+    void corruptArray();
+    void invalidEndOffset();
+};
+
+#endif // hifi_FBXReaderTests_h
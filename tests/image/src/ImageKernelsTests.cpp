@@ -0,0 +1,172 @@
+//
+//  ImageKernelsTests.cpp
+//  tests/image/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ImageKernelsTests.h"
+
+#include <random>
+
+#include <glm/gtc/epsilon.hpp>
+#include <glm/gtc/packing.hpp>
+
+#include <image/ImageKernels.h>
+
+QTEST_GUILESS_MAIN(ImageKernelsTests)
+
+using namespace image;
+
+static glm::vec3 clampToR11G11B10(const glm::vec3& color) {
+    glm::vec3 result;
+    for (int i = 0; i < 3; ++i) {
+        result[i] = (color[i] < 6.10e-5f) ? 0.0f : std::min(color[i], 6.50e4f);
+    }
+    return result;
+}
+
+void ImageKernelsTests::hdrPacking() {
+    std::mt19937 generator(1);
+    std::uniform_real_distribution<float> exponent(-6.0f, 6.0f);
+    // not a multiple of the SIMD width, so the tail gets tested too
+    const size_t NUM_PIXELS = 1003;
+    std::vector<float> rgb(3 * NUM_PIXELS);
+    for (size_t i = 0; i < rgb.size(); ++i) {
+        rgb[i] = (i % 17 == 0) ? 0.0f : powf(10.0f, exponent(generator)) * ((i % 13 == 0) ? -1.0f : 1.0f);
+    }
+
+    std::vector<uint32_t> packed(NUM_PIXELS);
+    packHDRPixels(rgb.data(), packed.data(), NUM_PIXELS, gpu::Element::COLOR_R11G11B10);
+    for (size_t i = 0; i < NUM_PIXELS; ++i) {
+        glm::vec3 color(rgb[3 * i], rgb[3 * i + 1], rgb[3 * i + 2]);
+        QCOMPARE(packed[i], glm::packF2x11_1x10(clampToR11G11B10(color)));
+    }
+
+    std::vector<QRgb> pixels(NUM_PIXELS);
+    for (auto& pixel : pixels) {
+        pixel = generator();
+    }
+    convertARGB32ToHDR(pixels.data(), packed.data(), NUM_PIXELS, gpu::Element::COLOR_R11G11B10);
+    for (size_t i = 0; i < NUM_PIXELS; ++i) {
+        glm::vec3 color = glm::pow(glm::vec3(qRed(pixels[i]), qGreen(pixels[i]), qBlue(pixels[i])) / 255.0f, glm::vec3(2.2f));
+        QCOMPARE(packed[i], glm::packF2x11_1x10(clampToR11G11B10(color)));
+    }
+}
+
+void ImageKernelsTests::hdrUnpacking() {
+    // every finite value of every channel
+    std::vector<uint32_t> packed;
+    for (uint32_t value = 0; value < 2048; ++value) {
+        if ((value & 0x7C0) != 0x7C0 && (value & 0x3E0) != 0x3E0) {
+            packed.push_back(value | (value << 11) | ((value & 0x3FF) << 22));
+        }
+    }
+    std::vector<glm::vec4> unpacked(packed.size());
+    unpackHDRPixels(packed.data(), unpacked.data(), packed.size(), gpu::Element::COLOR_R11G11B10);
+    for (size_t i = 0; i < packed.size(); ++i) {
+        QCOMPARE(unpacked[i], glm::vec4(glm::unpackF2x11_1x10(packed[i]), 1.0f));
+    }
+}
+
+void ImageKernelsTests::resizeIdentity() {
+    std::mt19937 generator(2);
+    for (auto colorSpace : { ColorSpace::LINEAR, ColorSpace::GAMMA }) {
+        QImage image(37, 29, QImage::Format_ARGB32);
+        for (int y = 0; y < image.height(); ++y) {
+            QRgb* line = reinterpret_cast<QRgb*>(image.scanLine(y));
+            for (int x = 0; x < image.width(); ++x) {
+                line[x] = generator() | 0xFF000000;
+            }
+        }
+        QImage resized = resizeImage(image, image.width(), image.height(), colorSpace);
+        for (int y = 0; y < image.height(); ++y) {
+            for (int x = 0; x < image.width(); ++x) {
+                QRgb expected = image.pixel(x, y);
+                QRgb actual = resized.pixel(x, y);
+                QVERIFY(abs(qRed(expected) - qRed(actual)) <= 1);
+                QVERIFY(abs(qGreen(expected) - qGreen(actual)) <= 1);
+                QVERIFY(abs(qBlue(expected) - qBlue(actual)) <= 1);
+                QCOMPARE(qAlpha(actual), qAlpha(expected));
+            }
+        }
+    }
+}
+
+void ImageKernelsTests::resizeConstantColor() {
+    QImage image(300, 200, QImage::Format_RGB32);
+    image.fill(qRgb(200, 100, 30));
+    for (auto size : { QSize(128, 128), QSize(512, 384), QSize(1, 1) }) {
+        QImage resized = resizeImage(image, size.width(), size.height(), ColorSpace::GAMMA);
+        QCOMPARE(resized.size(), size);
+        QCOMPARE(resized.format(), QImage::Format_RGB32);
+        for (int y = 0; y < size.height(); ++y) {
+            for (int x = 0; x < size.width(); ++x) {
+                QRgb pixel = resized.pixel(x, y);
+                QVERIFY(abs(qRed(pixel) - 200) <= 1);
+                QVERIFY(abs(qGreen(pixel) - 100) <= 1);
+                QVERIFY(abs(qBlue(pixel) - 30) <= 1);
+            }
+        }
+    }
+}
+
+void ImageKernelsTests::resizeNormalMap() {
+    QImage image(64, 64, QImage::Format_RGB32);
+    for (int y = 0; y < image.height(); ++y) {
+        for (int x = 0; x < image.width(); ++x) {
+            glm::vec3 normal = glm::normalize(glm::vec3(0.5f * sinf(0.1f * x), 0.5f * cosf(0.07f * y), 0.7f));
+            glm::ivec3 encoded = glm::ivec3(normal * 127.5f + 128.0f);
+            image.setPixel(x, y, qRgb(encoded.x, encoded.y, encoded.z));
+        }
+    }
+
+    QImage resized = resizeImage(image, 24, 40, ColorSpace::NORMAL_MAP);
+    for (int y = 0; y < resized.height(); ++y) {
+        for (int x = 0; x < resized.width(); ++x) {
+            QRgb pixel = resized.pixel(x, y);
+            glm::vec3 normal = glm::vec3(qRed(pixel), qGreen(pixel), qBlue(pixel)) / 127.5f - 1.0f;
+            QVERIFY(fabsf(glm::length(normal) - 1.0f) < 0.02f);
+        }
+    }
+}
+
+void ImageKernelsTests::downsample() {
+    FloatImage even;
+    even.width = 4;
+    even.height = 2;
+    for (int i = 0; i < 8; ++i) {
+        even.pixels.push_back(glm::vec4((float)i));
+    }
+    FloatImage half = downsampleImage(even, ColorSpace::LINEAR);
+    QCOMPARE(half.width, 2);
+    QCOMPARE(half.height, 1);
+    QCOMPARE(half.pixels[0], glm::vec4(2.5f));
+    QCOMPARE(half.pixels[1], glm::vec4(4.5f));
+
+    FloatImage odd;
+    odd.width = 3;
+    odd.height = 3;
+    for (int i = 0; i < 9; ++i) {
+        odd.pixels.push_back(glm::vec4((float)i));
+    }
+    FloatImage center = downsampleImage(odd, ColorSpace::LINEAR);
+    QCOMPARE(center.width, 1);
+    QCOMPARE(center.height, 1);
+    QVERIFY(glm::all(glm::epsilonEqual(center.pixels[0], glm::vec4(4.0f), 1e-5f)));
+
+    FloatImage column;
+    column.width = 1;
+    column.height = 4;
+    for (int i = 0; i < 4; ++i) {
+        column.pixels.push_back(glm::vec4((float)i));
+    }
+    FloatImage shorter = downsampleImage(column, ColorSpace::LINEAR);
+    QCOMPARE(shorter.width, 1);
+    QCOMPARE(shorter.height, 2);
+    QCOMPARE(shorter.pixels[0], glm::vec4(0.5f));
+    QCOMPARE(shorter.pixels[1], glm::vec4(2.5f));
+}
@@ -0,0 +1,27 @@
+//
+//  ImageKernelsTests.h
+//  tests/image/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ImageKernelsTests_h
+#define hifi_ImageKernelsTests_h
+
+#include <QtTest/QtTest>
+
+class ImageKernelsTests : public QObject {
+    Q_OBJECT
+private slots:
+    void hdrPacking();
+    void hdrUnpacking();
+    void resizeIdentity();
+    void resizeConstantColor();
+    void resizeNormalMap();
+    void downsample();
+};
+
+#endif // hifi_ImageKernelsTests_h
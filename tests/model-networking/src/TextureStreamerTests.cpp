@@ -0,0 +1,174 @@
+//
+//  TextureStreamerTests.cpp
+//  tests/model-networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "TextureStreamerTests.h"
+
+#include <limits>
+
+#include <ktx/KTX.h>
+#include <NumericalConstants.h>
+#include <model-networking/TextureStreamer.h>
+
+QTEST_GUILESS_MAIN(TextureStreamerTests)
+
+static const uint32_t TEXTURE_SIZE = 1024;
+static const uint16_t NUM_MIPS = 11;
+static const size_t UNLIMITED = std::numeric_limits<size_t>::max();
+
+static ktx::KTXDescriptor createDescriptor() {
+    ktx::Header header;
+    header.setUncompressed(ktx::GLType::UNSIGNED_BYTE, 1, ktx::GLFormat::RGBA, ktx::GLInternalFormat::RGBA8, ktx::GLBaseInternalFormat::RGBA);
+    header.set2D(TEXTURE_SIZE, TEXTURE_SIZE);
+    header.numberOfMipmapLevels = NUM_MIPS;
+    return ktx::KTXDescriptor(header, ktx::KeyValues(), header.generateImageDescriptors());
+}
+
+static size_t evalRequestSize(const ktx::KTXDescriptor& descriptor, uint16_t low, uint16_t high) {
+    size_t size = 0;
+    for (uint16_t level = low; level <= high; ++level) {
+        size += descriptor.images[level]._imageSize + ktx::IMAGE_SIZE_WIDTH;
+    }
+    return size;
+}
+
+static TextureStreamer::TextureState createState(const ktx::KTXDescriptor& descriptor, uint16_t populatedMip,
+                                                 bool hasUsage, float screenSize) {
+    TextureStreamer::TextureState state;
+    state.descriptor = &descriptor;
+    state.width = TEXTURE_SIZE;
+    state.height = TEXTURE_SIZE;
+    state.populatedMip = populatedMip;
+    state.lowestRequestedMip = 0;
+    state.hasUsage = hasUsage;
+    state.screenSize = screenSize;
+    return state;
+}
+
+// 64 pixels drawn at 512, 256 pixels drawn at 1024, not reported, off screen, 64 pixels drawn at 64
+static std::vector<TextureStreamer::TextureState> createStates(const ktx::KTXDescriptor& descriptor) {
+    return {
+        createState(descriptor, 4, true, 512.0f),
+        createState(descriptor, 2, true, 1024.0f),
+        createState(descriptor, 3, false, 0.0f),
+        createState(descriptor, 4, true, 0.0f),
+        createState(descriptor, 4, true, 64.0f)
+    };
+}
+
+void TextureStreamerTests::rankingTest() {
+    auto descriptor = createDescriptor();
+    auto states = createStates(descriptor);
+
+    auto requests = TextureStreamer::rankRequests(states, 0, 0, UNLIMITED, UNLIMITED);
+    QCOMPARE(requests.size(), (size_t)4);
+    QCOMPARE(requests[0].texture, (size_t)0);
+    QCOMPARE(requests[1].texture, (size_t)1);
+    QCOMPARE(requests[2].texture, (size_t)4);
+    QCOMPARE(requests[3].texture, (size_t)2);
+
+    // how magnified the populated level is, only the magnified textures get a priority
+    QCOMPARE(requests[0].priority, 8.0f);
+    QCOMPARE(requests[1].priority, 4.0f);
+    QCOMPARE(requests[2].priority, 0.0f);
+    QCOMPARE(requests[3].priority, 0.0f);
+
+    // magnified textures stop at the level matching their size on screen, the rest at their lowest requested level
+    QVERIFY(requests[0].low >= 1);
+    QCOMPARE(requests[0].high, (uint16_t)3);
+    QCOMPARE(requests[2].high, (uint16_t)3);
+}
+
+void TextureStreamerTests::memoryBudgetTest() {
+    auto descriptor = createDescriptor();
+    auto states = createStates(descriptor);
+
+    // over budget, only what's magnified on screen
+    auto requests = TextureStreamer::rankRequests(states, 0, MB_TO_BYTES(100), UNLIMITED, MB_TO_BYTES(100));
+    QCOMPARE(requests.size(), (size_t)2);
+    QCOMPARE(requests[0].texture, (size_t)0);
+    QCOMPARE(requests[1].texture, (size_t)1);
+
+    // under budget, the texture drawn at its resolution goes on, the next one waits for room
+    requests = TextureStreamer::rankRequests({ states[2], states[4] }, 0, 0, UNLIMITED, 1);
+    QCOMPARE(requests.size(), (size_t)1);
+    QCOMPARE(requests[0].texture, (size_t)1);
+    QCOMPARE(requests[0].high, (uint16_t)3);
+}
+
+void TextureStreamerTests::bytesInFlightTest() {
+    auto descriptor = createDescriptor();
+    auto states = createStates(descriptor);
+    const size_t MAX_BYTES_IN_FLIGHT = evalRequestSize(descriptor, 3, 3) + 1;
+
+    // the first level fits, batching the next one or starting another texture doesn't
+    auto requests = TextureStreamer::rankRequests(states, 0, 0, MAX_BYTES_IN_FLIGHT, UNLIMITED);
+    QCOMPARE(requests.size(), (size_t)1);
+    QCOMPARE(requests[0].texture, (size_t)0);
+    QCOMPARE(requests[0].low, (uint16_t)3);
+    QCOMPARE(requests[0].high, (uint16_t)3);
+    QCOMPARE(requests[0].bytes, evalRequestSize(descriptor, 3, 3));
+
+    // nothing starts once the cap would be crossed
+    requests = TextureStreamer::rankRequests(states, 2, 0, MAX_BYTES_IN_FLIGHT, UNLIMITED);
+    QVERIFY(requests.empty());
+
+    // a level bigger than the cap still goes when nothing else is in flight
+    requests = TextureStreamer::rankRequests({ states[1] }, 0, 0, 1, UNLIMITED);
+    QCOMPARE(requests.size(), (size_t)1);
+    QCOMPARE(requests[0].bytes, evalRequestSize(descriptor, 1, 1));
+}
+
+void TextureStreamerTests::batchingTest() {
+    auto descriptor = createDescriptor();
+    std::vector<TextureStreamer::TextureState> states { createState(descriptor, NUM_MIPS - 1, false, 0.0f) };
+
+    auto requests = TextureStreamer::rankRequests(states, 0, 0, UNLIMITED, UNLIMITED);
+    QCOMPARE(requests.size(), (size_t)1);
+
+    // as many levels as fit in one batch
+    const auto& request = requests[0];
+    QCOMPARE(request.high, (uint16_t)(NUM_MIPS - 2));
+    QCOMPARE(request.bytes, evalRequestSize(descriptor, request.low, request.high));
+    QVERIFY(request.bytes <= TextureStreamer::MAX_BATCH_BYTES);
+    QVERIFY(request.low > 0);
+    QVERIFY(request.bytes + evalRequestSize(descriptor, request.low - 1, request.low - 1) > TextureStreamer::MAX_BATCH_BYTES);
+}
+
+void TextureStreamerTests::mipRangeTest() {
+    auto descriptor = createDescriptor();
+    const uint16_t LOW = 2;
+    const uint16_t HIGH = 5;
+
+    // the image region of the file, each level's image filled with its level number
+    QByteArray images;
+    for (uint16_t level = 0; level < NUM_MIPS; ++level) {
+        QCOMPARE((size_t)images.size(), descriptor.images[level]._imageOffset);
+        images.append(QByteArray(ktx::IMAGE_SIZE_WIDTH, (char)0xff));
+        images.append(QByteArray(descriptor.images[level]._imageSize, (char)level));
+    }
+
+    auto range = TextureStreamer::evalMipRangeBytes(descriptor, LOW, HIGH);
+    auto imagesStart = ktx::KTX_HEADER_SIZE + descriptor.header.bytesOfKeyValueData;
+    QCOMPARE((size_t)range.size(), evalRequestSize(descriptor, LOW, HIGH) - ktx::IMAGE_SIZE_WIDTH);
+    auto data = images.mid((int)(range.fromInclusive - imagesStart), (int)range.size());
+
+    auto levels = TextureStreamer::splitMipRange(descriptor, LOW, HIGH, data.size());
+    QCOMPARE(levels.size(), (size_t)(HIGH - LOW + 1));
+    for (size_t i = 0; i < levels.size(); ++i) {
+        auto level = levels[i].first;
+        QCOMPARE(level, (uint16_t)(HIGH - i));
+        auto image = data.mid((int)levels[i].second, descriptor.images[level]._imageSize);
+        QCOMPARE(image, QByteArray(descriptor.images[level]._imageSize, (char)level));
+    }
+
+    // the smallest level is at the end, without it none of the others can be used
+    levels = TextureStreamer::splitMipRange(descriptor, LOW, HIGH, data.size() - 1);
+    QVERIFY(levels.empty());
+}
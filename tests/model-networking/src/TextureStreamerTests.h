@@ -0,0 +1,35 @@
+//
+//  TextureStreamerTests.h
+//  tests/model-networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_TextureStreamerTests_h
+#define hifi_TextureStreamerTests_h
+
+#include <QtTest/QtTest>
+
+class TextureStreamerTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that magnified textures go first, then the rest by size on screen, and off screen ones not at all
+    void rankingTest();
+
+    // Test that textures with the resolution they're drawn at keep streaming only while under the memory budget
+    void memoryBudgetTest();
+
+    // Test that requests stop at the cap on bytes in flight
+    void bytesInFlightTest();
+
+    // Test that small consecutive levels are fetched with one request
+    void batchingTest();
+
+    // Test where the levels of a ranged request are found in its data
+    void mipRangeTest();
+};
+
+#endif // hifi_TextureStreamerTests_h
@@ -0,0 +1,155 @@
+//
+//  AssetRequestTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AssetRequestTests.h"
+
+#include <QtCore/QLockFile>
+
+#include <AssetClient.h>
+#include <AssetRequest.h>
+#include <DependencyManager.h>
+#include <LimitedNodeList.h>
+#include <NodeList.h>
+#include <StatTracker.h>
+#include <shared/GlobalAppProperties.h>
+
+QTEST_GUILESS_MAIN(AssetRequestTests)
+
+static const int NUM_CHUNKS = 3;
+
+static QByteArray makeAsset() {
+    // the last chunk is a partial one
+    QByteArray data;
+    data.reserve(ASSET_DOWNLOAD_CHUNK_SIZE * NUM_CHUNKS);
+    for (int i = 0; data.size() < ASSET_DOWNLOAD_CHUNK_SIZE * (NUM_CHUNKS - 1) + ASSET_DOWNLOAD_CHUNK_SIZE / 2; ++i) {
+        data.append((char)(i * 31 + (i >> 8)));
+    }
+    return data;
+}
+
+static void writePartialDownload(const QString& path, const QByteArray& data, const QByteArray& receivedFlags) {
+    QFile partialFile(path);
+    QVERIFY(partialFile.open(QIODevice::WriteOnly));
+    partialFile.write(data);
+
+    QFile chunksFile(path + ".chunks");
+    QVERIFY(chunksFile.open(QIODevice::WriteOnly));
+    chunksFile.write(receivedFlags);
+}
+
+void AssetRequestTests::initTestCase() {
+    QVERIFY(_testDir.isValid());
+
+    // the asset client keeps its partial downloads next to the local data path, and there is no asset server to talk to
+    qApp->setProperty(hifi::properties::APP_LOCAL_DATA_PATH, _testDir.filePath("cache"));
+    DependencyManager::set<StatTracker>();
+    DependencyManager::registerInheritance<LimitedNodeList, NodeList>();
+    DependencyManager::set<NodeList>(NodeType::Agent, INVALID_PORT);
+    DependencyManager::set<AssetClient>();
+}
+
+void AssetRequestTests::fullyResumedTest() {
+    QByteArray data = makeAsset();
+    QString hash = QString(AssetUtils::hashData(data).toHex());
+    QString partialPath = DependencyManager::get<AssetClient>()->getPartialDownloadPath(hash);
+    QVERIFY(!partialPath.isEmpty());
+    // out of the disk cache's reach
+    QVERIFY(!partialPath.startsWith(_testDir.filePath("cache") + "/"));
+    writePartialDownload(partialPath, data, QByteArray(NUM_CHUNKS, 1));
+
+    AssetRequest request(hash);
+    QSignalSpy finishedSpy(&request, &AssetRequest::finished);
+    request._state = AssetRequest::WaitingForData;
+    request.requestChunks(data.size(), data.left(ASSET_DOWNLOAD_CHUNK_SIZE));
+
+    // nothing to request, the request finishes from what is on disk
+    QCOMPARE(finishedSpy.count(), 1);
+    QCOMPARE(request.getState(), AssetRequest::Finished);
+    QCOMPARE(request.getError(), AssetRequest::NoError);
+    QCOMPARE(request.getNumResumedChunks(), NUM_CHUNKS);
+    QVERIFY(request.getData() == data);
+
+    QVERIFY(!QFile::exists(partialPath));
+    QVERIFY(!QFile::exists(partialPath + ".chunks"));
+    QVERIFY(!QFile::exists(partialPath + ".lock"));
+}
+
+void AssetRequestTests::lockedPartialDownloadTest() {
+    QByteArray data = makeAsset();
+    QString hash = QString(AssetUtils::hashData(data).toHex());
+    QString partialPath = DependencyManager::get<AssetClient>()->getPartialDownloadPath(hash);
+    writePartialDownload(partialPath, data, QByteArray(NUM_CHUNKS, 1));
+
+    {
+        // as if another request for the same asset was downloading it
+        QLockFile lock(partialPath + ".lock");
+        QVERIFY(lock.tryLock(0));
+
+        AssetRequest request(hash);
+        request._state = AssetRequest::WaitingForData;
+        request.requestChunks(data.size(), data.left(ASSET_DOWNLOAD_CHUNK_SIZE));
+
+        // without the partial download it needs the asset server, which isn't there
+        QCOMPARE(request.getState(), AssetRequest::Finished);
+        QCOMPARE(request.getError(), AssetRequest::NetworkError);
+        QCOMPARE(request.getNumResumedChunks(), 0);
+
+        // and it left the other request's files alone
+        QFile partialFile(partialPath);
+        QVERIFY(partialFile.open(QIODevice::ReadOnly));
+        QVERIFY(partialFile.readAll() == data);
+    }
+
+    AssetRequest request(hash);
+    request._state = AssetRequest::WaitingForData;
+    request.requestChunks(data.size(), data.left(ASSET_DOWNLOAD_CHUNK_SIZE));
+    QCOMPARE(request.getError(), AssetRequest::NoError);
+    QCOMPARE(request.getNumResumedChunks(), NUM_CHUNKS);
+}
+
+void AssetRequestTests::firstChunkTest() {
+    QByteArray data = makeAsset();
+    QString hash = QString(AssetUtils::hashData(data).toHex());
+    QString partialPath = DependencyManager::get<AssetClient>()->getPartialDownloadPath(hash);
+
+    // everything but the first chunk was downloaded before, the reply that gave the size finishes it
+    QByteArray receivedFlags(NUM_CHUNKS, 1);
+    receivedFlags[0] = 0;
+    writePartialDownload(partialPath, data, receivedFlags);
+
+    AssetRequest request(hash);
+    request._state = AssetRequest::WaitingForData;
+    request.requestChunks(data.size(), data.left(ASSET_DOWNLOAD_CHUNK_SIZE));
+    QCOMPARE(request.getState(), AssetRequest::Finished);
+    QCOMPARE(request.getError(), AssetRequest::NoError);
+    QCOMPARE(request.getNumResumedChunks(), NUM_CHUNKS - 1);
+    QVERIFY(request.getData() == data);
+    QVERIFY(!QFile::exists(partialPath));
+}
+
+void AssetRequestTests::corruptPartialDownloadTest() {
+    QByteArray data = makeAsset();
+    QString hash = QString(AssetUtils::hashData(data).toHex());
+    QString partialPath = DependencyManager::get<AssetClient>()->getPartialDownloadPath(hash);
+
+    // a chunk flagged as complete with the wrong bytes in it
+    QByteArray corrupt = data;
+    corrupt[ASSET_DOWNLOAD_CHUNK_SIZE + 1] = ~corrupt[ASSET_DOWNLOAD_CHUNK_SIZE + 1];
+    writePartialDownload(partialPath, corrupt, QByteArray(NUM_CHUNKS, 1));
+
+    // the assembled asset has to match its hash before it is kept, and the partial download goes
+    AssetRequest request(hash);
+    request._state = AssetRequest::WaitingForData;
+    request.requestChunks(data.size(), data.left(ASSET_DOWNLOAD_CHUNK_SIZE));
+    QCOMPARE(request.getError(), AssetRequest::HashVerificationFailed);
+    QVERIFY(request.getData().isEmpty());
+    QVERIFY(!QFile::exists(partialPath));
+    QVERIFY(AssetUtils::loadFromCache(request.getUrl()).isEmpty());
+}
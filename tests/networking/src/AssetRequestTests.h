@@ -0,0 +1,30 @@
+//
+//  AssetRequestTests.h
+//  tests/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AssetRequestTests_h
+#define hifi_AssetRequestTests_h
+
+#include <QtTest/QtTest>
+#include <QtCore/QTemporaryDir>
+
+class AssetRequestTests : public QObject {
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void fullyResumedTest();
+    void lockedPartialDownloadTest();
+    void firstChunkTest();
+    void corruptPartialDownloadTest();
+
+private:
+    QTemporaryDir _testDir;
+};
+
+#endif // hifi_AssetRequestTests_h
@@ -0,0 +1,172 @@
+//
+//  ContentCacheTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ContentCacheTests.h"
+
+#include <ContentCache.h>
+#include <ContentDiskCache.h>
+
+QTEST_GUILESS_MAIN(ContentCacheTests)
+
+static const QByteArray TEST_DATA { 1024 * 64, 'x' };
+
+static ContentCachePointer makeContentCache(const QString& location) {
+    auto result = std::make_shared<ContentCache>(location.toStdString());
+    result->initialize();
+    return result;
+}
+
+class TestDiskCache : public ContentDiskCache {
+public:
+    TestDiskCache(const QString& location, const ContentCachePointer& contentCache) : _contentCache(contentCache) {
+        setCacheDirectory(location);
+    }
+
+    ContentCachePointer _contentCache;
+
+protected:
+    ContentCachePointer getContentCache() const override { return _contentCache; }
+};
+
+static void insertResponse(QNetworkDiskCache& cache, const QUrl& url, const QByteArray& data) {
+    QNetworkCacheMetaData metaData;
+    metaData.setUrl(url);
+    metaData.setSaveToDisk(true);
+    auto device = cache.prepare(metaData);
+    QVERIFY(device);
+    device->write(data);
+    cache.insert(device);
+}
+
+static QByteArray readResponse(QNetworkDiskCache& cache, const QUrl& url) {
+    std::unique_ptr<QIODevice> device { cache.data(url) };
+    return device ? device->readAll() : QByteArray();
+}
+
+void ContentCacheTests::readWriteTest() {
+    auto cache = makeContentCache(_testDir.path() + "/readWrite");
+
+    auto hash = cache->write(TEST_DATA);
+    QCOMPARE(hash, ContentCache::hashContent(TEST_DATA));
+    QVERIFY(cache->contains(hash));
+    QCOMPARE(cache->getBytesWritten(), (quint64)TEST_DATA.size());
+
+    // hashes are case-insensitive, as they are in ATP URLs
+    QCOMPARE(cache->read(hash.toUpper()), TEST_DATA);
+    QCOMPARE(cache->getHits(), (quint64)1);
+    QCOMPARE(cache->getBytesRead(), (quint64)TEST_DATA.size());
+}
+
+void ContentCacheTests::deduplicationTest() {
+    auto cache = makeContentCache(_testDir.path() + "/dedup");
+
+    auto hash = cache->write(TEST_DATA);
+    QCOMPARE(cache->write(TEST_DATA), hash);
+    QVERIFY(cache->write(hash, TEST_DATA));
+
+    QCOMPARE(cache->getNumTotalFiles(), (size_t)1);
+    QCOMPARE(cache->getSizeTotalFiles(), (size_t)TEST_DATA.size());
+    QCOMPARE(cache->getBytesWritten(), (quint64)TEST_DATA.size());
+    QCOMPARE(cache->getBytesDeduplicated(), (quint64)(2 * TEST_DATA.size()));
+}
+
+void ContentCacheTests::missTest() {
+    auto cache = makeContentCache(_testDir.path() + "/miss");
+
+    QVERIFY(cache->read(ContentCache::hashContent(TEST_DATA)).isEmpty());
+    QCOMPARE(cache->getMisses(), (quint64)1);
+    QCOMPARE(cache->getHits(), (quint64)0);
+
+    QVERIFY(cache->write(QByteArray()).isEmpty());
+    QCOMPARE(cache->getNumTotalFiles(), (size_t)0);
+}
+
+void ContentCacheTests::mappedReadTest() {
+    auto cache = makeContentCache(_testDir.path() + "/mapped");
+    auto hash = cache->write(TEST_DATA);
+
+    auto device = cache->open(hash);
+    QVERIFY(device);
+    QCOMPARE(device->size(), (qint64)TEST_DATA.size());
+
+    // an open mapping pins the content
+    cache->wipe();
+    QVERIFY(cache->contains(hash));
+    QCOMPARE(device->readAll(), TEST_DATA);
+
+    device.reset();
+    cache->wipe();
+    QVERIFY(!cache->contains(hash));
+}
+
+void ContentCacheTests::diskCacheDeduplicationTest() {
+    auto contentCache = makeContentCache(_testDir.path() + "/diskDedup/content");
+    TestDiskCache cache(_testDir.path() + "/diskDedup/http", contentCache);
+
+    const QUrl FIRST_URL { "http://example.com/first.fbx" };
+    const QUrl SECOND_URL { "https://mirror.example.com/second.fbx" };
+    insertResponse(cache, FIRST_URL, TEST_DATA);
+    insertResponse(cache, SECOND_URL, TEST_DATA);
+
+    // both responses and the ATP asset with the same bytes share one copy
+    QCOMPARE(contentCache->getNumTotalFiles(), (size_t)1);
+    auto hash = ContentCache::hashContent(TEST_DATA);
+    QVERIFY(contentCache->write(hash, TEST_DATA));
+    QCOMPARE(contentCache->getNumTotalFiles(), (size_t)1);
+
+    QCOMPARE(cache.metaData(FIRST_URL).attributes().value(ContentDiskCache::CONTENT_HASH_ATTRIBUTE).toString(), hash);
+    QCOMPARE(readResponse(cache, FIRST_URL), TEST_DATA);
+    QCOMPARE(readResponse(cache, SECOND_URL), TEST_DATA);
+    QCOMPARE(contentCache->getHits(), (quint64)2);
+
+    // revalidating a response keeps its content
+    auto metaData = cache.metaData(FIRST_URL);
+    metaData.setAttributes(QNetworkCacheMetaData::AttributesMap());
+    metaData.setExpirationDate(QDateTime::currentDateTime().addDays(1));
+    cache.updateMetaData(metaData);
+    QCOMPARE(readResponse(cache, FIRST_URL), TEST_DATA);
+
+    // removing one entry leaves the shared content for the other
+    QVERIFY(cache.remove(FIRST_URL));
+    QVERIFY(readResponse(cache, FIRST_URL).isEmpty());
+    QCOMPARE(readResponse(cache, SECOND_URL), TEST_DATA);
+}
+
+void ContentCacheTests::diskCacheLegacyEntryTest() {
+    auto contentCache = makeContentCache(_testDir.path() + "/diskLegacy/content");
+    TestDiskCache cache(_testDir.path() + "/diskLegacy/http", ContentCachePointer());
+
+    const QUrl URL { "http://example.com/legacy.fbx" };
+    insertResponse(cache, URL, TEST_DATA);
+    QCOMPARE(contentCache->getNumTotalFiles(), (size_t)0);
+
+    // a body stored inline is moved into the content cache the first time it is read
+    cache._contentCache = contentCache;
+    QCOMPARE(readResponse(cache, URL), TEST_DATA);
+    auto hash = ContentCache::hashContent(TEST_DATA);
+    QVERIFY(contentCache->contains(hash));
+    QCOMPARE(cache.metaData(URL).attributes().value(ContentDiskCache::CONTENT_HASH_ATTRIBUTE).toString(), hash);
+
+    QCOMPARE(readResponse(cache, URL), TEST_DATA);
+    QCOMPARE(contentCache->getHits(), (quint64)1);
+}
+
+void ContentCacheTests::diskCacheEvictedContentTest() {
+    auto contentCache = makeContentCache(_testDir.path() + "/diskEvicted/content");
+    TestDiskCache cache(_testDir.path() + "/diskEvicted/http", contentCache);
+
+    const QUrl URL { "http://example.com/evicted.fbx" };
+    insertResponse(cache, URL, TEST_DATA);
+    contentCache->wipe();
+
+    // the stale entry is dropped so the response is fetched again
+    QVERIFY(!cache.data(URL));
+    QVERIFY(!cache.metaData(URL).isValid());
+}
@@ -0,0 +1,32 @@
+//
+//  ContentCacheTests.h
+//  tests/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ContentCacheTests_h
+#define hifi_ContentCacheTests_h
+
+#include <QtTest/QtTest>
+#include <QtCore/QTemporaryDir>
+
+class ContentCacheTests : public QObject {
+    Q_OBJECT
+private slots:
+    void readWriteTest();
+    void deduplicationTest();
+    void missTest();
+    void mappedReadTest();
+    void diskCacheDeduplicationTest();
+    void diskCacheLegacyEntryTest();
+    void diskCacheEvictedContentTest();
+
+private:
+    QTemporaryDir _testDir;
+};
+
+#endif // hifi_ContentCacheTests_h
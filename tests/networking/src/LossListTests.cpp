@@ -0,0 +1,253 @@
+//
+//  LossListTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "LossListTests.h"
+
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include <udt/ControlPacket.h>
+#include <udt/LossList.h>
+
+QTEST_GUILESS_MAIN(LossListTests)
+
+using namespace udt;
+
+using Ranges = std::vector<std::pair<int, int>>;
+
+static SequenceNumber seq(int value) {
+    return SequenceNumber((SequenceNumber::Type)value);
+}
+
+// The ranges of the list, as a loss report carries them
+static Ranges getRanges(LossList& lossList) {
+    Ranges ranges;
+    if (lossList.isEmpty()) {
+        return ranges;
+    }
+
+    auto packet = ControlPacket::create(ControlPacket::TimeoutNAK, lossList.getLength() * 2 * sizeof(SequenceNumber));
+    lossList.write(*packet);
+    packet->reset();
+    while (packet->bytesLeftToRead() >= (qint64)(2 * sizeof(SequenceNumber))) {
+        SequenceNumber first;
+        SequenceNumber second;
+        packet->readPrimitive(&first);
+        packet->readPrimitive(&second);
+        ranges.emplace_back((SequenceNumber::Type)first, (SequenceNumber::Type)second);
+    }
+    return ranges;
+}
+
+// Every sequence number in the list, in order
+static std::vector<int> getSequenceNumbers(LossList lossList) {
+    std::vector<int> sequenceNumbers;
+    while (!lossList.isEmpty()) {
+        sequenceNumbers.push_back((SequenceNumber::Type)lossList.popFirstSequenceNumber());
+    }
+    return sequenceNumbers;
+}
+
+void LossListTests::appendTest() {
+    LossList lossList;
+    QVERIFY(lossList.isEmpty());
+
+    // following sequence numbers grow the last range
+    lossList.append(seq(10));
+    lossList.append(seq(11));
+    lossList.append(seq(12), seq(15));
+    QCOMPARE(getRanges(lossList), Ranges({ { 10, 15 } }));
+
+    // the others start a new one
+    lossList.append(seq(20));
+    lossList.append(seq(30), seq(32));
+    QCOMPARE(getRanges(lossList), Ranges({ { 10, 15 }, { 20, 20 }, { 30, 32 } }));
+    QCOMPARE(lossList.getLength(), 10);
+    QCOMPARE((SequenceNumber::Type)lossList.getFirstSequenceNumber(), 10);
+
+    lossList.clear();
+    QVERIFY(lossList.isEmpty());
+    QCOMPARE(getRanges(lossList), Ranges());
+}
+
+void LossListTests::insertTest() {
+    LossList lossList;
+    lossList.append(seq(10), seq(12));
+    lossList.append(seq(20), seq(22));
+    lossList.append(seq(30), seq(32));
+    lossList.append(seq(40), seq(42));
+
+    // in a gap, and in front of everything
+    lossList.insert(seq(25), seq(26));
+    lossList.insert(seq(1), seq(2));
+    QCOMPARE(getRanges(lossList), Ranges({ { 1, 2 }, { 10, 12 }, { 20, 22 }, { 25, 26 }, { 30, 32 }, { 40, 42 } }));
+    QCOMPARE(lossList.getLength(), 16);
+
+    // overlapping the start of a range
+    lossList.insert(seq(8), seq(11));
+    QCOMPARE(getRanges(lossList), Ranges({ { 1, 2 }, { 8, 12 }, { 20, 22 }, { 25, 26 }, { 30, 32 }, { 40, 42 } }));
+    QCOMPARE(lossList.getLength(), 18);
+
+    // reaching over several ranges merges them
+    lossList.insert(seq(21), seq(35));
+    QCOMPARE(getRanges(lossList), Ranges({ { 1, 2 }, { 8, 12 }, { 20, 35 }, { 40, 42 } }));
+    QCOMPARE(lossList.getLength(), 26);
+
+    // ranges that only touch stay apart
+    lossList.insert(seq(36), seq(39));
+    QCOMPARE(getRanges(lossList), Ranges({ { 1, 2 }, { 8, 12 }, { 20, 35 }, { 36, 39 }, { 40, 42 } }));
+    QCOMPARE(lossList.getLength(), 30);
+
+    // nothing new
+    lossList.insert(seq(9), seq(11));
+    QCOMPARE(lossList.getLength(), 30);
+
+    // past the end
+    lossList.insert(seq(50), seq(50));
+    QCOMPARE(getRanges(lossList), Ranges({ { 1, 2 }, { 8, 12 }, { 20, 35 }, { 36, 39 }, { 40, 42 }, { 50, 50 } }));
+    QCOMPARE(lossList.getLength(), 31);
+}
+
+void LossListTests::removeTest() {
+    LossList lossList;
+    lossList.append(seq(10), seq(15));
+    lossList.append(seq(20));
+
+    QVERIFY(!lossList.remove(seq(9)));
+    QVERIFY(!lossList.remove(seq(16)));
+    QVERIFY(!lossList.remove(seq(21)));
+    QCOMPARE(lossList.getLength(), 7);
+
+    // from either end of a range, from its middle, and a whole range
+    QVERIFY(lossList.remove(seq(10)));
+    QVERIFY(lossList.remove(seq(15)));
+    QVERIFY(lossList.remove(seq(12)));
+    QVERIFY(lossList.remove(seq(20)));
+    QCOMPARE(getRanges(lossList), Ranges({ { 11, 11 }, { 13, 14 } }));
+    QCOMPARE(lossList.getLength(), 3);
+    QVERIFY(!lossList.remove(seq(12)));
+
+    QCOMPARE((SequenceNumber::Type)lossList.popFirstSequenceNumber(), 11);
+    QCOMPARE((SequenceNumber::Type)lossList.popFirstSequenceNumber(), 13);
+    QCOMPARE((SequenceNumber::Type)lossList.popFirstSequenceNumber(), 14);
+    QVERIFY(lossList.isEmpty());
+}
+
+void LossListTests::removeRangeTest() {
+    LossList lossList;
+    lossList.append(seq(10), seq(19));
+    lossList.append(seq(30), seq(39));
+    lossList.append(seq(50), seq(59));
+    lossList.append(seq(70), seq(79));
+
+    // in a gap
+    lossList.remove(seq(20), seq(29));
+    QCOMPARE(lossList.getLength(), 40);
+
+    // the middle of a range splits it
+    lossList.remove(seq(13), seq(15));
+    QCOMPARE(getRanges(lossList), Ranges({ { 10, 12 }, { 16, 19 }, { 30, 39 }, { 50, 59 }, { 70, 79 } }));
+    QCOMPARE(lossList.getLength(), 37);
+
+    // across ranges, taking the end of one, whole ones and the start of another
+    lossList.remove(seq(35), seq(74));
+    QCOMPARE(getRanges(lossList), Ranges({ { 10, 12 }, { 16, 19 }, { 30, 34 }, { 75, 79 } }));
+    QCOMPARE(lossList.getLength(), 17);
+
+    // everything
+    lossList.remove(seq(0), seq(100));
+    QVERIFY(lossList.isEmpty());
+    QCOMPARE(getRanges(lossList), Ranges());
+}
+
+void LossListTests::rolloverTest() {
+    const int MAX = SequenceNumber::MAX;
+
+    LossList lossList;
+    lossList.append(seq(MAX - 2), seq(MAX));
+    lossList.append(seq(0), seq(2));
+    QCOMPARE(getRanges(lossList), Ranges({ { MAX - 2, 2 } }));
+    QCOMPARE(lossList.getLength(), 6);
+
+    lossList.append(seq(10));
+    lossList.insert(seq(MAX - 10), seq(MAX - 5));
+    QVERIFY(lossList.remove(seq(0)));
+    QCOMPARE(getRanges(lossList), Ranges({ { MAX - 10, MAX - 5 }, { MAX - 2, MAX }, { 1, 2 }, { 10, 10 } }));
+
+    lossList.remove(seq(MAX - 1), seq(1));
+    QCOMPARE(getSequenceNumbers(lossList), std::vector<int>({ MAX - 10, MAX - 9, MAX - 8, MAX - 7, MAX - 6, MAX - 5,
+                                                               MAX - 2, 2, 10 }));
+    QCOMPARE((SequenceNumber::Type)lossList.getFirstSequenceNumber(), MAX - 10);
+}
+
+void LossListTests::randomTest() {
+    const int FIRST = 1000;
+    const int WINDOW = 2000;
+    const int NUM_OPERATIONS = 20000;
+
+    std::mt19937 generator(1);
+    auto random = [&](int min, int max) {
+        return std::uniform_int_distribution<int>(min, max)(generator);
+    };
+
+    // the same operations on a plain set of the lost sequence numbers
+    LossList lossList;
+    std::set<int> expected;
+
+    for (int i = 0; i < NUM_OPERATIONS; ++i) {
+        int start = random(FIRST, FIRST + WINDOW);
+        int end = start + random(0, 20);
+
+        switch (random(0, 4)) {
+            case 0: {
+                // append only ever goes past the end
+                int first = expected.empty() ? start : *expected.rbegin() + random(1, 5);
+                int last = first + random(0, 5);
+                lossList.append(seq(first), seq(last));
+                for (int value = first; value <= last; ++value) {
+                    expected.insert(value);
+                }
+                break;
+            }
+            case 1:
+                lossList.insert(seq(start), seq(end));
+                for (int value = start; value <= end; ++value) {
+                    expected.insert(value);
+                }
+                break;
+            case 2:
+                QCOMPARE(lossList.remove(seq(start)), expected.erase(start) > 0);
+                break;
+            case 3:
+                lossList.remove(seq(start), seq(end));
+                expected.erase(expected.lower_bound(start), expected.upper_bound(end));
+                break;
+            case 4:
+                if (!expected.empty()) {
+                    QCOMPARE((SequenceNumber::Type)lossList.popFirstSequenceNumber(), *expected.begin());
+                    expected.erase(expected.begin());
+                }
+                break;
+        }
+
+        QCOMPARE(lossList.getLength(), (int)expected.size());
+
+        // the ranges stay sorted and apart, which the binary searches rely on
+        Ranges ranges = getRanges(lossList);
+        for (size_t j = 0; j < ranges.size(); ++j) {
+            QVERIFY(ranges[j].first <= ranges[j].second);
+            QVERIFY(j == 0 || ranges[j - 1].second < ranges[j].first);
+        }
+    }
+
+    QCOMPARE(getSequenceNumbers(lossList), std::vector<int>(expected.begin(), expected.end()));
+}
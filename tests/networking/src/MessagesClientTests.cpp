@@ -0,0 +1,46 @@
+//
+//  MessagesClientTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "MessagesClientTests.h"
+
+#include <MessagesClient.h>
+#include <NodePermissions.h>
+
+QTEST_GUILESS_MAIN(MessagesClientTests)
+
+using Permission = NodePermissions::Permission;
+
+void MessagesClientTests::openChannelTest() {
+    NodePermissions none;
+    QVERIFY(MessagesClient::canSendOnChannel("com.example.chat", none));
+    QVERIFY(MessagesClient::canSendOnChannel("", none));
+}
+
+void MessagesClientTests::scriptProfilerChannelTest() {
+    const QString& channel = MessagesClient::SCRIPT_PROFILER_CHANNEL;
+
+    NodePermissions none;
+    QVERIFY(!MessagesClient::canSendOnChannel(channel, none));
+
+    // rights that have nothing to do with rezzing don't count
+    NodePermissions other;
+    other.set(Permission::canConnectToDomain);
+    other.set(Permission::canAdjustLocks);
+    other.set(Permission::canWriteToAssetServer);
+    other.set(Permission::canKick);
+    QVERIFY(!MessagesClient::canSendOnChannel(channel, other));
+
+    for (auto permission : { Permission::canRezPermanentEntities, Permission::canRezTemporaryEntities,
+                             Permission::canRezPermanentCertifiedEntities, Permission::canRezTemporaryCertifiedEntities }) {
+        NodePermissions rez;
+        rez.set(permission);
+        QVERIFY(MessagesClient::canSendOnChannel(channel, rez));
+    }
+}
@@ -0,0 +1,23 @@
+//
+//  MessagesClientTests.h
+//  tests/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_MessagesClientTests_h
+#define hifi_MessagesClientTests_h
+
+#include <QtTest/QtTest>
+
+class MessagesClientTests : public QObject {
+    Q_OBJECT
+private slots:
+    void openChannelTest();
+    void scriptProfilerChannelTest();
+};
+
+#endif // hifi_MessagesClientTests_h
@@ -0,0 +1,132 @@
+//
+//  ReceivedMessageTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ReceivedMessageTests.h"
+#include "../QTestExtensions.h"
+
+#include <ReceivedMessage.h>
+
+QTEST_MAIN(ReceivedMessageTests)
+
+static const int NUM_TEST_PACKETS = 4;
+static const int TEST_PAYLOAD_SIZE = 1000;
+
+static std::unique_ptr<NLPacket> createMessagePacket(int partNumber, int numParts) {
+    auto packet = NLPacket::create(PacketType::Unknown, -1, true, true);
+
+    udt::Packet::PacketPosition position = udt::Packet::PacketPosition::MIDDLE;
+    if (partNumber == 0) {
+        position = udt::Packet::PacketPosition::FIRST;
+    } else if (partNumber == numParts - 1) {
+        position = udt::Packet::PacketPosition::LAST;
+    }
+    packet->writeMessageNumber(1, position, partNumber);
+
+    for (int i = 0; i < TEST_PAYLOAD_SIZE; ++i) {
+        char value = (char)(partNumber * TEST_PAYLOAD_SIZE + i);
+        packet->writePrimitive(value);
+    }
+
+    // copy the packet so that it looks like it came off the wire
+    auto size = packet->getDataSize();
+    auto data = std::unique_ptr<char[]>(new char[size]);
+    memcpy(data.get(), packet->getData(), size);
+    return NLPacket::fromReceivedPacket(std::move(data), size, HifiSockAddr());
+}
+
+static QSharedPointer<ReceivedMessage> createTestMessage() {
+    auto message = QSharedPointer<ReceivedMessage>::create(createMessagePacket(0, NUM_TEST_PACKETS));
+    for (int i = 1; i < NUM_TEST_PACKETS; ++i) {
+        message->appendPacket(createMessagePacket(i, NUM_TEST_PACKETS));
+    }
+    return message;
+}
+
+static QByteArray expectedData(int offset, int size) {
+    QByteArray data;
+    for (int i = offset; i < offset + size; ++i) {
+        data.append((char)i);
+    }
+    return data;
+}
+
+void ReceivedMessageTests::segmentChainTest() {
+    auto message = createTestMessage();
+
+    QCOMPARE(message->isComplete(), true);
+    QCOMPARE(message->getNumPackets(), (qint64)NUM_TEST_PACKETS);
+    QCOMPARE(message->getSize(), (qint64)(NUM_TEST_PACKETS * TEST_PAYLOAD_SIZE));
+    QCOMPARE(message->getNumSegments(), (size_t)NUM_TEST_PACKETS);
+}
+
+void ReceivedMessageTests::spanningReadTest() {
+    auto message = createTestMessage();
+
+    // read across the boundary between the first and second packet
+    const int OFFSET = TEST_PAYLOAD_SIZE - 10;
+    message->seek(OFFSET);
+    QCOMPARE(message->peek(20), expectedData(OFFSET, 20));
+    QCOMPARE(message->read(20), expectedData(OFFSET, 20));
+    QCOMPARE(message->getPosition(), (qint64)(OFFSET + 20));
+
+    char buffer[TEST_PAYLOAD_SIZE * 2];
+    message->seek(OFFSET);
+    QCOMPARE(message->read(buffer, sizeof(buffer)), (qint64)sizeof(buffer));
+    COMPARE_DATA(buffer, expectedData(OFFSET, sizeof(buffer)).constData(), sizeof(buffer));
+
+    message->seek(OFFSET);
+    QCOMPARE(message->readWithoutCopy(20), expectedData(OFFSET, 20));
+
+    message->seek(0);
+    QCOMPARE(message->readAll(), expectedData(0, NUM_TEST_PACKETS * TEST_PAYLOAD_SIZE));
+    QCOMPARE(message->getBytesLeftToRead(), (qint64)0);
+
+    // none of the reads should have required the message to be made contiguous
+    QCOMPARE(message->getNumSegments(), (size_t)NUM_TEST_PACKETS);
+}
+
+void ReceivedMessageTests::segmentViewTest() {
+    auto message = createTestMessage();
+
+    const int OFFSET = TEST_PAYLOAD_SIZE / 2;
+    message->seek(OFFSET);
+    auto views = message->readSegments(TEST_PAYLOAD_SIZE * 2);
+
+    QCOMPARE(views.size(), (size_t)3);
+    QCOMPARE(views[0].size, (qint64)(TEST_PAYLOAD_SIZE / 2));
+    QCOMPARE(views[1].size, (qint64)TEST_PAYLOAD_SIZE);
+    QCOMPARE(views[2].size, (qint64)(TEST_PAYLOAD_SIZE / 2));
+    QCOMPARE(message->getPosition(), (qint64)(OFFSET + TEST_PAYLOAD_SIZE * 2));
+
+    QByteArray gathered;
+    for (const auto& view : views) {
+        gathered.append(view.data, (int)view.size);
+    }
+    QCOMPARE(gathered, expectedData(OFFSET, TEST_PAYLOAD_SIZE * 2));
+}
+
+void ReceivedMessageTests::contiguousMessageTest() {
+    auto message = createTestMessage();
+
+    auto views = message->peekSegments(TEST_PAYLOAD_SIZE * 2);
+    auto withoutCopy = message->readWithoutCopy(10);
+
+    auto expected = expectedData(0, NUM_TEST_PACKETS * TEST_PAYLOAD_SIZE);
+    auto rawMessage = message->getRawMessage();
+    COMPARE_DATA(rawMessage, expected.constData(), expected.size());
+    QCOMPARE(message->getMessage(), expected);
+    QCOMPARE(message->getRawMessage(), rawMessage);
+
+    // the packets are still referenced in place
+    QCOMPARE(message->getNumSegments(), (size_t)NUM_TEST_PACKETS);
+    QCOMPARE(withoutCopy, expectedData(0, 10));
+    COMPARE_DATA(views[0].data, expected.constData(), TEST_PAYLOAD_SIZE);
+    COMPARE_DATA(views[1].data, expected.constData() + TEST_PAYLOAD_SIZE, TEST_PAYLOAD_SIZE);
+}
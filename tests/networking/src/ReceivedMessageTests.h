@@ -0,0 +1,34 @@
+//
+//  ReceivedMessageTests.h
+//  tests/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ReceivedMessageTests_h
+#define hifi_ReceivedMessageTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class ReceivedMessageTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that packets appended by ownership are chained without being coalesced
+    void segmentChainTest();
+
+    // Test reads that span several packets
+    void spanningReadTest();
+
+    // Test scatter-gather views over the packet chain
+    void segmentViewTest();
+
+    // Test that asking for the whole message leaves views taken earlier valid
+    void contiguousMessageTest();
+};
+
+#endif // hifi_ReceivedMessageTests_h
@@ -0,0 +1,193 @@
+//
+//  EntityPropertiesBufferTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityPropertiesBufferTests.h"
+
+#include <limits>
+
+#include <glm/gtc/quaternion.hpp>
+
+#include <AccountManager.h>
+#include <AddressManager.h>
+#include <EntityItem.h>
+#include <EntityScriptingInterface.h>
+#include <EntityTree.h>
+#include <NodeList.h>
+
+QTEST_MAIN(EntityPropertiesBufferTests)
+
+static const glm::vec3 TEST_POSITION { 1.0f, 2.0f, 3.0f };
+static const glm::quat TEST_ROTATION = glm::normalize(glm::quat(0.5f, 0.1f, -0.7f, 0.2f));
+static const float TEST_DAMPING = 0.25f;
+static const QStringList TEST_PROPERTIES { "position", "rotation", "damping" };
+static const int TEST_STRIDE = 3 + 4 + 1;
+
+// A serverless tree, so edits apply locally without going out to an entity server
+class TestEntities {
+public:
+    TestEntities() : scriptingInterface(false) {
+        tree = std::make_shared<EntityTree>();
+        tree->createRootElement();
+        tree->setIsServerlessMode(true);
+        scriptingInterface.init();
+        scriptingInterface.setEntityTree(tree);
+    }
+
+    QUuid addEntity() {
+        EntityItemProperties properties;
+        properties.setType(EntityTypes::Box);
+        properties.setPosition(TEST_POSITION);
+        properties.setRotation(TEST_ROTATION);
+        properties.setDamping(TEST_DAMPING);
+        EntityItemID id(QUuid::createUuid());
+        return tree->addEntity(id, properties) ? id : QUuid();
+    }
+
+    EntityItemPointer getEntity(const QUuid& id) { return tree->findEntityByEntityItemID(EntityItemID(id)); }
+
+    EntityTreePointer tree;
+    EntityScriptingInterface scriptingInterface;
+};
+
+static std::vector<float> toValues(const QByteArray& buffer) {
+    std::vector<float> values(buffer.size() / sizeof(float));
+    memcpy(values.data(), buffer.constData(), values.size() * sizeof(float));
+    return values;
+}
+
+static QByteArray toBuffer(const std::vector<float>& values) {
+    return QByteArray(reinterpret_cast<const char*>(values.data()), (int)(values.size() * sizeof(float)));
+}
+
+static bool isSameRotation(const glm::quat& a, const glm::quat& b) {
+    return fabsf(glm::dot(a, b)) > 0.9999f;
+}
+
+void EntityPropertiesBufferTests::initTestCase() {
+    // EntityTree::addEntity and EntityScriptingInterface check the permissions of this node
+    DependencyManager::registerInheritance<LimitedNodeList, NodeList>();
+    DependencyManager::set<AccountManager>();
+    DependencyManager::set<AddressManager>();
+    DependencyManager::set<NodeList>(NodeType::Agent);
+}
+
+void EntityPropertiesBufferTests::testStride() {
+    TestEntities entities;
+    auto& scriptingInterface = entities.scriptingInterface;
+
+    QCOMPARE(scriptingInterface.getEntityPropertiesBufferStride(TEST_PROPERTIES), TEST_STRIDE);
+    QCOMPARE(scriptingInterface.getEntityPropertiesBufferStride({ "localRotation", "visible", "age" }), 4 + 1 + 1);
+    QCOMPARE(scriptingInterface.getEntityPropertiesBufferStride(QStringList()), 0);
+    QCOMPARE(scriptingInterface.getEntityPropertiesBufferStride({ "position", "notAProperty" }), -1);
+}
+
+void EntityPropertiesBufferTests::testLayout() {
+    TestEntities entities;
+    QUuid id = entities.addEntity();
+    QVERIFY(!id.isNull());
+
+    // entity by entity, in the order of the properties, NaN for entities that can't be found
+    QVector<QUuid> ids { id, QUuid::createUuid() };
+    auto buffer = entities.scriptingInterface.getEntityPropertiesBuffer(ids, TEST_PROPERTIES);
+    QCOMPARE(buffer.size(), ids.size() * TEST_STRIDE * (int)sizeof(float));
+
+    auto values = toValues(buffer);
+    QCOMPARE(values[0], TEST_POSITION.x);
+    QCOMPARE(values[1], TEST_POSITION.y);
+    QCOMPARE(values[2], TEST_POSITION.z);
+    QVERIFY(isSameRotation(glm::quat(values[6], values[3], values[4], values[5]), TEST_ROTATION));
+    QCOMPARE(values[7], TEST_DAMPING);
+    for (int i = TEST_STRIDE; i < 2 * TEST_STRIDE; i++) {
+        QVERIFY(glm::isnan(values[i]));
+    }
+
+    QVERIFY(entities.scriptingInterface.getEntityPropertiesBuffer(ids, { "position", "notAProperty" }).isEmpty());
+}
+
+void EntityPropertiesBufferTests::testRoundTrip() {
+    TestEntities entities;
+    QVector<QUuid> ids { entities.addEntity(), entities.addEntity() };
+
+    auto values = toValues(entities.scriptingInterface.getEntityPropertiesBuffer(ids, TEST_PROPERTIES));
+    const glm::vec3 OFFSET { 0.0f, 1.0f, 0.0f };
+    const glm::quat NEW_ROTATION = glm::angleAxis(0.5f, glm::vec3(0.0f, 1.0f, 0.0f));
+    for (int i = 0; i < ids.size(); i++) {
+        float* entityValues = values.data() + i * TEST_STRIDE;
+        entityValues[1] += OFFSET.y;
+        entityValues[3] = NEW_ROTATION.x;
+        entityValues[4] = NEW_ROTATION.y;
+        entityValues[5] = NEW_ROTATION.z;
+        entityValues[6] = NEW_ROTATION.w;
+        entityValues[7] = 0.5f;
+    }
+
+    QCOMPARE(entities.scriptingInterface.editEntitiesFromBuffer(ids, TEST_PROPERTIES, toBuffer(values)), ids.size());
+    for (const auto& id : ids) {
+        auto entity = entities.getEntity(id);
+        QCOMPARE(entity->getWorldPosition(), TEST_POSITION + OFFSET);
+        QVERIFY(isSameRotation(entity->getWorldOrientation(), NEW_ROTATION));
+        QCOMPARE(entity->getDamping(), 0.5f);
+    }
+
+    // what was written reads back the same
+    auto readBack = toValues(entities.scriptingInterface.getEntityPropertiesBuffer(ids, TEST_PROPERTIES));
+    QCOMPARE(readBack.size(), values.size());
+    for (size_t i = 0; i < values.size(); i++) {
+        QVERIFY(fabsf(readBack[i] - values[i]) < 0.0001f);
+    }
+}
+
+void EntityPropertiesBufferTests::testInvalidValues() {
+    TestEntities entities;
+    QVector<QUuid> ids { entities.addEntity() };
+    const float NaN = std::numeric_limits<float>::quiet_NaN();
+
+    // a NaN leaves only its own property unchanged
+    std::vector<float> values { NaN, 5.0f, 5.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.75f };
+    QCOMPARE(entities.scriptingInterface.editEntitiesFromBuffer(ids, TEST_PROPERTIES, toBuffer(values)), 1);
+    auto entity = entities.getEntity(ids[0]);
+    QCOMPARE(entity->getWorldPosition(), TEST_POSITION);
+    QVERIFY(isSameRotation(entity->getWorldOrientation(), glm::quat()));
+    QCOMPARE(entity->getDamping(), 0.75f);
+
+    // a zero length rotation is left unchanged rather than normalized to NaN
+    values = { 0.0f, 0.0f, 0.0f, 0.0f };
+    QCOMPARE(entities.scriptingInterface.editEntitiesFromBuffer(ids, { "rotation" }, toBuffer(values)), 0);
+    QVERIFY(isSameRotation(entity->getWorldOrientation(), glm::quat()));
+    QVERIFY(!glm::any(glm::isnan(glm::vec4(entity->getWorldOrientation().x, entity->getWorldOrientation().y,
+                                           entity->getWorldOrientation().z, entity->getWorldOrientation().w))));
+
+    // an unnormalized rotation is normalized
+    values = { 0.0f, 0.0f, 0.0f, 2.0f };
+    QCOMPARE(entities.scriptingInterface.editEntitiesFromBuffer(ids, { "localRotation" }, toBuffer(values)), 1);
+    QVERIFY(isSameRotation(entity->getLocalOrientation(), glm::quat()));
+    QVERIFY(fabsf(glm::length(entity->getLocalOrientation()) - 1.0f) < 0.0001f);
+}
+
+void EntityPropertiesBufferTests::testInvalidBuffers() {
+    TestEntities entities;
+    QVector<QUuid> ids { entities.addEntity(), entities.addEntity() };
+    std::vector<float> values(ids.size() * TEST_STRIDE, 9.0f);
+
+    // one value short for the last entity
+    auto shortBuffer = toBuffer(values);
+    shortBuffer.chop(sizeof(float));
+    QCOMPARE(entities.scriptingInterface.editEntitiesFromBuffer(ids, TEST_PROPERTIES, shortBuffer), 0);
+
+    QCOMPARE(entities.scriptingInterface.editEntitiesFromBuffer(ids, { "position", "notAProperty" }, toBuffer(values)), 0);
+    QCOMPARE(entities.scriptingInterface.editEntitiesFromBuffer(ids, { "age" }, toBuffer(values)), 0);
+
+    // nothing was applied
+    for (const auto& id : ids) {
+        auto entity = entities.getEntity(id);
+        QCOMPARE(entity->getWorldPosition(), TEST_POSITION);
+        QCOMPARE(entity->getDamping(), TEST_DAMPING);
+    }
+}
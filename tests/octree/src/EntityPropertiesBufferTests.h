@@ -0,0 +1,28 @@
+//
+//  EntityPropertiesBufferTests.h
+//  tests/octree/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityPropertiesBufferTests_h
+#define hifi_EntityPropertiesBufferTests_h
+
+#include <QtTest/QtTest>
+
+class EntityPropertiesBufferTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void testStride();
+    void testLayout();
+    void testRoundTrip();
+    void testInvalidValues();
+    void testInvalidBuffers();
+};
+
+#endif // hifi_EntityPropertiesBufferTests_h
@@ -0,0 +1,371 @@
+//
+//  EntityQueryTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityQueryTests.h"
+
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <random>
+
+#include <glm/gtc/quaternion.hpp>
+
+#include <AccountManager.h>
+#include <AddressManager.h>
+#include <EntityItem.h>
+#include <EntityTree.h>
+#include <EntityTreeElement.h>
+#include <GLMHelpers.h>
+#include <NodeList.h>
+#include <SharedUtil.h>
+
+QTEST_MAIN(EntityQueryTests)
+
+static const int NUM_TEST_ENTITIES = 2000;
+static const int NUM_TEST_QUERIES = 50;
+static const float TEST_WORLD_HALF_SIZE = 100.0f;
+
+// Builds a tree of randomly placed, sized and rotated entities.  Every tenth entity is a Light so that
+// type queries exercise both the type index and the octree search, names cycle through a few spellings.
+static EntityTreePointer createTestTree(int numEntities, float worldHalfSize, std::vector<EntityItemID>& entityIDs,
+                                        uint32_t seed = 1) {
+    auto tree = std::make_shared<EntityTree>();
+    tree->createRootElement();
+    tree->setIsServer(true);
+
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<float> position(-worldHalfSize, worldHalfSize);
+    std::uniform_real_distribution<float> size(0.1f, 4.0f);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    const QString NAMES[] = { "chair", "Chair", "table", "lamp" };
+
+    entityIDs.clear();
+    for (int i = 0; i < numEntities; i++) {
+        EntityItemProperties properties;
+        properties.setType((i % 10 == 0) ? EntityTypes::Light : ((i % 2) ? EntityTypes::Box : EntityTypes::Sphere));
+        properties.setPosition(glm::vec3(position(generator), position(generator), position(generator)));
+        float dimension = size(generator);
+        if (i % 3 == 0) {
+            properties.setDimensions(glm::vec3(dimension));
+        } else {
+            properties.setDimensions(glm::vec3(dimension, size(generator), size(generator)));
+        }
+        glm::quat rotation(unit(generator), unit(generator), unit(generator), unit(generator));
+        properties.setRotation(glm::normalize(rotation));
+        properties.setName(NAMES[i % 4]);
+
+        EntityItemID id(QUuid::createUuid());
+        if (tree->addEntity(id, properties)) {
+            entityIDs.push_back(id);
+        }
+    }
+    return tree;
+}
+
+static QSet<EntityItemID> toIDSet(const QVector<EntityItemPointer>& entities) {
+    QSet<EntityItemID> result;
+    foreach (const EntityItemPointer& entity, entities) {
+        result.insert(entity->getEntityItemID());
+    }
+    return result;
+}
+
+static bool touchesSphere(const EntityItemPointer& entity, const glm::vec3& center, float radius) {
+    bool success;
+    AABox entityBox = entity->getAABox(success);
+    return (!success || entityBox.touchesSphere(center, radius)) &&
+        EntityTreeElement::entityTouchesSphere(entity, center, radius);
+}
+
+static float distanceToAABox(const EntityItemPointer& entity, const glm::vec3& point) {
+    bool success;
+    AABox entityBox = entity->getAABox(success);
+    glm::vec3 delta = glm::max(glm::max(entityBox.getMinimumPoint() - point, Vectors::ZERO),
+                               point - entityBox.getMaximumPoint());
+    return glm::length(delta);
+}
+
+void EntityQueryTests::initTestCase() {
+    // EntityTree::addEntity checks the permissions of this node
+    DependencyManager::registerInheritance<LimitedNodeList, NodeList>();
+    DependencyManager::set<AccountManager>();
+    DependencyManager::set<AddressManager>();
+    DependencyManager::set<NodeList>(NodeType::Agent);
+}
+
+void EntityQueryTests::testFindInSphere() {
+    std::vector<EntityItemID> entityIDs;
+    EntityTreePointer tree = createTestTree(NUM_TEST_ENTITIES, TEST_WORLD_HALF_SIZE, entityIDs);
+    QCOMPARE((int)entityIDs.size(), NUM_TEST_ENTITIES);
+
+    std::mt19937 generator(2);
+    std::uniform_real_distribution<float> position(-TEST_WORLD_HALF_SIZE, TEST_WORLD_HALF_SIZE);
+    std::uniform_real_distribution<float> radius(0.5f, 30.0f);
+    for (int i = 0; i < NUM_TEST_QUERIES; i++) {
+        glm::vec3 center(position(generator), position(generator), position(generator));
+        float queryRadius = radius(generator);
+
+        QSet<EntityItemID> expected;
+        for (const auto& id : entityIDs) {
+            EntityItemPointer entity = tree->findEntityByEntityItemID(id);
+            if (touchesSphere(entity, center, queryRadius)) {
+                expected.insert(id);
+            }
+        }
+
+        QVector<EntityItemPointer> found;
+        tree->findEntities(center, queryRadius, found);
+        QCOMPARE(found.size(), toIDSet(found).size());
+        QCOMPARE(toIDSet(found), expected);
+    }
+}
+
+void EntityQueryTests::testFindInBox() {
+    std::vector<EntityItemID> entityIDs;
+    EntityTreePointer tree = createTestTree(NUM_TEST_ENTITIES, TEST_WORLD_HALF_SIZE, entityIDs);
+
+    std::mt19937 generator(3);
+    std::uniform_real_distribution<float> position(-TEST_WORLD_HALF_SIZE, TEST_WORLD_HALF_SIZE);
+    std::uniform_real_distribution<float> size(0.5f, 40.0f);
+    for (int i = 0; i < NUM_TEST_QUERIES; i++) {
+        AABox box(glm::vec3(position(generator), position(generator), position(generator)),
+                  glm::vec3(size(generator), size(generator), size(generator)));
+
+        QSet<EntityItemID> expected;
+        for (const auto& id : entityIDs) {
+            bool success;
+            AABox entityBox = tree->findEntityByEntityItemID(id)->getAABox(success);
+            if (!success || entityBox.touches(box)) {
+                expected.insert(id);
+            }
+        }
+
+        QVector<EntityItemPointer> found;
+        tree->findEntities(box, found);
+        QCOMPARE(toIDSet(found), expected);
+    }
+}
+
+void EntityQueryTests::testFindByType() {
+    std::vector<EntityItemID> entityIDs;
+    EntityTreePointer tree = createTestTree(NUM_TEST_ENTITIES, TEST_WORLD_HALF_SIZE, entityIDs);
+
+    std::mt19937 generator(4);
+    std::uniform_real_distribution<float> position(-TEST_WORLD_HALF_SIZE, TEST_WORLD_HALF_SIZE);
+    std::uniform_real_distribution<float> radius(5.0f, 60.0f);
+
+    // Lights are few enough to be searched through the type index, Boxes are searched through the octree
+    EntityTypes::EntityType types[] = { EntityTypes::Light, EntityTypes::Box, EntityTypes::Text };
+    for (auto type : types) {
+        for (int i = 0; i < NUM_TEST_QUERIES; i++) {
+            glm::vec3 center(position(generator), position(generator), position(generator));
+            float queryRadius = radius(generator);
+
+            QSet<EntityItemID> expected;
+            for (const auto& id : entityIDs) {
+                EntityItemPointer entity = tree->findEntityByEntityItemID(id);
+                if (entity->getType() == type && touchesSphere(entity, center, queryRadius)) {
+                    expected.insert(id);
+                }
+            }
+
+            QVector<EntityItemPointer> found;
+            tree->findEntitiesByType(type, center, queryRadius, found);
+            QCOMPARE(toIDSet(found), expected);
+        }
+    }
+
+    // the type index forgets deleted entities
+    EntityItemPointer light = tree->findEntityByEntityItemID(entityIDs[0]);
+    QCOMPARE(light->getType(), EntityTypes::Light);
+    bool success;
+    glm::vec3 lightPosition = light->getCenterPosition(success);
+    tree->deleteEntity(entityIDs[0], true);
+    QVector<EntityItemPointer> found;
+    tree->findEntitiesByType(EntityTypes::Light, lightPosition, 1.0f, found);
+    QVERIFY(!toIDSet(found).contains(entityIDs[0]));
+}
+
+void EntityQueryTests::testFindByName() {
+    std::vector<EntityItemID> entityIDs;
+    EntityTreePointer tree = createTestTree(NUM_TEST_ENTITIES, TEST_WORLD_HALF_SIZE, entityIDs);
+
+    std::mt19937 generator(5);
+    std::uniform_real_distribution<float> position(-TEST_WORLD_HALF_SIZE, TEST_WORLD_HALF_SIZE);
+    std::uniform_real_distribution<float> radius(5.0f, 60.0f);
+    for (int i = 0; i < NUM_TEST_QUERIES; i++) {
+        glm::vec3 center(position(generator), position(generator), position(generator));
+        float queryRadius = radius(generator);
+        bool caseSensitive = (i % 2) == 0;
+
+        QSet<EntityItemID> expected;
+        for (const auto& id : entityIDs) {
+            EntityItemPointer entity = tree->findEntityByEntityItemID(id);
+            bool nameMatches = caseSensitive ? entity->getName() == "chair" : entity->getName().toLower() == "chair";
+            if (nameMatches && touchesSphere(entity, center, queryRadius)) {
+                expected.insert(id);
+            }
+        }
+
+        QVector<EntityItemPointer> found;
+        tree->findEntitiesByName("chair", center, queryRadius, caseSensitive, found);
+        QCOMPARE(toIDSet(found), expected);
+    }
+}
+
+void EntityQueryTests::testFindNearest() {
+    std::vector<EntityItemID> entityIDs;
+    EntityTreePointer tree = createTestTree(NUM_TEST_ENTITIES, TEST_WORLD_HALF_SIZE, entityIDs);
+
+    std::mt19937 generator(6);
+    std::uniform_real_distribution<float> position(-TEST_WORLD_HALF_SIZE, TEST_WORLD_HALF_SIZE);
+    std::uniform_real_distribution<float> radius(1.0f, 50.0f);
+    const float EPSILON = 1.0e-4f;
+    int counts[] = { 1, 8, 100 };
+    for (int count : counts) {
+        for (int i = 0; i < NUM_TEST_QUERIES; i++) {
+            glm::vec3 center(position(generator), position(generator), position(generator));
+            float queryRadius = radius(generator);
+
+            std::vector<float> expected;
+            for (const auto& id : entityIDs) {
+                float distance = distanceToAABox(tree->findEntityByEntityItemID(id), center);
+                if (distance <= queryRadius) {
+                    expected.push_back(distance);
+                }
+            }
+            std::sort(expected.begin(), expected.end());
+            expected.resize(std::min((int)expected.size(), count));
+
+            // ties may come back in any order, so compare distances rather than IDs
+            QVector<EntityItemPointer> found;
+            tree->findNearestEntities(center, count, queryRadius, found);
+            QCOMPARE(found.size(), (int)expected.size());
+            QCOMPARE(toIDSet(found).size(), found.size());
+            for (int j = 0; j < found.size(); j++) {
+                QVERIFY(fabsf(distanceToAABox(found[j], center) - expected[j]) < EPSILON);
+            }
+        }
+    }
+}
+
+void EntityQueryTests::testBoundsFollowEdits() {
+    std::vector<EntityItemID> entityIDs;
+    EntityTreePointer tree = createTestTree(NUM_TEST_ENTITIES, TEST_WORLD_HALF_SIZE, entityIDs);
+
+    // prime the packed bounds of every element
+    QVector<EntityItemPointer> found;
+    tree->findEntities(glm::vec3(0.0f), 2.0f * TEST_WORLD_HALF_SIZE, found);
+
+    const glm::vec3 NEW_POSITION(0.5f * TEST_WORLD_HALF_SIZE, -0.25f * TEST_WORLD_HALF_SIZE, 0.125f * TEST_WORLD_HALF_SIZE);
+    const float QUERY_RADIUS = 0.1f;
+    for (int i = 0; i < 10; i++) {
+        EntityItemID id = entityIDs[i * 7];
+        EntityItemPointer entity = tree->findEntityByEntityItemID(id);
+        bool success;
+        glm::vec3 oldPosition = entity->getCenterPosition(success);
+
+        // moving far enough to change elements, and just a little within the same element
+        glm::vec3 offsets[] = { NEW_POSITION - oldPosition, glm::vec3(0.0f, 0.01f, 0.0f) };
+        for (const auto& offset : offsets) {
+            glm::vec3 before = entity->getCenterPosition(success);
+            EntityItemProperties properties;
+            properties.setPosition(entity->getWorldPosition() + offset);
+            QVERIFY(tree->updateEntity(id, properties));
+            glm::vec3 after = entity->getCenterPosition(success);
+
+            tree->findEntities(after, QUERY_RADIUS, found);
+            QVERIFY(toIDSet(found).contains(id));
+            tree->findNearestEntities(after, 1, QUERY_RADIUS, found);
+            QCOMPARE(found.size(), 1);
+            QCOMPARE(distanceToAABox(found[0], after), 0.0f);
+
+            AABox oldBox(before - glm::vec3(QUERY_RADIUS), glm::vec3(2.0f * QUERY_RADIUS));
+            if (!entity->getAABox(success).touches(oldBox)) {
+                tree->findEntities(oldBox, found);
+                QVERIFY(!toIDSet(found).contains(id));
+            }
+        }
+    }
+}
+
+#ifdef MANUAL_TEST
+
+void EntityQueryTests::benchmark() {
+    const int NUM_ENTITIES = 100000;
+    const float WORLD_HALF_SIZE = 1000.0f;
+    const int NUM_QUERIES = 1000;
+    const float QUERY_RADIUS = 20.0f;
+
+    std::vector<EntityItemID> entityIDs;
+    uint64_t startTime = usecTimestampNow();
+    EntityTreePointer tree = createTestTree(NUM_ENTITIES, WORLD_HALF_SIZE, entityIDs);
+    std::cout << "built tree of " << entityIDs.size() << " entities in "
+        << (usecTimestampNow() - startTime) / USECS_PER_MSEC << " msec" << std::endl;
+
+    std::mt19937 generator(7);
+    std::uniform_real_distribution<float> position(-WORLD_HALF_SIZE, WORLD_HALF_SIZE);
+    std::vector<glm::vec3> centers;
+    for (int i = 0; i < NUM_QUERIES; i++) {
+        centers.push_back(glm::vec3(position(generator), position(generator), position(generator)));
+    }
+
+    auto measure = [&](const char* name, std::function<int(const glm::vec3&)> query) {
+        // the first pass builds the packed bounds, the second is what steady state queries cost
+        for (const auto& center : centers) {
+            query(center);
+        }
+        int numFound = 0;
+        uint64_t start = usecTimestampNow();
+        for (const auto& center : centers) {
+            numFound += query(center);
+        }
+        float usecPerQuery = (float)(usecTimestampNow() - start) / (float)NUM_QUERIES;
+        std::cout << "    " << name << ", " << usecPerQuery << ", " << (float)numFound / (float)NUM_QUERIES << std::endl;
+    };
+
+    QVector<EntityItemPointer> found;
+    std::cout << "[query, usecPerQuery, entitiesPerQuery] = [" << std::endl;
+    measure("sphere", [&](const glm::vec3& center) {
+        tree->findEntities(center, QUERY_RADIUS, found);
+        return found.size();
+    });
+    measure("box", [&](const glm::vec3& center) {
+        tree->findEntities(AABox(center - glm::vec3(QUERY_RADIUS), glm::vec3(2.0f * QUERY_RADIUS)), found);
+        return found.size();
+    });
+    measure("type (index)", [&](const glm::vec3& center) {
+        tree->findEntitiesByType(EntityTypes::Light, center, 10.0f * QUERY_RADIUS, found);
+        return found.size();
+    });
+    measure("type (octree)", [&](const glm::vec3& center) {
+        tree->findEntitiesByType(EntityTypes::Box, center, QUERY_RADIUS, found);
+        return found.size();
+    });
+    measure("type (filter after search)", [&](const glm::vec3& center) {
+        tree->findEntities(center, QUERY_RADIUS, found);
+        int numBoxes = 0;
+        foreach (const EntityItemPointer& entity, found) {
+            numBoxes += (entity->getType() == EntityTypes::Box) ? 1 : 0;
+        }
+        return numBoxes;
+    });
+    measure("name", [&](const glm::vec3& center) {
+        tree->findEntitiesByName("chair", center, QUERY_RADIUS, false, found);
+        return found.size();
+    });
+    measure("nearest 8", [&](const glm::vec3& center) {
+        tree->findNearestEntities(center, 8, 10.0f * QUERY_RADIUS, found);
+        return found.size();
+    });
+    std::cout << "];" << std::endl;
+}
+
+#endif // MANUAL_TEST
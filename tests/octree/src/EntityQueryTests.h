@@ -0,0 +1,34 @@
+//
+//  EntityQueryTests.h
+//  tests/octree/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityQueryTests_h
+#define hifi_EntityQueryTests_h
+
+#include <QtTest/QtTest>
+
+//#define MANUAL_TEST
+
+class EntityQueryTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void testFindInSphere();
+    void testFindInBox();
+    void testFindByType();
+    void testFindByName();
+    void testFindNearest();
+    void testBoundsFollowEdits();
+#ifdef MANUAL_TEST
+    void benchmark();
+#endif // MANUAL_TEST
+};
+
+#endif // hifi_EntityQueryTests_h
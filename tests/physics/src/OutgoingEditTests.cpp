@@ -0,0 +1,152 @@
+//
+//  OutgoingEditTests.cpp
+//  tests/physics/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "OutgoingEditTests.h"
+
+#include <PhysicalEntitySimulation.h>
+
+QTEST_MAIN(OutgoingEditTests)
+
+using Candidates = std::vector<std::pair<float, int>>;
+
+// mirrors the send loops in PhysicalEntitySimulation: bids are offered the budget first and
+// owned updates get what is left, each sent in priority order.  Returns the ids that went out.
+static std::vector<int> sendFrame(Candidates bids, Candidates updates, uint32_t maxEdits) {
+    std::vector<int> sent;
+    uint32_t numSent = 0;
+    for (Candidates* candidates : { &bids, &updates }) {
+        uint32_t budget = PhysicalEntitySimulation::computeOutgoingBudget(maxEdits, numSent);
+        PhysicalEntitySimulation::sortOutgoingCandidates(*candidates, budget);
+        for (size_t i = 0; i < candidates->size() && i < budget; ++i) {
+            sent.push_back((*candidates)[i].second);
+            ++numSent;
+        }
+    }
+    return sent;
+}
+
+void OutgoingEditTests::testBudget() {
+    QCOMPARE(PhysicalEntitySimulation::computeOutgoingBudget(64, 0), (uint32_t)64);
+    QCOMPARE(PhysicalEntitySimulation::computeOutgoingBudget(64, 10), (uint32_t)54);
+    QCOMPARE(PhysicalEntitySimulation::computeOutgoingBudget(64, 64), (uint32_t)0);
+    // edits that are never deferred can overrun the budget, which must not wrap around
+    QCOMPARE(PhysicalEntitySimulation::computeOutgoingBudget(64, 100), (uint32_t)0);
+
+    const int NUM_CANDIDATES = 100;
+    const uint32_t budget = DEFAULT_MAX_OUTGOING_EDITS_PER_FRAME;
+    Candidates candidates;
+    for (int i = 0; i < NUM_CANDIDATES; ++i) {
+        // scramble the order the candidates are collected in
+        int id = (i * 37) % NUM_CANDIDATES;
+        candidates.push_back({ (float)id, id });
+    }
+    PhysicalEntitySimulation::sortOutgoingCandidates(candidates, budget);
+    QCOMPARE(candidates.size(), (size_t)NUM_CANDIDATES);
+    for (uint32_t i = 0; i < budget; ++i) {
+        QCOMPARE(candidates[i].second, NUM_CANDIDATES - 1 - (int)i);
+    }
+
+    std::vector<int> sent = sendFrame(Candidates(), candidates, budget);
+    QCOMPARE(sent.size(), (size_t)budget);
+
+    // under budget everything goes out
+    Candidates few(candidates.begin(), candidates.begin() + 10);
+    QCOMPARE(sendFrame(Candidates(), few, budget).size(), (size_t)10);
+}
+
+void OutgoingEditTests::testPriority() {
+    const float ERROR = 0.05f;
+    const float AGE = 0.5f;
+    const float DISTANCE = 10.0f;
+    float base = PhysicalEntitySimulation::computeOutgoingPriority(ERROR, AGE, DISTANCE);
+    QVERIFY(base > 0.0f);
+
+    // more error ranks higher
+    QVERIFY(PhysicalEntitySimulation::computeOutgoingPriority(2.0f * ERROR, AGE, DISTANCE) > base);
+    // farther from the views ranks lower
+    QVERIFY(PhysicalEntitySimulation::computeOutgoingPriority(ERROR, AGE, 2.0f * DISTANCE) < base);
+    // waiting longer ranks higher
+    QVERIFY(PhysicalEntitySimulation::computeOutgoingPriority(ERROR, 2.0f * AGE, DISTANCE) > base);
+    // even an object with no error eventually has something to say
+    QVERIFY(PhysicalEntitySimulation::computeOutgoingPriority(0.0f, AGE, DISTANCE) > 0.0f);
+    // with no views every object counts as close
+    QCOMPARE(PhysicalEntitySimulation::computeOutgoingPriority(ERROR, 0.0f, 0.0f), ERROR);
+}
+
+void OutgoingEditTests::testBidsBeforeUpdates() {
+    const uint32_t MAX_EDITS = 8;
+    Candidates bids;
+    Candidates updates;
+    for (int i = 0; i < 5; ++i) {
+        bids.push_back({ PhysicalEntitySimulation::computeOutgoingPriority(0.01f * i, 0.0f, 1.0f), i });
+        updates.push_back({ PhysicalEntitySimulation::computeOutgoingPriority(0.01f * i, 0.0f, 1.0f), 100 + i });
+    }
+
+    // all five bids go out (highest priority first) and the updates get the remaining three
+    std::vector<int> sent = sendFrame(bids, updates, MAX_EDITS);
+    std::vector<int> expected = { 4, 3, 2, 1, 0, 104, 103, 102 };
+    QCOMPARE(sent.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        QCOMPARE(sent[i], expected[i]);
+    }
+
+    // with more bids than budget the bids fill it and every update waits
+    sent = sendFrame(bids, updates, 3);
+    expected = { 4, 3, 2 };
+    QCOMPARE(sent.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        QCOMPARE(sent[i], expected[i]);
+    }
+}
+
+void OutgoingEditTests::testNoStarvation() {
+    // many more owned objects than budget, each with a steady error: the deferred ones must
+    // still go out on later frames rather than lose to the noisy ones forever
+    const int NUM_OBJECTS = 200;
+    const uint32_t budget = DEFAULT_MAX_OUTGOING_EDITS_PER_FRAME;
+    const float FRAME_PERIOD = 1.0f / 90.0f;
+    const int NUM_FRAMES = 300;
+    const float DISTANCE = 1.0f;
+
+    std::vector<float> errors(NUM_OBJECTS);
+    std::vector<float> lastSent(NUM_OBJECTS, 0.0f);
+    std::vector<int> firstSentFrame(NUM_OBJECTS, -1);
+    for (int i = 0; i < NUM_OBJECTS; ++i) {
+        // from no error at all up to a centimeter
+        errors[i] = 0.01f * (float)i / (float)(NUM_OBJECTS - 1);
+    }
+
+    float longestWait = 0.0f;
+    for (int frame = 1; frame <= NUM_FRAMES; ++frame) {
+        float now = (float)frame * FRAME_PERIOD;
+        Candidates candidates;
+        for (int i = 0; i < NUM_OBJECTS; ++i) {
+            float age = now - lastSent[i];
+            candidates.push_back({ PhysicalEntitySimulation::computeOutgoingPriority(errors[i], age, DISTANCE), i });
+        }
+        std::vector<int> sent = sendFrame(Candidates(), candidates, budget);
+        QCOMPARE(sent.size(), (size_t)budget);
+        for (int i : sent) {
+            longestWait = glm::max(longestWait, now - lastSent[i]);
+            lastSent[i] = now;
+            if (firstSentFrame[i] < 0) {
+                firstSentFrame[i] = frame;
+            }
+        }
+    }
+
+    const int MAX_FRAMES_TO_FIRST_SEND = 90;
+    const float MAX_WAIT = 1.0f; // seconds
+    for (int i = 0; i < NUM_OBJECTS; ++i) {
+        QVERIFY(firstSentFrame[i] > 0);
+        QVERIFY(firstSentFrame[i] <= MAX_FRAMES_TO_FIRST_SEND);
+    }
+    QVERIFY(longestWait < MAX_WAIT);
+}
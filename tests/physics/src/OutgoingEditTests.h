@@ -0,0 +1,26 @@
+//
+//  OutgoingEditTests.h
+//  tests/physics/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OutgoingEditTests_h
+#define hifi_OutgoingEditTests_h
+
+#include <QtTest/QtTest>
+
+class OutgoingEditTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testBudget();
+    void testPriority();
+    void testBidsBeforeUpdates();
+    void testNoStarvation();
+};
+
+#endif // hifi_OutgoingEditTests_h
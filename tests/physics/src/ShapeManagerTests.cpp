@@ -13,6 +13,8 @@
 
 #include <iostream>
 
+#include <ShapeCache.h>
+#include <ShapeFactory.h>
 #include <ShapeManager.h>
 #include <StreamUtils.h>
 #include <Extents.h>
@@ -186,7 +188,7 @@ void ShapeManagerTests::addCapsuleShape() {
     */
 }
 
-void ShapeManagerTests::addCompoundShape() {
+static ShapeInfo makeCompoundShapeInfo(int numHulls) {
     // initialize some points for generating tetrahedral convex hulls
     QVector<glm::vec3> tetrahedron;
     tetrahedron.push_back(glm::vec3(1.0f, 1.0f, 1.0f));
@@ -197,7 +199,6 @@ void ShapeManagerTests::addCompoundShape() {
 
     // compute the points of the hulls
     ShapeInfo::PointCollection pointCollection;
-    int numHulls = 5;
     glm::vec3 offsetNormal(1.0f, 0.0f, 0.0f);
     Extents extents;
     for (int i = 0; i < numHulls; ++i) {
@@ -217,6 +218,12 @@ void ShapeManagerTests::addCompoundShape() {
     glm::vec3 halfExtents = 0.5f * (extents.maximum - extents.minimum);
     info.setParams(SHAPE_TYPE_COMPOUND, halfExtents);
     info.setPointCollection(pointCollection);
+    return info;
+}
+
+void ShapeManagerTests::addCompoundShape() {
+    int numHulls = 5;
+    ShapeInfo info = makeCompoundShapeInfo(numHulls);
 
     // create the shape
     ShapeManager shapeManager;
@@ -244,3 +251,193 @@ void ShapeManagerTests::addCompoundShape() {
     QCOMPARE(shapeManager.getNumShapes(), 0);
     QCOMPARE(shapeManager.getNumReferences(info), 0);
 }
+
+void ShapeManagerTests::buildShapeAsync() {
+    int numHulls = 5;
+    ShapeInfo info = makeCompoundShapeInfo(numHulls);
+
+    ShapeManager shapeManager;
+    shapeManager.setBuildShapesAsync(true);
+
+    // the first request starts the build and returns nothing
+    const btCollisionShape* shape = shapeManager.getShape(info);
+    QVERIFY(shape == nullptr);
+    QVERIFY(shapeManager.isBuildingShape(info));
+
+    // keep asking until the shape is handed out
+    const int MAX_TRIES = 1000;
+    for (int i = 0; i < MAX_TRIES && !shape; ++i) {
+        QThread::msleep(1);
+        shape = shapeManager.getShape(info);
+    }
+    QVERIFY(shape != nullptr);
+    QVERIFY(!shapeManager.hasPendingBuilds());
+    QCOMPARE(shape->getShapeType(), (int)COMPOUND_SHAPE_PROXYTYPE);
+    QCOMPARE(static_cast<const btCompoundShape*>(shape)->getNumChildShapes(), numHulls);
+    QCOMPARE(shapeManager.getNumShapes(), 1);
+    QCOMPARE(shapeManager.getNumReferences(info), 1);
+
+    // primitive shapes are still built right away
+    ShapeInfo boxInfo;
+    boxInfo.setBox(glm::vec3(1.0f));
+    const btCollisionShape* box = shapeManager.getShape(boxInfo);
+    QVERIFY(box != nullptr);
+
+    shapeManager.releaseShape(shape);
+    shapeManager.releaseShape(box);
+    shapeManager.collectGarbage();
+    QCOMPARE(shapeManager.getNumShapes(), 0);
+}
+
+void ShapeManagerTests::failedBuildAsync() {
+    // too few points for a triangle
+    ShapeInfo info;
+    info.setParams(SHAPE_TYPE_STATIC_MESH, glm::vec3(1.0f));
+    ShapeInfo::PointCollection pointCollection;
+    pointCollection.push_back({ glm::vec3(0.0f), glm::vec3(1.0f) });
+    info.setPointCollection(pointCollection);
+
+    ShapeManager shapeManager;
+    shapeManager.setBuildShapesAsync(true);
+    QVERIFY(shapeManager.getShape(info) == nullptr);
+    QVERIFY(shapeManager.isBuildingShape(info));
+
+    const int MAX_TRIES = 1000;
+    for (int i = 0; i < MAX_TRIES && shapeManager.isBuildingShape(info); ++i) {
+        QThread::msleep(1);
+        QVERIFY(shapeManager.getShape(info) == nullptr);
+    }
+
+    // asking again right away doesn't start another build, so the body can tell it failed
+    QVERIFY(shapeManager.getShape(info) == nullptr);
+    QVERIFY(!shapeManager.isBuildingShape(info));
+    QCOMPARE(shapeManager.getNumShapes(), 0);
+}
+
+void ShapeManagerTests::serializeCompoundShape() {
+    int numHulls = 3;
+    ShapeInfo info = makeCompoundShapeInfo(numHulls);
+
+    const btCollisionShape* shape = ShapeFactory::createShapeFromInfo(info);
+    QVERIFY(shape != nullptr);
+
+    QByteArray data;
+    QVERIFY(ShapeFactory::serializeShape(shape, data));
+    const btCollisionShape* restored = ShapeFactory::deserializeShape(info, data);
+    QVERIFY(restored != nullptr);
+    QCOMPARE(restored->getShapeType(), (int)COMPOUND_SHAPE_PROXYTYPE);
+
+    auto compound = static_cast<const btCompoundShape*>(shape);
+    auto restoredCompound = static_cast<const btCompoundShape*>(restored);
+    QCOMPARE(restoredCompound->getNumChildShapes(), numHulls);
+    for (int i = 0; i < numHulls; ++i) {
+        auto hull = static_cast<const btConvexHullShape*>(compound->getChildShape(i));
+        auto restoredHull = static_cast<const btConvexHullShape*>(restoredCompound->getChildShape(i));
+        QCOMPARE(restoredHull->getNumPoints(), hull->getNumPoints());
+        QCOMPARE(restoredHull->getMargin(), hull->getMargin());
+        for (int j = 0; j < hull->getNumPoints(); ++j) {
+            QVERIFY(restoredHull->getUnscaledPoints()[j] == hull->getUnscaledPoints()[j]);
+        }
+    }
+
+    // truncated data is rejected
+    QVERIFY(ShapeFactory::deserializeShape(info, data.left(data.size() / 2)) == nullptr);
+
+    // primitives are not worth caching
+    ShapeInfo boxInfo;
+    boxInfo.setBox(glm::vec3(1.0f));
+    const btCollisionShape* box = ShapeFactory::createShapeFromInfo(boxInfo);
+    QVERIFY(!ShapeFactory::serializeShape(box, data));
+
+    ShapeFactory::deleteShape(shape);
+    ShapeFactory::deleteShape(restored);
+    ShapeFactory::deleteShape(box);
+}
+
+static ShapeInfo makeStaticMeshShapeInfo() {
+    const int GRID_SIZE = 8;
+    ShapeInfo::PointList points;
+    for (int y = 0; y <= GRID_SIZE; ++y) {
+        for (int x = 0; x <= GRID_SIZE; ++x) {
+            points.push_back(glm::vec3((float)x, 0.1f * (float)((x * y) % 3), (float)y));
+        }
+    }
+    ShapeInfo info;
+    info.setParams(SHAPE_TYPE_STATIC_MESH, glm::vec3(0.5f * GRID_SIZE));
+    info.setPointCollection({ points });
+    auto& indices = info.getTriangleIndices();
+    for (int y = 0; y < GRID_SIZE; ++y) {
+        for (int x = 0; x < GRID_SIZE; ++x) {
+            int corner = y * (GRID_SIZE + 1) + x;
+            indices << corner << corner + 1 << corner + GRID_SIZE + 2;
+            indices << corner << corner + GRID_SIZE + 2 << corner + GRID_SIZE + 1;
+        }
+    }
+    return info;
+}
+
+void ShapeManagerTests::serializeStaticMeshShape() {
+    ShapeInfo info = makeStaticMeshShapeInfo();
+    const btCollisionShape* shape = ShapeFactory::createShapeFromInfo(info);
+    QVERIFY(shape != nullptr);
+    QCOMPARE(shape->getShapeType(), (int)TRIANGLE_MESH_SHAPE_PROXYTYPE);
+
+    QByteArray data;
+    QVERIFY(ShapeFactory::serializeShape(shape, data));
+    const btCollisionShape* restored = ShapeFactory::deserializeShape(info, data);
+    QVERIFY(restored != nullptr);
+    QCOMPARE(restored->getShapeType(), (int)TRIANGLE_MESH_SHAPE_PROXYTYPE);
+    auto bvh = const_cast<btBvhTriangleMeshShape*>(static_cast<const btBvhTriangleMeshShape*>(restored))->getOptimizedBvh();
+    QVERIFY(bvh != nullptr);
+    ShapeFactory::deleteShape(restored);
+
+    // the BVH comes last, a damaged one is a cache miss rather than a crash
+    QByteArray corrupted = data;
+    corrupted[corrupted.size() - 8] = corrupted[corrupted.size() - 8] ^ 0x5a;
+    QVERIFY(ShapeFactory::deserializeShape(info, corrupted) == nullptr);
+    QVERIFY(ShapeFactory::deserializeShape(info, data.left(data.size() - 1)) == nullptr);
+
+    // as is a size that doesn't match what follows
+    QByteArray resized = data;
+    QDataStream stream(&resized, QIODevice::ReadWrite);
+    quint32 magic, version;
+    quint8 node;
+    stream >> magic >> version >> node;
+    qint64 sizeOffset = stream.device()->pos();
+    quint32 bufferSize;
+    stream >> bufferSize;
+    stream.device()->seek(sizeOffset);
+    stream << bufferSize * 4;
+    QVERIFY(ShapeFactory::deserializeShape(info, resized) == nullptr);
+
+    ShapeFactory::deleteShape(shape);
+}
+
+void ShapeManagerTests::restoreShapeFromCache() {
+    QTemporaryDir cacheDir;
+    ShapeInfo info = makeCompoundShapeInfo(4);
+
+    auto shapeCache = std::make_shared<ShapeCache>(cacheDir.path().toStdString());
+    shapeCache->initialize();
+    QVERIFY(shapeCache->loadShape(info) == nullptr);
+
+    {
+        ShapeManager shapeManager;
+        shapeManager.setShapeCache(shapeCache);
+        const btCollisionShape* shape = shapeManager.getShape(info);
+        QVERIFY(shape != nullptr);
+        QCOMPARE(shapeCache->getNumTotalFiles(), (size_t)1);
+        shapeManager.releaseShape(shape);
+        shapeManager.collectGarbage();
+    }
+
+    const btCollisionShape* restored = shapeCache->loadShape(info);
+    QVERIFY(restored != nullptr);
+    QCOMPARE(static_cast<const btCompoundShape*>(restored)->getNumChildShapes(), 4);
+    ShapeFactory::deleteShape(restored);
+
+    // different points under the same url and dimensions must not hit the stale entry
+    ShapeInfo changedInfo = makeCompoundShapeInfo(4);
+    changedInfo.getPointCollection()[0][0] += glm::vec3(0.1f);
+    QVERIFY(shapeCache->loadShape(changedInfo) == nullptr);
+}
@@ -13,6 +13,7 @@
 #define hifi_ShapeManagerTests_h
 
 #include <QtTest/QtTest>
+#include <QtCore/QTemporaryDir>
 
 class ShapeManagerTests : public QObject {
     Q_OBJECT
@@ -25,6 +26,11 @@ private slots:
     void addCylinderShape();
     void addCapsuleShape();
     void addCompoundShape();
+    void buildShapeAsync();
+    void failedBuildAsync();
+    void serializeCompoundShape();
+    void serializeStaticMeshShape();
+    void restoreShapeFromCache();
 };
 
 #endif // hifi_ShapeManagerTests_h
@@ -0,0 +1,212 @@
+//
+//  ThreadSafeDynamicsWorldTests.cpp
+//  tests/physics/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ThreadSafeDynamicsWorldTests.h"
+
+#include <iostream>
+
+#include <btBulletDynamicsCommon.h>
+
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+#include <ThreadSafeDynamicsWorld.h>
+
+QTEST_MAIN(ThreadSafeDynamicsWorldTests)
+
+namespace {
+
+const btScalar FIXED_SUBSTEP = btScalar(1.0f / 90.0f);
+
+// owns everything needed to step a ThreadSafeDynamicsWorld without motion states
+class TestWorld {
+public:
+    TestWorld(int numThreads) {
+        _collisionConfig = new btDefaultCollisionConfiguration();
+        _dispatcher = new btCollisionDispatcher(_collisionConfig);
+        _broadphase = new btDbvtBroadphase();
+        _solver = new btSequentialImpulseConstraintSolver();
+        _world = new ThreadSafeDynamicsWorld(_dispatcher, _broadphase, _solver, _collisionConfig);
+        _world->setGravity(btVector3(0.0f, -9.8f, 0.0f));
+        _world->setNumWorkerThreads(numThreads);
+
+        btCollisionShape* ground = new btStaticPlaneShape(btVector3(0.0f, 1.0f, 0.0f), 0.0f);
+        _shapes.push_back(ground);
+        addBody(ground, 0.0f, btVector3(0.0f, 0.0f, 0.0f));
+        _boxShape = new btBoxShape(btVector3(0.5f, 0.5f, 0.5f));
+        _shapes.push_back(_boxShape);
+        _sphereShape = new btSphereShape(0.5f);
+        _shapes.push_back(_sphereShape);
+    }
+
+    ~TestWorld() {
+        for (auto body : _bodies) {
+            _world->removeRigidBody(body);
+            delete body;
+        }
+        for (auto shape : _shapes) {
+            delete shape;
+        }
+        delete _world;
+        delete _solver;
+        delete _broadphase;
+        delete _dispatcher;
+        delete _collisionConfig;
+    }
+
+    btRigidBody* addBody(btCollisionShape* shape, btScalar mass, const btVector3& position) {
+        btVector3 inertia(0.0f, 0.0f, 0.0f);
+        if (mass > 0.0f) {
+            shape->calculateLocalInertia(mass, inertia);
+        }
+        btRigidBody::btRigidBodyConstructionInfo info(mass, nullptr, shape, inertia);
+        info.m_startWorldTransform.setOrigin(position);
+        btRigidBody* body = new btRigidBody(info);
+        if (mass > 0.0f) {
+            body->setActivationState(DISABLE_DEACTIVATION);
+        }
+        _world->addRigidBody(body);
+        _bodies.push_back(body);
+        return body;
+    }
+
+    // columns of boxes, one island per column
+    void addStacks(int numStacks, int height, btScalar spacing) {
+        int side = (int)ceilf(sqrtf((float)numStacks));
+        for (int i = 0; i < numStacks; ++i) {
+            btScalar x = spacing * (btScalar)(i % side);
+            btScalar z = spacing * (btScalar)(i / side);
+            for (int j = 0; j < height; ++j) {
+                addBody(_boxShape, 1.0f, btVector3(x, 0.5f + (btScalar)j * 1.01f, z));
+            }
+        }
+    }
+
+    // loose pyramids of spheres, one island per pile
+    void addPiles(int numPiles, int layers, btScalar spacing, btScalar offset) {
+        int side = (int)ceilf(sqrtf((float)numPiles));
+        for (int i = 0; i < numPiles; ++i) {
+            btScalar x = offset + spacing * (btScalar)(i % side);
+            btScalar z = spacing * (btScalar)(i / side);
+            for (int layer = 0; layer < layers; ++layer) {
+                int width = layers - layer;
+                btScalar corner = -0.5f * (btScalar)(width - 1);
+                for (int a = 0; a < width; ++a) {
+                    for (int b = 0; b < width; ++b) {
+                        btVector3 position(x + corner + (btScalar)a, 0.5f + (btScalar)layer * 0.9f, z + corner + (btScalar)b);
+                        addBody(_sphereShape, 0.5f, position);
+                    }
+                }
+            }
+        }
+    }
+
+    void step(int numSubsteps) {
+        _world->stepSimulationWithSubstepCallback((btScalar)numSubsteps * FIXED_SUBSTEP, numSubsteps, FIXED_SUBSTEP);
+    }
+
+    ThreadSafeDynamicsWorld* getWorld() const { return _world; }
+    const std::vector<btRigidBody*>& getBodies() const { return _bodies; }
+    int getNumBodies() const { return (int)_bodies.size() - 1; }
+
+private:
+    btDefaultCollisionConfiguration* _collisionConfig;
+    btCollisionDispatcher* _dispatcher;
+    btDbvtBroadphase* _broadphase;
+    btSequentialImpulseConstraintSolver* _solver;
+    ThreadSafeDynamicsWorld* _world;
+    btCollisionShape* _boxShape;
+    btCollisionShape* _sphereShape;
+    std::vector<btCollisionShape*> _shapes;
+    std::vector<btRigidBody*> _bodies;
+};
+
+void simulate(int numThreads, int numSubsteps, std::vector<btTransform>& transforms) {
+    TestWorld world(numThreads);
+    world.addStacks(16, 6, 3.0f);
+    world.addPiles(9, 4, 6.0f, 20.0f);
+    world.step(numSubsteps);
+
+    transforms.clear();
+    for (auto body : world.getBodies()) {
+        transforms.push_back(body->getWorldTransform());
+    }
+}
+
+} // anonymous namespace
+
+void ThreadSafeDynamicsWorldTests::testSetNumWorkerThreads() {
+    TestWorld world(1);
+    ThreadSafeDynamicsWorld* dynamicsWorld = world.getWorld();
+    QCOMPARE(dynamicsWorld->getNumWorkerThreads(), 1);
+
+    dynamicsWorld->setNumWorkerThreads(4);
+    QCOMPARE(dynamicsWorld->getNumWorkerThreads(), 4);
+
+    // nonsense values clamp to serial stepping
+    dynamicsWorld->setNumWorkerThreads(0);
+    QCOMPARE(dynamicsWorld->getNumWorkerThreads(), 1);
+    dynamicsWorld->setNumWorkerThreads(-3);
+    QCOMPARE(dynamicsWorld->getNumWorkerThreads(), 1);
+}
+
+void ThreadSafeDynamicsWorldTests::testDeterministicIslands() {
+    const int NUM_SUBSTEPS = 90;
+    std::vector<btTransform> serial;
+    simulate(1, NUM_SUBSTEPS, serial);
+
+    // repeated runs with the same number of threads must agree exactly
+    std::vector<btTransform> parallel;
+    simulate(4, NUM_SUBSTEPS, parallel);
+    std::vector<btTransform> parallelAgain;
+    simulate(4, NUM_SUBSTEPS, parallelAgain);
+    QCOMPARE(parallel.size(), serial.size());
+    QCOMPARE(parallelAgain.size(), serial.size());
+    for (size_t i = 0; i < parallel.size(); ++i) {
+        QVERIFY(parallel[i].getOrigin() == parallelAgain[i].getOrigin());
+        QVERIFY(parallel[i].getRotation() == parallelAgain[i].getRotation());
+    }
+
+    // islands do not share dynamic bodies so splitting them across threads should not
+    // change where anything ends up, beyond floating point noise
+    const btScalar MAX_POSITION_ERROR = 1.0e-3f;
+    for (size_t i = 0; i < parallel.size(); ++i) {
+        btScalar error = (parallel[i].getOrigin() - serial[i].getOrigin()).length();
+        QVERIFY(error < MAX_POSITION_ERROR);
+    }
+}
+
+#ifdef MANUAL_TEST
+
+void ThreadSafeDynamicsWorldTests::benchmark() {
+    const int NUM_SUBSTEPS = 180;
+    int numThreads[] = { 1, 2, 4, 8 };
+    int numStacks[] = { 64, 256, 512 };
+
+    std::cout << "[numBodies, numThreads, msecPerSubstep] = [" << std::endl;
+    for (int stacks : numStacks) {
+        for (int threads : numThreads) {
+            TestWorld world(threads);
+            world.addStacks(stacks, 8, 3.0f);
+            world.addPiles(stacks / 4, 5, 8.0f, -100.0f);
+
+            // let the piles settle into their islands before measuring
+            world.step(10);
+
+            uint64_t startTime = usecTimestampNow();
+            world.step(NUM_SUBSTEPS);
+            uint64_t usec = usecTimestampNow() - startTime;
+            float msecPerSubstep = (float)usec / (float)(USECS_PER_MSEC * NUM_SUBSTEPS);
+            std::cout << "    " << world.getNumBodies() << ", " << threads << ", " << msecPerSubstep << std::endl;
+        }
+    }
+    std::cout << "];" << std::endl;
+}
+
+#endif // MANUAL_TEST
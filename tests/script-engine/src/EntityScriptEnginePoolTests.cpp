@@ -0,0 +1,122 @@
+//
+//  EntityScriptEnginePoolTests.cpp
+//  tests/script-engine/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityScriptEnginePoolTests.h"
+
+#include <EntityScriptEnginePool.h>
+
+QTEST_GUILESS_MAIN(EntityScriptEnginePoolTests)
+
+static const float MIN_IMBALANCE = 100000.0f;
+
+// the selection only looks at the assignments, the engines themselves are never touched
+static void setupPool(EntityScriptEnginePool& pool, int numEngines) {
+    pool.setEngines(std::vector<ScriptEnginePointer>(numEngines));
+}
+
+static EntityItemID addScript(EntityScriptEnginePool& pool, QHash<EntityItemID, float>& loads,
+                              const QString& scriptURL, int engine, float load) {
+    EntityItemID entityID = QUuid::createUuid();
+    pool.assign(entityID, scriptURL, glm::vec3());
+    pool.reassign(entityID, engine);
+    loads.insert(entityID, load);
+    return entityID;
+}
+
+void EntityScriptEnginePoolTests::minImbalanceTest() {
+    EntityScriptEnginePool pool;
+    setupPool(pool, 2);
+    QHash<EntityItemID, float> loads;
+    addScript(pool, loads, "a.js", 0, 30000.0f);
+    addScript(pool, loads, "b.js", 0, 40000.0f);
+
+    // not worth reloading anything for
+    QVERIFY(pool.chooseRebalanceMove(loads, MIN_IMBALANCE).entities.isEmpty());
+
+    // nor with a single engine
+    EntityScriptEnginePool single;
+    setupPool(single, 1);
+    QHash<EntityItemID, float> singleLoads;
+    addScript(single, singleLoads, "a.js", 0, 500000.0f);
+    QVERIFY(single.chooseRebalanceMove(singleLoads, MIN_IMBALANCE).entities.isEmpty());
+}
+
+void EntityScriptEnginePoolTests::halfImbalanceTest() {
+    EntityScriptEnginePool pool;
+    setupPool(pool, 3);
+    QHash<EntityItemID, float> loads;
+    addScript(pool, loads, "a.js", 0, 100000.0f);
+    EntityItemID smaller = addScript(pool, loads, "b.js", 0, 60000.0f);
+    addScript(pool, loads, "c.js", 1, 20000.0f);
+
+    // 160000 apart, the 100000 script would leave the idlest engine busier than the busiest, and move back next time
+    auto move = pool.chooseRebalanceMove(loads, MIN_IMBALANCE);
+    QCOMPARE(move.entities, QList<EntityItemID>({ smaller }));
+    QCOMPARE(move.from, 0);
+    QCOMPARE(move.to, 2);
+    QCOMPARE(move.load, 60000.0f);
+
+    pool.applyRebalanceMove(move);
+    QCOMPARE(pool.findIndex(smaller), 2);
+
+    // nothing on its own is worth moving
+    EntityScriptEnginePool onePool;
+    setupPool(onePool, 2);
+    QHash<EntityItemID, float> oneLoads;
+    addScript(onePool, oneLoads, "a.js", 0, 200000.0f);
+    QVERIFY(onePool.chooseRebalanceMove(oneLoads, MIN_IMBALANCE).entities.isEmpty());
+}
+
+void EntityScriptEnginePoolTests::entityPartitionTest() {
+    EntityScriptEnginePool pool;
+    setupPool(pool, 2);
+    QHash<EntityItemID, float> loads;
+    for (int i = 0; i < 3; i++) {
+        addScript(pool, loads, "shared.js", 0, 25000.0f);
+    }
+    addScript(pool, loads, "hot.js", 0, 100000.0f);
+    addScript(pool, loads, "other.js", 1, 5000.0f);
+
+    // every entity on its own
+    auto move = pool.chooseRebalanceMove(loads, MIN_IMBALANCE);
+    QCOMPARE(move.entities.size(), 1);
+    QCOMPARE(move.load, 25000.0f);
+    QVERIFY(move.scriptURL.isEmpty());
+}
+
+void EntityScriptEnginePoolTests::scriptPartitionTest() {
+    EntityScriptEnginePool pool;
+    pool.setPartition(EntityScriptEnginePool::Partition::Script);
+    setupPool(pool, 2);
+    QHash<EntityItemID, float> loads;
+    QList<EntityItemID> shared;
+    for (int i = 0; i < 3; i++) {
+        shared << addScript(pool, loads, "shared.js", 0, 25000.0f);
+    }
+    addScript(pool, loads, "hot.js", 0, 100000.0f);
+    addScript(pool, loads, "other.js", 1, 5000.0f);
+
+    // the instances of a script move together, 175000 against 5000 leaves room for the 75000 of shared.js
+    auto move = pool.chooseRebalanceMove(loads, MIN_IMBALANCE);
+    QCOMPARE(move.entities.toSet(), shared.toSet());
+    QCOMPARE(move.scriptURL, QString("shared.js"));
+    QCOMPARE(move.load, 75000.0f);
+    QCOMPARE(move.to, 1);
+
+    pool.applyRebalanceMove(move);
+    for (const auto& entityID : shared) {
+        QCOMPARE(pool.findIndex(entityID), 1);
+    }
+
+    // and later instances join them
+    EntityItemID later = QUuid::createUuid();
+    pool.assign(later, "shared.js", glm::vec3());
+    QCOMPARE(pool.findIndex(later), 1);
+}
@@ -0,0 +1,25 @@
+//
+//  EntityScriptEnginePoolTests.h
+//  tests/script-engine/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityScriptEnginePoolTests_h
+#define hifi_EntityScriptEnginePoolTests_h
+
+#include <QtTest/QtTest>
+
+class EntityScriptEnginePoolTests : public QObject {
+    Q_OBJECT
+private slots:
+    void minImbalanceTest();
+    void halfImbalanceTest();
+    void entityPartitionTest();
+    void scriptPartitionTest();
+};
+
+#endif // hifi_EntityScriptEnginePoolTests_h
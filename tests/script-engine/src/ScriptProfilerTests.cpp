@@ -0,0 +1,168 @@
+//
+//  ScriptProfilerTests.cpp
+//  tests/script-engine/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ScriptProfilerTests.h"
+
+#include <QtCore/QJsonArray>
+#include <QtCore/QThread>
+#include <QtScript/QScriptEngine>
+
+#include <ScriptProfiler.h>
+
+QTEST_GUILESS_MAIN(ScriptProfilerTests)
+
+int ScriptProfilerTests::addFunction(ScriptProfiler& profiler, const QString& name) {
+    ScriptProfiler::Function function;
+    function.name = name;
+    function.fileName = "test.js";
+    function.lineNumber = (int)profiler._functions.size() + 1;
+    profiler._functions.push_back(function);
+    return (int)profiler._functions.size() - 1;
+}
+
+void ScriptProfilerTests::addSample(ScriptProfiler& profiler, QVector<int> frames, quint64 usecs, quint64 timestamp) {
+    profiler.addSample(frames, usecs, timestamp);
+}
+
+static QVariantMap findFunctionStats(const QVariantMap& stats, const QString& name) {
+    for (const QVariant& function : stats["functions"].toList()) {
+        if (function.toMap()["name"].toString() == name) {
+            return function.toMap();
+        }
+    }
+    return QVariantMap();
+}
+
+void ScriptProfilerTests::aggregationTest() {
+    QScriptEngine engine;
+    ScriptProfiler profiler(&engine);
+    int program = addFunction(profiler, "(program)");
+    int update = addFunction(profiler, "update");
+    int physics = addFunction(profiler, "physics");
+
+    // frames from the top of the stack, a sample that waited on a long call owes more than one interval
+    addSample(profiler, { physics, update, program }, 5000, 100000);
+    addSample(profiler, { physics, update, program }, 40000, 140000);
+    addSample(profiler, { update, program }, 5000, 145000);
+    addSample(profiler, { program }, 5000, 150000);
+
+    QCOMPARE(profiler.getNumSamples(), 4);
+    QVariantMap stats = profiler.getStats();
+    QVariantList functions = stats["functions"].toList();
+    QCOMPARE(functions.size(), 3);
+
+    // most self time first
+    QCOMPARE(functions[0].toMap()["name"].toString(), QString("physics"));
+    QCOMPARE(functions[0].toMap()["selfTime"].toFloat(), 45.0f);
+    QCOMPARE(functions[0].toMap()["totalTime"].toFloat(), 45.0f);
+    QVariantMap updateStats = findFunctionStats(stats, "update");
+    QCOMPARE(updateStats["selfTime"].toFloat(), 5.0f);
+    QCOMPARE(updateStats["totalTime"].toFloat(), 50.0f);
+    QVariantMap programStats = findFunctionStats(stats, "(program)");
+    QCOMPARE(programStats["selfTime"].toFloat(), 5.0f);
+    QCOMPARE(programStats["totalTime"].toFloat(), 55.0f);
+
+    profiler.reset();
+    QCOMPARE(profiler.getNumSamples(), 0);
+    QVERIFY(profiler.getStats()["functions"].toList().isEmpty());
+}
+
+void ScriptProfilerTests::recursionTest() {
+    QScriptEngine engine;
+    ScriptProfiler profiler(&engine);
+    int program = addFunction(profiler, "(program)");
+    int walk = addFunction(profiler, "walk");
+
+    addSample(profiler, { walk, walk, walk, program }, 5000, 100000);
+    addSample(profiler, { walk, program }, 5000, 105000);
+
+    // each sample charges a function on the stack once however deep it recursed
+    QVariantMap walkStats = findFunctionStats(profiler.getStats(), "walk");
+    QCOMPARE(walkStats["selfTime"].toFloat(), 10.0f);
+    QCOMPARE(walkStats["totalTime"].toFloat(), 10.0f);
+}
+
+void ScriptProfilerTests::flameGraphTest() {
+    QScriptEngine engine;
+    ScriptProfiler profiler(&engine);
+    int program = addFunction(profiler, "(program)");
+    int update = addFunction(profiler, "update");
+    int physics = addFunction(profiler, "physics");
+
+    addSample(profiler, { physics, update, program }, 5000, 100000);
+    addSample(profiler, { physics, update, program }, 40000, 140000);
+    addSample(profiler, { update, program }, 5000, 145000);
+
+    QJsonObject root = profiler.toFlameGraph();
+    QCOMPARE(root["value"].toDouble(), 50000.0);
+    QJsonArray children = root["children"].toArray();
+    QCOMPARE(children.size(), 1);
+    QJsonObject updateNode = children[0].toObject()["children"].toArray()[0].toObject();
+    QVERIFY(updateNode["name"].toString().startsWith("update"));
+    QCOMPARE(updateNode["value"].toDouble(), 50000.0);
+    QCOMPARE(updateNode["children"].toArray()[0].toObject()["value"].toDouble(), 45000.0);
+}
+
+void ScriptProfilerTests::chromeTraceTest() {
+    QScriptEngine engine;
+    ScriptProfiler profiler(&engine, 5);
+    int program = addFunction(profiler, "(program)");
+    int update = addFunction(profiler, "update");
+    int physics = addFunction(profiler, "physics");
+
+    addSample(profiler, { physics, update, program }, 5000, 105000);
+    addSample(profiler, { physics, update, program }, 40000, 145000);
+    addSample(profiler, { update, program }, 5000, 150000);
+    // after a second of idling
+    addSample(profiler, { program }, 5000, 1155000);
+
+    QHash<QString, double> durations;
+    QHash<QString, int> slices;
+    for (const QJsonValue& value : profiler.toChromeTrace()["traceEvents"].toArray()) {
+        QJsonObject event = value.toObject();
+        durations[event["name"].toString()] += event["dur"].toDouble();
+        ++slices[event["name"].toString()];
+    }
+
+    // the long sample keeps physics going until update runs on its own, the idle second isn't charged to anything
+    QCOMPARE(durations["physics"], 45000.0);
+    QCOMPARE(durations["update"], 50000.0);
+    QCOMPARE(slices["(program)"], 2);
+    QCOMPARE(durations["(program)"], 55000.0);
+}
+
+static QScriptValue sleepFunction(QScriptContext* context, QScriptEngine* engine) {
+    QThread::msleep((unsigned long)context->argument(0).toInt32());
+    return QScriptValue();
+}
+
+void ScriptProfilerTests::nativeCallTest() {
+    QScriptEngine engine;
+    engine.globalObject().setProperty("sleep", engine.newFunction(sleepFunction));
+
+    const int SAMPLE_INTERVAL_MSECS = 5;
+    const int NUM_CALLS = 5;
+    const int SLEEP_MSECS = 30;
+    ScriptProfiler profiler(&engine, SAMPLE_INTERVAL_MSECS);
+    engine.setAgent(&profiler);
+    profiler.start();
+    engine.evaluate(QString("function caller() { sleep(%1); var slept = true; return slept; }\n"
+                            "for (var i = 0; i < %2; i++) { caller(); }").arg(SLEEP_MSECS).arg(NUM_CALLS));
+    profiler.stop();
+    engine.setAgent(nullptr);
+
+    // every interval of a call that lasts several is charged, not just the one sample it pays at the end.  The bounds
+    // are loose for busy machines, charging one interval per call would come to less than the lower one.
+    QVariantMap callerStats = findFunctionStats(profiler.getStats(), "caller");
+    QCOMPARE(callerStats["calls"].toInt(), NUM_CALLS);
+    float totalTime = callerStats["totalTime"].toFloat();
+    QVERIFY(totalTime > 0.6f * NUM_CALLS * SLEEP_MSECS);
+    QVERIFY(totalTime < 3.0f * NUM_CALLS * SLEEP_MSECS);
+}
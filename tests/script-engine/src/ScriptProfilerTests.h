@@ -0,0 +1,32 @@
+//
+//  ScriptProfilerTests.h
+//  tests/script-engine/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ScriptProfilerTests_h
+#define hifi_ScriptProfilerTests_h
+
+#include <QtTest/QtTest>
+
+class ScriptProfiler;
+
+class ScriptProfilerTests : public QObject {
+    Q_OBJECT
+private slots:
+    void aggregationTest();
+    void recursionTest();
+    void flameGraphTest();
+    void chromeTraceTest();
+    void nativeCallTest();
+
+private:
+    static int addFunction(ScriptProfiler& profiler, const QString& name);
+    static void addSample(ScriptProfiler& profiler, QVector<int> frames, quint64 usecs, quint64 timestamp);
+};
+
+#endif // hifi_ScriptProfilerTests_h
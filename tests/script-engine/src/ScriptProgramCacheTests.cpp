@@ -0,0 +1,108 @@
+//
+//  ScriptProgramCacheTests.cpp
+//  tests/script-engine/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ScriptProgramCacheTests.h"
+
+#include <QtScript/QScriptEngine>
+
+#include <ScriptProgramCache.h>
+
+QTEST_GUILESS_MAIN(ScriptProgramCacheTests)
+
+static QScriptProgram getProgram(ScriptProgramCache& cache, const QString& source, const QString& fileName = "test.js",
+                                 int lineNumber = 1) {
+    return cache.getProgram(source, fileName, lineNumber, ScriptProgramCache::hashSource(source));
+}
+
+void ScriptProgramCacheTests::hashTest() {
+    QByteArray hash = ScriptProgramCache::hashSource("print('hello');");
+    QCOMPARE(hash.size(), 32);
+    QCOMPARE(ScriptProgramCache::hashSource("print('hello');"), hash);
+    QVERIFY(ScriptProgramCache::hashSource("print('hello!');") != hash);
+    QVERIFY(ScriptProgramCache::hashSource(QString()) != hash);
+}
+
+void ScriptProgramCacheTests::sharedChecksTest() {
+    QByteArray hash = ScriptProgramCache::hashSource("(function() { this.preload = function() {}; })");
+    QByteArray otherHash = ScriptProgramCache::hashSource("(function() { this.unload = function() {}; })");
+    QVERIFY(!ScriptProgramCache::hasPassedSyntaxCheck(hash));
+    QVERIFY(!ScriptProgramCache::hasPassedPreflight(hash));
+
+    // the syntax check and the preflight are remembered separately, and only for that source
+    ScriptProgramCache::setPassedSyntaxCheck(hash);
+    QVERIFY(ScriptProgramCache::hasPassedSyntaxCheck(hash));
+    QVERIFY(!ScriptProgramCache::hasPassedPreflight(hash));
+    QVERIFY(!ScriptProgramCache::hasPassedSyntaxCheck(otherHash));
+
+    ScriptProgramCache::setPassedPreflight(hash);
+    QVERIFY(ScriptProgramCache::hasPassedPreflight(hash));
+    QVERIFY(!ScriptProgramCache::hasPassedPreflight(otherHash));
+}
+
+void ScriptProgramCacheTests::programTest() {
+    QScriptEngine engine;
+    ScriptProgramCache cache;
+
+    QScriptProgram program = getProgram(cache, "1 + 2");
+    QCOMPARE(cache.getNumMisses(), 1);
+    QCOMPARE(cache.getNumHits(), 0);
+    QCOMPARE(engine.evaluate(program).toInt32(), 3);
+
+    QScriptProgram cachedProgram = getProgram(cache, "1 + 2");
+    QCOMPARE(cache.getNumMisses(), 1);
+    QCOMPARE(cache.getNumHits(), 1);
+    QVERIFY(cachedProgram == program);
+    QCOMPARE(engine.evaluate(cachedProgram).toInt32(), 3);
+
+    getProgram(cache, "2 + 3");
+    QCOMPARE(cache.getNumMisses(), 2);
+
+    cache.clear();
+    getProgram(cache, "1 + 2");
+    QCOMPARE(cache.getNumMisses(), 3);
+}
+
+void ScriptProgramCacheTests::locationTest() {
+    QScriptEngine engine;
+    ScriptProgramCache cache;
+
+    // the same source in another file or at another line is another program, its errors point there
+    QScriptProgram first = getProgram(cache, "throw new Error('oops');", "first.js", 1);
+    QScriptProgram second = getProgram(cache, "throw new Error('oops');", "second.js", 1);
+    QScriptProgram third = getProgram(cache, "throw new Error('oops');", "first.js", 10);
+    QCOMPARE(cache.getNumMisses(), 3);
+    QCOMPARE(cache.getNumHits(), 0);
+    QCOMPARE(second.fileName(), QString("second.js"));
+    QCOMPARE(third.firstLineNumber(), 10);
+
+    engine.evaluate(first);
+    QVERIFY(engine.hasUncaughtException());
+    QCOMPARE(engine.uncaughtExceptionLineNumber(), 1);
+    engine.clearExceptions();
+    engine.evaluate(third);
+    QCOMPARE(engine.uncaughtExceptionLineNumber(), 10);
+}
+
+void ScriptProgramCacheTests::limitTest() {
+    ScriptProgramCache cache;
+
+    // the cache starts over once it holds as many programs as it allows
+    const int MAX_PROGRAMS = ScriptProgramCache::MAX_PROGRAMS;
+    for (int i = 0; i < MAX_PROGRAMS; i++) {
+        getProgram(cache, QString("var x = %1;").arg(i));
+    }
+    getProgram(cache, "var x = 0;");
+    QCOMPARE(cache.getNumHits(), 1);
+
+    getProgram(cache, "var y = 0;");
+    getProgram(cache, "var x = 1;");
+    QCOMPARE(cache.getNumHits(), 1);
+    QCOMPARE(cache.getNumMisses(), MAX_PROGRAMS + 2);
+}
@@ -0,0 +1,26 @@
+//
+//  ScriptProgramCacheTests.h
+//  tests/script-engine/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ScriptProgramCacheTests_h
+#define hifi_ScriptProgramCacheTests_h
+
+#include <QtTest/QtTest>
+
+class ScriptProgramCacheTests : public QObject {
+    Q_OBJECT
+private slots:
+    void hashTest();
+    void sharedChecksTest();
+    void programTest();
+    void locationTest();
+    void limitTest();
+};
+
+#endif // hifi_ScriptProgramCacheTests_h
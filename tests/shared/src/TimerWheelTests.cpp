@@ -0,0 +1,191 @@
+//
+//  TimerWheelTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "TimerWheelTests.h"
+
+#include <random>
+#include <unordered_map>
+
+#include <TimerWheel.h>
+
+QTEST_MAIN(TimerWheelTests)
+
+using Expired = std::vector<TimerWheel::Expired>;
+
+void TimerWheelTests::singleShotTest() {
+    TimerWheel wheel;
+    auto late = wheel.start(0, 20, 0, true);
+    auto early = wheel.start(0, 10, 0, true);
+    auto sameTick = wheel.start(0, 10, 0, true);
+    QCOMPARE(wheel.getNumTimers(), 3);
+    QCOMPARE(wheel.getNextWakeup(), (int64_t)10);
+
+    Expired expired;
+    wheel.advance(9, expired);
+    QVERIFY(expired.empty());
+
+    // timers due on the same tick fire in the order they were started
+    wheel.advance(10, expired);
+    QCOMPARE((int)expired.size(), 2);
+    QCOMPARE(expired[0].id, early);
+    QCOMPARE(expired[1].id, sameTick);
+    QCOMPARE(expired[0].dueTime, (int64_t)10);
+    QVERIFY(!wheel.isActive(early));
+
+    expired.clear();
+    wheel.advance(100, expired);
+    QCOMPARE((int)expired.size(), 1);
+    QCOMPARE(expired[0].id, late);
+    QCOMPARE(wheel.getNumTimers(), 0);
+    QCOMPARE(wheel.getNextWakeup(), (int64_t)-1);
+}
+
+void TimerWheelTests::repeatingTest() {
+    TimerWheel wheel;
+    auto id = wheel.start(0, 16, 0, false);
+
+    Expired expired;
+    for (int64_t now = 1; now <= 160; ++now) {
+        wheel.advance(now, expired);
+    }
+    QCOMPARE((int)expired.size(), 10);
+    for (size_t i = 0; i < expired.size(); ++i) {
+        QCOMPARE(expired[i].id, id);
+        QCOMPARE(expired[i].dueTime, (int64_t)(16 * (i + 1)));
+    }
+
+    // falling behind skips the missed firings instead of catching up with all of them at once
+    expired.clear();
+    wheel.advance(1000, expired);
+    QCOMPARE((int)expired.size(), 1);
+    QCOMPARE(wheel.getNextWakeup(), (int64_t)1016);
+    QVERIFY(wheel.isActive(id));
+    QCOMPARE(wheel.getNumSingleShotTimers(), 0);
+}
+
+void TimerWheelTests::stopTest() {
+    TimerWheel wheel;
+    auto first = wheel.start(0, 5, 0, false);
+    auto second = wheel.start(0, 5, 0, true);
+    QVERIFY(wheel.stop(first));
+    QVERIFY(!wheel.stop(first));
+    QVERIFY(!wheel.isActive(first));
+
+    // a recycled entry gets a new id, the old one stays invalid
+    auto third = wheel.start(0, 5, 0, true);
+    QVERIFY(third != first);
+    QVERIFY(!wheel.stop(first));
+
+    Expired expired;
+    wheel.advance(5, expired);
+    QCOMPARE((int)expired.size(), 2);
+    QCOMPARE(expired[0].id, second);
+    QCOMPARE(expired[1].id, third);
+    QVERIFY(!wheel.stop(TimerWheel::INVALID_TIMER_ID));
+}
+
+void TimerWheelTests::farTimerTest() {
+    const int64_t DAY = 24 * 60 * 60 * 1000;
+    TimerWheel wheel(12345);
+    auto id = wheel.start(12345, 10 * DAY, 0, true);
+
+    // the wheel only wakes up to move the timer down a level, never after it is due
+    Expired expired;
+    int wakeups = 0;
+    int64_t wakeup = wheel.getNextWakeup();
+    while (expired.empty()) {
+        QVERIFY(wakeup > 0 && wakeup <= 12345 + 10 * DAY);
+        wheel.advance(wakeup, expired);
+        wakeup = wheel.getNextWakeup();
+        ++wakeups;
+    }
+    QCOMPARE(expired[0].id, id);
+    QCOMPARE(expired[0].dueTime, 12345 + 10 * DAY);
+    QCOMPARE(wheel.getCurrentTick(), 12345 + 10 * DAY);
+    QVERIFY(wakeups < 10);
+}
+
+void TimerWheelTests::coalescingTest() {
+    TimerWheel wheel;
+    const int NUM_TIMERS = 50;
+    for (int i = 0; i < NUM_TIMERS; ++i) {
+        wheel.start(i, 1000, 50, true);
+    }
+
+    Expired expired;
+    int wakeups = 0;
+    while (wheel.getNumTimers() > 0) {
+        size_t before = expired.size();
+        wheel.advance(wheel.getNextWakeup(), expired);
+        if (expired.size() > before) {
+            ++wakeups;
+        }
+        // no timer fires early, or later than its tolerance allows
+        for (size_t i = before; i < expired.size(); ++i) {
+            QVERIFY(wheel.getCurrentTick() >= expired[i].dueTime);
+            QVERIFY(wheel.getCurrentTick() - expired[i].dueTime <= 50);
+        }
+    }
+    QCOMPARE((int)expired.size(), NUM_TIMERS);
+    QVERIFY(wakeups < NUM_TIMERS / 10);
+}
+
+void TimerWheelTests::randomTest() {
+    struct Timer {
+        int64_t dueTime;
+        int64_t interval;
+        bool singleShot;
+    };
+    std::unordered_map<TimerWheel::TimerID, Timer> timers;
+    std::mt19937 random(42);
+    TimerWheel wheel;
+    int64_t now = 0;
+    Expired expired;
+
+    for (int step = 0; step < 20000; ++step) {
+        int operation = random() % 10;
+        if (operation < 3) {
+            int64_t interval = (random() % 8 == 0) ? random() % 1000000 : random() % 300;
+            bool singleShot = (random() % 2) == 0;
+            auto id = wheel.start(now, interval, 0, singleShot);
+            interval = singleShot ? interval : std::max(interval, (int64_t)1);
+            timers[id] = { now + interval, interval, singleShot };
+        } else if (operation < 4 && !timers.empty()) {
+            auto timer = timers.begin();
+            std::advance(timer, random() % timers.size());
+            QVERIFY(wheel.stop(timer->first));
+            timers.erase(timer);
+        } else {
+            now += (random() % 100 == 0) ? random() % 2000000 : random() % 40;
+            expired.clear();
+            wheel.advance(now, expired);
+            for (const auto& timer : expired) {
+                auto expected = timers.find(timer.id);
+                QVERIFY(expected != timers.end());
+                QCOMPARE(timer.dueTime, expected->second.dueTime);
+                QVERIFY(timer.dueTime <= now);
+                if (expected->second.singleShot) {
+                    timers.erase(expected);
+                } else {
+                    expected->second.dueTime += expected->second.interval;
+                    if (expected->second.dueTime <= now) {
+                        expected->second.dueTime = now + expected->second.interval;
+                    }
+                }
+            }
+            QCOMPARE(wheel.getNumTimers(), (int)timers.size());
+            int64_t wakeup = wheel.getNextWakeup();
+            for (const auto& timer : timers) {
+                QVERIFY(timer.second.dueTime >= now);
+                QVERIFY(wakeup >= 0 && wakeup <= std::max(timer.second.dueTime, now + 1));
+            }
+        }
+    }
+}
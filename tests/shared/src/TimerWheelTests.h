@@ -0,0 +1,27 @@
+//
+//  TimerWheelTests.h
+//  tests/shared/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_TimerWheelTests_h
+#define hifi_TimerWheelTests_h
+
+#include <QtTest/QtTest>
+
+class TimerWheelTests : public QObject {
+    Q_OBJECT
+private slots:
+    void singleShotTest();
+    void repeatingTest();
+    void stopTest();
+    void farTimerTest();
+    void coalescingTest();
+    void randomTest();
+};
+
+#endif // hifi_TimerWheelTests_h
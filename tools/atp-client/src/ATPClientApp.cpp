@@ -12,6 +12,7 @@
 #include "ATPClientApp.h"
 
 #include <QDataStream>
+#include <QElapsedTimer>
 #include <QTextStream>
 #include <QThread>
 #include <QFile>
@@ -57,6 +58,11 @@ ATPClientApp::ATPClientApp(int argc, char* argv[]) :
     const QCommandLineOption listenPortOption("listenPort", "listen port", QString::number(INVALID_PORT));
     parser.addOption(listenPortOption);
 
+    const QCommandLineOption benchmarkOption("benchmark",
+        "download the asset once for each number of parallel chunk requests given and report throughput "
+        "(clears the atp-client disk cache between downloads)", "1,2,4,8");
+    parser.addOption(benchmarkOption);
+
     if (!parser.parse(QCoreApplication::arguments())) {
         qCritical() << parser.errorText() << endl;
         parser.showHelp();
@@ -125,6 +131,14 @@ ATPClientApp::ATPClientApp(int argc, char* argv[]) :
         _listenPort = parser.value(listenPortOption).toInt();
     }
 
+    if (parser.isSet(benchmarkOption)) {
+        for (auto& parallelism : parser.value(benchmarkOption).split(",")) {
+            if (parallelism.toInt() > 0) {
+                _benchmarkParallelism.push_back(parallelism.toInt());
+            }
+        }
+    }
+
     _domainServerAddress = QString("127.0.0.1") + ":" + QString::number(domainPort);
     if (parser.isSet(domainAddressOption)) {
         _domainServerAddress = parser.value(domainAddressOption);
@@ -205,7 +219,7 @@ ATPClientApp::ATPClientApp(int argc, char* argv[]) :
 
     DependencyManager::get<AddressManager>()->handleLookupString(_domainServerAddress, false);
 
-    QTimer* _timeoutTimer = new QTimer(this);
+    _timeoutTimer = new QTimer(this);
     _timeoutTimer->setSingleShot(true);
     connect(_timeoutTimer, &QTimer::timeout, this, &ATPClientApp::timedOut);
     _timeoutTimer->start(TIMEOUT_MILLISECONDS);
@@ -351,7 +365,13 @@ void ATPClientApp::lookupAsset() {
             qDebug() << "not found: " << request->getErrorString();
         } else if (result == GetMappingRequest::NoError) {
             qDebug() << "found, hash is " << request->getHash();
-            download(request->getHash());
+            if (_benchmarkParallelism.isEmpty()) {
+                download(request->getHash());
+            } else {
+                // large downloads take longer than our usual timeout
+                _timeoutTimer->stop();
+                benchmarkDownload(request->getHash());
+            }
         } else {
             qDebug() << "error -- " << request->getError() << " -- " << request->getErrorString();
         }
@@ -390,6 +410,45 @@ void ATPClientApp::download(AssetUtils::AssetHash hash) {
     assetRequest->start();
 }
 
+void ATPClientApp::benchmarkDownload(AssetUtils::AssetHash hash) {
+    if (_benchmarkRun >= _benchmarkParallelism.size()) {
+        finish(0);
+        return;
+    }
+
+    int parallelism = _benchmarkParallelism[_benchmarkRun++];
+    AssetRequest::setMaxParallelChunkRequests(parallelism);
+
+    // make sure we're measuring the download and not the disk cache
+    DependencyManager::get<AssetClient>()->clearCache();
+
+    auto assetRequest = new AssetRequest(hash);
+
+    auto timer = std::make_shared<QElapsedTimer>();
+    connect(assetRequest, &AssetRequest::finished, this, [this, hash, parallelism, timer](AssetRequest* request) mutable {
+        Q_ASSERT(request->getState() == AssetRequest::Finished);
+
+        if (request->getError() == AssetRequest::Error::NoError) {
+            static const double BYTES_PER_MEGABYTE = 1000000.0;
+            double seconds = timer->nsecsElapsed() / 1.0e9;
+            double megabytes = request->getData().size() / BYTES_PER_MEGABYTE;
+
+            qDebug() << "parallel chunk requests:" << parallelism
+                << "| size (MB):" << megabytes
+                << "| time (s):" << seconds
+                << "| throughput (MB/s):" << (seconds > 0.0 ? megabytes / seconds : 0.0);
+        } else {
+            qDebug() << "download failed with" << parallelism << "parallel chunk requests:" << request->getErrorString();
+        }
+
+        request->deleteLater();
+        benchmarkDownload(hash);
+    });
+
+    timer->start();
+    assetRequest->start();
+}
+
 void ATPClientApp::finish(int exitCode) {
     auto nodeList = DependencyManager::get<NodeList>();
 
@@ -46,6 +46,7 @@ private:
     void lookupAsset();
     void listAssets();
     void download(AssetUtils::AssetHash hash);
+    void benchmarkDownload(AssetUtils::AssetHash hash);
     void finish(int exitCode);
     bool _verbose;
 
@@ -53,6 +54,9 @@ private:
     QString _localOutputFile;
     QString _localUploadFile;
 
+    QList<int> _benchmarkParallelism; // numbers of parallel chunk requests to benchmark downloads with
+    int _benchmarkRun { 0 };
+
     int _listenPort { INVALID_PORT };
 
     QString _domainServerAddress;
@@ -0,0 +1,250 @@
+//
+//  LegacyFBXReader.cpp
+//  tools/fbx-benchmark/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "LegacyFBXReader.h"
+
+#include <QtCore/QDataStream>
+#include <QtCore/QtEndian>
+
+// The QDataStream based binary reader FBXReader::parseFBX used before it parsed in place, kept as the baseline
+
+namespace legacy {
+
+template<class T>
+int streamSize() {
+    return sizeof(T);
+}
+
+template<bool>
+int streamSize() {
+    return 1;
+}
+
+template<class T>
+static QVariant readBinaryArray(QDataStream& in, int& position) {
+    quint32 arrayLength;
+    quint32 encoding;
+    quint32 compressedLength;
+
+    in >> arrayLength;
+    in >> encoding;
+    in >> compressedLength;
+    position += sizeof(quint32) * 3;
+
+    QVector<T> values;
+    if ((int)QSysInfo::ByteOrder == (int)in.byteOrder()) {
+        values.resize(arrayLength);
+        QByteArray arrayData;
+        if (encoding == FBX_PROPERTY_COMPRESSED_FLAG) {
+            // preface encoded data with uncompressed length
+            QByteArray compressed(sizeof(quint32) + compressedLength, 0);
+            *((quint32*)compressed.data()) = qToBigEndian<quint32>(arrayLength * sizeof(T));
+            in.readRawData(compressed.data() + sizeof(quint32), compressedLength);
+            position += compressedLength;
+            arrayData = qUncompress(compressed);
+            if (arrayData.isEmpty() ||
+                (unsigned int)arrayData.size() != (sizeof(T) * arrayLength)) { // answers empty byte array if corrupt
+                throw QString("corrupt fbx file");
+            }
+        } else {
+            arrayData.resize(sizeof(T) * arrayLength);
+            position += sizeof(T) * arrayLength;
+            in.readRawData(arrayData.data(), arrayData.size());
+        }
+
+        if (arrayData.size() > 0) {
+            memcpy(&values[0], arrayData.constData(), arrayData.size());
+        }
+    } else {
+        values.reserve(arrayLength);
+        if (encoding == FBX_PROPERTY_COMPRESSED_FLAG) {
+            // preface encoded data with uncompressed length
+            QByteArray compressed(sizeof(quint32) + compressedLength, 0);
+            *((quint32*)compressed.data()) = qToBigEndian<quint32>(arrayLength * sizeof(T));
+            in.readRawData(compressed.data() + sizeof(quint32), compressedLength);
+            position += compressedLength;
+            QByteArray uncompressed = qUncompress(compressed);
+            if (uncompressed.isEmpty()) { // answers empty byte array if corrupt
+                throw QString("corrupt fbx file");
+            }
+            QDataStream uncompressedIn(uncompressed);
+            uncompressedIn.setByteOrder(QDataStream::LittleEndian);
+            uncompressedIn.setVersion(QDataStream::Qt_4_5); // for single/double precision switch
+            for (quint32 i = 0; i < arrayLength; i++) {
+                T value;
+                uncompressedIn >> value;
+                values.append(value);
+            }
+        } else {
+            for (quint32 i = 0; i < arrayLength; i++) {
+                T value;
+                in >> value;
+                position += streamSize<T>();
+                values.append(value);
+            }
+        }
+    }
+    return QVariant::fromValue(values);
+}
+
+static QVariant parseBinaryFBXProperty(QDataStream& in, int& position) {
+    char ch;
+    in.device()->getChar(&ch);
+    position++;
+    switch (ch) {
+        case 'Y': {
+            qint16 value;
+            in >> value;
+            position += sizeof(qint16);
+            return QVariant::fromValue(value);
+        }
+        case 'C': {
+            bool value;
+            in >> value;
+            position++;
+            return QVariant::fromValue(value);
+        }
+        case 'I': {
+            qint32 value;
+            in >> value;
+            position += sizeof(qint32);
+            return QVariant::fromValue(value);
+        }
+        case 'F': {
+            float value;
+            in >> value;
+            position += sizeof(float);
+            return QVariant::fromValue(value);
+        }
+        case 'D': {
+            double value;
+            in >> value;
+            position += sizeof(double);
+            return QVariant::fromValue(value);
+        }
+        case 'L': {
+            qint64 value;
+            in >> value;
+            position += sizeof(qint64);
+            return QVariant::fromValue(value);
+        }
+        case 'f': {
+            return readBinaryArray<float>(in, position);
+        }
+        case 'd': {
+            return readBinaryArray<double>(in, position);
+        }
+        case 'l': {
+            return readBinaryArray<qint64>(in, position);
+        }
+        case 'i': {
+            return readBinaryArray<qint32>(in, position);
+        }
+        case 'b': {
+            return readBinaryArray<bool>(in, position);
+        }
+        case 'S':
+        case 'R': {
+            quint32 length;
+            in >> length;
+            position += sizeof(quint32) + length;
+            return QVariant::fromValue(in.device()->read(length));
+        }
+        default:
+            throw QString("Unknown property type: ") + ch;
+    }
+}
+
+static FBXNode parseBinaryFBXNode(QDataStream& in, int& position, bool has64BitPositions) {
+    qint64 endOffset;
+    quint64 propertyCount;
+    quint64 propertyListLength;
+    quint8 nameLength;
+
+    // FBX 2016 and beyond uses 64bit positions in the node headers, pre-2016 used 32bit values
+    // our code generally doesn't care about the size that much, so we will use 64bit values
+    // from here on out, but if the file is an older format we read the stream into temp 32bit 
+    // values and then assign to our actual 64bit values.
+    if (has64BitPositions) {
+        in >> endOffset;
+        in >> propertyCount;
+        in >> propertyListLength;
+        position += sizeof(quint64) * 3;
+    } else {
+        qint32 tempEndOffset;
+        quint32 tempPropertyCount;
+        quint32 tempPropertyListLength;
+        in >> tempEndOffset;
+        in >> tempPropertyCount;
+        in >> tempPropertyListLength;
+        position += sizeof(quint32) * 3;
+        endOffset = tempEndOffset;
+        propertyCount = tempPropertyCount;
+        propertyListLength = tempPropertyListLength;
+    }
+    in >> nameLength;
+    position += sizeof(quint8);
+
+    FBXNode node;
+    const int MIN_VALID_OFFSET = 40;
+    if (endOffset < MIN_VALID_OFFSET || nameLength == 0) {
+        // use a null name to indicate a null node
+        return node;
+    }
+    node.name = in.device()->read(nameLength);
+    position += nameLength;
+
+    for (quint32 i = 0; i < propertyCount; i++) {
+        node.properties.append(parseBinaryFBXProperty(in, position));
+    }
+
+    while (endOffset > position) {
+        FBXNode child = parseBinaryFBXNode(in, position, has64BitPositions);
+        if (child.name.isNull()) {
+            return node;
+
+        } else {
+            node.children.append(child);
+        }
+    }
+
+    return node;
+}
+
+FBXNode parseFBX(QIODevice* device) {
+    if (device->peek(FBX_BINARY_PROLOG.size()) != FBX_BINARY_PROLOG) {
+        return FBXReader::parseFBX(device);
+    }
+    QDataStream in(device);
+    in.setByteOrder(QDataStream::LittleEndian);
+    in.setVersion(QDataStream::Qt_4_5); // for single/double precision switch
+
+    in.skipRawData(FBX_HEADER_BYTES_BEFORE_VERSION);
+    int position = FBX_HEADER_BYTES_BEFORE_VERSION;
+    quint32 fileVersion;
+    in >> fileVersion;
+    position += sizeof(fileVersion);
+    bool has64BitPositions = (fileVersion >= FBX_VERSION_2016);
+
+    FBXNode top;
+    while (device->bytesAvailable()) {
+        FBXNode next = parseBinaryFBXNode(in, position, has64BitPositions);
+        if (next.name.isNull()) {
+            return top;
+
+        } else {
+            top.children.append(next);
+        }
+    }
+
+    return top;
+}
+
+} // namespace legacy
@@ -0,0 +1,25 @@
+//
+//  LegacyFBXReader.h
+//  tools/fbx-benchmark/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_LegacyFBXReader_h
+#define hifi_LegacyFBXReader_h
+
+#include <QtCore/QIODevice>
+
+#include <FBXReader.h>
+
+namespace legacy {
+
+// Reads the whole tree, decoding every array as it goes
+FBXNode parseFBX(QIODevice* device);
+
+}
+
+#endif // hifi_LegacyFBXReader_h
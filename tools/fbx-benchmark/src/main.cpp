@@ -0,0 +1,174 @@
+//
+//  main.cpp
+//  tools/fbx-benchmark/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+// Times loading an FBX file with the in place reader against the QDataStream one it replaced, and compares
+// their peak memory.  Each reader runs in its own process so the peaks don't mix.
+//
+//   fbx-benchmark [-n iterations] model.fbx
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+
+#include <QtCore/QBuffer>
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDebug>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QProcess>
+#include <QtCore/QTextStream>
+
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#include <Psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include <FBXReader.h>
+#include <SharedUtil.h>
+
+#include "LegacyFBXReader.h"
+
+static const QString LEGACY_READER = "legacy";
+static const QString STREAMING_READER = "streaming";
+
+static quint64 getPeakMemoryUsage() {
+#if defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS counters;
+    GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+    return counters.PeakWorkingSetSize;
+#else
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#if defined(Q_OS_MAC)
+    return usage.ru_maxrss;
+#else
+    return (quint64)usage.ru_maxrss * 1024;
+#endif
+#endif
+}
+
+static FBXNode parse(const QString& reader, const QString& filename) {
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly)) {
+        throw QString("failed to open ") + filename;
+    }
+    if (reader == LEGACY_READER) {
+        // Models used to come in as a whole byte array
+        QByteArray data = file.readAll();
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::ReadOnly);
+        return legacy::parseFBX(&buffer);
+    }
+    return FBXReader::parseFBX(&file);
+}
+
+static FBXGeometry* load(const QString& reader, const QString& filename) {
+    if (reader == LEGACY_READER) {
+        FBXReader fbxReader;
+        fbxReader._rootNode = parse(reader, filename);
+        return fbxReader.extractFBXGeometry(QVariantHash(), filename);
+    }
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly)) {
+        throw QString("failed to open ") + filename;
+    }
+    return readFBX(&file, QVariantHash(), filename);
+}
+
+// Prints the best parse and load times in msecs and the growth of the peak memory in bytes
+static int runReader(const QString& reader, const QString& filename, int iterations) {
+    quint64 baseline = getPeakMemoryUsage();
+    qint64 bestParse = std::numeric_limits<qint64>::max();
+    qint64 bestLoad = std::numeric_limits<qint64>::max();
+    int meshCount = 0;
+
+    try {
+        for (int i = 0; i < iterations; i++) {
+            QElapsedTimer timer;
+            timer.start();
+            {
+                FBXNode root = parse(reader, filename);
+            }
+            bestParse = std::min(bestParse, timer.nsecsElapsed());
+
+            timer.restart();
+            std::unique_ptr<FBXGeometry> geometry(load(reader, filename));
+            bestLoad = std::min(bestLoad, timer.nsecsElapsed());
+            meshCount = geometry->meshes.size();
+        }
+    } catch (const QString& error) {
+        QTextStream(stderr) << reader << ": " << error << endl;
+        return 1;
+    }
+
+    QTextStream(stdout) << bestParse / 1.0e6 << " " << bestLoad / 1.0e6 << " " << (getPeakMemoryUsage() - baseline) << " "
+        << meshCount << endl;
+    return 0;
+}
+
+static bool runChild(const QString& reader, const QString& filename, int iterations, QStringList& results) {
+    QProcess child;
+    child.setProcessChannelMode(QProcess::ForwardedErrorChannel);
+    child.start(QCoreApplication::applicationFilePath(),
+        { "--reader", reader, "-n", QString::number(iterations), filename });
+    if (!child.waitForFinished(-1) || child.exitCode() != 0) {
+        return false;
+    }
+    results = QString(child.readAllStandardOutput()).trimmed().split(' ');
+    return results.size() == 4;
+}
+
+int main(int argc, char* argv[]) {
+    setupHifiApplication("FBX Benchmark");
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("High Fidelity FBX Reader Benchmark");
+    parser.addHelpOption();
+    const QCommandLineOption iterationsOption("n", "number of loads to take the best time of", "iterations", "5");
+    parser.addOption(iterationsOption);
+    const QCommandLineOption readerOption("reader", "run a single reader: legacy or streaming", "reader");
+    parser.addOption(readerOption);
+    parser.addPositionalArgument("file", "binary or text fbx file");
+    parser.process(app);
+
+    if (parser.positionalArguments().size() != 1) {
+        parser.showHelp(1);
+    }
+    QString filename = parser.positionalArguments().first();
+    int iterations = std::max(parser.value(iterationsOption).toInt(), 1);
+
+    if (parser.isSet(readerOption)) {
+        return runReader(parser.value(readerOption), filename, iterations);
+    }
+
+    QStringList legacyResults;
+    QStringList streamingResults;
+    if (!runChild(LEGACY_READER, filename, iterations, legacyResults) ||
+        !runChild(STREAMING_READER, filename, iterations, streamingResults)) {
+        qCritical() << "Failed to benchmark" << filename;
+        return 2;
+    }
+
+    QTextStream out(stdout);
+    out << filename << " (" << QFile(filename).size() / 1024 << " KB, " << legacyResults[3] << " meshes, best of "
+        << iterations << ")" << endl;
+    out << qSetFieldWidth(12) << "" << "parse ms" << "load ms" << "peak KB" << qSetFieldWidth(0) << endl;
+    auto printRow = [&](const QString& name, const QStringList& results) {
+        out << qSetFieldWidth(12) << name << results[0] << results[1] << results[2].toULongLong() / 1024
+            << qSetFieldWidth(0) << endl;
+    };
+    printRow(LEGACY_READER, legacyResults);
+    printRow(STREAMING_READER, streamingResults);
+    return 0;
+}
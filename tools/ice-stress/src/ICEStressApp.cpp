@@ -0,0 +1,326 @@
+//
+//  ICEStressApp.cpp
+//  tools/ice-stress/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ICEStressApp.h"
+
+#include <openssl/err.h>
+#include <openssl/rsa.h>
+#include <openssl/x509.h>
+
+#include <QCommandLineParser>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLoggingCategory>
+#include <QRegExp>
+
+#include <HTTPConnection.h>
+#include <NLPacket.h>
+#include <NetworkLogging.h>
+
+static const int SEND_INTERVAL_MSECS = 10;
+static const int STATS_INTERVAL_MSECS = 1000;
+
+static const quint16 METAVERSE_STUB_DEFAULT_PORT = 40190;
+
+// same keys as the domain-server makes, see RSAKeypairGenerator
+static const int RSA_KEY_BITS = 2048;
+static const unsigned long RSA_KEY_EXPONENT = 65537;
+
+static RSA* generateKeypair() {
+    RSA* keypair = RSA_new();
+    BIGNUM* exponent = BN_new();
+    BN_set_word(exponent, RSA_KEY_EXPONENT);
+
+    if (!RSA_generate_key_ex(keypair, RSA_KEY_BITS, exponent, NULL)) {
+        qCritical() << "Error generating 2048-bit RSA Keypair -" << ERR_get_error();
+        RSA_free(keypair);
+        keypair = nullptr;
+    }
+
+    BN_free(exponent);
+    return keypair;
+}
+
+// the public key as the metaverse API hands it to the ice-server
+static QByteArray getPublicKey(RSA* keypair) {
+    unsigned char* publicKeyDER = NULL;
+    int publicKeyLength = i2d_RSA_PUBKEY(keypair, &publicKeyDER);
+    if (publicKeyLength <= 0) {
+        return QByteArray();
+    }
+
+    QByteArray publicKey { reinterpret_cast<char*>(publicKeyDER), publicKeyLength };
+    OPENSSL_free(publicKeyDER);
+    return publicKey;
+}
+
+// signs the heartbeat the way DataServerAccountInfo::signPlaintext does for the domain-server
+static QByteArray signPlaintext(RSA* keypair, const QByteArray& plaintext) {
+    QByteArray hashedPlaintext = QCryptographicHash::hash(plaintext, QCryptographicHash::Sha256);
+
+    QByteArray signature(RSA_size(keypair), 0);
+    unsigned int signatureBytes = 0;
+    if (!RSA_sign(NID_sha256,
+                  reinterpret_cast<const unsigned char*>(hashedPlaintext.constData()),
+                  hashedPlaintext.size(),
+                  reinterpret_cast<unsigned char*>(signature.data()),
+                  &signatureBytes,
+                  keypair)) {
+        return QByteArray();
+    }
+
+    signature.resize(signatureBytes);
+    return signature;
+}
+
+ICEStressApp::ICEStressApp(int argc, char* argv[]) :
+    QCoreApplication(argc, argv)
+{
+    // parse command-line
+    QCommandLineParser parser;
+    parser.setApplicationDescription("High Fidelity ICE server stress test");
+
+    const QCommandLineOption helpOption = parser.addHelpOption();
+
+    const QCommandLineOption iceServerAddressOption("i", "ice-server address", "IP:PORT or HOSTNAME:PORT");
+    parser.addOption(iceServerAddressOption);
+
+    const QCommandLineOption numPeersOption("p", "number of simulated heartbeating peers", "1000");
+    parser.addOption(numPeersOption);
+
+    const QCommandLineOption heartbeatIntervalOption("r", "heartbeat interval per peer in milliseconds", "1000");
+    parser.addOption(heartbeatIntervalOption);
+
+    const QCommandLineOption durationOption("t", "test duration in seconds", "30");
+    parser.addOption(durationOption);
+
+    const QCommandLineOption queryOption("q", "also send an ICE query for every heartbeating peer");
+    parser.addOption(queryOption);
+
+    const QCommandLineOption numKeypairsOption("k", "number of keypairs the peers sign their heartbeats with", "16");
+    parser.addOption(numKeypairsOption);
+
+    const QCommandLineOption metaverseStubPortOption("a", "port the public keys are served on, "
+        "start the ice-server with HIFI_METAVERSE_URL=http://<this host>:<port>", QString::number(METAVERSE_STUB_DEFAULT_PORT));
+    parser.addOption(metaverseStubPortOption);
+
+    if (!parser.parse(QCoreApplication::arguments())) {
+        qCritical() << parser.errorText() << endl;
+        parser.showHelp();
+        Q_UNREACHABLE();
+    }
+
+    if (parser.isSet(helpOption)) {
+        parser.showHelp();
+        Q_UNREACHABLE();
+    }
+
+    // the networking library is very chatty at debug level, which would drown out the stats
+    const_cast<QLoggingCategory*>(&networking())->setEnabled(QtDebugMsg, false);
+    const_cast<QLoggingCategory*>(&networking())->setEnabled(QtInfoMsg, false);
+
+    int numPeers = parser.isSet(numPeersOption) ? parser.value(numPeersOption).toInt() : 1000;
+    if (parser.isSet(heartbeatIntervalOption)) {
+        _heartbeatIntervalMsecs = std::max(parser.value(heartbeatIntervalOption).toInt(), SEND_INTERVAL_MSECS);
+    }
+    if (parser.isSet(durationOption)) {
+        _durationSecs = parser.value(durationOption).toInt();
+    }
+    _sendQueries = parser.isSet(queryOption);
+    int numKeypairs = parser.isSet(numKeypairsOption) ? std::max(parser.value(numKeypairsOption).toInt(), 1) : 16;
+    quint16 metaverseStubPort = parser.isSet(metaverseStubPortOption)
+        ? (quint16)parser.value(metaverseStubPortOption).toUInt() : METAVERSE_STUB_DEFAULT_PORT;
+
+    _iceServerAddr = HifiSockAddr("127.0.0.1", ICE_SERVER_DEFAULT_PORT);
+    if (parser.isSet(iceServerAddressOption)) {
+        // parse the IP and port combination for this target
+        QString hostnamePortString = parser.value(iceServerAddressOption);
+
+        QHostAddress address { hostnamePortString.left(hostnamePortString.indexOf(':')) };
+        quint16 port { (quint16) hostnamePortString.mid(hostnamePortString.indexOf(':') + 1).toUInt() };
+        if (port == 0) {
+            port = ICE_SERVER_DEFAULT_PORT;
+        }
+
+        if (address.isNull()) {
+            qCritical() << "Could not parse an IP address and port combination from" << hostnamePortString << "-" <<
+                "The parsed IP was" << address.toString() << "and the parsed port was" << port;
+
+            QMetaObject::invokeMethod(this, "quit", Qt::QueuedConnection);
+            return;
+        } else {
+            _iceServerAddr = HifiSockAddr(address, port);
+        }
+    }
+
+    _socket.bind(QHostAddress::AnyIPv4, 0);
+    _socket.setPacketHandler([this](std::unique_ptr<udt::Packet> packet) { processPacket(std::move(packet)); });
+    _localSockAddr = HifiSockAddr("127.0.0.1", _socket.localPort());
+
+    // keypair generation is slow, so peers share a few keypairs - the ice-server still fetches a key per peer
+    qDebug() << "Generating" << numKeypairs << "keypairs";
+    std::vector<RSA*> keypairs;
+    for (int i = 0; i < numKeypairs; ++i) {
+        RSA* keypair = generateKeypair();
+        if (!keypair) {
+            for (RSA* generatedKeypair : keypairs) {
+                RSA_free(generatedKeypair);
+            }
+            QMetaObject::invokeMethod(this, "quit", Qt::QueuedConnection);
+            return;
+        }
+        keypairs.push_back(keypair);
+        _publicKeys.push_back(getPublicKey(keypair));
+    }
+
+    // a domain-server signs its heartbeat once and resends it until its sockets change, so do the same here
+    _peerIDs.reserve(numPeers);
+    _signedHeartbeats.reserve(numPeers);
+    for (int i = 0; i < numPeers; ++i) {
+        QUuid peerID = QUuid::createUuid();
+        int keypairIndex = i % numKeypairs;
+
+        QByteArray heartbeat;
+        QDataStream heartbeatStream(&heartbeat, QIODevice::WriteOnly);
+        heartbeatStream << peerID << _localSockAddr << _localSockAddr;
+        heartbeatStream << signPlaintext(keypairs[keypairIndex], heartbeat);
+
+        _peerIDs.push_back(peerID);
+        _signedHeartbeats.push_back(heartbeat);
+        _peerKeypairs.insert(peerID, keypairIndex);
+    }
+
+    for (RSA* keypair : keypairs) {
+        RSA_free(keypair);
+    }
+
+    _metaverseStub = new HTTPManager(QHostAddress::AnyIPv4, metaverseStubPort, QString(), this, this);
+
+    qDebug() << "Simulating" << numPeers << "peers heartbeating every" << _heartbeatIntervalMsecs
+        << "ms against" << _iceServerAddr << "for" << _durationSecs << "seconds";
+    qDebug() << "Serving their public keys on port" << metaverseStubPort
+        << "- the ice-server must run with HIFI_METAVERSE_URL pointing there";
+
+    connect(&_sendTimer, &QTimer::timeout, this, &ICEStressApp::sendDueHeartbeats);
+    _sendTimer.start(SEND_INTERVAL_MSECS);
+
+    connect(&_statsTimer, &QTimer::timeout, this, &ICEStressApp::reportStats);
+    _statsTimer.start(STATS_INTERVAL_MSECS);
+
+    _runTimer.start();
+}
+
+void ICEStressApp::sendDueHeartbeats() {
+    if (_peerIDs.isEmpty()) {
+        return;
+    }
+
+    // spread the heartbeats of all peers evenly over the heartbeat interval
+    int peersPerSend = std::max(1, (_peerIDs.size() * SEND_INTERVAL_MSECS) / _heartbeatIntervalMsecs);
+
+    for (int i = 0; i < peersPerSend; ++i) {
+        sendHeartbeat(_nextPeer);
+
+        if (_sendQueries) {
+            sendQuery(_peerIDs[_nextPeer]);
+        }
+
+        _nextPeer = (_nextPeer + 1) % _peerIDs.size();
+    }
+}
+
+void ICEStressApp::sendHeartbeat(int peerIndex) {
+    const QByteArray& heartbeat = _signedHeartbeats[peerIndex];
+
+    auto heartbeatPacket = NLPacket::create(PacketType::ICEServerHeartbeat, heartbeat.size());
+    heartbeatPacket->write(heartbeat);
+
+    _socket.writePacket(*heartbeatPacket, _iceServerAddr);
+    ++_heartbeatsSent;
+}
+
+void ICEStressApp::sendQuery(const QUuid& peerID) {
+    auto queryPacket = NLPacket::create(PacketType::ICEServerQuery);
+
+    QDataStream queryStream(queryPacket.get());
+    queryStream << QUuid::createUuid() << _localSockAddr << _localSockAddr << peerID;
+
+    _socket.writePacket(*queryPacket, _iceServerAddr);
+    ++_queriesSent;
+}
+
+bool ICEStressApp::handleHTTPRequest(HTTPConnection* connection, const QUrl& url, bool skipSubHandler) {
+    // answers /api/v1/domains/<domain ID>/public_key like the metaverse API, for the simulated peers only
+    QRegExp PUBLIC_KEY_REGEX { "^/api/v1/domains/([^/]+)/public_key$" };
+
+    if (connection->requestOperation() == QNetworkAccessManager::GetOperation
+        && PUBLIC_KEY_REGEX.indexIn(url.path()) != -1) {
+        QUuid peerID { PUBLIC_KEY_REGEX.cap(1) };
+
+        auto it = _peerKeypairs.find(peerID);
+        if (it != _peerKeypairs.end()) {
+            QJsonObject dataObject;
+            dataObject["public_key"] = QString(_publicKeys[it.value()].toBase64());
+
+            QJsonObject responseObject;
+            responseObject["status"] = "success";
+            responseObject["data"] = dataObject;
+
+            connection->respond(HTTPConnection::StatusCode200, QJsonDocument(responseObject).toJson(),
+                                "application/json");
+            return true;
+        }
+    }
+
+    connection->respond(HTTPConnection::StatusCode404);
+    return true;
+}
+
+void ICEStressApp::processPacket(std::unique_ptr<udt::Packet> packet) {
+    auto nlPacket = NLPacket::fromBase(std::move(packet));
+
+    switch (nlPacket->getType()) {
+        case PacketType::ICEServerHeartbeatACK:
+            ++_acksReceived;
+            break;
+        case PacketType::ICEServerHeartbeatDenied:
+            ++_denialsReceived;
+            break;
+        case PacketType::ICEServerPeerInformation:
+            ++_peerInformationReceived;
+            break;
+        default:
+            break;
+    }
+}
+
+void ICEStressApp::reportStats() {
+    quint64 responses = _acksReceived + _denialsReceived + _peerInformationReceived;
+    double elapsedSecs = _runTimer.elapsed() / 1000.0;
+
+    qDebug() << qPrintable(QString("%1s | sent %2 heartbeats %3 queries | received %4 ACK %5 denied %6 peer info | %7 responses/s")
+        .arg(elapsedSecs, 0, 'f', 1)
+        .arg(_heartbeatsSent).arg(_queriesSent)
+        .arg(_acksReceived).arg(_denialsReceived).arg(_peerInformationReceived)
+        .arg(responses - _responsesAtLastReport));
+
+    _responsesAtLastReport = responses;
+
+    if (elapsedSecs >= _durationSecs) {
+        quint64 sent = _heartbeatsSent + _queriesSent;
+        qDebug() << "Sent" << sent << "packets, received" << responses << "responses -"
+            << qPrintable(QString::number(sent > 0 ? (100.0 * responses) / sent : 0.0, 'f', 1)) << "% answered,"
+            << qPrintable(QString::number(responses / elapsedSecs, 'f', 1)) << "responses/s";
+
+        QMetaObject::invokeMethod(this, "quit", Qt::QueuedConnection);
+    }
+}
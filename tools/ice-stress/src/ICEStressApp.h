@@ -0,0 +1,74 @@
+//
+//  ICEStressApp.h
+//  tools/ice-stress/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+
+#ifndef hifi_ICEStressApp_h
+#define hifi_ICEStressApp_h
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QTimer>
+#include <QUuid>
+#include <QVector>
+
+#include <HTTPManager.h>
+#include <udt/Constants.h>
+#include <udt/Socket.h>
+#include <NetworkPeer.h>
+
+// Simulates thousands of heartbeating domain-servers (and optionally clients querying for them) against
+// an ice-server, and reports how many heartbeats and queries the ice-server answered per second.
+// The heartbeats are signed with keypairs generated here, and the public keys are served to the ice-server
+// by a stand-in for the metaverse API that the ice-server is pointed at with HIFI_METAVERSE_URL.
+class ICEStressApp : public QCoreApplication, public HTTPRequestHandler {
+    Q_OBJECT
+public:
+    ICEStressApp(int argc, char* argv[]);
+
+    bool handleHTTPRequest(HTTPConnection* connection, const QUrl& url, bool skipSubHandler = false) override;
+
+private slots:
+    void sendDueHeartbeats();
+    void reportStats();
+
+private:
+    void sendHeartbeat(int peerIndex);
+    void sendQuery(const QUuid& peerID);
+    void processPacket(std::unique_ptr<udt::Packet> packet);
+
+    HifiSockAddr _iceServerAddr;
+    HifiSockAddr _localSockAddr;
+    udt::Socket _socket { nullptr, false };
+
+    QVector<QUuid> _peerIDs;
+    QVector<QByteArray> _signedHeartbeats;
+    QHash<QUuid, int> _peerKeypairs;
+    QVector<QByteArray> _publicKeys;
+    HTTPManager* _metaverseStub { nullptr };
+
+    int _nextPeer { 0 };
+    int _heartbeatIntervalMsecs { 1000 };
+    int _durationSecs { 30 };
+    bool _sendQueries { false };
+
+    QTimer _sendTimer;
+    QTimer _statsTimer;
+    QElapsedTimer _runTimer;
+
+    quint64 _heartbeatsSent { 0 };
+    quint64 _queriesSent { 0 };
+    quint64 _acksReceived { 0 };
+    quint64 _denialsReceived { 0 };
+    quint64 _peerInformationReceived { 0 };
+    quint64 _responsesAtLastReport { 0 };
+};
+
+#endif //hifi_ICEStressApp_h
@@ -0,0 +1,19 @@
+//
+//  main.cpp
+//  tools/ice-stress/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+
+#include <SharedUtil.h>
+
+#include "ICEStressApp.h"
+
+int main(int argc, char * argv[]) {
+    setupHifiApplication("ICE Stress");
+
+    ICEStressApp app(argc, argv);
+    return app.exec();
+}
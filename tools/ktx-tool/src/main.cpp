@@ -16,6 +16,8 @@
 #include <QtCore/QLoggingCategory>
 
 #include <QtCore/QResource>
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QCoreApplication>
 
 #include <QtGui/QResizeEvent>
 #include <QtGui/QWindow>
@@ -40,6 +42,7 @@
 #include <gpu/Texture.h>
 
 #include <ktx/KTX.h>
+#include <image/Image.h>
 
 
 
@@ -108,8 +111,72 @@ void scanDir(const QDir& dir) {
     }
 }
 
+// Bakes every image as each texture type once per thread count, the timings show how well compression scales
+void benchmarkTextureProcessing(const QStringList& imageFiles, const QList<int>& threadCounts) {
+    image::setColorTexturesCompressionEnabled(true);
+    image::setGrayscaleTexturesCompressionEnabled(true);
+    image::setNormalTexturesCompressionEnabled(true);
+    image::setCubeTexturesCompressionEnabled(true);
+
+    static const std::vector<std::pair<image::TextureUsage::Type, QString>> TEXTURE_TYPES {
+        { image::TextureUsage::ALBEDO_TEXTURE, "albedo" },
+        { image::TextureUsage::NORMAL_TEXTURE, "normal" },
+        { image::TextureUsage::ROUGHNESS_TEXTURE, "roughness" },
+        { image::TextureUsage::CUBE_TEXTURE, "cube" },
+    };
+
+    for (const auto& imageFile : imageFiles) {
+        QFile file(imageFile);
+        if (!file.open(QIODevice::ReadOnly)) {
+            qWarning() << "Unable to read" << imageFile;
+            continue;
+        }
+        const QByteArray content = file.readAll();
+        qDebug() << imageFile;
+
+        for (const auto& textureType : TEXTURE_TYPES) {
+            QString timings;
+            for (int threadCount : threadCounts) {
+                image::setTextureProcessingThreadCount(threadCount);
+                QByteArray copy = content;
+                QElapsedTimer timer;
+                timer.start();
+                auto texture = image::processImage(std::move(copy), imageFile.toStdString(), ABSOLUTE_MAX_TEXTURE_NUM_PIXELS,
+                                                   textureType.first);
+                auto elapsed = timer.nsecsElapsed() / NSECS_PER_MSEC;
+                if (!texture) {
+                    timings = "failed";
+                    break;
+                }
+                timings += QString(" %1 threads: %2 ms").arg(threadCount).arg(elapsed);
+            }
+            qDebug().noquote() << "   " << textureType.second.leftJustified(10) << timings;
+        }
+    }
+}
+
 int main(int argc, char** argv) {
     qInstallMessageHandler(messageHandler);
+
+    QCoreApplication app(argc, argv);
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    const QCommandLineOption benchmarkOption("benchmark", "bake the given images as each texture type and report the time taken");
+    parser.addOption(benchmarkOption);
+    const QCommandLineOption threadsOption("threads", "comma separated thread counts to benchmark with", "counts", "1,2,4,8");
+    parser.addOption(threadsOption);
+    parser.addPositionalArgument("images", "images to benchmark with");
+    parser.process(app);
+
+    if (parser.isSet(benchmarkOption)) {
+        QList<int> threadCounts;
+        for (const auto& count : parser.value(threadsOption).split(',', QString::SkipEmptyParts)) {
+            threadCounts.push_back(std::max(count.toInt(), 1));
+        }
+        benchmarkTextureProcessing(parser.positionalArguments(), threadCounts);
+        return 0;
+    }
+
     {
         QDir destFolder(DEST_FOLDER);
         if (!destFolder.exists() && !destFolder.mkpath(".")) {
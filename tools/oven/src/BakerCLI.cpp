@@ -18,6 +18,7 @@
 
 #include "OvenCLIApplication.h"
 #include "ModelBakingLoggingCategory.h"
+#include "DomainBaker.h"
 #include "FBXBaker.h"
 #include "JSBaker.h"
 #include "TextureBaker.h"
@@ -26,7 +27,7 @@ BakerCLI::BakerCLI(OvenCLIApplication* parent) : QObject(parent) {
     
 }
 
-void BakerCLI::bakeFile(QUrl inputUrl, const QString& outputPath, const QString& type) {
+void BakerCLI::bakeFile(QUrl inputUrl, const QString& outputPath, const QString& type, const QString& destinationPath) {
 
     // if the URL doesn't have a scheme, assume it is a local file
     if (inputUrl.scheme() != "http" && inputUrl.scheme() != "https" && inputUrl.scheme() != "ftp") {
@@ -37,6 +38,7 @@ void BakerCLI::bakeFile(QUrl inputUrl, const QString& outputPath, const QString&
 
     static const QString MODEL_EXTENSION { "fbx" };
     static const QString SCRIPT_EXTENSION { "js" };
+    static const QString DOMAIN_TYPE { "domain" };
 
     QString extension = type;
 
@@ -48,6 +50,7 @@ void BakerCLI::bakeFile(QUrl inputUrl, const QString& outputPath, const QString&
     // check what kind of baker we should be creating
     bool isFBX = extension == MODEL_EXTENSION;
     bool isScript = extension == SCRIPT_EXTENSION;
+    bool isDomain = extension == DOMAIN_TYPE;
 
     bool isSupportedImage = QImageReader::supportedImageFormats().contains(extension.toLatin1());
 
@@ -64,6 +67,10 @@ void BakerCLI::bakeFile(QUrl inputUrl, const QString& outputPath, const QString&
     } else if (isScript) {
         _baker = std::unique_ptr<Baker> { new JSBaker(inputUrl, outputPath) };
         _baker->moveToThread(Oven::instance().getNextWorkerThread());
+    } else if (isDomain) {
+        // an entities file, baked to a timestamped folder in the output path beside the bake cache of earlier bakes
+        _baker = std::unique_ptr<Baker> { new DomainBaker(inputUrl, QString(), outputPath, destinationPath) };
+        _baker->moveToThread(Oven::instance().getNextWorkerThread());
     } else if (isSupportedImage) {
         _baker = std::unique_ptr<Baker> { new TextureBaker(inputUrl, image::TextureUsage::CUBE_TEXTURE, outputPath) };
         _baker->moveToThread(Oven::instance().getNextWorkerThread());
@@ -34,7 +34,8 @@ public:
     BakerCLI(OvenCLIApplication* parent);
 
 public slots:
-    void bakeFile(QUrl inputUrl, const QString& outputPath, const QString& type = QString::null);
+    void bakeFile(QUrl inputUrl, const QString& outputPath, const QString& type = QString::null,
+                  const QString& destinationPath = QString::null);
 
 private slots:
     void handleFinishedBaker();  
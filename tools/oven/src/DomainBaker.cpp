@@ -12,6 +12,8 @@
 #include "DomainBaker.h"
 
 #include <QtConcurrent>
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDirIterator>
 #include <QtCore/QEventLoop>
 #include <QtCore/QFile>
 #include <QtCore/QFileInfo>
@@ -40,6 +42,8 @@ DomainBaker::DomainBaker(const QUrl& localModelFileURL, const QString& domainNam
 }
 
 void DomainBaker::bake() {
+    _bakeTimer.start();
+
     setupOutputFolder();
 
     if (hasErrors()) {
@@ -52,12 +56,16 @@ void DomainBaker::bake() {
         return;
     }
 
+    loadBakeCache();
+
     enumerateEntities();
 
     if (hasErrors()) {
         return;
     }
 
+    startQueuedBakes();
+
     // in case we've baked and re-written all of our entities already, check if we're done
     checkIfRewritingComplete();
 }
@@ -95,6 +103,10 @@ void DomainBaker::setupOutputFolder() {
     }
 
     _contentOutputPath = outputDir.absoluteFilePath(CONTENT_OUTPUT_FOLDER_NAME);
+
+    // the bake cache is kept beside the timestamped folders, so the next bake to the same output path finds it
+    static const QString BAKE_CACHE_FILE_NAME = "bake-cache.json";
+    _bakeCacheFilePath = QDir(_baseOutputPath).absoluteFilePath(domainPrefix + BAKE_CACHE_FILE_NAME);
 }
 
 const QString ENTITIES_OBJECT_KEY = "Entities";
@@ -194,46 +206,19 @@ void DomainBaker::enumerateEntities() {
                         modelURL = modelURL.adjusted(QUrl::RemoveQuery | QUrl::RemoveFragment);
                     }
 
-                    // setup a ModelBaker for this URL, as long as we don't already have one
-                    if (!_modelBakers.contains(modelURL)) {
+                    // queue a bake for this URL, as long as we don't already have one
+                    // (entities stay in the multi hash until their model is baked)
+                    if (!_entitiesNeedingRewrite.contains(modelURL)) {
                         auto filename = modelURL.fileName();
                         auto baseName = filename.left(filename.lastIndexOf('.'));
                         auto subDirName = "/" + baseName;
                         int i = 1;
-                        while (QDir(_contentOutputPath + subDirName).exists()) {
+                        while (_modelSubDirectories.contains(subDirName) || QDir(_contentOutputPath + subDirName).exists()) {
                             subDirName = "/" + baseName + "-" + QString::number(i++);
                         }
+                        _modelSubDirectories.insert(subDirName);
 
-                        QSharedPointer<ModelBaker> baker;
-                        if (isBakeableFBX) {
-                            baker = {
-                                new FBXBaker(modelURL, []() -> QThread* {
-                                    return Oven::instance().getNextWorkerThread();
-                                }, _contentOutputPath + subDirName + "/baked", _contentOutputPath + subDirName + "/original"),
-                                &FBXBaker::deleteLater
-                            };
-                        } else {
-                            baker = {
-                                new OBJBaker(modelURL, []() -> QThread* {
-                                    return Oven::instance().getNextWorkerThread();
-                                }, _contentOutputPath + subDirName + "/baked", _contentOutputPath + subDirName + "/original"),
-                                &OBJBaker::deleteLater
-                            };
-                        }
-
-                        // make sure our handler is called when the baker is done
-                        connect(baker.data(), &Baker::finished, this, &DomainBaker::handleFinishedModelBaker);
-
-                        // insert it into our bakers hash so we hold a strong pointer to it
-                        _modelBakers.insert(modelURL, baker);
-
-                        // move the baker to the baker thread
-                        // and kickoff the bake
-                        baker->moveToThread(Oven::instance().getNextWorkerThread());
-                        QMetaObject::invokeMethod(baker.data(), "bake");
-
-                        // keep track of the total number of baking entities
-                        ++_totalNumberOfSubBakes;
+                        queueBake(modelURL, isBakeableFBX ? FBX_MODEL : OBJ_MODEL, subDirName);
                     }
 
                     // add this QJsonValueRef to our multi hash so that we can easily re-write
@@ -284,125 +269,351 @@ void DomainBaker::bakeSkybox(QUrl skyboxURL, QJsonValueRef entity) {
         // grab a clean version of the URL without a query or fragment
         skyboxURL = skyboxURL.adjusted(QUrl::RemoveQuery | QUrl::RemoveFragment);
 
-        // setup a texture baker for this URL, as long as we aren't baking a skybox already
-        if (!_skyboxBakers.contains(skyboxURL)) {
-            // setup a baker for this skybox
+        // queue a texture bake for this URL, as long as we aren't baking a skybox already
+        if (!_entitiesNeedingRewrite.contains(skyboxURL)) {
+            queueBake(skyboxURL, SKYBOX);
+        }
+
+        // add this QJsonValueRef to our multi hash so that it can re-write the skybox URL
+        // to the baked version once the baker is complete
+        _entitiesNeedingRewrite.insert(skyboxURL, entity);
+    }
+}
 
+void DomainBaker::queueBake(const QUrl& url, AssetType type, const QString& subDirectory) {
+    AssetBake bake;
+    bake.url = url;
+    bake.type = type;
+    bake.subDirectory = subDirectory;
+    bake.timer.start();
+    _queuedBakes.append(bake);
+
+    // keep track of the total number of baking entities
+    ++_totalNumberOfSubBakes;
+}
+
+void DomainBaker::startQueuedBakes() {
+    // bakes are started in the order their entities came in, each model bake starting its own texture bakes
+    while (!_queuedBakes.isEmpty() && _runningBakes.size() < _maxConcurrentBakes) {
+        auto bake = _queuedBakes.takeFirst();
+        bake.waitMsecs = bake.timer.restart();
+
+        if (bake.type == SKYBOX) {
             QSharedPointer<TextureBaker> skyboxBaker {
-                new TextureBaker(skyboxURL, image::TextureUsage::CUBE_TEXTURE, _contentOutputPath),
+                new TextureBaker(bake.url, image::TextureUsage::CUBE_TEXTURE, _contentOutputPath),
                 &TextureBaker::deleteLater
             };
 
             // make sure our handler is called when the skybox baker is done
             connect(skyboxBaker.data(), &TextureBaker::finished, this, &DomainBaker::handleFinishedSkyboxBaker);
+            bake.baker = skyboxBaker;
+        } else {
+            bake.sourceHash = hashLocalFile(bake.url);
+            if (reuseCachedModelBake(bake)) {
+                continue;
+            }
 
-            // insert it into our bakers hash so we hold a strong pointer to it
-            _skyboxBakers.insert(skyboxURL, skyboxBaker);
+            auto outputPath = _contentOutputPath + bake.subDirectory;
+            QSharedPointer<ModelBaker> baker;
+            if (bake.type == FBX_MODEL) {
+                baker = {
+                    new FBXBaker(bake.url, []() -> QThread* {
+                        return Oven::instance().getNextWorkerThread();
+                    }, outputPath + "/baked", outputPath + "/original"),
+                    &FBXBaker::deleteLater
+                };
+            } else {
+                baker = {
+                    new OBJBaker(bake.url, []() -> QThread* {
+                        return Oven::instance().getNextWorkerThread();
+                    }, outputPath + "/baked", outputPath + "/original"),
+                    &OBJBaker::deleteLater
+                };
+            }
 
-            // move the baker to a worker thread and kickoff the bake
-            skyboxBaker->moveToThread(Oven::instance().getNextWorkerThread());
-            QMetaObject::invokeMethod(skyboxBaker.data(), "bake");
+            // textures referenced by several models are only baked once
+            baker->setTextureBakeCache(_textureBakeCache);
 
-            // keep track of the total number of baking entities
-            ++_totalNumberOfSubBakes;
+            // make sure our handler is called when the baker is done
+            connect(baker.data(), &Baker::finished, this, &DomainBaker::handleFinishedModelBaker);
+            bake.baker = baker;
         }
 
-        // add this QJsonValueRef to our multi hash so that it can re-write the skybox URL
-        // to the baked version once the baker is complete
-        _entitiesNeedingRewrite.insert(skyboxURL, entity);
+        // hold a strong pointer to the baker until it's done
+        _runningBakes.insert(bake.baker.data(), bake);
+
+        // move the baker to a worker thread and kickoff the bake
+        bake.baker->moveToThread(Oven::instance().getNextWorkerThread());
+        QMetaObject::invokeMethod(bake.baker.data(), "bake");
     }
 }
 
-void DomainBaker::handleFinishedModelBaker() {
-    auto baker = qobject_cast<ModelBaker*>(sender());
+void DomainBaker::reportBake(const AssetBake& bake, const QString& status) {
+    static const QStringList ASSET_TYPE_NAMES { "fbx", "obj", "skybox" };
+
+    QJsonObject asset;
+    asset["url"] = bake.url.toString();
+    asset["type"] = ASSET_TYPE_NAMES[bake.type];
+    asset["status"] = status;
+    asset["waitMsecs"] = (double)bake.waitMsecs;
+    asset["bakeMsecs"] = (double)bake.timer.elapsed();
+    if (!bake.sourceHash.isEmpty()) {
+        asset["sourceHash"] = bake.sourceHash;
+    }
+    if (bake.baker) {
+        if (auto modelBaker = qobject_cast<ModelBaker*>(bake.baker.data())) {
+            asset["textures"] = modelBaker->getTextureURLs().size();
+        }
+        if (bake.baker->hasErrors()) {
+            asset["errors"] = QJsonArray::fromStringList(bake.baker->getErrors());
+        }
+        if (bake.baker->hasWarnings()) {
+            asset["warnings"] = QJsonArray::fromStringList(bake.baker->getWarnings());
+        }
+    }
+    _bakeReport.append(asset);
+}
 
-    if (baker) {
-        if (!baker->hasErrors()) {
-            // this FBXBaker is done and everything went according to plan
-            qDebug() << "Re-writing entity references to" << baker->getModelURL();
+QString DomainBaker::hashLocalFile(const QUrl& url) {
+    // remote files aren't hashed, what's behind a URL can change without us knowing
+    if (!url.isLocalFile()) {
+        return QString();
+    }
 
-            // enumerate the QJsonRef values for the URL of this FBX from our multi hash of
-            // entity objects needing a URL re-write
-            for (QJsonValueRef entityValue : _entitiesNeedingRewrite.values(baker->getModelURL())) {
+    auto filePath = url.toLocalFile();
+    auto it = _fileHashes.find(filePath);
+    if (it != _fileHashes.end()) {
+        return it.value();
+    }
 
-                // convert the entity QJsonValueRef to a QJsonObject so we can modify its URL
-                auto entity = entityValue.toObject();
+    QString hash;
+    QFile file { filePath };
+    QCryptographicHash hasher { QCryptographicHash::Sha256 };
+    if (file.open(QIODevice::ReadOnly) && hasher.addData(&file)) {
+        hash = hasher.result().toHex();
+    }
+    _fileHashes.insert(filePath, hash);
+    return hash;
+}
 
-                // grab the old URL
-                QUrl oldModelURL { entity[ENTITY_MODEL_URL_KEY].toString() };
+const QString BAKE_CACHE_MODELS_KEY = "models";
+const QString BAKE_CACHE_VERSION_KEY = "bakeVersion";
+const QString BAKE_CACHE_SOURCE_HASH_KEY = "sourceHash";
+const QString BAKE_CACHE_TEXTURES_KEY = "textures";
+const QString BAKE_CACHE_DIRECTORY_KEY = "directory";
+const QString BAKE_CACHE_BAKED_MODEL_KEY = "bakedModel";
+
+void DomainBaker::loadBakeCache() {
+    QFile bakeCacheFile { _bakeCacheFilePath };
+    if (bakeCacheFile.open(QIODevice::ReadOnly)) {
+        _cachedModelBakes = QJsonDocument::fromJson(bakeCacheFile.readAll()).object()[BAKE_CACHE_MODELS_KEY].toObject();
+        qDebug() << "Loaded" << _cachedModelBakes.size() << "previous model bakes from" << _bakeCacheFilePath;
+    }
+}
 
-                // setup a new URL using the prefix we were passed
-                auto relativeFBXFilePath = baker->getBakedModelFilePath().remove(_contentOutputPath);
-                if (relativeFBXFilePath.startsWith("/")) {
-                    relativeFBXFilePath = relativeFBXFilePath.right(relativeFBXFilePath.length() - 1);
-                }
-                QUrl newModelURL = _destinationPath.resolved(relativeFBXFilePath);
+void DomainBaker::writeBakeCache() {
+    QJsonObject rootObject;
+    rootObject[BAKE_CACHE_MODELS_KEY] = _cachedModelBakes;
 
-                // copy the fragment and query, and user info from the old model URL
-                newModelURL.setQuery(oldModelURL.query());
-                newModelURL.setFragment(oldModelURL.fragment());
-                newModelURL.setUserInfo(oldModelURL.userInfo());
+    QFile bakeCacheFile { _bakeCacheFilePath };
+    if (!bakeCacheFile.open(QIODevice::WriteOnly) || bakeCacheFile.write(QJsonDocument(rootObject).toJson()) == -1) {
+        // the bake itself is fine, the next one just won't be able to reuse it
+        handleWarning("Failed to write bake cache " + _bakeCacheFilePath);
+    }
+}
 
-                // set the new model URL as the value in our temp QJsonObject
-                entity[ENTITY_MODEL_URL_KEY] = newModelURL.toString();
+static bool copyDirectory(const QString& sourcePath, const QString& destinationPath) {
+    QDir sourceDir { sourcePath };
+    QDir destinationDir { destinationPath };
+    if (!destinationDir.mkpath(".")) {
+        return false;
+    }
 
-                // check if the entity also had an animation at the same URL
-                // in which case it should be replaced with our baked model URL too
-                const QString ENTITY_ANIMATION_KEY = "animation";
-                const QString ENTITIY_ANIMATION_URL_KEY = "url";
+    QDirIterator it { sourcePath, QDir::Files | QDir::NoDotAndDotDot, QDirIterator::Subdirectories };
+    while (it.hasNext()) {
+        auto relativePath = sourceDir.relativeFilePath(it.next());
+        if (!destinationDir.mkpath(QFileInfo(relativePath).path()) ||
+            !QFile::copy(it.filePath(), destinationDir.filePath(relativePath))) {
+            return false;
+        }
+    }
+    return true;
+}
 
-                if (entity.contains(ENTITY_ANIMATION_KEY)) {
-                    auto animationObject = entity[ENTITY_ANIMATION_KEY].toObject();
+bool DomainBaker::reuseCachedModelBake(const AssetBake& bake) {
+    auto cachedBake = _cachedModelBakes.value(bake.url.toString()).toObject();
+    if (!_useBakeCache || bake.sourceHash.isEmpty() || cachedBake.isEmpty() ||
+        cachedBake[BAKE_CACHE_VERSION_KEY].toInt() != MODEL_BAKE_VERSION ||
+        cachedBake[BAKE_CACHE_SOURCE_HASH_KEY].toString() != bake.sourceHash) {
+        return false;
+    }
 
-                    if (animationObject.contains(ENTITIY_ANIMATION_URL_KEY)) {
-                        // grab the old animation URL
-                        QUrl oldAnimationURL { animationObject[ENTITIY_ANIMATION_URL_KEY].toString() };
+    auto cachedTextures = cachedBake[BAKE_CACHE_TEXTURES_KEY].toObject();
+    for (auto it = cachedTextures.begin(); it != cachedTextures.end(); ++it) {
+        if (hashLocalFile(QUrl(it.key())) != it.value().toString()) {
+            return false;
+        }
+    }
 
-                        // check if its stripped down version matches our stripped down model URL
-                        if (oldAnimationURL.matches(oldModelURL, QUrl::RemoveQuery | QUrl::RemoveFragment)) {
-                            // the animation URL matched the old model URL, so make the animation URL point to the baked FBX
-                            // with its original query and fragment
-                            auto newAnimationURL = _destinationPath.resolved(relativeFBXFilePath);
-                            newAnimationURL.setQuery(oldAnimationURL.query());
-                            newAnimationURL.setFragment(oldAnimationURL.fragment());
-                            newAnimationURL.setUserInfo(oldAnimationURL.userInfo());
+    QDir cachedDir { cachedBake[BAKE_CACHE_DIRECTORY_KEY].toString() };
+    auto bakedModelRelativePath = cachedBake[BAKE_CACHE_BAKED_MODEL_KEY].toString();
+    if (!cachedDir.exists(bakedModelRelativePath)) {
+        // the folder of that bake was removed
+        return false;
+    }
 
-                            animationObject[ENTITIY_ANIMATION_URL_KEY] = newAnimationURL.toString();
+    auto outputPath = _contentOutputPath + bake.subDirectory;
+    if (!copyDirectory(cachedDir.absolutePath(), outputPath)) {
+        handleWarning("Could not copy the previous bake of " + bake.url.toString() + ", baking it again");
+        QDir(outputPath).removeRecursively();
+        return false;
+    }
 
-                            // replace the animation object in the entity object
-                            entity[ENTITY_ANIMATION_KEY] = animationObject;
-                        }
-                    }
-                }
-                
-                // replace our temp object with the value referenced by our QJsonValueRef
-                entityValue = entity;
-            }
+    qDebug() << "Reusing the previous bake of" << bake.url << "from" << cachedDir.absolutePath();
+    rewriteModelURLs(bake.url, QDir(outputPath).absoluteFilePath(bakedModelRelativePath));
+    _entitiesNeedingRewrite.remove(bake.url);
+
+    // point the cache at the copy, the folder of the previous bake can go away
+    cachedBake[BAKE_CACHE_DIRECTORY_KEY] = QDir(outputPath).absolutePath();
+    _cachedModelBakes[bake.url.toString()] = cachedBake;
+
+    reportBake(bake, "cached");
+    emit bakeProgress(++_completedSubBakes, _totalNumberOfSubBakes);
+    return true;
+}
+
+void DomainBaker::cacheModelBake(const AssetBake& bake, const ModelBaker& baker) {
+    _cachedModelBakes.remove(bake.url.toString());
+    if (bake.sourceHash.isEmpty()) {
+        return;
+    }
+
+    QJsonObject textures;
+    for (const auto& textureURL : baker.getTextureURLs()) {
+        if (bake.url.isParentOf(textureURL)) {
+            // embedded, it's in the model's hash
+            continue;
+        }
+        auto hash = hashLocalFile(textureURL);
+        if (hash.isEmpty()) {
+            return;
+        }
+        textures[textureURL.toString()] = hash;
+    }
+
+    QDir outputDir { _contentOutputPath + bake.subDirectory };
+
+    QJsonObject cachedBake;
+    cachedBake[BAKE_CACHE_VERSION_KEY] = MODEL_BAKE_VERSION;
+    cachedBake[BAKE_CACHE_SOURCE_HASH_KEY] = bake.sourceHash;
+    cachedBake[BAKE_CACHE_TEXTURES_KEY] = textures;
+    cachedBake[BAKE_CACHE_DIRECTORY_KEY] = outputDir.absolutePath();
+    cachedBake[BAKE_CACHE_BAKED_MODEL_KEY] = outputDir.relativeFilePath(baker.getBakedModelFilePath());
+    _cachedModelBakes[bake.url.toString()] = cachedBake;
+}
+
+void DomainBaker::handleFinishedModelBaker() {
+    auto baker = qobject_cast<ModelBaker*>(sender());
+
+    // a baker can finish more than once when it runs into several errors
+    if (baker && _runningBakes.contains(baker)) {
+        auto bake = _runningBakes.take(baker);
+
+        if (!baker->hasErrors()) {
+            rewriteModelURLs(baker->getModelURL(), baker->getBakedModelFilePath());
+            cacheModelBake(bake, *baker);
+            reportBake(bake, "baked");
         } else {
             // this model failed to bake - this doesn't fail the entire bake but we need to add
             // the errors from the model to our warnings
             _warningList << baker->getErrors();
+            reportBake(bake, "failed");
         }
 
         // remove the baked URL from the multi hash of entities needing a re-write
         _entitiesNeedingRewrite.remove(baker->getModelURL());
 
-        // drop our shared pointer to this baker so that it gets cleaned up
-        _modelBakers.remove(baker->getModelURL());
-
         // emit progress to tell listeners how many models we have baked
         emit bakeProgress(++_completedSubBakes, _totalNumberOfSubBakes);
 
+        // make room for the next bake
+        startQueuedBakes();
+
         // check if this was the last model we needed to re-write and if we are done now
         checkIfRewritingComplete();
     }
 }
 
+void DomainBaker::rewriteModelURLs(const QUrl& modelURL, const QString& bakedModelFilePath) {
+    qDebug() << "Re-writing entity references to" << modelURL;
+
+    // enumerate the QJsonRef values for the URL of this FBX from our multi hash of
+    // entity objects needing a URL re-write
+    for (QJsonValueRef entityValue : _entitiesNeedingRewrite.values(modelURL)) {
+        // convert the entity QJsonValueRef to a QJsonObject so we can modify its URL
+        auto entity = entityValue.toObject();
+
+        // grab the old URL
+        QUrl oldModelURL { entity[ENTITY_MODEL_URL_KEY].toString() };
+
+        // setup a new URL using the prefix we were passed
+        auto relativeFBXFilePath = QString(bakedModelFilePath).remove(_contentOutputPath);
+        if (relativeFBXFilePath.startsWith("/")) {
+            relativeFBXFilePath = relativeFBXFilePath.right(relativeFBXFilePath.length() - 1);
+        }
+        QUrl newModelURL = _destinationPath.resolved(relativeFBXFilePath);
+
+        // copy the fragment and query, and user info from the old model URL
+        newModelURL.setQuery(oldModelURL.query());
+        newModelURL.setFragment(oldModelURL.fragment());
+        newModelURL.setUserInfo(oldModelURL.userInfo());
+
+        // set the new model URL as the value in our temp QJsonObject
+        entity[ENTITY_MODEL_URL_KEY] = newModelURL.toString();
+
+        // check if the entity also had an animation at the same URL
+        // in which case it should be replaced with our baked model URL too
+        const QString ENTITY_ANIMATION_KEY = "animation";
+        const QString ENTITIY_ANIMATION_URL_KEY = "url";
+
+        if (entity.contains(ENTITY_ANIMATION_KEY)) {
+            auto animationObject = entity[ENTITY_ANIMATION_KEY].toObject();
+
+            if (animationObject.contains(ENTITIY_ANIMATION_URL_KEY)) {
+                // grab the old animation URL
+                QUrl oldAnimationURL { animationObject[ENTITIY_ANIMATION_URL_KEY].toString() };
+
+                // check if its stripped down version matches our stripped down model URL
+                if (oldAnimationURL.matches(oldModelURL, QUrl::RemoveQuery | QUrl::RemoveFragment)) {
+                    // the animation URL matched the old model URL, so make the animation URL point to the baked FBX
+                    // with its original query and fragment
+                    auto newAnimationURL = _destinationPath.resolved(relativeFBXFilePath);
+                    newAnimationURL.setQuery(oldAnimationURL.query());
+                    newAnimationURL.setFragment(oldAnimationURL.fragment());
+                    newAnimationURL.setUserInfo(oldAnimationURL.userInfo());
+
+                    animationObject[ENTITIY_ANIMATION_URL_KEY] = newAnimationURL.toString();
+
+                    // replace the animation object in the entity object
+                    entity[ENTITY_ANIMATION_KEY] = animationObject;
+                }
+            }
+        }
+        
+        // replace our temp object with the value referenced by our QJsonValueRef
+        entityValue = entity;
+    }
+}
+
 void DomainBaker::handleFinishedSkyboxBaker() {
     auto baker = qobject_cast<TextureBaker*>(sender());
 
-    if (baker) {
+    if (baker && _runningBakes.contains(baker)) {
+        auto bake = _runningBakes.take(baker);
+
         if (!baker->hasErrors()) {
+            reportBake(bake, "baked");
+
             // this FBXBaker is done and everything went according to plan
             qDebug() << "Re-writing entity references to" << baker->getTextureURL();
 
@@ -441,17 +652,18 @@ void DomainBaker::handleFinishedSkyboxBaker() {
             // this skybox failed to bake - this doesn't fail the entire bake but we need to add the errors from
             // the model to our warnings
             _warningList << baker->getWarnings();
+            reportBake(bake, "failed");
         }
 
         // remove the baked URL from the multi hash of entities needing a re-write
         _entitiesNeedingRewrite.remove(baker->getTextureURL());
 
-        // drop our shared pointer to this baker so that it gets cleaned up
-        _skyboxBakers.remove(baker->getTextureURL());
-
          // emit progress to tell listeners how many models we have baked
          emit bakeProgress(++_completedSubBakes, _totalNumberOfSubBakes);
 
+         // make room for the next bake
+         startQueuedBakes();
+
          // check if this was the last model we needed to re-write and if we are done now
          checkIfRewritingComplete();
     }
@@ -485,6 +697,9 @@ void DomainBaker::checkIfRewritingComplete() {
             return;
         }
 
+        writeBakeCache();
+        writeBakeReport();
+
         // we've now written out our new models file - time to say that we are finished up
         emit finished();
     }
@@ -527,3 +742,22 @@ void DomainBaker::writeNewEntitiesFile() {
     qDebug() << "Exported entities file with baked model URLs to" << bakedEntitiesFilePath;
 }
 
+void DomainBaker::writeBakeReport() {
+    QJsonObject rootObject;
+    rootObject["entitiesFile"] = _localEntitiesFileURL.toString();
+    rootObject["domain"] = _domainName;
+    rootObject["maxConcurrentBakes"] = _maxConcurrentBakes;
+    rootObject["totalMsecs"] = (double)_bakeTimer.elapsed();
+    rootObject["assets"] = _bakeReport;
+    rootObject["textures"] = _textureBakeCache->getReport();
+
+    static const QString BAKE_REPORT_FILE_NAME = "bake-report.json";
+    auto bakeReportFilePath = QDir(_uniqueOutputPath).filePath(BAKE_REPORT_FILE_NAME);
+    QFile bakeReportFile { bakeReportFilePath };
+    if (!bakeReportFile.open(QIODevice::WriteOnly) || bakeReportFile.write(QJsonDocument(rootObject).toJson()) == -1) {
+        handleWarning("Failed to write bake report " + bakeReportFilePath);
+        return;
+    }
+
+    qDebug() << "Wrote bake report to" << bakeReportFilePath;
+}
@@ -12,13 +12,20 @@
 #ifndef hifi_DomainBaker_h
 #define hifi_DomainBaker_h
 
+#include <algorithm>
+#include <memory>
+
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QJsonArray>
+#include <QtCore/QJsonObject>
 #include <QtCore/QObject>
+#include <QtCore/QSet>
 #include <QtCore/QUrl>
 #include <QtCore/QThread>
 
 #include "Baker.h"
 #include "FBXBaker.h"
+#include "TextureBakeCache.h"
 #include "TextureBaker.h"
 
 class DomainBaker : public Baker {
@@ -31,6 +38,13 @@ public:
                 const QString& baseOutputPath, const QUrl& destinationPath,
                 bool shouldRebakeOriginals = false);
 
+    // At most this many model and skybox bakes run at once, defaults to the ideal thread count
+    void setMaxConcurrentBakes(int maxConcurrentBakes) { _maxConcurrentBakes = std::max(maxConcurrentBakes, 1); }
+
+    // Models whose source, textures and bake version are the same as in the last bake to the same output path get
+    // a copy of that bake instead of being baked again.  On by default, the bake cache is updated either way.
+    void setUseBakeCache(bool useBakeCache) { _useBakeCache = useBakeCache; }
+
 signals:
     void allModelsFinished();
     void bakeProgress(int baked, int total);
@@ -41,12 +55,41 @@ private slots:
     void handleFinishedSkyboxBaker();
 
 private:
+    enum AssetType {
+        FBX_MODEL,
+        OBJ_MODEL,
+        SKYBOX
+    };
+
+    struct AssetBake {
+        QUrl url;
+        AssetType type { FBX_MODEL };
+        QString subDirectory; // of the content folder, for models
+        QString sourceHash;
+        QSharedPointer<Baker> baker;
+        QElapsedTimer timer; // queued, then running
+        qint64 waitMsecs { 0 };
+    };
+
     void setupOutputFolder();
     void loadLocalFile();
     void enumerateEntities();
     void checkIfRewritingComplete();
     void writeNewEntitiesFile();
 
+    void queueBake(const QUrl& url, AssetType type, const QString& subDirectory = QString());
+    void startQueuedBakes();
+    void reportBake(const AssetBake& bake, const QString& status);
+
+    void rewriteModelURLs(const QUrl& modelURL, const QString& bakedModelFilePath);
+
+    QString hashLocalFile(const QUrl& url);
+    void loadBakeCache();
+    void writeBakeCache();
+    bool reuseCachedModelBake(const AssetBake& bake);
+    void cacheModelBake(const AssetBake& bake, const ModelBaker& baker);
+    void writeBakeReport();
+
     void bakeSkybox(QUrl skyboxURL, QJsonValueRef entity);
     bool rewriteSkyboxURL(QJsonValueRef urlValue, TextureBaker* baker);
 
@@ -61,9 +104,21 @@ private:
 
     QJsonArray _entities;
 
-    QHash<QUrl, QSharedPointer<ModelBaker>> _modelBakers;
-    QHash<QUrl, QSharedPointer<TextureBaker>> _skyboxBakers;
-    
+    QList<AssetBake> _queuedBakes;
+    QHash<Baker*, AssetBake> _runningBakes;
+    int _maxConcurrentBakes { QThread::idealThreadCount() };
+    QSet<QString> _modelSubDirectories;
+
+    std::shared_ptr<TextureBakeCache> _textureBakeCache { std::make_shared<TextureBakeCache>() };
+
+    bool _useBakeCache { true };
+    QString _bakeCacheFilePath;
+    QJsonObject _cachedModelBakes;
+    QHash<QString, QString> _fileHashes;
+
+    QElapsedTimer _bakeTimer;
+    QJsonArray _bakeReport;
+
     QMultiHash<QUrl, QJsonValueRef> _entitiesNeedingRewrite;
 
     int _totalNumberOfSubBakes { 0 };
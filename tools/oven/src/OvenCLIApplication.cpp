@@ -19,6 +19,7 @@
 static const QString CLI_INPUT_PARAMETER = "i";
 static const QString CLI_OUTPUT_PARAMETER = "o";
 static const QString CLI_TYPE_PARAMETER = "t";
+static const QString CLI_DESTINATION_PARAMETER = "d";
 
 OvenCLIApplication::OvenCLIApplication(int argc, char* argv[]) :
     QCoreApplication(argc, argv)
@@ -29,7 +30,8 @@ OvenCLIApplication::OvenCLIApplication(int argc, char* argv[]) :
     parser.addOptions({
         { CLI_INPUT_PARAMETER, "Path to file that you would like to bake.", "input" },
         { CLI_OUTPUT_PARAMETER, "Path to folder that will be used as output.", "output" },
-        { CLI_TYPE_PARAMETER, "Type of asset.", "type" }
+        { CLI_TYPE_PARAMETER, "Type of asset, domain for an entities file.", "type" },
+        { CLI_DESTINATION_PARAMETER, "URL the baked content of a domain will be served from.", "destination" }
     });
 
     parser.addHelpOption();
@@ -40,8 +42,10 @@ OvenCLIApplication::OvenCLIApplication(int argc, char* argv[]) :
         QUrl inputUrl(QDir::fromNativeSeparators(parser.value(CLI_INPUT_PARAMETER)));
         QUrl outputUrl(QDir::fromNativeSeparators(parser.value(CLI_OUTPUT_PARAMETER)));
         QString type = parser.isSet(CLI_TYPE_PARAMETER) ? parser.value(CLI_TYPE_PARAMETER) : QString::null;
+        QString destination = parser.isSet(CLI_DESTINATION_PARAMETER) ? parser.value(CLI_DESTINATION_PARAMETER) : QString::null;
         QMetaObject::invokeMethod(cli, "bakeFile", Qt::QueuedConnection, Q_ARG(QUrl, inputUrl),
-                                    Q_ARG(QString, outputUrl.toString()), Q_ARG(QString, type));
+                                    Q_ARG(QString, outputUrl.toString()), Q_ARG(QString, type),
+                                    Q_ARG(QString, destination));
     } else {
         parser.showHelp();
         QCoreApplication::quit();
@@ -12,6 +12,7 @@
 #include "UDTTest.h"
 
 #include <QtCore/QDebug>
+#include <QtCore/QElapsedTimer>
 
 #include <udt/Constants.h>
 #include <udt/Packet.h>
@@ -55,6 +56,14 @@ const QCommandLineOption MESSAGE_SEED {
 const QCommandLineOption STATS_INTERVAL {
     "stats-interval", "stats output interval (default is 100ms)", "milliseconds"
 };
+const QCommandLineOption SYNC_BENCHMARK {
+    "sync-benchmark", "measure the cost of a SYN interval rate control sync for up to this many idle connections "
+    "next to connections receiving traffic from local senders, then exit", "connections"
+};
+const QCommandLineOption SYNC_BENCHMARK_SENDERS {
+    "sync-benchmark-senders", "number of local senders streaming reliable packets during the sync benchmark (default is 8)",
+    "senders", "8"
+};
 
 const QStringList CLIENT_STATS_TABLE_HEADERS {
     "Send (Mb/s)", "Est. Max (Mb/s)", "RTT (ms)", "CW (P)", "Period (us)",
@@ -78,6 +87,13 @@ UDTTest::UDTTest(int& argc, char** argv) :
 
     _socket.bind(QHostAddress::AnyIPv4, _argumentParser.value(PORT_OPTION).toUInt());
     qDebug() << "Test socket is listening on" << _socket.localPort();
+
+    if (_argumentParser.isSet(SYNC_BENCHMARK)) {
+        runSyncBenchmark(_argumentParser.value(SYNC_BENCHMARK).toInt(),
+                         _argumentParser.value(SYNC_BENCHMARK_SENDERS).toInt());
+        QMetaObject::invokeMethod(this, "quit", Qt::QueuedConnection);
+        return;
+    }
     
     if (_argumentParser.isSet(TARGET_OPTION)) {
         // parse the IP and port combination for this target
@@ -226,7 +242,7 @@ void UDTTest::parseArguments() {
     _argumentParser.addOptions({
         PORT_OPTION, TARGET_OPTION, PACKET_SIZE, MIN_PACKET_SIZE, MAX_PACKET_SIZE,
         MAX_SEND_BYTES, MAX_SEND_PACKETS, UNRELIABLE_PACKETS, ORDERED_PACKETS,
-        MESSAGE_SIZE, MESSAGE_SEED, STATS_INTERVAL
+        MESSAGE_SIZE, MESSAGE_SEED, STATS_INTERVAL, SYNC_BENCHMARK, SYNC_BENCHMARK_SENDERS
     });
     
     if (!_argumentParser.parse(arguments())) {
@@ -241,6 +257,96 @@ void UDTTest::parseArguments() {
     }
 }
 
+void UDTTest::runSyncBenchmark(int maxConnections, int numSenders) {
+    static const int NUM_SYNCS_PER_SAMPLE = 1000;
+    static const int PACKETS_PER_SENDER_PER_SYNC = 4;
+    static const float DROP_PROBABILITY = 0.01f;
+    static const int WARMUP_MSECS = 1000;
+    static const quint16 FIRST_FAKE_PORT = 10000;
+    static const int FAKE_PORTS_PER_ADDRESS = 50000;
+
+    // drop a few of the incoming data packets so the receiving connections keep loss lists and send NAKs
+    std::uniform_real_distribution<float> dropDistribution { 0.0f, 1.0f };
+    _socket.setPacketFilterOperator([&](const udt::Packet&) {
+        return dropDistribution(_generator) >= DROP_PROBABILITY;
+    });
+
+    // senders in this process push reliable packets at our socket over loopback
+    HifiSockAddr target { QHostAddress::LocalHost, _socket.localPort() };
+    std::vector<std::unique_ptr<udt::Socket>> senders;
+    for (int i = 0; i < numSenders; ++i) {
+        senders.emplace_back(new udt::Socket(nullptr, false));
+        senders.back()->bind(QHostAddress::LocalHost);
+    }
+
+    auto sendTraffic = [&] {
+        for (auto& sender : senders) {
+            for (int i = 0; i < PACKETS_PER_SENDER_PER_SYNC; ++i) {
+                int payloadSize = udt::MAX_PACKET_SIZE - udt::Packet::localHeaderSize(true);
+                auto packet = udt::Packet::create(payloadSize, true);
+                packet->setPayloadSize(payloadSize);
+                sender->writePacket(std::move(packet), target);
+            }
+        }
+
+        // read what has arrived, and let the senders hear the ACKs and NAKs
+        processEvents();
+    };
+
+    // let the senders finish their handshakes and get their data flowing
+    QElapsedTimer warmupTimer;
+    warmupTimer.start();
+    while (warmupTimer.elapsed() < WARMUP_MSECS) {
+        sendTraffic();
+    }
+    _socket.sampleStatsForAllConnections();
+
+    qDebug() << "Idle | Receiving | Recv (P) | Sent NAK | Sync (us)";
+
+    int numIdleConnections = 0;
+    for (int sampleConnections = 1; sampleConnections <= maxConnections; sampleConnections *= 2) {
+        // add idle connections to fake peers until we have the number for this sample
+        for (; numIdleConnections < sampleConnections; ++numIdleConnections) {
+            quint32 address = QHostAddress(QHostAddress::LocalHost).toIPv4Address() + 1
+                + (numIdleConnections / FAKE_PORTS_PER_ADDRESS);
+            quint16 port = FIRST_FAKE_PORT + (quint16)(numIdleConnections % FAKE_PORTS_PER_ADDRESS);
+            _socket.findOrCreateConnection(HifiSockAddr(QHostAddress(address), port));
+        }
+
+        // only the syncs are timed, the traffic between them is what they have to deal with
+        std::chrono::nanoseconds syncTime { 0 };
+        for (int i = 0; i < NUM_SYNCS_PER_SAMPLE; ++i) {
+            sendTraffic();
+
+            auto start = p_high_resolution_clock::now();
+            _socket.rateControlSync();
+            syncTime += std::chrono::duration_cast<std::chrono::nanoseconds>(p_high_resolution_clock::now() - start);
+        }
+
+        int receivedPackets = 0;
+        int sentNAKs = 0;
+        for (auto& connectionStats : _socket.sampleStatsForAllConnections()) {
+            const auto& stats = connectionStats.second;
+            receivedPackets += stats.receivedPackets;
+            sentNAKs += stats.events[udt::ConnectionStats::Stats::SentNAK]
+                + stats.events[udt::ConnectionStats::Stats::SentTimeoutNAK];
+        }
+
+        double usecsPerSync = syncTime.count() / (1000.0 * NUM_SYNCS_PER_SAMPLE);
+        qDebug() << qPrintable(QString::number(numIdleConnections).rightJustified(4)) << "|"
+            << qPrintable(QString::number(_socket._receivingConnections.size()).rightJustified(9)) << "|"
+            << qPrintable(QString::number(receivedPackets).rightJustified(8)) << "|"
+            << qPrintable(QString::number(sentNAKs).rightJustified(8)) << "|"
+            << qPrintable(QString::number(usecsPerSync, 'f', 3));
+    }
+
+    _socket.setPacketFilterOperator(nullptr);
+    for (auto& sender : senders) {
+        sender->clearConnections();
+    }
+    _socket.clearConnections();
+}
+
 void UDTTest::sendInitialPackets() {
     static const int NUM_INITIAL_PACKETS = 500;
     
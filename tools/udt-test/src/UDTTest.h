@@ -42,6 +42,10 @@ public slots:
 private:
     void parseArguments();
     void handleMessage(std::unique_ptr<Message> message);
+
+    // measures Socket::rateControlSync against a growing number of idle connections,
+    // while local senders keep a few connections receiving (and losing) reliable packets
+    void runSyncBenchmark(int maxConnections, int numSenders);
     
     void sendInitialPackets(); // fills the queue with packets to start
     void sendPacket(); // constructs and sends a packet according to the test parameters